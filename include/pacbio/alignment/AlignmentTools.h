@@ -6,6 +6,7 @@
 #include <pacbio/alignment/DiffCounts.h>
 #include <pbbam/Cigar.h>
 #include <pbbam/CigarOperation.h>
+#include <vector>
 
 namespace PacBio {
 namespace Pancake {
@@ -25,6 +26,9 @@ inline bool operator==(const TrimmingInfo& lhs, const TrimmingInfo& rhs)
 
 PacBio::BAM::Cigar EdlibAlignmentToCigar(const unsigned char* aln, int32_t alnLen);
 
+/// \brief Same as above, but writes into retCigar, retaining its capacity.
+void EdlibAlignmentToCigar(const unsigned char* aln, int32_t alnLen, PacBio::BAM::Cigar& retCigar);
+
 void EdlibAlignmentDiffCounts(const unsigned char* aln, int32_t alnLen, int32_t& numEq,
                               int32_t& numX, int32_t& numI, int32_t& numD);
 
@@ -67,9 +71,25 @@ void ConvertCigarToM5(const char* query, int64_t queryLen, const char* target, i
 
 Data::Cigar ConvertM5ToCigar(const std::string& queryAln, const std::string& targetAln);
 
+/// \brief Normalizes the gaps in an alignment in the same way as NormalizeAlignmentInPlace
+///         does for the M5 representation, but works directly on the CIGAR operations
+///         without expanding the alignment. Only the columns around gaps are inspected.
 Data::Cigar NormalizeCigar(const char* query, int64_t queryLen, const char* target,
                            int64_t targetLen, const Data::Cigar& cigar);
 
+/// \brief Same as above, but writes into retCigar, which has to be a different object than
+///         the input cigar. The gapRun is scratch space for the run of shifted gap columns.
+///         The capacities of retCigar and gapRun are retained, so normalizing in a loop with
+///         the same objects does not allocate memory once they have grown large enough.
+void NormalizeCigar(const char* query, int64_t queryLen, const char* target, int64_t targetLen,
+                    const Data::Cigar& cigar, Data::Cigar& retCigar, std::vector<char>& gapRun);
+
+/// \brief Trims the front and the back of an alignment up to the first window of windowSize
+///         columns which contains at least minMatches matches. If clipOnFirstMatch is true,
+///         the window also needs to begin with a match. The window is moved over whole CIGAR
+///         operations, so the running time depends on the number of operations and not on the
+///         length of the alignment or the window size.
+/// \returns false if no such window was found on either end. Throws if windowSize < 0.
 bool TrimCigar(const PacBio::BAM::Cigar& cigar, int32_t windowSize, int32_t minMatches,
                bool clipOnFirstMatch, PacBio::BAM::Cigar& retTrimmedCigar,
                TrimmingInfo& retTrimming);
@@ -21,16 +21,38 @@ namespace PacBio {
 namespace Pancake {
 namespace Alignment {
 
-template <SESAlignMode ALIGN_MODE, SESTrimmingMode TRIM_MODE, SESTracebackMode TRACEBACK>
-SesResults SES2AlignBanded(const char* query, size_t queryLen, const char* target,
-                              size_t targetLen, int32_t maxDiffs, int32_t bandwidth,
-                          std::shared_ptr<SESScratchSpace> ss = nullptr)
+/*
+ * The DIRECTION parameter controls only how the sequences are read. Aligning in
+ * the SESAlignDirection::Reverse direction produces exactly the same result as aligning
+ * the reversed copies of both sequences in the forward direction, including the CIGAR
+ * (which is in the order of the reversed sequences).
+ *
+ * The adaptive version starts with the given bandwidth and diff budget. When the band
+ * grows wider than the bandwidth, or all of the diffs are used up, both are doubled
+ * (up to maxDiffsCap and bandwidthCap) and the alignment resumes from the last computed
+ * furthest-reaching row instead of starting over. Each row depends only on the previous one,
+ * so the rows computed with the narrower band remain valid. The number of doublings is
+ * reported in SesResults::numWidenings.
+ * The working rows and the traceback matrix are sized for the initial band, and grow only
+ * when the band is actually widened, so the common case without widening stays as cheap as
+ * the fixed band.
+ *
+ * The results are written into ret, which is cleared first. The capacity of its CIGAR is
+ * retained, so reusing the same results and scratch space across calls does not allocate
+ * memory once the buffers have grown large enough.
+*/
+template <SESAlignMode ALIGN_MODE, SESTrimmingMode TRIM_MODE, SESTracebackMode TRACEBACK,
+          SESAlignDirection DIRECTION = SESAlignDirection::Forward>
+void SES2AlignBandedAdaptive(const char* query, size_t queryLen, const char* target,
+                             size_t targetLen, int32_t maxDiffs, int32_t bandwidth,
+                             int32_t maxDiffsCap, int32_t bandwidthCap, SesResults& ret,
+                             std::shared_ptr<SESScratchSpace> ss = nullptr)
 {
-    SesResults ret;
+    ret.Clear();
 
     if (queryLen == 0 || targetLen == 0) {
         ret.valid = true;
-        return ret;
+        return;
     }
 
     // Allocate scratch space memory if required.
@@ -39,14 +61,17 @@ SesResults SES2AlignBanded(const char* query, size_t queryLen, const char* targe
     }
 
     bandwidth = std::min(bandwidth, maxDiffs);
+    maxDiffsCap = std::max(maxDiffsCap, maxDiffs);
+    bandwidthCap = std::max(std::min(bandwidthCap, maxDiffsCap), bandwidth);
 
-    // Define the required variables.
-    const int32_t maxAllowedDiffs = std::max(maxDiffs, bandwidth);
+    // Define the required variables. The rows are sized for the current band, and are moved
+    // to a larger zero offset when the band is widened.
+    int32_t maxAllowedDiffs = std::max(maxDiffs, bandwidth);
     const int32_t qlen = queryLen;
     const int32_t tlen = targetLen;
-    const int32_t zero_offset = maxAllowedDiffs + 1;
-    const int32_t bandTolerance = bandwidth / 2 + 1;
-    const int32_t rowLen = (2 * maxAllowedDiffs + 3);
+    int32_t zero_offset = maxAllowedDiffs + 1;
+    int32_t bandTolerance = bandwidth / 2 + 1;
+    int32_t rowLen = (2 * maxAllowedDiffs + 3);
 
     // Working space for regular alignment (without traceback).
     auto& W = ss->v;                                        // Y for a diagonal k. 'W' is taken from the pseudocode. Working row.
@@ -83,8 +108,10 @@ SesResults SES2AlignBanded(const char* query, size_t queryLen, const char* targe
     (void)prevK;
 
     // Allocate memory for basic alignment.
-    if (rowLen > static_cast<int32_t>(W.capacity())) {
+    if (rowLen > static_cast<int32_t>(W.size())) {
         W.resize(rowLen, -1);
+    }
+    if (rowLen > static_cast<int32_t>(u.size())) {
         u.resize(rowLen, MINUS_INF);
     }
     // Allocate the memory for trimming.
@@ -95,24 +122,88 @@ SesResults SES2AlignBanded(const char* query, size_t queryLen, const char* targe
     // Allocate memory for traceback.
     // clang-format off
     if constexpr (TRACEBACK == SESTracebackMode::Enabled) {
-        if (rowLen > static_cast<int32_t>(dStart.capacity())) {
+        if (rowLen > static_cast<int32_t>(dStart.size())) {
             dStart.resize(rowLen, {0, 0});
         }
-        if (rowLen > static_cast<int32_t>(alnPath.capacity())) {
+        if (rowLen > static_cast<int32_t>(alnPath.size())) {
             alnPath.resize(rowLen);
         }
-        if ((rowLen * maxDiffs) > static_cast<int32_t>(WMatrix.capacity())) {
+        if ((rowLen * maxDiffs) > static_cast<int32_t>(WMatrix.size())) {
             WMatrix.resize(rowLen * maxDiffs);
         }
     }
     // clang-format on
 
+    // Moves the first oldRowLen values of a row by shift positions to the right, to account for
+    // a larger zero offset. The row is enlarged first if needed.
+    auto ShiftRow = [](auto& row, int32_t oldRowLen, int32_t newRowLen, int32_t shift,
+                       auto fillValue) {
+        if (newRowLen > static_cast<int32_t>(row.size())) {
+            row.resize(newRowLen, fillValue);
+        }
+        if (shift > 0) {
+            std::copy_backward(row.begin(), row.begin() + oldRowLen,
+                               row.begin() + oldRowLen + shift);
+            std::fill(row.begin(), row.begin() + shift, fillValue);
+        }
+    };
+
+    // Doubles the bandwidth and the diff budget. Returns false if both are already at the caps.
+    auto Widen = [&]() {
+        if (maxDiffs >= maxDiffsCap && bandwidth >= bandwidthCap) {
+            return false;
+        }
+        maxDiffs = std::min(maxDiffsCap, std::max(1, maxDiffs * 2));
+        bandwidth = std::min(bandwidthCap, std::max(1, bandwidth * 2));
+        bandTolerance = bandwidth / 2 + 1;
+        ++ret.numWidenings;
+
+        // Re-stride the working rows for the wider band. The diagonals computed so far keep
+        // their values, but are moved to the new zero offset.
+        const int32_t oldRowLen = rowLen;
+        const int32_t shift = std::max(maxDiffs, bandwidth) + 1 - zero_offset;
+        maxAllowedDiffs = std::max(maxDiffs, bandwidth);
+        zero_offset = maxAllowedDiffs + 1;
+        rowLen = (2 * maxAllowedDiffs + 3);
+        ShiftRow(W, oldRowLen, rowLen, shift, -1);
+        ShiftRow(u, oldRowLen, rowLen, shift, MINUS_INF);
+        // clang-format off
+        if constexpr (TRIM_MODE == SESTrimmingMode::Enabled) {
+            ShiftRow(B, oldRowLen, rowLen, shift, static_cast<uint64_t>(MINUS_INF));
+            ShiftRow(M, oldRowLen, rowLen, shift, MINUS_INF);
+        }
+        if constexpr (TRACEBACK == SESTracebackMode::Enabled) {
+            // The traceback rows are stored back to back, and each row is never wider than
+            // the band, so only the total size needs to grow.
+            if (rowLen > static_cast<int32_t>(dStart.size())) {
+                dStart.resize(rowLen, {0, 0});
+            }
+            if (rowLen > static_cast<int32_t>(alnPath.size())) {
+                alnPath.resize(rowLen);
+            }
+            const int64_t newSize = static_cast<int64_t>(rowLen) * maxDiffs;
+            if (newSize > static_cast<int64_t>(WMatrix.size())) {
+                WMatrix.resize(newSize);
+            }
+        }
+        // clang-format on
+        return true;
+    };
+
     // Initialize the alignment vectors.
     u[zero_offset] = u[zero_offset + 1] = u[zero_offset - 1] = MINUS_INF;
     W[zero_offset] = W[zero_offset + 1] = W[zero_offset - 1] = -1;
 
-    for (int32_t d = 0; d < maxDiffs; ++d) {
+    for (int32_t d = 0;; ++d) {
+        if (d >= maxDiffs && Widen() == false) {
+            break;
+        }
         ret.numDiffs = d;
+        while ((maxK - minK) > bandwidth) {
+            if (Widen() == false) {
+                break;
+            }
+        }
         if ((maxK - minK) > bandwidth) {
             ret.valid = false;
             break;
@@ -213,19 +304,35 @@ SesResults SES2AlignBanded(const char* query, size_t queryLen, const char* targe
 
             int32_t x = y + k;
             int32_t minLeft = std::min(qlen - x, tlen - y);
-            const char* querySub = query + x;
-            const char* targetSub = target + y;
             int32_t moves = 0;
 
-            while (moves < minLeft && querySub[moves] == targetSub[moves]) {
-                ++moves;
-                if constexpr (TRIM_MODE == SESTrimmingMode::Enabled) {
-                    if ((b & MASKC) == 0) {
-                        ++m;
+            // clang-format off
+            if constexpr (DIRECTION == SESAlignDirection::Forward) {
+                const char* querySub = query + x;
+                const char* targetSub = target + y;
+                while (moves < minLeft && querySub[moves] == targetSub[moves]) {
+                    ++moves;
+                    if constexpr (TRIM_MODE == SESTrimmingMode::Enabled) {
+                        if ((b & MASKC) == 0) {
+                            ++m;
+                        }
+                        b = (b << 1) | 1;
+                    }
+                }
+            } else {
+                const int32_t qLast = qlen - 1 - x;
+                const int32_t tLast = tlen - 1 - y;
+                while (moves < minLeft && query[qLast - moves] == target[tLast - moves]) {
+                    ++moves;
+                    if constexpr (TRIM_MODE == SESTrimmingMode::Enabled) {
+                        if ((b & MASKC) == 0) {
+                            ++m;
+                        }
+                        b = (b << 1) | 1;
                     }
-                    b = (b << 1) | 1;
                 }
             }
+            // clang-format on
             y += moves;
             x += moves;
             W[kz] = y;
@@ -394,9 +501,41 @@ SesResults SES2AlignBanded(const char* query, size_t queryLen, const char* targe
         std::reverse(ret.cigar.begin(), ret.cigar.end());
     }
     // clang-format on
+}
 
+template <SESAlignMode ALIGN_MODE, SESTrimmingMode TRIM_MODE, SESTracebackMode TRACEBACK,
+          SESAlignDirection DIRECTION = SESAlignDirection::Forward>
+SesResults SES2AlignBandedAdaptive(const char* query, size_t queryLen, const char* target,
+                                   size_t targetLen, int32_t maxDiffs, int32_t bandwidth,
+                                   int32_t maxDiffsCap, int32_t bandwidthCap,
+                                   std::shared_ptr<SESScratchSpace> ss = nullptr)
+{
+    SesResults ret;
+    SES2AlignBandedAdaptive<ALIGN_MODE, TRIM_MODE, TRACEBACK, DIRECTION>(
+        query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap, bandwidthCap, ret,
+        ss);
     return ret;
 }
+
+template <SESAlignMode ALIGN_MODE, SESTrimmingMode TRIM_MODE, SESTracebackMode TRACEBACK,
+          SESAlignDirection DIRECTION = SESAlignDirection::Forward>
+void SES2AlignBanded(const char* query, size_t queryLen, const char* target, size_t targetLen,
+                     int32_t maxDiffs, int32_t bandwidth, SesResults& ret,
+                     std::shared_ptr<SESScratchSpace> ss = nullptr)
+{
+    SES2AlignBandedAdaptive<ALIGN_MODE, TRIM_MODE, TRACEBACK, DIRECTION>(
+        query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffs, bandwidth, ret, ss);
+}
+
+template <SESAlignMode ALIGN_MODE, SESTrimmingMode TRIM_MODE, SESTracebackMode TRACEBACK,
+          SESAlignDirection DIRECTION = SESAlignDirection::Forward>
+SesResults SES2AlignBanded(const char* query, size_t queryLen, const char* target,
+                           size_t targetLen, int32_t maxDiffs, int32_t bandwidth,
+                           std::shared_ptr<SESScratchSpace> ss = nullptr)
+{
+    return SES2AlignBandedAdaptive<ALIGN_MODE, TRIM_MODE, TRACEBACK, DIRECTION>(
+        query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffs, bandwidth, ss);
+}
 }
 }
 }
@@ -21,7 +21,11 @@ namespace PacBio {
 namespace Pancake {
 namespace Alignment {
 
-template <SESAlignMode ALIGN_MODE, SESTrimmingMode TRIM_MODE>
+/*
+ * The DIRECTION parameter has the same meaning as in SES2AlignBanded.
+*/
+template <SESAlignMode ALIGN_MODE, SESTrimmingMode TRIM_MODE,
+          SESAlignDirection DIRECTION = SESAlignDirection::Forward>
 SesResults SES2DistanceBanded(const char* query, size_t queryLen, const char* target,
                               size_t targetLen, int32_t maxDiffs, int32_t bandwidth)
 {
@@ -112,19 +116,35 @@ SesResults SES2DistanceBanded(const char* query, size_t queryLen, const char* ta
 
             int32_t x = y + k;
             int32_t minLeft = std::min(qlen - x, tlen - y);
-            const char* querySub = query + x;
-            const char* targetSub = target + y;
             int32_t moves = 0;
 
-            while (moves < minLeft && querySub[moves] == targetSub[moves]) {
-                ++moves;
-                if constexpr (TRIM_MODE == SESTrimmingMode::Enabled) {
-                    if ((b & MASKC) == 0) {
-                        ++m;
+            // clang-format off
+            if constexpr (DIRECTION == SESAlignDirection::Forward) {
+                const char* querySub = query + x;
+                const char* targetSub = target + y;
+                while (moves < minLeft && querySub[moves] == targetSub[moves]) {
+                    ++moves;
+                    if constexpr (TRIM_MODE == SESTrimmingMode::Enabled) {
+                        if ((b & MASKC) == 0) {
+                            ++m;
+                        }
+                        b = (b << 1) | 1;
+                    }
+                }
+            } else {
+                const int32_t qLast = qlen - 1 - x;
+                const int32_t tLast = tlen - 1 - y;
+                while (moves < minLeft && query[qLast - moves] == target[tLast - moves]) {
+                    ++moves;
+                    if constexpr (TRIM_MODE == SESTrimmingMode::Enabled) {
+                        if ((b & MASKC) == 0) {
+                            ++m;
+                        }
+                        b = (b << 1) | 1;
                     }
-                    b = (b << 1) | 1;
                 }
             }
+            // clang-format on
             y += moves;
             x += moves;
 
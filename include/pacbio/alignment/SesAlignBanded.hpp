@@ -47,13 +47,16 @@ namespace Alignment {
 ///                 auto ss = std::make_shared<SESScratchSpace>();
 ///             and then provide that to the function call.
 ///
-/// \returns A SesResults object containing alignment coordinates, scores and CIGAR vector (if computed).
+/// \param ret The SesResults object to write the alignment coordinates, scores and CIGAR vector
+///             (if computed) into. It is cleared first, but the capacity of its CIGAR is retained,
+///             so together with the scratch space, aligning in a loop with the same objects
+///             does not allocate memory once the buffers have grown large enough.
 template <SESAlignMode ALIGN_MODE, SESTracebackMode TRACEBACK>
-SesResults SESAlignBanded(const char* query, size_t queryLen, const char* target, size_t targetLen,
-                          int32_t maxDiffs, int32_t bandwidth,
-                          std::shared_ptr<SESScratchSpace> ss = nullptr)
+void SESAlignBanded(const char* query, size_t queryLen, const char* target, size_t targetLen,
+                    int32_t maxDiffs, int32_t bandwidth, SesResults& ret,
+                    std::shared_ptr<SESScratchSpace> ss = nullptr)
 {
-    SesResults ret;
+    ret.Clear();
 
     if (ss == nullptr) {
         ss = std::make_shared<SESScratchSpace>();
@@ -291,7 +294,19 @@ SesResults SESAlignBanded(const char* query, size_t queryLen, const char* target
         ret.numDiffs = ret.diffCounts.NumDiffs();
     }
     // clang-format on
+}
 
+/// \brief Same as above, but returns a new SesResults object.
+///
+/// \returns A SesResults object containing alignment coordinates, scores and CIGAR vector (if computed).
+template <SESAlignMode ALIGN_MODE, SESTracebackMode TRACEBACK>
+SesResults SESAlignBanded(const char* query, size_t queryLen, const char* target, size_t targetLen,
+                          int32_t maxDiffs, int32_t bandwidth,
+                          std::shared_ptr<SESScratchSpace> ss = nullptr)
+{
+    SesResults ret;
+    SESAlignBanded<ALIGN_MODE, TRACEBACK>(query, queryLen, target, targetLen, maxDiffs, bandwidth,
+                                          ret, ss);
     return ret;
 }
 }
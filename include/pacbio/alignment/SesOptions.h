@@ -24,6 +24,12 @@ enum class SESTrimmingMode
     Disabled,
     Enabled,
 };
+
+enum class SESAlignDirection
+{
+    Forward,  // Sequences are aligned from their first base onward.
+    Reverse,  // Sequences are aligned from their last base backward, without reversing them.
+};
 }
 }
 }
@@ -56,6 +56,9 @@ public:
     int32_t numDiffs = 0;
     bool valid = false;
     PacBio::BAM::Cigar cigar;
+    // Number of times the band and the diff budget were doubled by the adaptive alignment.
+    // This is a work statistic, and is not compared by operator==.
+    int32_t numWidenings = 0;
 
     SesResults() = default;
     SesResults(int32_t _lastQueryPos, int32_t _lastTargetPos, int32_t _diffs, bool _valid)
@@ -87,6 +90,18 @@ public:
     {
     }
 
+    /// \brief Resets the results to the default values, but keeps the capacity of the CIGAR.
+    void Clear()
+    {
+        lastQueryPos = 0;
+        lastTargetPos = 0;
+        diffCounts.Clear();
+        numDiffs = 0;
+        valid = false;
+        cigar.clear();
+        numWidenings = 0;
+    }
+
     bool operator==(const SesResults& b) const
     {
         return lastQueryPos == b.lastQueryPos && lastTargetPos == b.lastTargetPos &&
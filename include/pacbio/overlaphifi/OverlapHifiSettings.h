@@ -7,6 +7,8 @@
 #include <string>
 
 #include <pacbio/pancake/OverlapWriterFormat.h>
+#include <pacbio/pancake/Palindrome.h>
+#include <pacbio/pancake/SeedIndexHashType.h>
 #include <pbcopper/cli2/CLI.h>
 
 namespace PacBio {
@@ -29,8 +31,10 @@ struct OverlapHifiSettings
         static const int64_t MinCoveredBases = 30;
         static const int64_t MinChainSpan = 1000;
         static const int64_t ChainBandwidth = 100;
+        static const int32_t AnchorMergeMaxGap = 0;
         static constexpr double AlignmentBandwidth = 0.01;
         static constexpr double AlignmentMaxD = 0.03;
+        static const int32_t AlignmentMaxWidenings = 0;
         static constexpr double MinIdentity = 98.0;
         static const bool NoSNPsInIdentity = 0.0;
         static const bool NoIndelsInIdentity = 0.0;
@@ -45,7 +49,9 @@ struct OverlapHifiSettings
         static const int32_t AllowedHeuristicExtendDist = 0;
         static const int32_t CombineBlocks = 1;
         static const int32_t BestN = 0;
+        static const int32_t BestNPerEnd = 0;
         static const bool UseHPC = false;
+        static const bool HPCRawCoords = false;
         static const bool UseTraceback = false;
         static const bool MaskHomopolymers = false;
         static const bool MaskSimpleRepeats = false;
@@ -59,6 +65,26 @@ struct OverlapHifiSettings
         static const int32_t TrimWindowSize = 30;
         static constexpr double TrimWindowMatchFraction = 0.75;
         static const bool TrimToFirstMatch = false;
+        static const bool AlignmentPiecewise = false;
+        static const int32_t AlignmentPiecewiseMinSpan = 1000;
+        static const int32_t EndSeedDistance = 0;
+        static const bool MinimizerSpace = false;
+        static const int32_t MinimizerSpaceK = 3;
+        static const int32_t MinimizerSpaceMaxSkip = 3;
+        static const bool PairsUseIds = false;
+        static const bool ComputeQuerySeeds = false;
+        static const bool ComputeTargetSeeds = false;
+        static const SeedIndexHashType SeedIndexHash = SeedIndexHashType::FlatHashMap;
+        static const PalindromeAction Palindromes = PalindromeAction::None;
+        static const int32_t PalindromeMinArmSpan = 1000;
+        static const int32_t CorrectMinCoverage = 3;
+        static const int32_t CorrectMinHetSupport = 2;
+        static constexpr double CorrectMinHetFraction = 0.20;
+        static const int32_t SVMinLength = 50;
+        static const bool WriteSATags = false;
+        static constexpr double ProgressInterval = 60.0;
+        static const int32_t WorkLease = 600;
+        static const int32_t WorkQueryBlocks = 1;
     };
 
     std::string TargetDBPrefix;
@@ -77,8 +103,10 @@ struct OverlapHifiSettings
     int64_t MinCoveredBases = Defaults::MinCoveredBases;
     int64_t MinChainSpan = Defaults::MinChainSpan;
     int64_t ChainBandwidth = Defaults::ChainBandwidth;
+    int32_t AnchorMergeMaxGap = Defaults::AnchorMergeMaxGap;
     double AlignmentBandwidth = Defaults::AlignmentBandwidth;
     double AlignmentMaxD = Defaults::AlignmentMaxD;
+    int32_t AlignmentMaxWidenings = Defaults::AlignmentMaxWidenings;
     double MinIdentity = Defaults::MinIdentity;
     bool NoSNPsInIdentity = Defaults::NoSNPsInIdentity;
     bool NoIndelsInIdentity = Defaults::NoIndelsInIdentity;
@@ -93,7 +121,9 @@ struct OverlapHifiSettings
     int32_t AllowedHeuristicExtendDist = Defaults::AllowedHeuristicExtendDist;
     int32_t CombineBlocks = Defaults::CombineBlocks;
     int32_t BestN = Defaults::BestN;
+    int32_t BestNPerEnd = Defaults::BestNPerEnd;
     bool UseHPC = Defaults::UseHPC;
+    bool HPCRawCoords = Defaults::HPCRawCoords;
     bool UseTraceback = Defaults::UseTraceback;
     bool MaskHomopolymers = Defaults::MaskHomopolymers;
     bool MaskSimpleRepeats = Defaults::MaskSimpleRepeats;
@@ -107,6 +137,33 @@ struct OverlapHifiSettings
     int32_t TrimWindowSize = Defaults::TrimWindowSize;
     double TrimWindowMatchFraction = Defaults::TrimWindowMatchFraction;
     bool TrimToFirstMatch = Defaults::TrimToFirstMatch;
+    bool AlignmentPiecewise = Defaults::AlignmentPiecewise;
+    int32_t AlignmentPiecewiseMinSpan = Defaults::AlignmentPiecewiseMinSpan;
+    int32_t EndSeedDistance = Defaults::EndSeedDistance;
+    bool MinimizerSpace = Defaults::MinimizerSpace;
+    int32_t MinimizerSpaceK = Defaults::MinimizerSpaceK;
+    int32_t MinimizerSpaceMaxSkip = Defaults::MinimizerSpaceMaxSkip;
+    std::string PairsPath;
+    bool PairsUseIds = Defaults::PairsUseIds;
+    bool ComputeQuerySeeds = Defaults::ComputeQuerySeeds;
+    bool ComputeTargetSeeds = Defaults::ComputeTargetSeeds;
+    std::string SeedParams;
+    SeedIndexHashType SeedIndexHash = Defaults::SeedIndexHash;
+    PalindromeAction Palindromes = Defaults::Palindromes;
+    int32_t PalindromeMinArmSpan = Defaults::PalindromeMinArmSpan;
+    std::string PalindromeListPath;
+    std::string CorrectOutPrefix;
+    int32_t CorrectMinCoverage = Defaults::CorrectMinCoverage;
+    int32_t CorrectMinHetSupport = Defaults::CorrectMinHetSupport;
+    double CorrectMinHetFraction = Defaults::CorrectMinHetFraction;
+    std::string SVBedpePath;
+    int32_t SVMinLength = Defaults::SVMinLength;
+    bool WriteSATags = Defaults::WriteSATags;
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
+    std::string WorkDir;
+    int32_t WorkLease = Defaults::WorkLease;
+    int32_t WorkQueryBlocks = Defaults::WorkQueryBlocks;
 
     OverlapHifiSettings();
     OverlapHifiSettings(const PacBio::CLI_v2::Results& options);
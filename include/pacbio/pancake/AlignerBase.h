@@ -20,6 +20,38 @@ public:
                                    int64_t tlen) = 0;
     virtual AlignmentResult Extend(const char* qseq, int64_t qlen, const char* tseq,
                                    int64_t tlen) = 0;
+    /*
+     * \brief Extends the alignment from the last base of both sequences towards their
+     * beginning. The sequences are not copied or reversed. The result is the same as that of
+     * Extend applied to the reversed sequences, so the CIGAR is in the reversed order as well.
+    */
+    virtual AlignmentResult ExtendReverse(const char* qseq, int64_t qlen, const char* tseq,
+                                          int64_t tlen) = 0;
+
+    /*
+     * \brief Variants of the above which write into a caller-owned result. The result object is
+     * overwritten, but the capacity of its CIGAR is retained, so that reusing the same object
+     * across calls does not allocate memory once the buffers have grown large enough.
+     * The default implementations simply forward to the value-returning functions, and so they
+     * still allocate a new CIGAR on every call. The KSW2 and SES aligners override them and
+     * align without allocating memory. AlignerEdlib reuses the result buffers as well, but
+     * Edlib still allocates its own matrices internally.
+    */
+    virtual void Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                        AlignmentResult& result)
+    {
+        result = Global(qseq, qlen, tseq, tlen);
+    }
+    virtual void Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                        AlignmentResult& result)
+    {
+        result = Extend(qseq, qlen, tseq, tlen);
+    }
+    virtual void ExtendReverse(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                               AlignmentResult& result)
+    {
+        result = ExtendReverse(qseq, qlen, tseq, tlen);
+    }
 };
 
 typedef std::shared_ptr<AlignerBase> AlignerBasePtr;
@@ -24,9 +24,27 @@ public:
 
     AlignmentResult Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen) override;
     AlignmentResult Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen) override;
+    AlignmentResult ExtendReverse(const char* qseq, int64_t qlen, const char* tseq,
+                                  int64_t tlen) override;
+
+    /*
+     * \brief The caller-owned result variants reuse the CIGAR buffers of the aligner and of the
+     * result. Edlib itself still allocates its matrices and the alignment path internally on
+     * every call, because its API does not accept external buffers.
+    */
+    void Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                AlignmentResult& result) override;
+    void Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                AlignmentResult& result) override;
+    void ExtendReverse(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                       AlignmentResult& result) override;
 
 private:
     AlignmentParameters opt_;
+    // Reused between alignments: the CIGAR converted from the Edlib path, and the scratch
+    // space for normalization.
+    PacBio::BAM::Cigar edlibCigar_;
+    std::vector<char> normalizeGapRun_;
 };
 
 }  // namespace Pancake
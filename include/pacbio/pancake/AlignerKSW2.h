@@ -41,20 +41,43 @@ public:
 
     AlignmentResult Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen) override;
     AlignmentResult Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen) override;
+    AlignmentResult ExtendReverse(const char* qseq, int64_t qlen, const char* tseq,
+                                  int64_t tlen) override;
+
+    void Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                AlignmentResult& result) override;
+    void Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                AlignmentResult& result) override;
+    void ExtendReverse(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                       AlignmentResult& result) override;
+
+    /// \brief Statistics of the memory pool which holds the KSW2 matrices. The pool allocates
+    ///         from the system heap only when it grows, i.e. when the number of cores changes.
+    km_stat_t MemoryPoolStats() const;
 
 private:
     AlignmentParameters opt_;
     Minimap2ThreadBufferPtr buffer_;
     int8_t mat_[25];
 
-    void ConvertMinimap2CigarToPbbam_(uint32_t* mm2Cigar, int32_t cigarLen,
-                                      const std::vector<uint8_t>& qseq,
-                                      const std::vector<uint8_t>& tseq,
-                                      PacBio::Data::Cigar& retCigar, int32_t& retQueryAlignmentLen,
-                                      int32_t& retTargetAlignmentLen);
+    void Extend_(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen, bool reverse,
+                 AlignmentResult& result);
+
+    /*
+     * \brief The KSW2 matrices and the converted sequences are allocated from the thread
+     * buffer's memory pool, which keeps the memory between alignments. This releases the pool
+     * if a very large alignment made it grow too much, same as in Minimap2.
+    */
+    void ResetBufferIfLarge_();
+
+    static void ConvertMinimap2CigarToPbbam_(uint32_t* mm2Cigar, int32_t cigarLen,
+                                             const uint8_t* qseq, const uint8_t* tseq,
+                                             PacBio::Data::Cigar& retCigar,
+                                             int32_t& retQueryAlignmentLen,
+                                             int32_t& retTargetAlignmentLen);
 
-    static std::vector<uint8_t> ConvertSeqAlphabet_(const char* seq, size_t seqlen,
-                                                    const int8_t* conv_table);
+    static void ConvertSeqAlphabet_(const char* seq, size_t seqlen, const int8_t* conv_table,
+                                    bool reverse, uint8_t* ret);
 
     static void GenerateSimpleMatrix_(int m, int8_t* mat, int8_t a, int8_t b, int8_t scAmbi);
 
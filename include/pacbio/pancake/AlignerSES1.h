@@ -25,10 +25,22 @@ public:
 
     AlignmentResult Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen) override;
     AlignmentResult Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen) override;
+    AlignmentResult ExtendReverse(const char* qseq, int64_t qlen, const char* tseq,
+                                  int64_t tlen) override;
+
+    void Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                AlignmentResult& result) override;
+    void Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                AlignmentResult& result) override;
+    void ExtendReverse(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                       AlignmentResult& result) override;
 
 private:
     AlignmentParameters opt_;
     std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch_;
+    // Reused between alignments: the raw SES result, and the scratch space for normalization.
+    PacBio::Pancake::Alignment::SesResults sesResult_;
+    std::vector<char> normalizeGapRun_;
 };
 
 }  // namespace Pancake
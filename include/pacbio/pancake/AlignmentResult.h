@@ -21,6 +21,20 @@ public:
     int32_t score = 0;
     int32_t maxScore = 0;
     bool zdropped = false;
+
+    /// \brief Resets the result to the default values, but keeps the capacity of the CIGAR.
+    void Clear()
+    {
+        cigar.clear();
+        lastQueryPos = 0;
+        lastTargetPos = 0;
+        maxQueryPos = 0;
+        maxTargetPos = 0;
+        valid = false;
+        score = 0;
+        maxScore = 0;
+        zdropped = false;
+    }
 };
 
 inline std::ostream& operator<<(std::ostream& os, const AlignmentResult& b)
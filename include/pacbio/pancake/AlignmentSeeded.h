@@ -79,6 +79,34 @@ AlignmentResult AlignSingleRegion(const char* targetSeq, int32_t targetLen, cons
                                   AlignerBasePtr& alignerGlobal, AlignerBasePtr& alignerExt,
                                   const AlignmentRegion& region);
 
+/*
+ * \brief Same as above, but writes into a caller-owned result, so that its CIGAR
+ * memory can be reused across calls.
+*/
+void AlignSingleRegion(const char* targetSeq, int32_t targetLen, const char* querySeqFwd,
+                       const char* querySeqRev, int32_t queryLen, AlignerBasePtr& alignerGlobal,
+                       AlignerBasePtr& alignerExt, const AlignmentRegion& region,
+                       AlignmentResult& alnRes);
+
+/*
+ * \brief Aligns two sequences of equal length without any indels, and without dynamic
+ * programming. The sequences are compared a machine word at a time.
+ * Returns a valid result with a CIGAR composed of only '=' and 'X' operations if there are at
+ * most maxMismatches mismatches and each two consecutive mismatches are at least
+ * minMismatchDist bases apart. Otherwise, returns an invalid result and the region should be
+ * aligned using an aligner.
+ * The score fields of the result are set to zero.
+*/
+AlignmentResult AlignUngapped(const char* querySeq, const char* targetSeq, int32_t span,
+                              int32_t maxMismatches, int32_t minMismatchDist);
+
+/*
+ * \brief Same as above, but writes into the given result, so that the memory of its CIGAR
+ * can be reused between calls.
+*/
+void AlignUngapped(const char* querySeq, const char* targetSeq, int32_t span,
+                   int32_t maxMismatches, int32_t minMismatchDist, AlignmentResult& result);
+
 AlignRegionsGenericResult AlignRegionsGeneric(const char* targetSeq, const int32_t targetLen,
                                               const char* queryFwd, const char* queryRev,
                                               const int32_t queryLen,
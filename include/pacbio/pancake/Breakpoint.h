@@ -0,0 +1,151 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_BREAKPOINT_H
+#define PANCAKE_BREAKPOINT_H
+
+#include <pacbio/pancake/FastaSequenceCached.h>
+#include <pacbio/pancake/Overlap.h>
+#include <pacbio/pancake/SeqDBReaderCachedBlock.h>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+struct ChainedRegion;
+
+enum class BreakpointType
+{
+    Unknown,
+    SplitRead,  // Junction between two mappings which are not colinear (other target, strand or order).
+    Deletion,   // Target bases skipped between two colinear segments.
+    Insertion,  // Query bases skipped between two colinear segments.
+};
+
+std::string BreakpointTypeToString(const BreakpointType& type);
+
+/*
+ * \brief Describes a junction between two consecutive aligned segments of a query.
+ * Segments are ordered by their position on the forward strand of the query, so the
+ * "left" side is the segment which ends at the junction, and the "right" side is the
+ * segment which begins at the junction.
+ * Target coordinates are always given in the forward strand of the target.
+ * For large indels contained within a single alignment, leftMappingId == rightMappingId.
+*/
+class Breakpoint
+{
+public:
+    BreakpointType type = BreakpointType::Unknown;
+    int32_t queryId = -1;
+    int32_t queryPos = 0;
+    // Unaligned query bases at the junction. Negative values denote microhomology, which is
+    // reported only for the junctions which were not realigned.
+    int32_t queryGap = 0;
+    int32_t leftMappingId = -1;
+    int32_t leftTargetId = -1;
+    bool leftTargetRev = false;
+    int32_t leftTargetPos = 0;
+    int32_t rightMappingId = -1;
+    int32_t rightTargetId = -1;
+    bool rightTargetRev = false;
+    int32_t rightTargetPos = 0;
+    int32_t svLen = 0;  // Event length for indels. Zero for split reads.
+};
+
+inline bool operator==(const Breakpoint& a, const Breakpoint& b)
+{
+    return a.type == b.type && a.queryId == b.queryId && a.queryPos == b.queryPos &&
+           a.queryGap == b.queryGap && a.leftMappingId == b.leftMappingId &&
+           a.leftTargetId == b.leftTargetId && a.leftTargetRev == b.leftTargetRev &&
+           a.leftTargetPos == b.leftTargetPos && a.rightMappingId == b.rightMappingId &&
+           a.rightTargetId == b.rightTargetId && a.rightTargetRev == b.rightTargetRev &&
+           a.rightTargetPos == b.rightTargetPos && a.svLen == b.svLen;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Breakpoint& a)
+{
+    os << "type = " << BreakpointTypeToString(a.type) << ", qid = " << a.queryId
+       << ", qpos = " << a.queryPos << ", qgap = " << a.queryGap << ", left = {"
+       << a.leftMappingId << ", " << a.leftTargetId << ", " << a.leftTargetRev << ", "
+       << a.leftTargetPos << "}, right = {" << a.rightMappingId << ", " << a.rightTargetId << ", "
+       << a.rightTargetRev << ", " << a.rightTargetPos << "}, svLen = " << a.svLen;
+    return os;
+}
+
+/*
+ * \brief Collects the split-read and large-gap evidence from the final mappings of a single query.
+ * Only primary and supplementary mappings (priority == 0) are considered. Consecutive mappings
+ * (in query coordinates) produce one breakpoint per junction. If the two mappings are colinear on the
+ * same target and strand, the junction is labelled as a deletion or an insertion; otherwise it is a split read.
+ * Without the sequences, when both mappings were aligned and they overlap in the query, the
+ * junction is refined by selecting the split point in the overlap which retains the largest
+ * number of matches in the two alignments.
+ * Indels of length >= minSVLength contained within a CIGAR of a single mapping are reported as well.
+ * The output is sorted by the query position of the junction.
+*/
+std::vector<Breakpoint> ExtractBreakpoints(
+    const std::vector<std::unique_ptr<ChainedRegion>>& mappings, int32_t queryId,
+    int32_t minSVLength);
+
+/*
+ * \brief Same as above, but each junction is realigned: the query bases around the junction are
+ * aligned to the target extending forward from the left mapping and backward from the right
+ * mapping, and the junction is placed where the two extensions score best together.
+ * The query bases between the two extensions are reported as the query gap. Junctions with the
+ * mappings far apart in the query are refined from the alignments only.
+ * The targetSeqs are indexed by the target ID.
+*/
+std::vector<Breakpoint> ExtractBreakpoints(
+    const std::vector<std::unique_ptr<ChainedRegion>>& mappings,
+    const FastaSequenceCached& querySeq, const std::vector<FastaSequenceCached>& targetSeqs,
+    int32_t queryId, int32_t minSVLength);
+
+/*
+ * \brief Same as above, for the overlaps of a single query from the HiFi mapper. The primary and
+ * supplementary mappings are the ones not marked as secondary, and the flipped overlaps are
+ * ignored. The query ID is taken from the querySeq.
+*/
+std::vector<Breakpoint> ExtractBreakpoints(const std::vector<OverlapPtr>& mappings,
+                                           const FastaSequenceCached& querySeq,
+                                           const SeqDBReaderCachedBlock& targetSeqs,
+                                           int32_t minSVLength);
+
+/*
+ * \brief Finds the indels of length >= minSVLength in the CIGAR string of an aligned mapping.
+ * The mappingId is stored in both the left and right side of each reported breakpoint.
+*/
+std::vector<Breakpoint> ExtractLargeIndelBreakpoints(const Overlap& ovl, int32_t mappingId,
+                                                     int32_t minSVLength);
+
+/*
+ * \brief Formats the SAM "SA:Z:" tag for the mapping given by mappingId, listing all other
+ * primary and supplementary mappings of the same query.
+ * Returns an empty string if there are no other such mappings.
+*/
+std::string FormatSATag(const std::vector<std::unique_ptr<ChainedRegion>>& mappings,
+                        int32_t mappingId, const std::vector<FastaSequenceCached>& targetSeqs,
+                        bool writeIds);
+
+/*
+ * \brief Same as above, for the overlaps of a single query from the HiFi mapper, where the
+ * mappings which are not marked as secondary are listed.
+*/
+std::string FormatSATag(const std::vector<OverlapPtr>& mappings, int32_t mappingId,
+                        const SeqDBReaderCachedBlock& targetSeqs, bool writeIds);
+
+/*
+ * \brief Writes a breakpoint as one BEDPE-like line. The first ten columns follow BEDPE:
+ * chrom1, start1, end1, chrom2, start2, end2, name, score, strand1, strand2. Additional columns
+ * are: type, query position of the junction, query gap and the SV length.
+*/
+void PrintBreakpointAsBEDPE(FILE* fpOut, const Breakpoint& bp, const std::string& queryName,
+                            const std::string& leftTargetName, const std::string& rightTargetName);
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_BREAKPOINT_H
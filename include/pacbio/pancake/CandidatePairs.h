@@ -0,0 +1,75 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_CANDIDATE_PAIRS_H
+#define PANCAKE_CANDIDATE_PAIRS_H
+
+#include <pacbio/pancake/SeqDBIndexCache.h>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+enum class CandidateStrand
+{
+    Any,
+    Forward,
+    Reverse,
+};
+
+/*
+ * \brief A query-target pair which should be checked for an overlap. The strand is the
+ * orientation of the target relative to the query.
+*/
+class CandidatePair
+{
+public:
+    int32_t queryId = -1;
+    int32_t targetId = -1;
+    CandidateStrand strand = CandidateStrand::Any;
+
+    bool operator==(const CandidatePair& b) const
+    {
+        return queryId == b.queryId && targetId == b.targetId && strand == b.strand;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const CandidatePair& b)
+{
+    os << "queryId = " << b.queryId << ", targetId = " << b.targetId
+       << ", strand = " << static_cast<int32_t>(b.strand);
+    return os;
+}
+
+/// \brief Parses the strand of a candidate pair: "+" or "0" is forward, "-" or "1" is reverse,
+///         and "*" is any. Throws if the value is not valid.
+CandidateStrand ParseCandidateStrand(const std::string& val);
+
+/// \brief Parses a single line of a pair list. The line contains the query, the target and
+///         optionally the strand, separated by whitespace. The query and the target are either
+///         sequence names or numeric IDs.
+/// \returns False if the line is empty or a comment (starts with '#'), true otherwise.
+///          Throws if the line is malformed.
+bool ParseCandidatePairLine(const std::string& line, std::string& retQuery,
+                            std::string& retTarget, CandidateStrand& retStrand);
+
+/// \brief Reads a pair list from a stream, line by line, and converts the sequence names to IDs.
+///         If useIds is true, the pair list specifies the numeric IDs instead of the names.
+///         Otherwise, the header lookups of both SeqDB caches need to be constructed
+///         before the call. Throws if a name cannot be found.
+std::vector<CandidatePair> ReadCandidatePairs(std::istream& is,
+                                              const SeqDBIndexCache& querySeqDBCache,
+                                              const SeqDBIndexCache& targetSeqDBCache,
+                                              bool useIds);
+
+/// \brief Sorts the pairs by query ID and target ID, and merges the duplicates. Duplicate pairs
+///         with different strands are merged into a single pair with any strand.
+void NormalizeCandidatePairs(std::vector<CandidatePair>& pairs);
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_CANDIDATE_PAIRS_H
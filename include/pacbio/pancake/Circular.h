@@ -0,0 +1,49 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_CIRCULAR_H
+#define PANCAKE_CIRCULAR_H
+
+#include <pacbio/pancake/Overlap.h>
+#include <pacbio/pancake/Seed.h>
+#include <cstdint>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * Circular targets (plasmids, organelles) are mapped by unrolling each one into two
+ * concatenated copies of itself (see SeqDBReaderCachedBlock::UnrollCircularSequences). A read
+ * which spans the origin then maps colinearly to the unrolled sequence, and is chained and
+ * aligned as a single overlap. The overlaps are then wrapped back onto the circular sequence.
+ *
+ * In the wrapped coordinates, the start of B is always in [0, Blen), and the end of B is
+ * larger than Blen if the overlap spans the origin. This holds in both strands, so the
+ * conversion between the strands (Overlap::BstartFwd, Overlap::Flip) wraps the start as well.
+ *
+ * The circular lengths are indexed by the sequence ID, and are 0 for the linear sequences.
+*/
+
+/// \brief Adds a copy of the seeds of each circular sequence, shifted to the second copy of the
+///         unrolled sequence. The copies which would extend past the end of the unrolled
+///         sequence are skipped. The input seeds need to be grouped by the sequence ID, and the
+///         copies are placed right after the seeds of their sequence.
+std::vector<SeedDB::SeedRaw> UnrollCircularSeeds(const SeedDB::SeedRaw* seeds, int64_t numSeeds,
+                                                 const std::vector<int32_t>& circularLengths);
+
+/// \brief Wraps the overlaps with the unrolled circular targets back onto the circular
+///         coordinates, and sets the B length to the circular length. The flipped overlaps
+///         (where the target is the A-read) are wrapped in the same way.
+///         A circular target has no ends, so its overlaps are either containments or internal.
+///         Each overlap is found once in each copy of the unrolled target, so the duplicates
+///         (the same target and strand, and diagonals within the bandwidth modulo the circular
+///         length) are removed, keeping the one with the best score. The best-N filters
+///         need to be applied after this, because the duplicates would take up the slots.
+void WrapCircularOverlaps(std::vector<OverlapPtr>& overlaps,
+                          const std::vector<int32_t>& circularLengths, int32_t allowedDovetailDist,
+                          int32_t diagonalBandwidth);
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_CIRCULAR_H
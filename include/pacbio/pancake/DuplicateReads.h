@@ -0,0 +1,92 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_DUPLICATE_READS_H
+#define PANCAKE_DUPLICATE_READS_H
+
+#include <pacbio/alignment/SesResults.h>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * Duplicate reads are detected without overlapping. Each read gets a fingerprint: a
+ * strand-canonical hash of the whole sequence, and a bottom-s sketch of its canonical k-mers.
+ * The exact duplicates (also on the opposite strand) share the whole-read hash, while the near
+ * duplicates share at least one sketch value. All candidates are confirmed with a single global
+ * banded alignment before they are grouped.
+ *
+ * The fingerprints and the groups are indexed by the sequence ID.
+*/
+
+class ReadFingerprint
+{
+public:
+    // Minimum of the fwd and the revcomp hashes of the whole read.
+    uint64_t hash = 0;
+    // The revcomp hash was smaller.
+    bool isRev = false;
+    int32_t length = 0;
+    // The smallest distinct hashed canonical k-mers, sorted in increasing order.
+    std::vector<uint64_t> sketch;
+};
+
+/// \brief Computes the fingerprint of a read. The k-mers which contain a non-ACGT base are
+///         skipped. Reads shorter than the k-mer size have an empty sketch.
+///         The k-mer size needs to be in [1, 32].
+ReadFingerprint ComputeReadFingerprint(const char* seq, int32_t seqLen, int32_t kmerSize,
+                                       int32_t sketchSize);
+
+/// \brief Estimates the Jaccard similarity of two reads from the bottom-s sketch of the union
+///         of their sketches.
+double EstimateSketchJaccard(const std::vector<uint64_t>& sketchA,
+                             const std::vector<uint64_t>& sketchB, int32_t sketchSize);
+
+/// \brief Pairs of reads with the same whole-read hash and length. Each member of such a group
+///         is paired with the first member, so the pairs are (first, other).
+std::vector<std::pair<int32_t, int32_t>> FindExactDuplicateCandidates(
+    const std::vector<ReadFingerprint>& fingerprints);
+
+/// \brief Pairs of reads which share at least one sketch value, have a length ratio of at
+///         least minLengthRatio, and an estimated Jaccard similarity of at least minJaccard.
+///         Only the reads listed in readIds are considered, and the sketch values shared by too
+///         many reads (repeats) are skipped. The pairs are unique and sorted, and the first read
+///         of a pair is the shorter one.
+std::vector<std::pair<int32_t, int32_t>> FindNearDuplicateCandidates(
+    const std::vector<ReadFingerprint>& fingerprints, const std::vector<int32_t>& readIds,
+    double minLengthRatio, double minJaccard, int32_t sketchSize);
+
+/// \brief Globally aligns read B to read A, first on the fwd strand and then on the reverse
+///         strand of B. The allowed number of diffs is the length difference, plus the
+///         maxDiffRate of the shorter read.
+/// \returns The number of diffs in the alignment, or -1 if the reads are not duplicates.
+int32_t AlignDuplicateCandidate(const char* seqA, int32_t lenA, const char* seqB, int32_t lenB,
+                                double maxDiffRate, bool& isRev,
+                                std::shared_ptr<Alignment::SESScratchSpace> ss = nullptr);
+
+/*
+ * Disjoint sets of the duplicate reads.
+*/
+class DuplicateGroups
+{
+public:
+    explicit DuplicateGroups(int32_t numReads);
+
+    int32_t Find(int32_t readId);
+    void Join(int32_t readIdA, int32_t readIdB);
+
+    /// \brief The representative of the group of each read: the longest read in the group,
+    ///         and the lowest ID for ties. Singletons are their own representatives.
+    std::vector<int32_t> Representatives(const std::vector<ReadFingerprint>& fingerprints);
+
+private:
+    std::vector<int32_t> parents_;
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_DUPLICATE_READS_H
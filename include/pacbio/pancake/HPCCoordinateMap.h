@@ -0,0 +1,91 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_HPC_COORDINATE_MAP_H
+#define PANCAKE_HPC_COORDINATE_MAP_H
+
+#include <pacbio/pancake/Overlap.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * Maps the coordinates of homopolymer-compressed (HPC) sequences back to the raw sequences.
+ * The run length of each HPC base is stored in a single byte, and the runs of 255 bases or
+ * longer are stored separately. Every HPC_MAP_SAMPLE_INTERVAL-th HPC position also stores the
+ * raw position, so that the conversions in both directions only need to sum up a bounded
+ * number of run lengths.
+ * This takes a bit over one byte per HPC base, compared to the two 32-bit coordinate vectors
+ * per base used by the RunLengthEncoding functions.
+*/
+class HPCCoordinateMap
+{
+public:
+    HPCCoordinateMap() = default;
+
+    /// \brief Adds the run lengths of a sequence, one for each HPC base. If the sequence was
+    ///         added before, it is replaced.
+    void AddSequence(int32_t seqId, const int32_t* runLengths, int32_t hpcLen);
+
+    void Clear();
+
+    bool HasSequence(int32_t seqId) const;
+    int32_t HPCLength(int32_t seqId) const;
+    int32_t RawLength(int32_t seqId) const;
+    int32_t RunLength(int32_t seqId, int32_t hpcPos) const;
+
+    /// \brief Run lengths of the HPC range [hpcStart, hpcEnd). The end can be up to twice the
+    ///         HPC length, for the ranges which span the origin of a circular sequence.
+    std::vector<int32_t> RunLengths(int32_t seqId, int32_t hpcStart, int32_t hpcEnd) const;
+
+    /// \brief Raw position of the first base of the run at the given HPC position. The HPC
+    ///         length maps to the raw length.
+    int32_t ToRaw(int32_t seqId, int32_t hpcPos) const;
+
+    /// \brief HPC position of the run which contains the given raw position. The raw length
+    ///         maps to the HPC length.
+    int32_t ToHPC(int32_t seqId, int32_t rawPos) const;
+
+    /// \brief Reconstructs the raw bases of the HPC range [hpcStart, hpcEnd) of a sequence.
+    std::string ExpandSequence(int32_t seqId, const char* hpcSeq, int32_t hpcStart,
+                               int32_t hpcEnd) const;
+
+    int64_t MemoryUsage() const;
+
+private:
+    struct SequenceInfo
+    {
+        int64_t runStart = 0;
+        int64_t sampleStart = 0;
+        int32_t hpcLen = 0;
+        int32_t rawLen = 0;
+    };
+
+    std::vector<uint8_t> runs_;
+    std::vector<int32_t> samples_;
+    std::unordered_map<int64_t, int32_t> longRuns_;
+    std::unordered_map<int32_t, SequenceInfo> seqs_;
+
+    const SequenceInfo& GetSequenceInfo_(int32_t seqId) const;
+    int32_t RunAt_(int64_t runPos) const;
+};
+
+/// \brief Lifts the coordinates of an overlap computed on the HPC sequences to the raw
+///         sequences. The A-read needs to be in the fwd orientation, and the overlaps with
+///         circular targets may span the origin, as produced by WrapCircularOverlaps.
+///         If the overlap has a CIGAR, each HPC base pair is expanded to its runs, and the
+///         difference of the run lengths becomes an insertion or a deletion. The variant strings
+///         are expanded along with the CIGAR, and the homopolymer length differences are written
+///         in lowercase, as they were not considered by the alignment.
+///         The score, identity and edit distance remain as computed on the HPC sequences.
+/// \param aSeqHPC The HPC sequence of the A-read, used only to expand the variant strings.
+void LiftOverlapToRaw(Overlap& ovl, const HPCCoordinateMap& aMap, const HPCCoordinateMap& bMap,
+                      const char* aSeqHPC);
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_HPC_COORDINATE_MAP_H
@@ -110,6 +110,7 @@ inline std::ostream& operator<<(std::ostream& out, const MapperCLRSettings& a)
         << "seedParams.UseHPCForSeedsOnly = " << a.seedParams.UseHPCForSeedsOnly << "\n"
         << "seedParams.MaxHPCLen = " << a.seedParams.MaxHPCLen << "\n"
         << "seedParams.UseRC = " << a.seedParams.UseRC << "\n"
+        << "seedParams.Scheme = " << SeedDB::SeedingSchemeToString(a.seedParams.Scheme) << "\n"
 
         << "seedParamsFallback.KmerSize = " << a.seedParamsFallback.KmerSize << "\n"
         << "seedParamsFallback.MinimizerWindow = " << a.seedParamsFallback.MinimizerWindow << "\n"
@@ -119,6 +120,8 @@ inline std::ostream& operator<<(std::ostream& out, const MapperCLRSettings& a)
         << "\n"
         << "seedParamsFallback.MaxHPCLen = " << a.seedParamsFallback.MaxHPCLen << "\n"
         << "seedParamsFallback.UseRC = " << a.seedParamsFallback.UseRC << "\n"
+        << "seedParamsFallback.Scheme = "
+        << SeedDB::SeedingSchemeToString(a.seedParamsFallback.Scheme) << "\n"
 
         << "freqPercentile = " << a.freqPercentile << "\n"
 
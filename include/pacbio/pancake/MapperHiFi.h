@@ -5,10 +5,13 @@
 
 #include <pacbio/alignment/SesResults.h>
 #include <pacbio/overlaphifi/OverlapHifiSettings.h>
+#include <pacbio/pancake/CandidatePairs.h>
 #include <pacbio/pancake/FastaSequenceCached.h>
+#include <pacbio/pancake/MinimizerSpaceIndex.h>
 #include <pacbio/pancake/Overlap.h>
 #include <pacbio/pancake/Seed.h>
 #include <pacbio/pancake/SeedDBIndexCache.h>
+#include <pacbio/pancake/SeedDBReaderCachedBlock.h>
 #include <pacbio/pancake/SeedIndex.h>
 #include <pacbio/pancake/SeqDBReaderCachedBlock.h>
 #include <pacbio/pancake/SequenceSeedsCached.h>
@@ -26,6 +29,128 @@ class MapperResult
 {
 public:
     std::vector<PacBio::Pancake::OverlapPtr> overlaps;
+    // Work statistics, used for progress reporting. In the minimizer-space mode,
+    // the hits are the matched regions of the minimizer strings.
+    int64_t numHits = 0;
+    int64_t numAlignments = 0;
+    int64_t numBandWidenings = 0;
+};
+
+/// \brief Groups the overlap types for the per-end best N selection: 5' dovetails,
+///         3' dovetails, containments in either direction and internal overlaps.
+enum class OverlapEndClass
+{
+    FivePrime,
+    ThreePrime,
+    Containment,
+    Internal,
+};
+
+constexpr int32_t NUM_OVERLAP_END_CLASSES = 4;
+
+OverlapEndClass GetOverlapEndClass(OverlapType type);
+
+/// \brief Keeps at most bestNPerEnd overlaps of each end class (classified by Atype), and then
+///         at most bestN of the remaining ones. Either limit is disabled if <= 0.
+///         The input needs to be sorted by score, best first.
+/// \returns The removed overlaps, in the order of the input.
+std::vector<OverlapPtr> KeepBestOverlaps(std::vector<OverlapPtr>& sortedOverlaps, int32_t bestN,
+                                         int32_t bestNPerEnd);
+
+/// \brief Merges the colinear anchors of the same target and strand which were split into
+///         separate diagonal bins by a large indel. The anchors are chained sparsely: each anchor
+///         scores its number of seeds, and each join is penalized by the diagonal shift between
+///         the two anchors. Joins with a shift larger than minIndelLen are recorded in the
+///         merged overlap as long indels, and the first hit after each join is flagged as a
+///         long join. The merged anchors are then filtered in the same way as in FormAnchors2_.
+/// \param overlaps Anchors, as formed by the FormAnchors2_.
+/// \param anchorHits If not nullptr, this vector is expected to be of the same size as
+///                   overlaps, and will be merged in the same way.
+/// \param maxGap Maximum distance between two joined anchors, in both the query and the target.
+/// \param minIndelLen Minimum diagonal shift of a join to record it as a long indel.
+/// \returns The merged anchors, in the order of their first anchor in the input.
+std::vector<OverlapPtr> MergeColinearAnchors(const std::vector<OverlapPtr>& overlaps,
+                                             std::vector<std::vector<SeedHit>>* anchorHits,
+                                             int32_t maxGap, int32_t minIndelLen,
+                                             int32_t minNumSeeds, int32_t minChainSpan);
+
+/// \brief Removes the chained hits which step away from the diagonal and return back to it,
+///         and the short runs of hits on a different diagonal at either end of the chain.
+///         The hits after a long join are never considered a detour. At least two hits are
+///         always kept.
+/// \param hits Chained seed hits, sorted by query and target positions.
+/// \param diagTolerance Maximum diagonal difference between two hits on the same diagonal.
+/// \param minEndRunSpan End runs with a shorter query span than this are removed.
+std::vector<SeedHit> FilterDetourHits(const std::vector<SeedHit>& hits, int32_t diagTolerance,
+                                      int32_t minEndRunSpan);
+
+/*
+ * \brief Decides the order in which the candidate overlaps are aligned when only the best N
+ * overlaps are kept (--bestn and/or --bestn-per-end), and which candidates can be skipped.
+ *
+ * The score of an aligned overlap is bounded by the length of the longest alignment which can
+ * pass through the start of the anchor, i.e. the anchor extended along its diagonal to the
+ * sequence ends. The candidates are aligned from the best bound down, and a candidate is
+ * skipped once the best N accepted alignments are strictly better than its bound.
+ * For the per-end limit, the end class of a candidate is predicted from the same extension of
+ * the anchor. Both the bound and the prediction assume that the alignment follows the anchor
+ * up to the ends of the reads, which does not hold e.g. when the alignment stops short of the
+ * ends, or when the piecewise alignment drops the detour hits. Each alignment is checked against
+ * them, and after the first violation nothing is skipped anymore, and the candidates skipped
+ * so far are returned for alignment by TakeSkipped.
+ * The scheduler is inactive if no limit is set, or if the secondary overlaps are marked,
+ * because marking can remove alignments after they were accepted.
+*/
+class AlignmentScheduler
+{
+public:
+    AlignmentScheduler(const std::vector<OverlapPtr>& candidates,
+                       const OverlapHifiSettings& settings);
+
+    bool IsActive() const { return isActive_; }
+
+    /// \brief Candidate IDs in the order in which they should be aligned.
+    const std::vector<int32_t>& Order() const { return order_; }
+
+    /// \brief Returns false if the candidate cannot be among the kept overlaps anymore.
+    ///         The skipped candidates are counted.
+    bool ShouldAlign(int32_t candidateId);
+
+    /// \brief Records the aligned overlap of a candidate, and checks it against the score
+    ///         bound and the predicted end class. The alignments which would not pass the filters
+    ///         of the FilterOverlaps_ do not count towards the limits.
+    void AddAligned(int32_t candidateId, const Overlap& ovl);
+
+    /// \brief If a prediction was violated, returns the candidates skipped so far, which then
+    ///         need to be aligned, and no longer counts them as skipped. Otherwise empty.
+    std::vector<int32_t> TakeSkipped();
+
+    bool IsPredictionViolated() const { return isPredictionViolated_; }
+    int32_t NumSkipped() const { return skipped_.size(); }
+
+private:
+    class AcceptedAlignment
+    {
+    public:
+        float score = 0.0f;
+        OverlapEndClass endClass = OverlapEndClass::Internal;
+    };
+
+    const OverlapHifiSettings& settings_;
+    bool isActive_ = false;
+    std::vector<int32_t> order_;
+    std::vector<float> scoreBounds_;
+    std::vector<OverlapEndClass> predictedEndClasses_;
+    // The best accepted alignment for each target and strand, because the duplicate overlaps
+    // of the same target are removed in the FilterOverlaps_.
+    std::unordered_map<int64_t, AcceptedAlignment> accepted_;
+    // The score of the worst kept overlap when the limit is reached, or +inf.
+    float globalThreshold_;
+    std::vector<float> endClassThresholds_;
+    std::vector<int32_t> skipped_;
+    bool isPredictionViolated_ = false;
+
+    void UpdateThresholds_();
 };
 
 class Mapper
@@ -54,10 +179,90 @@ public:
                      const PacBio::Pancake::SequenceSeedsCached& querySeeds, int64_t freqCutoff,
                      bool generateFlippedOverlap) const;
 
+    /// \brief Maps a single query to a given set of targets in minimizer space. Instead of
+    ///         collecting and chaining the seed hits, the overlaps are found by merging the
+    ///         minimizer strings of the query and the targets. The overlaps are not aligned,
+    ///         and their identity is estimated from the fraction of shared minimizers.
+    ///
+    /// \param targetSeqs Cached target sequences (i.e. a single block of sequences).
+    /// \param index The minimizer-space index of the targets.
+    /// \param querySeq The query sequence which will be mapped.
+    /// \param querySeeds Precomputed seeds for the query sequence.
+    /// \param freqCutoff Maximum allowed frequency of any particular k-min-mer to retain it.
+    /// \returns An object which contains a vector of all found overlaps.
+    ///
+    MapperResult Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                     const PacBio::Pancake::MinimizerSpaceIndex& index,
+                     const PacBio::Pancake::FastaSequenceCached& querySeq,
+                     const PacBio::Pancake::SequenceSeedsCached& querySeeds, int64_t freqCutoff,
+                     bool generateFlippedOverlap) const;
+
+    /// \brief Maps a single query only to the given candidate targets, without a seed index.
+    ///         The seed hits with each target are collected by a merge join of the query and
+    ///         the target seeds, and then chained, aligned and filtered in the same way as in
+    ///         the index-based mapping.
+    ///
+    /// \param targetSeqs Cached target sequences (i.e. a single block of sequences).
+    /// \param targetSeeds Seeds of the same target sequences, sorted within each sequence.
+    /// \param targetLengths Lengths of the target sequences, indexed by the target ID.
+    /// \param kmerSize The k-mer size used to compute the seeds.
+    /// \param querySeq The query sequence which will be mapped.
+    /// \param querySeeds Precomputed seeds for the query sequence.
+    /// \param candidates The targets and strands to check. All of them need to have the ID of
+    ///                   the query sequence. This is usually a range within a larger sorted
+    ///                   pair list, so that the candidates are not copied.
+    /// \param numCandidates Number of candidates in the range.
+    /// \param freqCutoff Seeds which occur more than this many times within a single target
+    ///                   are skipped. If <= 0, no seeds are skipped.
+    /// \returns An object which contains a vector of all found overlaps.
+    ///
+    MapperResult MapCandidates(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                               const PacBio::Pancake::SortedSequenceSeeds& targetSeeds,
+                               const std::vector<int32_t>& targetLengths, int32_t kmerSize,
+                               const PacBio::Pancake::FastaSequenceCached& querySeq,
+                               const PacBio::Pancake::SequenceSeedsCached& querySeeds,
+                               const CandidatePair* candidates, int64_t numCandidates,
+                               int64_t freqCutoff, bool generateFlippedOverlap) const;
+
+    /// \brief Performs alignment and alignment extension of a single overlap, but instead of
+    ///        running a single O(nd) alignment over the entire overlap, the overlap is split
+    ///        into regions between the chained seed hits (ExtractAlignmentRegions). Each region
+    ///        is aligned globally with a small diff budget, and the unaligned flanks are extended
+    ///        in the same way as in AlignOverlap_. The memory and time consumption are bounded
+    ///        by the distance between the hits instead of the overlap length.
+    ///        If there are no inner regions, or if any of them cannot be aligned within the
+    ///        allowed diffs, this falls back to AlignOverlap_.
+    /// \param anchorHits Chained seed hits of the overlap, sorted by query and target positions.
+    ///                   The first and the last hit must match the overlap coordinates.
+    /// \param minAlignmentSpan Minimum query and target distance between two consecutive hits
+    ///                         used as region boundaries.
+    /// All other parameters are the same as in AlignOverlap_.
+    /// \returns A new vector overlap with alignment information and modified coordinates.
+    ///
+    static OverlapPtr AlignOverlapPiecewise(
+        const PacBio::Pancake::FastaSequenceCached& targetSeq,
+        const PacBio::Pancake::FastaSequenceCached& querySeq, const std::string reverseQuerySeq,
+        const OverlapPtr& ovl, const std::vector<SeedHit>& anchorHits, int32_t minAlignmentSpan,
+        double alignBandwidth, double alignMaxDiff, int32_t alignMaxWidenings, bool useTraceback,
+        bool noSNPs, bool noIndels, bool maskHomopolymers, bool maskSimpleRepeats,
+        bool maskHomopolymerSNPs, bool maskHomopolymersArbitrary, bool trimAlignment,
+        int32_t trimWindowSize, double trimMatchFraction, bool trimToFirstMatch,
+        std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch,
+        int64_t* numWidenings);
+
 private:
     OverlapHifiSettings settings_;
     std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch_;
 
+    /// \brief Forms the anchors from the seed hits, and then aligns and filters them.
+    ///         Shared by the index-based and the candidate-based mapping.
+    /// \param hits The seed hits of the query. They will be sorted in place.
+    ///
+    MapperResult MapHits_(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                          const std::vector<int32_t>& targetLengths, int32_t kmerSize,
+                          const PacBio::Pancake::FastaSequenceCached& querySeq,
+                          std::vector<SeedHit>& hits, bool generateFlippedOverlap) const;
+
     /// \brief Writes the seed hits to a specified file, in a CSV format, useful for visualization.
     /// The header line contains:
     ///     <queryName> <queryStart> <querySpan> <targetName> <targetStart> <targetSpan> 0.0
@@ -81,7 +286,7 @@ private:
     /// \param sortedHits Hits should be sorted in the following order of priority:
     ///                   (targetID, targetReverse, diagonal, targetPos, queryPos)
     /// \param querySeq The query sequence.
-    /// \param indexCache is needed to fetch the length of the target sequences.
+    /// \param targetLengths Lengths of the target sequences, indexed by the target ID.
     /// \param chainBandwidth Allowed diagonal bandwidth to bin hits together.
     /// \param minNumSeeds Minimum number of seeds per diagonal bin to retain it.
     /// \param minChainSpan Minimum span (in either query or target coordinates) of the
@@ -92,21 +297,28 @@ private:
     static std::vector<OverlapPtr> FormAnchors_(
         const std::vector<SeedHit>& sortedHits,
         const PacBio::Pancake::FastaSequenceCached& querySeq,
-        const PacBio::Pancake::SeedIndex& index, int32_t chainBandwidth, int32_t minNumSeeds,
+        const std::vector<int32_t>& targetLengths, int32_t chainBandwidth, int32_t minNumSeeds,
         int32_t minChainSpan, bool skipSelfHits, bool skipSymmetricOverlaps);
 
+    /// \brief Forms anchors by binning seeds in narrow diagonals, and then chaining the
+    ///         hits within each bin using the LIS.
+    /// \param kmerSize The k-mer size of the seeds, used to refine the ends of the chains.
+    /// \param retAnchorHits If not nullptr, the chained hits of each returned overlap will be
+    ///                      stored here, in the same order as the overlaps.
+    ///
     static std::vector<OverlapPtr> FormAnchors2_(
         const std::vector<SeedHit>& sortedHits,
         const PacBio::Pancake::FastaSequenceCached& querySeq,
-        const PacBio::Pancake::SeedIndex& index, int32_t chainBandwidth, int32_t minNumSeeds,
-        int32_t minChainSpan, int32_t minMatch, bool skipSelfHits, bool skipSymmetricOverlaps);
+        const std::vector<int32_t>& targetLengths, int32_t kmerSize, int32_t chainBandwidth,
+        int32_t minNumSeeds, int32_t minChainSpan, int32_t minMatch, bool skipSelfHits,
+        bool skipSymmetricOverlaps, std::vector<std::vector<SeedHit>>* retAnchorHits);
 
     /// \brief  Helper function used by FormDiagonalAnchors_ which creates a new overlap object
     ///         based on the minimum and maximum hit IDs.
     /// \param sortedHits Hits should be sorted in the following order of priority:
     ///                   (targetID, targetReverse, diagonal, targetPos, queryPos)
     /// \param querySeq The query sequence.
-    /// \param indexCache is needed to fetch the length of the target sequences.
+    /// \param targetLengths Lengths of the target sequences, indexed by the target ID.
     /// \param beginId The ID of the first element in sortedHits corresponding to the current
     ///                diagonal bin for which we're constructing the overlap.
     /// \param endId The ID of the last element in sortedHits corresponding to the current
@@ -117,8 +329,29 @@ private:
     ///
     static OverlapPtr MakeOverlap_(const std::vector<SeedHit>& sortedHits,
                                    const PacBio::Pancake::FastaSequenceCached& querySeq,
-                                   const PacBio::Pancake::SeedIndex& index, int32_t numSeeds,
-                                   int32_t minTargetPosId, int32_t maxTargetPosId);
+                                   const std::vector<int32_t>& targetLengths,
+                                   int32_t numSeeds, int32_t minTargetPosId,
+                                   int32_t maxTargetPosId);
+
+    /// \brief Converts the minimizer-space matches into overlaps. The coordinates of the matches
+    ///         which reach the first or the last minimizer of a sequence are projected along the
+    ///         diagonal to the end of that sequence.
+    /// \param matches Matches found by the MinimizerSpaceIndex.
+    /// \param querySeq The query sequence.
+    /// \param index is needed to fetch the length of the target sequences.
+    /// \param minChainSpan Minimum span (in either query or target coordinates) of a match.
+    ///
+    static std::vector<OverlapPtr> MakeMinimizerSpaceOverlaps_(
+        const std::vector<PacBio::Pancake::MinimizerSpaceMatch>& matches,
+        const PacBio::Pancake::FastaSequenceCached& querySeq,
+        const PacBio::Pancake::MinimizerSpaceIndex& index, int32_t minChainSpan);
+
+    /// \brief Flags the secondary and supplementary overlaps, and removes all other
+    ///         non-primary overlaps.
+    ///
+    static std::vector<OverlapPtr> MarkSecondaryOverlaps_(std::vector<OverlapPtr>& overlaps,
+                                                          double allowedOverlapFraction,
+                                                          double minScoreFraction);
 
     /// \brief Performs alignment and alignment extension of a given vector of overlaps.
     ///         A thin wrapper around AlignOverlap_, simply calls it for each overlap.
@@ -130,6 +363,8 @@ private:
     ///                       O(nd) algorithm
     /// \param alignMaxDiff The maximum number of diffs allowed between the query and target pair.
     ///                     This is a parameter of the O(nd) algorithm.
+    /// \param alignMaxWidenings How many times the bandwidth and the diff budget of a flank
+    ///                          alignment can be doubled when the alignment runs out of either.
     /// \param useTraceback Runs alignment with traceback, for more accurate
     ///                     identity computation (in terms of mismatches) and CIGAR construction.
     /// \param noSNPs Ignore SNPs when computing the alignment identity.
@@ -137,18 +372,34 @@ private:
     /// \param maskHomopolymers Ignore homopolymer errors when computing the alignment identity.
     ///                             Also, converts them to lowercase in the variant strings.
     /// \param maskSimpleRepeats Ignores indel errors in simple repeats, such as di-nuc.
+    /// \param anchorHits Chained seed hits for each overlap, in the same order as overlaps.
+    ///                   Used only if alignPiecewise is true.
+    /// \param alignPiecewise Align each overlap piecewise between the anchorHits
+    ///                       (AlignOverlapPiecewise) instead of a single alignment over
+    ///                       the entire overlap (AlignOverlap_).
+    /// \param piecewiseMinSpan Minimum query and target distance between two consecutive hits
+    ///                         used as boundaries of piecewise alignment.
     /// \param sesScratch The memory scratch space for alignment. Providing a pointer to default
     ///                     constructed object is enough.
-    /// \returns A new vector of overlaps with alignment information and modified coordinates.
+    /// \param scheduler If not nullptr and active, determines the order of alignment and
+    ///                   which overlaps do not need to be aligned.
+    /// \param numWidenings If not nullptr, the number of band widenings of all alignments is
+    ///                     added to it.
+    /// \returns A new vector of overlaps with alignment information and modified coordinates,
+    ///          in the same order as the input overlaps.
     ///
     static std::vector<OverlapPtr> AlignOverlaps_(
         const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
         const PacBio::Pancake::FastaSequenceCached& querySeq, const std::string reverseQuerySeq,
         const std::vector<OverlapPtr>& overlaps, double alignBandwidth, double alignMaxDiff,
-        bool useTraceback, bool noSNPs, bool noIndels, bool maskHomopolymers,
-        bool maskSimpleRepeats, bool maskHomopolymerSNPs, bool maskHomopolymersArbitrary,
-        bool trimAlignment, int32_t trimWindowSize, double trimMatchFraction, bool trimToFirstMatch,
-        std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch);
+        int32_t alignMaxWidenings, bool useTraceback, bool noSNPs, bool noIndels,
+        bool maskHomopolymers, bool maskSimpleRepeats, bool maskHomopolymerSNPs,
+        bool maskHomopolymersArbitrary, bool trimAlignment, int32_t trimWindowSize,
+        double trimMatchFraction, bool trimToFirstMatch,
+        const std::vector<std::vector<SeedHit>>& anchorHits, bool alignPiecewise,
+        int32_t piecewiseMinSpan,
+        std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch,
+        AlignmentScheduler* scheduler, int64_t* numWidenings);
 
     /// \brief Generates a set of flipped overlaps from a given set of overlaps. A flipped overlap
     ///         is when the A-read and B-read change places, but the A-read is still always kept in
@@ -179,18 +430,23 @@ private:
     ///                       O(nd) algorithm
     /// \param alignMaxDiff The maximum number of diffs allowed between the query and target pair.
     ///                     This is a parameter of the O(nd) algorithm.
+    /// \param alignMaxWidenings How many times the bandwidth and the diff budget of a flank
+    ///                          alignment can be doubled when the alignment runs out of either.
     /// \param useTraceback Runs alignment with traceback, for more accurate
     ///                     identity computation (in terms of mismatches) and CIGAR construction.
+    /// \param numWidenings If not nullptr, the number of band widenings is added to it.
     /// \returns A new vector overlap with alignment information and modified coordinates.
     ///
     static OverlapPtr AlignOverlap_(
         const PacBio::Pancake::FastaSequenceCached& targetSeq,
         const PacBio::Pancake::FastaSequenceCached& querySeq, const std::string reverseQuerySeq,
-        const OverlapPtr& ovl, double alignBandwidth, double alignMaxDiff, bool useTraceback,
-        bool noSNPs, bool noIndels, bool maskHomopolymers, bool maskSimpleRepeats,
-        bool maskHomopolymerSNPs, bool maskHomopolymersArbitrary, bool trimAlignment,
-        int32_t trimWindowSize, double trimMatchFraction, bool trimToFirstMatch,
-        std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch);
+        const OverlapPtr& ovl, double alignBandwidth, double alignMaxDiff,
+        int32_t alignMaxWidenings, bool useTraceback, bool noSNPs, bool noIndels,
+        bool maskHomopolymers, bool maskSimpleRepeats, bool maskHomopolymerSNPs,
+        bool maskHomopolymersArbitrary, bool trimAlignment, int32_t trimWindowSize,
+        double trimMatchFraction, bool trimToFirstMatch,
+        std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch,
+        int64_t* numWidenings);
 
     static void NormalizeAndExtractVariantsInPlace_(
         OverlapPtr& ovl, const PacBio::Pancake::FastaSequenceCached& targetSeq,
@@ -212,6 +468,8 @@ private:
     ///                          coordinates, but only if the unaligned flank is < allowedExtendDist.
     /// \param bestN Keep only best N overlaps. If bestN <= 0, all overlaps are kept. This keeps overall best
     ///               overlaps and it's not side specific (i.e. this bestN does not care about 5' or 3' ends).
+    /// \param bestNPerEnd Keep only best N overlaps of each end class (see OverlapEndClass), before
+    ///                     the bestN is applied. If bestNPerEnd <= 0, this limit is not applied.
     /// \returns A new vector of remaining overlaps.
     ///
     static std::vector<OverlapPtr> FilterOverlaps_(const std::vector<OverlapPtr>& overlaps,
@@ -219,14 +477,18 @@ private:
                                                    int32_t minMappedSpan, int32_t minQueryLen,
                                                    int32_t minTargetLen, int32_t diagonalBandwidth,
                                                    int32_t allowedDovetailDist,
-                                                   int32_t allowedExtendDist, int32_t bestN);
+                                                   int32_t allowedExtendDist, int32_t bestN,
+                                                   int32_t bestNPerEnd);
     /// \brief  Filters multiple overlaps for the same query-target pair, for example tandem repeats,
     ///         and keeps only the longest spanning overlap. The maximum of (querySpan, targetSpan)
     ///         is taken for a particular query-target pair for comparison.
     /// \param overlaps A vector of overlaps to filter.
+    /// \param anchorHits If not nullptr, this vector is expected to be of the same size as
+    ///                   overlaps, and will be filtered in the same way.
     /// \return A vector of filtered overlaps.
     ///
-    static std::vector<OverlapPtr> FilterTandemOverlaps_(const std::vector<OverlapPtr>& overlaps);
+    static std::vector<OverlapPtr> FilterTandemOverlaps_(
+        const std::vector<OverlapPtr>& overlaps, std::vector<std::vector<SeedHit>>* anchorHits);
 
     /// \brief  Helper function which extracts a subsequence from a given sequence, and reverse
     ///         complements if needed.
@@ -242,6 +504,11 @@ private:
 
     static std::string FetchTargetSubsequence_(const char* seq, int32_t seqLen, int32_t seqStart,
                                                int32_t seqEnd, bool revCmp);
+
+    /// \brief  Throws if the range [seqStart, seqEnd) is not valid for a sequence of
+    ///         length seqLen.
+    ///
+    static void CheckTargetRange_(int32_t seqLen, int32_t seqStart, int32_t seqEnd);
 };
 
 }  // namespace OverlapHiFi
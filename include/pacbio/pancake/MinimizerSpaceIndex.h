@@ -0,0 +1,156 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_MINIMIZER_SPACE_INDEX_H
+#define PANCAKE_MINIMIZER_SPACE_INDEX_H
+
+#include <pacbio/pancake/Seed.h>
+#include <pacbio/pancake/SeedDBParameters.h>
+#include <pacbio/pancake/SeedIndex.h>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * \brief A region where the minimizer strings of the query and a target agree.
+ * The target coordinates are in the strand of the target given by targetRev, same as for
+ * the SeedHit. The reachesStart and reachesEnd flags are set if the matching minimizers
+ * extend up to the first or the last minimizer of either sequence (within the allowed skip),
+ * which means that the overlap can be extended to the sequence ends.
+*/
+class MinimizerSpaceMatch
+{
+public:
+    int32_t targetId = 0;
+    bool targetRev = false;
+    int32_t queryStart = 0;
+    int32_t queryEnd = 0;
+    int32_t targetStart = 0;
+    int32_t targetEnd = 0;
+    int32_t numSharedSeeds = 0;
+    int32_t numQuerySeeds = 0;
+    int32_t numTargetSeeds = 0;
+    bool reachesStart = false;
+    bool reachesEnd = false;
+
+    bool operator==(const MinimizerSpaceMatch& b) const
+    {
+        return targetId == b.targetId && targetRev == b.targetRev &&
+               queryStart == b.queryStart && queryEnd == b.queryEnd &&
+               targetStart == b.targetStart && targetEnd == b.targetEnd &&
+               numSharedSeeds == b.numSharedSeeds && numQuerySeeds == b.numQuerySeeds &&
+               numTargetSeeds == b.numTargetSeeds && reachesStart == b.reachesStart &&
+               reachesEnd == b.reachesEnd;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const MinimizerSpaceMatch& a)
+{
+    os << "targetId = " << a.targetId << ", targetRev = " << a.targetRev
+       << ", queryStart = " << a.queryStart << ", queryEnd = " << a.queryEnd
+       << ", targetStart = " << a.targetStart << ", targetEnd = " << a.targetEnd
+       << ", numSharedSeeds = " << a.numSharedSeeds << ", numQuerySeeds = " << a.numQuerySeeds
+       << ", numTargetSeeds = " << a.numTargetSeeds << ", reachesStart = " << a.reachesStart
+       << ", reachesEnd = " << a.reachesEnd;
+    return os;
+}
+
+/*
+ * \brief Index for overlapping in minimizer space. Each sequence is represented as a string of
+ * its seed keys ordered by position, and every run of kMinMerSize consecutive keys
+ * (a k-min-mer) is indexed. The k-min-mers are canonical, so that a sequence and its reverse
+ * complement produce the same k-min-mers.
+ * Candidate overlaps are found by k-min-mer lookup, and verified by a linear merge of the two
+ * minimizer strings, without collecting and chaining the individual seed hits.
+*/
+class MinimizerSpaceIndex
+{
+public:
+    MinimizerSpaceIndex(const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams,
+                        const std::vector<int32_t>& sequenceLengths,
+                        std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds,
+                        int32_t kMinMerSize);
+    ~MinimizerSpaceIndex();
+
+    /// \brief Computes the occurrence statistics of the indexed k-min-mers. The cutoff is
+    ///         used in the same way as for the SeedIndex.
+    void ComputeFrequencyStats(double percentileCutoff, int64_t& retFreqMax, double& retFreqAvg,
+                               double& retFreqMedian, int64_t& retFreqCutoff) const;
+
+    /// \brief Finds all regions where the minimizer string of the query agrees with the
+    ///         minimizer string of a target. Colinear regions on the same diagonal are
+    ///         joined into a single match, even if they are separated by more than
+    ///         maxSkip differing minimizers.
+    ///
+    /// \param querySeeds Seeds of the query. Do not need to be sorted.
+    /// \param querySeedsSize Number of query seeds.
+    /// \param queryId ID of the query, used to skip the self and symmetric matches.
+    /// \param freqCutoff K-min-mers which occur more often than this are ignored. Ignored if <= 0.
+    /// \param maxSkip Maximum number of consecutive minimizers on either sequence which can
+    ///                 be skipped in the merge, e.g. because a sequencing error changed them.
+    /// \param maxDiagonalDiff Maximum change of the diagonal between two consecutive
+    ///                         matching minimizers.
+    /// \param skipSelfHits Ignore matches where the target ID equals the queryId.
+    /// \param skipSymmetricOverlaps Ignore matches where the target ID is larger than the queryId.
+    /// \param matches Output vector of matches, cleared internally.
+    ///
+    void FindMatches(const PacBio::Pancake::SeedDB::SeedRaw* querySeeds, int64_t querySeedsSize,
+                     int32_t queryId, int64_t freqCutoff, int32_t maxSkip,
+                     int32_t maxDiagonalDiff, bool skipSelfHits, bool skipSymmetricOverlaps,
+                     std::vector<MinimizerSpaceMatch>& matches) const;
+
+    const PacBio::Pancake::SeedDB::SeedDBParameters& GetSeedParams() const { return seedParams_; }
+
+    int32_t GetKMinMerSize() const { return kMinMerSize_; }
+
+    int32_t GetSequenceLength(int32_t seqId) const
+    {
+        // Sanity check for the sequence ID.
+        if (seqId < 0 || seqId >= static_cast<int32_t>(sequenceLengths_.size())) {
+            std::ostringstream oss;
+            oss << "Invalid seqId. seqId = " << seqId
+                << ", sequenceLengths_.size() = " << sequenceLengths_.size();
+            throw std::runtime_error(oss.str());
+        }
+        return sequenceLengths_[seqId];
+    }
+
+private:
+    class KMinMer
+    {
+    public:
+        uint64_t hash = 0;
+        int32_t seqId = 0;
+        int32_t firstSeedId = 0;  // Index of the first seed of the k-min-mer in the sequence.
+        bool isRev = false;
+    };
+
+    // All seeds, sorted by the sequence ID and then the position.
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw> seeds_;
+    // Range of each sequence in seeds_, indexed by the sequence ID.
+    std::vector<std::pair<int64_t, int64_t>> sequenceRanges_;
+    // All k-min-mers, sorted by hash. The hash_ points to ranges in this vector.
+    std::vector<KMinMer> kMinMers_;
+    SeedHashType hash_;
+    PacBio::Pancake::SeedDB::SeedDBParameters seedParams_;
+    std::vector<int32_t> sequenceLengths_;
+    int32_t kMinMerSize_;
+
+    void BuildIndex_();
+
+    /// \brief Appends the canonical k-min-mers of a string of seeds sorted by position.
+    ///         The palindromic k-min-mers are skipped.
+    static void ComputeKMinMers_(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int32_t numSeeds,
+                                 int32_t seqId, int32_t kMinMerSize,
+                                 std::vector<KMinMer>& retKMinMers);
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_MINIMIZER_SPACE_INDEX_H
@@ -5,6 +5,7 @@
 
 #include <pacbio/pancake/FastaSequenceCached.h>
 #include <pacbio/pancake/Seed.h>
+#include <pacbio/pancake/SeedDBParameters.h>
 #include <pacbio/pancake/SeedHit.h>
 #include <pacbio/util/CommonTypes.h>
 #include <array>
@@ -58,6 +59,55 @@ void GenerateMinimizers(std::vector<PacBio::Pancake::Int128t>& retSeeds,
                         const bool useReverseComplement, const bool useHPC,
                         const int32_t maxHPCLen);
 
+/*
+ * Open syncmers are kmers whose smallest s-mer (by hash) is in the middle of the kmer, and closed
+ * syncmers are kmers whose smallest s-mer is at either end. Unlike minimizers, the selection of a
+ * kmer does not depend on its neighbours, so a substitution only affects the kmers which
+ * contain it.
+ * With useHPC, the kmers skip the homopolymer bases, and homopolymers of maxHPCLen or longer
+ * are skipped entirely. The seed coordinates are in the original sequence.
+ */
+int GenerateSyncmers(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                     const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                     const int32_t kmerSize, const int32_t syncmerSize, const bool closedSyncmers,
+                     const bool useReverseComplement, const bool useHPC, const int32_t maxHPCLen);
+
+/*
+ * Randstrobes link each open syncmer to a second syncmer between strobeMinDist and strobeMaxDist
+ * bases downstream (or upstream, depending on the strand of the first kmer), picked by the hash of
+ * both kmers. The seed spans both strobes, so an indel between them does not destroy the seed.
+ */
+int GenerateRandstrobes(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                        const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                        const int32_t kmerSize, const int32_t syncmerSize,
+                        const int32_t strobeMinDist, const int32_t strobeMaxDist,
+                        const bool useReverseComplement, const bool useHPC,
+                        const int32_t maxHPCLen);
+
+/*
+ * Generates the seeds using the scheme specified in the parameters. The seeds are computed
+ * on HP-compressed kmers if UseHPCForSeedsOnly is set.
+ */
+int GenerateSeeds(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                  const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                  const SeedDBParameters& params);
+
+/*
+ * Generates the seeds of a circular sequence. The seeds are computed on a virtual rotation,
+ * where the sequence is flanked by its own suffix and prefix, so that the seeds which span the
+ * origin are emitted and the seeds next to the origin are selected with their full context.
+ * Only the seeds which begin within the sequence are kept; the span of a seed near the end
+ * can reach past the end of the sequence.
+ */
+int GenerateSeedsCircular(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                          const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                          const SeedDBParameters& params);
+
+void GenerateSeeds(std::vector<PacBio::Pancake::Int128t>& retSeeds,
+                   std::vector<int32_t>& retSequenceLengths,
+                   const std::vector<FastaSequenceCached>& targetSeqs,
+                   const SeedDBParameters& params);
+
 template <class TargetHashType>
 bool CollectSeedHits(std::vector<SeedHit>& hits, const PacBio::Pancake::SeedDB::SeedRaw* querySeeds,
                      const int64_t querySeedsSize, const int32_t /*queryLen*/,
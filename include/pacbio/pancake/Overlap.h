@@ -71,6 +71,12 @@ public:
     bool IsSupplementary = false;
     bool IsSecondary = false;
 
+    // Large indels which were spanned by merging the anchors across diagonals. They are
+    // excluded from the identity and the edit distance, and reported separately.
+    int32_t NumLongIndels = 0;
+    int32_t LongInsertionBases = 0;
+    int32_t LongDeletionBases = 0;
+
 public:
     Overlap() = default;
     ~Overlap() = default;
@@ -138,8 +144,16 @@ public:
     int32_t BSpan() const { return (Bend - Bstart); }
     int32_t AstartFwd() const { return (Arev ? (Alen - Aend) : Astart); }
     int32_t AendFwd() const { return (Arev ? (Alen - Astart) : Aend); }
-    int32_t BstartFwd() const { return (Brev ? (Blen - Bend) : Bstart); }
-    int32_t BendFwd() const { return (Brev ? (Blen - Bstart) : Bend); }
+    // The end of an overlap which spans the origin of a circular B-read is past Blen in
+    // either strand (see Circular.h), so the reversed coordinates are shifted by Blen.
+    int32_t BstartFwd() const
+    {
+        return (Brev ? (Blen - Bend + ((Bend > Blen) ? Blen : 0)) : Bstart);
+    }
+    int32_t BendFwd() const
+    {
+        return (Brev ? (Blen - Bstart + ((Bend > Blen) ? Blen : 0)) : Bend);
+    }
 
     void Flip()
     {
@@ -150,6 +164,7 @@ public:
         std::swap(Alen, Blen);
         std::swap(Avars, Bvars);
         std::swap(Atype, Btype);
+        std::swap(LongInsertionBases, LongDeletionBases);
 
         // If the query/target context changed, then I/D operations need to
         // be updated.
@@ -177,6 +192,17 @@ public:
             Bend = Blen - Bend;
             Brev = !Brev;
 
+            // Keep the start of an overlap which spans the origin of a circular sequence
+            // in [0, len).
+            if (Astart < 0) {
+                Astart += Alen;
+                Aend += Alen;
+            }
+            if (Bstart < 0) {
+                Bstart += Blen;
+                Bend += Blen;
+            }
+
             // Reverse the CIGAR string.
             if (Cigar.size() > 0) {
                 std::reverse(Cigar.begin(), Cigar.end());
@@ -226,7 +252,9 @@ public:
                Alen == rhs.Aend && Brev == rhs.Brev && Bstart == rhs.Bstart && Bend == rhs.Bend &&
                Blen == rhs.Bend && Cigar == rhs.Cigar && Avars == rhs.Avars && Bvars == rhs.Bvars &&
                IsFlipped == rhs.IsFlipped && IsSupplementary == rhs.IsSupplementary &&
-               IsSecondary == rhs.IsSecondary;
+               IsSecondary == rhs.IsSecondary && NumLongIndels == rhs.NumLongIndels &&
+               LongInsertionBases == rhs.LongInsertionBases &&
+               LongDeletionBases == rhs.LongDeletionBases;
     }
 };
 
@@ -257,11 +285,15 @@ inline std::unique_ptr<Overlap> createOverlap(int32_t Aid, int32_t Bid, float sc
 
 inline std::unique_ptr<Overlap> createOverlap(const Overlap& ovl)
 {
-    return std::unique_ptr<Overlap>(
+    auto ret = std::unique_ptr<Overlap>(
         new Overlap(ovl.Aid, ovl.Bid, ovl.Score, ovl.Identity, ovl.Arev, ovl.Astart, ovl.Aend,
                     ovl.Alen, ovl.Brev, ovl.Bstart, ovl.Bend, ovl.Blen, ovl.EditDistance,
                     ovl.NumSeeds, ovl.Atype, ovl.Btype, ovl.Cigar, ovl.Avars, ovl.Bvars,
                     ovl.IsFlipped, ovl.IsSupplementary, ovl.IsSecondary));
+    ret->NumLongIndels = ovl.NumLongIndels;
+    ret->LongInsertionBases = ovl.LongInsertionBases;
+    ret->LongDeletionBases = ovl.LongDeletionBases;
+    return ret;
 }
 
 inline std::unique_ptr<Overlap> createOverlap(const std::unique_ptr<Overlap>& ovl)
@@ -0,0 +1,98 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_OVERLAP_MERGE_H
+#define PANCAKE_OVERLAP_MERGE_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * \brief One line of an M4 or an IPA overlap file. Both formats begin with the columns
+ * "Aname Bname score identity", which is all that is needed to sort, group and deduplicate
+ * the overlaps. The line itself is kept verbatim, so it can be written out unchanged.
+*/
+class OverlapLine
+{
+public:
+    std::string line;
+    int32_t aNameLen = 0;
+    int32_t bNameStart = 0;
+    int32_t bNameLen = 0;
+    float score = 0.0f;
+    float identity = 0.0f;
+
+    std::string AName() const { return line.substr(0, aNameLen); }
+    std::string BName() const { return line.substr(bNameStart, bNameLen); }
+
+    /// \brief Approximate number of bytes this line occupies in memory.
+    int64_t MemoryUsage() const { return sizeof(OverlapLine) + line.capacity(); }
+};
+
+/*
+ * \brief Order of the overlap lines.
+ *  - ByRead groups the lines by the A-read, and sorts the overlaps of each A-read from the
+ *    best to the worst, by score and then by identity.
+ *  - ByPair groups the lines by the unordered pair of reads, so that the A-B and the B-A
+ *    overlaps are adjacent, and sorts each group from the best to the worst.
+*/
+enum class OverlapSortOrder
+{
+    ByRead,
+    ByPair,
+};
+
+/// \brief Parses the first four columns of an M4 or IPA overlap line. Throws if the line has
+///         fewer columns, or if the score or identity are not numbers.
+OverlapLine ParseOverlapLine(std::string line);
+
+/// \brief Compares the A-read names of two lines, with the semantics of std::string::compare.
+int32_t CompareAName(const OverlapLine& a, const OverlapLine& b);
+
+/// \brief Compares the unordered read pairs of two lines, with the semantics of
+///         std::string::compare. The A-B and B-A overlaps compare equal.
+int32_t ComparePair(const OverlapLine& a, const OverlapLine& b);
+
+/// \brief Strict weak ordering of the lines in the given sort order. Ties between overlaps of
+///         equal quality are broken by the read names, so the order does not depend on the
+///         order of the input files.
+bool OverlapLineLess(const OverlapLine& a, const OverlapLine& b, OverlapSortOrder order);
+
+void SortOverlapLines(std::vector<OverlapLine>& lines, OverlapSortOrder order);
+
+/// \brief Writes the lines to a file, one per line. Throws if the file cannot be written.
+void WriteOverlapLines(const std::vector<OverlapLine>& lines, const std::string& outPath);
+
+/*
+ * \brief K-way merge of sorted run files. All runs need to be sorted in the same order, e.g.
+ * written with SortOverlapLines and WriteOverlapLines. Only one line per run is held in memory.
+*/
+class OverlapRunMerger
+{
+public:
+    OverlapRunMerger(const std::vector<std::string>& runPaths, OverlapSortOrder order);
+    ~OverlapRunMerger();
+
+    /// \brief Returns the next line in the sort order, or false when all runs are consumed.
+    bool GetNext(OverlapLine& ret);
+
+private:
+    OverlapSortOrder order_;
+    std::vector<std::unique_ptr<std::ifstream>> runs_;
+    std::vector<OverlapLine> heads_;
+    // Min-heap of run indices, ordered by the current head lines of the runs.
+    std::vector<int32_t> heap_;
+
+    bool ReadHead_(int32_t runId);
+    bool HeapCompare_(int32_t a, int32_t b) const;
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_OVERLAP_MERGE_H
@@ -0,0 +1,132 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_OVERLAP_TASK_QUEUE_H
+#define PANCAKE_OVERLAP_TASK_QUEUE_H
+
+#include <pacbio/pancake/SeqDBIndexCache.h>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * A queue of the overlapping tasks, shared by any number of worker processes through a
+ * directory on a shared filesystem. Each task maps a range of query blocks onto one target
+ * block. The directory contains:
+ *  - plan.tsv: the list of tasks, written by the first worker.
+ *  - tasks/task-<id>.lock.<attempt>: created with O_EXCL by the worker which claims the task.
+ *    The owner touches the file periodically, and a task without a heartbeat for longer than
+ *    the lease is claimed again with the next attempt number.
+ *  - tasks/task-<id>.done: the completion marker.
+ *  - out/task-<id>.out: the overlaps of a completed task. The output of an attempt is written
+ *    to a temporary file. On completion, the owner creates the lock of the next attempt with
+ *    O_EXCL, and renames the output only if that succeeds, i.e. if no other worker has
+ *    reclaimed the task.
+ *
+ * The tasks of a target block are consecutive in the plan, so that a worker can claim the
+ * other tasks of the target block it has already indexed.
+*/
+
+class OverlapTask
+{
+public:
+    int32_t taskId = 0;
+    int32_t targetBlockId = 0;
+    int32_t queryBlockStartId = 0;
+    int32_t queryBlockEndId = 0;
+    // Estimated cost: the product of the target and the query bases.
+    double cost = 0.0;
+};
+
+inline bool operator==(const OverlapTask& lhs, const OverlapTask& rhs)
+{
+    return lhs.taskId == rhs.taskId && lhs.targetBlockId == rhs.targetBlockId &&
+           lhs.queryBlockStartId == rhs.queryBlockStartId &&
+           lhs.queryBlockEndId == rhs.queryBlockEndId;
+}
+
+/// \brief Splits the mapping of all query blocks onto all target blocks into tasks of
+///         queryBlocksPerTask query blocks. With skipSymmetric, the pairs of blocks which
+///         can only produce the skipped symmetric overlaps are left out: those in which all
+///         query IDs are lower than or equal to all target IDs. This is valid only if the
+///         query and the target DBs are the same.
+///         The groups of tasks of a target block are sorted by the decreasing total cost,
+///         and the tasks within a group by the decreasing cost. The task IDs follow this order.
+std::vector<OverlapTask> PlanOverlapTasks(const SeqDBIndexCache& targetCache,
+                                          const SeqDBIndexCache& queryCache,
+                                          int32_t queryBlocksPerTask, bool skipSymmetric);
+
+void WriteOverlapTaskPlan(std::ostream& os, const std::vector<OverlapTask>& tasks);
+
+/// \brief Parses the plan written by WriteOverlapTaskPlan. Throws on malformed lines.
+std::vector<OverlapTask> ParseOverlapTaskPlan(std::istream& is);
+
+class OverlapTaskQueue
+{
+public:
+    /// \brief Opens the queue in the work directory, and writes the plan if no other worker
+    ///         has done so yet. Throws if the existing plan differs from the given one.
+    OverlapTaskQueue(const std::string& workDir, const std::vector<OverlapTask>& plan,
+                     int32_t leaseSeconds);
+    ~OverlapTaskQueue();
+
+    OverlapTaskQueue(const OverlapTaskQueue&) = delete;
+    OverlapTaskQueue& operator=(const OverlapTaskQueue&) = delete;
+
+    /// \brief Claims the next available task: either an unclaimed one, or one whose lease
+    ///         has expired. If targetBlockId >= 0, only the tasks of that target block are
+    ///         considered. Otherwise the target blocks not yet claimed by any worker are
+    ///         preferred. Only one task can be claimed at a time.
+    /// \returns False if there is no task available at the moment.
+    bool Claim(int32_t targetBlockId, OverlapTask& task);
+
+    /// \brief Path to which the output of the claimed task should be written.
+    std::string OutputPath() const;
+
+    /// \brief Publishes the output of the claimed task and marks it done.
+    /// \returns False if the lease was lost to another worker, in which case the output
+    ///          is discarded.
+    bool Complete();
+
+    /// \brief Gives up the claimed task, so that any worker can claim it immediately.
+    void Release();
+
+    bool HasTask() const { return currentTaskId_ >= 0; }
+    int32_t NumTasks() const { return plan_.size(); }
+    int32_t NumDone() const;
+    bool IsFinished() const { return NumDone() == NumTasks(); }
+
+    std::string TaskLockPath(int32_t taskId, int32_t attempt) const;
+    std::string TaskDonePath(int32_t taskId) const;
+    std::string TaskOutputPath(int32_t taskId) const;
+
+private:
+    std::string workDir_;
+    std::vector<OverlapTask> plan_;
+    int32_t leaseSeconds_ = 0;
+
+    int32_t currentTaskId_ = -1;
+    int32_t currentAttempt_ = -1;
+
+    std::mutex heartbeatMutex_;
+    std::condition_variable heartbeatCv_;
+    bool heartbeatStop_ = false;
+    std::string heartbeatPath_;
+    std::thread heartbeatThread_;
+
+    void LoadOrWritePlan_();
+    bool TryClaim_(const OverlapTask& task);
+    void SetHeartbeatPath_(const std::string& path);
+    void HeartbeatWorker_();
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_OVERLAP_TASK_QUEUE_H
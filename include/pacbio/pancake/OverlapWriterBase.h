@@ -28,6 +28,18 @@ public:
                        const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
                        const PacBio::Pancake::FastaSequenceCached& querySeq) = 0;
 
+    /// \brief Writes the overlap along with the extra SAM tags, e.g. the SA tag of a split
+    ///         mapping. Only the SAM writer uses the tags, and it then also sets the secondary
+    ///         and supplementary flags, so that the records agree with the SA tags. The other
+    ///         formats write the overlap as is.
+    virtual void WriteWithSAMTags(const OverlapPtr& ovl,
+                                  const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                                  const PacBio::Pancake::FastaSequenceCached& querySeq,
+                                  const std::string& /*samTags*/)
+    {
+        Write(ovl, targetSeqs, querySeq);
+    }
+
     virtual void WriteHeader(const PacBio::Pancake::SeqDBReaderCached& targetSeqs) = 0;
 
     virtual void WriteHeader(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs) = 0;
@@ -41,6 +53,10 @@ public:
     static void PrintOverlapAsSAM(FILE* fpOut, const OverlapPtr& ovl, const char* seq,
                                   int64_t seqLen, const std::string& Aname,
                                   const std::string& Bname, bool writeIds, bool writeCigar);
+    static void PrintOverlapAsSAM(FILE* fpOut, const OverlapPtr& ovl, const char* seq,
+                                  int64_t seqLen, const std::string& Aname,
+                                  const std::string& Bname, bool writeIds, bool writeCigar,
+                                  bool writeMappingFlags, const std::string& extraTags);
     static std::string PrintOverlapAsM4(const Overlap& ovl, const std::string& Aname,
                                         const std::string& Bname, bool writeIds, bool writeCigar);
     static std::string PrintOverlapAsM4(const OverlapPtr& ovl, const std::string& Aname,
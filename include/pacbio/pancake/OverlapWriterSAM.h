@@ -33,6 +33,11 @@ public:
     void Write(const OverlapPtr& ovl, const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
                const PacBio::Pancake::FastaSequenceCached& querySeq) override;
 
+    void WriteWithSAMTags(const OverlapPtr& ovl,
+                          const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                          const PacBio::Pancake::FastaSequenceCached& querySeq,
+                          const std::string& samTags) override;
+
 private:
     std::string outFile_;
     FILE* fpOut_ = NULL;
@@ -0,0 +1,106 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_PALINDROME_H
+#define PANCAKE_PALINDROME_H
+
+#include <pacbio/pancake/Seed.h>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * \brief What to do with the reads which align to their own reverse complement, e.g. the reads
+ * with a missed adapter. The Trim action keeps only the longer side of the fold.
+*/
+enum class PalindromeAction
+{
+    None,
+    Report,
+    Skip,
+    Trim,
+};
+
+inline std::string PalindromeActionToString(const PalindromeAction& action)
+{
+    if (action == PalindromeAction::None) {
+        return "none";
+    } else if (action == PalindromeAction::Report) {
+        return "report";
+    } else if (action == PalindromeAction::Skip) {
+        return "skip";
+    } else if (action == PalindromeAction::Trim) {
+        return "trim";
+    }
+    return "unknown";
+}
+
+inline PalindromeAction PalindromeActionFromString(const std::string& action)
+{
+    if (action == "none") {
+        return PalindromeAction::None;
+    } else if (action == "report") {
+        return PalindromeAction::Report;
+    } else if (action == "skip") {
+        return PalindromeAction::Skip;
+    } else if (action == "trim") {
+        return PalindromeAction::Trim;
+    }
+    throw std::runtime_error("Unknown palindrome action: '" + action +
+                             "' in PalindromeActionFromString.");
+}
+
+/*
+ * \brief The strongest alignment of a sequence to its own reverse complement. The arm is the
+ * aligned part before the fold, and its mirror image around the fold position is the other arm.
+*/
+class PalindromeResult
+{
+public:
+    bool isPalindrome = false;
+    int32_t foldPos = -1;
+    int32_t armStart = 0;
+    int32_t armEnd = 0;
+    int32_t numSeeds = 0;
+
+    bool operator==(const PalindromeResult& b) const
+    {
+        return isPalindrome == b.isPalindrome && foldPos == b.foldPos &&
+               armStart == b.armStart && armEnd == b.armEnd && numSeeds == b.numSeeds;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const PalindromeResult& b)
+{
+    os << "isPalindrome = " << (b.isPalindrome ? "true" : "false") << ", foldPos = " << b.foldPos
+       << ", armStart = " << b.armStart << ", armEnd = " << b.armEnd
+       << ", numSeeds = " << b.numSeeds;
+    return os;
+}
+
+/// \brief Detects whether a sequence aligns to its own reverse complement, by mapping the seeds
+///         of the sequence onto themselves. The seeds need to be computed with the reverse
+///         complement enabled. Each pair of seeds with the same key on the opposite strands is
+///         a hit, and the colinear hits are chained. The sequence is a palindrome if the best
+///         chain has at least minNumSeeds seeds and its arm spans at least minArmSpan bases.
+///         Keys with more than maxSeedOccurrences seeds within the sequence are skipped, if
+///         the value is > 0.
+PalindromeResult DetectPalindrome(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize,
+                                  int32_t seqLen, int32_t minNumSeeds, int32_t minArmSpan,
+                                  int32_t maxSeedDistance, int32_t chainBandwidth,
+                                  int64_t maxSeedOccurrences);
+
+/// \brief Keeps only the seeds on the longer side of the fold of a palindrome, and appends them
+///         to the output vector. The seeds which span the fold position are removed.
+void CollectSeedsOnLongerArm(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize,
+                             int32_t seqLen, const PalindromeResult& palindrome,
+                             std::vector<PacBio::Pancake::SeedDB::SeedRaw>& retSeeds);
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_PALINDROME_H
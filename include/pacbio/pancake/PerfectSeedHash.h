@@ -0,0 +1,102 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_PERFECT_SEED_HASH_H
+#define PANCAKE_PERFECT_SEED_HASH_H
+
+#include <pacbio/pancake/Seed.h>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * \brief A static hash of seed keys to ranges of seeds, for an index which is built once and then
+ * only queried. It can be used in place of the SeedHashType in the CollectSeedHits.
+ *
+ * The keys are mapped to the slots by a minimal perfect hash function, constructed in the same
+ * way as in PTHash: the keys are distributed into buckets, and for each bucket a pilot value is
+ * searched for which places all of its keys into free positions. The buckets are processed from
+ * the largest to the smallest. The table is slightly larger than the number of keys to speed up
+ * the search, and the positions outside of the first N slots are remapped to the free slots.
+ *
+ * The keys themselves are not stored. Each slot packs the start and the count of the range of
+ * seeds and an 8-bit fingerprint of the key, which rejects most of the keys which are not in the
+ * hash without touching the seeds. The remaining ones are rejected by comparing to the key of the
+ * first seed in the range, so the lookups are exact.
+ *
+ * The seeds need to be sorted by key, and they are not copied. They must not be modified or
+ * reallocated while the hash is in use.
+*/
+class PerfectSeedHash
+{
+public:
+    using value_type = std::pair<uint64_t, std::pair<int64_t, int64_t>>;
+
+    class const_iterator
+    {
+    public:
+        const_iterator(const PerfectSeedHash* hash, int64_t slot) : hash_(hash), slot_(slot)
+        {
+            Fetch_();
+        }
+        const value_type& operator*() const { return value_; }
+        const value_type* operator->() const { return &value_; }
+        const_iterator& operator++()
+        {
+            ++slot_;
+            Fetch_();
+            return *this;
+        }
+        bool operator==(const const_iterator& b) const { return slot_ == b.slot_; }
+        bool operator!=(const const_iterator& b) const { return slot_ != b.slot_; }
+
+    private:
+        void Fetch_()
+        {
+            if (slot_ >= 0 && slot_ < hash_->size()) {
+                value_ = hash_->GetSlot_(slot_);
+            }
+        }
+
+        const PerfectSeedHash* hash_;
+        int64_t slot_;
+        value_type value_;
+    };
+
+    PerfectSeedHash();
+    PerfectSeedHash(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize);
+
+    const_iterator find(uint64_t key) const;
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, numKeys_); }
+    int64_t size() const { return numKeys_; }
+    bool empty() const { return numKeys_ == 0; }
+
+    /// \brief Approximate number of bytes used by the hash, without the seeds.
+    int64_t MemoryUsage() const;
+
+private:
+    const PacBio::Pancake::SeedDB::SeedRaw* seeds_ = nullptr;
+    int64_t numKeys_ = 0;
+    int64_t tableSize_ = 0;
+    int64_t numBuckets_ = 0;
+    int64_t numDenseBuckets_ = 0;
+    uint64_t seed_ = 0;
+    std::vector<uint16_t> pilots_;
+    std::vector<int64_t> freeSlots_;
+    std::vector<uint64_t> slots_;
+    std::unordered_map<int64_t, int64_t> largeCounts_;
+
+    bool Build_(const std::vector<uint64_t>& keys);
+    int64_t GetBucket_(uint64_t hashedKey) const;
+    int64_t FindSlot_(uint64_t hashedKey) const;
+    value_type GetSlot_(int64_t slot) const;
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_PERFECT_SEED_HASH_H
@@ -0,0 +1,68 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_READ_CORRECTION_H
+#define PANCAKE_READ_CORRECTION_H
+
+#include <pacbio/pancake/Overlap.h>
+#include <pbbam/Cigar.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+struct ReadCorrectionSettings
+{
+    // Minimum number of reads covering a homopolymer run, including the corrected read itself,
+    // for the run to be corrected.
+    int32_t minCoverage = 3;
+    // The corrected read keeps its own version of a run if at least this many other reads,
+    // and at least this fraction of the other reads, support it. This keeps the heterozygous
+    // variants, which are supported by the reads from one haplotype only.
+    int32_t minHetSupport = 2;
+    double minHetFraction = 0.2;
+};
+
+struct ReadCorrectionStats
+{
+    int32_t numRuns = 0;
+    int32_t numCovered = 0;
+    int32_t numCorrected = 0;
+    int32_t numHetKept = 0;
+};
+
+/*
+ * One read in the pileup of the corrected read: the aligned part of the other read, in the
+ * strand in which it aligns to the corrected read, and the CIGAR string of the alignment.
+ * The insertions in the CIGAR are the bases of the corrected read, and the deletions are the
+ * bases of the other read.
+*/
+struct PileupAlignment
+{
+    int32_t queryStart = 0;
+    int32_t queryEnd = 0;
+    std::string targetSeq;
+    PacBio::BAM::Cigar cigar;
+};
+
+/// \brief Creates the pileup alignment for an overlap with a CIGAR string, where the A-read is
+///         the corrected read. The targetSeq is the forward B-read, and can be the unrolled
+///         sequence of a circular read.
+PileupAlignment CreatePileupAlignment(const Overlap& ovl, const char* targetSeq,
+                                      int32_t targetLen);
+
+/// \brief Corrects a read with the consensus of its pileup. The votes are collected for each
+///         homopolymer run of the read: every alignment which covers the whole run contributes
+///         the bases aligned to the run, together with the adjacent inserted bases. The run
+///         is replaced with the most supported version, unless the read's own version looks
+///         like a heterozygous variant (see ReadCorrectionSettings). Voting on the whole runs
+///         makes the consensus independent of where the aligner placed the homopolymer indels.
+std::string CorrectRead(const char* seq, int32_t seqLen,
+                        const std::vector<PileupAlignment>& alignments,
+                        const ReadCorrectionSettings& settings, ReadCorrectionStats& stats);
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_READ_CORRECTION_H
@@ -52,6 +52,10 @@ public:
     int32_t startSeqId = -1;
     int32_t endSeqId = -1;
     int64_t numBytes = 0;
+    // CRC-32C of the seeds of the sequences in the block (see CombineRecordCRC32C).
+    // Written as an optional trailing column of the B line, so older indexes remain valid.
+    bool hasChecksum = false;
+    uint32_t checksum = 0;
 
     int32_t Span() const { return endSeqId - startSeqId; }
 };
@@ -82,6 +86,11 @@ public:
 void ComputeSeedDBIndexHeaderLookup(const PacBio::Pancake::SeedDBIndexCache& dbCache,
                                     HeaderLookupType& headerToOrdinalId);
 
+/// \brief Parses the seeding parameters in the format of the 'P' line of the SeedDB index,
+///         e.g. "k=28,w=80,s=0,hpc=0,hpc_len=10,rc=1". Parameters which are not specified keep
+///         their default values.
+PacBio::Pancake::SeedDB::SeedDBParameters ParseSeedDBParams(const std::string& paramsStr);
+
 /// \brief Loads the SeedDB index from file.
 ///
 /// \param[in]  indexFilename           Path to the .seqdb index file.
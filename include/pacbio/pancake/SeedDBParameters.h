@@ -4,11 +4,50 @@
 #define PANCAKE_SEEDDB_PARAMETERS_H
 
 #include <cstdint>
+#include <stdexcept>
+#include <string>
 
 namespace PacBio {
 namespace Pancake {
 namespace SeedDB {
 
+enum class SeedingScheme
+{
+    Minimizer,
+    OpenSyncmer,
+    ClosedSyncmer,
+    Randstrobe,
+};
+
+inline std::string SeedingSchemeToString(const SeedingScheme& scheme)
+{
+    if (scheme == SeedingScheme::Minimizer) {
+        return "minimizer";
+    } else if (scheme == SeedingScheme::OpenSyncmer) {
+        return "open-syncmer";
+    } else if (scheme == SeedingScheme::ClosedSyncmer) {
+        return "closed-syncmer";
+    } else if (scheme == SeedingScheme::Randstrobe) {
+        return "randstrobe";
+    }
+    return "unknown";
+}
+
+inline SeedingScheme SeedingSchemeFromString(const std::string& scheme)
+{
+    if (scheme == "minimizer") {
+        return SeedingScheme::Minimizer;
+    } else if (scheme == "open-syncmer") {
+        return SeedingScheme::OpenSyncmer;
+    } else if (scheme == "closed-syncmer") {
+        return SeedingScheme::ClosedSyncmer;
+    } else if (scheme == "randstrobe") {
+        return SeedingScheme::Randstrobe;
+    }
+    throw std::runtime_error("Unknown seeding scheme: '" + scheme +
+                             "' in SeedingSchemeFromString.");
+}
+
 // clang-format off
 class SeedDBParameters
 {
@@ -20,6 +59,10 @@ public:
     bool UseHPCForSeedsOnly = false;    // This takes the uncompressed sequences, and just skips HP bases when computing seeds.
     int32_t MaxHPCLen = 10;
     bool UseRC = true;
+    SeedingScheme Scheme = SeedingScheme::Minimizer;
+    int32_t SyncmerSize = 12;           // Length of the s-mers which select syncmers. Used by all schemes except minimizers.
+    int32_t StrobeMinDist = 20;         // Minimum distance between the starts of the two randstrobe kmers.
+    int32_t StrobeMaxDist = 100;        // Maximum distance between the starts of the two randstrobe kmers.
 
     SeedDBParameters() = default;
     ~SeedDBParameters() = default;
@@ -29,7 +72,9 @@ public:
         return KmerSize == rhs.KmerSize && MinimizerWindow == rhs.MinimizerWindow &&
             Spacing == rhs.Spacing && UseHPC == rhs.UseHPC &&
             UseHPCForSeedsOnly == rhs.UseHPCForSeedsOnly &&
-            MaxHPCLen == rhs.MaxHPCLen && UseRC == rhs.UseRC;
+            MaxHPCLen == rhs.MaxHPCLen && UseRC == rhs.UseRC && Scheme == rhs.Scheme &&
+            SyncmerSize == rhs.SyncmerSize && StrobeMinDist == rhs.StrobeMinDist &&
+            StrobeMaxDist == rhs.StrobeMaxDist;
     }
     bool operator!=(const SeedDBParameters& rhs) const
     {
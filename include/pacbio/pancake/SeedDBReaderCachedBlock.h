@@ -3,6 +3,7 @@
 #ifndef PANCAKE_SEEDDB_READER_CACHED_BLOCK_H
 #define PANCAKE_SEEDDB_READER_CACHED_BLOCK_H
 
+#include <pacbio/pancake/FastaSequenceCached.h>
 #include <pacbio/pancake/SeedDBIndexCache.h>
 #include <pacbio/pancake/SeedDBReaderCachedBlock.h>
 #include <pacbio/pancake/SequenceSeedsCached.h>
@@ -21,8 +22,15 @@ public:
     SeedDBReaderCachedBlock(std::shared_ptr<PacBio::Pancake::SeedDBIndexCache>& seedDBCache);
     SeedDBReaderCachedBlock(std::shared_ptr<PacBio::Pancake::SeedDBIndexCache>& seedDBCache,
                             const std::vector<int32_t>& blockIds);
+    /// \brief Holds the seeds which were computed from the sequences instead of loaded from
+    ///         a SeedDB. The seeds of seqs[i] are given in seeds[i]. Such a block cannot load
+    ///         other blocks.
+    SeedDBReaderCachedBlock(const std::vector<FastaSequenceCached>& seqs,
+                            const std::vector<std::vector<PacBio::Pancake::Int128t>>& seeds);
     ~SeedDBReaderCachedBlock();
 
+    /// \brief Loads the seeds of the blocks. The blocks which have a checksum in the index
+    ///         are verified after loading, and a mismatch throws.
     void LoadBlock(const std::vector<int32_t>& blockIds);
     const SequenceSeedsCached& GetSeedsForSequence(int32_t seqId) const;
     const SequenceSeedsCached& GetSeedsForSequence(const std::string& seqName) const;
@@ -37,6 +45,8 @@ private:
     // Info to allow random access.
     std::unordered_map<std::string, int32_t> headerToOrdinalId_;
     std::unordered_map<int32_t, int32_t> seqIdToOrdinalId_;
+
+    void VerifyBlockChecksums_() const;
 };
 
 }  // namespace Pancake
@@ -26,9 +26,12 @@
     P <param1=val1,param2=val2,...>
     F <int32_t:file_id> <string:filename> <int32_t:num_seqs> <int64_t:file_size_in_bytes>
     S <int32_t:seq_id> <string:header> <int32_t:file_id> <int64_t:file_offset> <int64_t:byte_size> <int32_t:num_bases> <int32_t:num_seeds>
-    B <int32_t:block_id> <int32_t:start_seq_id> <int32_t:end_seq_id> <int64_t:byte_size>
+    B <int32_t:block_id> <int32_t:start_seq_id> <int32_t:end_seq_id> <int64_t:byte_size> [crc32c=<hex:checksum>]
     ```
 
+    The optional block checksum is the CRC-32C of the per-sequence CRC-32C values of the
+    seed bytes, in the order of sequence IDs (see CombineRecordCRC32C).
+
     ## Seed file:
     Binary file. Contains all bytes concatenated together, no headers, no new line chars.
 */
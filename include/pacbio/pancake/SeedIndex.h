@@ -3,9 +3,12 @@
 #ifndef PANCAKE_OVERLAPHIFI_SEEDINDEX_H
 #define PANCAKE_OVERLAPHIFI_SEEDINDEX_H
 
+#include <pacbio/pancake/PerfectSeedHash.h>
 #include <pacbio/pancake/Seed.h>
 #include <pacbio/pancake/SeedDBIndexCache.h>
 #include <pacbio/pancake/SeedHit.h>
+#include <pacbio/pancake/SeedIndexHashType.h>
+#include <pacbio/pancake/SequenceSeedsCached.h>
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
@@ -60,10 +63,12 @@ class SeedIndex
 {
 public:
     SeedIndex(std::shared_ptr<PacBio::Pancake::SeedDBIndexCache>& seedDBCache,
-              std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds);
+              std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds,
+              SeedIndexHashType hashType = SeedIndexHashType::FlatHashMap);
     SeedIndex(const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams,
               const std::vector<int32_t>& sequenceLengths,
-              std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds);
+              std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds,
+              SeedIndexHashType hashType = SeedIndexHashType::FlatHashMap);
     ~SeedIndex();
 
     void ComputeFrequencyStats(double percentileCutoff, int64_t& retFreqMax, double& retFreqAvg,
@@ -74,10 +79,12 @@ public:
     bool CollectHits(const PacBio::Pancake::SeedDB::SeedRaw* querySeeds, int64_t querySeedsSize,
                      int32_t queryLen, std::vector<SeedHit>& hits, int64_t freqCutoff) const;
 
-    const std::vector<int32_t> GetSequenceLengths() const { return sequenceLengths_; }
+    const std::vector<int32_t>& GetSequenceLengths() const { return sequenceLengths_; }
 
     const PacBio::Pancake::SeedDB::SeedDBParameters& GetSeedParams() const { return seedParams_; }
 
+    SeedIndexHashType GetHashType() const { return hashType_; }
+
     int32_t GetSequenceLength(int32_t seqId) const
     {
         // Sanity check for the sequence ID.
@@ -92,13 +99,80 @@ public:
 
 private:
     std::vector<PacBio::Pancake::SeedDB::SeedRaw> seeds_;
+    SeedIndexHashType hashType_;
     SeedHashType hash_;
+    // Points into the seeds_, so it is not copyable.
+    std::unique_ptr<PerfectSeedHash> perfectHash_;
     PacBio::Pancake::SeedDB::SeedDBParameters seedParams_;
     std::vector<int32_t> sequenceLengths_;
 
     void BuildHash_();
 };
 
+/*
+ * \brief Computes the statistics of the number of occurrences of the keys in a seed hash,
+ * where each key points to a range of elements. The percentileCutoff is the fraction of the most
+ * frequent keys which should be above the returned cutoff.
+*/
+void ComputeSeedHashFrequencyStats(const SeedHashType& hash, double percentileCutoff,
+                                   int64_t& retFreqMax, double& retFreqAvg, double& retFreqMedian,
+                                   int64_t& retFreqCutoff);
+void ComputeSeedHashFrequencyStats(const PerfectSeedHash& hash, double percentileCutoff,
+                                   int64_t& retFreqMax, double& retFreqAvg, double& retFreqMedian,
+                                   int64_t& retFreqCutoff);
+
+/*
+ * \brief Collects the seeds which begin within maxDist bases from either end of their sequence,
+ * and appends them to the output vector. The length of each sequence is looked up by the
+ * sequence ID encoded in the seed.
+ * Used to build the index in the end-anchored overlap mode, where every overlap of interest
+ * covers at least one end of a sequence.
+*/
+void CollectSeedsNearSequenceEnds(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize,
+                                  const std::vector<int32_t>& sequenceLengths, int32_t maxDist,
+                                  std::vector<PacBio::Pancake::SeedDB::SeedRaw>& retSeeds);
+
+/*
+ * \brief Collects the seed hits between a query and a single target without an index, by a merge
+ * join of their seeds. Both seed arrays need to be sorted by key, e.g. by sorting the raw seed
+ * values, because the key occupies the most significant bits. The hits are the same as the ones
+ * which the SeedIndex::CollectHits finds for this target, except that the frequency cutoff is
+ * applied to the number of occurrences of a key within the target. The hits are appended to
+ * the output vector.
+ * Used to map a query only to a few known candidate targets.
+*/
+void CollectSeedHitsFromSortedSeeds(const PacBio::Pancake::SeedDB::SeedRaw* querySeeds,
+                                    int64_t querySeedsSize,
+                                    const PacBio::Pancake::SeedDB::SeedRaw* targetSeeds,
+                                    int64_t targetSeedsSize, int32_t targetLen, int64_t freqCutoff,
+                                    std::vector<SeedHit>& retHits);
+
+/*
+ * \brief The seeds of a block of sequences, sorted by key within each sequence, as needed by
+ * CollectSeedHitsFromSortedSeeds. Built once per target block, so that the candidates of each
+ * query only look up the sorted seeds of their targets instead of copying and sorting them.
+*/
+class SortedSequenceSeeds
+{
+public:
+    explicit SortedSequenceSeeds(const std::vector<SequenceSeedsCached>& records);
+
+    // The views point into the seeds of this object, which are kept when moved.
+    SortedSequenceSeeds(const SortedSequenceSeeds&) = delete;
+    SortedSequenceSeeds& operator=(const SortedSequenceSeeds&) = delete;
+    SortedSequenceSeeds(SortedSequenceSeeds&&) = default;
+    SortedSequenceSeeds& operator=(SortedSequenceSeeds&&) = default;
+
+    /// \brief Returns a view of the sorted seeds of a sequence. Throws if the sequence
+    ///         is not in the block.
+    const SequenceSeedsCached& GetSeedsForSequence(int32_t seqId) const;
+
+private:
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw> seeds_;
+    std::vector<SequenceSeedsCached> records_;
+    std::unordered_map<int32_t, int32_t> seqIdToOrdinalId_;
+};
+
 }  // namespace Pancake
 }  // namespace PacBio
 
@@ -0,0 +1,47 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_SEED_INDEX_HASH_TYPE_H
+#define PANCAKE_SEED_INDEX_HASH_TYPE_H
+
+#include <stdexcept>
+#include <string>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * \brief Hash used to look up the seeds in the SeedIndex. The perfect hash uses several times less
+ * memory, because it does not store the keys or any empty slots, but it is slower to build and
+ * to query. It is meant for the large target blocks, where the memory is the limit.
+*/
+enum class SeedIndexHashType
+{
+    FlatHashMap,
+    PerfectHash,
+};
+
+inline std::string SeedIndexHashTypeToString(const SeedIndexHashType& hashType)
+{
+    if (hashType == SeedIndexHashType::FlatHashMap) {
+        return "flat-hash-map";
+    } else if (hashType == SeedIndexHashType::PerfectHash) {
+        return "perfect-hash";
+    }
+    return "unknown";
+}
+
+inline SeedIndexHashType SeedIndexHashTypeFromString(const std::string& hashType)
+{
+    if (hashType == "flat-hash-map") {
+        return SeedIndexHashType::FlatHashMap;
+    } else if (hashType == "perfect-hash") {
+        return SeedIndexHashType::PerfectHash;
+    }
+    throw std::runtime_error("Unknown seed index hash type: '" + hashType +
+                             "' in SeedIndexHashTypeFromString.");
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_SEED_INDEX_HASH_TYPE_H
@@ -45,6 +45,9 @@ public:
     int32_t fileId = 0;
     int64_t fileOffset = 0;
     std::vector<PacBio::Pancake::Range> ranges;
+    // Circular sequences (e.g. plasmids, organelles) are marked with an optional trailing
+    // "circular" column in the S line, so older indexes remain valid.
+    bool isCircular = false;
 };
 
 class SeqDBBlockLine
@@ -55,6 +58,10 @@ public:
     int32_t endSeqId = -1;
     int64_t numBytes = 0;
     int64_t numBases = 0;
+    // CRC-32C of the stored bytes of the records in the block (see CombineRecordCRC32C).
+    // Written as an optional trailing column of the B line, so older indexes remain valid.
+    bool hasChecksum = false;
+    uint32_t checksum = 0;
 
     int32_t Span() const { return endSeqId - startSeqId; }
 };
@@ -12,6 +12,7 @@
 
 #include <pacbio/pancake/FastaSequenceCached.h>
 #include <pacbio/pancake/FastaSequenceId.h>
+#include <pacbio/pancake/HPCCoordinateMap.h>
 #include <pacbio/pancake/SeqDBIndexCache.h>
 #include <pacbio/pancake/SeqDBReaderCachedBlock.h>
 #include <memory>
@@ -25,9 +26,11 @@ class SeqDBReaderCachedBlock
 {
 public:
     SeqDBReaderCachedBlock(std::shared_ptr<PacBio::Pancake::SeqDBIndexCache>& seedDBCache,
-                           bool useHomopolymerCompression);
+                           bool useHomopolymerCompression, bool buildHPCCoordinateMap = false);
     ~SeqDBReaderCachedBlock();
 
+    /// \brief Loads the sequences of the blocks. The blocks which have a checksum in the index
+    ///         are verified while loading, and a mismatch throws.
     void LoadBlocks(const std::vector<int32_t>& blockIds);
     void LoadSequences(const std::vector<int32_t>& seqIds);
     void LoadSequences(const std::vector<std::string>& seqNames);
@@ -38,18 +41,36 @@ public:
     void GetSequence(FastaSequenceCached& record, const std::string& seqName);
     const std::vector<FastaSequenceCached>& records() const { return records_; }
 
+    /// \brief Run lengths of the loaded homopolymer-compressed sequences, for lifting the
+    ///         coordinates back to the raw sequences. Built only if requested in the constructor.
+    const HPCCoordinateMap& hpcCoordinateMap() const { return hpcCoordinateMap_; }
+
+    /// \brief Replaces each loaded circular sequence with two concatenated copies of itself, so
+    ///         that the alignments which span the origin are colinear in the unrolled sequence.
+    ///         Returns the lengths of the circular sequences before unrolling, indexed by the
+    ///         sequence ID, and 0 for the linear ones.
+    std::vector<int32_t> UnrollCircularSequences();
+
 private:
     std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> seqDBIndexCache_;
     bool useHomopolymerCompression_;
+    bool buildHPCCoordinateMap_;
     std::vector<uint8_t> data_;
     std::vector<FastaSequenceCached> records_;
+    HPCCoordinateMap hpcCoordinateMap_;
 
     // Info to allow random access.
     std::unordered_map<std::string, int32_t> headerToOrdinalId_;
     std::unordered_map<int32_t, int32_t> seqIdToOrdinalId_;
 
-    void LoadBlockUncompressed_(const std::vector<ContiguousFilePart>& parts);
-    void LoadBlockCompressed_(const std::vector<ContiguousFilePart>& parts);
+    // If recordChecksums is not null, it is filled with the checksums of the stored bytes of
+    // each loaded record, in the order of records_.
+    void LoadBlockUncompressed_(const std::vector<ContiguousFilePart>& parts,
+                                std::vector<uint32_t>* recordChecksums);
+    void LoadBlockCompressed_(const std::vector<ContiguousFilePart>& parts,
+                              std::vector<uint32_t>* recordChecksums);
+    void VerifyBlockChecksums_(const std::vector<int32_t>& blockIds,
+                               const std::vector<uint32_t>& recordChecksums);
 
     void CompressHomopolymers_();
 };
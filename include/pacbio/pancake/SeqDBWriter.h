@@ -22,9 +22,13 @@
     V <string:semantic_version>
     C <int32_t:compression_level>
     F <int32_t:file_id> <string:filename> <int32_t:num_seqs> <int64_t:file_size_in_bytes> <int64_t:num_compressed_bases>
-    S <int32_t:seq_id> <string:header> <int32_t:file_id> <int64_t:file_offset> <int32_t:byte_size> <int32_t:num_bases> <int32_t:num_ranges> <int64_t:start_1> <int64_t:end_1> [<int64_t:start_2> <int64_t:end_2> ...]
+    S <int32_t:seq_id> <string:header> <int32_t:file_id> <int64_t:file_offset> <int32_t:byte_size> <int32_t:num_bases> <int32_t:num_ranges> <int64_t:start_1> <int64_t:end_1> [<int64_t:start_2> <int64_t:end_2> ...] [circular]
+    B <int32_t:block_id> <int32_t:start_seq_id> <int32_t:end_seq_id> <int64_t:byte_size> <int64_t:num_bases> [crc32c=<hex:checksum>]
     ```
 
+    The optional block checksum is the CRC-32C of the per-sequence CRC-32C values of the
+    stored bytes, in the order of sequence IDs (see CombineRecordCRC32C).
+
     ## Sequence file:
     Binary file. Contains all bytes concatenated together, no headers, no new line chars.
     It can be either compressed (2-bit) or uncompressed (1-byte per base).
@@ -40,7 +44,8 @@ public:
                 int64_t blockSize, bool splitBlocks);
     ~SeqDBWriter() override;
 
-    void AddSequence(const std::string& header, const std::string& seq) override;
+    void AddSequence(const std::string& header, const std::string& seq,
+                     bool isCircular = false) override;
     bool WriteSequences() override;
     void WriteIndex() override;
     void ClearSequenceBuffer() override;
@@ -17,7 +17,8 @@ class SeqDBWriterBase
 {
 public:
     virtual ~SeqDBWriterBase() {}
-    virtual void AddSequence(const std::string& header, const std::string& seq) = 0;
+    virtual void AddSequence(const std::string& header, const std::string& seq,
+                             bool isCircular = false) = 0;
     virtual bool WriteSequences() = 0;
     virtual void WriteIndex() = 0;
     virtual void ClearSequenceBuffer() = 0;
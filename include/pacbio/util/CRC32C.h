@@ -0,0 +1,35 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_CRC32C_H
+#define PANCAKE_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PacBio {
+namespace Pancake {
+
+/// \brief Computes the CRC-32C (Castagnoli) checksum of the data. Uses the SSE4.2 crc32
+///         instruction if the CPU supports it, and a table-driven implementation otherwise.
+///         The data can be checksummed in pieces, by passing the result of the previous
+///         piece as the initial value.
+uint32_t CRC32C(const void* data, size_t len, uint32_t crc = 0);
+
+/// \brief Folds the checksum of one record into the checksum of a block of records.
+///         The block checksum is the CRC-32C of the little-endian record checksums, so
+///         it depends only on the records and their order, and not on where the records
+///         are stored in the files.
+uint32_t CombineRecordCRC32C(uint32_t blockCrc, uint32_t recordCrc);
+
+/// \brief Formats a checksum as a column of the DB indexes: "crc32c=<8 hex digits>".
+std::string CRC32CToString(uint32_t crc);
+
+/// \brief Parses a checksum column written by CRC32CToString. Throws if the column
+///         is not a valid checksum.
+uint32_t ParseCRC32C(const std::string& column);
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_CRC32C_H
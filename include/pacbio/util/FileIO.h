@@ -53,6 +53,9 @@ bool FormatIsXml(const std::string& fn);
 /// \brief Checks if the provided file path has a SeqDBe xtension.
 bool FormatIsSeqDB(const std::string& fn);
 
+/// \brief Checks if the provided file path has a SeedDB extension.
+bool FormatIsSeedDB(const std::string& fn);
+
 /// \brief Parses the format of a file based on it's extension.
 SequenceFormat ParseFormat(const std::string& filename);
 
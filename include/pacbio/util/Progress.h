@@ -0,0 +1,138 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_PROGRESS_H
+#define PANCAKE_PROGRESS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * \brief Counters of the work done by a workflow. The workers update them with relaxed atomic
+ * additions, so the updates are cheap enough to be done once per query.
+ * A "query" is the unit of work of the workflow, e.g. a sequence which was
+ * mapped, seeded or written.
+*/
+class ProgressCounters
+{
+public:
+    void AddQueries(int64_t val) { queries_.fetch_add(val, std::memory_order_relaxed); }
+    void AddBases(int64_t val) { bases_.fetch_add(val, std::memory_order_relaxed); }
+    void AddHits(int64_t val) { hits_.fetch_add(val, std::memory_order_relaxed); }
+    void AddAlignments(int64_t val) { alignments_.fetch_add(val, std::memory_order_relaxed); }
+    void AddBandWidenings(int64_t val)
+    {
+        bandWidenings_.fetch_add(val, std::memory_order_relaxed);
+    }
+    void AddOverlaps(int64_t val) { overlaps_.fetch_add(val, std::memory_order_relaxed); }
+
+    int64_t Queries() const { return queries_.load(std::memory_order_relaxed); }
+    int64_t Bases() const { return bases_.load(std::memory_order_relaxed); }
+    int64_t Hits() const { return hits_.load(std::memory_order_relaxed); }
+    int64_t Alignments() const { return alignments_.load(std::memory_order_relaxed); }
+    int64_t BandWidenings() const { return bandWidenings_.load(std::memory_order_relaxed); }
+    int64_t Overlaps() const { return overlaps_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> queries_{0};
+    std::atomic<int64_t> bases_{0};
+    std::atomic<int64_t> hits_{0};
+    std::atomic<int64_t> alignments_{0};
+    std::atomic<int64_t> bandWidenings_{0};
+    std::atomic<int64_t> overlaps_{0};
+};
+
+/*
+ * \brief A point-in-time copy of the counters, used to format the progress reports.
+ * The totals are <= 0 if they are not known in advance.
+*/
+class ProgressSnapshot
+{
+public:
+    double elapsedSecs = 0.0;
+    int64_t queries = 0;
+    int64_t totalQueries = 0;
+    int64_t bases = 0;
+    int64_t totalBases = 0;
+    int64_t hits = 0;
+    int64_t alignments = 0;
+    int64_t bandWidenings = 0;
+    int64_t overlaps = 0;
+};
+
+/// \brief Estimates the remaining time in seconds from the average rate so far.
+///         The fraction of processed bases is used if the total number of bases is known,
+///         otherwise the fraction of processed queries. Returns a negative value if the
+///         estimate cannot be made.
+double EstimateRemainingSecs(const ProgressSnapshot& snapshot);
+
+/// \brief Formats a duration in seconds as "HH:MM:SS", or as "--:--:--" if negative.
+std::string FormatDuration(double secs);
+
+/// \brief Formats a human readable single-line progress report.
+std::string FormatProgressLine(const std::string& name, const ProgressSnapshot& snapshot);
+
+/// \brief Formats a progress report as a single-line JSON object.
+std::string FormatProgressJSON(const std::string& name, const ProgressSnapshot& snapshot,
+                               bool isFinal);
+
+/*
+ * \brief Periodically reports the progress, rate and ETA of a workflow from a background
+ * thread. The reports are written to stderr every intervalSecs seconds, and optionally
+ * appended as JSON lines to a file. A final JSON line is written when the reporter is stopped.
+ * If intervalSecs <= 0, the reporter thread is not started and no periodic reports are
+ * written, but the counters can still be updated and the final JSON line is still written.
+*/
+class ProgressReporter
+{
+public:
+    ProgressReporter(const std::string& name, double intervalSecs, const std::string& jsonPath);
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    /// \brief Sets the total amount of work, used to compute the ETA. Can be called at any
+    ///         time, e.g. when the totals become known.
+    void SetTotals(int64_t totalQueries, int64_t totalBases);
+
+    ProgressCounters& Counters() { return counters_; }
+
+    ProgressSnapshot Snapshot() const;
+
+    /// \brief Starts the reporter thread. Does nothing if the reporting is disabled or
+    ///         the thread is already running.
+    void Start();
+
+    /// \brief Stops the reporter thread and writes the final JSON line. Called by the destructor.
+    void Stop();
+
+private:
+    std::string name_;
+    double intervalSecs_;
+    ProgressCounters counters_;
+    std::atomic<int64_t> totalQueries_{0};
+    std::atomic<int64_t> totalBases_{0};
+    std::chrono::time_point<std::chrono::steady_clock> startTime_;
+    std::unique_ptr<std::ofstream> jsonOfs_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopRequested_ = false;
+
+    void Run_();
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_PROGRESS_H
@@ -2,11 +2,13 @@
 
 #include <pacbio/alignment/AlignmentTools.h>
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <pbcopper/third-party/edlib.h>
 
@@ -15,8 +17,17 @@ namespace Pancake {
 
 PacBio::BAM::Cigar EdlibAlignmentToCigar(const unsigned char* aln, int32_t alnLen)
 {
+    PacBio::BAM::Cigar ret;
+    EdlibAlignmentToCigar(aln, alnLen, ret);
+    return ret;
+}
+
+void EdlibAlignmentToCigar(const unsigned char* aln, int32_t alnLen, PacBio::BAM::Cigar& retCigar)
+{
+    retCigar.clear();
+
     if (alnLen <= 0) {
-        return {};
+        return;
     }
 
     // Edlib move codes: 0: '=', 1: 'I', 2: 'D', 3: 'X'
@@ -27,11 +38,10 @@ PacBio::BAM::Cigar EdlibAlignmentToCigar(const unsigned char* aln, int32_t alnLe
 
     PacBio::BAM::CigarOperationType prevOp = PacBio::BAM::CigarOperationType::UNKNOWN_OP;
     int32_t count = 0;
-    PacBio::BAM::Cigar ret;
     for (int32_t i = 0; i <= alnLen; i++) {
         if (i == alnLen || (opToCigar[aln[i]] != prevOp &&
                             prevOp != PacBio::BAM::CigarOperationType::UNKNOWN_OP)) {
-            ret.emplace_back(PacBio::BAM::CigarOperation(prevOp, count));
+            retCigar.emplace_back(PacBio::BAM::CigarOperation(prevOp, count));
             count = 0;
         }
         if (i < alnLen) {
@@ -39,7 +49,6 @@ PacBio::BAM::Cigar EdlibAlignmentToCigar(const unsigned char* aln, int32_t alnLe
             count += 1;
         }
     }
-    return ret;
 }
 
 void EdlibAlignmentDiffCounts(const unsigned char* aln, int32_t alnLen, int32_t& numEq,
@@ -1011,32 +1020,383 @@ Data::Cigar ConvertM5ToCigar(const std::string& queryAln, const std::string& tar
     return cigar;
 }
 
+namespace {
+
+/*
+ * Walks through the columns of an alignment given by a CIGAR string, without expanding
+ * the alignment. Columns of the same CIGAR operation can be skipped in bulk.
+*/
+class CigarColumnReader
+{
+public:
+    CigarColumnReader(const char* query, const char* target, const Data::Cigar& cigar)
+        : query_(query), target_(target), cigar_(cigar)
+    {
+        SkipEmptyOps_();
+    }
+
+    bool Done() const { return opId_ >= cigar_.size(); }
+
+    Data::CigarOperationType Type() const { return cigar_[opId_].Type(); }
+
+    int32_t Remaining() const { return static_cast<int32_t>(cigar_[opId_].Length()) - opOffset_; }
+
+    bool HasQueryBase() const
+    {
+        const auto op = Type();
+        return op != Data::CigarOperationType::DELETION &&
+               op != Data::CigarOperationType::REFERENCE_SKIP;
+    }
+
+    bool HasTargetBase() const
+    {
+        const auto op = Type();
+        return op != Data::CigarOperationType::INSERTION &&
+               op != Data::CigarOperationType::SOFT_CLIP;
+    }
+
+    char QueryChar() const { return HasQueryBase() ? query_[queryPos_] : '-'; }
+
+    char TargetChar() const { return HasTargetBase() ? target_[targetPos_] : '-'; }
+
+    void Advance(int32_t count)
+    {
+        queryPos_ += HasQueryBase() ? count : 0;
+        targetPos_ += HasTargetBase() ? count : 0;
+        opOffset_ += count;
+        if (opOffset_ >= static_cast<int32_t>(cigar_[opId_].Length())) {
+            ++opId_;
+            opOffset_ = 0;
+            SkipEmptyOps_();
+        }
+    }
+
+private:
+    const char* query_;
+    const char* target_;
+    const Data::Cigar& cigar_;
+    size_t opId_ = 0;
+    int32_t opOffset_ = 0;
+    int64_t queryPos_ = 0;
+    int64_t targetPos_ = 0;
+
+    void SkipEmptyOps_()
+    {
+        while (opId_ < cigar_.size() && cigar_[opId_].Length() == 0) {
+            ++opId_;
+        }
+    }
+};
+
+void AppendColumnToCigar(Data::Cigar& cigar, char queryChar, char targetChar)
+{
+    if (queryChar == '-' && targetChar == '-') {
+        return;
+    } else if (queryChar == '-') {
+        AppendToCigar(cigar, Data::CigarOperationType::DELETION, 1);
+    } else if (targetChar == '-') {
+        AppendToCigar(cigar, Data::CigarOperationType::INSERTION, 1);
+    } else if (queryChar == targetChar) {
+        AppendToCigar(cigar, Data::CigarOperationType::SEQUENCE_MATCH, 1);
+    } else {
+        AppendToCigar(cigar, Data::CigarOperationType::SEQUENCE_MISMATCH, 1);
+    }
+}
+
+}  // namespace
+
 Data::Cigar NormalizeCigar(const char* query, int64_t queryLen, const char* target,
                            int64_t targetLen, const Data::Cigar& cigar)
 {
-    std::string queryAln;
-    std::string targetAln;
+    Data::Cigar ret;
+    std::vector<char> gapRun;
+    NormalizeCigar(query, queryLen, target, targetLen, cigar, ret, gapRun);
+    return ret;
+}
+
+void NormalizeCigar(const char* query, int64_t queryLen, const char* target, int64_t targetLen,
+                    const Data::Cigar& cigar, Data::Cigar& retCigar, std::vector<char>& gapRun)
+{
+    /*
+     * Produces the same result as normalizing the M5 representation of the alignment
+     * with NormalizeAlignmentInPlace, but works directly on the CIGAR operations.
+     *
+     * NormalizeAlignmentInPlace scans the columns left to right. When it finds a gap,
+     * it moves the next base of the same sequence into the gap if that base is the
+     * same as the base on the other side of the gap, or if the column of that base
+     * is not a match. All columns left of the scan are final, and all modified columns
+     * right of the scan form a single contiguous run of gaps in the same sequence,
+     * beginning at the current column. Only this run is kept here, as the bases on the
+     * non-gap side (or '-' for columns where both sequences have a gap). Matches and
+     * mismatches outside of a run are copied to the output CIGAR in bulk, so the work
+     * depends on the number and length of gaps, and the repeats they are shifted
+     * through, instead of the length of the alignment.
+     *
+     * The '=' and 'X' operations are expected to be consistent with the sequences.
+    */
 
-    PacBio::Pancake::ConvertCigarToM5(query, queryLen, target, targetLen, cigar, queryAln,
-                                      targetAln);
+    retCigar.clear();
+    gapRun.clear();
 
-    NormalizeAlignmentInPlace(queryAln, targetAln);
+    if (cigar.empty()) {
+        return;
+    }
+
+    for (const auto& op : cigar) {
+        if (op.Type() != Data::CigarOperationType::ALIGNMENT_MATCH &&
+            op.Type() != Data::CigarOperationType::SEQUENCE_MATCH &&
+            op.Type() != Data::CigarOperationType::SEQUENCE_MISMATCH &&
+            op.Type() != Data::CigarOperationType::INSERTION &&
+            op.Type() != Data::CigarOperationType::SOFT_CLIP &&
+            op.Type() != Data::CigarOperationType::DELETION &&
+            op.Type() != Data::CigarOperationType::REFERENCE_SKIP) {
+            throw std::runtime_error{"ERROR: Unknown/unsupported CIGAR op: " +
+                                     std::to_string(op.Char())};
+        }
+    }
+
+    // Sanity check.
+    const Alignment::DiffCounts diffs = CigarDiffCounts(cigar);
+    const int32_t querySpan = diffs.numEq + diffs.numX + diffs.numI;
+    const int32_t targetSpan = diffs.numEq + diffs.numX + diffs.numD;
+    if (querySpan != queryLen || targetSpan != targetLen) {
+        std::ostringstream oss;
+        oss << "Invalid CIGAR string, query or target span do not match. CIGAR: "
+            << cigar.ToStdString() << ", queryLen = " << queryLen << ", targetLen = " << targetLen
+            << ", querySpan = " << querySpan << ", targetSpan = " << targetSpan;
+        throw std::runtime_error(oss.str());
+    }
+
+    CigarColumnReader reader(query, target, cigar);
+
+    // The run of gap columns which begins at the current column. For each column,
+    // the base of the sequence which does not have a gap is stored.
+    size_t gapRunStart = 0;
+    bool gapInTarget = false;
+
+    while (true) {
+        if (gapRunStart == gapRun.size()) {
+            gapRun.clear();
+            gapRunStart = 0;
+
+            if (reader.Done()) {
+                break;
+            }
+
+            const auto op = reader.Type();
+            if (op == Data::CigarOperationType::SEQUENCE_MATCH ||
+                op == Data::CigarOperationType::SEQUENCE_MISMATCH) {
+                AppendToCigar(retCigar, op, reader.Remaining());
+                reader.Advance(reader.Remaining());
+            } else if (op == Data::CigarOperationType::ALIGNMENT_MATCH) {
+                AppendColumnToCigar(retCigar, reader.QueryChar(), reader.TargetChar());
+                reader.Advance(1);
+            } else {
+                gapInTarget = reader.HasQueryBase();
+                gapRun.emplace_back(gapInTarget ? reader.QueryChar() : reader.TargetChar());
+                reader.Advance(1);
+            }
+            continue;
+        }
 
-    return PacBio::Pancake::ConvertM5ToCigar(queryAln, targetAln);
+        const char gapBase = gapRun[gapRunStart];
+        ++gapRunStart;
+
+        // Both sequences have a gap in this column.
+        if (gapBase == '-') {
+            continue;
+        }
+
+        // Find the next column with a base in the gapped sequence.
+        // The columns in between extend the run.
+        while (reader.Done() == false &&
+               (gapInTarget ? reader.HasTargetBase() : reader.HasQueryBase()) == false) {
+            gapRun.emplace_back(gapInTarget ? reader.QueryChar() : reader.TargetChar());
+            reader.Advance(1);
+        }
+
+        if (reader.Done()) {
+            AppendColumnToCigar(retCigar, gapInTarget ? gapBase : '-', gapInTarget ? '-' : gapBase);
+            continue;
+        }
+
+        // Move the base into the gap if it is the same as the base on the other side,
+        // or if its column is not a match. Its column then extends the run.
+        const char queryChar = reader.QueryChar();
+        const char targetChar = reader.TargetChar();
+        const char movedChar = gapInTarget ? targetChar : queryChar;
+        if (movedChar == gapBase || targetChar != queryChar) {
+            AppendColumnToCigar(retCigar, gapInTarget ? gapBase : queryChar,
+                                gapInTarget ? targetChar : gapBase);
+            gapRun.emplace_back(gapInTarget ? queryChar : targetChar);
+            reader.Advance(1);
+        } else {
+            AppendColumnToCigar(retCigar, gapInTarget ? gapBase : '-', gapInTarget ? '-' : gapBase);
+        }
+
+        // Drop the processed part of a run which is shifted through a long repeat.
+        if (gapRunStart >= 1024 && (gapRunStart * 2) >= gapRun.size()) {
+            gapRun.erase(gapRun.begin(), gapRun.begin() + gapRunStart);
+            gapRunStart = 0;
+        }
+    }
+}
+
+namespace {
+
+/*
+ * Finds the first window of windowSize alignment columns which contains at least minMatches
+ * '=' columns, and (if clipOnFirstMatch is true) begins with a '=' column. Each base of a
+ * CIGAR operation is one column. The operations are visited from the back if reverse is true.
+ *
+ * Within a stretch in which the first and the last column of the window do not change their
+ * CIGAR operation, the number of matches in the window changes linearly, so the window is
+ * moved over whole stretches instead of one column at a time. Only windows which are followed
+ * by at least one more column are considered.
+ *
+ * \returns true if a window was found, together with the ID of the CIGAR operation in which
+ *          the window begins, the number of columns of that operation before the window, and
+ *          the query and target lengths of all columns before the window.
+*/
+bool FindTrimmingWindow(const PacBio::BAM::Cigar& cigar, const bool reverse,
+                        const int32_t windowSize, const int32_t minMatches,
+                        const bool clipOnFirstMatch, int32_t& retOpId, int32_t& retOpInternalId,
+                        int32_t& retPosQuery, int32_t& retPosTarget)
+{
+    const int32_t numOps = cigar.size();
+    const auto OpAt = [&](int32_t id) -> const PacBio::Data::CigarOperation& {
+        return cigar[reverse ? (numOps - 1 - id) : id];
+    };
+    const auto IsMatch = [&](int32_t id) {
+        return OpAt(id).Type() == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH;
+    };
+    // Moves to the next operation which has at least one column.
+    const auto NextNonEmptyOp = [&](int32_t id) {
+        while (id < numOps && OpAt(id).Length() == 0) {
+            ++id;
+        }
+        return id;
+    };
+
+    int64_t numColumns = 0;
+    for (const auto& op : cigar) {
+        numColumns += op.Length();
+    }
+    const int64_t lastWindowStart = numColumns - 1 - windowSize;
+
+    // Window start and window end (one past the last column), each as an operation ID and
+    // the number of columns of that operation before it.
+    int32_t startOpId = NextNonEmptyOp(0);
+    int64_t startOffset = 0;
+    int32_t endOpId = startOpId;
+    int64_t endOffset = 0;
+    int64_t matchCount = 0;
+    for (int64_t remaining = windowSize; remaining > 0 && endOpId < numOps;) {
+        const int64_t span = std::min<int64_t>(remaining, OpAt(endOpId).Length() - endOffset);
+        matchCount += IsMatch(endOpId) ? span : 0;
+        remaining -= span;
+        endOffset += span;
+        if (endOffset == OpAt(endOpId).Length()) {
+            endOpId = NextNonEmptyOp(endOpId + 1);
+            endOffset = 0;
+        }
+    }
+
+    bool found = false;
+    for (int64_t windowStart = 0; windowStart <= lastWindowStart;) {
+        const int64_t stretch =
+            std::min({OpAt(startOpId).Length() - startOffset, OpAt(endOpId).Length() - endOffset,
+                      lastWindowStart - windowStart + 1});
+        const int64_t slope = (IsMatch(endOpId) ? 1 : 0) - (IsMatch(startOpId) ? 1 : 0);
+
+        if (clipOnFirstMatch == false || IsMatch(startOpId)) {
+            int64_t shift = -1;
+            if (matchCount >= minMatches) {
+                shift = 0;
+            } else if (slope > 0 && (minMatches - matchCount) < stretch) {
+                shift = minMatches - matchCount;
+            }
+            if (shift >= 0) {
+                startOffset += shift;
+                found = true;
+                break;
+            }
+        }
+
+        windowStart += stretch;
+        matchCount += slope * stretch;
+        startOffset += stretch;
+        endOffset += stretch;
+        if (startOffset == OpAt(startOpId).Length()) {
+            startOpId = NextNonEmptyOp(startOpId + 1);
+            startOffset = 0;
+        }
+        if (endOffset == OpAt(endOpId).Length()) {
+            endOpId = NextNonEmptyOp(endOpId + 1);
+            endOffset = 0;
+        }
+    }
+
+    // Accumulate the lengths of the columns which were moved out of the window. If no window
+    // was found, every window start which was tested was moved out.
+    int64_t numSkipped = 0;
+    if (found == false) {
+        numSkipped = std::max<int64_t>(0, lastWindowStart + 1);
+    }
+    int32_t posQuery = 0;
+    int32_t posTarget = 0;
+    for (int32_t id = 0; id < numOps; ++id) {
+        const auto& op = OpAt(id);
+        int64_t span = op.Length();
+        if (found) {
+            if (id > startOpId) {
+                break;
+            }
+            span = (id == startOpId) ? startOffset : span;
+        } else {
+            span = std::min(span, numSkipped);
+            numSkipped -= span;
+        }
+        if (span == 0) {
+            continue;
+        }
+        const auto opType = op.Type();
+        if (opType == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH ||
+            opType == PacBio::BAM::CigarOperationType::SEQUENCE_MISMATCH) {
+            posQuery += span;
+            posTarget += span;
+        } else if (opType == PacBio::BAM::CigarOperationType::INSERTION) {
+            posQuery += span;
+        } else if (opType == PacBio::BAM::CigarOperationType::DELETION) {
+            posTarget += span;
+        } else {
+            throw std::runtime_error("Unsupported CIGAR operation when trimming the alignment: '" +
+                                     std::string(Data::CigarOperation::TypeToChar(opType), 1) +
+                                     "'");
+        }
+    }
+
+    if (found == false) {
+        return false;
+    }
+
+    retOpId = reverse ? (numOps - 1 - startOpId) : startOpId;
+    retOpInternalId = startOffset;
+    retPosQuery = posQuery;
+    retPosTarget = posTarget;
+    return true;
 }
 
+}  // namespace
+
 bool TrimCigar(const PacBio::BAM::Cigar& cigar, const int32_t windowSize, const int32_t minMatches,
                const bool clipOnFirstMatch, PacBio::BAM::Cigar& retTrimmedCigar,
                TrimmingInfo& retTrimming)
 {
-    // Hardcode the max window size so that we can allocate on stack.
-    static const int32_t MAX_WINDOW_SIZE = 512;
-
     // Sanity check.
-    if (windowSize >= MAX_WINDOW_SIZE) {
+    if (windowSize < 0) {
         std::ostringstream oss;
-        oss << "Too large window size. Requested: " << windowSize
-            << ", max allowed: " << MAX_WINDOW_SIZE;
+        oss << "Invalid window size, it should be >= 0. Requested: " << windowSize;
         throw std::runtime_error(oss.str());
     }
 
@@ -1047,82 +1407,6 @@ bool TrimCigar(const PacBio::BAM::Cigar& cigar, const int32_t windowSize, const
     // Temporary storage until the end, so that we don't return partial results.
     TrimmingInfo trimInfo;
 
-    const auto ProcessCigarOp = [](
-        const PacBio::BAM::Cigar& _cigar, const int32_t opId, const int32_t _windowSize,
-        const int32_t _minMatches, const bool _clipOnFirstMatch,
-        std::array<std::pair<int32_t, int32_t>, 512>& buff, int32_t& buffStart, int32_t& buffEnd,
-        int32_t& matchCount, int32_t& foundOpId, int32_t& foundOpInternalId, int32_t& posQuery,
-        int32_t& posTarget) -> bool {
-        /*
-         * This function processes a single CIGAR operation and adds it to the circular buffer.
-         * The circular buffer represents the window.
-         * Every base of the CIGAR event is processed and added separately to the window, and the
-         * amount of matches in the window are maintained.
-         * Once the window is filled to its size, we check if it is valid or it needs to be trimmed.
-         * \returns true if a valid window was found. Also, the ID of the CIGAR operation and the
-         *          internal ID of that CIGAR operation are returned via parameters.
-        */
-
-        const auto& op = _cigar[opId];
-        int32_t opLen = op.Length();
-        int32_t buffSize = buff.size();
-        for (int32_t i = 0; i < opLen; ++i) {
-            const int32_t currWindowSize =
-                (buffEnd >= buffStart) ? (buffEnd - buffStart) : (buffSize - buffStart + buffEnd);
-
-            // This happens only after the window has been filled.
-            if (currWindowSize >= _windowSize) {
-                // Get the start operation, which will be pushed outside of the window.
-                const auto& windowOpPair = buff[buffStart];
-                const int32_t startOpId = windowOpPair.first;
-                const int32_t startOpInternalId = windowOpPair.second;
-                const auto startOpType = _cigar[startOpId].Type();
-                buffStart = (buffStart + 1) % buffSize;
-
-                // Check if we found our target window.
-                if (matchCount >= _minMatches &&
-                    (_clipOnFirstMatch == false ||
-                     (_clipOnFirstMatch &&
-                      startOpType == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH))) {
-                    foundOpId = startOpId;
-                    foundOpInternalId = startOpInternalId;
-                    return true;
-                }
-
-                // Move window down and maintain the match count.
-                if (startOpType == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH) {
-                    // If the start operation was a match, reduce the count as it leaves the window.
-                    matchCount = std::max(matchCount - 1, 0);
-                    ++posQuery;
-                    ++posTarget;
-                } else if (startOpType == PacBio::BAM::CigarOperationType::SEQUENCE_MISMATCH) {
-                    ++posQuery;
-                    ++posTarget;
-                } else if (startOpType == PacBio::BAM::CigarOperationType::INSERTION) {
-                    ++posQuery;
-                } else if (startOpType == PacBio::BAM::CigarOperationType::DELETION) {
-                    ++posTarget;
-                } else {
-                    throw std::runtime_error(
-                        "Unsupported CIGAR operation when trimming the alignment: '" +
-                        std::string(Data::CigarOperation::TypeToChar(startOpType), 1) + "'");
-                }
-            }
-
-            // Add to the window.
-            buff[buffEnd].first = opId;
-            buff[buffEnd].second = i;
-            buffEnd = (buffEnd + 1) % buffSize;
-            if (op.Type() == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH) {
-                ++matchCount;
-            }
-        }
-        return false;
-    };
-
-    // Circular buffer.
-    std::array<std::pair<int32_t, int32_t>, MAX_WINDOW_SIZE> buff;
-
     // Clipping information.
     PacBio::Data::CigarOperation prefixOp;
     int32_t infixOpIdStart = 0;
@@ -1136,23 +1420,13 @@ bool TrimCigar(const PacBio::BAM::Cigar& cigar, const int32_t windowSize, const
 
     // Find clipping of the front part.
     {
-        int32_t buffStart = 0;
-        int32_t buffEnd = 0;
-        int32_t matchCount = 0;
         int32_t posQuery = 0;
         int32_t posTarget = 0;
         int32_t foundOpId = 0;
         int32_t foundOpInternalId = 0;
-        bool foundGoodWindow = false;
-
-        for (int32_t opId = 0; opId < static_cast<int32_t>(cigar.size()); ++opId) {
-            foundGoodWindow = ProcessCigarOp(cigar, opId, windowSize, minMatches, clipOnFirstMatch,
-                                             buff, buffStart, buffEnd, matchCount, foundOpId,
-                                             foundOpInternalId, posQuery, posTarget);
-            if (foundGoodWindow) {
-                break;
-            }
-        }
+        const bool foundGoodWindow =
+            FindTrimmingWindow(cigar, false, windowSize, minMatches, clipOnFirstMatch, foundOpId,
+                               foundOpInternalId, posQuery, posTarget);
 
         // If we cannot find a good window, just return.
         // This means that we looped through the entire CIGAR string, and it was bad in its entirety.
@@ -1175,23 +1449,13 @@ bool TrimCigar(const PacBio::BAM::Cigar& cigar, const int32_t windowSize, const
 
     // Find clipping of the back part.
     {
-        int32_t buffStart = 0;
-        int32_t buffEnd = 0;
-        int32_t matchCount = 0;
         int32_t posQuery = 0;
         int32_t posTarget = 0;
         int32_t foundOpId = 0;
         int32_t foundOpInternalId = 0;
-        bool foundGoodWindow = false;
-
-        for (int32_t opId = (static_cast<int32_t>(cigar.size()) - 1); opId >= 0; --opId) {
-            foundGoodWindow = ProcessCigarOp(cigar, opId, windowSize, minMatches, clipOnFirstMatch,
-                                             buff, buffStart, buffEnd, matchCount, foundOpId,
-                                             foundOpInternalId, posQuery, posTarget);
-            if (foundGoodWindow) {
-                break;
-            }
-        }
+        const bool foundGoodWindow =
+            FindTrimmingWindow(cigar, true, windowSize, minMatches, clipOnFirstMatch, foundOpId,
+                               foundOpInternalId, posQuery, posTarget);
 
         // If we cannot find a good window, just return.
         // This means that we looped through the entire CIGAR string, and it was bad in it's entirety.
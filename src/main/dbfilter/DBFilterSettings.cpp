@@ -98,6 +98,21 @@ R"({
     "description" : "Write seeds for each block into a separate file."
 })", DBFilterSettings::Defaults::SplitBlocks};
 
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed queries and bases, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", DBFilterSettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
 // clang-format on
 
 }  // namespace OptionNames
@@ -139,6 +154,8 @@ DBFilterSettings::DBFilterSettings(const PacBio::CLI_v2::Results& options)
     , CompressionLevel{options[OptionNames::CompressionLevel]}
     , BufferSize{options[OptionNames::BufferSize]}
     , SplitBlocks{options[OptionNames::SplitBlocks]}
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
 {
     Sampling = ParseSamplingType(options[OptionNames::Sampling]);
     if (Sampling == SamplingType::Unknown) {
@@ -184,6 +201,10 @@ PacBio::CLI_v2::Interface DBFilterSettings::CreateCLI()
         OptionNames::BufferSize,
         OptionNames::SplitBlocks,
     });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
+    });
     i.AddPositionalArguments({
         OptionNames::InputPrefix,
         OptionNames::OutputPrefix,
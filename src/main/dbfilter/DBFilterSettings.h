@@ -26,6 +26,7 @@ struct DBFilterSettings
         static const int32_t CompressionLevel = 1;
         static constexpr float BufferSize = 1000.0f;
         static const bool SplitBlocks = false;
+        static constexpr double ProgressInterval = 60.0;
     };
 
     std::string InputPrefix;
@@ -42,6 +43,8 @@ struct DBFilterSettings
     int32_t CompressionLevel = Defaults::CompressionLevel;
     float BufferSize = Defaults::BufferSize;
     bool SplitBlocks = Defaults::SplitBlocks;
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
 
     DBFilterSettings();
     DBFilterSettings(const PacBio::CLI_v2::Results& options);
@@ -18,6 +18,7 @@
 #include <pacbio/pancake/SeqDBIndexCache.h>
 #include <pacbio/pancake/SeqDBReader.h>
 #include <pacbio/pancake/SeqDBWriter.h>
+#include <pacbio/util/Progress.h>
 #include <pacbio/util/TicToc.h>
 #include <pacbio/util/Util.h>
 
@@ -89,13 +90,25 @@ int DBFilterWorkflow::Runner(const PacBio::CLI_v2::Results& options)
             settings.OutputPrefix, settings.CompressionLevel, settings.BufferSize,
             settings.BlockSize, settings.SplitBlocks);
 
+        ProgressReporter progress("dbfilter", settings.ProgressInterval, settings.ProgressJSON);
+        int64_t totalBases = 0;
+        for (const auto& sl : filteredSeqDBCache->seqLines) {
+            totalBases += sl.numBases;
+        }
+        progress.SetTotals(filteredSeqDBCache->seqLines.size(), totalBases);
+        progress.Start();
+
         // Fetch and copy all the sequences into the new DB.
         Pancake::FastaSequenceId record;
         for (const auto& sl : filteredSeqDBCache->seqLines) {
             reader.GetSequence(record, sl.seqId);
-            writer->AddSequence(record.Name(), record.Bases());
+            writer->AddSequence(record.Name(), record.Bases(), sl.isCircular);
+            progress.Counters().AddQueries(1);
+            progress.Counters().AddBases(record.Bases().size());
         }
 
+        progress.Stop();
+
     } else {
         NormalizeSeqDBIndexCache(*filteredSeqDBCache, settings.BlockSize);
         std::unique_ptr<FILE, FileDeleter> fpOutSeqDBCache =
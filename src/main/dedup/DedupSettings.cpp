@@ -0,0 +1,173 @@
+// Author: Ivan Sovic
+
+#include "DedupSettings.h"
+#include <pacbio/Version.h>
+
+namespace PacBio {
+namespace Pancake {
+namespace OptionNames {
+
+// clang-format off
+
+const CLI_v2::PositionalArgument InputFile {
+R"({
+    "name" : "input.seqdb",
+    "description" : "Path to the SeqDB to process."
+})"};
+
+const CLI_v2::PositionalArgument OutputFile {
+R"({
+    "name" : "out_fn",
+    "description" : "Output filter list with one read name per line, usable with 'pancake dbfilter --filter-list'."
+})"};
+
+const CLI_v2::Option KmerSize{
+R"({
+    "names" : ["k", "kmer-size"],
+    "type" : "int",
+    "description" : "Kmer size for the sketches. Maximum size is 32."
+})", DedupSettings::Defaults::KmerSize};
+
+const CLI_v2::Option SketchSize{
+R"({
+    "names" : ["sketch-size"],
+    "type" : "int",
+    "description" : "Number of the smallest hashed kmers kept in the sketch of each read."
+})", DedupSettings::Defaults::SketchSize};
+
+const CLI_v2::Option MinJaccard{
+R"({
+    "names" : ["min-jaccard"],
+    "type" : "double",
+    "description" : "Minimum Jaccard similarity estimated from the sketches for a pair of reads to be aligned as a near-duplicate candidate."
+})", DedupSettings::Defaults::MinJaccard};
+
+const CLI_v2::Option MaxDiffRate{
+R"({
+    "names" : ["max-diff-rate"],
+    "type" : "double",
+    "description" : "Maximum rate of diffs in the alignment of two duplicates, relative to the shorter read. The difference in lengths is allowed on top of this."
+})", DedupSettings::Defaults::MaxDiffRate};
+
+const CLI_v2::Option MinLengthRatio{
+R"({
+    "names" : ["min-length-ratio"],
+    "type" : "double",
+    "description" : "Minimum ratio of the shorter to the longer read length for two reads to be near-duplicates."
+})", DedupSettings::Defaults::MinLengthRatio};
+
+const CLI_v2::Option BufferSize{
+R"({
+    "names" : ["buffer-size"],
+    "description" : "Sequence buffer size in megabytes for confirming the candidates. The candidate pairs are aligned in chunks, and the reads of each chunk are loaded at once. Has to be >= 0.0.",
+    "type" : "float"
+})", DedupSettings::Defaults::BufferSize};
+
+const CLI_v2::Option Blacklist{
+R"({
+    "names" : ["blacklist"],
+    "description" : "Write the names of the removed duplicates instead of the kept reads. Use with '--filter-type blacklist' in dbfilter.",
+    "type" : "bool"
+})", DedupSettings::Defaults::Blacklist};
+
+const CLI_v2::Option GroupsFile{
+R"({
+    "names" : ["groups"],
+    "description" : "Write the duplicates to this file, one per line: the name of the kept representative and the name of the duplicate, tab separated.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed queries and bases, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", DedupSettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+// clang-format on
+
+}  // namespace OptionNames
+
+DedupSettings::DedupSettings() = default;
+
+DedupSettings::DedupSettings(const PacBio::CLI_v2::Results& options)
+    : InputFile{options[OptionNames::InputFile]}
+    , OutputFile{options[OptionNames::OutputFile]}
+    , NumThreads{options.NumThreads()}
+    , KmerSize{options[OptionNames::KmerSize]}
+    , SketchSize{options[OptionNames::SketchSize]}
+    , MinJaccard{options[OptionNames::MinJaccard]}
+    , MaxDiffRate{options[OptionNames::MaxDiffRate]}
+    , MinLengthRatio{options[OptionNames::MinLengthRatio]}
+    , BufferSize{options[OptionNames::BufferSize]}
+    , Blacklist{options[OptionNames::Blacklist]}
+    , GroupsFile{options[OptionNames::GroupsFile]}
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
+{
+    if (KmerSize <= 0 || KmerSize > 32) {
+        throw std::runtime_error("The kmer size needs to be in the range [1, 32].");
+    }
+    if (SketchSize <= 0) {
+        throw std::runtime_error("The sketch size needs to be a positive value.");
+    }
+    if (MinJaccard < 0.0 || MinJaccard > 1.0) {
+        throw std::runtime_error("The minimum Jaccard similarity needs to be in [0.0, 1.0].");
+    }
+    if (MaxDiffRate < 0.0 || MaxDiffRate > 1.0) {
+        throw std::runtime_error("The maximum diff rate needs to be in [0.0, 1.0].");
+    }
+    if (MinLengthRatio < 0.0 || MinLengthRatio > 1.0) {
+        throw std::runtime_error("The minimum length ratio needs to be in [0.0, 1.0].");
+    }
+    if (BufferSize < 0.0f) {
+        throw std::runtime_error("Buffer size cannot be a negative value.");
+    }
+
+    // Convert the buffer size from MB to bytes.
+    BufferSize *= (1024 * 1024);
+}
+
+PacBio::CLI_v2::Interface DedupSettings::CreateCLI()
+{
+    PacBio::CLI_v2::Interface i{"pancake dedup",
+                                "Detects the duplicate reads in a SeqDB without overlapping, and "
+                                "writes a filter list which keeps one read of each group.",
+                                PacBio::Pancake::PancakeFormattedVersion()};
+
+    // clang-format off
+    i.AddOptionGroup("Algorithm Options", {
+        OptionNames::KmerSize,
+        OptionNames::SketchSize,
+        OptionNames::MinJaccard,
+        OptionNames::MaxDiffRate,
+        OptionNames::MinLengthRatio,
+        OptionNames::BufferSize,
+    });
+    i.AddOptionGroup("Output Options", {
+        OptionNames::Blacklist,
+        OptionNames::GroupsFile,
+    });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
+    });
+    i.AddPositionalArguments({
+        OptionNames::InputFile,
+        OptionNames::OutputFile,
+    });
+
+    // clang-format on
+    return i;
+}
+}  // namespace Pancake
+}  // namespace PacBio
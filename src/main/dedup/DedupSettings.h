@@ -0,0 +1,51 @@
+// Authors: Ivan Sovic
+
+#ifndef PANCAKE_DEDUP_SETTINGS_H
+#define PANCAKE_DEDUP_SETTINGS_H
+
+#include <cstdint>
+#include <string>
+
+#include <pbcopper/cli2/CLI.h>
+
+namespace PacBio {
+namespace Pancake {
+
+struct DedupSettings
+{
+    struct Defaults
+    {
+        static const size_t NumThreads = 1;
+        static const int32_t KmerSize = 21;
+        static const int32_t SketchSize = 32;
+        static constexpr double MinJaccard = 0.5;
+        static constexpr double MaxDiffRate = 0.01;
+        static constexpr double MinLengthRatio = 0.95;
+        static constexpr float BufferSize = 1000.0f;
+        static const bool Blacklist = false;
+        static constexpr double ProgressInterval = 60.0;
+    };
+
+    std::string InputFile;
+    std::string OutputFile;
+    size_t NumThreads = Defaults::NumThreads;
+    int32_t KmerSize = Defaults::KmerSize;
+    int32_t SketchSize = Defaults::SketchSize;
+    double MinJaccard = Defaults::MinJaccard;
+    double MaxDiffRate = Defaults::MaxDiffRate;
+    double MinLengthRatio = Defaults::MinLengthRatio;
+    float BufferSize = Defaults::BufferSize;
+    bool Blacklist = Defaults::Blacklist;
+    std::string GroupsFile;
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
+
+    DedupSettings();
+    DedupSettings(const PacBio::CLI_v2::Results& options);
+    static PacBio::CLI_v2::Interface CreateCLI();
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_DEDUP_SETTINGS_H
@@ -0,0 +1,257 @@
+// Authors: Ivan Sovic
+
+#include "DedupWorkflow.h"
+#include "DedupSettings.h"
+#include <pacbio/pancake/DuplicateReads.h>
+#include <pacbio/pancake/SeqDBIndexCache.h>
+#include <pacbio/pancake/SeqDBReaderCachedBlock.h>
+#include <pacbio/util/Progress.h>
+#include <pacbio/util/TicToc.h>
+#include <pbcopper/logging/LogLevel.h>
+#include <pbcopper/logging/Logging.h>
+#include <pbcopper/parallel/FireAndForget.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * Alignment of a candidate pair. The number of diffs is -1 if the reads are not duplicates.
+*/
+struct ConfirmedDuplicate
+{
+    int32_t idA = -1;
+    int32_t idB = -1;
+    int32_t diffs = -1;
+    bool isRev = false;
+};
+
+void FingerprintWorker(const std::vector<FastaSequenceCached>& records,
+                       const DedupSettings& settings, int32_t start, int32_t end,
+                       std::vector<ReadFingerprint>& fingerprints, ProgressCounters& counters)
+{
+    for (int32_t i = start; i < end; ++i) {
+        const auto& record = records[i];
+        fingerprints[record.Id()] = ComputeReadFingerprint(record.c_str(), record.size(),
+                                                           settings.KmerSize, settings.SketchSize);
+        counters.AddQueries(1);
+        counters.AddBases(record.size());
+    }
+}
+
+void AlignCandidatesWorker(const std::vector<FastaSequenceCached>& records,
+                           const std::unordered_map<int32_t, int32_t>& idToRecord,
+                           const std::vector<std::pair<int32_t, int32_t>>& candidates,
+                           double maxDiffRate, int32_t start, int32_t end,
+                           std::vector<ConfirmedDuplicate>& results, ProgressCounters& counters)
+{
+    auto ss = std::make_shared<Alignment::SESScratchSpace>();
+    for (int32_t i = start; i < end; ++i) {
+        const auto& recordA = records[idToRecord.at(candidates[i].first)];
+        const auto& recordB = records[idToRecord.at(candidates[i].second)];
+        auto& result = results[i];
+        result.idA = candidates[i].first;
+        result.idB = candidates[i].second;
+        result.diffs = AlignDuplicateCandidate(recordA.c_str(), recordA.size(), recordB.c_str(),
+                                               recordB.size(), maxDiffRate, result.isRev, ss);
+    }
+    counters.AddAlignments(end - start);
+}
+
+/// \brief Loads the reads of the candidate pairs in [start, end), and aligns the pairs in
+///         parallel.
+void ConfirmCandidateChunk(SeqDBReaderCachedBlock& reader,
+                           const std::vector<std::pair<int32_t, int32_t>>& candidates,
+                           int32_t start, int32_t end, const DedupSettings& settings,
+                           std::vector<ConfirmedDuplicate>& results, ProgressCounters& counters)
+{
+    std::vector<int32_t> seqIds;
+    for (int32_t i = start; i < end; ++i) {
+        seqIds.emplace_back(candidates[i].first);
+        seqIds.emplace_back(candidates[i].second);
+    }
+    std::sort(seqIds.begin(), seqIds.end());
+    seqIds.erase(std::unique(seqIds.begin(), seqIds.end()), seqIds.end());
+    reader.LoadSequences(seqIds);
+    std::unordered_map<int32_t, int32_t> idToRecord;
+    for (int32_t i = 0; i < static_cast<int32_t>(reader.records().size()); ++i) {
+        idToRecord[reader.records()[i].Id()] = i;
+    }
+
+    const int32_t numCandidates = end - start;
+    const int32_t numThreads = std::max<int32_t>(1, settings.NumThreads);
+    const int32_t chunkSize = (numCandidates + numThreads - 1) / numThreads;
+    PacBio::Parallel::FireAndForget faf(numThreads);
+    for (int32_t chunkStart = start; chunkStart < end; chunkStart += chunkSize) {
+        const int32_t chunkEnd = std::min(end, chunkStart + chunkSize);
+        faf.ProduceWith(AlignCandidatesWorker, std::cref(reader.records()), std::cref(idToRecord),
+                        std::cref(candidates), settings.MaxDiffRate, chunkStart, chunkEnd,
+                        std::ref(results), std::ref(counters));
+    }
+    faf.Finalize();
+}
+
+/// \brief Aligns all candidate pairs. The pairs are confirmed in consecutive chunks, and the
+///         reads of a chunk fit into the buffer size. A single pair larger than the buffer is
+///         confirmed on its own.
+std::vector<ConfirmedDuplicate> ConfirmCandidates(
+    const SeqDBIndexCache& seqDBCache, SeqDBReaderCachedBlock& reader,
+    const std::vector<std::pair<int32_t, int32_t>>& candidates, const DedupSettings& settings,
+    ProgressCounters& counters)
+{
+    const int32_t numCandidates = candidates.size();
+    std::vector<ConfirmedDuplicate> results(numCandidates);
+    std::unordered_set<int32_t> chunkSeqIds;
+    int64_t chunkBases = 0;
+    int32_t chunkStart = 0;
+    for (int32_t i = 0; i < numCandidates; ++i) {
+        const int32_t idA = candidates[i].first;
+        const int32_t idB = candidates[i].second;
+        const auto NewBases = [&]() {
+            int64_t ret = 0;
+            if (chunkSeqIds.count(idA) == 0) {
+                ret += seqDBCache.GetSeqLine(idA).numBases;
+            }
+            if (idB != idA && chunkSeqIds.count(idB) == 0) {
+                ret += seqDBCache.GetSeqLine(idB).numBases;
+            }
+            return ret;
+        };
+        if (i > chunkStart && (chunkBases + NewBases()) > settings.BufferSize) {
+            ConfirmCandidateChunk(reader, candidates, chunkStart, i, settings, results, counters);
+            chunkSeqIds.clear();
+            chunkBases = 0;
+            chunkStart = i;
+        }
+        chunkBases += NewBases();
+        chunkSeqIds.emplace(idA);
+        chunkSeqIds.emplace(idB);
+    }
+    if (chunkStart < numCandidates) {
+        ConfirmCandidateChunk(reader, candidates, chunkStart, numCandidates, settings, results,
+                              counters);
+    }
+
+    return results;
+}
+
+int DedupWorkflow::Runner(const PacBio::CLI_v2::Results& options)
+{
+    DedupSettings settings{options};
+
+    std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> seqDBCache =
+        PacBio::Pancake::LoadSeqDBIndexCache(settings.InputFile);
+    PacBio::Pancake::SeqDBReaderCachedBlock reader(seqDBCache, false);
+
+    const int32_t numReads = seqDBCache->seqLines.size();
+    const int32_t numThreads = std::max<int32_t>(1, settings.NumThreads);
+
+    ProgressReporter progress("dedup", settings.ProgressInterval, settings.ProgressJSON);
+    int64_t totalBases = 0;
+    for (const auto& blockLine : seqDBCache->blockLines) {
+        totalBases += blockLine.numBases;
+    }
+    progress.SetTotals(numReads, totalBases);
+    progress.Start();
+
+    // Fingerprint all reads, one block at a time.
+    TicToc ttFingerprint;
+    std::vector<ReadFingerprint> fingerprints(numReads);
+    for (int32_t blockId = 0; blockId < static_cast<int32_t>(seqDBCache->blockLines.size());
+         ++blockId) {
+        reader.LoadBlocks({blockId});
+        const int32_t numRecords = reader.records().size();
+        const int32_t chunkSize = (numRecords + numThreads - 1) / numThreads;
+        PacBio::Parallel::FireAndForget faf(numThreads);
+        for (int32_t start = 0; start < numRecords; start += chunkSize) {
+            const int32_t end = std::min(numRecords, start + chunkSize);
+            faf.ProduceWith(FingerprintWorker, std::cref(reader.records()), std::cref(settings),
+                            start, end, std::ref(fingerprints), std::ref(progress.Counters()));
+        }
+        faf.Finalize();
+    }
+    ttFingerprint.Stop();
+    PBLOG_INFO << "Computed the fingerprints of " << numReads << " reads in "
+               << ttFingerprint.GetSecs() << " sec.";
+
+    DuplicateGroups groups(numReads);
+    int64_t numExact = 0;
+    int64_t numNear = 0;
+
+    // Exact duplicates on either strand. The alignment guards against hash collisions.
+    const std::vector<std::pair<int32_t, int32_t>> exactCandidates =
+        FindExactDuplicateCandidates(fingerprints);
+    for (const auto& dup :
+         ConfirmCandidates(*seqDBCache, reader, exactCandidates, settings, progress.Counters())) {
+        if (dup.diffs >= 0) {
+            groups.Join(dup.idA, dup.idB);
+            ++numExact;
+        }
+    }
+
+    // Near duplicates, between one read of each group of exact duplicates.
+    std::vector<int32_t> readIds;
+    for (int32_t i = 0; i < numReads; ++i) {
+        if (groups.Find(i) == i) {
+            readIds.emplace_back(i);
+        }
+    }
+    const std::vector<std::pair<int32_t, int32_t>> nearCandidates =
+        FindNearDuplicateCandidates(fingerprints, readIds, settings.MinLengthRatio,
+                                    settings.MinJaccard, settings.SketchSize);
+    for (const auto& dup :
+         ConfirmCandidates(*seqDBCache, reader, nearCandidates, settings, progress.Counters())) {
+        if (dup.diffs >= 0) {
+            groups.Join(dup.idA, dup.idB);
+            ++numNear;
+        }
+    }
+    PBLOG_INFO << "Confirmed " << numExact << " of " << exactCandidates.size()
+               << " exact duplicate candidates, and " << numNear << " of "
+               << nearCandidates.size() << " near duplicate candidates.";
+
+    progress.Stop();
+
+    const std::vector<int32_t> representatives = groups.Representatives(fingerprints);
+
+    std::ofstream ofs(settings.OutputFile);
+    if (ofs.is_open() == false) {
+        throw std::runtime_error("Could not open output file '" + settings.OutputFile + "'!");
+    }
+    int32_t numKept = 0;
+    for (int32_t i = 0; i < numReads; ++i) {
+        const bool isKept = representatives[i] == i;
+        numKept += isKept;
+        if (isKept != settings.Blacklist) {
+            ofs << seqDBCache->seqLines[i].header << '\n';
+        }
+    }
+
+    if (settings.GroupsFile.empty() == false) {
+        std::ofstream ofsGroups(settings.GroupsFile);
+        if (ofsGroups.is_open() == false) {
+            throw std::runtime_error("Could not open output file '" + settings.GroupsFile + "'!");
+        }
+        for (int32_t i = 0; i < numReads; ++i) {
+            if (representatives[i] != i) {
+                ofsGroups << seqDBCache->seqLines[representatives[i]].header << '\t'
+                          << seqDBCache->seqLines[i].header << '\n';
+            }
+        }
+    }
+
+    PBLOG_INFO << "Kept " << numKept << " of " << numReads << " reads, in "
+               << (numReads - numKept) << " duplicates.";
+
+    return EXIT_SUCCESS;
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
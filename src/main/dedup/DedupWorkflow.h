@@ -0,0 +1,19 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_DEDUP_WORKFLOW_H
+#define PANCAKE_DEDUP_WORKFLOW_H
+
+#include <pbcopper/cli2/CLI.h>
+
+namespace PacBio {
+namespace Pancake {
+
+struct DedupWorkflow
+{
+    static int Runner(const PacBio::CLI_v2::Results& options);
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_DEDUP_WORKFLOW_H
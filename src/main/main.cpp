@@ -11,6 +11,10 @@
 #include <pacbio/overlaphifi/OverlapHifiSettings.h>
 #include "dbfilter/DBFilterSettings.h"
 #include "dbfilter/DBFilterWorkflow.h"
+#include "dedup/DedupSettings.h"
+#include "dedup/DedupWorkflow.h"
+#include "ovlmerge/OverlapMergeSettings.h"
+#include "ovlmerge/OverlapMergeWorkflow.h"
 #include "overlaphifi/OverlapHifiWorkflow.h"
 #include "seeddb/SeedDBSettings.h"
 #include "seeddb/SeedDBWorkflow.h"
@@ -18,6 +22,8 @@
 #include "seqdb/SeqDBWorkflow.h"
 #include "seqfetch/SeqFetchSettings.h"
 #include "seqfetch/SeqFetchWorkflow.h"
+#include "verify/VerifySettings.h"
+#include "verify/VerifyWorkflow.h"
 
 PacBio::CLI_v2::MultiToolInterface CreateMultiInterface()
 {
@@ -36,12 +42,21 @@ PacBio::CLI_v2::MultiToolInterface CreateMultiInterface()
         {"ovl-hifi",
             PacBio::Pancake::OverlapHifiSettings::CreateCLI(),
            &PacBio::Pancake::OverlapHifiWorkflow::Runner},
+        {"ovl-merge",
+            PacBio::Pancake::OverlapMergeSettings::CreateCLI(),
+           &PacBio::Pancake::OverlapMergeWorkflow::Runner},
         {"dbfilter",
             PacBio::Pancake::DBFilterSettings::CreateCLI(),
            &PacBio::Pancake::DBFilterWorkflow::Runner},
+        {"dedup",
+            PacBio::Pancake::DedupSettings::CreateCLI(),
+           &PacBio::Pancake::DedupWorkflow::Runner},
         {"seqfetch",
             PacBio::Pancake::SeqFetchSettings::CreateCLI(),
            &PacBio::Pancake::SeqFetchWorkflow::Runner},
+        {"verify",
+            PacBio::Pancake::VerifySettings::CreateCLI(),
+           &PacBio::Pancake::VerifyWorkflow::Runner},
     });
 
     // clang-format on
@@ -12,13 +12,13 @@ namespace OptionNames {
 const CLI_v2::PositionalArgument TargetDBPrefix {
 R"({
     "name" : "target_prefix",
-    "description" : "Prefix of the target SeqDB and SeedDB files. It should match."
+    "description" : "Prefix of the target SeqDB and SeedDB files. It should match. The SeedDB is not needed with --compute-target-seeds."
 })"};
 
 const CLI_v2::PositionalArgument QueryDBPrefix {
 R"({
     "name" : "query_prefix",
-    "description" : "Prefix of the query SeqDB and SeedDB files. It should match."
+    "description" : "Prefix of the query SeqDB and SeedDB files. It should match. The SeedDB is not needed with --compute-query-seeds."
 })"};
 
 const CLI_v2::PositionalArgument TargetBlockId {
@@ -109,6 +109,13 @@ R"({
     "type" : "int"
 })", OverlapHifiSettings::Defaults::ChainBandwidth};
 
+const CLI_v2::Option AnchorMergeMaxGap{
+R"({
+    "names" : ["anchor-merge-gap"],
+    "description" : "Merge the colinear anchors of a target which are split by a large indel, if they are at most this far apart in both the query and the target. The alignment goes through the indel, which is excluded from the identity and reported with the LI, LQ and LT tags in the PAF output. Value 0 disables the merging.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::AnchorMergeMaxGap};
+
 const CLI_v2::Option AlignmentBandwidth{
 R"({
     "names" : ["aln-bw"],
@@ -123,6 +130,13 @@ R"({
     "type" : "double"
 })", OverlapHifiSettings::Defaults::AlignmentMaxD};
 
+const CLI_v2::Option AlignmentMaxWidenings{
+R"({
+    "names" : ["aln-max-widenings"],
+    "description" : "Maximum number of times the alignment bandwidth and diff budget are doubled when the alignment of a flank runs out of either. The alignment resumes from where it stopped instead of starting over. Value 0 disables the widening.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::AlignmentMaxWidenings};
+
 const CLI_v2::Option MinIdentity{
 R"({
     "names" : ["min-idt"],
@@ -219,12 +233,26 @@ R"({
     "type" : "int"
 })", OverlapHifiSettings::Defaults::BestN};
 
+const CLI_v2::Option BestNPerEnd{
+R"({
+    "names" : ["bestn-per-end"],
+    "description" : "Output only best N alignments for each end of the query: N for the 5' dovetails, N for the 3' dovetails, N containments and N internal overlaps. The candidates are aligned in the order of their best possible score, and the alignment stops early once the best N are known. Can be combined with '--bestn'.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::BestNPerEnd};
+
 const CLI_v2::Option UseHPC{
 R"({
     "names" : ["use-hpc"],
     "description" : "Enable homopolymer compression."
 })", OverlapHifiSettings::Defaults::UseHPC};
 
+const CLI_v2::Option HPCRawCoords{
+R"({
+    "names" : ["hpc-raw-coords"],
+    "description" : "With '--use-hpc', lift the overlap coordinates, lengths, CIGAR strings and variant strings back to the raw (uncompressed) sequences before writing. The identity and the score remain as computed on the compressed sequences. Not supported with the SAM output format.",
+    "type" : "bool"
+})", OverlapHifiSettings::Defaults::HPCRawCoords};
+
 const CLI_v2::Option UseTraceback{
 R"({
     "names" : ["traceback"],
@@ -309,6 +337,206 @@ R"({
     "type" : "bool"
 })", OverlapHifiSettings::Defaults::TrimToFirstMatch};
 
+const CLI_v2::Option AlignmentPiecewise{
+R"({
+    "names" : ["aln-piecewise"],
+    "description" : "Align the overlaps piecewise, between the chained seed hits, instead of using a single alignment over the entire overlap. Bounds the alignment memory for long overlaps.",
+    "type" : "bool"
+})", OverlapHifiSettings::Defaults::AlignmentPiecewise};
+
+const CLI_v2::Option AlignmentPiecewiseMinSpan{
+R"({
+    "names" : ["aln-piecewise-min-span"],
+    "description" : "Minimum distance between two seed hits used as boundaries of piecewise alignment. Closer hits are skipped.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::AlignmentPiecewiseMinSpan};
+
+const CLI_v2::Option EndSeedDistance{
+R"({
+    "names" : ["end-seed-dist"],
+    "description" : "End-anchored mode for assembly. If > 0, only the target seeds within this distance from either end of a target are indexed. A symmetric pass over the query ends then finds the queries contained in targets. Only overlaps which cover an end of a read are found. Value 0 indexes all seeds.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::EndSeedDistance};
+
+const CLI_v2::Option MinimizerSpace{
+R"({
+    "names" : ["min-space"],
+    "description" : "Experimental. Find the overlaps in minimizer space, by merging the minimizer strings of the reads instead of chaining the seed hits. The overlaps are not aligned, and the identity is estimated from the fraction of shared minimizers. Much faster, but less sensitive for lower quality reads.",
+    "type" : "bool"
+})", OverlapHifiSettings::Defaults::MinimizerSpace};
+
+const CLI_v2::Option SeedIndexHash{
+R"({
+    "names" : ["seed-index"],
+    "choices" : ["flat-hash-map", "perfect-hash"],
+    "type" : "string",
+    "default" : "flat-hash-map",
+    "description" : "Hash used to index the target seeds. The perfect-hash uses several times less memory for large target blocks, but it is slower to build and to query."
+})", std::string("flat-hash-map")};
+
+const CLI_v2::Option MinimizerSpaceK{
+R"({
+    "names" : ["min-space-k"],
+    "description" : "Number of consecutive minimizers used to look up the candidate overlaps in the minimizer-space mode.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::MinimizerSpaceK};
+
+const CLI_v2::Option MinimizerSpaceMaxSkip{
+R"({
+    "names" : ["min-space-max-skip"],
+    "description" : "Maximum number of consecutive minimizers which can be skipped on either read when merging the minimizer strings, e.g. because of a sequencing error.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::MinimizerSpaceMaxSkip};
+
+const CLI_v2::Option PairsPath{
+R"({
+    "names" : ["pairs"],
+    "description" : "Align only the query-target pairs listed in this file ('-' for stdin), instead of searching for overlaps with a seed index. Each line contains the query, the target and optionally the strand ('+' or '-'), separated by whitespace. Pairs outside of the target block and the query blocks are ignored.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option PairsUseIds{
+R"({
+    "names" : ["pairs-use-ids"],
+    "description" : "The pair list specifies the numeric sequence IDs instead of the names.",
+    "type" : "bool"
+})", OverlapHifiSettings::Defaults::PairsUseIds};
+
+const CLI_v2::Option ComputeQuerySeeds{
+R"({
+    "names" : ["compute-query-seeds"],
+    "description" : "Compute the query seeds from the query sequences while mapping, instead of loading them from the query SeedDB.",
+    "type" : "bool"
+})", OverlapHifiSettings::Defaults::ComputeQuerySeeds};
+
+const CLI_v2::Option ComputeTargetSeeds{
+R"({
+    "names" : ["compute-target-seeds"],
+    "description" : "Compute the target seeds from the target sequences, instead of loading them from the target SeedDB.",
+    "type" : "bool"
+})", OverlapHifiSettings::Defaults::ComputeTargetSeeds};
+
+const CLI_v2::Option SeedParams{
+R"({
+    "names" : ["seed-params"],
+    "description" : "Seeding parameters for the computed seeds, in the format of the SeedDB index, e.g. 'k=28,w=80,s=0,hpc=0,hpc_len=10,rc=1'. By default, the parameters of the SeedDB of the other side are used. Required if both the query and the target seeds are computed.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option Palindromes{
+R"({
+    "names" : ["palindromes"],
+    "choices" : ["none", "report", "skip", "trim"],
+    "type" : "string",
+    "default" : "none",
+    "description" : "Detect the query reads which align to their own reverse complement, e.g. the reads with a missed adapter, by mapping the seeds of each read onto themselves. Report only logs and lists them, skip does not map them, and trim maps only the longer side of the fold."
+})", std::string("none")};
+
+const CLI_v2::Option PalindromeMinArmSpan{
+R"({
+    "names" : ["palindrome-min-arm"],
+    "description" : "Minimum span of the self-aligned arm of a read to detect it as a palindrome.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::PalindromeMinArmSpan};
+
+const CLI_v2::Option PalindromeListPath{
+R"({
+    "names" : ["palindrome-list"],
+    "description" : "Write the names of the detected palindromic reads to this file, one per line. The file can be used as the '--filter-list' of the dbfilter.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option CorrectOutPrefix{
+R"({
+    "names" : ["correct"],
+    "description" : "Error-correct the query reads using the pileups of their overlaps, and write the corrected reads to a SeqDB with this prefix. Requires '--traceback'. Only the overlaps with the target block of this run are used, so the target DB must consist of a single block, and '--skip-sym' cannot be used because it drops the overlaps with the higher-ID targets. The '--bestn' limits the number of reads in each pileup.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option CorrectMinCoverage{
+R"({
+    "names" : ["correct-min-cov"],
+    "description" : "Minimum number of reads covering a homopolymer run of the query, including the query itself, for the run to be corrected.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::CorrectMinCoverage};
+
+const CLI_v2::Option CorrectMinHetSupport{
+R"({
+    "names" : ["correct-min-het-support"],
+    "description" : "Keep the query's own version of a homopolymer run if at least this many other reads support it, as a heterozygous variant.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::CorrectMinHetSupport};
+
+const CLI_v2::Option CorrectMinHetFraction{
+R"({
+    "names" : ["correct-min-het-frac"],
+    "description" : "Keep the query's own version of a homopolymer run only if it is supported by at least this fraction of the other reads covering the run.",
+    "type" : "double"
+})", OverlapHifiSettings::Defaults::CorrectMinHetFraction};
+
+const CLI_v2::Option SVBedpePath{
+R"({
+    "names" : ["sv-bedpe"],
+    "description" : "Write the structural variant evidence of each query to this file in the BEDPE format: the junctions between its primary and supplementary mappings, realigned at the base level, and the large indels within the alignments. Requires '--mark-secondary'. Only the mappings to the target block of this run are used, so the target DB must consist of a single block.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option SVMinLength{
+R"({
+    "names" : ["sv-min-len"],
+    "description" : "Minimum length of an indel, or of the difference between the target and the query gaps of two colinear mappings, to report it as structural variant evidence.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::SVMinLength};
+
+const CLI_v2::Option WriteSATags{
+R"({
+    "names" : ["write-sa-tags"],
+    "description" : "Write the SA tag to the primary and supplementary SAM records of a split query, and set the secondary and supplementary flags. Requires '--mark-secondary' and the SAM output format. Only the mappings to the target block of this run are listed, so the target DB must consist of a single block.",
+    "type" : "bool"
+})", OverlapHifiSettings::Defaults::WriteSATags};
+
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed queries and bases, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", OverlapHifiSettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option WorkDir{
+R"({
+    "names" : ["work-dir"],
+    "description" : "Run as one of the workers which share the overlapping of the whole DBs through this directory, instead of mapping the given blocks. The block positional arguments are ignored. The first worker writes the plan of the tasks, and each task's overlaps are written to the 'out' subfolder.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option WorkLease{
+R"({
+    "names" : ["work-lease"],
+    "description" : "Number of seconds without a heartbeat after which a claimed task is considered abandoned and can be claimed by another worker. Should be much larger than the clock skew between the hosts.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::WorkLease};
+
+const CLI_v2::Option WorkQueryBlocks{
+R"({
+    "names" : ["work-query-blocks"],
+    "description" : "Number of query blocks per task.",
+    "type" : "int"
+})", OverlapHifiSettings::Defaults::WorkQueryBlocks};
+
 // clang-format on
 
 }  // namespace OptionNames
@@ -345,8 +573,10 @@ OverlapHifiSettings::OverlapHifiSettings(const PacBio::CLI_v2::Results& options)
     , MinCoveredBases{options[OptionNames::MinCoveredBases]}
     , MinChainSpan{options[OptionNames::MinChainSpan]}
     , ChainBandwidth{options[OptionNames::ChainBandwidth]}
+    , AnchorMergeMaxGap{options[OptionNames::AnchorMergeMaxGap]}
     , AlignmentBandwidth{options[OptionNames::AlignmentBandwidth]}
     , AlignmentMaxD{options[OptionNames::AlignmentMaxD]}
+    , AlignmentMaxWidenings{options[OptionNames::AlignmentMaxWidenings]}
     , MinIdentity{options[OptionNames::MinIdentity]}
     , NoSNPsInIdentity{options[OptionNames::NoSNPsInIdentity]}
     , NoIndelsInIdentity{options[OptionNames::NoIndelsInIdentity]}
@@ -359,7 +589,9 @@ OverlapHifiSettings::OverlapHifiSettings(const PacBio::CLI_v2::Results& options)
     , AllowedHeuristicExtendDist{options[OptionNames::AllowedHeuristicExtendDist]}
     , CombineBlocks{options[OptionNames::CombineBlocks]}
     , BestN{options[OptionNames::BestN]}
+    , BestNPerEnd{options[OptionNames::BestNPerEnd]}
     , UseHPC{options[OptionNames::UseHPC]}
+    , HPCRawCoords{options[OptionNames::HPCRawCoords]}
     , UseTraceback{options[OptionNames::UseTraceback]}
     , MaskHomopolymers{options[OptionNames::MaskHomopolymers]}
     , MaskSimpleRepeats{options[OptionNames::MaskSimpleRepeats]}
@@ -372,6 +604,31 @@ OverlapHifiSettings::OverlapHifiSettings(const PacBio::CLI_v2::Results& options)
     , TrimWindowSize{options[OptionNames::TrimWindowSize]}
     , TrimWindowMatchFraction{options[OptionNames::TrimWindowMatchFraction]}
     , TrimToFirstMatch{options[OptionNames::TrimToFirstMatch]}
+    , AlignmentPiecewise{options[OptionNames::AlignmentPiecewise]}
+    , AlignmentPiecewiseMinSpan{options[OptionNames::AlignmentPiecewiseMinSpan]}
+    , EndSeedDistance{options[OptionNames::EndSeedDistance]}
+    , MinimizerSpace{options[OptionNames::MinimizerSpace]}
+    , MinimizerSpaceK{options[OptionNames::MinimizerSpaceK]}
+    , MinimizerSpaceMaxSkip{options[OptionNames::MinimizerSpaceMaxSkip]}
+    , PairsPath{options[OptionNames::PairsPath]}
+    , PairsUseIds{options[OptionNames::PairsUseIds]}
+    , ComputeQuerySeeds{options[OptionNames::ComputeQuerySeeds]}
+    , ComputeTargetSeeds{options[OptionNames::ComputeTargetSeeds]}
+    , SeedParams{options[OptionNames::SeedParams]}
+    , PalindromeMinArmSpan{options[OptionNames::PalindromeMinArmSpan]}
+    , PalindromeListPath{options[OptionNames::PalindromeListPath]}
+    , CorrectOutPrefix{options[OptionNames::CorrectOutPrefix]}
+    , CorrectMinCoverage{options[OptionNames::CorrectMinCoverage]}
+    , CorrectMinHetSupport{options[OptionNames::CorrectMinHetSupport]}
+    , CorrectMinHetFraction{options[OptionNames::CorrectMinHetFraction]}
+    , SVBedpePath{options[OptionNames::SVBedpePath]}
+    , SVMinLength{options[OptionNames::SVMinLength]}
+    , WriteSATags{options[OptionNames::WriteSATags]}
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
+    , WorkDir{options[OptionNames::WorkDir]}
+    , WorkLease{options[OptionNames::WorkLease]}
+    , WorkQueryBlocks{options[OptionNames::WorkQueryBlocks]}
 {
     if ((NoSNPsInIdentity || NoIndelsInIdentity || MaskHomopolymers || MaskSimpleRepeats ||
          MaskHomopolymerSNPs || MaskHomopolymersArbitrary) &&
@@ -398,6 +655,17 @@ OverlapHifiSettings::OverlapHifiSettings(const PacBio::CLI_v2::Results& options)
         throw std::runtime_error("Unknown output format: '" +
                                  std::string(options[OptionNames::OutFormat]) + "'.");
     }
+    if (HPCRawCoords == true && UseHPC == false) {
+        throw std::runtime_error("Option '--hpc-raw-coords' can only be used together with "
+                                 "'--use-hpc'.");
+    }
+    if (HPCRawCoords == true && OutFormat == OverlapWriterFormat::SAM) {
+        throw std::runtime_error(
+            "Option '--hpc-raw-coords' is not supported with the SAM output format.");
+    }
+
+    SeedIndexHash = SeedIndexHashTypeFromString(options[OptionNames::SeedIndexHash]);
+    Palindromes = PalindromeActionFromString(options[OptionNames::Palindromes]);
 
     SkipSelfHits = false;
     if (static_cast<bool>(options[OptionNames::AllowSelfHits]) == false &&
@@ -415,6 +683,118 @@ OverlapHifiSettings::OverlapHifiSettings(const PacBio::CLI_v2::Results& options)
         throw std::runtime_error(
             "The '--trim-to-first-match' option can only be used when '--trim' is specified.");
     }
+    if (AlignmentMaxWidenings < 0) {
+        throw std::runtime_error("The '--aln-max-widenings' value should be >= 0.");
+    }
+    if (AlignmentPiecewiseMinSpan < 0) {
+        throw std::runtime_error("The '--aln-piecewise-min-span' value should be >= 0.");
+    }
+    if (EndSeedDistance < 0) {
+        throw std::runtime_error("The '--end-seed-dist' value should be >= 0.");
+    }
+    if (EndSeedDistance > 0 && EndSeedDistance < MinChainSpan) {
+        throw std::runtime_error(
+            "The '--end-seed-dist' value should be >= '--min-anchor-span', otherwise anchors "
+            "cannot be formed from the seeds near the ends of the reads.");
+    }
+    if (AnchorMergeMaxGap < 0) {
+        throw std::runtime_error("The '--anchor-merge-gap' value should be >= 0.");
+    }
+    if (AnchorMergeMaxGap > 0 && MinimizerSpace) {
+        throw std::runtime_error(
+            "The '--anchor-merge-gap' option cannot be used together with '--min-space'.");
+    }
+    if (MinimizerSpaceK <= 0) {
+        throw std::runtime_error("The '--min-space-k' value should be > 0.");
+    }
+    if (MinimizerSpaceMaxSkip < 0) {
+        throw std::runtime_error("The '--min-space-max-skip' value should be >= 0.");
+    }
+    if (MinimizerSpace && EndSeedDistance > 0) {
+        throw std::runtime_error(
+            "The '--min-space' option cannot be used together with '--end-seed-dist'.");
+    }
+    if (PairsPath.empty() == false && (MinimizerSpace || EndSeedDistance > 0)) {
+        throw std::runtime_error(
+            "The '--pairs' option cannot be used together with '--min-space' or "
+            "'--end-seed-dist'.");
+    }
+    if (SeedIndexHash != SeedIndexHashType::FlatHashMap &&
+        (MinimizerSpace || PairsPath.empty() == false)) {
+        throw std::runtime_error(
+            "The '--seed-index' option cannot be used together with '--min-space' or '--pairs'.");
+    }
+    if (PalindromeMinArmSpan < 0) {
+        throw std::runtime_error("The '--palindrome-min-arm' value should be >= 0.");
+    }
+    if (PalindromeListPath.empty() == false && Palindromes == PalindromeAction::None) {
+        throw std::runtime_error(
+            "The '--palindrome-list' option can only be used together with '--palindromes'.");
+    }
+    if (PairsPath.empty() && PairsUseIds) {
+        throw std::runtime_error("The '--pairs-use-ids' option can only be used with '--pairs'.");
+    }
+    if (SeedParams.empty() == false && ComputeQuerySeeds == false && ComputeTargetSeeds == false) {
+        throw std::runtime_error(
+            "The '--seed-params' option can only be used with '--compute-query-seeds' or "
+            "'--compute-target-seeds'.");
+    }
+    if (SeedParams.empty() && ComputeQuerySeeds && ComputeTargetSeeds) {
+        throw std::runtime_error(
+            "The '--seed-params' option is required when both '--compute-query-seeds' and "
+            "'--compute-target-seeds' are used.");
+    }
+    if (CorrectOutPrefix.empty() == false) {
+        if (UseTraceback == false) {
+            throw std::runtime_error("The '--correct' option requires '--traceback'.");
+        }
+        if (UseHPC) {
+            throw std::runtime_error("The '--correct' option cannot be used with '--use-hpc'.");
+        }
+        if (SkipSymmetricOverlaps) {
+            throw std::runtime_error("The '--correct' option cannot be used with '--skip-sym'.");
+        }
+        if (CorrectMinCoverage < 1) {
+            throw std::runtime_error("The '--correct-min-cov' value should be >= 1.");
+        }
+        if (CorrectMinHetFraction < 0.0 || CorrectMinHetFraction > 1.0) {
+            throw std::runtime_error("The '--correct-min-het-frac' value should be in [0.0, 1.0].");
+        }
+    }
+    if (SVBedpePath.empty() == false || WriteSATags) {
+        if (MarkSecondary == false) {
+            throw std::runtime_error(
+                "The '--sv-bedpe' and '--write-sa-tags' options require '--mark-secondary'.");
+        }
+        if (UseHPC) {
+            throw std::runtime_error(
+                "The '--sv-bedpe' and '--write-sa-tags' options cannot be used with '--use-hpc'.");
+        }
+    }
+    if (WriteSATags && OutFormat != OverlapWriterFormat::SAM) {
+        throw std::runtime_error("The '--write-sa-tags' option requires '--out-fmt sam'.");
+    }
+    if (SVMinLength < 1) {
+        throw std::runtime_error("The '--sv-min-len' value should be >= 1.");
+    }
+    if (WorkDir.empty() == false) {
+        if (WorkLease <= 0) {
+            throw std::runtime_error("The '--work-lease' value should be > 0.");
+        }
+        if (WorkQueryBlocks <= 0) {
+            throw std::runtime_error("The '--work-query-blocks' value should be > 0.");
+        }
+        if (CorrectOutPrefix.empty() == false || PalindromeListPath.empty() == false ||
+            ProgressJSON.empty() == false || SVBedpePath.empty() == false) {
+            throw std::runtime_error(
+                "The '--work-dir' option cannot be used together with '--correct', "
+                "'--palindrome-list', '--progress-json' or '--sv-bedpe'.");
+        }
+        if (PairsPath == "-") {
+            throw std::runtime_error(
+                "The '--work-dir' option cannot be used with the pairs read from stdin.");
+        }
+    }
 }
 
 PacBio::CLI_v2::Interface OverlapHifiSettings::CreateCLI()
@@ -425,6 +805,12 @@ PacBio::CLI_v2::Interface OverlapHifiSettings::CreateCLI()
     // clang-format off
     i.AddOptionGroup("Input/Output Options", {
         OptionNames::OutFormat,
+        OptionNames::PairsPath,
+        OptionNames::PairsUseIds,
+        OptionNames::ComputeQuerySeeds,
+        OptionNames::ComputeTargetSeeds,
+        OptionNames::SeedParams,
+        OptionNames::PalindromeListPath,
     });
     i.AddOptionGroup("Algorithm Options", {
         OptionNames::FreqPercentile,
@@ -435,8 +821,10 @@ PacBio::CLI_v2::Interface OverlapHifiSettings::CreateCLI()
         OptionNames::MinCoveredBases,
         OptionNames::MinChainSpan,
         OptionNames::ChainBandwidth,
+        OptionNames::AnchorMergeMaxGap,
         OptionNames::AlignmentBandwidth,
         OptionNames::AlignmentMaxD,
+        OptionNames::AlignmentMaxWidenings,
         OptionNames::MinIdentity,
         OptionNames::NoSNPsInIdentity,
         OptionNames::NoIndelsInIdentity,
@@ -451,7 +839,9 @@ PacBio::CLI_v2::Interface OverlapHifiSettings::CreateCLI()
         OptionNames::AllowedHeuristicExtendDist,
         OptionNames::CombineBlocks,
         OptionNames::BestN,
+        OptionNames::BestNPerEnd,
         OptionNames::UseHPC,
+        OptionNames::HPCRawCoords,
         OptionNames::UseTraceback,
         OptionNames::MaskHomopolymers,
         OptionNames::MaskSimpleRepeats,
@@ -464,6 +854,35 @@ PacBio::CLI_v2::Interface OverlapHifiSettings::CreateCLI()
         OptionNames::TrimWindowSize,
         OptionNames::TrimWindowMatchFraction,
         OptionNames::TrimToFirstMatch,
+        OptionNames::AlignmentPiecewise,
+        OptionNames::AlignmentPiecewiseMinSpan,
+        OptionNames::EndSeedDistance,
+        OptionNames::SeedIndexHash,
+        OptionNames::MinimizerSpace,
+        OptionNames::MinimizerSpaceK,
+        OptionNames::MinimizerSpaceMaxSkip,
+        OptionNames::Palindromes,
+        OptionNames::PalindromeMinArmSpan,
+    });
+    i.AddOptionGroup("Correction Options", {
+        OptionNames::CorrectOutPrefix,
+        OptionNames::CorrectMinCoverage,
+        OptionNames::CorrectMinHetSupport,
+        OptionNames::CorrectMinHetFraction,
+    });
+    i.AddOptionGroup("Structural Variant Evidence Options", {
+        OptionNames::SVBedpePath,
+        OptionNames::SVMinLength,
+        OptionNames::WriteSATags,
+    });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
+    });
+    i.AddOptionGroup("Work Queue Options", {
+        OptionNames::WorkDir,
+        OptionNames::WorkLease,
+        OptionNames::WorkQueryBlocks,
     });
     i.AddPositionalArguments({
         OptionNames::TargetDBPrefix,
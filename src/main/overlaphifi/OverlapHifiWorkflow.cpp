@@ -2,8 +2,17 @@
 
 #include "OverlapHifiWorkflow.h"
 #include <pacbio/overlaphifi/OverlapHifiSettings.h>
+#include <pacbio/pancake/Breakpoint.h>
+#include <pacbio/pancake/CandidatePairs.h>
+#include <pacbio/pancake/Circular.h>
+#include <pacbio/pancake/HPCCoordinateMap.h>
 #include <pacbio/pancake/MapperHiFi.h>
+#include <pacbio/pancake/MinimizerSpaceIndex.h>
+#include <pacbio/pancake/Minimizers.h>
+#include <pacbio/pancake/OverlapTaskQueue.h>
 #include <pacbio/pancake/OverlapWriterFactory.h>
+#include <pacbio/pancake/Palindrome.h>
+#include <pacbio/pancake/ReadCorrection.h>
 #include <pacbio/pancake/Seed.h>
 #include <pacbio/pancake/SeedDBIndexCache.h>
 #include <pacbio/pancake/SeedDBReaderCachedBlock.h>
@@ -11,23 +20,215 @@
 #include <pacbio/pancake/SeedIndex.h>
 #include <pacbio/pancake/SeqDBIndexCache.h>
 #include <pacbio/pancake/SeqDBReaderCached.h>
+#include <pacbio/pancake/SeqDBWriter.h>
+#include <pacbio/util/Progress.h>
 #include <pacbio/util/TicToc.h>
 #include <pbcopper/logging/LogLevel.h>
 #include <pbcopper/logging/Logging.h>
 #include <pbcopper/parallel/FireAndForget.h>
 #include <pbcopper/parallel/WorkQueue.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace PacBio {
 namespace Pancake {
 
+/*
+ * Stands in for the seed index in the pair-list mode. Instead of looking up the seeds, the query
+ * is mapped only to the targets listed for it in the pairs, which are sorted by the query ID.
+ * The target seeds are sorted once when the index is built.
+*/
+class CandidatePairIndex
+{
+public:
+    PacBio::Pancake::SortedSequenceSeeds targetSeeds;
+    std::vector<int32_t> targetLengths;
+    int32_t kmerSize = 0;
+    const std::vector<CandidatePair>& pairs;
+};
+
+OverlapHiFi::MapperResult MapQuery(const OverlapHiFi::Mapper& mapper,
+                                   const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
+                                   const PacBio::Pancake::SeedIndex& index,
+                                   const PacBio::Pancake::FastaSequenceCached& querySeq,
+                                   const PacBio::Pancake::SequenceSeedsCached& querySeeds,
+                                   int64_t freqCutoff, bool generateFlippedOverlaps)
+{
+    return mapper.Map(targetSeqDBReader, index, querySeq, querySeeds, freqCutoff,
+                      generateFlippedOverlaps);
+}
+
+OverlapHiFi::MapperResult MapQuery(const OverlapHiFi::Mapper& mapper,
+                                   const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
+                                   const PacBio::Pancake::MinimizerSpaceIndex& index,
+                                   const PacBio::Pancake::FastaSequenceCached& querySeq,
+                                   const PacBio::Pancake::SequenceSeedsCached& querySeeds,
+                                   int64_t freqCutoff, bool generateFlippedOverlaps)
+{
+    return mapper.Map(targetSeqDBReader, index, querySeq, querySeeds, freqCutoff,
+                      generateFlippedOverlaps);
+}
+
+OverlapHiFi::MapperResult MapQuery(const OverlapHiFi::Mapper& mapper,
+                                   const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
+                                   const CandidatePairIndex& index,
+                                   const PacBio::Pancake::FastaSequenceCached& querySeq,
+                                   const PacBio::Pancake::SequenceSeedsCached& querySeeds,
+                                   int64_t freqCutoff, bool generateFlippedOverlaps)
+{
+    CandidatePair key;
+    key.queryId = querySeq.Id();
+    const auto range =
+        std::equal_range(index.pairs.begin(), index.pairs.end(), key,
+                         [](const auto& a, const auto& b) { return a.queryId < b.queryId; });
+    // The candidates are passed as a range within the pair list, to avoid copying them.
+    const CandidatePair* candidates = index.pairs.data() + (range.first - index.pairs.begin());
+    const int64_t numCandidates = range.second - range.first;
+    return mapper.MapCandidates(targetSeqDBReader, index.targetSeeds, index.targetLengths,
+                                index.kmerSize, querySeq, querySeeds, candidates, numCandidates,
+                                freqCutoff, generateFlippedOverlaps);
+}
+
+/*
+ * Seeds of the query sequences. If the cached seeds are not given, the seeds of each query
+ * are computed by the worker which maps it.
+*/
+class QuerySeedSource
+{
+public:
+    const PacBio::Pancake::SeedDBReaderCachedBlock* cachedSeeds = nullptr;
+    PacBio::Pancake::SeedDB::SeedDBParameters seedParams;
+};
+
+void GenerateSequenceSeeds(const PacBio::Pancake::FastaSequenceCached& record,
+                           const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams,
+                           std::vector<PacBio::Pancake::Int128t>& retSeeds)
+{
+    retSeeds.clear();
+    const int rv = GenerateSeeds(retSeeds, reinterpret_cast<const uint8_t*>(record.c_str()),
+                                 record.size(), 0, record.Id(), seedParams);
+    if (rv) {
+        throw std::runtime_error("Generating seeds failed for sequence ID " +
+                                 std::to_string(record.Id()) + ", return code = " +
+                                 std::to_string(rv));
+    }
+}
+
+void SeedingWorker(const std::vector<PacBio::Pancake::FastaSequenceCached>& records,
+                   const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams, int32_t start,
+                   int32_t end, std::vector<std::vector<PacBio::Pancake::Int128t>>& seeds)
+{
+    for (int32_t i = start; i < end; ++i) {
+        GenerateSequenceSeeds(records[i], seedParams, seeds[i]);
+    }
+}
+
+/*
+ * Computes the seeds of all given sequences in parallel, and stores them in the same form
+ * as they would be loaded from a SeedDB.
+*/
+std::unique_ptr<PacBio::Pancake::SeedDBReaderCachedBlock> GenerateSeedsInParallel(
+    const std::vector<PacBio::Pancake::FastaSequenceCached>& records,
+    const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams, size_t numThreads)
+{
+    const int32_t numRecords = records.size();
+    std::vector<std::vector<PacBio::Pancake::Int128t>> seeds(numRecords);
+    const int32_t numJobs = std::max<int32_t>(1, std::min<int32_t>(numThreads, numRecords));
+    const int32_t recordsPerJob = (numRecords + numJobs - 1) / numJobs;
+    PacBio::Parallel::FireAndForget faf(numThreads);
+    for (int32_t start = 0; start < numRecords; start += recordsPerJob) {
+        faf.ProduceWith(SeedingWorker, std::cref(records), std::cref(seedParams), start,
+                        std::min(numRecords, start + recordsPerJob), std::ref(seeds));
+    }
+    faf.Finalize();
+    return std::make_unique<PacBio::Pancake::SeedDBReaderCachedBlock>(records, seeds);
+}
+
+// Keys which occur more often within a read, e.g. in tandem repeats, are not used to detect
+// the palindromes.
+static const int64_t PALINDROME_MAX_SEED_OCCURRENCES = 10;
+
+void PalindromeWorker(const PacBio::Pancake::SeqDBReaderCachedBlock& seqDBReader,
+                      const PacBio::Pancake::SeedDBReaderCachedBlock& seedDBReader,
+                      const OverlapHifiSettings& settings, int32_t start, int32_t end,
+                      std::vector<PalindromeResult>& results)
+{
+    for (int32_t i = start; i < end; ++i) {
+        const auto& record = seqDBReader.records()[i];
+        const auto& seeds = seedDBReader.GetSeedsForSequence(record.Id());
+        results[i] = DetectPalindrome(seeds.Seeds(), seeds.Size(), record.size(),
+                                      settings.MinNumSeeds, settings.PalindromeMinArmSpan,
+                                      settings.MaxSeedDistance, settings.ChainBandwidth,
+                                      PALINDROME_MAX_SEED_OCCURRENCES);
+    }
+}
+
+/*
+ * Detects the palindromic reads in parallel, by mapping each read onto itself.
+ * The results are in the same order as the records of the SeqDB reader.
+*/
+std::vector<PalindromeResult> DetectPalindromesInParallel(
+    const PacBio::Pancake::SeqDBReaderCachedBlock& seqDBReader,
+    const PacBio::Pancake::SeedDBReaderCachedBlock& seedDBReader,
+    const OverlapHifiSettings& settings)
+{
+    const int32_t numRecords = seqDBReader.records().size();
+    std::vector<PalindromeResult> results(numRecords);
+    const int32_t numJobs =
+        std::max<int32_t>(1, std::min<int32_t>(settings.NumThreads, numRecords));
+    const int32_t recordsPerJob = (numRecords + numJobs - 1) / numJobs;
+    PacBio::Parallel::FireAndForget faf(settings.NumThreads);
+    for (int32_t start = 0; start < numRecords; start += recordsPerJob) {
+        faf.ProduceWith(PalindromeWorker, std::cref(seqDBReader), std::cref(seedDBReader),
+                        std::cref(settings), start, std::min(numRecords, start + recordsPerJob),
+                        std::ref(results));
+    }
+    faf.Finalize();
+    return results;
+}
+
+/*
+ * Creates the seeds of the query block without the palindromic reads (skip), or with only the
+ * longer side of their fold (trim).
+*/
+std::unique_ptr<PacBio::Pancake::SeedDBReaderCachedBlock> FilterPalindromeSeeds(
+    const PacBio::Pancake::SeqDBReaderCachedBlock& seqDBReader,
+    const PacBio::Pancake::SeedDBReaderCachedBlock& seedDBReader,
+    const std::vector<PalindromeResult>& palindromes, PalindromeAction action)
+{
+    const auto& records = seqDBReader.records();
+    std::vector<std::vector<PacBio::Pancake::Int128t>> seeds(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        const auto& recordSeeds = seedDBReader.GetSeedsForSequence(records[i].Id());
+        if (palindromes[i].isPalindrome == false) {
+            seeds[i].assign(recordSeeds.Seeds(), recordSeeds.Seeds() + recordSeeds.Size());
+        } else if (action == PalindromeAction::Trim) {
+            CollectSeedsOnLongerArm(recordSeeds.Seeds(), recordSeeds.Size(), records[i].size(),
+                                    palindromes[i], seeds[i]);
+        }
+    }
+    return std::make_unique<PacBio::Pancake::SeedDBReaderCachedBlock>(records, seeds);
+}
+
+template <typename IndexType>
 void Worker(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
-            const PacBio::Pancake::SeedIndex& index,
+            const IndexType& index,
             const PacBio::Pancake::SeqDBReaderCachedBlock& querySeqDBReader,
-            const PacBio::Pancake::SeedDBReaderCachedBlock& querySeedDBReader,
+            const QuerySeedSource& querySeedSource,
             const OverlapHifiSettings& /*settings*/, const OverlapHiFi::Mapper& mapper,
             int64_t freqCutoff, bool generateFlippedOverlaps, int32_t start, int32_t end,
-            std::vector<OverlapHiFi::MapperResult>& results)
+            std::vector<OverlapHiFi::MapperResult>& results, ProgressCounters& counters,
+            bool countQueries)
 {
     int32_t numRecords = querySeqDBReader.records().size();
     if (start < 0 || end < 0 || start > end || start > numRecords || end > numRecords) {
@@ -38,18 +239,440 @@ void Worker(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
     }
 
     // Map the reads.
+    std::vector<PacBio::Pancake::Int128t> computedSeeds;
     for (int32_t i = start; i < end; ++i) {
         const auto& querySeq = querySeqDBReader.records()[i];
-        const auto& querySeeds = querySeedDBReader.GetSeedsForSequence(querySeq.Id());
-        results[i] = mapper.Map(targetSeqDBReader, index, querySeq, querySeeds, freqCutoff,
-                                generateFlippedOverlaps);
+        PacBio::Pancake::SequenceSeedsCached computedQuerySeeds;
+        if (querySeedSource.cachedSeeds == nullptr) {
+            GenerateSequenceSeeds(querySeq, querySeedSource.seedParams, computedSeeds);
+            computedQuerySeeds = PacBio::Pancake::SequenceSeedsCached(
+                querySeq.Name(), computedSeeds.data(), computedSeeds.size(), querySeq.Id());
+        }
+        const auto& querySeeds =
+            (querySeedSource.cachedSeeds == nullptr)
+                ? computedQuerySeeds
+                : querySeedSource.cachedSeeds->GetSeedsForSequence(querySeq.Id());
+        results[i] = MapQuery(mapper, targetSeqDBReader, index, querySeq, querySeeds, freqCutoff,
+                              generateFlippedOverlaps);
+        counters.AddHits(results[i].numHits);
+        counters.AddAlignments(results[i].numAlignments);
+        counters.AddBandWidenings(results[i].numBandWidenings);
+        if (countQueries) {
+            counters.AddQueries(1);
+            counters.AddBases(querySeq.Size());
+        }
     }
 }
 
-int OverlapHifiWorkflow::Runner(const PacBio::CLI_v2::Results& options)
+std::vector<int32_t> GetSequenceLengths(const PacBio::Pancake::SeedDBIndexCache& seedDBCache)
 {
-    OverlapHifiSettings settings{options};
+    std::vector<int32_t> ret(seedDBCache.seedLines.size());
+    for (size_t i = 0; i < seedDBCache.seedLines.size(); ++i) {
+        ret[i] = seedDBCache.seedLines[i].numBases;
+    }
+    return ret;
+}
+
+/*
+ * Lengths of the sequences loaded in the reader (after HP compression, if used), indexed by
+ * the sequence ID. Used instead of the SeedDB when the seeds are computed.
+ * The sequences which are not loaded have length 0.
+*/
+std::vector<int32_t> GetSequenceLengths(const PacBio::Pancake::SeqDBReaderCachedBlock& seqDBReader,
+                                        int32_t numSeqs)
+{
+    std::vector<int32_t> ret(numSeqs, 0);
+    for (const auto& record : seqDBReader.records()) {
+        ret[record.Id()] = record.size();
+    }
+    return ret;
+}
 
+void LogSeedParams(const std::string& label,
+                   const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams)
+{
+    PBLOG_INFO << label << " seed params: k = " << seedParams.KmerSize
+               << ", w = " << seedParams.MinimizerWindow << ", s = " << seedParams.Spacing
+               << ", hpc = " << seedParams.UseHPC << ", rc = " << seedParams.UseRC
+               << ", scheme = " << SeedDB::SeedingSchemeToString(seedParams.Scheme);
+}
+
+template <typename IndexType>
+std::vector<OverlapHiFi::MapperResult> MapInParallel(
+    const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader, const IndexType& index,
+    const PacBio::Pancake::SeqDBReaderCachedBlock& querySeqDBReader,
+    const QuerySeedSource& querySeedSource, const OverlapHifiSettings& settings,
+    const std::vector<OverlapHiFi::Mapper>& mappers,
+    int64_t freqCutoff, bool generateFlippedOverlaps, ProgressCounters& counters,
+    bool countQueries)
+{
+    const int32_t numRecords = static_cast<int32_t>(querySeqDBReader.records().size());
+    // Storage for the results of the batch run.
+    std::vector<OverlapHiFi::MapperResult> results(numRecords);
+    if (numRecords == 0) {
+        return results;
+    }
+    // No empty threads (e.g. reduce the requested number, if small record input)
+    const int32_t actualThreadCount =
+        std::min(static_cast<int32_t>(settings.NumThreads), numRecords);
+
+    // Determine how many records should land in each thread, spread roughly evenly.
+    const int32_t minimumRecordsPerThreads = (numRecords / actualThreadCount);
+    const int32_t remainingRecords = (numRecords % actualThreadCount);
+    std::vector<int32_t> recordsPerThread(actualThreadCount, minimumRecordsPerThreads);
+    for (int i = 0; i < remainingRecords; ++i)
+        ++recordsPerThread[i];
+
+    // Run the mapping in parallel.
+    PacBio::Parallel::FireAndForget faf(settings.NumThreads);
+    int32_t submittedCount = 0;
+    for (int32_t i = 0; i < actualThreadCount; ++i) {
+        faf.ProduceWith(Worker<IndexType>, std::cref(targetSeqDBReader), std::cref(index),
+                        std::cref(querySeqDBReader), std::cref(querySeedSource),
+                        std::cref(settings), std::cref(mappers[i]), freqCutoff,
+                        generateFlippedOverlaps, submittedCount,
+                        submittedCount + recordsPerThread[i], std::ref(results),
+                        std::ref(counters), countQueries);
+        submittedCount += recordsPerThread[i];
+    }
+    faf.Finalize();
+
+    return results;
+}
+
+/*
+ * Keeps only the best N non-flipped overlaps by score (in total and per end of the query),
+ * and drops the flipped counterparts (the reverse overlaps, written with --write-rev)
+ * of the removed ones.
+*/
+void KeepBestN(std::vector<OverlapPtr>& overlaps, int32_t bestN, int32_t bestNPerEnd)
+{
+    std::vector<OverlapPtr> primary;
+    std::vector<OverlapPtr> flipped;
+    for (auto& ovl : overlaps) {
+        if (ovl->IsFlipped) {
+            flipped.emplace_back(std::move(ovl));
+        } else {
+            primary.emplace_back(std::move(ovl));
+        }
+    }
+    std::stable_sort(primary.begin(), primary.end(),
+                     [](const auto& a, const auto& b) { return a->Score < b->Score; });
+    const std::vector<OverlapPtr> removed =
+        OverlapHiFi::KeepBestOverlaps(primary, bestN, bestNPerEnd);
+
+    // A flipped overlap is matched to its primary by the target ID and the query coordinates.
+    std::set<std::tuple<int32_t, int32_t, int32_t>> dropped;
+    for (const auto& ovl : removed) {
+        dropped.emplace(std::make_tuple(ovl->Bid, ovl->AstartFwd(), ovl->AendFwd()));
+    }
+
+    overlaps = std::move(primary);
+    for (auto& ovl : flipped) {
+        if (dropped.count(std::make_tuple(ovl->Aid, ovl->BstartFwd(), ovl->BendFwd()))) {
+            continue;
+        }
+        overlaps.emplace_back(std::move(ovl));
+    }
+}
+
+/*
+ * Lifts an overlap computed on the HPC sequences back to the raw sequences, using the run
+ * lengths stored by the readers. The flipped overlaps have the target as the A-read.
+*/
+void LiftOverlapToRawCoords(Overlap& ovl,
+                            const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
+                            const PacBio::Pancake::SeqDBReaderCachedBlock& querySeqDBReader,
+                            const PacBio::Pancake::FastaSequenceCached& querySeq)
+{
+    if (ovl.IsFlipped) {
+        LiftOverlapToRaw(ovl, targetSeqDBReader.hpcCoordinateMap(),
+                         querySeqDBReader.hpcCoordinateMap(),
+                         targetSeqDBReader.GetSequence(ovl.Aid).c_str());
+    } else {
+        LiftOverlapToRaw(ovl, querySeqDBReader.hpcCoordinateMap(),
+                         targetSeqDBReader.hpcCoordinateMap(), querySeq.c_str());
+    }
+}
+
+// The corrected reads are written with the default buffer and block sizes of 'pancake seqdb'.
+static const int64_t CORRECTED_SEQDB_BUFFER_SIZE = 1000LL * 1024 * 1024;
+static const int64_t CORRECTED_SEQDB_BLOCK_SIZE = 1000LL * 1000 * 1000;
+
+void CorrectionWorker(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
+                      const PacBio::Pancake::SeqDBReaderCachedBlock& querySeqDBReader,
+                      const std::vector<OverlapHiFi::MapperResult>& results,
+                      const ReadCorrectionSettings& correctionSettings, int32_t start,
+                      int32_t end, std::vector<std::string>& corrected,
+                      std::vector<ReadCorrectionStats>& stats)
+{
+    for (int32_t i = start; i < end; ++i) {
+        const auto& querySeq = querySeqDBReader.records()[i];
+        std::vector<PileupAlignment> alignments;
+        for (const auto& ovl : results[i].overlaps) {
+            if (ovl->IsFlipped || ovl->IsSecondary || ovl->Cigar.empty()) {
+                continue;
+            }
+            const auto& targetSeq = targetSeqDBReader.GetSequence(ovl->Bid);
+            alignments.emplace_back(
+                CreatePileupAlignment(*ovl, targetSeq.c_str(), targetSeq.size()));
+        }
+        corrected[i] = CorrectRead(querySeq.c_str(), querySeq.size(), alignments,
+                                   correctionSettings, stats[i]);
+    }
+}
+
+/*
+ * Error-corrects the reads of the query block with the pileups of their overlaps, while the
+ * alignments are still in memory, and adds the corrected reads to the writer in the order of
+ * the query block. The flipped overlaps have the target as the A-read and are skipped, as are
+ * the secondary alignments, which come from the repeats.
+*/
+void CorrectQueryBlock(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqDBReader,
+                       const PacBio::Pancake::SeqDBReaderCachedBlock& querySeqDBReader,
+                       const PacBio::Pancake::SeqDBIndexCache& querySeqDBCache,
+                       const std::vector<OverlapHiFi::MapperResult>& results,
+                       const OverlapHifiSettings& settings,
+                       PacBio::Pancake::SeqDBWriter& correctedWriter)
+{
+    ReadCorrectionSettings correctionSettings;
+    correctionSettings.minCoverage = settings.CorrectMinCoverage;
+    correctionSettings.minHetSupport = settings.CorrectMinHetSupport;
+    correctionSettings.minHetFraction = settings.CorrectMinHetFraction;
+
+    const int32_t numRecords = querySeqDBReader.records().size();
+    std::vector<std::string> corrected(numRecords);
+    std::vector<ReadCorrectionStats> stats(numRecords);
+    const int32_t numJobs =
+        std::max<int32_t>(1, std::min<int32_t>(settings.NumThreads, numRecords));
+    const int32_t recordsPerJob = (numRecords + numJobs - 1) / numJobs;
+    PacBio::Parallel::FireAndForget faf(settings.NumThreads);
+    for (int32_t start = 0; start < numRecords; start += recordsPerJob) {
+        faf.ProduceWith(CorrectionWorker, std::cref(targetSeqDBReader), std::cref(querySeqDBReader),
+                        std::cref(results), std::cref(correctionSettings), start,
+                        std::min(numRecords, start + recordsPerJob), std::ref(corrected),
+                        std::ref(stats));
+    }
+    faf.Finalize();
+
+    int64_t numCovered = 0;
+    int64_t numCorrected = 0;
+    int64_t numHetKept = 0;
+    for (int32_t i = 0; i < numRecords; ++i) {
+        const auto& querySeq = querySeqDBReader.records()[i];
+        const bool isCircular = querySeqDBCache.GetSeqLine(querySeq.Id()).isCircular;
+        correctedWriter.AddSequence(querySeq.Name(), corrected[i], isCircular);
+        numCovered += stats[i].numCovered;
+        numCorrected += stats[i].numCorrected;
+        numHetKept += stats[i].numHetKept;
+    }
+    PBLOG_INFO << "Corrected " << numCorrected << " homopolymer runs and kept " << numHetKept
+               << " heterozygous runs, out of " << numCovered << " covered runs in "
+               << numRecords << " reads.";
+}
+
+/*
+ * Merges the results of the query-end pass into the results of the main pass.
+ * The query-end pass maps the targets onto an index of the query ends, so its overlaps have
+ * the target as the A-read. Every overlap was generated together with its flipped version
+ * (A-read is the query), which are stored in the same order in the second half of the vector.
+ * An overlap is kept only if the main pass did not already report the same (Aid, Bid, Brev)
+ * pair, so overlaps found by both passes are written once.
+*/
+void MergeQueryEndResults(std::vector<OverlapHiFi::MapperResult>& queryEndResults,
+                          const PacBio::Pancake::SeqDBReaderCachedBlock& querySeqDBReader,
+                          const OverlapHifiSettings& settings,
+                          std::vector<OverlapHiFi::MapperResult>& results)
+{
+    std::unordered_map<int32_t, int32_t> queryIdToOrdinalId;
+    for (size_t i = 0; i < querySeqDBReader.records().size(); ++i) {
+        queryIdToOrdinalId[querySeqDBReader.records()[i].Id()] = i;
+    }
+
+    // The flipped query-end overlaps can have the query (A-read) reversed, so the key uses
+    // the relative strand, which equals Brev for the main-pass overlaps.
+    const auto PairKey = [](const PacBio::Pancake::OverlapPtr& ovl) {
+        return (static_cast<int64_t>(ovl->Bid) << 1) | static_cast<int64_t>(ovl->Arev != ovl->Brev);
+    };
+    std::vector<std::unordered_set<int64_t>> mainPassPairs(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        for (const auto& ovl : results[i].overlaps) {
+            if (ovl->IsFlipped == false) {
+                mainPassPairs[i].emplace(PairKey(ovl));
+            }
+        }
+    }
+
+    std::vector<bool> isUpdated(results.size(), false);
+
+    for (auto& result : queryEndResults) {
+        auto& overlaps = result.overlaps;
+        const size_t numOverlaps = overlaps.size() / 2;
+        for (size_t i = 0; i < numOverlaps; ++i) {
+            auto& ovlRev = overlaps[i];
+            auto& ovl = overlaps[numOverlaps + i];
+            if (settings.SkipSymmetricOverlaps && ovl->Aid > ovl->Bid) {
+                continue;
+            }
+            const int32_t ordinalId = queryIdToOrdinalId.at(ovl->Aid);
+            if (mainPassPairs[ordinalId].count(PairKey(ovl)) > 0) {
+                continue;
+            }
+
+            // Switch the contexts, because the query is the A-read in the output.
+            ovl->IsFlipped = false;
+            results[ordinalId].overlaps.emplace_back(std::move(ovl));
+            if (settings.WriteReverseOverlaps) {
+                ovlRev->IsFlipped = true;
+                results[ordinalId].overlaps.emplace_back(std::move(ovlRev));
+            }
+            isUpdated[ordinalId] = true;
+        }
+    }
+
+    if (settings.BestN > 0 || settings.BestNPerEnd > 0) {
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (isUpdated[i]) {
+                KeepBestN(results[i].overlaps, settings.BestN, settings.BestNPerEnd);
+            }
+        }
+    }
+}
+
+/*
+ * The DB caches, the seed parameters and the candidate pairs, shared by all target blocks
+ * mapped in a run.
+*/
+class OverlapHifiInputs
+{
+public:
+    std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> targetSeqDBCache;
+    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> targetSeedDBCache;
+    std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> querySeqDBCache;
+    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> querySeedDBCache;
+    SeedDB::SeedDBParameters targetSeedParams;
+    SeedDB::SeedDBParameters querySeedParams;
+    bool usePairs = false;
+    std::vector<CandidatePair> pairs;
+};
+
+/*
+ * Ranges of query blocks to map onto the loaded target block, and the output of each range.
+*/
+class QueryRangeSource
+{
+public:
+    virtual ~QueryRangeSource() = default;
+
+    /// \brief Returns false if there are no more ranges for the target block.
+    virtual bool Next(int32_t& queryBlockStartId, int32_t& queryBlockEndId, FILE*& fpOut) = 0;
+
+    /// \brief Called after all overlaps of the range were written.
+    virtual void Finish() = 0;
+};
+
+/*
+ * The query blocks given on the command line, written to stdout.
+*/
+class SingleQueryRangeSource : public QueryRangeSource
+{
+public:
+    SingleQueryRangeSource(int32_t queryBlockStartId, int32_t queryBlockEndId)
+        : queryBlockStartId_{queryBlockStartId}, queryBlockEndId_{queryBlockEndId}
+    {}
+
+    bool Next(int32_t& queryBlockStartId, int32_t& queryBlockEndId, FILE*& fpOut) override
+    {
+        if (isDone_) {
+            return false;
+        }
+        queryBlockStartId = queryBlockStartId_;
+        queryBlockEndId = queryBlockEndId_;
+        fpOut = stdout;
+        isDone_ = true;
+        return true;
+    }
+
+    void Finish() override {}
+
+private:
+    int32_t queryBlockStartId_ = 0;
+    int32_t queryBlockEndId_ = 0;
+    bool isDone_ = false;
+};
+
+/*
+ * The tasks of one target block claimed from the work queue. The first task is claimed by
+ * the caller, and the target block is kept while there are more tasks for it. Each task is
+ * written to its own output file.
+*/
+class WorkQueueRangeSource : public QueryRangeSource
+{
+public:
+    WorkQueueRangeSource(OverlapTaskQueue& queue, const OverlapTask& firstTask)
+        : queue_{queue}, task_{firstTask}
+    {}
+
+    ~WorkQueueRangeSource() override
+    {
+        if (fpOut_ != nullptr) {
+            fclose(fpOut_);
+        }
+    }
+
+    bool Next(int32_t& queryBlockStartId, int32_t& queryBlockEndId, FILE*& fpOut) override
+    {
+        if (isFirst_ == false && queue_.Claim(task_.targetBlockId, task_) == false) {
+            return false;
+        }
+        isFirst_ = false;
+        const std::string outPath = queue_.OutputPath();
+        fpOut_ = fopen(outPath.c_str(), "w");
+        if (fpOut_ == nullptr) {
+            throw std::runtime_error("Could not open the task output '" + outPath + "'.");
+        }
+        PBLOG_INFO << "Claimed task " << task_.taskId << ": target block " << task_.targetBlockId
+                   << ", query blocks [" << task_.queryBlockStartId << ", "
+                   << task_.queryBlockEndId << ").";
+        queryBlockStartId = task_.queryBlockStartId;
+        queryBlockEndId = task_.queryBlockEndId;
+        fpOut = fpOut_;
+        return true;
+    }
+
+    void Finish() override
+    {
+        const int rv = fclose(fpOut_);
+        fpOut_ = nullptr;
+        if (rv != 0) {
+            throw std::runtime_error("Could not write the output of task " +
+                                     std::to_string(task_.taskId) + ".");
+        }
+        if (queue_.Complete()) {
+            PBLOG_INFO << "Completed task " << task_.taskId << ".";
+        } else {
+            PBLOG_WARN << "Task " << task_.taskId
+                       << " was claimed by another worker after its lease expired. The output "
+                          "of this worker was discarded.";
+        }
+    }
+
+private:
+    OverlapTaskQueue& queue_;
+    OverlapTask task_;
+    bool isFirst_ = true;
+    FILE* fpOut_ = nullptr;
+};
+
+int32_t GetQueryBlockEndId(const OverlapHifiSettings& settings,
+                           const PacBio::Pancake::SeqDBIndexCache& querySeqDBCache)
+{
+    return (settings.QueryBlockEndId <= 0) ? querySeqDBCache.blockLines.size()
+                                           : settings.QueryBlockEndId;
+}
+
+OverlapHifiInputs LoadOverlapHifiInputs(const OverlapHifiSettings& settings)
+{
     std::string targetSeqDBFile = settings.TargetDBPrefix + ".seqdb";
     std::string targetSeedDBFile = settings.TargetDBPrefix + ".seeddb";
     std::string querySeqDBFile = settings.QueryDBPrefix + ".seqdb";
@@ -58,70 +681,306 @@ int OverlapHifiWorkflow::Runner(const PacBio::CLI_v2::Results& options)
     PBLOG_INFO << "Loading the input DBs.";
     TicToc ttInit;
 
-    // Load the target DB caches.
+    // Load the DB caches. The SeedDB is not needed for a side which is seeded on the fly.
     std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> targetSeqDBCache =
         PacBio::Pancake::LoadSeqDBIndexCache(targetSeqDBFile);
     PBLOG_INFO << "After loading target seq cache: " << ttInit.VerboseSecs(true);
-    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> targetSeedDBCache =
-        PacBio::Pancake::LoadSeedDBIndexCache(targetSeedDBFile);
-    PBLOG_INFO << "After loading target seed cache: " << ttInit.VerboseSecs(true);
-    PBLOG_INFO << "Target seed params: k = " << targetSeedDBCache->seedParams.KmerSize
-               << ", w = " << targetSeedDBCache->seedParams.MinimizerWindow
-               << ", s = " << targetSeedDBCache->seedParams.Spacing
-               << ", hpc = " << targetSeedDBCache->seedParams.UseHPC
-               << ", rc = " << targetSeedDBCache->seedParams.UseRC;
-    if (targetSeedDBCache->seedParams.UseHPC != settings.UseHPC) {
+    // The pileups are built from the overlaps with one target block only.
+    if (settings.CorrectOutPrefix.empty() == false && targetSeqDBCache->blockLines.size() > 1) {
         throw std::runtime_error(
-            "The --use-hpc option was either used to compute the target SeedDB but not specified "
-            "for overlapping, or vice versa.");
+            "The '--correct' option requires a target DB with a single block, but '" +
+            targetSeqDBFile + "' has " + std::to_string(targetSeqDBCache->blockLines.size()) +
+            " blocks.");
+    }
+    // The SV evidence is collected from the mappings to one target block only.
+    if ((settings.SVBedpePath.empty() == false || settings.WriteSATags) &&
+        targetSeqDBCache->blockLines.size() > 1) {
+        throw std::runtime_error(
+            "The '--sv-bedpe' and '--write-sa-tags' options require a target DB with a single "
+            "block, but '" +
+            targetSeqDBFile + "' has " + std::to_string(targetSeqDBCache->blockLines.size()) +
+            " blocks.");
+    }
+    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> targetSeedDBCache;
+    if (settings.ComputeTargetSeeds == false) {
+        targetSeedDBCache = PacBio::Pancake::LoadSeedDBIndexCache(targetSeedDBFile);
+        PBLOG_INFO << "After loading target seed cache: " << ttInit.VerboseSecs(true);
     }
-
-    // Load the query DB caches.
     std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> querySeqDBCache =
         PacBio::Pancake::LoadSeqDBIndexCache(querySeqDBFile);
     PBLOG_INFO << "After loading query seq cache: " << ttInit.VerboseSecs(true);
-    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> querySeedDBCache =
-        PacBio::Pancake::LoadSeedDBIndexCache(querySeedDBFile);
-    PBLOG_INFO << "After loading query seed cache: " << ttInit.VerboseSecs(true);
-    PBLOG_INFO << "Query seed params: k = " << targetSeedDBCache->seedParams.KmerSize
-               << ", w = " << targetSeedDBCache->seedParams.MinimizerWindow
-               << ", s = " << targetSeedDBCache->seedParams.Spacing
-               << ", hpc = " << targetSeedDBCache->seedParams.UseHPC
-               << ", rc = " << targetSeedDBCache->seedParams.UseRC;
-    if (querySeedDBCache->seedParams.UseHPC != settings.UseHPC) {
+    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> querySeedDBCache;
+    if (settings.ComputeQuerySeeds == false) {
+        querySeedDBCache = PacBio::Pancake::LoadSeedDBIndexCache(querySeedDBFile);
+        PBLOG_INFO << "After loading query seed cache: " << ttInit.VerboseSecs(true);
+    }
+
+    // The seeds computed on the fly use the given parameters, or the ones of the other SeedDB.
+    SeedDB::SeedDBParameters computedSeedParams;
+    if (settings.SeedParams.empty() == false) {
+        computedSeedParams = ParseSeedDBParams(settings.SeedParams);
+    } else if (targetSeedDBCache != nullptr) {
+        computedSeedParams = targetSeedDBCache->seedParams;
+    } else if (querySeedDBCache != nullptr) {
+        computedSeedParams = querySeedDBCache->seedParams;
+    }
+    const SeedDB::SeedDBParameters targetSeedParams =
+        (targetSeedDBCache != nullptr) ? targetSeedDBCache->seedParams : computedSeedParams;
+    const SeedDB::SeedDBParameters querySeedParams =
+        (querySeedDBCache != nullptr) ? querySeedDBCache->seedParams : computedSeedParams;
+
+    LogSeedParams((settings.ComputeTargetSeeds ? "Target (computed)" : "Target"),
+                  targetSeedParams);
+    if (targetSeedParams.UseHPC != settings.UseHPC) {
+        throw std::runtime_error(
+            "The --use-hpc option was either used to compute the target SeedDB but not specified "
+            "for overlapping, or vice versa.");
+    }
+    LogSeedParams((settings.ComputeQuerySeeds ? "Query (computed)" : "Query"), querySeedParams);
+    if (querySeedParams.UseHPC != settings.UseHPC) {
         throw std::runtime_error(
             "The --use-hpc option was either used to compute the query SeedDB but not specified "
             "for overlapping, or vice versa.");
     }
+    // Seeds from different schemes have unrelated keys, so they would not produce any hits.
+    if (querySeedParams.Scheme != targetSeedParams.Scheme ||
+        (querySeedParams.Scheme != SeedDB::SeedingScheme::Minimizer &&
+         (querySeedParams.KmerSize != targetSeedParams.KmerSize ||
+          querySeedParams.SyncmerSize != targetSeedParams.SyncmerSize ||
+          querySeedParams.StrobeMinDist != targetSeedParams.StrobeMinDist ||
+          querySeedParams.StrobeMaxDist != targetSeedParams.StrobeMaxDist))) {
+        throw std::runtime_error(
+            "The query and target SeedDBs were computed with different seeding schemes or "
+            "scheme parameters.");
+    }
+    if (settings.Palindromes != PalindromeAction::None && querySeedParams.UseRC == false) {
+        throw std::runtime_error(
+            "The '--palindromes' option requires the query seeds to be computed with the reverse "
+            "complement.");
+    }
+
+    // Pair-list mode: load the pairs. A single run keeps only the pairs within its query blocks.
+    const bool usePairs = settings.PairsPath.empty() == false;
+    std::vector<CandidatePair> pairs;
+    if (usePairs) {
+        TicToc ttPairs;
+        if (settings.PairsUseIds == false) {
+            querySeqDBCache->ConstructHeaderLookup();
+            targetSeqDBCache->ConstructHeaderLookup();
+        }
+        if (settings.PairsPath == "-") {
+            pairs = ReadCandidatePairs(std::cin, *querySeqDBCache, *targetSeqDBCache,
+                                       settings.PairsUseIds);
+        } else {
+            std::ifstream ifs(settings.PairsPath);
+            if (ifs.is_open() == false) {
+                throw std::runtime_error("Could not open the pair list file '" +
+                                         settings.PairsPath + "'!");
+            }
+            pairs = ReadCandidatePairs(ifs, *querySeqDBCache, *targetSeqDBCache,
+                                       settings.PairsUseIds);
+        }
+        const int64_t numPairsRead = pairs.size();
+        if (settings.WorkDir.empty()) {
+            const int32_t endBlockId = GetQueryBlockEndId(settings, *querySeqDBCache);
+            int32_t queryStartSeqId = 0;
+            int32_t queryEndSeqId = 0;
+            if (settings.QueryBlockStartId < endBlockId) {
+                queryStartSeqId =
+                    querySeqDBCache->GetBlockLine(settings.QueryBlockStartId).startSeqId;
+                queryEndSeqId = querySeqDBCache->GetBlockLine(endBlockId - 1).endSeqId;
+            }
+            pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+                                       [&](const auto& pair) {
+                                           return pair.queryId < queryStartSeqId ||
+                                                  pair.queryId >= queryEndSeqId;
+                                       }),
+                        pairs.end());
+        }
+        NormalizeCandidatePairs(pairs);
+        ttPairs.Stop();
+        PBLOG_INFO << "Loaded " << numPairsRead << " candidate pairs, " << pairs.size()
+                   << " unique pairs are within the query blocks. Time: " << ttPairs.GetSecs()
+                   << " sec.";
+    }
+
+    OverlapHifiInputs inputs;
+    inputs.targetSeqDBCache = targetSeqDBCache;
+    inputs.targetSeedDBCache = targetSeedDBCache;
+    inputs.querySeqDBCache = querySeqDBCache;
+    inputs.querySeedDBCache = querySeedDBCache;
+    inputs.targetSeedParams = targetSeedParams;
+    inputs.querySeedParams = querySeedParams;
+    inputs.usePairs = usePairs;
+    inputs.pairs = std::move(pairs);
+    return inputs;
+}
+
+/*
+ * Loads and indexes the target block, and maps the ranges of query blocks onto it.
+ * Only the main pass counts the queries in the progress. The hits and alignments of the
+ * query-end pass are counted too, because it takes a part of the run time.
+*/
+void RunTargetBlock(const OverlapHifiSettings& settings, const OverlapHifiInputs& inputs,
+                    int32_t targetBlockId, QueryRangeSource& querySource,
+                    ProgressReporter& progress)
+{
+    TicToc ttInit;
+
+    std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> targetSeqDBCache = inputs.targetSeqDBCache;
+    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> targetSeedDBCache = inputs.targetSeedDBCache;
+    std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> querySeqDBCache = inputs.querySeqDBCache;
+    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> querySeedDBCache = inputs.querySeedDBCache;
+    const SeedDB::SeedDBParameters& targetSeedParams = inputs.targetSeedParams;
+    const SeedDB::SeedDBParameters& querySeedParams = inputs.querySeedParams;
+    const bool usePairs = inputs.usePairs;
+
+    // The pairs within the target block, still sorted by the query ID.
+    std::vector<CandidatePair> pairs;
+    if (usePairs) {
+        const auto& targetBlock = targetSeqDBCache->GetBlockLine(targetBlockId);
+        std::copy_if(inputs.pairs.begin(), inputs.pairs.end(), std::back_inserter(pairs),
+                     [&](const auto& pair) {
+                         return pair.targetId >= targetBlock.startSeqId &&
+                                pair.targetId < targetBlock.endSeqId;
+                     });
+        PBLOG_INFO << pairs.size() << " candidate pairs are within the target block "
+                   << targetBlockId << ".";
+    }
 
     // Create the target readers.
-    PacBio::Pancake::SeqDBReaderCachedBlock targetSeqDBReader(targetSeqDBCache, settings.UseHPC);
-    targetSeqDBReader.LoadBlocks({settings.TargetBlockId});
-    PacBio::Pancake::SeedDBReaderRawBlock targetSeedDBReader(targetSeedDBCache);
+    PacBio::Pancake::SeqDBReaderCachedBlock targetSeqDBReader(targetSeqDBCache, settings.UseHPC,
+                                                               settings.HPCRawCoords);
+    targetSeqDBReader.LoadBlocks({targetBlockId});
 
-    // Read the seeds for the target block.
-    std::vector<PacBio::Pancake::SeedDB::SeedRaw> targetSeeds =
-        targetSeedDBReader.GetBlock(settings.TargetBlockId);
+    // The circular targets are unrolled, so that the reads which span the origin map colinearly.
+    // The end-anchored mode indexes only the target ends, which a circular target does not have.
+    std::vector<int32_t> targetCircularLengths;
+    if (settings.EndSeedDistance > 0) {
+        for (const auto& record : targetSeqDBReader.records()) {
+            if (targetSeqDBCache->GetSeqLine(record.Id()).isCircular) {
+                PBLOG_WARN << "The circular targets are treated as linear in the end-anchored "
+                              "mode.";
+                break;
+            }
+        }
+    } else {
+        targetCircularLengths = targetSeqDBReader.UnrollCircularSequences();
+    }
+    const int32_t numCircularTargets =
+        std::count_if(targetCircularLengths.begin(), targetCircularLengths.end(),
+                      [](int32_t len) { return len > 0; });
+
+    // Read or compute the seeds for the target block.
+    // In the end-anchored mode, all target seeds are kept for the query-end pass, but only
+    // the ones near the target ends are indexed.
+    // In the pair-list mode, the seeds of each target are looked up by the target ID.
+    std::vector<int32_t> targetLengths =
+        (targetSeedDBCache != nullptr)
+            ? GetSequenceLengths(*targetSeedDBCache)
+            : GetSequenceLengths(targetSeqDBReader, targetSeqDBCache->seqLines.size());
+    for (const auto& record : targetSeqDBReader.records()) {
+        if (targetCircularLengths.empty() == false && targetCircularLengths[record.Id()] > 0) {
+            targetLengths[record.Id()] = record.size();
+        }
+    }
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw> targetSeeds;
+    std::unique_ptr<PacBio::Pancake::SeedDBReaderCachedBlock> targetSeedDBReaderCached;
+    if (usePairs || settings.EndSeedDistance > 0) {
+        if (settings.ComputeTargetSeeds) {
+            targetSeedDBReaderCached = GenerateSeedsInParallel(
+                targetSeqDBReader.records(), targetSeedParams, settings.NumThreads);
+        } else {
+            targetSeedDBReaderCached =
+                std::make_unique<PacBio::Pancake::SeedDBReaderCachedBlock>(targetSeedDBCache);
+            targetSeedDBReaderCached->LoadBlock({targetBlockId});
+            if (numCircularTargets > 0) {
+                std::vector<std::vector<PacBio::Pancake::Int128t>> unrolledSeeds;
+                for (const auto& record : targetSeqDBReader.records()) {
+                    const auto& recordSeeds =
+                        targetSeedDBReaderCached->GetSeedsForSequence(record.Id());
+                    unrolledSeeds.emplace_back(UnrollCircularSeeds(
+                        recordSeeds.Seeds(), recordSeeds.Size(), targetCircularLengths));
+                }
+                targetSeedDBReaderCached =
+                    std::make_unique<PacBio::Pancake::SeedDBReaderCachedBlock>(
+                        targetSeqDBReader.records(), unrolledSeeds);
+            }
+        }
+        if (usePairs == false) {
+            for (const auto& record : targetSeedDBReaderCached->records()) {
+                CollectSeedsNearSequenceEnds(record.Seeds(), record.Size(), targetLengths,
+                                             settings.EndSeedDistance, targetSeeds);
+            }
+        }
+    } else if (settings.ComputeTargetSeeds) {
+        const auto computed = GenerateSeedsInParallel(targetSeqDBReader.records(),
+                                                      targetSeedParams, settings.NumThreads);
+        for (const auto& record : computed->records()) {
+            targetSeeds.insert(targetSeeds.end(), record.Seeds(), record.Seeds() + record.Size());
+        }
+    } else {
+        PacBio::Pancake::SeedDBReaderRawBlock targetSeedDBReader(targetSeedDBCache);
+        targetSeeds = targetSeedDBReader.GetBlock(targetBlockId);
+        if (numCircularTargets > 0) {
+            targetSeeds =
+                UnrollCircularSeeds(targetSeeds.data(), targetSeeds.size(), targetCircularLengths);
+        }
+    }
 
     ttInit.Stop();
     PBLOG_INFO << "Loaded the target index and seqs in " << ttInit.GetSecs() << " sec.";
 
+    if (settings.EndSeedDistance > 0) {
+        PBLOG_INFO << "End-anchored mode: indexing only the seeds within "
+                   << settings.EndSeedDistance << " bp from the target ends.";
+    }
     PBLOG_INFO << "Target seqs: " << targetSeqDBReader.records().size();
+    if (numCircularTargets > 0) {
+        PBLOG_INFO << "Circular target seqs: " << numCircularTargets;
+    }
     PBLOG_INFO << "Target seeds: " << targetSeeds.size();
 
-    // Build the seed index.
+    // Build the seed index. In the minimizer-space mode, the k-min-mers are indexed instead.
+    // The pair-list mode does not need an index.
     TicToc ttIndex;
-    PacBio::Pancake::SeedIndex index(targetSeedDBCache, std::move(targetSeeds));
+    std::unique_ptr<PacBio::Pancake::SeedIndex> index;
+    std::unique_ptr<PacBio::Pancake::MinimizerSpaceIndex> minSpaceIndex;
+    std::unique_ptr<CandidatePairIndex> pairIndex;
+    if (usePairs) {
+        pairIndex = std::make_unique<CandidatePairIndex>(CandidatePairIndex{
+            PacBio::Pancake::SortedSequenceSeeds(targetSeedDBReaderCached->records()),
+            targetLengths, targetSeedParams.KmerSize, pairs});
+    } else if (settings.MinimizerSpace) {
+        minSpaceIndex = std::make_unique<PacBio::Pancake::MinimizerSpaceIndex>(
+            targetSeedParams, targetLengths, std::move(targetSeeds), settings.MinimizerSpaceK);
+    } else {
+        index = std::make_unique<PacBio::Pancake::SeedIndex>(
+            targetSeedParams, targetLengths, std::move(targetSeeds), settings.SeedIndexHash);
+    }
     ttIndex.Stop();
-    PBLOG_INFO << "Built the seed index in " << ttIndex.GetSecs() << " sec.";
+    PBLOG_INFO << "Built the "
+               << (usePairs ? "pair" : (settings.MinimizerSpace ? "minimizer-space" : "seed"))
+               << " index in " << ttIndex.GetSecs() << " sec.";
+    if (index != nullptr) {
+        PBLOG_INFO << "Seed index hash: " << SeedIndexHashTypeToString(index->GetHashType());
+    }
 
-    // Seed statistics, and computing the cutoff.
+    // Seed statistics, and computing the cutoff. The pairs are checked without a cutoff.
     TicToc ttSeedStats;
     int64_t freqMax = 0;
     int64_t freqCutoff = 0;
     double freqAvg = 0.0;
     double freqMedian = 0.0;
-    index.ComputeFrequencyStats(settings.FreqPercentile, freqMax, freqAvg, freqMedian, freqCutoff);
+    if (usePairs) {
+        // Nothing to compute.
+    } else if (settings.MinimizerSpace) {
+        minSpaceIndex->ComputeFrequencyStats(settings.FreqPercentile, freqMax, freqAvg, freqMedian,
+                                             freqCutoff);
+    } else {
+        index->ComputeFrequencyStats(settings.FreqPercentile, freqMax, freqAvg, freqMedian,
+                                     freqCutoff);
+    }
     ttSeedStats.Stop();
     PBLOG_INFO << "Computed the seed frequency statistics in " << ttSeedStats.GetSecs() << " sec.";
 
@@ -132,110 +991,376 @@ int OverlapHifiWorkflow::Runner(const PacBio::CLI_v2::Results& options)
 
     PBLOG_INFO << "Beginning to map the sequences.";
     PBLOG_INFO << "Using " << settings.NumThreads << " threads.";
+    // Each overlap with a circular target is found in both copies of the unrolled target,
+    // so the best-N filters are applied only after the duplicates are removed.
+    OverlapHifiSettings mapperSettings = settings;
+    if (numCircularTargets > 0) {
+        mapperSettings.BestN = 0;
+        mapperSettings.BestNPerEnd = 0;
+    }
     std::vector<OverlapHiFi::Mapper> mappers;
     for (size_t i = 0; i < settings.NumThreads; ++i) {
-        mappers.emplace_back(OverlapHiFi::Mapper(settings));
+        mappers.emplace_back(OverlapHiFi::Mapper(mapperSettings));
+    }
+
+    // The query-end pass maps the targets onto the queries, so the roles are swapped.
+    // The symmetric and the best-N filters are applied after the results are merged.
+    std::vector<OverlapHiFi::Mapper> mappersQueryEnds;
+    if (settings.EndSeedDistance > 0) {
+        OverlapHifiSettings settingsQueryEnds = settings;
+        settingsQueryEnds.MinQueryLen = settings.MinTargetLen;
+        settingsQueryEnds.MinTargetLen = settings.MinQueryLen;
+        settingsQueryEnds.SkipSymmetricOverlaps = false;
+        settingsQueryEnds.BestN = 0;
+        settingsQueryEnds.BestNPerEnd = 0;
+        for (size_t i = 0; i < settings.NumThreads; ++i) {
+            mappersQueryEnds.emplace_back(OverlapHiFi::Mapper(settingsQueryEnds));
+        }
     }
-    TicToc ttMap;
 
-    auto writer = PacBio::Pancake::OverlapWriterFactory(settings.OutFormat, stdout,
-                                                        settings.WriteIds, settings.WriteCigar);
+    std::ofstream palindromeListStream;
+    if (settings.PalindromeListPath.empty() == false) {
+        palindromeListStream.open(settings.PalindromeListPath);
+        if (palindromeListStream.is_open() == false) {
+            throw std::runtime_error("Could not open the palindrome list file '" +
+                                     settings.PalindromeListPath + "' for writing!");
+        }
+    }
 
-    writer->WriteHeader(targetSeqDBReader);
+    std::unique_ptr<FILE, decltype(&fclose)> svBedpeFile(nullptr, &fclose);
+    if (settings.SVBedpePath.empty() == false) {
+        svBedpeFile.reset(fopen(settings.SVBedpePath.c_str(), "w"));
+        if (svBedpeFile == nullptr) {
+            throw std::runtime_error("Could not open the SV evidence file '" +
+                                     settings.SVBedpePath + "' for writing!");
+        }
+    }
 
-    const int32_t endBlockId = (settings.QueryBlockEndId <= 0) ? querySeqDBCache->blockLines.size()
-                                                               : settings.QueryBlockEndId;
+    std::unique_ptr<PacBio::Pancake::SeqDBWriter> correctedWriter;
+    if (settings.CorrectOutPrefix.empty() == false) {
+        correctedWriter = PacBio::Pancake::CreateSeqDBWriter(
+            settings.CorrectOutPrefix, true, CORRECTED_SEQDB_BUFFER_SIZE,
+            CORRECTED_SEQDB_BLOCK_SIZE, false);
+    }
 
-    // Process all blocks.
-    PacBio::Pancake::SeqDBReaderCachedBlock querySeqDBReader(querySeqDBCache, settings.UseHPC);
-    PacBio::Pancake::SeedDBReaderCachedBlock querySeedDBReader(querySeedDBCache);
-    for (int32_t queryBlockId = settings.QueryBlockStartId; queryBlockId < endBlockId;
-         queryBlockId += settings.CombineBlocks) {
+    PacBio::Pancake::SeqDBReaderCachedBlock querySeqDBReader(querySeqDBCache, settings.UseHPC,
+                                                              settings.HPCRawCoords);
+    std::unique_ptr<PacBio::Pancake::SeedDBReaderCachedBlock> querySeedDBReader;
+    if (querySeedDBCache != nullptr) {
+        querySeedDBReader =
+            std::make_unique<PacBio::Pancake::SeedDBReaderCachedBlock>(querySeedDBCache);
+    }
 
-        std::vector<int32_t> blocksToLoad;
-        for (int32_t blockId = queryBlockId;
-             blockId < std::min(endBlockId, (queryBlockId + settings.CombineBlocks)); ++blockId) {
-            blocksToLoad.emplace_back(blockId);
-        }
-        if (blocksToLoad.empty()) {
-            throw std::runtime_error("There are zero blocks to load!");
-        }
-        std::string blocksToLoadStr;
-        {
-            std::ostringstream oss;
-            oss << "{" << blocksToLoad[0];
-            for (size_t i = 1; i < blocksToLoad.size(); ++i) {
-                oss << ", " << blocksToLoad[i];
+    // Process all query ranges.
+    int32_t queryBlockStartId = 0;
+    int32_t queryBlockEndId = 0;
+    FILE* fpOut = nullptr;
+    while (querySource.Next(queryBlockStartId, queryBlockEndId, fpOut)) {
+        auto writer = PacBio::Pancake::OverlapWriterFactory(settings.OutFormat, fpOut,
+                                                            settings.WriteIds, settings.WriteCigar);
+
+        writer->WriteHeader(targetSeqDBReader);
+
+        TicToc ttMap;
+
+        for (int32_t queryBlockId = queryBlockStartId; queryBlockId < queryBlockEndId;
+             queryBlockId += settings.CombineBlocks) {
+
+            std::vector<int32_t> blocksToLoad;
+            for (int32_t blockId = queryBlockId;
+                 blockId < std::min(queryBlockEndId, (queryBlockId + settings.CombineBlocks));
+                 ++blockId) {
+                blocksToLoad.emplace_back(blockId);
+            }
+            if (blocksToLoad.empty()) {
+                throw std::runtime_error("There are zero blocks to load!");
             }
-            oss << "}";
-            blocksToLoadStr = oss.str();
-        }
 
-        PBLOG_INFO << "Loading the query blocks: " << blocksToLoadStr << ".";
-        // Create the query readers for the current block.
-        TicToc ttQueryLoad;
-        // PacBio::Pancake::SeqDBReaderCached querySeqDBReader(querySeqDBCache, queryBlockId);
-        querySeqDBReader.LoadBlocks(blocksToLoad);
-        PBLOG_INFO << "Loaded the query SeqDB cache block after " << ttQueryLoad.GetSecs(true)
-                   << " sec.";
-        querySeedDBReader.LoadBlock(blocksToLoad);
-        ttQueryLoad.Stop();
-        PBLOG_INFO << "Loaded the query SeedDB cache block after " << ttQueryLoad.GetSecs()
-                   << " sec.";
-        PBLOG_INFO << "Loaded all query blocks in " << ttQueryLoad.GetSecs() << " sec.";
+            std::string blocksToLoadStr;
+            {
+                std::ostringstream oss;
+                oss << "{" << blocksToLoad[0];
+                for (size_t i = 1; i < blocksToLoad.size(); ++i) {
+                    oss << ", " << blocksToLoad[i];
+                }
+                oss << "}";
+                blocksToLoadStr = oss.str();
+            }
 
-        std::ostringstream oss;
-        oss << "About to map query blocks: " << blocksToLoadStr
-            << ": num_seqs = " << querySeqDBReader.records().size();
-        PBLOG_INFO << oss.str();
-
-        // Parallel processing.
-        {
-            TicToc ttQueryBlockMapping;
-            const int32_t numRecords = static_cast<int32_t>(querySeqDBReader.records().size());
-            // Storage for the results of the batch run.
-            std::vector<OverlapHiFi::MapperResult> results(numRecords);
-            // No empty threads (e.g. reduce the requested number, if small record input)
-            const int32_t actualThreadCount =
-                std::min(static_cast<int32_t>(settings.NumThreads), numRecords);
-
-            // Determine how many records should land in each thread, spread roughly evenly.
-            const int32_t minimumRecordsPerThreads = (numRecords / actualThreadCount);
-            const int32_t remainingRecords = (numRecords % actualThreadCount);
-            std::vector<int32_t> recordsPerThread(actualThreadCount, minimumRecordsPerThreads);
-            for (int i = 0; i < remainingRecords; ++i)
-                ++recordsPerThread[i];
-
-            // Run the mapping in parallel.
-            PacBio::Parallel::FireAndForget faf(settings.NumThreads);
-            int32_t submittedCount = 0;
-            for (int32_t i = 0; i < actualThreadCount; ++i) {
-                faf.ProduceWith(Worker, std::cref(targetSeqDBReader), std::cref(index),
-                                std::cref(querySeqDBReader), std::cref(querySeedDBReader),
-                                std::cref(settings), std::cref(mappers[i]), freqCutoff,
-                                settings.WriteReverseOverlaps, submittedCount,
-                                submittedCount + recordsPerThread[i], std::ref(results));
-                submittedCount += recordsPerThread[i];
-            }
-            faf.Finalize();
-
-            // Write the results.
-            for (size_t i = 0; i < querySeqDBReader.records().size(); ++i) {
-                const auto& result = results[i];
-                const auto& querySeq = querySeqDBReader.records()[i];
-
-                for (const auto& ovl : result.overlaps) {
-                    writer->Write(ovl, targetSeqDBReader, querySeq);
+            // In the pair-list mode, the query blocks without any pairs do not need to be loaded.
+            if (usePairs) {
+                const auto& startBlock = querySeqDBCache->GetBlockLine(blocksToLoad.front());
+                const auto& endBlock = querySeqDBCache->GetBlockLine(blocksToLoad.back());
+                CandidatePair key;
+                key.queryId = startBlock.startSeqId;
+                const auto it = std::lower_bound(
+                    pairs.begin(), pairs.end(), key,
+                    [](const auto& a, const auto& b) { return a.queryId < b.queryId; });
+                if (it == pairs.end() || it->queryId >= endBlock.endSeqId) {
+                    PBLOG_INFO << "Skipping the query blocks without pairs: " << blocksToLoadStr
+                               << ".";
+                    progress.Counters().AddQueries(endBlock.endSeqId - startBlock.startSeqId);
+                    for (const auto& blockId : blocksToLoad) {
+                        progress.Counters().AddBases(
+                            querySeqDBCache->GetBlockLine(blockId).numBases);
+                    }
+                    continue;
+                }
+            }
+
+            PBLOG_INFO << "Loading the query blocks: " << blocksToLoadStr << ".";
+            // Create the query readers for the current block.
+            TicToc ttQueryLoad;
+            // PacBio::Pancake::SeqDBReaderCached querySeqDBReader(querySeqDBCache, queryBlockId);
+            querySeqDBReader.LoadBlocks(blocksToLoad);
+            PBLOG_INFO << "Loaded the query SeqDB cache block after " << ttQueryLoad.GetSecs(true)
+                       << " sec.";
+            // The computed query seeds are generated by the mapping workers, unless they are also
+            // needed to index the query ends or to detect the palindromes.
+            if (querySeedDBCache != nullptr) {
+                querySeedDBReader->LoadBlock(blocksToLoad);
+                PBLOG_INFO << "Loaded the query SeedDB cache block after "
+                           << ttQueryLoad.GetSecs(true) << " sec.";
+            } else if (settings.EndSeedDistance > 0 ||
+                       settings.Palindromes != PalindromeAction::None) {
+                querySeedDBReader = GenerateSeedsInParallel(querySeqDBReader.records(),
+                                                            querySeedParams, settings.NumThreads);
+                PBLOG_INFO << "Computed the query seeds after " << ttQueryLoad.GetSecs(true)
+                           << " sec.";
+            }
+            ttQueryLoad.Stop();
+            PBLOG_INFO << "Loaded all query blocks in " << ttQueryLoad.GetSecs() << " sec.";
+
+            // Detect the reads which align to their own reverse complement. Skipping or trimming
+            // them replaces the seeds of the query block.
+            std::unique_ptr<PacBio::Pancake::SeedDBReaderCachedBlock> palindromeFilteredSeeds;
+            if (settings.Palindromes != PalindromeAction::None) {
+                TicToc ttPalindromes;
+                const std::vector<PalindromeResult> palindromes =
+                    DetectPalindromesInParallel(querySeqDBReader, *querySeedDBReader, settings);
+                int32_t numPalindromes = 0;
+                for (size_t i = 0; i < palindromes.size(); ++i) {
+                    if (palindromes[i].isPalindrome == false) {
+                        continue;
+                    }
+                    const auto& querySeq = querySeqDBReader.records()[i];
+                    PBLOG_DEBUG << "Palindrome: " << querySeq.Name()
+                                << ", len = " << querySeq.size() << ", " << palindromes[i];
+                    if (palindromeListStream.is_open()) {
+                        palindromeListStream << querySeq.Name() << "\n";
+                    }
+                    ++numPalindromes;
+                }
+                if (settings.Palindromes == PalindromeAction::Skip ||
+                    settings.Palindromes == PalindromeAction::Trim) {
+                    palindromeFilteredSeeds = FilterPalindromeSeeds(
+                        querySeqDBReader, *querySeedDBReader, palindromes, settings.Palindromes);
+                }
+                ttPalindromes.Stop();
+                PBLOG_INFO << "Detected " << numPalindromes << " palindromic reads ("
+                           << PalindromeActionToString(settings.Palindromes) << ") in "
+                           << ttPalindromes.GetSecs() << " sec.";
+            }
+            const QuerySeedSource querySeedSource{(palindromeFilteredSeeds != nullptr)
+                                                      ? palindromeFilteredSeeds.get()
+                                                      : querySeedDBReader.get(),
+                                                  querySeedParams};
+
+            std::ostringstream oss;
+            oss << "About to map query blocks: " << blocksToLoadStr
+                << ": num_seqs = " << querySeqDBReader.records().size();
+            PBLOG_INFO << oss.str();
+
+            // Parallel processing.
+            {
+                TicToc ttQueryBlockMapping;
+                std::vector<OverlapHiFi::MapperResult> results;
+                if (usePairs) {
+                    results = MapInParallel(targetSeqDBReader, *pairIndex, querySeqDBReader,
+                                            querySeedSource, settings, mappers, freqCutoff,
+                                            settings.WriteReverseOverlaps, progress.Counters(),
+                                            true);
+                } else if (settings.MinimizerSpace) {
+                    results = MapInParallel(targetSeqDBReader, *minSpaceIndex, querySeqDBReader,
+                                            querySeedSource, settings, mappers, freqCutoff,
+                                            settings.WriteReverseOverlaps, progress.Counters(),
+                                            true);
+                } else {
+                    results = MapInParallel(targetSeqDBReader, *index, querySeqDBReader,
+                                            querySeedSource, settings, mappers, freqCutoff,
+                                            settings.WriteReverseOverlaps, progress.Counters(),
+                                            true);
                 }
+
+                // End-anchored mode: find the queries contained in the targets by mapping the
+                // targets onto an index of the query ends.
+                if (settings.EndSeedDistance > 0) {
+                    std::vector<PacBio::Pancake::SeedDB::SeedRaw> queryEndSeeds;
+                    const std::vector<int32_t> queryLengths =
+                        (querySeedDBCache != nullptr)
+                            ? GetSequenceLengths(*querySeedDBCache)
+                            : GetSequenceLengths(querySeqDBReader,
+                                                 querySeqDBCache->seqLines.size());
+                    for (const auto& record : querySeedSource.cachedSeeds->records()) {
+                        CollectSeedsNearSequenceEnds(record.Seeds(), record.Size(), queryLengths,
+                                                     settings.EndSeedDistance, queryEndSeeds);
+                    }
+                    PacBio::Pancake::SeedIndex queryEndIndex(querySeedParams, queryLengths,
+                                                             std::move(queryEndSeeds),
+                                                             settings.SeedIndexHash);
+                    int64_t queryEndFreqMax = 0;
+                    int64_t queryEndFreqCutoff = 0;
+                    double queryEndFreqAvg = 0.0;
+                    double queryEndFreqMedian = 0.0;
+                    queryEndIndex.ComputeFrequencyStats(settings.FreqPercentile, queryEndFreqMax,
+                                                        queryEndFreqAvg, queryEndFreqMedian,
+                                                        queryEndFreqCutoff);
+
+                    const QuerySeedSource targetSeedSource{targetSeedDBReaderCached.get(),
+                                                           targetSeedParams};
+                    std::vector<OverlapHiFi::MapperResult> queryEndResults = MapInParallel(
+                        querySeqDBReader, queryEndIndex, targetSeqDBReader, targetSeedSource,
+                        settings, mappersQueryEnds, queryEndFreqCutoff, true, progress.Counters(),
+                        false);
+
+                    MergeQueryEndResults(queryEndResults, querySeqDBReader, mapperSettings,
+                                         results);
+                }
+
+                // Wrap the overlaps with the unrolled circular targets back onto the targets.
+                if (numCircularTargets > 0) {
+                    for (auto& result : results) {
+                        WrapCircularOverlaps(result.overlaps, targetCircularLengths,
+                                             settings.AllowedDovetailDist, settings.ChainBandwidth);
+                        if (settings.BestN > 0 || settings.BestNPerEnd > 0) {
+                            KeepBestN(result.overlaps, settings.BestN, settings.BestNPerEnd);
+                        }
+                    }
+                }
+
+                if (correctedWriter != nullptr) {
+                    CorrectQueryBlock(targetSeqDBReader, querySeqDBReader, *querySeqDBCache,
+                                      results, settings, *correctedWriter);
+                }
+
+                // Write the results.
+                for (size_t i = 0; i < querySeqDBReader.records().size(); ++i) {
+                    const auto& result = results[i];
+                    const auto& querySeq = querySeqDBReader.records()[i];
+
+                    if (svBedpeFile != nullptr) {
+                        const std::vector<PacBio::Pancake::Breakpoint> breakpoints =
+                            PacBio::Pancake::ExtractBreakpoints(result.overlaps, querySeq,
+                                                                targetSeqDBReader,
+                                                                settings.SVMinLength);
+                        for (const auto& bp : breakpoints) {
+                            PacBio::Pancake::PrintBreakpointAsBEDPE(
+                                svBedpeFile.get(), bp, querySeq.Name(),
+                                targetSeqDBReader.GetSequence(bp.leftTargetId).Name(),
+                                targetSeqDBReader.GetSequence(bp.rightTargetId).Name());
+                        }
+                    }
+
+                    for (size_t ovlId = 0; ovlId < result.overlaps.size(); ++ovlId) {
+                        const auto& ovl = result.overlaps[ovlId];
+                        if (settings.HPCRawCoords) {
+                            LiftOverlapToRawCoords(*ovl, targetSeqDBReader, querySeqDBReader,
+                                                   querySeq);
+                        }
+                        if (settings.WriteSATags) {
+                            // Only the primary and supplementary records list the split mappings.
+                            const std::string saTag =
+                                ovl->IsSecondary
+                                    ? ""
+                                    : PacBio::Pancake::FormatSATag(result.overlaps, ovlId,
+                                                                   targetSeqDBReader,
+                                                                   settings.WriteIds);
+                            writer->WriteWithSAMTags(ovl, targetSeqDBReader, querySeq, saTag);
+                        } else {
+                            writer->Write(ovl, targetSeqDBReader, querySeq);
+                        }
+                    }
+                    progress.Counters().AddOverlaps(result.overlaps.size());
+                }
+
+                ttQueryBlockMapping.Stop();
+
+                PBLOG_INFO << "Mapped query block in " << ttQueryBlockMapping.GetSecs() << " sec.";
             }
+        }
+        ttMap.Stop();
+        PBLOG_INFO << "Mapped all query blocks in " << ttMap.GetSecs() << " sec.";
 
-            ttQueryBlockMapping.Stop();
+        querySource.Finish();
+    }
+}
 
-            PBLOG_INFO << "Mapped query block in " << ttQueryBlockMapping.GetSecs() << " sec.";
+void RunWorkQueue(const OverlapHifiSettings& settings, const OverlapHifiInputs& inputs,
+                  ProgressReporter& progress)
+{
+    // With the symmetric overlaps skipped, only the queries with IDs larger than the target IDs
+    // produce overlaps. This holds only when the query and the target are the same DB, and the
+    // end-anchored pass keeps the other half, so it needs all pairs.
+    const bool skipSymmetric = settings.SkipSymmetricOverlaps &&
+                               settings.QueryDBPrefix == settings.TargetDBPrefix &&
+                               settings.EndSeedDistance == 0;
+    const std::vector<OverlapTask> plan =
+        PlanOverlapTasks(*inputs.targetSeqDBCache, *inputs.querySeqDBCache,
+                         settings.WorkQueryBlocks, skipSymmetric);
+
+    OverlapTaskQueue queue(settings.WorkDir, plan, settings.WorkLease);
+    PBLOG_INFO << "Work folder '" << settings.WorkDir << "': " << queue.NumTasks()
+               << " tasks, " << queue.NumDone() << " already done.";
+
+    // The tasks held by the other workers are reclaimed if their leases expire.
+    const auto pollInterval =
+        std::chrono::seconds(std::min(10, std::max(1, settings.WorkLease / 4)));
+    OverlapTask task;
+    while (true) {
+        if (queue.Claim(-1, task)) {
+            WorkQueueRangeSource querySource(queue, task);
+            RunTargetBlock(settings, inputs, task.targetBlockId, querySource, progress);
+            continue;
+        }
+        if (queue.IsFinished()) {
+            break;
         }
+        std::this_thread::sleep_for(pollInterval);
+    }
+    PBLOG_INFO << "All " << queue.NumTasks() << " tasks are done.";
+}
+
+int OverlapHifiWorkflow::Runner(const PacBio::CLI_v2::Results& options)
+{
+    OverlapHifiSettings settings{options};
+
+    const OverlapHifiInputs inputs = LoadOverlapHifiInputs(settings);
+
+    // One reporter for the whole run. A worker of the work queue does not know in advance
+    // which tasks it will process, so it reports only the rates.
+    ProgressReporter progress("ovl-hifi", settings.ProgressInterval, settings.ProgressJSON);
+
+    if (settings.WorkDir.empty() == false) {
+        progress.Start();
+        RunWorkQueue(settings, inputs, progress);
+        progress.Stop();
+        return EXIT_SUCCESS;
+    }
+
+    const int32_t queryBlockEndId = GetQueryBlockEndId(settings, *inputs.querySeqDBCache);
+    int64_t totalQueries = 0;
+    int64_t totalBases = 0;
+    for (int32_t blockId = settings.QueryBlockStartId; blockId < queryBlockEndId; ++blockId) {
+        const auto& blockLine = inputs.querySeqDBCache->GetBlockLine(blockId);
+        totalQueries += blockLine.Span();
+        totalBases += blockLine.numBases;
     }
-    ttMap.Stop();
-    PBLOG_INFO << "Mapped all query blocks in " << ttMap.GetSecs() << " sec.";
+    progress.SetTotals(totalQueries, totalBases);
+    progress.Start();
+
+    SingleQueryRangeSource querySource(settings.QueryBlockStartId, queryBlockEndId);
+    RunTargetBlock(settings, inputs, settings.TargetBlockId, querySource, progress);
+    progress.Stop();
 
     return EXIT_SUCCESS;
 }
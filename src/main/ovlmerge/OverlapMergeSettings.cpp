@@ -0,0 +1,134 @@
+// Author: Ivan Sovic
+
+#include "OverlapMergeSettings.h"
+#include <pacbio/Version.h>
+
+namespace PacBio {
+namespace Pancake {
+namespace OptionNames {
+
+// clang-format off
+
+const CLI_v2::PositionalArgument OutputFile {
+R"({
+    "name" : "out_fn",
+    "description" : "Output file for the merged overlaps."
+})"};
+
+const CLI_v2::PositionalArgument InputFiles {
+R"({
+    "name" : "<input.m4/ovl/fofn> [...]",
+    "description" : "One or more overlap files in the M4 or IPA formats, or FOFNs of them. The formats should not be mixed."
+})"};
+
+const CLI_v2::Option MaxMemory{
+R"({
+    "names" : ["max-memory"],
+    "description" : "Memory budget in megabytes for the overlaps sorted in memory. Overlaps above this are sorted in runs and written to temporary files, which are merged at the end. Has to be > 0.0.",
+    "type" : "float"
+})", OverlapMergeSettings::Defaults::MaxMemory};
+
+const CLI_v2::Option TmpDir{
+R"({
+    "names" : ["tmp-dir"],
+    "description" : "Directory for the temporary sorted runs. If not specified, the runs are written next to the output file.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option Dedup{
+R"({
+    "names" : ["dedup"],
+    "description" : "Keep only the best overlap of each pair of reads, by score and then identity. This removes the duplicate A-B and B-A overlaps produced by the symmetric query and target block jobs.",
+    "type" : "bool"
+})", OverlapMergeSettings::Defaults::Dedup};
+
+const CLI_v2::Option BestN{
+R"({
+    "names" : ["bestn"],
+    "description" : "Output only best N overlaps of each A-read, across all inputs. Value 0 outputs all overlaps.",
+    "type" : "int"
+})", OverlapMergeSettings::Defaults::BestN};
+
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed input files and bytes, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", OverlapMergeSettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+// clang-format on
+
+}  // namespace OptionNames
+
+OverlapMergeSettings::OverlapMergeSettings() = default;
+
+OverlapMergeSettings::OverlapMergeSettings(const PacBio::CLI_v2::Results& options)
+    : OutputFile{options[OptionNames::OutputFile]}
+    , InputFiles{options[OptionNames::InputFiles]}
+    , NumThreads{options.NumThreads()}
+    , MaxMemory{options[OptionNames::MaxMemory]}
+    , TmpDir{options[OptionNames::TmpDir]}
+    , Dedup{options[OptionNames::Dedup]}
+    , BestN{options[OptionNames::BestN]}
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
+{
+    // Allow multiple positional input arguments.
+    const auto& files = options.PositionalArguments();
+    if (files.size() < 2)
+        throw std::runtime_error{"Not enough input files specified, at least one required."};
+    OutputFile = files[0];
+    InputFiles.clear();
+    for (size_t i = 1; i < files.size(); ++i)
+        InputFiles.push_back(files[i]);
+
+    if (MaxMemory <= 0.0f) {
+        throw std::runtime_error("The memory budget needs to be a positive value.");
+    }
+    if (BestN < 0) {
+        throw std::runtime_error("The bestn value cannot be negative.");
+    }
+
+    // Convert the memory budget from MB to bytes.
+    MaxMemory *= (1024 * 1024);
+}
+
+PacBio::CLI_v2::Interface OverlapMergeSettings::CreateCLI()
+{
+    PacBio::CLI_v2::Interface i{"pancake ovl-merge",
+                                "Merges the overlaps of multiple jobs into one file, grouped by "
+                                "the A-read, within a bounded memory.",
+                                PacBio::Pancake::PancakeFormattedVersion()};
+
+    // clang-format off
+    i.AddOptionGroup("Algorithm Options", {
+        OptionNames::Dedup,
+        OptionNames::BestN,
+    });
+    i.AddOptionGroup("Memory Options", {
+        OptionNames::MaxMemory,
+        OptionNames::TmpDir,
+    });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
+    });
+    i.AddPositionalArguments({
+        OptionNames::OutputFile,
+        OptionNames::InputFiles,
+    });
+
+    // clang-format on
+    return i;
+}
+}  // namespace Pancake
+}  // namespace PacBio
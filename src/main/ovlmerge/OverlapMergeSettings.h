@@ -0,0 +1,44 @@
+// Authors: Ivan Sovic
+
+#ifndef PANCAKE_OVERLAP_MERGE_SETTINGS_H
+#define PANCAKE_OVERLAP_MERGE_SETTINGS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <pbcopper/cli2/CLI.h>
+
+namespace PacBio {
+namespace Pancake {
+
+struct OverlapMergeSettings
+{
+    struct Defaults
+    {
+        static const size_t NumThreads = 1;
+        static constexpr float MaxMemory = 1000.0f;
+        static const bool Dedup = false;
+        static const int32_t BestN = 0;
+        static constexpr double ProgressInterval = 60.0;
+    };
+
+    std::string OutputFile;
+    std::vector<std::string> InputFiles;
+    size_t NumThreads = Defaults::NumThreads;
+    float MaxMemory = Defaults::MaxMemory;
+    std::string TmpDir;
+    bool Dedup = Defaults::Dedup;
+    int32_t BestN = Defaults::BestN;
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
+
+    OverlapMergeSettings();
+    OverlapMergeSettings(const PacBio::CLI_v2::Results& options);
+    static PacBio::CLI_v2::Interface CreateCLI();
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_OVERLAP_MERGE_SETTINGS_H
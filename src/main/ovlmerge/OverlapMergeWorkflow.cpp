@@ -0,0 +1,299 @@
+// Authors: Ivan Sovic
+
+#include "OverlapMergeWorkflow.h"
+#include "OverlapMergeSettings.h"
+#include <pacbio/pancake/OverlapMerge.h>
+#include <pacbio/util/FileIO.h>
+#include <pacbio/util/Progress.h>
+#include <pacbio/util/TicToc.h>
+#include <pbcopper/logging/LogLevel.h>
+#include <pbcopper/logging/Logging.h>
+#include <pbcopper/parallel/FireAndForget.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+// Maximum number of runs which are merged at once. If there are more runs, they are first merged
+// into larger runs, to limit the number of open files.
+static const int32_t MAX_MERGE_FAN_IN = 256;
+
+void SortAndWriteRun(std::vector<OverlapLine>& lines, OverlapSortOrder order,
+                     const std::string& runPath)
+{
+    SortOverlapLines(lines, order);
+    WriteOverlapLines(lines, runPath);
+    std::vector<OverlapLine>().swap(lines);
+}
+
+/*
+ * Collects the overlap lines into sorted runs on disk. The memory budget is split into one
+ * chunk per thread. Once all chunks are full, they are sorted and written in parallel.
+ * The run files are removed when the object is destroyed.
+*/
+class OverlapRunGenerator
+{
+public:
+    OverlapRunGenerator(OverlapSortOrder order, int64_t maxMemory, int32_t numThreads,
+                        const std::string& runPrefix)
+        : order_(order)
+        , numThreads_(std::max(1, numThreads))
+        , maxChunkMemory_(std::max<int64_t>(1, maxMemory / numThreads_))
+        , runPrefix_(runPrefix)
+        , chunks_(numThreads_)
+    {
+    }
+
+    ~OverlapRunGenerator()
+    {
+        for (const auto& runPath : runPaths_) {
+            std::remove(runPath.c_str());
+        }
+    }
+
+    void Add(OverlapLine&& line)
+    {
+        currChunkMemory_ += line.MemoryUsage();
+        chunks_[currChunk_].emplace_back(std::move(line));
+        ++numLines_;
+        if (currChunkMemory_ < maxChunkMemory_) {
+            return;
+        }
+        currChunkMemory_ = 0;
+        ++currChunk_;
+        if (currChunk_ == numThreads_) {
+            WriteChunks_();
+        }
+    }
+
+    /// \brief Writes the remaining lines, and returns a merger over all runs.
+    std::unique_ptr<OverlapRunMerger> Merge()
+    {
+        WriteChunks_();
+
+        // Limit the number of runs open at once.
+        while (static_cast<int32_t>(runPaths_.size()) > MAX_MERGE_FAN_IN) {
+            std::vector<std::string> mergedPaths;
+            for (size_t start = 0; start < runPaths_.size(); start += MAX_MERGE_FAN_IN) {
+                const size_t end = std::min(runPaths_.size(), start + MAX_MERGE_FAN_IN);
+                const std::vector<std::string> group(runPaths_.begin() + start,
+                                                     runPaths_.begin() + end);
+                const std::string mergedPath = NextRunPath_();
+                {
+                    OverlapRunMerger merger(group, order_);
+                    std::ofstream ofs(mergedPath);
+                    if (ofs.is_open() == false) {
+                        throw std::runtime_error("Could not open file '" + mergedPath +
+                                                 "' for writing!");
+                    }
+                    OverlapLine line;
+                    while (merger.GetNext(line)) {
+                        ofs << line.line << '\n';
+                    }
+                }
+                for (const auto& runPath : group) {
+                    std::remove(runPath.c_str());
+                }
+                mergedPaths.emplace_back(mergedPath);
+            }
+            runPaths_ = mergedPaths;
+        }
+
+        return std::make_unique<OverlapRunMerger>(runPaths_, order_);
+    }
+
+    int64_t NumLines() const { return numLines_; }
+    int32_t NumRuns() const { return runPaths_.size(); }
+
+private:
+    OverlapSortOrder order_;
+    int32_t numThreads_;
+    int64_t maxChunkMemory_;
+    std::string runPrefix_;
+    std::vector<std::vector<OverlapLine>> chunks_;
+    int32_t currChunk_ = 0;
+    int64_t currChunkMemory_ = 0;
+    int64_t numLines_ = 0;
+    int32_t numRunsWritten_ = 0;
+    std::vector<std::string> runPaths_;
+
+    std::string NextRunPath_()
+    {
+        const std::string runPath = runPrefix_ + "." + std::to_string(numRunsWritten_) + ".tmp";
+        ++numRunsWritten_;
+        return runPath;
+    }
+
+    void WriteChunks_()
+    {
+        PacBio::Parallel::FireAndForget faf(numThreads_);
+        for (auto& chunk : chunks_) {
+            if (chunk.empty()) {
+                continue;
+            }
+            runPaths_.emplace_back(NextRunPath_());
+            faf.ProduceWith(SortAndWriteRun, std::ref(chunk), order_, runPaths_.back());
+        }
+        faf.Finalize();
+        currChunk_ = 0;
+        currChunkMemory_ = 0;
+    }
+};
+
+void CollectOverlapFiles(const std::vector<std::string>& inFiles,
+                         std::vector<std::string>& retFiles)
+{
+    for (const auto& inFile : inFiles) {
+        if (FormatIsFofn(inFile)) {
+            CollectOverlapFiles(LoadLinesToVector(inFile), retFiles);
+        } else {
+            retFiles.emplace_back(inFile);
+        }
+    }
+}
+
+int64_t GetFileSize(const std::string& inFile)
+{
+    std::ifstream ifs(inFile, std::ios::binary | std::ios::ate);
+    if (ifs.is_open() == false) {
+        throw std::runtime_error("Could not open overlap file '" + inFile + "'!");
+    }
+    return ifs.tellg();
+}
+
+/*
+ * The progress counts the input files as queries and the bytes read from them as bases.
+*/
+void LoadOverlapFile(const std::string& inFile, OverlapRunGenerator& runGenerator,
+                     ProgressCounters& counters)
+{
+    std::ifstream ifs(inFile);
+    if (ifs.is_open() == false) {
+        throw std::runtime_error("Could not open overlap file '" + inFile + "'!");
+    }
+    std::string line;
+    while (std::getline(ifs, line)) {
+        counters.AddBases(line.size() + 1);
+        if (line.empty()) {
+            continue;
+        }
+        runGenerator.Add(ParseOverlapLine(std::move(line)));
+    }
+    counters.AddQueries(1);
+}
+
+std::string ComposeRunPrefix(const OverlapMergeSettings& settings)
+{
+    if (settings.TmpDir.empty()) {
+        return settings.OutputFile;
+    }
+    const size_t pos = settings.OutputFile.find_last_of('/');
+    const std::string outName =
+        (pos == std::string::npos) ? settings.OutputFile : settings.OutputFile.substr(pos + 1);
+    return settings.TmpDir + "/" + outName;
+}
+
+int OverlapMergeWorkflow::Runner(const PacBio::CLI_v2::Results& options)
+{
+    OverlapMergeSettings settings{options};
+
+    std::vector<std::string> inFiles;
+    CollectOverlapFiles(settings.InputFiles, inFiles);
+
+    ProgressReporter progress("ovl-merge", settings.ProgressInterval, settings.ProgressJSON);
+    int64_t totalBytes = 0;
+    for (const auto& inFile : inFiles) {
+        totalBytes += GetFileSize(inFile);
+    }
+    progress.SetTotals(inFiles.size(), totalBytes);
+    progress.Start();
+
+    const std::string runPrefix = ComposeRunPrefix(settings);
+    const int64_t maxMemory = settings.MaxMemory;
+
+    // The final order groups the overlaps by the A-read.
+    OverlapRunGenerator readRuns(OverlapSortOrder::ByRead, maxMemory, settings.NumThreads,
+                                 runPrefix + ".read");
+
+    TicToc ttSort;
+    int64_t numDuplicates = 0;
+    if (settings.Dedup) {
+        // First sort by the pair of reads, so that the duplicates are adjacent and the best
+        // overlap of each pair comes first.
+        OverlapRunGenerator pairRuns(OverlapSortOrder::ByPair, maxMemory, settings.NumThreads,
+                                     runPrefix + ".pair");
+        for (const auto& inFile : inFiles) {
+            LoadOverlapFile(inFile, pairRuns, progress.Counters());
+        }
+        PBLOG_INFO << "Loaded " << pairRuns.NumLines() << " overlaps from " << inFiles.size()
+                   << " files.";
+
+        const auto merger = pairRuns.Merge();
+        OverlapLine line;
+        OverlapLine prevLine;
+        bool isFirst = true;
+        while (merger->GetNext(line)) {
+            if (isFirst == false && ComparePair(line, prevLine) == 0) {
+                ++numDuplicates;
+                continue;
+            }
+            isFirst = false;
+            prevLine = line;
+            readRuns.Add(std::move(line));
+        }
+        PBLOG_INFO << "Removed " << numDuplicates << " duplicate overlaps of the same pairs.";
+
+    } else {
+        for (const auto& inFile : inFiles) {
+            LoadOverlapFile(inFile, readRuns, progress.Counters());
+        }
+        PBLOG_INFO << "Loaded " << readRuns.NumLines() << " overlaps from " << inFiles.size()
+                   << " files.";
+    }
+
+    std::ofstream ofs(settings.OutputFile);
+    if (ofs.is_open() == false) {
+        throw std::runtime_error("Could not open output file '" + settings.OutputFile + "'!");
+    }
+
+    // The overlaps of each A-read come sorted from the best to the worst.
+    const auto merger = readRuns.Merge();
+    PBLOG_INFO << "Merging " << readRuns.NumRuns() << " sorted runs.";
+    int64_t numWritten = 0;
+    int32_t numInGroup = 0;
+    OverlapLine line;
+    OverlapLine prevLine;
+    while (merger->GetNext(line)) {
+        if (numWritten == 0 || CompareAName(line, prevLine) != 0) {
+            numInGroup = 0;
+        }
+        ++numInGroup;
+        if (settings.BestN > 0 && numInGroup > settings.BestN) {
+            continue;
+        }
+        ofs << line.line << '\n';
+        ++numWritten;
+        progress.Counters().AddOverlaps(1);
+        prevLine = std::move(line);
+    }
+    ofs.close();
+    if (ofs.fail()) {
+        throw std::runtime_error("Could not write the overlaps to file '" + settings.OutputFile +
+                                 "'!");
+    }
+    ttSort.Stop();
+    progress.Stop();
+
+    PBLOG_INFO << "Wrote " << numWritten << " overlaps in " << ttSort.GetSecs() << " sec.";
+
+    return EXIT_SUCCESS;
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
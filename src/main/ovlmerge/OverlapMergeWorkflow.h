@@ -0,0 +1,19 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_OVERLAP_MERGE_WORKFLOW_H
+#define PANCAKE_OVERLAP_MERGE_WORKFLOW_H
+
+#include <pbcopper/cli2/CLI.h>
+
+namespace PacBio {
+namespace Pancake {
+
+struct OverlapMergeWorkflow
+{
+    static int Runner(const PacBio::CLI_v2::Results& options);
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_OVERLAP_MERGE_WORKFLOW_H
@@ -79,6 +79,53 @@ R"({
     "description" : "Do not produce seeds from the reverse complement strand."
 })", SeedDBSettings::Defaults::NoRevCmp};
 
+const CLI_v2::Option Scheme{
+R"({
+    "names" : ["seeding"],
+    "type" : "string",
+    "default" : "minimizer",
+    "description" : "Seeding scheme: minimizer, open-syncmer, closed-syncmer, randstrobe. Syncmers are selected by the position of their smallest s-mer and do not depend on the neighbouring kmers. Randstrobes link pairs of open syncmers, which makes them more robust to indels. The window size is used only by minimizers."
+})", std::string("minimizer")};
+
+const CLI_v2::Option SyncmerSize{
+R"({
+    "names" : ["syncmer-size"],
+    "type" : "int",
+    "default" : 12,
+    "description" : "Length of the s-mers used to select syncmers and randstrobes. For open syncmers and randstrobes, the difference between the kmer size and this value needs to be even. The density of the seeds is roughly 1 / (k - s + 1)."
+})", SeedDBSettings::Defaults::SyncmerSize};
+
+const CLI_v2::Option StrobeMinDist{
+R"({
+    "names" : ["strobe-min-dist"],
+    "type" : "int",
+    "default" : 20,
+    "description" : "Minimum distance between the two kmers of a randstrobe."
+})", SeedDBSettings::Defaults::StrobeMinDist};
+
+const CLI_v2::Option StrobeMaxDist{
+R"({
+    "names" : ["strobe-max-dist"],
+    "type" : "int",
+    "default" : 100,
+    "description" : "Maximum distance between the two kmers of a randstrobe. The sum of this value and the kmer size can be at most 255."
+})", SeedDBSettings::Defaults::StrobeMaxDist};
+
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed queries and bases, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", SeedDBSettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
 // clang-format on
 
 }  // namespace OptionNames
@@ -96,7 +143,13 @@ SeedDBSettings::SeedDBSettings(const PacBio::CLI_v2::Results& options)
                      options[OptionNames::UseHPC],
                      options[OptionNames::UseHPCForSeedsOnly],
                      options[OptionNames::MaxHPCLen],
-                     !options[OptionNames::NoRevCmp]}
+                     !options[OptionNames::NoRevCmp],
+                     SeedingSchemeFromString(options[OptionNames::Scheme]),
+                     options[OptionNames::SyncmerSize],
+                     options[OptionNames::StrobeMinDist],
+                     options[OptionNames::StrobeMaxDist]}
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
 {
 }
 
@@ -115,6 +168,14 @@ PacBio::CLI_v2::Interface SeedDBSettings::CreateCLI()
         OptionNames::UseHPCForSeedsOnly,
         OptionNames::MaxHPCLen,
         OptionNames::NoRevCmp,
+        OptionNames::Scheme,
+        OptionNames::SyncmerSize,
+        OptionNames::StrobeMinDist,
+        OptionNames::StrobeMaxDist,
+    });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
     });
     i.AddPositionalArguments({
         OptionNames::InputFile,
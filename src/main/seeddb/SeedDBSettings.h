@@ -26,6 +26,11 @@ struct SeedDBSettings
         static const bool UseHPCForSeedsOnly = false;
         static const int32_t MaxHPCLen = 10;
         static const bool NoRevCmp = false;
+        static const SeedingScheme Scheme = SeedingScheme::Minimizer;
+        static const int32_t SyncmerSize = 12;
+        static const int32_t StrobeMinDist = 20;
+        static const int32_t StrobeMaxDist = 100;
+        static constexpr double ProgressInterval = 60.0;
     };
 
     std::string InputFile;
@@ -35,7 +40,10 @@ struct SeedDBSettings
     SeedDBParameters SeedParameters{
         Defaults::KmerSize, Defaults::MinimizerWindow,    Defaults::Spacing,
         Defaults::UseHPC,   Defaults::UseHPCForSeedsOnly, Defaults::MaxHPCLen,
-        !Defaults::NoRevCmp};
+        !Defaults::NoRevCmp, Defaults::Scheme,            Defaults::SyncmerSize,
+        Defaults::StrobeMinDist, Defaults::StrobeMaxDist};
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
 
     SeedDBSettings();
     SeedDBSettings(const PacBio::CLI_v2::Results& options);
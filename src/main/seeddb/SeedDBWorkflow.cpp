@@ -7,6 +7,7 @@
 #include <pacbio/pancake/SeedDBWriter.h>
 #include <pacbio/pancake/SeqDBIndexCache.h>
 #include <pacbio/pancake/SeqDBReaderCachedBlock.h>
+#include <pacbio/util/Progress.h>
 #include "SeedDBSettings.h"
 
 #include <pbcopper/parallel/FireAndForget.h>
@@ -18,9 +19,9 @@ namespace PacBio {
 namespace Pancake {
 namespace SeedDB {
 
-void Worker(const std::vector<FastaSequenceCached>& records, const SeedDBSettings& settings,
-            int32_t start, int32_t end, int32_t startAbs,
-            std::vector<std::vector<PacBio::Pancake::Int128t>>& seeds)
+void Worker(const std::vector<FastaSequenceCached>& records, const SeqDBIndexCache& seqDBCache,
+            const SeedDBSettings& settings, int32_t start, int32_t end, int32_t startAbs,
+            std::vector<std::vector<PacBio::Pancake::Int128t>>& seeds, ProgressCounters& counters)
 {
     const auto& sp = settings.SeedParameters;
 
@@ -28,13 +29,16 @@ void Worker(const std::vector<FastaSequenceCached>& records, const SeedDBSetting
         const auto& record = records[i];
         const uint8_t* seq = reinterpret_cast<const uint8_t*>(record.c_str());
         int32_t seqLen = record.size();
-        int rv = GenerateMinimizers(seeds[i], seq, seqLen, 0, record.Id(), sp.KmerSize,
-                                    sp.MinimizerWindow, sp.Spacing, sp.UseRC, sp.UseHPCForSeedsOnly,
-                                    sp.MaxHPCLen);
+        // Circular sequences also get the seeds which span the origin.
+        const bool isCircular = seqDBCache.GetSeqLine(record.Id()).isCircular;
+        int rv = isCircular ? GenerateSeedsCircular(seeds[i], seq, seqLen, 0, record.Id(), sp)
+                            : GenerateSeeds(seeds[i], seq, seqLen, 0, record.Id(), sp);
         if (rv)
-            throw std::runtime_error("Generating minimizers failed, startAbs = " +
+            throw std::runtime_error("Generating seeds failed, startAbs = " +
                                      std::to_string(startAbs) + ", return code = " +
                                      std::to_string(rv));
+        counters.AddQueries(1);
+        counters.AddBases(seqLen);
     }
 }
 
@@ -52,6 +56,14 @@ int SeedDBWorkflow::Runner(const PacBio::CLI_v2::Results& options)
     int32_t numBlocks = seqDBCache->blockLines.size();
     int32_t absOffset = 0;
 
+    ProgressReporter progress("seeddb", settings.ProgressInterval, settings.ProgressJSON);
+    int64_t totalBases = 0;
+    for (const auto& blockLine : seqDBCache->blockLines) {
+        totalBases += blockLine.numBases;
+    }
+    progress.SetTotals(seqDBCache->seqLines.size(), totalBases);
+    progress.Start();
+
     auto writer = PacBio::Pancake::CreateSeedDBWriter(settings.OutputPrefix, settings.SplitBlocks,
                                                       settings.SeedParameters);
 
@@ -64,8 +76,9 @@ int SeedDBWorkflow::Runner(const PacBio::CLI_v2::Results& options)
         std::vector<std::vector<PacBio::Pancake::Int128t>> results(numRecords);
         PacBio::Parallel::FireAndForget faf(settings.NumThreads);
         for (int32_t i = 0; i < numRecords; ++i) {
-            faf.ProduceWith(Worker, std::cref(reader.records()), std::cref(settings), i, i + 1,
-                            i + absOffset, std::ref(results));
+            faf.ProduceWith(Worker, std::cref(reader.records()), std::cref(*seqDBCache),
+                            std::cref(settings), i, i + 1, i + absOffset, std::ref(results),
+                            std::ref(progress.Counters()));
         }
         faf.Finalize();
 
@@ -76,6 +89,8 @@ int SeedDBWorkflow::Runner(const PacBio::CLI_v2::Results& options)
         absOffset += numRecords;
     }
 
+    progress.Stop();
+
     return EXIT_SUCCESS;
 }
 
@@ -49,6 +49,29 @@ R"({
     "description" : "Write seeds for each block into a separate file."
 })", SeqDBSettings::Defaults::SplitBlocks};
 
+const CLI_v2::Option CircularList{
+R"({
+    "names" : ["circular-list"],
+    "description" : "Path to a file with the names of circular sequences (e.g. plasmids, organelles), one per line. These sequences are marked as circular in the DB, so that the seeding and the overlapping can handle the alignments which wrap around their origin.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed queries and bases, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", SeqDBSettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
 // clang-format on
 
 }  // namespace OptionNames
@@ -63,6 +86,9 @@ SeqDBSettings::SeqDBSettings(const PacBio::CLI_v2::Results& options)
     , BufferSize{options[OptionNames::BufferSize]}
     , BlockSize{options[OptionNames::BlockSize]}
     , SplitBlocks{options[OptionNames::SplitBlocks]}
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
+    , CircularList{options[OptionNames::CircularList]}
 {
     // Allow multiple positional input arguments.
     const auto& files = options.PositionalArguments();
@@ -95,6 +121,11 @@ PacBio::CLI_v2::Interface SeqDBSettings::CreateCLI()
         OptionNames::BufferSize,
         OptionNames::BlockSize,
         OptionNames::SplitBlocks,
+        OptionNames::CircularList,
+    });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
     });
     i.AddPositionalArguments({
         OptionNames::OutputPrefix,
@@ -20,6 +20,7 @@ struct SeqDBSettings
         static constexpr float BufferSize = 1000.0f;
         static constexpr float BlockSize = 1000.0f;
         static const bool SplitBlocks = false;
+        static constexpr double ProgressInterval = 60.0;
     };
 
     std::string OutputPrefix;
@@ -29,6 +30,9 @@ struct SeqDBSettings
     float BufferSize = Defaults::BufferSize;
     float BlockSize = Defaults::BlockSize;
     bool SplitBlocks = Defaults::SplitBlocks;
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
+    std::string CircularList;
 
     SeqDBSettings();
     SeqDBSettings(const PacBio::CLI_v2::Results& options);
@@ -3,15 +3,19 @@
 #include "SeqDBWorkflow.h"
 #include <pacbio/pancake/SeqDBWriter.h>
 #include <pacbio/util/FileIO.h>
+#include <pacbio/util/Progress.h>
 #include <pbbam/BamReader.h>
 #include <pbbam/DataSet.h>
 #include <pbbam/FastaReader.h>
 #include <pbbam/FastqReader.h>
 #include <pbbam/PbiIndexedBamReader.h>
+#include <pbcopper/logging/LogLevel.h>
+#include <pbcopper/logging/Logging.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include "SeqDBSettings.h"
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <iostream>
@@ -31,6 +35,28 @@ int SeqDBWorkflow::Runner(const PacBio::CLI_v2::Results& options)
     std::vector<std::pair<SequenceFormat, std::string>> inputFiles =
         ExpandInputFileList(settings.InputFiles, false);
 
+    // Names of the sequences to mark as circular.
+    std::unordered_set<std::string> circularNames;
+    if (settings.CircularList.empty() == false) {
+        for (const auto& name : LoadLinesToVector(settings.CircularList)) {
+            if (name.empty() == false) {
+                circularNames.emplace(name);
+            }
+        }
+    }
+    int32_t numCircular = 0;
+
+    // The total amount of input is not known up front, so the reports show only the rates.
+    ProgressReporter progress("seqdb", settings.ProgressInterval, settings.ProgressJSON);
+    auto AddSequence = [&](const std::string& name, const std::string& bases) {
+        const bool isCircular = circularNames.count(name) > 0;
+        numCircular += isCircular;
+        writer->AddSequence(name, bases, isCircular);
+        progress.Counters().AddQueries(1);
+        progress.Counters().AddBases(bases.size());
+    };
+    progress.Start();
+
     for (const auto& inFilePair : inputFiles) {
         const auto& inFmt = inFilePair.first;
         const auto& inFile = inFilePair.second;
@@ -38,18 +64,18 @@ int SeqDBWorkflow::Runner(const PacBio::CLI_v2::Results& options)
             BAM::FastaReader inReader{inFile};
             BAM::FastaSequence record;
             while (inReader.GetNext(record)) {
-                writer->AddSequence(record.Name(), record.Bases());
+                AddSequence(record.Name(), record.Bases());
             }
         } else if (inFmt == SequenceFormat::Fastq) {
             BAM::FastqReader inReader{inFile};
             BAM::FastqSequence record;
             while (inReader.GetNext(record)) {
-                writer->AddSequence(record.Name(), record.Bases());
+                AddSequence(record.Name(), record.Bases());
             }
         } else if (inFmt == SequenceFormat::Bam) {
             BAM::BamReader inputBamReader{inFile};
             for (const auto& bam : inputBamReader)
-                writer->AddSequence(bam.FullName(), bam.Sequence());
+                AddSequence(bam.FullName(), bam.Sequence());
         } else if (inFmt == SequenceFormat::Xml) {
             BAM::DataSet dataset{inFile};
             const PacBio::BAM::PbiIndexCache pbiCache = PacBio::BAM::MakePbiIndexCache(dataset);
@@ -59,7 +85,7 @@ int SeqDBWorkflow::Runner(const PacBio::CLI_v2::Results& options)
                 const std::shared_ptr<PacBio::BAM::PbiRawData>& pbiIndex = pbiCache->at(fileId);
                 PacBio::BAM::PbiIndexedBamReader reader{filter, bam, pbiIndex};
                 for (const auto& record : reader) {
-                    writer->AddSequence(record.FullName(), record.Sequence());
+                    AddSequence(record.FullName(), record.Sequence());
                 }
                 ++fileId;
             }
@@ -68,6 +94,13 @@ int SeqDBWorkflow::Runner(const PacBio::CLI_v2::Results& options)
         }
     }
 
+    progress.Stop();
+
+    if (numCircular < static_cast<int32_t>(circularNames.size())) {
+        PBLOG_WARN << "Only " << numCircular << " out of " << circularNames.size()
+                   << " sequences from the circular list were found in the input.";
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -81,6 +81,21 @@ R"({
     "description" : "Write a run-length-encoded file alongside to the output file. The RLE file contains conversion coordinates from the HPC space to the original space instead of the run-length-encoding. This option does not write the HPC sequence, for that please specify '--user-hpc'."
 })", SeqFetchSettings::Defaults::UseRLE};
 
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed queries and bases, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", SeqFetchSettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
 // clang-format on
 
 }  // namespace OptionNames
@@ -108,6 +123,8 @@ SeqFetchSettings::SeqFetchSettings(const PacBio::CLI_v2::Results& options)
     , WriteIds(options[OptionNames::WriteIds])
     , UseHPC(options[OptionNames::UseHPC])
     , UseRLE(options[OptionNames::UseRLE])
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
 {
     // Allow multiple positional input arguments.
     const auto& files = options.PositionalArguments();
@@ -150,6 +167,10 @@ PacBio::CLI_v2::Interface SeqFetchSettings::CreateCLI()
         OptionNames::UseHPC,
         OptionNames::UseRLE,
     });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
+    });
     i.AddPositionalArguments({
         OptionNames::OutputFile,
         OptionNames::InputFetchListFile,
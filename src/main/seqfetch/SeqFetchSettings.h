@@ -27,6 +27,7 @@ struct SeqFetchSettings
         static const bool WriteIds = false;
         static const bool UseHPC = false;
         static const bool UseRLE = false;
+        static constexpr double ProgressInterval = 60.0;
     };
 
     std::string OutputFile;
@@ -39,6 +40,8 @@ struct SeqFetchSettings
     bool WriteIds = Defaults::WriteIds;
     bool UseHPC = Defaults::UseHPC;
     bool UseRLE = Defaults::UseRLE;
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
 
     SeqFetchSettings();
     SeqFetchSettings(const PacBio::CLI_v2::Results& options);
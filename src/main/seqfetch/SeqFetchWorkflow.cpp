@@ -2,6 +2,7 @@
 
 #include "SeqFetchWorkflow.h"
 #include <pacbio/util/FileIO.h>
+#include <pacbio/util/Progress.h>
 #include "SeqFetchSettings.h"
 
 #include <algorithm>
@@ -63,7 +64,7 @@ void WriteRLE(std::ostream& os, const std::string& seqName, std::vector<int32_t>
 void WriteSeqAndRLE(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::ostream>& osRlePtr,
                     const std::string& seqName, const std::string& seq, const std::string& quals,
                     char dummyQV, bool useProvidedQuals, const SeqFetchOutFormat& outFmt,
-                    bool useHPC, bool useRLE)
+                    bool useHPC, bool useRLE, ProgressCounters& counters)
 {
     std::string seqRLE;
     std::vector<int32_t> seqToHPCCoords;
@@ -86,12 +87,16 @@ void WriteSeqAndRLE(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::o
     if (useRLE) {
         WriteRLE(*osRlePtr, seqName, hpcToSeqCoords);
     }
+
+    counters.AddQueries(1);
+    counters.AddBases(seq.size());
 }
 
 void FetchFromFasta(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::ostream>& osRlePtr,
                     std::vector<std::string>& foundSeqs, const std::string& inFile,
                     const std::set<std::string>& remainingToFind, const char dummyQV,
-                    const PacBio::Pancake::SeqFetchOutFormat& outFormat, bool useHPC, bool useRLE)
+                    const PacBio::Pancake::SeqFetchOutFormat& outFormat, bool useHPC, bool useRLE,
+                    ProgressCounters& counters)
 {
     BAM::IndexedFastaReader reader{inFile};
     PBLOG_INFO << "Num sequences in file: " << reader.NumSequences();
@@ -103,7 +108,7 @@ void FetchFromFasta(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::o
         std::string seq = reader.Subsequence(seqName.c_str());
         std::string qual;
         WriteSeqAndRLE(osPtr, osRlePtr, seqName, seq, qual, dummyQV, false, outFormat, useHPC,
-                       useRLE);
+                       useRLE, counters);
         foundSeqs.emplace_back(seqName);
     }
 }
@@ -111,7 +116,8 @@ void FetchFromFasta(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::o
 void FetchFromFastq(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::ostream>& osRlePtr,
                     std::vector<std::string>& foundSeqs, const std::string& inFile,
                     const std::set<std::string>& remainingToFind, const char dummyQV,
-                    const PacBio::Pancake::SeqFetchOutFormat& outFormat, bool useHPC, bool useRLE)
+                    const PacBio::Pancake::SeqFetchOutFormat& outFormat, bool useHPC, bool useRLE,
+                    ProgressCounters& counters)
 {
     BAM::IndexedFastqReader reader{inFile};
     PBLOG_INFO << "Num sequences in file: " << reader.NumSequences();
@@ -127,14 +133,15 @@ void FetchFromFastq(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::o
         std::string qual = std::get<1>(seqQualPair).Fastq();
         foundSeqs.emplace_back(seqName);
         WriteSeqAndRLE(osPtr, osRlePtr, seqName, seq, qual, dummyQV, true, outFormat, useHPC,
-                       useRLE);
+                       useRLE, counters);
     }
 }
 
 void FetchFromBam(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::ostream>& osRlePtr,
                   std::vector<std::string>& foundSeqs, const std::string& inFile,
                   const std::set<std::string>& remainingToFind, const char dummyQV,
-                  const PacBio::Pancake::SeqFetchOutFormat& outFormat, bool useHPC, bool useRLE)
+                  const PacBio::Pancake::SeqFetchOutFormat& outFormat, bool useHPC, bool useRLE,
+                  ProgressCounters& counters)
 {
     PacBio::BAM::BamFile bamFile(inFile);
     bamFile.EnsurePacBioIndexExists();
@@ -146,7 +153,7 @@ void FetchFromBam(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::ost
     for (auto record : query) {
         auto quals = record.Qualities().Fastq();
         WriteSeqAndRLE(osPtr, osRlePtr, record.FullName(), record.Sequence(), quals, dummyQV,
-                       quals.size() > 0, outFormat, useHPC, useRLE);
+                       quals.size() > 0, outFormat, useHPC, useRLE, counters);
         foundSeqs.emplace_back(record.FullName());
     }
 }
@@ -155,7 +162,7 @@ void FetchFromSeqDB(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::o
                     std::vector<std::string>& foundSeqs, const std::string& inFile,
                     const std::set<std::string>& remainingToFind, const char dummyQV,
                     const bool writeIds, const PacBio::Pancake::SeqFetchOutFormat& outFormat,
-                    bool useHPC, bool useRLE)
+                    bool useHPC, bool useRLE, ProgressCounters& counters)
 {
     std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> seqDBCache =
         PacBio::Pancake::LoadSeqDBIndexCache(inFile);
@@ -173,10 +180,10 @@ void FetchFromSeqDB(std::shared_ptr<std::ostream>& osPtr, std::shared_ptr<std::o
             char buff[50];
             sprintf(buff, "%09ld", record.Id());
             WriteSeqAndRLE(osPtr, osRlePtr, std::string(buff), record.Bases(), std::string(),
-                           dummyQV, false, outFormat, useHPC, useRLE);
+                           dummyQV, false, outFormat, useHPC, useRLE, counters);
         } else {
             WriteSeqAndRLE(osPtr, osRlePtr, seqName, record.Bases(), std::string(), dummyQV, false,
-                           outFormat, useHPC, useRLE);
+                           outFormat, useHPC, useRLE, counters);
         }
     }
 }
@@ -244,6 +251,11 @@ int SeqFetchWorkflow::Runner(const PacBio::CLI_v2::Results& options)
         osRlePtr = std::shared_ptr<std::ostream>(new std::ofstream(settings.OutputFile + ".rle"));
     }
 
+    // The total number of bases is not known before the sequences are fetched.
+    ProgressReporter progress("seqfetch", settings.ProgressInterval, settings.ProgressJSON);
+    progress.SetTotals(seqNamesToFind.size(), 0);
+    progress.Start();
+
     PBLOG_INFO << "Starting to fetch.";
     auto remainingToFind = seqNamesToFind;
     for (const auto& filePair : inFiles) {
@@ -260,20 +272,23 @@ int SeqFetchWorkflow::Runner(const PacBio::CLI_v2::Results& options)
 
         if (inFmt == SequenceFormat::Fasta) {
             FetchFromFasta(osPtr, osRlePtr, foundSeqs, inFile, remainingToFind, settings.DummyQV,
-                           settings.OutputFormat, settings.UseHPC, settings.UseRLE);
+                           settings.OutputFormat, settings.UseHPC, settings.UseRLE,
+                         progress.Counters());
 
         } else if (inFmt == SequenceFormat::Fastq) {
             FetchFromFastq(osPtr, osRlePtr, foundSeqs, inFile, remainingToFind, settings.DummyQV,
-                           settings.OutputFormat, settings.UseHPC, settings.UseRLE);
+                           settings.OutputFormat, settings.UseHPC, settings.UseRLE,
+                         progress.Counters());
 
         } else if (inFmt == SequenceFormat::SeqDB) {
             FetchFromSeqDB(osPtr, osRlePtr, foundSeqs, inFile, remainingToFind, settings.DummyQV,
                            settings.WriteIds, settings.OutputFormat, settings.UseHPC,
-                           settings.UseRLE);
+                           settings.UseRLE, progress.Counters());
 
         } else if (inFmt == SequenceFormat::Bam) {
             FetchFromBam(osPtr, osRlePtr, foundSeqs, inFile, remainingToFind, settings.DummyQV,
-                         settings.OutputFormat, settings.UseHPC, settings.UseRLE);
+                         settings.OutputFormat, settings.UseHPC, settings.UseRLE,
+                         progress.Counters());
         }
 
         // Remove the found sequences from the remaining set.
@@ -282,6 +297,8 @@ int SeqFetchWorkflow::Runner(const PacBio::CLI_v2::Results& options)
         }
     }
 
+    progress.Stop();
+
     PBLOG_INFO << "Done!";
     PBLOG_INFO << "Found sequences: " << (static_cast<int32_t>(seqNamesToFind.size()) -
                                           static_cast<int32_t>(remainingToFind.size()))
@@ -0,0 +1,78 @@
+// Author: Ivan Sovic
+
+#include "VerifySettings.h"
+#include <pacbio/Version.h>
+
+namespace PacBio {
+namespace Pancake {
+namespace OptionNames {
+
+// clang-format off
+
+const CLI_v2::PositionalArgument InputFile {
+R"({
+    "name" : "input.db",
+    "description" : "Path to the SeqDB (.seqdb) or SeedDB (.seeddb) to verify."
+})"};
+
+const CLI_v2::Option RequireChecksums{
+R"({
+    "names" : ["require-checksums"],
+    "description" : "Report the blocks without a checksum as errors. Such blocks are otherwise only checked for truncated files. DBs written by older versions and filtered DBs have no checksums.",
+    "type" : "bool"
+})", VerifySettings::Defaults::RequireChecksums};
+
+const CLI_v2::Option ProgressInterval{
+R"({
+    "names" : ["progress-interval"],
+    "description" : "Interval in seconds between the progress reports written to stderr. Each report shows the processed sequences and bytes, the throughput and the ETA. Value 0 disables the reports.",
+    "type" : "double"
+})", VerifySettings::Defaults::ProgressInterval};
+
+const CLI_v2::Option ProgressJSON{
+R"({
+    "names" : ["progress-json"],
+    "description" : "Append the progress reports as JSON lines to this file. A final report is written at the end of the run.",
+    "type" : "string",
+    "default" : ""
+})", std::string("")};
+
+// clang-format on
+
+}  // namespace OptionNames
+
+VerifySettings::VerifySettings() = default;
+
+VerifySettings::VerifySettings(const PacBio::CLI_v2::Results& options)
+    : InputFile{options[OptionNames::InputFile]}
+    , NumThreads{options.NumThreads()}
+    , RequireChecksums{options[OptionNames::RequireChecksums]}
+    , ProgressInterval{options[OptionNames::ProgressInterval]}
+    , ProgressJSON{options[OptionNames::ProgressJSON]}
+{
+}
+
+PacBio::CLI_v2::Interface VerifySettings::CreateCLI()
+{
+    PacBio::CLI_v2::Interface i{"pancake verify",
+                                "Verifies the integrity of all blocks of a SeqDB or a SeedDB "
+                                "against the checksums stored in the index.",
+                                PacBio::Pancake::PancakeFormattedVersion()};
+
+    // clang-format off
+    i.AddOptionGroup("Verification Options", {
+        OptionNames::RequireChecksums,
+    });
+    i.AddOptionGroup("Progress Options", {
+        OptionNames::ProgressInterval,
+        OptionNames::ProgressJSON,
+    });
+    i.AddPositionalArguments({
+        OptionNames::InputFile,
+    });
+
+    // clang-format on
+    return i;
+}
+}  // namespace Pancake
+}  // namespace PacBio
@@ -0,0 +1,37 @@
+// Authors: Ivan Sovic
+
+#ifndef PANCAKE_VERIFY_SETTINGS_H
+#define PANCAKE_VERIFY_SETTINGS_H
+
+#include <cstdint>
+#include <string>
+
+#include <pbcopper/cli2/CLI.h>
+
+namespace PacBio {
+namespace Pancake {
+
+struct VerifySettings
+{
+    struct Defaults
+    {
+        static const size_t NumThreads = 1;
+        static const bool RequireChecksums = false;
+        static constexpr double ProgressInterval = 60.0;
+    };
+
+    std::string InputFile;
+    size_t NumThreads = Defaults::NumThreads;
+    bool RequireChecksums = Defaults::RequireChecksums;
+    double ProgressInterval = Defaults::ProgressInterval;
+    std::string ProgressJSON;
+
+    VerifySettings();
+    VerifySettings(const PacBio::CLI_v2::Results& options);
+    static PacBio::CLI_v2::Interface CreateCLI();
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_VERIFY_SETTINGS_H
@@ -0,0 +1,148 @@
+// Authors: Ivan Sovic
+
+#include "VerifyWorkflow.h"
+#include "VerifySettings.h"
+#include <pacbio/pancake/SeedDBIndexCache.h>
+#include <pacbio/pancake/SeedDBReaderRawBlock.h>
+#include <pacbio/pancake/SeqDBIndexCache.h>
+#include <pacbio/pancake/SeqDBReaderCachedBlock.h>
+#include <pacbio/util/FileIO.h>
+#include <pacbio/util/Progress.h>
+#include <pacbio/util/TicToc.h>
+#include <pbcopper/logging/LogLevel.h>
+#include <pbcopper/logging/Logging.h>
+#include <pbcopper/parallel/FireAndForget.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PacBio {
+namespace Pancake {
+
+/*
+ * The workers load the blocks [startBlockId, endBlockId) one at a time. The block readers
+ * verify the checksums, and fail on truncated files also for the blocks without a checksum.
+ * The error of each failed block is stored in errors[blockId]. The progress counts the
+ * sequences and the bases (SeqDB) or the bytes (SeedDB) of the loaded blocks.
+*/
+void VerifySeqDBWorker(std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> seqDBCache,
+                       int32_t startBlockId, int32_t endBlockId, std::vector<std::string>& errors,
+                       ProgressCounters& counters)
+{
+    PacBio::Pancake::SeqDBReaderCachedBlock reader(seqDBCache, false);
+    for (int32_t blockId = startBlockId; blockId < endBlockId; ++blockId) {
+        try {
+            reader.LoadBlocks({blockId});
+        } catch (const std::exception& e) {
+            errors[blockId] = e.what();
+        }
+        const auto& blockLine = seqDBCache->blockLines[blockId];
+        counters.AddQueries(blockLine.Span());
+        counters.AddBases(blockLine.numBases);
+    }
+}
+
+void VerifySeedDBWorker(std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> seedDBCache,
+                        int32_t startBlockId, int32_t endBlockId, std::vector<std::string>& errors,
+                        ProgressCounters& counters)
+{
+    PacBio::Pancake::SeedDBReaderRawBlock reader(seedDBCache);
+    for (int32_t blockId = startBlockId; blockId < endBlockId; ++blockId) {
+        try {
+            reader.GetBlock(blockId);
+        } catch (const std::exception& e) {
+            errors[blockId] = e.what();
+        }
+        const auto& blockLine = seedDBCache->blockLines[blockId];
+        counters.AddQueries(blockLine.Span());
+        counters.AddBases(blockLine.numBytes);
+    }
+}
+
+int VerifyWorkflow::Runner(const PacBio::CLI_v2::Results& options)
+{
+    VerifySettings settings{options};
+
+    const int32_t numThreads = std::max<int32_t>(1, settings.NumThreads);
+    std::vector<bool> hasChecksum;
+    std::vector<std::string> errors;
+
+    TicToc ttVerify;
+    ProgressReporter progress("verify", settings.ProgressInterval, settings.ProgressJSON);
+    PacBio::Parallel::FireAndForget faf(numThreads);
+
+    if (FormatIsSeqDB(settings.InputFile)) {
+        std::shared_ptr<PacBio::Pancake::SeqDBIndexCache> seqDBCache =
+            PacBio::Pancake::LoadSeqDBIndexCache(settings.InputFile);
+        int64_t totalBases = 0;
+        for (const auto& blockLine : seqDBCache->blockLines) {
+            hasChecksum.emplace_back(blockLine.hasChecksum);
+            totalBases += blockLine.numBases;
+        }
+        progress.SetTotals(seqDBCache->seqLines.size(), totalBases);
+        progress.Start();
+        const int32_t numBlocks = hasChecksum.size();
+        const int32_t chunkSize = (numBlocks + numThreads - 1) / numThreads;
+        errors.resize(numBlocks);
+        for (int32_t start = 0; start < numBlocks; start += chunkSize) {
+            const int32_t end = std::min(numBlocks, start + chunkSize);
+            faf.ProduceWith(VerifySeqDBWorker, seqDBCache, start, end, std::ref(errors),
+                            std::ref(progress.Counters()));
+        }
+
+    } else if (FormatIsSeedDB(settings.InputFile)) {
+        std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> seedDBCache =
+            PacBio::Pancake::LoadSeedDBIndexCache(settings.InputFile);
+        int64_t totalBases = 0;
+        for (const auto& blockLine : seedDBCache->blockLines) {
+            hasChecksum.emplace_back(blockLine.hasChecksum);
+            totalBases += blockLine.numBytes;
+        }
+        progress.SetTotals(seedDBCache->seedLines.size(), totalBases);
+        progress.Start();
+        const int32_t numBlocks = hasChecksum.size();
+        const int32_t chunkSize = (numBlocks + numThreads - 1) / numThreads;
+        errors.resize(numBlocks);
+        for (int32_t start = 0; start < numBlocks; start += chunkSize) {
+            const int32_t end = std::min(numBlocks, start + chunkSize);
+            faf.ProduceWith(VerifySeedDBWorker, seedDBCache, start, end, std::ref(errors),
+                            std::ref(progress.Counters()));
+        }
+
+    } else {
+        throw std::runtime_error("Unknown input format: '" + settings.InputFile +
+                                 "'. Expected a .seqdb or a .seeddb file.");
+    }
+
+    faf.Finalize();
+    ttVerify.Stop();
+    progress.Stop();
+
+    int32_t numCorrupted = 0;
+    int32_t numUnchecked = 0;
+    for (size_t blockId = 0; blockId < errors.size(); ++blockId) {
+        if (errors[blockId].empty() == false) {
+            ++numCorrupted;
+            PBLOG_WARN << "Block " << blockId << " failed verification: " << errors[blockId];
+        } else if (hasChecksum[blockId] == false) {
+            ++numUnchecked;
+            if (settings.RequireChecksums) {
+                PBLOG_WARN << "Block " << blockId << " has no checksum.";
+            }
+        }
+    }
+
+    PBLOG_INFO << "Verified " << errors.size() << " blocks in " << ttVerify.GetSecs()
+               << " sec: " << numCorrupted << " failed, " << numUnchecked
+               << " without a checksum.";
+
+    if (numCorrupted > 0 || (settings.RequireChecksums && numUnchecked > 0)) {
+        throw std::runtime_error("The DB '" + settings.InputFile + "' failed verification.");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
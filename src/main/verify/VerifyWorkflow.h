@@ -0,0 +1,19 @@
+// Author: Ivan Sovic
+
+#ifndef PANCAKE_VERIFY_WORKFLOW_H
+#define PANCAKE_VERIFY_WORKFLOW_H
+
+#include <pbcopper/cli2/CLI.h>
+
+namespace PacBio {
+namespace Pancake {
+
+struct VerifyWorkflow
+{
+    static int Runner(const PacBio::CLI_v2::Results& options);
+};
+
+}  // namespace Pancake
+}  // namespace PacBio
+
+#endif  // PANCAKE_VERIFY_WORKFLOW_H
@@ -17,11 +17,34 @@ AlignerEdlib::AlignerEdlib(const AlignmentParameters& opt) : opt_(opt) {}
 AlignerEdlib::~AlignerEdlib() {}
 
 AlignmentResult AlignerEdlib::Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen)
+{
+    AlignmentResult ret;
+    Global(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+AlignmentResult AlignerEdlib::Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen)
+{
+    AlignmentResult ret;
+    Extend(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+AlignmentResult AlignerEdlib::ExtendReverse(const char* qseq, int64_t qlen, const char* tseq,
+                                            int64_t tlen)
+{
+    AlignmentResult ret;
+    ExtendReverse(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+void AlignerEdlib::Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                          AlignmentResult& result)
 {
     if (qlen == 0 || tlen == 0) {
-        AlignmentResult ret = EdgeCaseAlignmentResult(
-            qlen, tlen, opt_.matchScore, opt_.mismatchPenalty, opt_.gapOpen1, opt_.gapExtend1);
-        return ret;
+        result = EdgeCaseAlignmentResult(qlen, tlen, opt_.matchScore, opt_.mismatchPenalty,
+                                         opt_.gapOpen1, opt_.gapExtend1);
+        return;
     }
 
     EdlibAlignResult edlibResult = edlibAlign(
@@ -29,44 +52,43 @@ AlignmentResult AlignerEdlib::Global(const char* qseq, int64_t qlen, const char*
 
     if (edlibResult.numLocations == 0) {
         edlibFreeAlignResult(edlibResult);
-        return {};
+        result.Clear();
+        return;
     }
 
-    Data::Cigar cigar = EdlibAlignmentToCigar(edlibResult.alignment, edlibResult.alignmentLength);
-    bool valid = true;
+    EdlibAlignmentToCigar(edlibResult.alignment, edlibResult.alignmentLength, edlibCigar_);
+    edlibFreeAlignResult(edlibResult);
 
+    bool valid = true;
     try {
-        cigar = NormalizeCigar(qseq, qlen, tseq, tlen, cigar);
+        NormalizeCigar(qseq, qlen, tseq, tlen, edlibCigar_, result.cigar, normalizeGapRun_);
     } catch (std::exception& e) {
         valid = false;
-        cigar.clear();
+        result.cigar.clear();
     }
 
-    AlignmentResult ret;
-    ret.cigar = std::move(cigar);
-    ret.score = ScoreCigarAlignment(ret.cigar, opt_.matchScore, opt_.mismatchPenalty, opt_.gapOpen1,
-                                    opt_.gapExtend1);
-    ret.valid = valid;
-    ret.maxScore = ret.score;
-    ret.zdropped = false;
-    ret.lastQueryPos = qlen;
-    ret.lastTargetPos = tlen;
-    ret.maxQueryPos = qlen;
-    ret.maxTargetPos = tlen;
-
-    edlibFreeAlignResult(edlibResult);
+    result.score = ScoreCigarAlignment(result.cigar, opt_.matchScore, opt_.mismatchPenalty,
+                                       opt_.gapOpen1, opt_.gapExtend1);
+    result.valid = valid;
+    result.maxScore = result.score;
+    result.zdropped = false;
+    result.lastQueryPos = qlen;
+    result.lastTargetPos = tlen;
+    result.maxQueryPos = qlen;
+    result.maxTargetPos = tlen;
+}
 
-    return ret;
+void AlignerEdlib::Extend(const char* /*qseq*/, int64_t /*qlen*/, const char* /*tseq*/,
+                          int64_t /*tlen*/, AlignmentResult& result)
+{
+    // Extension is not supported by this aligner.
+    result.Clear();
 }
 
-AlignmentResult AlignerEdlib::Extend(const char* /*qseq*/, int64_t /*qlen*/, const char* /*tseq*/,
-                                     int64_t /*tlen*/)
+void AlignerEdlib::ExtendReverse(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                                 AlignmentResult& result)
 {
-    AlignmentResult ret;
-    ret.valid = false;
-    ret.lastQueryPos = 0;
-    ret.lastTargetPos = 0;
-    return ret;
+    Extend(qseq, qlen, tseq, tlen, result);
 }
 
 }  // namespace Pancake
@@ -8,11 +8,16 @@
 namespace PacBio {
 namespace Pancake {
 
+// Same as in Minimap2: the memory pool is released once it contains a core larger than this.
+static const size_t KALLOC_MAX_RETAINED_BLOCK = 1U << 28;
+
 mm_tbuf_t* mm_tbuf_init(void)
 {
     mm_tbuf_t* b;
     b = (mm_tbuf_t*)calloc(1, sizeof(mm_tbuf_t));
-    // if (!(mm_dbg_flag & 1)) b->km = km_init();              // This flag means: #define MM_DBG_NO_KALLOC     0x1
+    // The memory pool keeps the KSW2 matrices between alignments, so that aligning in a loop
+    // does not allocate memory once the pool has grown large enough.
+    b->km = km_init();
     return b;
 }
 
@@ -40,11 +45,34 @@ AlignerKSW2::AlignerKSW2(const AlignmentParameters& opt)
 AlignerKSW2::~AlignerKSW2() = default;
 
 AlignmentResult AlignerKSW2::Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen)
+{
+    AlignmentResult ret;
+    Global(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+AlignmentResult AlignerKSW2::Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen)
+{
+    AlignmentResult ret;
+    Extend(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+AlignmentResult AlignerKSW2::ExtendReverse(const char* qseq, int64_t qlen, const char* tseq,
+                                           int64_t tlen)
+{
+    AlignmentResult ret;
+    ExtendReverse(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+void AlignerKSW2::Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                         AlignmentResult& result)
 {
     if (qlen == 0 || tlen == 0) {
-        AlignmentResult ret = EdgeCaseAlignmentResult(
-            qlen, tlen, opt_.matchScore, opt_.mismatchPenalty, opt_.gapOpen1, opt_.gapExtend1);
-        return ret;
+        result = EdgeCaseAlignmentResult(qlen, tlen, opt_.matchScore, opt_.mismatchPenalty,
+                                         opt_.gapOpen1, opt_.gapExtend1);
+        return;
     }
 
     const int32_t extra_flag = 0;
@@ -56,9 +84,12 @@ AlignmentResult AlignerKSW2::Global(const char* qseq, int64_t qlen, const char*
     ksw_extz_t ez;
     memset(&ez, 0, sizeof(ksw_extz_t));
 
-    // Convert the subsequence's alphabet from ACTG to [0123].
-    const std::vector<uint8_t> qseqInt = ConvertSeqAlphabet_(qseq, qlen, &BaseToTwobit[0]);
-    const std::vector<uint8_t> tseqInt = ConvertSeqAlphabet_(tseq, tlen, &BaseToTwobit[0]);
+    // Convert the subsequence's alphabet from ACTG to [0123]. The buffers are taken from
+    // the memory pool.
+    uint8_t* qseqInt = static_cast<uint8_t*>(kmalloc(buffer_->km, qlen));
+    uint8_t* tseqInt = static_cast<uint8_t*>(kmalloc(buffer_->km, tlen));
+    ConvertSeqAlphabet_(qseq, qlen, &BaseToTwobit[0], false, qseqInt);
+    ConvertSeqAlphabet_(tseq, tlen, &BaseToTwobit[0], false, tseqInt);
 
     // Compute the actual bandwidth. If this was a long join, we need to allow more room.
     const int32_t longestSpan = std::max(qlen, tlen);
@@ -70,44 +101,56 @@ AlignmentResult AlignerKSW2::Global(const char* qseq, int64_t qlen, const char*
     const int32_t actualBandwidth = (spanDiff > (bw / 2)) ? longestSpan : bw;
 
     // First pass: with approximate Z-drop
-    AlignPair_(buffer_->km, qlen, &qseqInt[0], tlen, &tseqInt[0], mat_, actualBandwidth, -1, -1,
+    AlignPair_(buffer_->km, qlen, qseqInt, tlen, tseqInt, mat_, actualBandwidth, -1, -1,
                extra_flag | KSW_EZ_APPROX_MAX, &ez, opt_.gapOpen1, opt_.gapExtend1, opt_.gapOpen2,
                opt_.gapExtend2);
 
-    PacBio::Data::Cigar currCigar;
     int32_t qAlnLen = 0;
     int32_t tAlnLen = 0;
-    ConvertMinimap2CigarToPbbam_(ez.cigar, ez.n_cigar, qseqInt, tseqInt, currCigar, qAlnLen,
+    ConvertMinimap2CigarToPbbam_(ez.cigar, ez.n_cigar, qseqInt, tseqInt, result.cigar, qAlnLen,
                                  tAlnLen);
 
-    AlignmentResult ret;
-    ret.cigar = std::move(currCigar);
-    ret.valid =
+    result.valid =
         (ez.zdropped || ez.n_cigar == 0 || qAlnLen != qlen || tAlnLen != tlen) ? false : true;
-    ret.lastQueryPos = qlen;
-    ret.lastTargetPos = tlen;
-    ret.maxQueryPos = ez.max_q;
-    ret.maxTargetPos = ez.max_t;
-    ret.score = ez.score;
-    ret.maxScore = ez.max;
-    ret.zdropped = ez.zdropped;
-
-    if (ret.valid == false) {
-        ret.cigar.clear();
+    result.lastQueryPos = qlen;
+    result.lastTargetPos = tlen;
+    result.maxQueryPos = ez.max_q;
+    result.maxTargetPos = ez.max_t;
+    result.score = ez.score;
+    result.maxScore = ez.max;
+    result.zdropped = ez.zdropped;
+
+    if (result.valid == false) {
+        result.cigar.clear();
     }
 
     // Free KSW2 memory.
     kfree(buffer_->km, ez.cigar);
+    kfree(buffer_->km, qseqInt);
+    kfree(buffer_->km, tseqInt);
+    ResetBufferIfLarge_();
+}
 
-    return ret;
+void AlignerKSW2::Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                         AlignmentResult& result)
+{
+    Extend_(qseq, qlen, tseq, tlen, false, result);
 }
 
-AlignmentResult AlignerKSW2::Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen)
+void AlignerKSW2::ExtendReverse(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                                AlignmentResult& result)
+{
+    // The sequences are reversed while converting the alphabet, so there is no extra copy.
+    Extend_(qseq, qlen, tseq, tlen, true, result);
+}
+
+void AlignerKSW2::Extend_(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                          bool reverse, AlignmentResult& result)
 {
     if (qlen == 0 || tlen == 0) {
-        AlignmentResult ret = EdgeCaseAlignmentResult(
-            qlen, tlen, opt_.matchScore, opt_.mismatchPenalty, opt_.gapOpen1, opt_.gapExtend1);
-        return ret;
+        result = EdgeCaseAlignmentResult(qlen, tlen, opt_.matchScore, opt_.mismatchPenalty,
+                                         opt_.gapOpen1, opt_.gapExtend1);
+        return;
     }
 
     const int32_t extra_flag = 0;
@@ -119,50 +162,71 @@ AlignmentResult AlignerKSW2::Extend(const char* qseq, int64_t qlen, const char*
     ksw_extz_t ez;
     memset(&ez, 0, sizeof(ksw_extz_t));
 
-    // Convert the subsequence's alphabet from ACTG to [0123].
-    const std::vector<uint8_t> qseqInt = ConvertSeqAlphabet_(qseq, qlen, &BaseToTwobit[0]);
-    const std::vector<uint8_t> tseqInt = ConvertSeqAlphabet_(tseq, tlen, &BaseToTwobit[0]);
+    // Convert the subsequence's alphabet from ACTG to [0123]. The buffers are taken from
+    // the memory pool.
+    uint8_t* qseqInt = static_cast<uint8_t*>(kmalloc(buffer_->km, qlen));
+    uint8_t* tseqInt = static_cast<uint8_t*>(kmalloc(buffer_->km, tlen));
+    ConvertSeqAlphabet_(qseq, qlen, &BaseToTwobit[0], reverse, qseqInt);
+    ConvertSeqAlphabet_(tseq, tlen, &BaseToTwobit[0], reverse, tseqInt);
 
-    AlignPair_(buffer_->km, qlen, &qseqInt[0], tlen, &tseqInt[0], mat_, bw, opt_.endBonus,
-               opt_.zdrop, extra_flag | KSW_EZ_EXTZ_ONLY | KSW_EZ_RIGHT, &ez, opt_.gapOpen1,
-               opt_.gapExtend1, opt_.gapOpen2, opt_.gapExtend2);
+    AlignPair_(buffer_->km, qlen, qseqInt, tlen, tseqInt, mat_, bw, opt_.endBonus, opt_.zdrop,
+               extra_flag | KSW_EZ_EXTZ_ONLY | KSW_EZ_RIGHT, &ez, opt_.gapOpen1, opt_.gapExtend1,
+               opt_.gapOpen2, opt_.gapExtend2);
 
-    PacBio::Data::Cigar currCigar;
     int32_t qAlnLen = 0;
     int32_t tAlnLen = 0;
-    ConvertMinimap2CigarToPbbam_(ez.cigar, ez.n_cigar, qseqInt, tseqInt, currCigar, qAlnLen,
+    ConvertMinimap2CigarToPbbam_(ez.cigar, ez.n_cigar, qseqInt, tseqInt, result.cigar, qAlnLen,
                                  tAlnLen);
 
-    AlignmentResult ret;
-    ret.cigar = std::move(currCigar);
-    ret.valid = (ez.n_cigar == 0) ? false : true;
-    ret.lastQueryPos = (ez.reach_end ? qlen : ez.max_q + 1);
-    ret.lastTargetPos = (ez.reach_end ? ez.mqe_t + 1 : ez.max_t + 1);
-    ret.maxQueryPos = ez.max_q;
-    ret.maxTargetPos = ez.max_t;
-    ret.score = ez.score;
-    ret.maxScore = ez.max;
-    ret.zdropped = ez.zdropped;
+    result.valid = (ez.n_cigar == 0) ? false : true;
+    result.lastQueryPos = (ez.reach_end ? qlen : ez.max_q + 1);
+    result.lastTargetPos = (ez.reach_end ? ez.mqe_t + 1 : ez.max_t + 1);
+    result.maxQueryPos = ez.max_q;
+    result.maxTargetPos = ez.max_t;
+    result.score = ez.score;
+    result.maxScore = ez.max;
+    result.zdropped = ez.zdropped;
 
     // Free KSW2 memory.
     kfree(buffer_->km, ez.cigar);
+    kfree(buffer_->km, qseqInt);
+    kfree(buffer_->km, tseqInt);
+    ResetBufferIfLarge_();
+}
 
-    return ret;
+km_stat_t AlignerKSW2::MemoryPoolStats() const
+{
+    km_stat_t kmst;
+    km_stat(buffer_->km, &kmst);
+    return kmst;
 }
 
-std::vector<uint8_t> AlignerKSW2::ConvertSeqAlphabet_(const char* seq, size_t seqlen,
-                                                      const int8_t* conv_table)
+void AlignerKSW2::ResetBufferIfLarge_()
 {
-    std::vector<uint8_t> ret(seqlen);
-    for (size_t i = 0; i < seqlen; i++) {
-        ret[i] = (int8_t)conv_table[(uint8_t)seq[i]];
+    km_stat_t kmst;
+    km_stat(buffer_->km, &kmst);
+    if (kmst.largest > KALLOC_MAX_RETAINED_BLOCK) {
+        km_destroy(buffer_->km);
+        buffer_->km = km_init();
+    }
+}
+
+void AlignerKSW2::ConvertSeqAlphabet_(const char* seq, size_t seqlen, const int8_t* conv_table,
+                                      bool reverse, uint8_t* ret)
+{
+    if (reverse) {
+        for (size_t i = 0; i < seqlen; i++) {
+            ret[i] = (int8_t)conv_table[(uint8_t)seq[seqlen - 1 - i]];
+        }
+    } else {
+        for (size_t i = 0; i < seqlen; i++) {
+            ret[i] = (int8_t)conv_table[(uint8_t)seq[i]];
+        }
     }
-    return ret;
 }
 
 void AlignerKSW2::ConvertMinimap2CigarToPbbam_(uint32_t* mm2Cigar, int32_t cigarLen,
-                                               const std::vector<uint8_t>& qseq,
-                                               const std::vector<uint8_t>& tseq,
+                                               const uint8_t* qseq, const uint8_t* tseq,
                                                PacBio::Data::Cigar& retCigar,
                                                int32_t& retQueryAlignmentLen,
                                                int32_t& retTargetAlignmentLen)
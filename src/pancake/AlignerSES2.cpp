@@ -21,11 +21,34 @@ AlignerSES2::AlignerSES2(const AlignmentParameters& opt)
 AlignerSES2::~AlignerSES2() {}
 
 AlignmentResult AlignerSES2::Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen)
+{
+    AlignmentResult ret;
+    Global(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+AlignmentResult AlignerSES2::Extend(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen)
+{
+    AlignmentResult ret;
+    Extend(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+AlignmentResult AlignerSES2::ExtendReverse(const char* qseq, int64_t qlen, const char* tseq,
+                                           int64_t tlen)
+{
+    AlignmentResult ret;
+    ExtendReverse(qseq, qlen, tseq, tlen, ret);
+    return ret;
+}
+
+void AlignerSES2::Global(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                         AlignmentResult& result)
 {
     if (qlen == 0 || tlen == 0) {
-        AlignmentResult ret = EdgeCaseAlignmentResult(
-            qlen, tlen, opt_.matchScore, opt_.mismatchPenalty, opt_.gapOpen1, opt_.gapExtend1);
-        return ret;
+        result = EdgeCaseAlignmentResult(qlen, tlen, opt_.matchScore, opt_.mismatchPenalty,
+                                         opt_.gapOpen1, opt_.gapExtend1);
+        return;
     }
 
     const double alignMaxDiff = 1.0;  // 0.30;
@@ -41,40 +64,41 @@ AlignmentResult AlignerSES2::Global(const char* qseq, int64_t qlen, const char*
     // const int32_t actualBandwidth = ((static_cast<double>(spanDiff) / static_cast<double>(longestSpan)) > 0.05) ? longestSpan : bw;
     const int32_t actualBandwidth = qlen + tlen;
 
-    auto aln = Alignment::SES2AlignBanded<Alignment::SESAlignMode::Global,
-                                          Alignment::SESTrimmingMode::Disabled,
-                                          Alignment::SESTracebackMode::Enabled>(
-        qseq, qlen, tseq, tlen, maxDiffs, actualBandwidth, sesScratch_);
+    // The SES result and the normalized CIGAR are written into buffers which are kept between
+    // calls, so the steady state does not allocate memory.
+    Alignment::SES2AlignBanded<Alignment::SESAlignMode::Global,
+                               Alignment::SESTrimmingMode::Disabled,
+                               Alignment::SESTracebackMode::Enabled>(
+        qseq, qlen, tseq, tlen, maxDiffs, actualBandwidth, sesResult_, sesScratch_);
 
-    Data::Cigar cigar = NormalizeCigar(qseq, qlen, tseq, tlen, aln.cigar);
+    NormalizeCigar(qseq, qlen, tseq, tlen, sesResult_.cigar, result.cigar, normalizeGapRun_);
 
-    AlignmentResult ret;
-    ret.cigar = std::move(cigar);
-    ret.score = ScoreCigarAlignment(ret.cigar, opt_.matchScore, opt_.mismatchPenalty, opt_.gapOpen1,
-                                    opt_.gapExtend1);
-    ret.valid = aln.valid;
-    ret.maxScore = ret.score;
-    ret.zdropped = false;
-    ret.lastQueryPos = qlen;
-    ret.lastTargetPos = tlen;
-    ret.maxQueryPos = qlen;
-    ret.maxTargetPos = tlen;
-
-    if (ret.valid == false) {
-        ret.cigar.clear();
+    result.score = ScoreCigarAlignment(result.cigar, opt_.matchScore, opt_.mismatchPenalty,
+                                       opt_.gapOpen1, opt_.gapExtend1);
+    result.valid = sesResult_.valid;
+    result.maxScore = result.score;
+    result.zdropped = false;
+    result.lastQueryPos = qlen;
+    result.lastTargetPos = tlen;
+    result.maxQueryPos = qlen;
+    result.maxTargetPos = tlen;
+
+    if (result.valid == false) {
+        result.cigar.clear();
     }
+}
 
-    return ret;
+void AlignerSES2::Extend(const char* /*qseq*/, int64_t /*qlen*/, const char* /*tseq*/,
+                         int64_t /*tlen*/, AlignmentResult& result)
+{
+    // Extension is not supported by this aligner.
+    result.Clear();
 }
 
-AlignmentResult AlignerSES2::Extend(const char* /*qseq*/, int64_t /*qlen*/, const char* /*tseq*/,
-                                    int64_t /*tlen*/)
+void AlignerSES2::ExtendReverse(const char* qseq, int64_t qlen, const char* tseq, int64_t tlen,
+                                AlignmentResult& result)
 {
-    AlignmentResult ret;
-    ret.valid = false;
-    ret.lastQueryPos = 0;
-    ret.lastTargetPos = 0;
-    return ret;
+    Extend(qseq, qlen, tseq, tlen, result);
 }
 
 }  // namespace Pancake
@@ -4,6 +4,7 @@
 #include <pacbio/pancake/AlignmentSeeded.h>
 #include <pacbio/pancake/OverlapWriterBase.h>
 #include <pbcopper/logging/Logging.h>
+#include <cstring>
 #include <iostream>
 
 namespace PacBio {
@@ -11,6 +12,11 @@ namespace Pancake {
 
 // #define DEBUG_ALIGNMENT_SEEDED
 
+// Regions with at most this many mismatches (and no indels) are not passed to the aligner.
+static const int32_t UNGAPPED_MAX_MISMATCHES = 4;
+// Mismatches closer than this might be better explained with an indel, so the aligner decides.
+static const int32_t UNGAPPED_MIN_MISMATCH_DIST = 4;
+
 std::vector<AlignmentRegion> ExtractAlignmentRegions(const std::vector<SeedHit>& inSortedHits,
                                                      int32_t qLen, int32_t tLen, bool isRev,
                                                      int32_t minAlignmentSpan,
@@ -171,16 +177,28 @@ AlignmentResult AlignSingleRegion(const char* targetSeq, int32_t targetLen, cons
                                   const char* querySeqRev, int32_t queryLen,
                                   AlignerBasePtr& alignerGlobal, AlignerBasePtr& alignerExt,
                                   const AlignmentRegion& region)
+{
+    AlignmentResult alnRes;
+    AlignSingleRegion(targetSeq, targetLen, querySeqFwd, querySeqRev, queryLen, alignerGlobal,
+                      alignerExt, region, alnRes);
+    return alnRes;
+}
+
+void AlignSingleRegion(const char* targetSeq, int32_t targetLen, const char* querySeqFwd,
+                       const char* querySeqRev, int32_t queryLen, AlignerBasePtr& alignerGlobal,
+                       AlignerBasePtr& alignerExt, const AlignmentRegion& region,
+                       AlignmentResult& alnRes)
 {
     const char* querySeqInStrand = region.queryRev ? querySeqRev : querySeqFwd;
     const char* targetSeqInStrand = targetSeq;
-    int32_t qStart = region.qStart;
-    int32_t tStart = region.tStart;
+    const int32_t qStart = region.qStart;
+    const int32_t tStart = region.tStart;
     const int32_t qSpan = region.qSpan;
     const int32_t tSpan = region.tSpan;
 
     if (qSpan == 0 && tSpan == 0) {
-        return {};
+        alnRes = AlignmentResult();
+        return;
     }
 
     if (qStart >= queryLen || (qStart + qSpan) > queryLen || tStart >= targetLen ||
@@ -201,35 +219,103 @@ AlignmentResult AlignSingleRegion(const char* targetSeq, int32_t targetLen, cons
         throw std::runtime_error(oss.str());
     }
 
-    // Prepare the reversed front sequence if required.
-    std::string qSubSeq;
-    std::string tSubSeq;
+    // Align. The front is extended from its last base backwards, which produces the CIGAR
+    // in the reversed order.
     if (region.type == RegionType::FRONT) {
-        qSubSeq = std::string(querySeqInStrand + region.qStart, region.qSpan);
-        tSubSeq = std::string(targetSeqInStrand + region.tStart, region.tSpan);
-        std::reverse(qSubSeq.begin(), qSubSeq.end());
-        std::reverse(tSubSeq.begin(), tSubSeq.end());
-        querySeqInStrand = qSubSeq.c_str();
-        targetSeqInStrand = tSubSeq.c_str();
-        qStart = 0;
-        tStart = 0;
-    }
-
-    // Align.
-    AlignmentResult alnRes;
-    if (region.type == RegionType::FRONT || region.type == RegionType::BACK) {
-        alnRes =
-            alignerExt->Extend(querySeqInStrand + qStart, qSpan, targetSeqInStrand + tStart, tSpan);
+        alignerExt->ExtendReverse(querySeqInStrand + qStart, qSpan, targetSeqInStrand + tStart,
+                                  tSpan, alnRes);
+    } else if (region.type == RegionType::BACK) {
+        alignerExt->Extend(querySeqInStrand + qStart, qSpan, targetSeqInStrand + tStart, tSpan,
+                           alnRes);
     } else {
-        alnRes = alignerGlobal->Global(querySeqInStrand + qStart, qSpan, targetSeqInStrand + tStart,
-                                       tSpan);
+        alignerGlobal->Global(querySeqInStrand + qStart, qSpan, targetSeqInStrand + tStart, tSpan,
+                              alnRes);
     }
 
     if (region.type == RegionType::FRONT) {
         std::reverse(alnRes.cigar.begin(), alnRes.cigar.end());
     }
+}
 
-    return alnRes;
+AlignmentResult AlignUngapped(const char* querySeq, const char* targetSeq, int32_t span,
+                              int32_t maxMismatches, int32_t minMismatchDist)
+{
+    AlignmentResult ret;
+    AlignUngapped(querySeq, targetSeq, span, maxMismatches, minMismatchDist, ret);
+    return ret;
+}
+
+void AlignUngapped(const char* querySeq, const char* targetSeq, int32_t span,
+                   int32_t maxMismatches, int32_t minMismatchDist, AlignmentResult& ret)
+{
+    // Clear the CIGAR, but keep its memory.
+    ret.cigar.clear();
+    ret.lastQueryPos = 0;
+    ret.lastTargetPos = 0;
+    ret.maxQueryPos = 0;
+    ret.maxTargetPos = 0;
+    ret.valid = false;
+    ret.score = 0;
+    ret.maxScore = 0;
+    ret.zdropped = false;
+
+    if (span < 0 || querySeq == NULL || targetSeq == NULL) {
+        return;
+    }
+
+    int32_t numMismatches = 0;
+    int32_t lastDiffEnd = 0;
+
+    // Returns false if the mismatch at pos cannot be accepted.
+    auto AddMismatch = [&](int32_t pos) {
+        ++numMismatches;
+        if (numMismatches > maxMismatches ||
+            (numMismatches > 1 && (pos + 1 - lastDiffEnd) < minMismatchDist)) {
+            return false;
+        }
+        if (pos > lastDiffEnd) {
+            ret.cigar.emplace_back(PacBio::BAM::CigarOperation(
+                PacBio::BAM::CigarOperationType::SEQUENCE_MATCH, pos - lastDiffEnd));
+        }
+        ret.cigar.emplace_back(
+            PacBio::BAM::CigarOperation(PacBio::BAM::CigarOperationType::SEQUENCE_MISMATCH, 1));
+        lastDiffEnd = pos + 1;
+        return true;
+    };
+
+    // Compare 8 bytes at a time, and only look into the individual bases of differing words.
+    int32_t pos = 0;
+    for (; (pos + 8) <= span; pos += 8) {
+        uint64_t q = 0;
+        uint64_t t = 0;
+        std::memcpy(&q, querySeq + pos, sizeof(q));
+        std::memcpy(&t, targetSeq + pos, sizeof(t));
+        if (q == t) {
+            continue;
+        }
+        for (int32_t j = pos; j < (pos + 8); ++j) {
+            if (querySeq[j] != targetSeq[j] && AddMismatch(j) == false) {
+                ret.cigar.clear();
+                return;
+            }
+        }
+    }
+    for (; pos < span; ++pos) {
+        if (querySeq[pos] != targetSeq[pos] && AddMismatch(pos) == false) {
+            ret.cigar.clear();
+            return;
+        }
+    }
+    if (span > lastDiffEnd) {
+        ret.cigar.emplace_back(PacBio::BAM::CigarOperation(
+            PacBio::BAM::CigarOperationType::SEQUENCE_MATCH, span - lastDiffEnd));
+    }
+
+    ret.valid = true;
+    ret.lastQueryPos = span;
+    ret.lastTargetPos = span;
+    ret.maxQueryPos = span;
+    ret.maxTargetPos = span;
 }
 
 AlignRegionsGenericResult AlignRegionsGeneric(const char* targetSeq, const int32_t targetLen,
@@ -241,13 +327,29 @@ AlignRegionsGenericResult AlignRegionsGeneric(const char* targetSeq, const int32
 {
     AlignRegionsGenericResult ret;
 
-    std::vector<AlignmentResult> alignedRegions;
+    // The same result object is reused for all regions, so that the aligners can keep
+    // the memory of its CIGAR.
+    AlignmentResult alnRes;
 
     for (size_t i = 0; i < regions.size(); ++i) {
         const auto& region = regions[i];
 
-        auto alnRes = AlignSingleRegion(targetSeq, targetLen, queryFwd, queryRev, queryLen,
-                                        alignerGlobal, alignerExt, region);
+        // Most of the regions between seed hits in high-identity data are ungapped and contain
+        // only a few mismatches, if any. These do not need the aligner.
+        alnRes.valid = false;
+        if (region.type == RegionType::GLOBAL && region.qSpan == region.tSpan &&
+            region.qSpan > 0 && region.qStart >= 0 && (region.qStart + region.qSpan) <= queryLen &&
+            region.tStart >= 0 && (region.tStart + region.tSpan) <= targetLen &&
+            targetSeq != NULL && queryFwd != NULL && queryRev != NULL) {
+            const char* querySeqInStrand = region.queryRev ? queryRev : queryFwd;
+            AlignUngapped(querySeqInStrand + region.qStart, targetSeq + region.tStart,
+                          region.qSpan, UNGAPPED_MAX_MISMATCHES, UNGAPPED_MIN_MISMATCH_DIST,
+                          alnRes);
+        }
+        if (alnRes.valid == false) {
+            AlignSingleRegion(targetSeq, targetLen, queryFwd, queryRev, queryLen, alignerGlobal,
+                              alignerExt, region, alnRes);
+        }
 
         if (region.type == RegionType::FRONT) {
             ret.offsetFrontQuery = alnRes.lastQueryPos;
@@ -257,19 +359,14 @@ AlignRegionsGenericResult AlignRegionsGeneric(const char* targetSeq, const int32
             ret.offsetBackTarget = alnRes.lastTargetPos;
         }
 
-        // Store the results.
-        alignedRegions.emplace_back(std::move(alnRes));
-
 #ifdef DEBUG_ALIGNMENT_SEEDED
         std::cerr << "[aln region i = " << i << " / " << regions.size() << "] " << region
-                  << ", CIGAR: " << alignedRegions.back().cigar.ToStdString() << "\n"
+                  << ", CIGAR: " << alnRes.cigar.ToStdString() << "\n"
                   << alnRes << "\n\n";
 #endif
-    }
 
-    // Merge the CIGAR chunks.
-    for (const auto& alnRegion : alignedRegions) {
-        const auto& currCigar = alnRegion.cigar;
+        // Merge the CIGAR chunk.
+        const auto& currCigar = alnRes.cigar;
         if (currCigar.empty()) {
             continue;
         }
@@ -0,0 +1,634 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/Breakpoint.h>
+#include <pacbio/pancake/MapperBase.h>
+#include <pacbio/pancake/OverlapWriterBase.h>
+#include <pacbio/util/Util.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <tuple>
+
+namespace PacBio {
+namespace Pancake {
+
+// Scores of the junction realignment.
+static const int32_t JUNCTION_MATCH = 2;
+static const int32_t JUNCTION_MISMATCH = -4;
+static const int32_t JUNCTION_GAP = -4;
+// Number of query bases realigned on each side of the junction given by the mappings.
+static const int32_t JUNCTION_FLANK = 50;
+// Junctions with a longer query overlap or gap between the two mappings are not realigned.
+static const int32_t JUNCTION_MAX_REALIGN_DIST = 1000;
+
+std::string BreakpointTypeToString(const BreakpointType& type)
+{
+    if (type == BreakpointType::SplitRead) {
+        return "split";
+    } else if (type == BreakpointType::Deletion) {
+        return "del";
+    } else if (type == BreakpointType::Insertion) {
+        return "ins";
+    }
+    return "unknown";
+}
+
+namespace {
+
+/*
+ * For every query position in the range [qFrom, qTo] (inclusive), computes the number
+ * of matching bases accumulated from the beginning of the alignment up to that position,
+ * and the target position (in the strand of the target) aligned to it.
+ * Positions outside of the alignment are clamped to the closest aligned position.
+*/
+void ComputeAlignmentProfile(const Overlap& ovl, int32_t qFrom, int32_t qTo,
+                             std::vector<int32_t>& matches, std::vector<int32_t>& targetPos)
+{
+    const int32_t n = qTo - qFrom + 1;
+    matches.assign(n, -1);
+    targetPos.assign(n, -1);
+
+    int32_t qpos = ovl.Astart;
+    int32_t tpos = ovl.Bstart;
+    int32_t numMatches = 0;
+
+    auto Record = [&]() {
+        if (qpos >= qFrom && qpos <= qTo && matches[qpos - qFrom] < 0) {
+            matches[qpos - qFrom] = numMatches;
+            targetPos[qpos - qFrom] = tpos;
+        }
+    };
+
+    for (const auto& op : ovl.Cigar) {
+        const auto opType = op.Type();
+        const int32_t opLen = op.Length();
+        const bool consumesQuery = opType == PacBio::BAM::CigarOperationType::ALIGNMENT_MATCH ||
+                                   opType == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH ||
+                                   opType == PacBio::BAM::CigarOperationType::SEQUENCE_MISMATCH ||
+                                   opType == PacBio::BAM::CigarOperationType::INSERTION;
+        const bool consumesTarget = opType == PacBio::BAM::CigarOperationType::ALIGNMENT_MATCH ||
+                                    opType == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH ||
+                                    opType == PacBio::BAM::CigarOperationType::SEQUENCE_MISMATCH ||
+                                    opType == PacBio::BAM::CigarOperationType::DELETION;
+        const bool isMatch = opType == PacBio::BAM::CigarOperationType::ALIGNMENT_MATCH ||
+                             opType == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH;
+
+        if (consumesQuery == false) {
+            Record();
+            tpos += consumesTarget ? opLen : 0;
+            continue;
+        }
+
+        // Fast path: the entire operation is outside of the range of interest.
+        if ((qpos + opLen) < qFrom || qpos > qTo) {
+            qpos += opLen;
+            tpos += consumesTarget ? opLen : 0;
+            numMatches += isMatch ? opLen : 0;
+            continue;
+        }
+
+        for (int32_t i = 0; i < opLen; ++i) {
+            Record();
+            ++qpos;
+            tpos += consumesTarget;
+            numMatches += isMatch;
+        }
+    }
+    Record();
+
+    // Clamp the positions which were not covered by the alignment.
+    int32_t firstSet = -1;
+    for (int32_t i = 0; i < n; ++i) {
+        if (matches[i] >= 0) {
+            firstSet = i;
+            break;
+        }
+    }
+    if (firstSet < 0) {
+        std::fill(matches.begin(), matches.end(), 0);
+        std::fill(targetPos.begin(), targetPos.end(), ovl.Bstart);
+        return;
+    }
+    for (int32_t i = 0; i < firstSet; ++i) {
+        matches[i] = matches[firstSet];
+        targetPos[i] = targetPos[firstSet];
+    }
+    for (int32_t i = firstSet + 1; i < n; ++i) {
+        if (matches[i] < 0) {
+            matches[i] = matches[i - 1];
+            targetPos[i] = targetPos[i - 1];
+        }
+    }
+}
+
+int32_t TargetPosToFwd(const Overlap& ovl, int32_t tpos)
+{
+    return ovl.Brev ? (ovl.Blen - tpos) : tpos;
+}
+
+/*
+ * Determines the query split point and the in-strand target positions of the junction
+ * between two consecutive mappings from their alignments only. Consecutive mappings are
+ * allowed to overlap in the query, in which case the split point is chosen to retain the
+ * maximum number of matches.
+*/
+void RefineJunctionFromAlignments(const Overlap& left, const Overlap& right,
+                                  int32_t& retQueryPos, int32_t& retLeftTargetPos,
+                                  int32_t& retRightTargetPos)
+{
+    // No overlap in query coordinates, nothing to refine.
+    if (left.Aend <= right.Astart) {
+        retQueryPos = left.Aend;
+        retLeftTargetPos = left.Bend;
+        retRightTargetPos = right.Bstart;
+        return;
+    }
+
+    const int32_t qFrom = right.Astart;
+    const int32_t qTo = left.Aend;
+
+    // Without the alignment, project the midpoint of the overlap over the diagonals.
+    if (left.Cigar.empty() || right.Cigar.empty()) {
+        const int32_t q = (qFrom + qTo) / 2;
+        retQueryPos = q;
+        retLeftTargetPos = std::max(left.Bstart, left.Bend - (left.Aend - q));
+        retRightTargetPos = std::min(right.Bend, right.Bstart + (q - right.Astart));
+        return;
+    }
+
+    std::vector<int32_t> leftMatches;
+    std::vector<int32_t> leftTargetPos;
+    std::vector<int32_t> rightMatches;
+    std::vector<int32_t> rightTargetPos;
+    ComputeAlignmentProfile(left, qFrom, qTo, leftMatches, leftTargetPos);
+    ComputeAlignmentProfile(right, qFrom, qTo, rightMatches, rightTargetPos);
+
+    // The left alignment keeps the matches before the split point, while the right
+    // alignment keeps the matches after the split point.
+    int32_t bestId = 0;
+    int32_t bestScore = leftMatches[0] - rightMatches[0];
+    for (int32_t i = 1; i < static_cast<int32_t>(leftMatches.size()); ++i) {
+        const int32_t score = leftMatches[i] - rightMatches[i];
+        if (score > bestScore) {
+            bestScore = score;
+            bestId = i;
+        }
+    }
+
+    retQueryPos = qFrom + bestId;
+    retLeftTargetPos = leftTargetPos[bestId];
+    retRightTargetPos = rightTargetPos[bestId];
+}
+
+/*
+ * Returns the in-strand target position aligned to the query position qpos, from the
+ * alignment if there is one, or by projecting along the diagonal of the mapping otherwise.
+ * The diagonal goes through the start of the mapping, or through its end if fromEnd is set.
+ * The end away from the junction should be used, because the mapping can be extended into
+ * the unrelated sequence on the other side of the junction.
+*/
+int32_t TargetPosAtQueryPos(const Overlap& ovl, int32_t qpos, bool fromEnd)
+{
+    if (ovl.Cigar.empty()) {
+        const int32_t tpos =
+            fromEnd ? (ovl.Bend - (ovl.Aend - qpos)) : (ovl.Bstart + (qpos - ovl.Astart));
+        return std::min(ovl.Bend, std::max(ovl.Bstart, tpos));
+    }
+    std::vector<int32_t> matches;
+    std::vector<int32_t> targetPos;
+    ComputeAlignmentProfile(ovl, qpos, qpos, matches, targetPos);
+    return targetPos[0];
+}
+
+/*
+ * Returns the bases [start, end) of the target in the strand of the mapping.
+*/
+std::string GetTargetInStrand(const FastaSequenceCached& targetSeq, bool targetRev, int32_t start,
+                              int32_t end)
+{
+    if (targetRev) {
+        return ReverseComplement(targetSeq.Bases() + (targetSeq.Size() - end), end - start, 0,
+                                 end - start);
+    }
+    return std::string(targetSeq.Bases() + start, end - start);
+}
+
+/*
+ * Aligns the query to the target, with both anchored at their starts, using a linear gap
+ * penalty. For each query prefix length i, stores the best score of aligning that prefix to
+ * any prefix of the target, and the length of the target prefix.
+*/
+void ComputePrefixScores(const std::string& query, const std::string& target,
+                         std::vector<int32_t>& bestScores, std::vector<int32_t>& bestTargetLens)
+{
+    const int32_t qlen = query.size();
+    const int32_t tlen = target.size();
+    bestScores.assign(qlen + 1, 0);
+    bestTargetLens.assign(qlen + 1, 0);
+
+    std::vector<int32_t> prev(tlen + 1, 0);
+    std::vector<int32_t> curr(tlen + 1, 0);
+    for (int32_t j = 0; j <= tlen; ++j) {
+        prev[j] = j * JUNCTION_GAP;
+    }
+    for (int32_t i = 1; i <= qlen; ++i) {
+        curr[0] = i * JUNCTION_GAP;
+        int32_t best = curr[0];
+        int32_t bestJ = 0;
+        for (int32_t j = 1; j <= tlen; ++j) {
+            const int32_t score =
+                (query[i - 1] == target[j - 1]) ? JUNCTION_MATCH : JUNCTION_MISMATCH;
+            const int32_t diag = prev[j - 1] + score;
+            curr[j] = std::max(diag, std::max(prev[j], curr[j - 1]) + JUNCTION_GAP);
+            if (curr[j] > best) {
+                best = curr[j];
+                bestJ = j;
+            }
+        }
+        bestScores[i] = best;
+        bestTargetLens[i] = bestJ;
+        std::swap(prev, curr);
+    }
+}
+
+/*
+ * Realigns the query around the junction between two consecutive mappings. The left side is
+ * extended forward from the left mapping, and the right side backward from the right mapping,
+ * over the same window of the query. The junction is placed where the sum of the two extension
+ * scores is maximal. The query bases between the two extensions are left unaligned, which gives
+ * the query gap, and the leftmost of the equally good junctions is chosen.
+ * Returns false if the junction cannot be realigned, e.g. when the mappings are too far apart.
+*/
+bool RealignJunction(const Overlap& left, const Overlap& right, const FastaSequenceCached& querySeq,
+                     const FastaSequenceCached& leftTargetSeq,
+                     const FastaSequenceCached& rightTargetSeq, int32_t& retQueryPos,
+                     int32_t& retQueryGap, int32_t& retLeftTargetPos, int32_t& retRightTargetPos)
+{
+    if (std::abs(right.Astart - left.Aend) > JUNCTION_MAX_REALIGN_DIST ||
+        querySeq.Size() != left.Alen || leftTargetSeq.Size() != left.Blen ||
+        rightTargetSeq.Size() != right.Blen) {
+        return false;
+    }
+
+    const int32_t qLo = std::max(left.Astart, std::min(left.Aend, right.Astart) - JUNCTION_FLANK);
+    const int32_t qHi = std::min(right.Aend, std::max(left.Aend, right.Astart) + JUNCTION_FLANK);
+    if (qHi <= qLo) {
+        return false;
+    }
+    const int32_t qSpan = qHi - qLo;
+    const std::string query(querySeq.Bases() + qLo, qSpan);
+
+    // The extension windows in the target, in the strand of each mapping.
+    const int32_t leftStart = TargetPosAtQueryPos(left, qLo, false);
+    const int32_t leftEnd = std::min(left.Blen, leftStart + qSpan + JUNCTION_FLANK);
+    const int32_t rightEnd = TargetPosAtQueryPos(right, qHi, true);
+    const int32_t rightStart = std::max(0, rightEnd - qSpan - JUNCTION_FLANK);
+    const std::string leftTarget = GetTargetInStrand(leftTargetSeq, left.Brev, leftStart, leftEnd);
+    std::string rightTarget = GetTargetInStrand(rightTargetSeq, right.Brev, rightStart, rightEnd);
+    std::reverse(rightTarget.begin(), rightTarget.end());
+    const std::string queryRev(query.rbegin(), query.rend());
+
+    std::vector<int32_t> leftScores;
+    std::vector<int32_t> leftTargetLens;
+    std::vector<int32_t> rightScores;
+    std::vector<int32_t> rightTargetLens;
+    ComputePrefixScores(query, leftTarget, leftScores, leftTargetLens);
+    ComputePrefixScores(queryRev, rightTarget, rightScores, rightTargetLens);
+
+    // The left extension ends at s1 and the right one starts at s2, with s1 <= s2.
+    int32_t bestScore = std::numeric_limits<int32_t>::min();
+    int32_t bestS1 = 0;
+    int32_t bestS2 = 0;
+    int32_t bestLeftScore = leftScores[0];
+    int32_t bestLeftS1 = 0;
+    for (int32_t s2 = 0; s2 <= qSpan; ++s2) {
+        if (leftScores[s2] > bestLeftScore) {
+            bestLeftScore = leftScores[s2];
+            bestLeftS1 = s2;
+        }
+        const int32_t score = bestLeftScore + rightScores[qSpan - s2];
+        if (score > bestScore) {
+            bestScore = score;
+            bestS1 = bestLeftS1;
+            bestS2 = s2;
+        }
+    }
+
+    retQueryPos = qLo + bestS1;
+    retQueryGap = bestS2 - bestS1;
+    retLeftTargetPos = leftStart + leftTargetLens[bestS1];
+    retRightTargetPos = rightEnd - rightTargetLens[qSpan - bestS2];
+    return true;
+}
+
+/*
+ * Collects the breakpoints of the primary and supplementary mappings, given with the non-null
+ * entries. If the querySeq is not null, the target sequence of each mapping is given in
+ * targetSeqs, and the junctions are realigned.
+*/
+std::vector<Breakpoint> ExtractBreakpointsImpl(
+    const std::vector<const Overlap*>& mappings, const FastaSequenceCached* querySeq,
+    const std::vector<const FastaSequenceCached*>& targetSeqs, int32_t queryId,
+    int32_t minSVLength)
+{
+    std::vector<Breakpoint> ret;
+
+    // Collect the primary and supplementary mappings, in the order of the query coordinates.
+    std::vector<int32_t> segments;
+    for (int32_t i = 0; i < static_cast<int32_t>(mappings.size()); ++i) {
+        if (mappings[i] != nullptr) {
+            segments.emplace_back(i);
+        }
+    }
+    std::sort(segments.begin(), segments.end(), [&](const int32_t a, const int32_t b) {
+        const auto& ao = mappings[a];
+        const auto& bo = mappings[b];
+        return std::tuple(ao->Astart, ao->Aend, a) < std::tuple(bo->Astart, bo->Aend, b);
+    });
+
+    // Large indels within each alignment.
+    for (const int32_t id : segments) {
+        auto indels = ExtractLargeIndelBreakpoints(*mappings[id], id, minSVLength);
+        for (auto& bp : indels) {
+            bp.queryId = queryId;
+        }
+        ret.insert(ret.end(), indels.begin(), indels.end());
+    }
+
+    // Junctions between consecutive mappings. Mappings contained within the previous
+    // one (in query coordinates) do not form a junction.
+    int32_t prevId = -1;
+    for (const int32_t currId : segments) {
+        if (prevId >= 0 && mappings[currId]->Aend <= mappings[prevId]->Aend) {
+            continue;
+        }
+        if (prevId < 0) {
+            prevId = currId;
+            continue;
+        }
+
+        const auto& left = *mappings[prevId];
+        const auto& right = *mappings[currId];
+
+        int32_t queryPos = 0;
+        int32_t queryGap = right.Astart - left.Aend;
+        int32_t leftTargetPos = 0;
+        int32_t rightTargetPos = 0;
+        if (querySeq == nullptr ||
+            RealignJunction(left, right, *querySeq, *targetSeqs[prevId], *targetSeqs[currId],
+                            queryPos, queryGap, leftTargetPos, rightTargetPos) == false) {
+            RefineJunctionFromAlignments(left, right, queryPos, leftTargetPos, rightTargetPos);
+        }
+
+        Breakpoint bp;
+        bp.type = BreakpointType::SplitRead;
+        bp.queryId = queryId;
+        bp.queryPos = queryPos;
+        bp.queryGap = queryGap;
+        bp.leftMappingId = prevId;
+        bp.leftTargetId = left.Bid;
+        bp.leftTargetRev = left.Brev;
+        bp.leftTargetPos = TargetPosToFwd(left, leftTargetPos);
+        bp.rightMappingId = currId;
+        bp.rightTargetId = right.Bid;
+        bp.rightTargetRev = right.Brev;
+        bp.rightTargetPos = TargetPosToFwd(right, rightTargetPos);
+
+        // Colinear mappings on the same target and strand are a large indel signature.
+        if (left.Bid == right.Bid && left.Brev == right.Brev && rightTargetPos >= leftTargetPos) {
+            const int32_t targetGap = rightTargetPos - leftTargetPos;
+            const int32_t clampedQueryGap = std::max(0, bp.queryGap);
+            const int32_t diff = targetGap - clampedQueryGap;
+            if (std::abs(diff) < minSVLength) {
+                prevId = currId;
+                continue;
+            }
+            bp.type = (diff > 0) ? BreakpointType::Deletion : BreakpointType::Insertion;
+            bp.svLen = std::abs(diff);
+        }
+
+        ret.emplace_back(bp);
+        prevId = currId;
+    }
+
+    std::sort(ret.begin(), ret.end(), [](const Breakpoint& a, const Breakpoint& b) {
+        return std::tuple(a.queryPos, a.leftMappingId, a.rightMappingId) <
+               std::tuple(b.queryPos, b.leftMappingId, b.rightMappingId);
+    });
+
+    return ret;
+}
+
+std::vector<const Overlap*> CollectPrimaryMappings(
+    const std::vector<std::unique_ptr<ChainedRegion>>& mappings)
+{
+    std::vector<const Overlap*> ret(mappings.size(), nullptr);
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        const auto& region = mappings[i];
+        if (region != nullptr && region->mapping != nullptr && region->priority == 0) {
+            ret[i] = region->mapping.get();
+        }
+    }
+    return ret;
+}
+
+std::vector<const Overlap*> CollectPrimaryMappings(const std::vector<OverlapPtr>& mappings)
+{
+    std::vector<const Overlap*> ret(mappings.size(), nullptr);
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        const auto& ovl = mappings[i];
+        if (ovl != nullptr && ovl->IsSecondary == false && ovl->IsFlipped == false) {
+            ret[i] = ovl.get();
+        }
+    }
+    return ret;
+}
+
+/*
+ * Formats the SA tag of the mapping given by mappingId, from the other non-null mappings.
+ * The target names are looked up only if the IDs are not written.
+*/
+std::string FormatSATagImpl(const std::vector<const Overlap*>& mappings, int32_t mappingId,
+                            const std::vector<const FastaSequenceCached*>& targetSeqs,
+                            bool writeIds)
+{
+    std::ostringstream oss;
+    int32_t numEntries = 0;
+    for (int32_t i = 0; i < static_cast<int32_t>(mappings.size()); ++i) {
+        const Overlap* ovl = mappings[i];
+        if (i == mappingId || ovl == nullptr) {
+            continue;
+        }
+
+        if (numEntries == 0) {
+            oss << "SA:Z:";
+        }
+        if (writeIds) {
+            char buff[100];
+            snprintf(buff, sizeof(buff), "%09d", ovl->Bid);
+            oss << buff;
+        } else {
+            oss << targetSeqs[i]->Name();
+        }
+        oss << "," << (ovl->BstartFwd() + 1) << "," << (ovl->Brev ? '-' : '+') << ",";
+
+        // The CIGAR is given in the fwd strand of the target, same as in the SAM output.
+        const int32_t clipFront = ovl->Brev ? (ovl->Alen - ovl->Aend) : ovl->Astart;
+        const int32_t clipBack = ovl->Brev ? ovl->Astart : (ovl->Alen - ovl->Aend);
+        if (clipFront > 0) {
+            oss << clipFront << "S";
+        }
+        if (ovl->Cigar.empty()) {
+            oss << ovl->ASpan() << "M";
+        } else if (ovl->Brev) {
+            for (auto it = ovl->Cigar.rbegin(); it != ovl->Cigar.rend(); ++it) {
+                oss << it->Length() << ConstexprTypeToChar(it->Type());
+            }
+        } else {
+            for (const auto& op : ovl->Cigar) {
+                oss << op.Length() << ConstexprTypeToChar(op.Type());
+            }
+        }
+        if (clipBack > 0) {
+            oss << clipBack << "S";
+        }
+        oss << "," << 60 << "," << std::max(0, ovl->EditDistance) << ";";
+        ++numEntries;
+    }
+    return oss.str();
+}
+
+}  // namespace
+
+std::vector<Breakpoint> ExtractLargeIndelBreakpoints(const Overlap& ovl, int32_t mappingId,
+                                                     int32_t minSVLength)
+{
+    std::vector<Breakpoint> ret;
+
+    int32_t qpos = ovl.Astart;
+    int32_t tpos = ovl.Bstart;
+    for (const auto& op : ovl.Cigar) {
+        const auto opType = op.Type();
+        const int32_t opLen = op.Length();
+
+        if (opType == PacBio::BAM::CigarOperationType::DELETION ||
+            opType == PacBio::BAM::CigarOperationType::INSERTION) {
+            const bool isDel = opType == PacBio::BAM::CigarOperationType::DELETION;
+            if (opLen >= minSVLength) {
+                Breakpoint bp;
+                bp.type = isDel ? BreakpointType::Deletion : BreakpointType::Insertion;
+                bp.queryId = ovl.Aid;
+                bp.queryPos = qpos;
+                bp.queryGap = isDel ? 0 : opLen;
+                bp.leftMappingId = mappingId;
+                bp.leftTargetId = ovl.Bid;
+                bp.leftTargetRev = ovl.Brev;
+                bp.leftTargetPos = TargetPosToFwd(ovl, tpos);
+                bp.rightMappingId = mappingId;
+                bp.rightTargetId = ovl.Bid;
+                bp.rightTargetRev = ovl.Brev;
+                bp.rightTargetPos = TargetPosToFwd(ovl, isDel ? (tpos + opLen) : tpos);
+                bp.svLen = opLen;
+                ret.emplace_back(bp);
+            }
+            qpos += isDel ? 0 : opLen;
+            tpos += isDel ? opLen : 0;
+
+        } else if (opType == PacBio::BAM::CigarOperationType::ALIGNMENT_MATCH ||
+                   opType == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH ||
+                   opType == PacBio::BAM::CigarOperationType::SEQUENCE_MISMATCH) {
+            qpos += opLen;
+            tpos += opLen;
+        } else if (opType == PacBio::BAM::CigarOperationType::REFERENCE_SKIP) {
+            tpos += opLen;
+        }
+    }
+
+    return ret;
+}
+
+std::vector<Breakpoint> ExtractBreakpoints(
+    const std::vector<std::unique_ptr<ChainedRegion>>& mappings, int32_t queryId,
+    int32_t minSVLength)
+{
+    return ExtractBreakpointsImpl(CollectPrimaryMappings(mappings), nullptr, {}, queryId,
+                                  minSVLength);
+}
+
+std::vector<Breakpoint> ExtractBreakpoints(
+    const std::vector<std::unique_ptr<ChainedRegion>>& mappings,
+    const FastaSequenceCached& querySeq, const std::vector<FastaSequenceCached>& targetSeqs,
+    int32_t queryId, int32_t minSVLength)
+{
+    const std::vector<const Overlap*> primary = CollectPrimaryMappings(mappings);
+    std::vector<const FastaSequenceCached*> mappingTargetSeqs(primary.size(), nullptr);
+    for (size_t i = 0; i < primary.size(); ++i) {
+        if (primary[i] != nullptr) {
+            mappingTargetSeqs[i] = &targetSeqs[primary[i]->Bid];
+        }
+    }
+    return ExtractBreakpointsImpl(primary, &querySeq, mappingTargetSeqs, queryId, minSVLength);
+}
+
+std::vector<Breakpoint> ExtractBreakpoints(const std::vector<OverlapPtr>& mappings,
+                                           const FastaSequenceCached& querySeq,
+                                           const SeqDBReaderCachedBlock& targetSeqs,
+                                           int32_t minSVLength)
+{
+    const std::vector<const Overlap*> primary = CollectPrimaryMappings(mappings);
+    std::vector<const FastaSequenceCached*> mappingTargetSeqs(primary.size(), nullptr);
+    for (size_t i = 0; i < primary.size(); ++i) {
+        if (primary[i] != nullptr) {
+            mappingTargetSeqs[i] = &targetSeqs.GetSequence(primary[i]->Bid);
+        }
+    }
+    return ExtractBreakpointsImpl(primary, &querySeq, mappingTargetSeqs, querySeq.Id(),
+                                  minSVLength);
+}
+
+std::string FormatSATag(const std::vector<std::unique_ptr<ChainedRegion>>& mappings,
+                        int32_t mappingId, const std::vector<FastaSequenceCached>& targetSeqs,
+                        bool writeIds)
+{
+    const std::vector<const Overlap*> primary = CollectPrimaryMappings(mappings);
+    std::vector<const FastaSequenceCached*> mappingTargetSeqs(primary.size(), nullptr);
+    for (size_t i = 0; i < primary.size(); ++i) {
+        if (primary[i] != nullptr && writeIds == false) {
+            mappingTargetSeqs[i] = &targetSeqs[primary[i]->Bid];
+        }
+    }
+    return FormatSATagImpl(primary, mappingId, mappingTargetSeqs, writeIds);
+}
+
+std::string FormatSATag(const std::vector<OverlapPtr>& mappings, int32_t mappingId,
+                        const SeqDBReaderCachedBlock& targetSeqs, bool writeIds)
+{
+    const std::vector<const Overlap*> primary = CollectPrimaryMappings(mappings);
+    std::vector<const FastaSequenceCached*> mappingTargetSeqs(primary.size(), nullptr);
+    for (size_t i = 0; i < primary.size(); ++i) {
+        if (primary[i] != nullptr && writeIds == false) {
+            mappingTargetSeqs[i] = &targetSeqs.GetSequence(primary[i]->Bid);
+        }
+    }
+    return FormatSATagImpl(primary, mappingId, mappingTargetSeqs, writeIds);
+}
+
+void PrintBreakpointAsBEDPE(FILE* fpOut, const Breakpoint& bp, const std::string& queryName,
+                            const std::string& leftTargetName, const std::string& rightTargetName)
+{
+    // Each side is reported as the 1bp interval of the aligned base adjacent to the junction.
+    // The positions are boundaries in the fwd strand, so on the reverse strand the last base
+    // of the left mapping follows the boundary, and the first base of the right one precedes it.
+    const int32_t leftStart =
+        bp.leftTargetRev ? bp.leftTargetPos : std::max(0, bp.leftTargetPos - 1);
+    const int32_t rightStart =
+        bp.rightTargetRev ? std::max(0, bp.rightTargetPos - 1) : bp.rightTargetPos;
+    fprintf(fpOut, "%s\t%d\t%d\t%s\t%d\t%d\t%s\t.\t%c\t%c\t%s\t%d\t%d\t%d\n",
+            leftTargetName.c_str(), leftStart, leftStart + 1, rightTargetName.c_str(), rightStart,
+            rightStart + 1, queryName.c_str(), (bp.leftTargetRev ? '-' : '+'),
+            (bp.rightTargetRev ? '-' : '+'), BreakpointTypeToString(bp.type).c_str(), bp.queryPos,
+            bp.queryGap, bp.svLen);
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
@@ -0,0 +1,99 @@
+// Author: Ivan Sovic
+
+#include <pacbio/pancake/CandidatePairs.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace PacBio {
+namespace Pancake {
+
+CandidateStrand ParseCandidateStrand(const std::string& val)
+{
+    if (val == "+" || val == "0") {
+        return CandidateStrand::Forward;
+    } else if (val == "-" || val == "1") {
+        return CandidateStrand::Reverse;
+    } else if (val == "*") {
+        return CandidateStrand::Any;
+    }
+    throw std::runtime_error("Invalid strand '" + val +
+                             "' in the pair list. Valid values are: '+', '-', '0', '1' and '*'.");
+}
+
+bool ParseCandidatePairLine(const std::string& line, std::string& retQuery,
+                            std::string& retTarget, CandidateStrand& retStrand)
+{
+    std::istringstream iss(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (iss >> token) {
+        tokens.emplace_back(token);
+    }
+    if (tokens.empty() || tokens[0][0] == '#') {
+        return false;
+    }
+    if (tokens.size() < 2 || tokens.size() > 3) {
+        throw std::runtime_error("Malformed line in the pair list: '" + line +
+                                 "'. Expected: <query> <target> [strand].");
+    }
+    retQuery = tokens[0];
+    retTarget = tokens[1];
+    retStrand = (tokens.size() == 3) ? ParseCandidateStrand(tokens[2]) : CandidateStrand::Any;
+    return true;
+}
+
+std::vector<CandidatePair> ReadCandidatePairs(std::istream& is,
+                                              const SeqDBIndexCache& querySeqDBCache,
+                                              const SeqDBIndexCache& targetSeqDBCache,
+                                              bool useIds)
+{
+    std::vector<CandidatePair> ret;
+    std::string line;
+    std::string queryName;
+    std::string targetName;
+    CandidateStrand strand = CandidateStrand::Any;
+    while (std::getline(is, line)) {
+        if (ParseCandidatePairLine(line, queryName, targetName, strand) == false) {
+            continue;
+        }
+        CandidatePair pair;
+        pair.queryId = GetSequenceIdFromHeader(queryName, useIds, querySeqDBCache);
+        pair.targetId = GetSequenceIdFromHeader(targetName, useIds, targetSeqDBCache);
+        pair.strand = strand;
+        if (pair.queryId < 0 ||
+            pair.queryId >= static_cast<int32_t>(querySeqDBCache.seqLines.size()) ||
+            pair.targetId < 0 ||
+            pair.targetId >= static_cast<int32_t>(targetSeqDBCache.seqLines.size())) {
+            throw std::runtime_error("Sequence ID out of bounds in the pair list line: '" + line +
+                                     "'.");
+        }
+        ret.emplace_back(pair);
+    }
+    return ret;
+}
+
+void NormalizeCandidatePairs(std::vector<CandidatePair>& pairs)
+{
+    std::sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
+        return std::make_tuple(a.queryId, a.targetId, static_cast<int32_t>(a.strand)) <
+               std::make_tuple(b.queryId, b.targetId, static_cast<int32_t>(b.strand));
+    });
+    size_t numKept = 0;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        if (numKept > 0 && pairs[numKept - 1].queryId == pairs[i].queryId &&
+            pairs[numKept - 1].targetId == pairs[i].targetId) {
+            if (pairs[numKept - 1].strand != pairs[i].strand) {
+                pairs[numKept - 1].strand = CandidateStrand::Any;
+            }
+            continue;
+        }
+        pairs[numKept] = pairs[i];
+        ++numKept;
+    }
+    pairs.resize(numKept);
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
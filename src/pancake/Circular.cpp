@@ -0,0 +1,158 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/Circular.h>
+#include <algorithm>
+#include <cstdlib>
+#include <tuple>
+
+namespace PacBio {
+namespace Pancake {
+
+namespace {
+
+int32_t GetCircularLength(const std::vector<int32_t>& circularLengths, int32_t seqId)
+{
+    if (seqId < 0 || seqId >= static_cast<int32_t>(circularLengths.size())) {
+        return 0;
+    }
+    return circularLengths[seqId];
+}
+
+// Wraps an overlap where the B-read is the unrolled circular target.
+void WrapOverlap(Overlap& ovl, int32_t circLen, int32_t allowedDovetailDist)
+{
+    int32_t bStart = ovl.BstartFwd();
+    int32_t bEnd = ovl.BendFwd();
+    if (bStart >= circLen) {
+        bStart -= circLen;
+        bEnd -= circLen;
+    }
+    ovl.Blen = circLen;
+    // Internally, the coordinates are in the strand of the B-read. The reverse strand start
+    // is wrapped modulo the circular length if the overlap spans the origin.
+    ovl.Bstart = ovl.Brev ? (circLen - bEnd) : bStart;
+    ovl.Bend = ovl.Brev ? (circLen - bStart) : bEnd;
+    if (ovl.Bstart < 0) {
+        ovl.Bstart += circLen;
+        ovl.Bend += circLen;
+    }
+
+    const bool isAContained = ovl.AstartFwd() <= allowedDovetailDist &&
+                              (ovl.Alen - ovl.AendFwd()) <= allowedDovetailDist;
+    const bool isBContained = (bEnd - bStart) >= (circLen - allowedDovetailDist);
+    if (isAContained) {
+        ovl.Atype = OverlapType::Contained;
+        ovl.Btype = OverlapType::Contains;
+    } else if (isBContained) {
+        ovl.Atype = OverlapType::Contains;
+        ovl.Btype = OverlapType::Contained;
+    } else {
+        ovl.Atype = OverlapType::Internal;
+        ovl.Btype = OverlapType::Internal;
+    }
+}
+
+}  // namespace
+
+std::vector<SeedDB::SeedRaw> UnrollCircularSeeds(const SeedDB::SeedRaw* seeds, int64_t numSeeds,
+                                                 const std::vector<int32_t>& circularLengths)
+{
+    std::vector<SeedDB::SeedRaw> ret;
+    ret.reserve(numSeeds);
+    int64_t runStart = 0;
+    for (int64_t i = 0; i <= numSeeds; ++i) {
+        // Find the end of the run of seeds of the same sequence.
+        if (i < numSeeds && SeedDB::Seed::DecodeSeqId(seeds[i]) ==
+                                SeedDB::Seed::DecodeSeqId(seeds[runStart])) {
+            continue;
+        }
+        if (i == runStart) {
+            break;
+        }
+        ret.insert(ret.end(), seeds + runStart, seeds + i);
+        const int32_t seqId = SeedDB::Seed::DecodeSeqId(seeds[runStart]);
+        const int32_t circLen = GetCircularLength(circularLengths, seqId);
+        if (circLen > 0) {
+            for (int64_t j = runStart; j < i; ++j) {
+                const SeedDB::Seed seed(seeds[j]);
+                const int32_t pos = seed.pos + circLen;
+                if ((pos + static_cast<int32_t>(seed.span)) > (2 * circLen)) {
+                    continue;
+                }
+                ret.emplace_back(
+                    SeedDB::Seed::Encode(seed.key, seed.span, seed.seqID, pos, seed.seqRev));
+            }
+        }
+        runStart = i;
+    }
+    return ret;
+}
+
+void WrapCircularOverlaps(std::vector<OverlapPtr>& overlaps,
+                          const std::vector<int32_t>& circularLengths, int32_t allowedDovetailDist,
+                          int32_t diagonalBandwidth)
+{
+    // Wrap the overlaps in the context where the B-read is the target.
+    std::vector<int32_t> wrapped;
+    std::vector<bool> isFlipped(overlaps.size(), false);
+    for (int32_t i = 0; i < static_cast<int32_t>(overlaps.size()); ++i) {
+        auto& ovl = overlaps[i];
+        const int32_t targetId = ovl->IsFlipped ? ovl->Aid : ovl->Bid;
+        const int32_t circLen = GetCircularLength(circularLengths, targetId);
+        if (circLen <= 0) {
+            continue;
+        }
+        isFlipped[i] = ovl->IsFlipped;
+        if (isFlipped[i]) {
+            ovl->Flip();
+        }
+        WrapOverlap(*ovl, circLen, allowedDovetailDist);
+        wrapped.emplace_back(i);
+    }
+
+    // Mark the duplicates from the two copies of the unrolled target. Sorting by the score
+    // keeps the best of the duplicates.
+    std::stable_sort(wrapped.begin(), wrapped.end(), [&](int32_t a, int32_t b) {
+        const auto& ovlA = overlaps[a];
+        const auto& ovlB = overlaps[b];
+        return std::make_tuple(isFlipped[a], ovlA->Aid, ovlA->Bid, ovlA->Brev, ovlA->Score) <
+               std::make_tuple(isFlipped[b], ovlB->Aid, ovlB->Bid, ovlB->Brev, ovlB->Score);
+    });
+    std::vector<bool> isDuplicate(overlaps.size(), false);
+    for (size_t i = 0; i < wrapped.size(); ++i) {
+        const auto& ovlI = overlaps[wrapped[i]];
+        if (isDuplicate[wrapped[i]]) {
+            continue;
+        }
+        const int32_t diagI = ovlI->Bstart - ovlI->Astart;
+        for (size_t j = i + 1; j < wrapped.size(); ++j) {
+            const auto& ovlJ = overlaps[wrapped[j]];
+            if (isFlipped[wrapped[j]] != isFlipped[wrapped[i]] || ovlJ->Aid != ovlI->Aid ||
+                ovlJ->Bid != ovlI->Bid || ovlJ->Brev != ovlI->Brev) {
+                break;
+            }
+            const int32_t diagDist = std::abs(ovlJ->Bstart - ovlJ->Astart - diagI) % ovlI->Blen;
+            if (std::min(diagDist, ovlI->Blen - diagDist) <= diagonalBandwidth) {
+                isDuplicate[wrapped[j]] = true;
+            }
+        }
+    }
+
+    // Restore the flipped overlaps, and remove the duplicates while keeping the order.
+    for (const int32_t i : wrapped) {
+        if (isFlipped[i]) {
+            overlaps[i]->Flip();
+        }
+    }
+    std::vector<OverlapPtr> ret;
+    ret.reserve(overlaps.size());
+    for (size_t i = 0; i < overlaps.size(); ++i) {
+        if (isDuplicate[i] == false) {
+            ret.emplace_back(std::move(overlaps[i]));
+        }
+    }
+    std::swap(overlaps, ret);
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
@@ -0,0 +1,293 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/alignment/Ses2AlignBanded.hpp>
+#include <pacbio/pancake/DuplicateReads.h>
+#include <pacbio/pancake/Lookups.h>
+#include <pacbio/pancake/Minimizers.h>
+#include <pacbio/util/Util.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace PacBio {
+namespace Pancake {
+
+// Buckets larger than this come from the repetitive k-mers, and are skipped.
+static const int32_t MAX_SKETCH_BUCKET_SIZE = 1000;
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+ReadFingerprint ComputeReadFingerprint(const char* seq, int32_t seqLen, int32_t kmerSize,
+                                       int32_t sketchSize)
+{
+    if (kmerSize <= 0 || kmerSize > 32) {
+        throw std::runtime_error("Invalid k-mer size in ComputeReadFingerprint: " +
+                                 std::to_string(kmerSize) + ". It needs to be in [1, 32].");
+    }
+
+    ReadFingerprint ret;
+    ret.length = seqLen;
+
+    // Whole-read hashes of both strands, case insensitive.
+    uint64_t hashFwd = FNV_OFFSET_BASIS;
+    uint64_t hashRev = FNV_OFFSET_BASIS;
+    for (int32_t i = 0; i < seqLen; ++i) {
+        const uint8_t baseFwd = std::toupper(static_cast<uint8_t>(seq[i]));
+        const uint8_t baseRev = std::toupper(static_cast<uint8_t>(
+            BaseToBaseComplement[static_cast<uint8_t>(seq[seqLen - 1 - i])]));
+        hashFwd = (hashFwd ^ baseFwd) * FNV_PRIME;
+        hashRev = (hashRev ^ baseRev) * FNV_PRIME;
+    }
+    ret.isRev = hashRev < hashFwd;
+    ret.hash = std::min(hashFwd, hashRev);
+
+    if (sketchSize <= 0) {
+        return ret;
+    }
+
+    // Bottom-s sketch of the canonical k-mers.
+    const uint64_t mask = (kmerSize == 32) ? ~0ULL : ((1ULL << (2 * kmerSize)) - 1);
+    const int32_t shiftRev = 2 * (kmerSize - 1);
+    uint64_t kmerFwd = 0;
+    uint64_t kmerRev = 0;
+    int32_t validLen = 0;
+    for (int32_t i = 0; i < seqLen; ++i) {
+        const int8_t twobit = BaseToTwobit[static_cast<uint8_t>(seq[i])];
+        if (twobit > 3) {
+            validLen = 0;
+            kmerFwd = kmerRev = 0;
+            continue;
+        }
+        kmerFwd = ((kmerFwd << 2) | twobit) & mask;
+        kmerRev = (kmerRev >> 2) | (static_cast<uint64_t>(3 - twobit) << shiftRev);
+        ++validLen;
+        if (validLen < kmerSize) {
+            continue;
+        }
+        const uint64_t hash = SeedDB::InvertibleHash(std::min(kmerFwd, kmerRev), mask);
+        auto& sketch = ret.sketch;
+        if (static_cast<int32_t>(sketch.size()) == sketchSize && hash >= sketch.back()) {
+            continue;
+        }
+        const auto it = std::lower_bound(sketch.begin(), sketch.end(), hash);
+        if (it != sketch.end() && *it == hash) {
+            continue;
+        }
+        sketch.insert(it, hash);
+        if (static_cast<int32_t>(sketch.size()) > sketchSize) {
+            sketch.pop_back();
+        }
+    }
+
+    return ret;
+}
+
+double EstimateSketchJaccard(const std::vector<uint64_t>& sketchA,
+                             const std::vector<uint64_t>& sketchB, int32_t sketchSize)
+{
+    int32_t numUnion = 0;
+    int32_t numShared = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (numUnion < sketchSize && (i < sketchA.size() || j < sketchB.size())) {
+        if (j == sketchB.size() || (i < sketchA.size() && sketchA[i] < sketchB[j])) {
+            ++i;
+        } else if (i == sketchA.size() || sketchB[j] < sketchA[i]) {
+            ++j;
+        } else {
+            ++numShared;
+            ++i;
+            ++j;
+        }
+        ++numUnion;
+    }
+    if (numUnion == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(numShared) / static_cast<double>(numUnion);
+}
+
+std::vector<std::pair<int32_t, int32_t>> FindExactDuplicateCandidates(
+    const std::vector<ReadFingerprint>& fingerprints)
+{
+    std::vector<int32_t> ids(fingerprints.size());
+    for (int32_t i = 0; i < static_cast<int32_t>(ids.size()); ++i) {
+        ids[i] = i;
+    }
+    std::sort(ids.begin(), ids.end(), [&](int32_t a, int32_t b) {
+        return std::make_tuple(fingerprints[a].hash, fingerprints[a].length, a) <
+               std::make_tuple(fingerprints[b].hash, fingerprints[b].length, b);
+    });
+
+    std::vector<std::pair<int32_t, int32_t>> ret;
+    size_t first = 0;
+    for (size_t i = 1; i < ids.size(); ++i) {
+        const auto& fpFirst = fingerprints[ids[first]];
+        const auto& fp = fingerprints[ids[i]];
+        if (fp.hash != fpFirst.hash || fp.length != fpFirst.length) {
+            first = i;
+            continue;
+        }
+        ret.emplace_back(ids[first], ids[i]);
+    }
+    return ret;
+}
+
+std::vector<std::pair<int32_t, int32_t>> FindNearDuplicateCandidates(
+    const std::vector<ReadFingerprint>& fingerprints, const std::vector<int32_t>& readIds,
+    double minLengthRatio, double minJaccard, int32_t sketchSize)
+{
+    // Bucket the reads by every value of their sketches, so that a pair is found if it shares
+    // any of them.
+    std::vector<std::pair<uint64_t, int32_t>> buckets;
+    for (const int32_t readId : readIds) {
+        for (const uint64_t value : fingerprints[readId].sketch) {
+            buckets.emplace_back(value, readId);
+        }
+    }
+    std::sort(buckets.begin(), buckets.end());
+
+    // Within a bucket, only the reads of similar lengths are paired.
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    std::vector<int32_t> members;
+    size_t start = 0;
+    while (start < buckets.size()) {
+        size_t end = start + 1;
+        while (end < buckets.size() && buckets[end].first == buckets[start].first) {
+            ++end;
+        }
+        const int32_t bucketSize = end - start;
+        if (bucketSize < 2 || bucketSize > MAX_SKETCH_BUCKET_SIZE) {
+            start = end;
+            continue;
+        }
+
+        members.clear();
+        for (size_t i = start; i < end; ++i) {
+            members.emplace_back(buckets[i].second);
+        }
+        std::sort(members.begin(), members.end(), [&](int32_t a, int32_t b) {
+            return std::make_pair(fingerprints[a].length, a) <
+                   std::make_pair(fingerprints[b].length, b);
+        });
+        for (size_t i = 0; i < members.size(); ++i) {
+            const auto& fpA = fingerprints[members[i]];
+            for (size_t j = i + 1; j < members.size(); ++j) {
+                const auto& fpB = fingerprints[members[j]];
+                if (fpA.length < minLengthRatio * fpB.length) {
+                    break;
+                }
+                pairs.emplace_back(members[i], members[j]);
+            }
+        }
+        start = end;
+    }
+
+    // The same pair usually shares many buckets, so the similarity is estimated once per pair.
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    std::vector<std::pair<int32_t, int32_t>> ret;
+    for (const auto& pair : pairs) {
+        if (EstimateSketchJaccard(fingerprints[pair.first].sketch,
+                                  fingerprints[pair.second].sketch, sketchSize) >= minJaccard) {
+            ret.emplace_back(pair);
+        }
+    }
+    return ret;
+}
+
+int32_t AlignDuplicateCandidate(const char* seqA, int32_t lenA, const char* seqB, int32_t lenB,
+                                double maxDiffRate, bool& isRev,
+                                std::shared_ptr<Alignment::SESScratchSpace> ss)
+{
+    isRev = false;
+    if (lenA <= 0 || lenB <= 0) {
+        return -1;
+    }
+    const int32_t maxDiffs = std::abs(lenA - lenB) +
+                             static_cast<int32_t>(std::ceil(maxDiffRate * std::min(lenA, lenB)));
+    // The band is pruned to diagonals within half of the bandwidth from the furthest one, and
+    // the bandwidth cannot be larger than the diff limit. The limit is doubled so that the length
+    // difference fits in the band, and the number of diffs is checked after the alignment.
+    const int32_t diffLimit = 2 * maxDiffs + 2;
+
+    auto aln = Alignment::SES2AlignBanded<Alignment::SESAlignMode::Global,
+                                          Alignment::SESTrimmingMode::Disabled,
+                                          Alignment::SESTracebackMode::Disabled>(
+        seqB, lenB, seqA, lenA, diffLimit, diffLimit, ss);
+    if (aln.valid && aln.numDiffs <= maxDiffs) {
+        return aln.numDiffs;
+    }
+
+    const std::string seqBRev = ReverseComplement(seqB, lenB, 0, lenB);
+    aln = Alignment::SES2AlignBanded<Alignment::SESAlignMode::Global,
+                                     Alignment::SESTrimmingMode::Disabled,
+                                     Alignment::SESTracebackMode::Disabled>(
+        seqBRev.c_str(), lenB, seqA, lenA, diffLimit, diffLimit, ss);
+    if (aln.valid && aln.numDiffs <= maxDiffs) {
+        isRev = true;
+        return aln.numDiffs;
+    }
+
+    return -1;
+}
+
+DuplicateGroups::DuplicateGroups(int32_t numReads) : parents_(numReads)
+{
+    for (int32_t i = 0; i < numReads; ++i) {
+        parents_[i] = i;
+    }
+}
+
+int32_t DuplicateGroups::Find(int32_t readId)
+{
+    int32_t root = readId;
+    while (parents_[root] != root) {
+        root = parents_[root];
+    }
+    // Path compression.
+    while (parents_[readId] != root) {
+        const int32_t next = parents_[readId];
+        parents_[readId] = root;
+        readId = next;
+    }
+    return root;
+}
+
+void DuplicateGroups::Join(int32_t readIdA, int32_t readIdB)
+{
+    const int32_t rootA = Find(readIdA);
+    const int32_t rootB = Find(readIdB);
+    if (rootA == rootB) {
+        return;
+    }
+    // The lower ID becomes the root, which keeps the result independent of the join order.
+    parents_[std::max(rootA, rootB)] = std::min(rootA, rootB);
+}
+
+std::vector<int32_t> DuplicateGroups::Representatives(
+    const std::vector<ReadFingerprint>& fingerprints)
+{
+    const int32_t numReads = parents_.size();
+    std::vector<int32_t> best(numReads, -1);
+    for (int32_t i = 0; i < numReads; ++i) {
+        const int32_t root = Find(i);
+        if (best[root] < 0 || fingerprints[i].length > fingerprints[best[root]].length) {
+            best[root] = i;
+        }
+    }
+    std::vector<int32_t> ret(numReads);
+    for (int32_t i = 0; i < numReads; ++i) {
+        ret[i] = best[Find(i)];
+    }
+    return ret;
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
@@ -0,0 +1,351 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/HPCCoordinateMap.h>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace PacBio {
+namespace Pancake {
+
+// Number of HPC positions between two stored raw positions. This bounds the number of run
+// lengths summed up in each conversion.
+static const int32_t HPC_MAP_SAMPLE_INTERVAL = 64;
+
+// Runs of this length or longer are stored in the long runs, and marked with 0.
+static const int32_t HPC_MAP_MAX_SHORT_RUN = 255;
+
+void HPCCoordinateMap::AddSequence(int32_t seqId, const int32_t* runLengths, int32_t hpcLen)
+{
+    SequenceInfo info;
+    info.runStart = runs_.size();
+    info.sampleStart = samples_.size();
+    info.hpcLen = hpcLen;
+
+    int32_t rawPos = 0;
+    for (int32_t i = 0; i < hpcLen; ++i) {
+        if ((i % HPC_MAP_SAMPLE_INTERVAL) == 0) {
+            samples_.emplace_back(rawPos);
+        }
+        const int32_t runLen = runLengths[i];
+        if (runLen <= 0) {
+            throw std::runtime_error("Invalid run length " + std::to_string(runLen) +
+                                     " in HPCCoordinateMap::AddSequence, seqId = " +
+                                     std::to_string(seqId) + ".");
+        }
+        if (runLen >= HPC_MAP_MAX_SHORT_RUN) {
+            longRuns_[runs_.size()] = runLen;
+            runs_.emplace_back(0);
+        } else {
+            runs_.emplace_back(runLen);
+        }
+        rawPos += runLen;
+    }
+    // The end of the sequence is the last sample if it falls on the interval.
+    if ((hpcLen % HPC_MAP_SAMPLE_INTERVAL) == 0) {
+        samples_.emplace_back(rawPos);
+    }
+    info.rawLen = rawPos;
+
+    seqs_[seqId] = info;
+}
+
+void HPCCoordinateMap::Clear()
+{
+    runs_.clear();
+    samples_.clear();
+    longRuns_.clear();
+    seqs_.clear();
+}
+
+bool HPCCoordinateMap::HasSequence(int32_t seqId) const { return seqs_.count(seqId) > 0; }
+
+int32_t HPCCoordinateMap::HPCLength(int32_t seqId) const
+{
+    return GetSequenceInfo_(seqId).hpcLen;
+}
+
+int32_t HPCCoordinateMap::RawLength(int32_t seqId) const
+{
+    return GetSequenceInfo_(seqId).rawLen;
+}
+
+int32_t HPCCoordinateMap::RunLength(int32_t seqId, int32_t hpcPos) const
+{
+    const auto& info = GetSequenceInfo_(seqId);
+    if (hpcPos < 0 || hpcPos >= info.hpcLen) {
+        throw std::runtime_error("HPC position " + std::to_string(hpcPos) +
+                                 " out of bounds in HPCCoordinateMap::RunLength, seqId = " +
+                                 std::to_string(seqId) + ".");
+    }
+    return RunAt_(info.runStart + hpcPos);
+}
+
+std::vector<int32_t> HPCCoordinateMap::RunLengths(int32_t seqId, int32_t hpcStart,
+                                                  int32_t hpcEnd) const
+{
+    const auto& info = GetSequenceInfo_(seqId);
+    if (hpcStart < 0 || hpcStart > hpcEnd || hpcEnd > 2 * info.hpcLen) {
+        std::ostringstream oss;
+        oss << "Invalid HPC range in HPCCoordinateMap::RunLengths: seqId = " << seqId
+            << ", hpcStart = " << hpcStart << ", hpcEnd = " << hpcEnd
+            << ", hpcLen = " << info.hpcLen << ".";
+        throw std::runtime_error(oss.str());
+    }
+    std::vector<int32_t> ret(hpcEnd - hpcStart);
+    for (int32_t i = hpcStart; i < hpcEnd; ++i) {
+        const int32_t pos = (i < info.hpcLen) ? i : (i - info.hpcLen);
+        ret[i - hpcStart] = RunAt_(info.runStart + pos);
+    }
+    return ret;
+}
+
+int32_t HPCCoordinateMap::ToRaw(int32_t seqId, int32_t hpcPos) const
+{
+    const auto& info = GetSequenceInfo_(seqId);
+    if (hpcPos < 0 || hpcPos > info.hpcLen) {
+        throw std::runtime_error("HPC position " + std::to_string(hpcPos) +
+                                 " out of bounds in HPCCoordinateMap::ToRaw, seqId = " +
+                                 std::to_string(seqId) + ".");
+    }
+    const int32_t sampleId = hpcPos / HPC_MAP_SAMPLE_INTERVAL;
+    int32_t rawPos = samples_[info.sampleStart + sampleId];
+    for (int32_t i = sampleId * HPC_MAP_SAMPLE_INTERVAL; i < hpcPos; ++i) {
+        rawPos += RunAt_(info.runStart + i);
+    }
+    return rawPos;
+}
+
+int32_t HPCCoordinateMap::ToHPC(int32_t seqId, int32_t rawPos) const
+{
+    const auto& info = GetSequenceInfo_(seqId);
+    if (rawPos < 0 || rawPos > info.rawLen) {
+        throw std::runtime_error("Raw position " + std::to_string(rawPos) +
+                                 " out of bounds in HPCCoordinateMap::ToHPC, seqId = " +
+                                 std::to_string(seqId) + ".");
+    }
+    if (rawPos == info.rawLen) {
+        return info.hpcLen;
+    }
+
+    // Find the last sample at or before the raw position.
+    const int64_t numSamples =
+        (info.hpcLen + HPC_MAP_SAMPLE_INTERVAL - 1) / HPC_MAP_SAMPLE_INTERVAL;
+    const auto samplesBegin = samples_.begin() + info.sampleStart;
+    const auto it = std::upper_bound(samplesBegin, samplesBegin + numSamples, rawPos);
+    const int32_t sampleId = (it - samplesBegin) - 1;
+
+    int32_t hpcPos = sampleId * HPC_MAP_SAMPLE_INTERVAL;
+    int32_t runStart = *(it - 1);
+    while (true) {
+        const int32_t runEnd = runStart + RunAt_(info.runStart + hpcPos);
+        if (rawPos < runEnd) {
+            break;
+        }
+        runStart = runEnd;
+        ++hpcPos;
+    }
+    return hpcPos;
+}
+
+std::string HPCCoordinateMap::ExpandSequence(int32_t seqId, const char* hpcSeq, int32_t hpcStart,
+                                             int32_t hpcEnd) const
+{
+    const auto& info = GetSequenceInfo_(seqId);
+    if (hpcStart < 0 || hpcStart > hpcEnd || hpcEnd > info.hpcLen) {
+        std::ostringstream oss;
+        oss << "Invalid HPC range in HPCCoordinateMap::ExpandSequence: seqId = " << seqId
+            << ", hpcStart = " << hpcStart << ", hpcEnd = " << hpcEnd
+            << ", hpcLen = " << info.hpcLen << ".";
+        throw std::runtime_error(oss.str());
+    }
+    std::string ret;
+    ret.reserve(ToRaw(seqId, hpcEnd) - ToRaw(seqId, hpcStart));
+    for (int32_t i = hpcStart; i < hpcEnd; ++i) {
+        ret.append(RunAt_(info.runStart + i), hpcSeq[i]);
+    }
+    return ret;
+}
+
+int64_t HPCCoordinateMap::MemoryUsage() const
+{
+    return runs_.capacity() * sizeof(uint8_t) + samples_.capacity() * sizeof(int32_t) +
+           longRuns_.size() * (sizeof(int64_t) + sizeof(int32_t)) +
+           seqs_.size() * (sizeof(int32_t) + sizeof(SequenceInfo));
+}
+
+const HPCCoordinateMap::SequenceInfo& HPCCoordinateMap::GetSequenceInfo_(int32_t seqId) const
+{
+    const auto it = seqs_.find(seqId);
+    if (it == seqs_.end()) {
+        throw std::runtime_error("Sequence with ID " + std::to_string(seqId) +
+                                 " not found in the HPCCoordinateMap.");
+    }
+    return it->second;
+}
+
+int32_t HPCCoordinateMap::RunAt_(int64_t runPos) const
+{
+    const int32_t runLen = runs_[runPos];
+    return (runLen == 0) ? longRuns_.at(runPos) : runLen;
+}
+
+namespace {
+
+void AddCigarOp(PacBio::BAM::Cigar& cigar, PacBio::BAM::CigarOperationType type, int32_t len)
+{
+    if (len <= 0) {
+        return;
+    }
+    if (cigar.empty() == false && cigar.back().Type() == type) {
+        cigar.back().Length(cigar.back().Length() + len);
+        return;
+    }
+    cigar.emplace_back(PacBio::BAM::CigarOperation(type, len));
+}
+
+// Lifts an HPC position which can be past the HPC length, in a circular sequence.
+int32_t LiftPosition(const HPCCoordinateMap& map, int32_t seqId, int32_t hpcPos)
+{
+    const int32_t hpcLen = map.HPCLength(seqId);
+    if (hpcPos > hpcLen) {
+        return map.RawLength(seqId) + map.ToRaw(seqId, hpcPos - hpcLen);
+    }
+    return map.ToRaw(seqId, hpcPos);
+}
+
+char VariantAt(const std::string& vars, int32_t pos)
+{
+    if (pos >= static_cast<int32_t>(vars.size())) {
+        throw std::runtime_error(
+            "The variant string is shorter than the CIGAR in LiftOverlapToRaw. vars.size() = " +
+            std::to_string(vars.size()) + ", pos = " + std::to_string(pos) + ".");
+    }
+    return vars[pos];
+}
+
+}  // namespace
+
+void LiftOverlapToRaw(Overlap& ovl, const HPCCoordinateMap& aMap, const HPCCoordinateMap& bMap,
+                      const char* aSeqHPC)
+{
+    using PacBio::BAM::CigarOperationType;
+
+    if (ovl.Arev) {
+        throw std::runtime_error("The A-read should always be forward oriented. (In "
+                                 "LiftOverlapToRaw.)");
+    }
+    if (aMap.HPCLength(ovl.Aid) != ovl.Alen || bMap.HPCLength(ovl.Bid) != ovl.Blen) {
+        std::ostringstream oss;
+        oss << "The overlap lengths do not match the HPC lengths in LiftOverlapToRaw. Aid = "
+            << ovl.Aid << ", Alen = " << ovl.Alen << ", HPC Alen = " << aMap.HPCLength(ovl.Aid)
+            << ", Bid = " << ovl.Bid << ", Blen = " << ovl.Blen
+            << ", HPC Blen = " << bMap.HPCLength(ovl.Bid) << ".";
+        throw std::runtime_error(oss.str());
+    }
+
+    const int32_t aStartHPC = ovl.Astart;
+    const int32_t aEndHPC = ovl.Aend;
+    const int32_t bStartFwdHPC = ovl.BstartFwd();
+    const int32_t bEndFwdHPC = ovl.BendFwd();
+
+    // Lift the CIGAR first, while the coordinates are still in the HPC space.
+    if (ovl.Cigar.empty() == false) {
+        const std::vector<int32_t> aRuns = aMap.RunLengths(ovl.Aid, aStartHPC, aEndHPC);
+        std::vector<int32_t> bRuns = bMap.RunLengths(ovl.Bid, bStartFwdHPC, bEndFwdHPC);
+        if (ovl.Brev) {
+            std::reverse(bRuns.begin(), bRuns.end());
+        }
+
+        PacBio::BAM::Cigar cigar;
+        std::string aVars;
+        std::string bVars;
+        int32_t aPos = 0;
+        int32_t bPos = 0;
+        int32_t aVarPos = 0;
+        int32_t bVarPos = 0;
+        for (const auto& op : ovl.Cigar) {
+            const int32_t opLen = op.Length();
+            const auto type = op.Type();
+            if ((aPos + opLen) > static_cast<int32_t>(aRuns.size()) &&
+                type != CigarOperationType::DELETION) {
+                throw std::runtime_error("The CIGAR is longer than the A span in "
+                                         "LiftOverlapToRaw.");
+            }
+            if ((bPos + opLen) > static_cast<int32_t>(bRuns.size()) &&
+                type != CigarOperationType::INSERTION) {
+                throw std::runtime_error("The CIGAR is longer than the B span in "
+                                         "LiftOverlapToRaw.");
+            }
+
+            if (type == CigarOperationType::SEQUENCE_MATCH ||
+                type == CigarOperationType::ALIGNMENT_MATCH) {
+                for (int32_t i = 0; i < opLen; ++i, ++aPos, ++bPos) {
+                    const int32_t aRun = aRuns[aPos];
+                    const int32_t bRun = bRuns[bPos];
+                    AddCigarOp(cigar, type, std::min(aRun, bRun));
+                    // The homopolymer length differences. Both runs are of the same base.
+                    const char base = std::tolower(aSeqHPC[(aStartHPC + aPos) % ovl.Alen]);
+                    if (aRun > bRun) {
+                        AddCigarOp(cigar, CigarOperationType::INSERTION, aRun - bRun);
+                        aVars.append(aRun - bRun, base);
+                    } else if (bRun > aRun) {
+                        AddCigarOp(cigar, CigarOperationType::DELETION, bRun - aRun);
+                        bVars.append(bRun - aRun, base);
+                    }
+                }
+            } else if (type == CigarOperationType::SEQUENCE_MISMATCH) {
+                for (int32_t i = 0; i < opLen; ++i, ++aPos, ++bPos) {
+                    const int32_t aRun = aRuns[aPos];
+                    const int32_t bRun = bRuns[bPos];
+                    const char aBase = VariantAt(ovl.Avars, aVarPos++);
+                    const char bBase = VariantAt(ovl.Bvars, bVarPos++);
+                    const int32_t minRun = std::min(aRun, bRun);
+                    AddCigarOp(cigar, type, minRun);
+                    aVars.append(minRun, aBase);
+                    bVars.append(minRun, bBase);
+                    if (aRun > bRun) {
+                        AddCigarOp(cigar, CigarOperationType::INSERTION, aRun - bRun);
+                        aVars.append(aRun - bRun, aBase);
+                    } else if (bRun > aRun) {
+                        AddCigarOp(cigar, CigarOperationType::DELETION, bRun - aRun);
+                        bVars.append(bRun - aRun, bBase);
+                    }
+                }
+            } else if (type == CigarOperationType::INSERTION) {
+                for (int32_t i = 0; i < opLen; ++i, ++aPos) {
+                    AddCigarOp(cigar, type, aRuns[aPos]);
+                    aVars.append(aRuns[aPos], VariantAt(ovl.Avars, aVarPos++));
+                }
+            } else if (type == CigarOperationType::DELETION) {
+                for (int32_t i = 0; i < opLen; ++i, ++bPos) {
+                    AddCigarOp(cigar, type, bRuns[bPos]);
+                    bVars.append(bRuns[bPos], VariantAt(ovl.Bvars, bVarPos++));
+                }
+            } else {
+                std::ostringstream oss;
+                oss << "CIGAR operation '" << op.TypeToChar(type)
+                    << "' not supported by LiftOverlapToRaw.";
+                throw std::runtime_error(oss.str());
+            }
+        }
+        std::swap(ovl.Cigar, cigar);
+        std::swap(ovl.Avars, aVars);
+        std::swap(ovl.Bvars, bVars);
+    }
+
+    // Lift the coordinates. The B coordinates are internally in the strand of B.
+    const int32_t bRawLen = bMap.RawLength(ovl.Bid);
+    const int32_t bStartFwdRaw = LiftPosition(bMap, ovl.Bid, bStartFwdHPC);
+    const int32_t bEndFwdRaw = LiftPosition(bMap, ovl.Bid, bEndFwdHPC);
+    ovl.Astart = LiftPosition(aMap, ovl.Aid, aStartHPC);
+    ovl.Aend = LiftPosition(aMap, ovl.Aid, aEndHPC);
+    ovl.Alen = aMap.RawLength(ovl.Aid);
+    ovl.Bstart = ovl.Brev ? (bRawLen - bEndFwdRaw) : bStartFwdRaw;
+    ovl.Bend = ovl.Brev ? (bRawLen - bStartFwdRaw) : bEndFwdRaw;
+    ovl.Blen = bRawLen;
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
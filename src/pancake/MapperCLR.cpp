@@ -132,9 +132,7 @@ std::vector<MapperBaseResult> MapperCLR::WrapBuildIndexMapAndAlignWithFallback_(
     std::vector<PacBio::Pancake::Int128t> seeds;
     std::vector<int32_t> sequenceLengths;
     const auto& seedParams = settings.seedParams;
-    SeedDB::GenerateMinimizers(seeds, sequenceLengths, targetSeqs, seedParams.KmerSize,
-                               seedParams.MinimizerWindow, seedParams.Spacing, seedParams.UseRC,
-                               seedParams.UseHPCForSeedsOnly, seedParams.MaxHPCLen);
+    SeedDB::GenerateSeeds(seeds, sequenceLengths, targetSeqs, seedParams);
     std::unique_ptr<SeedIndex> seedIndex =
         std::make_unique<SeedIndex>(settings.seedParams, sequenceLengths, std::move(seeds));
 
@@ -152,11 +150,7 @@ std::vector<MapperBaseResult> MapperCLR::WrapBuildIndexMapAndAlignWithFallback_(
     if (settings.seedParamsFallback != settings.seedParams) {
         std::vector<PacBio::Pancake::Int128t> seedsFallback;
         const auto& seedParamsFallback = settings.seedParamsFallback;
-        SeedDB::GenerateMinimizers(seedsFallback, sequenceLengths, targetSeqs,
-                                   seedParamsFallback.KmerSize, seedParamsFallback.MinimizerWindow,
-                                   seedParamsFallback.Spacing, seedParamsFallback.UseRC,
-                                   seedParamsFallback.UseHPCForSeedsOnly,
-                                   seedParamsFallback.MaxHPCLen);
+        SeedDB::GenerateSeeds(seedsFallback, sequenceLengths, targetSeqs, seedParamsFallback);
         seedIndexFallback = std::make_unique<SeedIndex>(settings.seedParamsFallback,
                                                         sequenceLengths, std::move(seedsFallback));
         seedIndexFallback->ComputeFrequencyStats(settings.freqPercentile, freqMax, freqAvg,
@@ -177,11 +171,8 @@ std::vector<MapperBaseResult> MapperCLR::WrapBuildIndexMapAndAlignWithFallback_(
         std::vector<PacBio::Pancake::Int128t> querySeeds;
         int32_t seqLen = query.size();
         const uint8_t* seq = reinterpret_cast<const uint8_t*>(query.data());
-        int rv = SeedDB::GenerateMinimizers(
-            querySeeds, seq, seqLen, 0, queryId, settings.seedParams.KmerSize,
-            settings.seedParams.MinimizerWindow, settings.seedParams.Spacing,
-            settings.seedParams.UseRC, settings.seedParams.UseHPCForSeedsOnly,
-            settings.seedParams.MaxHPCLen);
+        int rv =
+            SeedDB::GenerateSeeds(querySeeds, seq, seqLen, 0, queryId, settings.seedParams);
         if (rv)
             throw std::runtime_error("Generating minimizers failed for the query sequence i = " +
                                      std::to_string(i) + ", id = " + std::to_string(queryId));
@@ -190,11 +181,8 @@ std::vector<MapperBaseResult> MapperCLR::WrapBuildIndexMapAndAlignWithFallback_(
                                              freqCutoff, settings, alignerGlobal, alignerExt);
 
         if (queryResults.mappings.empty() && seedIndexFallback != nullptr) {
-            rv = SeedDB::GenerateMinimizers(
-                querySeeds, seq, seqLen, 0, queryId, settings.seedParamsFallback.KmerSize,
-                settings.seedParamsFallback.MinimizerWindow, settings.seedParamsFallback.Spacing,
-                settings.seedParamsFallback.UseRC, settings.seedParamsFallback.UseHPCForSeedsOnly,
-                settings.seedParamsFallback.MaxHPCLen);
+            rv = SeedDB::GenerateSeeds(querySeeds, seq, seqLen, 0, queryId,
+                                       settings.seedParamsFallback);
             if (rv)
                 throw std::runtime_error(
                     "Generating minimizers failed for the query sequence, id = " +
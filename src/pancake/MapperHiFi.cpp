@@ -4,6 +4,7 @@
 #include <pacbio/alignment/AlignmentTools.h>
 #include <pacbio/alignment/DiffCounts.h>
 #include <pacbio/alignment/SesDistanceBanded.h>
+#include <pacbio/pancake/AlignmentSeeded.h>
 #include <pacbio/pancake/MapperHiFi.h>
 #include <pacbio/pancake/OverlapWriterBase.h>
 #include <pacbio/pancake/Secondary.h>
@@ -14,7 +15,12 @@
 #include <pbcopper/logging/Logging.h>
 #include <pbcopper/third-party/edlib.h>
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <tuple>
 #include <lib/istl/lis.hpp>
 #include <pacbio/alignment/Ses2AlignBanded.hpp>
 #include <pacbio/alignment/Ses2DistanceBanded.hpp>
@@ -28,30 +34,544 @@ namespace OverlapHiFi {
 // #define PANCAKE_DEBUG
 // #define PANCAKE_DEBUG_ALN
 
+/*
+ * All of the alignment wrappers below are adaptive. They start with the given maxDiffs and
+ * bandwidth, and double both (up to maxDiffsCap and bandwidthCap) when the alignment runs out
+ * of either. If the caps are equal to the initial values, the alignment is a plain banded one.
+*/
+template <Alignment::SESAlignDirection DIRECTION = Alignment::SESAlignDirection::Forward>
 auto AlignWithTraceback(const char* query, size_t queryLen, const char* target, size_t targetLen,
-                        int32_t maxDiffs, int32_t bandwidth,
+                        int32_t maxDiffs, int32_t bandwidth, int32_t maxDiffsCap,
+                        int32_t bandwidthCap,
                         std::shared_ptr<Alignment::SESScratchSpace> ss = nullptr)
 {
-    return Alignment::SES2AlignBanded<Alignment::SESAlignMode::Semiglobal,
-                                      Alignment::SESTrimmingMode::Disabled,
-                                      Alignment::SESTracebackMode::Enabled>(
-        query, queryLen, target, targetLen, maxDiffs, bandwidth, ss);
+    return Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Semiglobal,
+                                              Alignment::SESTrimmingMode::Disabled,
+                                              Alignment::SESTracebackMode::Enabled, DIRECTION>(
+        query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap, bandwidthCap, ss);
 }
 
+template <Alignment::SESAlignDirection DIRECTION = Alignment::SESAlignDirection::Forward>
 auto AlignNoTraceback(const char* query, size_t queryLen, const char* target, size_t targetLen,
-                      int32_t maxDiffs, int32_t bandwidth,
+                      int32_t maxDiffs, int32_t bandwidth, int32_t maxDiffsCap,
+                      int32_t bandwidthCap,
                       std::shared_ptr<Alignment::SESScratchSpace> ss = nullptr)
 {
-    return Alignment::SES2AlignBanded<Alignment::SESAlignMode::Semiglobal,
-                                      Alignment::SESTrimmingMode::Disabled,
-                                      Alignment::SESTracebackMode::Disabled>(
-        query, queryLen, target, targetLen, maxDiffs, bandwidth, ss);
+    return Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Semiglobal,
+                                              Alignment::SESTrimmingMode::Disabled,
+                                              Alignment::SESTracebackMode::Disabled, DIRECTION>(
+        query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap, bandwidthCap, ss);
+}
+
+/*
+ * Semiglobal alignment of the entire query and target, in the given direction.
+ * In the reverse direction, both sequences are aligned from their last base backwards.
+*/
+Alignment::SesResults AlignSemiglobal(const char* query, size_t queryLen, const char* target,
+                                      size_t targetLen, int32_t maxDiffs, int32_t bandwidth,
+                                      int32_t maxDiffsCap, int32_t bandwidthCap,
+                                      bool useTraceback, bool reverse,
+                                      std::shared_ptr<Alignment::SESScratchSpace> ss)
+{
+    if (reverse) {
+        if (useTraceback) {
+            return AlignWithTraceback<Alignment::SESAlignDirection::Reverse>(
+                query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap,
+                bandwidthCap, ss);
+        }
+        return AlignNoTraceback<Alignment::SESAlignDirection::Reverse>(
+            query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap, bandwidthCap,
+            ss);
+    }
+    if (useTraceback) {
+        return AlignWithTraceback(query, queryLen, target, targetLen, maxDiffs, bandwidth,
+                                  maxDiffsCap, bandwidthCap, ss);
+    }
+    return AlignNoTraceback(query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap,
+                            bandwidthCap, ss);
+}
+
+auto AlignGlobalWithTraceback(const char* query, size_t queryLen, const char* target,
+                              size_t targetLen, int32_t maxDiffs, int32_t bandwidth,
+                              int32_t maxDiffsCap, int32_t bandwidthCap,
+                              std::shared_ptr<Alignment::SESScratchSpace> ss = nullptr)
+{
+    return Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                              Alignment::SESTrimmingMode::Disabled,
+                                              Alignment::SESTracebackMode::Enabled>(
+        query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap, bandwidthCap, ss);
+}
+
+auto AlignGlobalNoTraceback(const char* query, size_t queryLen, const char* target,
+                            size_t targetLen, int32_t maxDiffs, int32_t bandwidth,
+                            int32_t maxDiffsCap, int32_t bandwidthCap,
+                            std::shared_ptr<Alignment::SESScratchSpace> ss = nullptr)
+{
+    return Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                              Alignment::SESTrimmingMode::Disabled,
+                                              Alignment::SESTracebackMode::Disabled>(
+        query, queryLen, target, targetLen, maxDiffs, bandwidth, maxDiffsCap, bandwidthCap, ss);
+}
+
+/*
+ * Upper limit for an adaptive alignment which starts from the given value, and doubles it at
+ * most maxWidenings times. The limit is never larger than maxValue, unless the initial
+ * value already is.
+*/
+int32_t ComputeWideningCap(int32_t value, int32_t maxWidenings, int32_t maxValue)
+{
+    int64_t ret = value;
+    for (int32_t i = 0; i < maxWidenings && ret < maxValue; ++i) {
+        ret = std::max<int64_t>(1, ret * 2);
+    }
+    return std::max(value, static_cast<int32_t>(std::min<int64_t>(ret, maxValue)));
+}
+
+/*
+ * Removes the chained hits which step away from the diagonal and then return back to it,
+ * which is typical for seeds in tandem repeats. Forcing the alignment through such hits
+ * would produce an insertion followed by an equally long deletion (or vice versa), while
+ * a regular alignment would simply go along the diagonal.
+ * Short runs of hits at either end of the chain which are on a different diagonal than the
+ * rest of the chain are removed as well, and those bases are left to the flank extension.
+*/
+std::vector<SeedHit> FilterDetourHits(const std::vector<SeedHit>& hits, int32_t diagTolerance,
+                                      int32_t minEndRunSpan)
+{
+    if (hits.size() < 3) {
+        return hits;
+    }
+    std::vector<SeedHit> ret;
+    ret.reserve(hits.size());
+    ret.emplace_back(hits.front());
+    size_t i = 1;
+    while (i < hits.size()) {
+        const int32_t prevDiag = ret.back().Diagonal();
+        // A long join is an intended step to another diagonal, over a large indel.
+        if (hits[i].CheckFlagLongJoin() ||
+            std::abs(hits[i].Diagonal() - prevDiag) <= diagTolerance) {
+            ret.emplace_back(hits[i]);
+            ++i;
+            continue;
+        }
+        // Look for the first hit which returns to the diagonal of the last kept hit.
+        size_t j = i + 1;
+        while (j < hits.size() && hits[j].CheckFlagLongJoin() == false &&
+               std::abs(hits[j].Diagonal() - prevDiag) > diagTolerance) {
+            ++j;
+        }
+        if (j < hits.size() && hits[j].CheckFlagLongJoin() == false) {
+            i = j;
+        } else {
+            ret.emplace_back(hits[i]);
+            ++i;
+        }
+    }
+
+    auto IsJump = [&](size_t k) {
+        return ret[k].CheckFlagLongJoin() == false &&
+               std::abs(ret[k].Diagonal() - ret[k - 1].Diagonal()) > diagTolerance;
+    };
+
+    // Trim a short run at the back, then at the front. At least two hits are always kept.
+    size_t lastJump = ret.size() - 1;
+    while (lastJump > 0 && IsJump(lastJump) == false) {
+        --lastJump;
+    }
+    if (lastJump > 1 && (ret.back().queryPos - ret[lastJump].queryPos) < minEndRunSpan) {
+        ret.resize(lastJump);
+    }
+    size_t firstJump = 1;
+    while (firstJump < ret.size() && IsJump(firstJump) == false) {
+        ++firstJump;
+    }
+    if ((firstJump + 1) < ret.size() &&
+        (ret[firstJump - 1].queryPos - ret.front().queryPos) < minEndRunSpan) {
+        ret.erase(ret.begin(), ret.begin() + firstJump);
+    }
+
+    return ret;
+}
+
+/*
+ * The anchor hits are permuted and filtered together with the overlaps, so the two vectors
+ * need to stay parallel.
+*/
+void CheckAnchorHitsSize(size_t numAnchorHits, size_t numOverlaps, const std::string& caller)
+{
+    if (numAnchorHits != numOverlaps) {
+        std::ostringstream oss;
+        oss << "The number of anchor hit vectors does not match the number of overlaps in "
+            << caller << ". anchorHits.size() = " << numAnchorHits
+            << ", overlaps.size() = " << numOverlaps;
+        throw std::runtime_error(oss.str());
+    }
 }
 
 static const int32_t MIN_DIFFS_CAP = 10;
 static const int32_t MIN_BANDWIDTH_CAP = 10;
+// Cost of joining two anchors in MergeColinearAnchors, in the number of seeds. The log term
+// dominates for short diagonal shifts, so a large indel costs only a few seeds more than a
+// small one.
+static const double MERGE_GAP_LOG_COST = 0.5;
+static const double MERGE_GAP_LINEAR_COST = 0.001;
+// Maximum number of preceding anchors checked for a join.
+static const int32_t MERGE_MAX_PREDECESSORS = 50;
+
+/*
+ * Removes the long indels recorded by the anchor merging from the alignment diffs, so that they
+ * do not count towards the identity and the edit distance.
+*/
+Alignment::DiffCounts RemoveLongIndelDiffs(Alignment::DiffCounts diffs, const Overlap& ovl)
+{
+    diffs.numI = std::max(0, diffs.numI - ovl.LongInsertionBases);
+    diffs.numD = std::max(0, diffs.numD - ovl.LongDeletionBases);
+    return diffs;
+}
+
+/*
+ * Finds where to place a long indel between two anchors on different diagonals. The query and
+ * the target are the sequences between the anchors. The shorter of the two is split into a prefix
+ * on the diagonal of the first anchor and a suffix on the diagonal of the second anchor, and the
+ * length of the prefix with the fewest mismatches is returned.
+*/
+int32_t FindLongIndelBreakpoint(const char* query, int32_t qSpan, const char* target,
+                                int32_t tSpan)
+{
+    const int32_t minSpan = std::min(qSpan, tSpan);
+    const int32_t qShift = qSpan - minSpan;
+    const int32_t tShift = tSpan - minSpan;
+    std::vector<int32_t> suffixMismatches(minSpan + 1, 0);
+    for (int32_t i = minSpan - 1; i >= 0; --i) {
+        suffixMismatches[i] = suffixMismatches[i + 1] + (query[i + qShift] != target[i + tShift]);
+    }
+    int32_t bestPos = 0;
+    int32_t bestMismatches = suffixMismatches[0];
+    int32_t prefixMismatches = 0;
+    for (int32_t i = 1; i <= minSpan; ++i) {
+        prefixMismatches += (query[i - 1] != target[i - 1]);
+        if ((prefixMismatches + suffixMismatches[i]) < bestMismatches) {
+            bestPos = i;
+            bestMismatches = prefixMismatches + suffixMismatches[i];
+        }
+    }
+    return bestPos;
+}
 // static const int32_t MASK_DEGREE = 3;
 
+OverlapEndClass GetOverlapEndClass(OverlapType type)
+{
+    if (type == OverlapType::FivePrime) {
+        return OverlapEndClass::FivePrime;
+    } else if (type == OverlapType::ThreePrime) {
+        return OverlapEndClass::ThreePrime;
+    } else if (type == OverlapType::Contained || type == OverlapType::Contains) {
+        return OverlapEndClass::Containment;
+    }
+    return OverlapEndClass::Internal;
+}
+
+std::vector<OverlapPtr> KeepBestOverlaps(std::vector<OverlapPtr>& sortedOverlaps, int32_t bestN,
+                                         int32_t bestNPerEnd)
+{
+    std::vector<OverlapPtr> kept;
+    std::vector<OverlapPtr> removed;
+    std::array<int32_t, NUM_OVERLAP_END_CLASSES> endClassCounts{};
+    for (auto& ovl : sortedOverlaps) {
+        const int32_t endClass = static_cast<int32_t>(GetOverlapEndClass(ovl->Atype));
+        if ((bestNPerEnd > 0 && endClassCounts[endClass] >= bestNPerEnd) ||
+            (bestN > 0 && static_cast<int32_t>(kept.size()) >= bestN)) {
+            removed.emplace_back(std::move(ovl));
+            continue;
+        }
+        ++endClassCounts[endClass];
+        kept.emplace_back(std::move(ovl));
+    }
+    std::swap(sortedOverlaps, kept);
+    return removed;
+}
+
+std::vector<OverlapPtr> MergeColinearAnchors(const std::vector<OverlapPtr>& overlaps,
+                                             std::vector<std::vector<SeedHit>>* anchorHits,
+                                             int32_t maxGap, int32_t minIndelLen,
+                                             int32_t minNumSeeds, int32_t minChainSpan)
+{
+    if (maxGap < 0) {
+        throw std::runtime_error("(MergeColinearAnchors) maxGap cannot be negative. maxGap = " +
+                                 std::to_string(maxGap));
+    }
+    if (anchorHits != nullptr) {
+        CheckAnchorHitsSize(anchorHits->size(), overlaps.size(), "MergeColinearAnchors");
+    }
+
+    const int32_t numOverlaps = overlaps.size();
+
+    // Sort the IDs instead of the overlaps, so that the anchor hits can be merged
+    // in the same way.
+    std::vector<int32_t> sortedIds(numOverlaps);
+    std::iota(sortedIds.begin(), sortedIds.end(), 0);
+    std::sort(sortedIds.begin(), sortedIds.end(), [&overlaps](int32_t aId, int32_t bId) {
+        const auto& a = overlaps[aId];
+        const auto& b = overlaps[bId];
+        return std::tuple(a->Bid, a->Brev, a->Astart, a->Bstart) <
+               std::tuple(b->Bid, b->Brev, b->Astart, b->Bstart);
+    });
+
+    // Sparse chaining of the anchors. The predecessors are indices into sortedIds.
+    std::vector<double> scores(numOverlaps, 0.0);
+    std::vector<int32_t> preds(numOverlaps, -1);
+    for (int32_t i = 0; i < numOverlaps; ++i) {
+        const auto& curr = overlaps[sortedIds[i]];
+        scores[i] = curr->NumSeeds;
+        const int32_t minJ = std::max(0, i - MERGE_MAX_PREDECESSORS);
+        for (int32_t j = (i - 1); j >= minJ; --j) {
+            const auto& prev = overlaps[sortedIds[j]];
+            if (prev->Bid != curr->Bid || prev->Brev != curr->Brev) {
+                break;
+            }
+            // Skip if there is an overlap, to preserve colinearity.
+            if (curr->Astart <= prev->Aend || curr->Bstart <= prev->Bend) {
+                continue;
+            }
+            const int32_t qGap = curr->Astart - prev->Aend;
+            const int32_t tGap = curr->Bstart - prev->Bend;
+            if (std::max(qGap, tGap) > maxGap) {
+                continue;
+            }
+            const int32_t shift = std::abs(tGap - qGap);
+            const double cost =
+                MERGE_GAP_LOG_COST * std::log2(shift + 1.0) + MERGE_GAP_LINEAR_COST * shift;
+            const double score = scores[j] + curr->NumSeeds - cost;
+            if (score > scores[i]) {
+                scores[i] = score;
+                preds[i] = j;
+            }
+        }
+    }
+
+    // Backtrack from the best chain down. A chain ends when it reaches an anchor which
+    // was already used by a better chain.
+    std::vector<int32_t> chainEnds(numOverlaps);
+    std::iota(chainEnds.begin(), chainEnds.end(), 0);
+    std::stable_sort(chainEnds.begin(), chainEnds.end(),
+                     [&scores](int32_t a, int32_t b) { return scores[a] > scores[b]; });
+
+    // The merged overlaps are stored at the input position of their first anchor.
+    std::vector<OverlapPtr> merged(numOverlaps);
+    std::vector<std::vector<SeedHit>> mergedHits((anchorHits != nullptr) ? numOverlaps : 0);
+    std::vector<uint8_t> isUsed(numOverlaps, false);
+    std::vector<int32_t> chain;
+    for (const int32_t chainEnd : chainEnds) {
+        chain.clear();
+        for (int32_t i = chainEnd; i >= 0 && isUsed[i] == false; i = preds[i]) {
+            chain.emplace_back(i);
+            isUsed[i] = true;
+        }
+        if (chain.empty()) {
+            continue;
+        }
+        std::reverse(chain.begin(), chain.end());
+
+        const int32_t firstId = sortedIds[chain.front()];
+        OverlapPtr ovl = createOverlap(overlaps[firstId]);
+        std::vector<SeedHit> hits;
+        if (anchorHits != nullptr) {
+            hits = std::move((*anchorHits)[firstId]);
+        }
+        for (size_t i = 1; i < chain.size(); ++i) {
+            const int32_t currId = sortedIds[chain[i]];
+            const auto& curr = overlaps[currId];
+            // Positive when the target has the extra bases.
+            const int32_t shift = (curr->Bstart - ovl->Bend) - (curr->Astart - ovl->Aend);
+            const bool isLongIndel = std::abs(shift) > minIndelLen;
+            if (isLongIndel) {
+                ++ovl->NumLongIndels;
+                if (shift > 0) {
+                    ovl->LongDeletionBases += shift;
+                } else {
+                    ovl->LongInsertionBases -= shift;
+                }
+            }
+            ovl->Aend = curr->Aend;
+            ovl->Bend = curr->Bend;
+            ovl->Score += curr->Score;
+            ovl->NumSeeds += curr->NumSeeds;
+            if (anchorHits != nullptr && (*anchorHits)[currId].empty() == false) {
+                auto& currHits = (*anchorHits)[currId];
+                // The piecewise alignment places the long indels at the flagged joins.
+                if (isLongIndel) {
+                    currHits.front().SetFlagLongJoin();
+                }
+                hits.insert(hits.end(), currHits.begin(), currHits.end());
+            }
+        }
+        merged[firstId] = std::move(ovl);
+        if (anchorHits != nullptr) {
+            mergedHits[firstId] = std::move(hits);
+        }
+    }
+
+    // Filter in the same way as the FormAnchors2_.
+    std::vector<OverlapPtr> ret;
+    std::vector<std::vector<SeedHit>> retAnchorHits;
+    for (int32_t i = 0; i < numOverlaps; ++i) {
+        auto& ovl = merged[i];
+        if (ovl == nullptr || ovl->NumSeeds < minNumSeeds || ovl->ASpan() <= minChainSpan ||
+            ovl->BSpan() <= minChainSpan) {
+            continue;
+        }
+        ret.emplace_back(std::move(ovl));
+        if (anchorHits != nullptr) {
+            retAnchorHits.emplace_back(std::move(mergedHits[i]));
+        }
+    }
+
+    if (anchorHits != nullptr) {
+        std::swap(*anchorHits, retAnchorHits);
+    }
+
+    return ret;
+}
+
+/*
+ * The per-overlap filters of the FilterOverlaps_.
+*/
+bool PassesOverlapFilters(const Overlap& ovl, int32_t minNumSeeds, float minIdentity,
+                          int32_t minMappedSpan, int32_t minQueryLen, int32_t minTargetLen)
+{
+    return !(100 * ovl.Identity < minIdentity || ovl.ASpan() < minMappedSpan ||
+             ovl.BSpan() < minMappedSpan || ovl.NumSeeds < minNumSeeds || ovl.Alen < minQueryLen ||
+             ovl.Blen < minTargetLen);
+}
+
+AlignmentScheduler::AlignmentScheduler(const std::vector<OverlapPtr>& candidates,
+                                       const OverlapHifiSettings& settings)
+    : settings_(settings)
+    , isActive_((settings.BestN > 0 || settings.BestNPerEnd > 0) && !settings.MarkSecondary)
+    , globalThreshold_(std::numeric_limits<float>::infinity())
+    , endClassThresholds_(NUM_OVERLAP_END_CLASSES, std::numeric_limits<float>::infinity())
+{
+    order_.resize(candidates.size());
+    std::iota(order_.begin(), order_.end(), 0);
+    if (isActive_ == false) {
+        return;
+    }
+
+    scoreBounds_.resize(candidates.size());
+    predictedEndClasses_.resize(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const auto& ovl = candidates[i];
+        // The alignment passes through the start of the anchor. Every column contributes at most
+        // one to the score, regardless if it is computed from the matches or from the spans and
+        // the edit distance. The B coordinates are in the strand of the B-read.
+        const int32_t leftExt = std::min(ovl->Astart, ovl->Bstart);
+        const int32_t rightExt = std::min(ovl->Alen - ovl->Aend, ovl->Blen - ovl->Bend);
+        const int32_t maxSpan =
+            leftExt + std::min(ovl->Alen - ovl->Astart, ovl->Blen - ovl->Bstart);
+        scoreBounds_[i] = -static_cast<float>(maxSpan);
+
+        Overlap projected = *ovl;
+        projected.Astart -= leftExt;
+        projected.Bstart -= leftExt;
+        projected.Aend += rightExt;
+        projected.Bend += rightExt;
+        predictedEndClasses_[i] =
+            GetOverlapEndClass(DetermineOverlapType(projected, settings.AllowedDovetailDist));
+    }
+
+    // Score is negative, as per legacy Falcon convention.
+    std::stable_sort(order_.begin(), order_.end(), [&](int32_t a, int32_t b) {
+        return std::make_tuple(scoreBounds_[a], -candidates[a]->NumSeeds) <
+               std::make_tuple(scoreBounds_[b], -candidates[b]->NumSeeds);
+    });
+}
+
+bool AlignmentScheduler::ShouldAlign(int32_t candidateId)
+{
+    if (isActive_ == false || isPredictionViolated_) {
+        return true;
+    }
+    const float bound = scoreBounds_[candidateId];
+    const int32_t endClass = static_cast<int32_t>(predictedEndClasses_[candidateId]);
+    if (globalThreshold_ < bound || endClassThresholds_[endClass] < bound) {
+        skipped_.emplace_back(candidateId);
+        return false;
+    }
+    return true;
+}
+
+void AlignmentScheduler::AddAligned(int32_t candidateId, const Overlap& ovl)
+{
+    if (isActive_ == false) {
+        return;
+    }
+    const OverlapEndClass endClass =
+        GetOverlapEndClass(DetermineOverlapType(ovl, settings_.AllowedDovetailDist));
+    if (ovl.Score < scoreBounds_[candidateId] || endClass != predictedEndClasses_[candidateId]) {
+        isPredictionViolated_ = true;
+    }
+    if (PassesOverlapFilters(ovl, settings_.MinNumSeeds, settings_.MinIdentity,
+                             settings_.MinMappedLength, settings_.MinQueryLen,
+                             settings_.MinTargetLen) == false) {
+        return;
+    }
+    const int64_t key = (static_cast<int64_t>(ovl.Bid) << 1) | static_cast<int64_t>(ovl.Brev);
+    auto it = accepted_.find(key);
+    if (it != accepted_.end() && it->second.score <= ovl.Score) {
+        return;
+    }
+    AcceptedAlignment& acc = accepted_[key];
+    acc.score = ovl.Score;
+    acc.endClass = endClass;
+    UpdateThresholds_();
+}
+
+std::vector<int32_t> AlignmentScheduler::TakeSkipped()
+{
+    if (isPredictionViolated_ == false) {
+        return {};
+    }
+    std::vector<int32_t> ret;
+    std::swap(ret, skipped_);
+    return ret;
+}
+
+void AlignmentScheduler::UpdateThresholds_()
+{
+    std::vector<AcceptedAlignment> sorted;
+    sorted.reserve(accepted_.size());
+    for (const auto& it : accepted_) {
+        sorted.emplace_back(it.second);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) { return a.score < b.score; });
+
+    // Same selection as in the KeepBestOverlaps. An accepted alignment can be replaced by a better
+    // one of a different class, so the thresholds are recomputed from scratch.
+    globalThreshold_ = std::numeric_limits<float>::infinity();
+    std::fill(endClassThresholds_.begin(), endClassThresholds_.end(),
+              std::numeric_limits<float>::infinity());
+    std::array<int32_t, NUM_OVERLAP_END_CLASSES> endClassCounts{};
+    int32_t numKept = 0;
+    for (const auto& acc : sorted) {
+        const int32_t endClass = static_cast<int32_t>(acc.endClass);
+        if (settings_.BestNPerEnd > 0 && endClassCounts[endClass] >= settings_.BestNPerEnd) {
+            continue;
+        }
+        if (settings_.BestN > 0 && numKept >= settings_.BestN) {
+            break;
+        }
+        ++endClassCounts[endClass];
+        ++numKept;
+        if (endClassCounts[endClass] == settings_.BestNPerEnd) {
+            endClassThresholds_[endClass] = acc.score;
+        }
+        if (numKept == settings_.BestN) {
+            globalThreshold_ = acc.score;
+        }
+    }
+}
+
 MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
                          const PacBio::Pancake::SeedIndex& index,
                          const PacBio::Pancake::FastaSequenceCached& querySeq,
@@ -71,6 +591,74 @@ MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSe
     index.CollectHits(querySeeds.Seeds(), querySeeds.Size(), querySeq.Size(), hits, freqCutoff);
     ttCollectHits.Stop();
 
+#ifdef PANCAKE_DEBUG
+    PBLOG_INFO << "Collected " << hits.size() << " hits.";
+    PBLOG_INFO << "Time - collecting hits: " << ttCollectHits.GetMillisecs() << " ms / "
+               << ttCollectHits.GetCpuMillisecs() << " CPU ms";
+#endif
+
+    return MapHits_(targetSeqs, index.GetSequenceLengths(), index.GetSeedParams().KmerSize,
+                    querySeq, hits, generateFlippedOverlap);
+}
+
+MapperResult Mapper::MapCandidates(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                                   const PacBio::Pancake::SortedSequenceSeeds& targetSeeds,
+                                   const std::vector<int32_t>& targetLengths, int32_t kmerSize,
+                                   const PacBio::Pancake::FastaSequenceCached& querySeq,
+                                   const PacBio::Pancake::SequenceSeedsCached& querySeeds,
+                                   const CandidatePair* candidates, int64_t numCandidates,
+                                   int64_t freqCutoff, bool generateFlippedOverlap) const
+{
+    if (querySeq.Size() < settings_.MinQueryLen || numCandidates <= 0) {
+        return {};
+    }
+
+    // The key occupies the most significant bits of a raw seed, so sorting the raw values
+    // sorts the seeds by key.
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw> sortedQuerySeeds(
+        querySeeds.Seeds(), querySeeds.Seeds() + querySeeds.Size());
+    std::sort(sortedQuerySeeds.begin(), sortedQuerySeeds.end());
+
+    std::vector<SeedHit> hits;
+    std::vector<SeedHit> candidateHits;
+    for (int64_t candidateId = 0; candidateId < numCandidates; ++candidateId) {
+        const auto& candidate = candidates[candidateId];
+        if (candidate.queryId != querySeq.Id()) {
+            std::ostringstream oss;
+            oss << "Candidate pair query ID " << candidate.queryId
+                << " does not match the ID of the query sequence " << querySeq.Id() << ".";
+            throw std::runtime_error(oss.str());
+        }
+        if (candidate.targetId < 0 ||
+            candidate.targetId >= static_cast<int32_t>(targetLengths.size())) {
+            std::ostringstream oss;
+            oss << "Invalid target ID in a candidate pair. targetId = " << candidate.targetId
+                << ", targetLengths.size() = " << targetLengths.size();
+            throw std::runtime_error(oss.str());
+        }
+        const auto& sortedTargetSeeds = targetSeeds.GetSeedsForSequence(candidate.targetId);
+
+        candidateHits.clear();
+        CollectSeedHitsFromSortedSeeds(sortedQuerySeeds.data(), sortedQuerySeeds.size(),
+                                       sortedTargetSeeds.Seeds(), sortedTargetSeeds.Size(),
+                                       targetLengths[candidate.targetId], freqCutoff,
+                                       candidateHits);
+        for (const auto& hit : candidateHits) {
+            if (candidate.strand == CandidateStrand::Any ||
+                hit.targetRev == (candidate.strand == CandidateStrand::Reverse)) {
+                hits.emplace_back(hit);
+            }
+        }
+    }
+
+    return MapHits_(targetSeqs, targetLengths, kmerSize, querySeq, hits, generateFlippedOverlap);
+}
+
+MapperResult Mapper::MapHits_(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                              const std::vector<int32_t>& targetLengths, int32_t kmerSize,
+                              const PacBio::Pancake::FastaSequenceCached& querySeq,
+                              std::vector<SeedHit>& hits, bool generateFlippedOverlap) const
+{
     TicToc ttSortHits;
     std::sort(hits.begin(), hits.end(), [](const auto& a, const auto& b) {
         return PackSeedHitWithDiagonalToTuple(a) < PackSeedHitWithDiagonalToTuple(b);
@@ -79,11 +667,25 @@ MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSe
 
     // PBLOG_INFO << "Hits: " << hits.size();
 
+    // Chained hits are only needed for piecewise alignment, which is also used to align
+    // through the indels of the merged anchors.
+    const bool mergeAnchors = settings_.AnchorMergeMaxGap > 0;
+    std::vector<std::vector<SeedHit>> anchorHits;
+    std::vector<std::vector<SeedHit>>* anchorHitsPtr =
+        (settings_.AlignmentPiecewise || mergeAnchors) ? &anchorHits : nullptr;
+
+    // When merging, the short pieces of an anchor split by an indel are kept until they are
+    // merged, and the filters are applied to the merged anchors.
     TicToc ttChain;
-    auto overlaps =
-        FormAnchors2_(hits, querySeq, index, settings_.ChainBandwidth, settings_.MinNumSeeds,
-                      settings_.MinChainSpan, index.GetSeedParams().KmerSize * 3,
-                      settings_.SkipSelfHits, settings_.SkipSymmetricOverlaps);
+    auto overlaps = FormAnchors2_(
+        hits, querySeq, targetLengths, kmerSize, settings_.ChainBandwidth,
+        mergeAnchors ? 0 : settings_.MinNumSeeds, mergeAnchors ? 0 : settings_.MinChainSpan,
+        kmerSize * 3, settings_.SkipSelfHits, settings_.SkipSymmetricOverlaps, anchorHitsPtr);
+    if (mergeAnchors) {
+        overlaps = MergeColinearAnchors(overlaps, anchorHitsPtr, settings_.AnchorMergeMaxGap,
+                                        settings_.ChainBandwidth, settings_.MinNumSeeds,
+                                        settings_.MinChainSpan);
+    }
     ttChain.Stop();
 #ifdef PANCAKE_DEBUG
     PBLOG_INFO << "Formed diagonal anchors: " << overlaps.size();
@@ -93,7 +695,7 @@ MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSe
     // taking only the longest overlap chain.
     TicToc ttFilterTandem;
     if (settings_.OneHitPerTarget) {
-        overlaps = FilterTandemOverlaps_(overlaps);
+        overlaps = FilterTandemOverlaps_(overlaps, anchorHitsPtr);
     }
     ttFilterTandem.Stop();
 #ifdef PANCAKE_DEBUG
@@ -103,37 +705,28 @@ MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSe
     const std::string reverseQuerySeq =
         PacBio::Pancake::ReverseComplement(querySeq.Bases(), querySeq.Size(), 0, querySeq.Size());
 
+    // With a best N limit, the alignment can stop early.
+    AlignmentScheduler scheduler(overlaps, settings_);
+    const int64_t numCandidates = overlaps.size();
+
     TicToc ttAlign;
+    int64_t numBandWidenings = 0;
     overlaps = AlignOverlaps_(
         targetSeqs, querySeq, reverseQuerySeq, overlaps, settings_.AlignmentBandwidth,
-        settings_.AlignmentMaxD, settings_.UseTraceback, settings_.NoSNPsInIdentity,
-        settings_.NoIndelsInIdentity, settings_.MaskHomopolymers, settings_.MaskSimpleRepeats,
-        settings_.MaskHomopolymerSNPs, settings_.MaskHomopolymersArbitrary, settings_.TrimAlignment,
-        settings_.TrimWindowSize, settings_.TrimWindowMatchFraction, settings_.TrimToFirstMatch,
-        sesScratch_);
+        settings_.AlignmentMaxD, settings_.AlignmentMaxWidenings, settings_.UseTraceback,
+        settings_.NoSNPsInIdentity, settings_.NoIndelsInIdentity, settings_.MaskHomopolymers,
+        settings_.MaskSimpleRepeats, settings_.MaskHomopolymerSNPs,
+        settings_.MaskHomopolymersArbitrary, settings_.TrimAlignment, settings_.TrimWindowSize,
+        settings_.TrimWindowMatchFraction, settings_.TrimToFirstMatch, anchorHits,
+        settings_.AlignmentPiecewise, settings_.AlignmentPiecewiseMinSpan, sesScratch_,
+        &scheduler, &numBandWidenings);
     ttAlign.Stop();
+    const int64_t numAlignments = numCandidates - scheduler.NumSkipped();
 
     TicToc ttMarkSecondary;
     if (settings_.MarkSecondary) {
-        // Flag the secondary and supplementary overlaps.
-        // Overlaps don't have to be sorted, the maximum is found internally.
-        std::vector<OverlapPriority> overlapPriorities = FlagSecondaryAndSupplementary(
-            overlaps, settings_.SecondaryAllowedOverlapFraction,
-            settings_.SecondaryAllowedOverlapFraction, settings_.SecondaryMinScoreFraction);
-
-        // Generate a new, filtered list of overlaps. The non-primary, non-secondary and non-supplementary
-        // alignments are filtered out.
-        std::vector<OverlapPtr> newOverlaps;
-        for (size_t i = 0; i < overlaps.size(); ++i) {
-            if (overlapPriorities[i].priority > 1) {
-                continue;
-            }
-            auto& ovl = overlaps[i];
-            ovl->IsSupplementary = overlapPriorities[i].isSupplementary;
-            ovl->IsSecondary = (overlapPriorities[i].priority > 0);
-            newOverlaps.emplace_back(std::move(overlaps[i]));
-        }
-        std::swap(overlaps, newOverlaps);
+        overlaps = MarkSecondaryOverlaps_(overlaps, settings_.SecondaryAllowedOverlapFraction,
+                                          settings_.SecondaryMinScoreFraction);
     }
     ttMarkSecondary.Stop();
 
@@ -142,7 +735,8 @@ MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSe
     overlaps = FilterOverlaps_(
         overlaps, settings_.MinNumSeeds, settings_.MinIdentity, settings_.MinMappedLength,
         settings_.MinQueryLen, settings_.MinTargetLen, settings_.ChainBandwidth,
-        settings_.AllowedDovetailDist, settings_.AllowedHeuristicExtendDist, settings_.BestN);
+        settings_.AllowedDovetailDist, settings_.AllowedHeuristicExtendDist, settings_.BestN,
+        settings_.BestNPerEnd);
     ttFilter.Stop();
 
     // Generating flipped overlaps.
@@ -172,9 +766,6 @@ MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSe
                                             targetSeqs.GetSequence(ovl->Bid).Name(), false, false);
     }
     PBLOG_INFO << "Num anchors: " << overlaps.size();
-    PBLOG_INFO << "Collected " << hits.size() << " hits.";
-    PBLOG_INFO << "Time - collecting hits: " << ttCollectHits.GetMillisecs() << " ms / "
-               << ttCollectHits.GetCpuMillisecs() << " CPU ms";
     PBLOG_INFO << "Time - sorting: " << ttSortHits.GetMillisecs() << " ms / "
                << ttSortHits.GetCpuMillisecs() << " CPU ms";
     PBLOG_INFO << "Time - chaining: " << ttChain.GetMillisecs() << " ms / "
@@ -191,12 +782,138 @@ MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSe
 
     MapperResult result;
     std::swap(result.overlaps, overlaps);
+    result.numHits = hits.size();
+    result.numAlignments = numAlignments;
+    result.numBandWidenings = numBandWidenings;
     return result;
 }
 
+MapperResult Mapper::Map(const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                         const PacBio::Pancake::MinimizerSpaceIndex& index,
+                         const PacBio::Pancake::FastaSequenceCached& querySeq,
+                         const PacBio::Pancake::SequenceSeedsCached& querySeeds, int64_t freqCutoff,
+                         bool generateFlippedOverlap) const
+{
+    if (querySeq.Size() < settings_.MinQueryLen) {
+        return {};
+    }
+
+    // The ChainBandwidth limits the indel size between two consecutive shared minimizers.
+    std::vector<MinimizerSpaceMatch> matches;
+    index.FindMatches(querySeeds.Seeds(), querySeeds.Size(), querySeq.Id(), freqCutoff,
+                      settings_.MinimizerSpaceMaxSkip, settings_.ChainBandwidth,
+                      settings_.SkipSelfHits, settings_.SkipSymmetricOverlaps, matches);
+
+    auto overlaps = MakeMinimizerSpaceOverlaps_(matches, querySeq, index, settings_.MinChainSpan);
+
+    if (settings_.OneHitPerTarget) {
+        overlaps = FilterTandemOverlaps_(overlaps, nullptr);
+    }
+
+    if (settings_.MarkSecondary) {
+        overlaps = MarkSecondaryOverlaps_(overlaps, settings_.SecondaryAllowedOverlapFraction,
+                                          settings_.SecondaryMinScoreFraction);
+    }
+
+    overlaps = FilterOverlaps_(
+        overlaps, settings_.MinNumSeeds, settings_.MinIdentity, settings_.MinMappedLength,
+        settings_.MinQueryLen, settings_.MinTargetLen, settings_.ChainBandwidth,
+        settings_.AllowedDovetailDist, settings_.AllowedHeuristicExtendDist, settings_.BestN,
+        settings_.BestNPerEnd);
+
+    // The overlaps have no CIGAR strings, so the reverse query is not used for flipping.
+    if (generateFlippedOverlap) {
+        std::vector<OverlapPtr> flippedOverlaps = GenerateFlippedOverlaps_(
+            targetSeqs, querySeq, "", overlaps, settings_.NoSNPsInIdentity,
+            settings_.NoIndelsInIdentity, settings_.MaskHomopolymers, settings_.MaskSimpleRepeats,
+            settings_.MaskHomopolymerSNPs, settings_.MaskHomopolymersArbitrary);
+        for (size_t i = 0; i < flippedOverlaps.size(); ++i) {
+            overlaps.emplace_back(std::move(flippedOverlaps[i]));
+        }
+    }
+
+    MapperResult result;
+    std::swap(result.overlaps, overlaps);
+    result.numHits = matches.size();
+    return result;
+}
+
+std::vector<OverlapPtr> Mapper::MakeMinimizerSpaceOverlaps_(
+    const std::vector<PacBio::Pancake::MinimizerSpaceMatch>& matches,
+    const PacBio::Pancake::FastaSequenceCached& querySeq,
+    const PacBio::Pancake::MinimizerSpaceIndex& index, int32_t minChainSpan)
+{
+    const int32_t kmerSize = index.GetSeedParams().KmerSize;
+    const int32_t queryLen = querySeq.Size();
+
+    std::vector<OverlapPtr> ret;
+    for (const auto& match : matches) {
+        if ((match.queryEnd - match.queryStart) < minChainSpan ||
+            (match.targetEnd - match.targetStart) < minChainSpan) {
+            continue;
+        }
+
+        const int32_t targetLen = index.GetSequenceLength(match.targetId);
+        int32_t queryStart = match.queryStart;
+        int32_t queryEnd = match.queryEnd;
+        int32_t targetStart = match.targetStart;
+        int32_t targetEnd = match.targetEnd;
+        if (match.reachesStart) {
+            const int32_t dist = std::min(queryStart, targetStart);
+            queryStart -= dist;
+            targetStart -= dist;
+        }
+        if (match.reachesEnd) {
+            const int32_t dist = std::min(queryLen - queryEnd, targetLen - targetEnd);
+            queryEnd += dist;
+            targetEnd += dist;
+        }
+
+        // A single base difference removes the minimizers of all k-mers which cover it,
+        // so the fraction of shared minimizers is roughly identity^k.
+        const int32_t numMinimizers = std::max(match.numQuerySeeds, match.numTargetSeeds);
+        const float identity = std::pow(
+            static_cast<double>(match.numSharedSeeds) / std::max(numMinimizers, 1), 1.0 / kmerSize);
+        // Score is negative, as per legacy Falcon convention.
+        const float score = -std::min(queryEnd - queryStart, targetEnd - targetStart) * identity;
+
+        ret.emplace_back(createOverlap(querySeq.Id(), match.targetId, score, identity, false,
+                                       queryStart, queryEnd, queryLen, match.targetRev,
+                                       targetStart, targetEnd, targetLen, -1,
+                                       match.numSharedSeeds, OverlapType::Unknown,
+                                       OverlapType::Unknown));
+    }
+
+    return ret;
+}
+
+std::vector<OverlapPtr> Mapper::MarkSecondaryOverlaps_(std::vector<OverlapPtr>& overlaps,
+                                                       double allowedOverlapFraction,
+                                                       double minScoreFraction)
+{
+    // Flag the secondary and supplementary overlaps.
+    // Overlaps don't have to be sorted, the maximum is found internally.
+    std::vector<OverlapPriority> overlapPriorities = FlagSecondaryAndSupplementary(
+        overlaps, allowedOverlapFraction, allowedOverlapFraction, minScoreFraction);
+
+    // Generate a new, filtered list of overlaps. The non-primary, non-secondary and non-supplementary
+    // alignments are filtered out.
+    std::vector<OverlapPtr> newOverlaps;
+    for (size_t i = 0; i < overlaps.size(); ++i) {
+        if (overlapPriorities[i].priority > 1) {
+            continue;
+        }
+        auto& ovl = overlaps[i];
+        ovl->IsSupplementary = overlapPriorities[i].isSupplementary;
+        ovl->IsSecondary = (overlapPriorities[i].priority > 0);
+        newOverlaps.emplace_back(std::move(overlaps[i]));
+    }
+    return newOverlaps;
+}
+
 OverlapPtr Mapper::MakeOverlap_(const std::vector<SeedHit>& sortedHits,
                                 const PacBio::Pancake::FastaSequenceCached& querySeq,
-                                const PacBio::Pancake::SeedIndex& index, int32_t numSeeds,
+                                const std::vector<int32_t>& targetLengths, int32_t numSeeds,
                                 int32_t minTargetPosId, int32_t maxTargetPosId)
 {
 
@@ -217,7 +934,13 @@ OverlapPtr Mapper::MakeOverlap_(const std::vector<SeedHit>& sortedHits,
     const float identity = 0.0;
     const int32_t editDist = -1;
 
-    const int32_t targetLen = index.GetSequenceLength(targetId);
+    if (targetId < 0 || targetId >= static_cast<int32_t>(targetLengths.size())) {
+        std::ostringstream oss;
+        oss << "Invalid targetId in MakeOverlap. targetId = " << targetId
+            << ", targetLengths.size() = " << targetLengths.size();
+        throw std::runtime_error(oss.str());
+    }
+    const int32_t targetLen = targetLengths[targetId];
 
     OverlapPtr ret = createOverlap(querySeq.Id(), targetId, score, identity, 0, beginHit.queryPos,
                                    endHit.queryPos, querySeq.Size(), beginHit.targetRev,
@@ -231,7 +954,7 @@ OverlapPtr Mapper::MakeOverlap_(const std::vector<SeedHit>& sortedHits,
 
 std::vector<OverlapPtr> Mapper::FormAnchors_(const std::vector<SeedHit>& sortedHits,
                                              const PacBio::Pancake::FastaSequenceCached& querySeq,
-                                             const PacBio::Pancake::SeedIndex& index,
+                                             const std::vector<int32_t>& targetLengths,
                                              int32_t chainBandwidth, int32_t minNumSeeds,
                                              int32_t minChainSpan, bool skipSelfHits,
                                              bool skipSymmetricOverlaps)
@@ -278,7 +1001,8 @@ std::vector<OverlapPtr> Mapper::FormAnchors_(const std::vector<SeedHit>& sortedH
 
         if (currHit.targetId != prevHit.targetId || currHit.targetRev != prevHit.targetRev ||
             diagDiff > chainBandwidth) {
-            auto ovl = MakeOverlap_(sortedHits, querySeq, index, i - beginId, minPosId, maxPosId);
+            auto ovl =
+                MakeOverlap_(sortedHits, querySeq, targetLengths, i - beginId, minPosId, maxPosId);
             beginId = i;
             beginDiag = currDiag;
 
@@ -315,7 +1039,8 @@ std::vector<OverlapPtr> Mapper::FormAnchors_(const std::vector<SeedHit>& sortedH
     }
 
     if ((numHits - beginId) > 0) {
-        auto ovl = MakeOverlap_(sortedHits, querySeq, index, numHits - beginId, minPosId, maxPosId);
+        auto ovl = MakeOverlap_(sortedHits, querySeq, targetLengths, numHits - beginId, minPosId,
+                                maxPosId);
 
 #ifdef PANCAKE_DEBUG
         std::cerr << "ovl->NumSeeds = " << ovl->NumSeeds << " (" << minNumSeeds
@@ -417,10 +1142,12 @@ void RefineBadEnds(const std::vector<SeedHit>& chainedHits, int32_t beginId, int
 
 std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sortedHits,
                                               const PacBio::Pancake::FastaSequenceCached& querySeq,
-                                              const PacBio::Pancake::SeedIndex& index,
-                                              int32_t chainBandwidth, int32_t minNumSeeds,
+                                              const std::vector<int32_t>& targetLengths,
+                                              int32_t kmerSize, int32_t chainBandwidth,
+                                              int32_t minNumSeeds,
                                               int32_t minChainSpan, int32_t minMatch,
-                                              bool skipSelfHits, bool skipSymmetricOverlaps)
+                                              bool skipSelfHits, bool skipSymmetricOverlaps,
+                                              std::vector<std::vector<SeedHit>>* retAnchorHits)
 {
 #ifdef PANCAKE_DEBUG
     std::cerr << "[Function: " << __FUNCTION__ << "]\n";
@@ -433,8 +1160,9 @@ std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sorted
     auto WrapMakeOverlap = [](const std::vector<SeedHit>& _sortedHits, const int32_t beginId,
                               const int32_t endId,
                               const PacBio::Pancake::FastaSequenceCached& _querySeq,
-                              const PacBio::Pancake::SeedIndex& _index, int32_t _chainBandwidth,
-                              int32_t kmerSize, int32_t _minMatch) -> OverlapPtr {
+                              const std::vector<int32_t>& _targetLengths, int32_t _chainBandwidth,
+                              int32_t _kmerSize, int32_t _minMatch,
+                              std::vector<SeedHit>* _retHits) -> OverlapPtr {
         if (endId <= beginId) {
             return nullptr;
         }
@@ -458,8 +1186,8 @@ std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sorted
 
         int32_t finalFirst = 0;
         int32_t finalLast = 0;
-        RefineBadEnds(lisHits, 0, lisHits.size(), kmerSize, _chainBandwidth, _minMatch, finalFirst,
-                      finalLast);
+        RefineBadEnds(lisHits, 0, lisHits.size(), _kmerSize, _chainBandwidth, _minMatch,
+                      finalFirst, finalLast);
 
 #ifdef PANCAKE_DEBUG
         std::cerr << "LIS hits for a group, beginId = " << beginId << ", endId = " << endId << "\n";
@@ -471,8 +1199,13 @@ std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sorted
 #endif
 
         // Make the overlap.
-        auto ovl = MakeOverlap_(lisHits, _querySeq, _index, (finalLast - finalFirst), finalFirst,
-                                finalLast - 1);
+        auto ovl = MakeOverlap_(lisHits, _querySeq, _targetLengths, (finalLast - finalFirst),
+                                finalFirst, finalLast - 1);
+
+        // Keep the hits which were used to construct the overlap.
+        if (_retHits != nullptr) {
+            _retHits->assign(lisHits.begin() + finalFirst, lisHits.begin() + finalLast);
+        }
 
 #ifdef PANCAKE_DEBUG
         if (ovl->NumSeeds > 200) {
@@ -492,6 +1225,11 @@ std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sorted
     };
 
     std::vector<OverlapPtr> overlaps;
+    std::vector<SeedHit> groupHits;
+
+    if (retAnchorHits != nullptr) {
+        retAnchorHits->clear();
+    }
 
     const int32_t numHits = static_cast<int32_t>(sortedHits.size());
     int32_t beginId = 0;
@@ -514,8 +1252,9 @@ std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sorted
         if (currHit.targetId != prevHit.targetId || currHit.targetRev != prevHit.targetRev ||
             diagDiff > chainBandwidth) {
 
-            auto ovl = WrapMakeOverlap(sortedHits, beginId, i, querySeq, index, chainBandwidth,
-                                       index.GetSeedParams().KmerSize, minMatch);
+            auto ovl = WrapMakeOverlap(sortedHits, beginId, i, querySeq, targetLengths,
+                                       chainBandwidth, kmerSize, minMatch,
+                                       (retAnchorHits != nullptr) ? &groupHits : nullptr);
             beginId = i;
             beginDiag = currDiag;
 
@@ -535,13 +1274,17 @@ std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sorted
                 (skipSymmetricOverlaps == false ||
                  (skipSymmetricOverlaps && ovl->Bid < ovl->Aid))) {
                 overlaps.emplace_back(std::move(ovl));
+                if (retAnchorHits != nullptr) {
+                    retAnchorHits->emplace_back(std::move(groupHits));
+                }
             }
         }
     }
 
     if ((numHits - beginId) > 0) {
-        auto ovl = WrapMakeOverlap(sortedHits, beginId, numHits, querySeq, index, chainBandwidth,
-                                   index.GetSeedParams().KmerSize, minMatch);
+        auto ovl = WrapMakeOverlap(sortedHits, beginId, numHits, querySeq, targetLengths,
+                                   chainBandwidth, kmerSize, minMatch,
+                                   (retAnchorHits != nullptr) ? &groupHits : nullptr);
 
 #ifdef PANCAKE_DEBUG
         std::cerr << "ovl->NumSeeds = " << ovl->NumSeeds << " (" << minNumSeeds
@@ -558,6 +1301,9 @@ std::vector<OverlapPtr> Mapper::FormAnchors2_(const std::vector<SeedHit>& sorted
             (skipSymmetricOverlaps == false || (skipSymmetricOverlaps && ovl->Bid < ovl->Aid))) {
 
             overlaps.emplace_back(std::move(ovl));
+            if (retAnchorHits != nullptr) {
+                retAnchorHits->emplace_back(std::move(groupHits));
+            }
         }
     }
 
@@ -569,13 +1315,13 @@ std::vector<OverlapPtr> Mapper::FilterOverlaps_(const std::vector<OverlapPtr>& o
                                                 int32_t minMappedSpan, int32_t minQueryLen,
                                                 int32_t minTargetLen, int32_t diagonalBandwidth,
                                                 int32_t allowedDovetailDist,
-                                                int32_t allowedExtendDist, int32_t bestN)
+                                                int32_t allowedExtendDist, int32_t bestN,
+                                                int32_t bestNPerEnd)
 {
     std::vector<OverlapPtr> newOverlaps;
     for (const auto& ovl : overlaps) {
-        if (100 * ovl->Identity < minIdentity || ovl->ASpan() < minMappedSpan ||
-            ovl->BSpan() < minMappedSpan || ovl->NumSeeds < minNumSeeds ||
-            ovl->Alen < minQueryLen || ovl->Blen < minTargetLen) {
+        if (PassesOverlapFilters(*ovl, minNumSeeds, minIdentity, minMappedSpan, minQueryLen,
+                                 minTargetLen) == false) {
             continue;
         }
         auto newOvl = createOverlap(ovl);
@@ -638,26 +1384,36 @@ std::vector<OverlapPtr> Mapper::FilterOverlaps_(const std::vector<OverlapPtr>& o
     std::stable_sort(ret.begin(), ret.end(),
                      [](const auto& a, const auto& b) { return a->Score < b->Score; });
     // Keep best N.
-    int32_t nToKeep = (bestN > 0) ? std::min(bestN, static_cast<int32_t>(ret.size())) : ret.size();
-    ret.resize(nToKeep);
+    KeepBestOverlaps(ret, bestN, bestNPerEnd);
 
     return ret;
 }
 
-std::vector<OverlapPtr> Mapper::FilterTandemOverlaps_(const std::vector<OverlapPtr>& overlaps)
+std::vector<OverlapPtr> Mapper::FilterTandemOverlaps_(
+    const std::vector<OverlapPtr>& overlaps, std::vector<std::vector<SeedHit>>* anchorHits)
 {
     if (overlaps.empty()) {
+        if (anchorHits != nullptr) {
+            anchorHits->clear();
+        }
         return {};
     }
 
-    // Make an internal copy for sorting.
-    std::vector<OverlapPtr> overlaps_copy;
-    for (const auto& ovl : overlaps) {
-        overlaps_copy.emplace_back(createOverlap(ovl));
+    if (anchorHits != nullptr) {
+        CheckAnchorHitsSize(anchorHits->size(), overlaps.size(), "FilterTandemOverlaps_");
+    }
+
+    // Sort the IDs instead of the overlaps, so that the anchor hits can be permuted
+    // in the same way.
+    std::vector<int32_t> sortedIds(overlaps.size());
+    for (size_t i = 0; i < sortedIds.size(); ++i) {
+        sortedIds[i] = i;
     }
 
     // Sort by length.
-    std::sort(overlaps_copy.begin(), overlaps_copy.end(), [](const auto& a, const auto& b) {
+    std::sort(sortedIds.begin(), sortedIds.end(), [&overlaps](int32_t aId, int32_t bId) {
+        const auto& a = overlaps[aId];
+        const auto& b = overlaps[bId];
         return a->Bid < b->Bid ||
                (a->Bid == b->Bid &&
                 std::max(a->ASpan(), a->BSpan()) > std::max(b->ASpan(), b->BSpan()));
@@ -665,12 +1421,19 @@ std::vector<OverlapPtr> Mapper::FilterTandemOverlaps_(const std::vector<OverlapP
 
     // Accumulate the results.
     std::vector<OverlapPtr> ret;
-    ret.emplace_back(createOverlap(overlaps_copy.front()));
-    for (const auto& ovl : overlaps_copy) {
-        if (ovl->Bid == ret.back()->Bid) {
+    std::vector<std::vector<SeedHit>> retAnchorHits;
+    for (const int32_t id : sortedIds) {
+        if (ret.size() > 0 && overlaps[id]->Bid == ret.back()->Bid) {
             continue;
         }
-        ret.emplace_back(createOverlap(ovl));
+        ret.emplace_back(createOverlap(overlaps[id]));
+        if (anchorHits != nullptr) {
+            retAnchorHits.emplace_back(std::move((*anchorHits)[id]));
+        }
+    }
+
+    if (anchorHits != nullptr) {
+        std::swap(*anchorHits, retAnchorHits);
     }
 
     return ret;
@@ -680,26 +1443,50 @@ std::vector<OverlapPtr> Mapper::AlignOverlaps_(
     const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
     const PacBio::Pancake::FastaSequenceCached& querySeq, const std::string reverseQuerySeq,
     const std::vector<OverlapPtr>& overlaps, double alignBandwidth, double alignMaxDiff,
-    bool useTraceback, bool noSNPs, bool noIndels, bool maskHomopolymers, bool maskSimpleRepeats,
-    bool maskHomopolymerSNPs, bool maskHomopolymersArbitrary, bool trimAlignment,
-    int32_t trimWindowSize, double trimMatchFraction, bool trimToFirstMatch,
-    std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch)
+    int32_t alignMaxWidenings, bool useTraceback, bool noSNPs, bool noIndels,
+    bool maskHomopolymers, bool maskSimpleRepeats, bool maskHomopolymerSNPs,
+    bool maskHomopolymersArbitrary, bool trimAlignment, int32_t trimWindowSize,
+    double trimMatchFraction, bool trimToFirstMatch,
+    const std::vector<std::vector<SeedHit>>& anchorHits, bool alignPiecewise,
+    int32_t piecewiseMinSpan,
+    std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch,
+    AlignmentScheduler* scheduler, int64_t* numWidenings)
 {
-    std::vector<OverlapPtr> ret;
+    if (alignPiecewise || anchorHits.empty() == false) {
+        CheckAnchorHitsSize(anchorHits.size(), overlaps.size(), "AlignOverlaps_");
+    }
 
-    for (size_t i = 0; i < overlaps.size(); ++i) {
+    // The scheduler may change the order of alignment, so the results are collected
+    // by the candidate ID to keep the input order.
+    std::vector<OverlapPtr> aligned(overlaps.size());
+
+    auto AlignCandidate = [&](int32_t i) {
 #ifdef PANCAKE_DEBUG_ALN
         PBLOG_INFO << "Aligning overlap: [" << i << "] "
                    << OverlapWriterBase::PrintOverlapAsM4(overlaps[i], "", "", true, false);
 #endif
         const auto& targetSeq = targetSeqs.GetSequence(overlaps[i]->Bid);
-        OverlapPtr newOverlap = AlignOverlap_(
-            targetSeq, querySeq, reverseQuerySeq, overlaps[i], alignBandwidth, alignMaxDiff,
-            useTraceback, noSNPs, noIndels, maskHomopolymers, maskSimpleRepeats,
-            maskHomopolymerSNPs, maskHomopolymersArbitrary, trimAlignment, trimWindowSize,
-            trimMatchFraction, trimToFirstMatch, sesScratch);
+        OverlapPtr newOverlap;
+        // Merged anchors are always aligned piecewise, to go through the long indels.
+        if (alignPiecewise || overlaps[i]->NumLongIndels > 0) {
+            newOverlap = AlignOverlapPiecewise(
+                targetSeq, querySeq, reverseQuerySeq, overlaps[i], anchorHits[i], piecewiseMinSpan,
+                alignBandwidth, alignMaxDiff, alignMaxWidenings, useTraceback, noSNPs, noIndels,
+                maskHomopolymers, maskSimpleRepeats, maskHomopolymerSNPs, maskHomopolymersArbitrary,
+                trimAlignment, trimWindowSize, trimMatchFraction, trimToFirstMatch, sesScratch,
+                numWidenings);
+        } else {
+            newOverlap = AlignOverlap_(
+                targetSeq, querySeq, reverseQuerySeq, overlaps[i], alignBandwidth, alignMaxDiff,
+                alignMaxWidenings, useTraceback, noSNPs, noIndels, maskHomopolymers,
+                maskSimpleRepeats, maskHomopolymerSNPs, maskHomopolymersArbitrary, trimAlignment,
+                trimWindowSize, trimMatchFraction, trimToFirstMatch, sesScratch, numWidenings);
+        }
         if (newOverlap != nullptr) {
-            ret.emplace_back(std::move(newOverlap));
+            if (scheduler != nullptr) {
+                scheduler->AddAligned(i, *newOverlap);
+            }
+            aligned[i] = std::move(newOverlap);
 #ifdef PANCAKE_DEBUG_ALN
             PBLOG_INFO << "After alignment: "
                        << OverlapWriterBase::PrintOverlapAsM4(overlaps[i], "", "", true, false);
@@ -709,6 +1496,29 @@ std::vector<OverlapPtr> Mapper::AlignOverlaps_(
 #ifdef PANCAKE_DEBUG_ALN
         PBLOG_INFO << "\n";
 #endif
+    };
+
+    for (size_t orderId = 0; orderId < overlaps.size(); ++orderId) {
+        const int32_t i = (scheduler != nullptr) ? scheduler->Order()[orderId] : orderId;
+        if (scheduler != nullptr && scheduler->ShouldAlign(i) == false) {
+            continue;
+        }
+        AlignCandidate(i);
+    }
+
+    // The candidates skipped before an alignment violated the predictions of the scheduler
+    // might have been kept after all.
+    if (scheduler != nullptr) {
+        for (const int32_t i : scheduler->TakeSkipped()) {
+            AlignCandidate(i);
+        }
+    }
+
+    std::vector<OverlapPtr> ret;
+    for (auto& ovl : aligned) {
+        if (ovl != nullptr) {
+            ret.emplace_back(std::move(ovl));
+        }
     }
 
     return ret;
@@ -749,20 +1559,24 @@ std::string Mapper::FetchTargetSubsequence_(const PacBio::Pancake::FastaSequence
     return FetchTargetSubsequence_(targetSeq.Bases(), targetSeq.Size(), seqStart, seqEnd, revCmp);
 }
 
-std::string Mapper::FetchTargetSubsequence_(const char* seq, int32_t seqLen, int32_t seqStart,
-                                            int32_t seqEnd, bool revCmp)
+void Mapper::CheckTargetRange_(int32_t seqLen, int32_t seqStart, int32_t seqEnd)
 {
-    if (seqEnd == seqStart) {
-        return {};
-    }
     if (seqStart < 0 || seqEnd < 0 || seqStart > seqLen || seqEnd > seqLen || seqEnd < seqStart) {
         std::ostringstream oss;
-        oss << "Invalid seqStart or seqEnd in a call to FetchTargetSubsequence_. seqStart = "
-            << seqStart << ", seqEnd = " << seqEnd << ", seqLen = " << seqLen
-            << ", revCmp = " << revCmp << ".";
+        oss << "Invalid seqStart or seqEnd of a target range. seqStart = " << seqStart
+            << ", seqEnd = " << seqEnd << ", seqLen = " << seqLen << ".";
         std::cerr << oss.str() << "\n";
         throw std::runtime_error(oss.str());
     }
+}
+
+std::string Mapper::FetchTargetSubsequence_(const char* seq, int32_t seqLen, int32_t seqStart,
+                                            int32_t seqEnd, bool revCmp)
+{
+    if (seqEnd == seqStart) {
+        return {};
+    }
+    CheckTargetRange_(seqLen, seqStart, seqEnd);
     seqEnd = (seqEnd == 0) ? seqLen : seqEnd;
     std::string ret(seq + seqStart, seqEnd - seqStart);
     if (revCmp) {
@@ -774,11 +1588,12 @@ std::string Mapper::FetchTargetSubsequence_(const char* seq, int32_t seqLen, int
 OverlapPtr Mapper::AlignOverlap_(
     const PacBio::Pancake::FastaSequenceCached& targetSeq,
     const PacBio::Pancake::FastaSequenceCached& querySeq, const std::string reverseQuerySeq,
-    const OverlapPtr& ovl, double alignBandwidth, double alignMaxDiff, bool useTraceback,
-    bool noSNPs, bool noIndels, bool maskHomopolymers, bool maskSimpleRepeats,
+    const OverlapPtr& ovl, double alignBandwidth, double alignMaxDiff, int32_t alignMaxWidenings,
+    bool useTraceback, bool noSNPs, bool noIndels, bool maskHomopolymers, bool maskSimpleRepeats,
     bool maskHomopolymerSNPs, bool maskHomopolymersArbitrary, bool trimAlignment,
     int32_t trimWindowSize, double trimMatchFraction, bool trimToFirstMatch,
-    std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch)
+    std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch,
+    int64_t* numWidenings)
 {
 
     if (ovl == nullptr) {
@@ -791,6 +1606,11 @@ OverlapPtr Mapper::AlignOverlap_(
 
     OverlapPtr ret = createOverlap(ovl);
     PacBio::Pancake::Alignment::SesResults sesResultRight;
+
+    // The extension does not follow the merged anchors, so any long indels are regular diffs.
+    ret->NumLongIndels = 0;
+    ret->LongInsertionBases = 0;
+    ret->LongDeletionBases = 0;
     PacBio::Pancake::Alignment::SesResults sesResultLeft;
 
     ///////////////////////////
@@ -802,43 +1622,48 @@ OverlapPtr Mapper::AlignOverlap_(
         const int32_t qSpan = qEnd - qStart;
         const int32_t tStartFwd = ovl->Brev ? (ovl->Blen - ovl->Bend) : ovl->Bstart;
         const int32_t tEndFwd = ovl->Brev ? (ovl->Blen - ovl->Bstart) : ovl->Bend;
-        std::string tseq;
+        int32_t extractBegin = 0;
+        int32_t extractEnd = 0;
+        const char* qseq = querySeq.Bases() + qStart;
         if (ovl->Brev) {
-            // Extract reverse complemented target sequence.
-            // The reverse complement begins at the last mapped position (tEndFwd),
+            // The reverse complemented target begins at the last mapped position (tEndFwd),
             // and ends at the the tStartFwd reduced by an allowed overhang.
             // The allowed overhang is designed to absorb the entire unmapped end
             // of the query, and at most 2x that length in the target. (The 2xhang
             // is just to be safe, because no proper alignment should be 2x longer
             // in one sequence than in the other).
+            // Aligning the query to the reverse complement of the target is equivalent to
+            // aligning the reverse complement of the query to the target backwards, so
+            // the target does not need to be copied.
             int32_t minHangLen = std::min(ovl->Alen - ovl->Aend, tStartFwd);
-            int32_t extractBegin = std::max(0, tStartFwd - minHangLen * 2);
-            int32_t extractEnd = tEndFwd;
-            tseq = FetchTargetSubsequence_(targetSeq, extractBegin, extractEnd, ovl->Brev);
+            extractBegin = std::max(0, tStartFwd - minHangLen * 2);
+            extractEnd = tEndFwd;
+            qseq = reverseQuerySeq.c_str();
         } else {
             // Take the sequence starting from the start position, and reaching
             // until the end of the query (or target, which ever is the shorter).
             // Extract 2x larger overhang to be safe - no proper alignment should be
             // 2x longer in one sequence than the other.
             int32_t minHangLen = std::min(ovl->Blen - tEndFwd, ovl->Alen - ovl->Aend);
-            int32_t extractBegin = tStartFwd;
-            int32_t extractEnd = std::min(ovl->Blen, tEndFwd + minHangLen * 2);
-            tseq = FetchTargetSubsequence_(targetSeq, extractBegin, extractEnd, ovl->Brev);
+            extractBegin = tStartFwd;
+            extractEnd = std::min(ovl->Blen, tEndFwd + minHangLen * 2);
         }
-        const int32_t tSpan = tseq.size();
+        CheckTargetRange_(targetSeq.Size(), extractBegin, extractEnd);
+        const char* tseq = targetSeq.Bases() + extractBegin;
+        const int32_t tSpan = extractEnd - extractBegin;
         const int32_t dMax =
             std::max(MIN_DIFFS_CAP, static_cast<int32_t>(ovl->Alen * alignMaxDiff));
         const int32_t bandwidth =
             std::max(MIN_BANDWIDTH_CAP,
                      static_cast<int32_t>(std::min(ovl->Blen, ovl->Alen) * alignBandwidth));
 
-        if (useTraceback) {
-            sesResultRight = AlignWithTraceback(querySeq.Bases() + qStart, qSpan, tseq.c_str(),
-                                                tSpan, dMax, bandwidth, sesScratch);
-        } else {
-            sesResultRight = AlignNoTraceback(querySeq.Bases() + qStart, qSpan, tseq.c_str(), tSpan,
-                                              dMax, bandwidth, sesScratch);
-        }
+        const int32_t maxSpan = qSpan + tSpan + 1;
+
+        sesResultRight = AlignSemiglobal(
+            qseq, qSpan, tseq, tSpan, dMax, bandwidth,
+            ComputeWideningCap(dMax, alignMaxWidenings, maxSpan),
+            ComputeWideningCap(bandwidth, alignMaxWidenings, maxSpan), useTraceback, ovl->Brev,
+            sesScratch);
 
         ret->Aend = sesResultRight.lastQueryPos;
         ret->Bend = sesResultRight.lastTargetPos;
@@ -865,38 +1690,47 @@ OverlapPtr Mapper::AlignOverlap_(
         const int32_t qSpan = qEnd - qStart;
         const int32_t tStartFwd = ret->Brev ? (ret->Blen - ret->Bend) : ret->Bstart;
         const int32_t tEndFwd = ret->Brev ? (ret->Blen - ret->Bstart) : ret->Bend;
-        std::string tseq;
+        int32_t extractBegin = 0;
+        int32_t extractEnd = 0;
+        const char* qseq = reverseQuerySeq.c_str() + qStart;
         if (ovl->Brev) {
             int32_t minHangLen = std::min(ovl->Blen - tEndFwd, qStart);
-            int32_t extractBegin = tEndFwd;
-            int32_t extractEnd = std::min(ret->Blen, tEndFwd + minHangLen * 2);
-            tseq = FetchTargetSubsequence_(targetSeq, extractBegin, extractEnd, !ret->Brev);
+            extractBegin = tEndFwd;
+            extractEnd = std::min(ret->Blen, tEndFwd + minHangLen * 2);
         } else {
+            // Both the query and the target would have to be reverse complemented here.
+            // Instead, the forward sequences are aligned backwards.
             int32_t minHangLen = std::min(ovl->Astart, tStartFwd);
-            int32_t extractBegin = std::max(0, tStartFwd - minHangLen * 2);
-            int32_t extractEnd = tStartFwd;
-            tseq = FetchTargetSubsequence_(targetSeq, extractBegin, extractEnd, !ret->Brev);
+            extractBegin = std::max(0, tStartFwd - minHangLen * 2);
+            extractEnd = tStartFwd;
+            qseq = querySeq.Bases();
         }
-        const int32_t tSpan = tseq.size();
+        CheckTargetRange_(targetSeq.Size(), extractBegin, extractEnd);
+        const char* tseq = targetSeq.Bases() + extractBegin;
+        const int32_t tSpan = extractEnd - extractBegin;
         const int32_t dMax = std::max(MIN_DIFFS_CAP, static_cast<int32_t>(ovl->Alen * alignMaxDiff -
                                                                           sesResultRight.numDiffs));
         const int32_t bandwidth =
             std::max(MIN_BANDWIDTH_CAP,
                      static_cast<int32_t>(std::min(ovl->Blen, ovl->Alen) * alignBandwidth));
 
-        if (useTraceback) {
-            sesResultLeft = AlignWithTraceback(reverseQuerySeq.c_str() + qStart, qSpan,
-                                               tseq.c_str(), tSpan, dMax, bandwidth, sesScratch);
-        } else {
-            sesResultLeft = AlignNoTraceback(reverseQuerySeq.c_str() + qStart, qSpan, tseq.c_str(),
-                                             tSpan, dMax, bandwidth, sesScratch);
-        }
+        const int32_t maxSpan = qSpan + tSpan + 1;
+
+        sesResultLeft = AlignSemiglobal(
+            qseq, qSpan, tseq, tSpan, dMax, bandwidth,
+            ComputeWideningCap(dMax, alignMaxWidenings, maxSpan),
+            ComputeWideningCap(bandwidth, alignMaxWidenings, maxSpan), useTraceback, !ovl->Brev,
+            sesScratch);
 
         ret->Astart = ovl->Astart - sesResultLeft.lastQueryPos;
         ret->Bstart = ovl->Bstart - sesResultLeft.lastTargetPos;
         std::reverse(sesResultLeft.cigar.begin(), sesResultLeft.cigar.end());
     }
 
+    if (numWidenings != nullptr) {
+        *numWidenings += sesResultRight.numWidenings + sesResultLeft.numWidenings;
+    }
+
     PacBio::Pancake::Alignment::DiffCounts diffs =
         sesResultRight.diffCounts + sesResultLeft.diffCounts;
 
@@ -945,6 +1779,347 @@ OverlapPtr Mapper::AlignOverlap_(
     return ret;
 }
 
+OverlapPtr Mapper::AlignOverlapPiecewise(
+    const PacBio::Pancake::FastaSequenceCached& targetSeq,
+    const PacBio::Pancake::FastaSequenceCached& querySeq, const std::string reverseQuerySeq,
+    const OverlapPtr& ovl, const std::vector<SeedHit>& anchorHits, int32_t minAlignmentSpan,
+    double alignBandwidth, double alignMaxDiff, int32_t alignMaxWidenings, bool useTraceback,
+    bool noSNPs, bool noIndels, bool maskHomopolymers, bool maskSimpleRepeats,
+    bool maskHomopolymerSNPs, bool maskHomopolymersArbitrary, bool trimAlignment,
+    int32_t trimWindowSize, double trimMatchFraction, bool trimToFirstMatch,
+    std::shared_ptr<PacBio::Pancake::Alignment::SESScratchSpace> sesScratch,
+    int64_t* numWidenings)
+{
+    if (ovl == nullptr) {
+        return nullptr;
+    }
+
+    auto AlignFullOverlap = [&]() {
+        return AlignOverlap_(targetSeq, querySeq, reverseQuerySeq, ovl, alignBandwidth,
+                             alignMaxDiff, alignMaxWidenings, useTraceback, noSNPs, noIndels,
+                             maskHomopolymers, maskSimpleRepeats, maskHomopolymerSNPs,
+                             maskHomopolymersArbitrary, trimAlignment, trimWindowSize,
+                             trimMatchFraction, trimToFirstMatch, sesScratch, numWidenings);
+    };
+
+    // At least two hits are needed to define a region between them.
+    if (anchorHits.size() < 2) {
+        return AlignFullOverlap();
+    }
+
+    if (ovl->Astart != anchorHits.front().queryPos || ovl->Aend != anchorHits.back().queryPos ||
+        ovl->Bstart != anchorHits.front().targetPos || ovl->Bend != anchorHits.back().targetPos ||
+        ovl->Brev != anchorHits.front().targetRev) {
+        std::ostringstream oss;
+        oss << "Provided overlap coordinates do not match the first/last seed hit in "
+               "AlignOverlapPiecewise. ovl: "
+            << OverlapWriterBase::PrintOverlapAsM4(ovl, "", "", true, false)
+            << "; anchorHits.front() = " << anchorHits.front()
+            << "; anchorHits.back() = " << anchorHits.back();
+        throw std::runtime_error(oss.str());
+    }
+
+    // The regions are given in the strand of the query, while the target is always forward.
+    // This means that the target sequence never needs to be copied or reverse complemented.
+    // The 2.0 factor allows the flank to be at most 2x longer in the target than in the query,
+    // same as in AlignOverlap_.
+    const std::vector<SeedHit> boundaryHits =
+        FilterDetourHits(anchorHits, MIN_DIFFS_CAP, minAlignmentSpan);
+    const std::vector<AlignmentRegion> regions = ExtractAlignmentRegions(
+        boundaryHits, ovl->Alen, ovl->Blen, ovl->Brev, minAlignmentSpan, -1, 2.0);
+
+    // The coordinates of the result are anchored on the inner regions.
+    if (std::none_of(regions.begin(), regions.end(), [](const AlignmentRegion& region) {
+            return region.type == RegionType::GLOBAL;
+        })) {
+        return AlignFullOverlap();
+    }
+    const char* querySeqInStrand = ovl->Brev ? reverseQuerySeq.c_str() : querySeq.Bases();
+    const char* targetSeqFwd = targetSeq.Bases();
+
+    // Joins of the merged anchors which span a long indel, in the same coordinates as the regions.
+    std::vector<AlignmentRegion> longJoins;
+    int32_t longInsertionBases = 0;
+    int32_t longDeletionBases = 0;
+    for (size_t i = 1; i < boundaryHits.size(); ++i) {
+        if (boundaryHits[i].CheckFlagLongJoin() == false) {
+            continue;
+        }
+        const auto& h1 = ovl->Brev ? boundaryHits[i] : boundaryHits[i - 1];
+        const auto& h2 = ovl->Brev ? boundaryHits[i - 1] : boundaryHits[i];
+        AlignmentRegion join;
+        join.qStart = ovl->Brev ? (ovl->Alen - h1.queryPos) : h1.queryPos;
+        join.tStart = ovl->Brev ? (ovl->Blen - h1.targetPos) : h1.targetPos;
+        join.qSpan = (ovl->Brev ? (ovl->Alen - h2.queryPos) : h2.queryPos) - join.qStart;
+        join.tSpan = (ovl->Brev ? (ovl->Blen - h2.targetPos) : h2.targetPos) - join.tStart;
+        if (join.qSpan < 0 || join.tSpan < 0 || join.qSpan == join.tSpan) {
+            continue;
+        }
+        longInsertionBases += std::max(0, join.qSpan - join.tSpan);
+        longDeletionBases += std::max(0, join.tSpan - join.qSpan);
+        longJoins.emplace_back(join);
+    }
+    std::sort(longJoins.begin(), longJoins.end(),
+              [](const AlignmentRegion& a, const AlignmentRegion& b) {
+                  return a.qStart < b.qStart;
+              });
+
+    // Same limits as for the full overlap in AlignOverlap_. The inner regions consume the
+    // allowed diffs first, and the flanks get the rest. The long indels of merged anchors
+    // are allowed on top of that.
+    const int32_t dMaxTotal =
+        std::max(MIN_DIFFS_CAP, static_cast<int32_t>(ovl->Alen * alignMaxDiff)) +
+        longInsertionBases + longDeletionBases;
+    const int32_t flankBandwidth = std::max(
+        MIN_BANDWIDTH_CAP, static_cast<int32_t>(std::min(ovl->Blen, ovl->Alen) * alignBandwidth));
+    int32_t numDiffsTotal = 0;
+
+    // Globally aligns a part of an inner region, with at most maxDiffs diffs.
+    auto AlignGlobalPart = [&](int32_t qStart, int32_t qSpan, int32_t tStart, int32_t tSpan,
+                               int32_t maxDiffs) {
+        PacBio::Pancake::Alignment::SesResults res;
+        if (qSpan == 0 || tSpan == 0) {
+            // SES2 does not produce a CIGAR for empty sequences.
+            res.valid = true;
+            res.lastQueryPos = qSpan;
+            res.lastTargetPos = tSpan;
+            res.diffCounts.numI = qSpan;
+            res.diffCounts.numD = tSpan;
+            res.numDiffs = qSpan + tSpan;
+            if (useTraceback && qSpan > 0) {
+                res.cigar.emplace_back(PacBio::BAM::CigarOperationType::INSERTION, qSpan);
+            } else if (useTraceback && tSpan > 0) {
+                res.cigar.emplace_back(PacBio::BAM::CigarOperationType::DELETION, tSpan);
+            }
+            return res;
+        }
+
+        // Start with a diff budget proportional to the region length, and widen it
+        // if the region could not be aligned. The alignment resumes from where the smaller
+        // budget ran out. The diffs can never exceed qSpan + tSpan.
+        const int32_t maxSpan = std::max(qSpan, tSpan);
+        const int32_t spanDiff = std::abs(qSpan - tSpan);
+        const int32_t dMaxCap = std::min(maxDiffs, qSpan + tSpan + 1);
+        const int32_t dMax = std::min(
+            dMaxCap,
+            std::max(MIN_DIFFS_CAP, spanDiff + static_cast<int32_t>(maxSpan * alignMaxDiff)));
+        if (dMax <= spanDiff) {
+            return res;
+        }
+
+        if (useTraceback) {
+            res = AlignGlobalWithTraceback(querySeqInStrand + qStart, qSpan, targetSeqFwd + tStart,
+                                           tSpan, dMax, dMax, dMaxCap, dMaxCap, sesScratch);
+        } else {
+            res = AlignGlobalNoTraceback(querySeqInStrand + qStart, qSpan, targetSeqFwd + tStart,
+                                         tSpan, dMax, dMax, dMaxCap, dMaxCap, sesScratch);
+        }
+        if (numWidenings != nullptr) {
+            *numWidenings += res.numWidenings;
+        }
+        return res;
+    };
+
+    std::vector<PacBio::Pancake::Alignment::SesResults> results(regions.size());
+
+    // Align the regions between the hits.
+    size_t nextJoin = 0;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const auto& region = regions[i];
+        if (region.type != RegionType::GLOBAL) {
+            continue;
+        }
+        auto& res = results[i];
+
+        // The long indels of the merged anchors would need a band of twice their size, so the
+        // region is split at each of them instead. The flanks of a join stay on the diagonals
+        // of the neighboring hits, and the indel is placed in between.
+        const int32_t qEnd = region.qStart + region.qSpan;
+        const int32_t tEnd = region.tStart + region.tSpan;
+        while (nextJoin < longJoins.size() && longJoins[nextJoin].qStart < region.qStart) {
+            ++nextJoin;
+        }
+        if (nextJoin < longJoins.size() && longJoins[nextJoin].qStart >= region.qStart &&
+            (longJoins[nextJoin].qStart + longJoins[nextJoin].qSpan) <= qEnd) {
+            res.valid = true;
+            auto AddPart = [&](const PacBio::Pancake::Alignment::SesResults& part) {
+                res.valid = res.valid && part.valid;
+                res.numDiffs += part.numDiffs;
+                res.diffCounts = res.diffCounts + part.diffCounts;
+                for (const auto& op : part.cigar) {
+                    AppendToCigar(res.cigar, op.Type(), op.Length());
+                }
+            };
+            int32_t qPos = region.qStart;
+            int32_t tPos = region.tStart;
+            for (; res.valid && nextJoin < longJoins.size() &&
+                   (longJoins[nextJoin].qStart + longJoins[nextJoin].qSpan) <= qEnd;
+                 ++nextJoin) {
+                const auto& join = longJoins[nextJoin];
+                const int32_t qShift = std::max(0, join.qSpan - join.tSpan);
+                const int32_t tShift = std::max(0, join.tSpan - join.qSpan);
+                const int32_t breakpoint = FindLongIndelBreakpoint(
+                    querySeqInStrand + join.qStart, join.qSpan, targetSeqFwd + join.tStart,
+                    join.tSpan);
+                AddPart(AlignGlobalPart(qPos, join.qStart + breakpoint - qPos, tPos,
+                                        join.tStart + breakpoint - tPos,
+                                        dMaxTotal - numDiffsTotal - res.numDiffs));
+                PacBio::Pancake::Alignment::SesResults indel;
+                indel.valid = true;
+                indel.numDiffs = qShift + tShift;
+                indel.diffCounts.numI = qShift;
+                indel.diffCounts.numD = tShift;
+                if (useTraceback) {
+                    indel.cigar.emplace_back((qShift > 0)
+                                                 ? PacBio::BAM::CigarOperationType::INSERTION
+                                                 : PacBio::BAM::CigarOperationType::DELETION,
+                                             qShift + tShift);
+                }
+                AddPart(indel);
+                qPos = join.qStart + breakpoint + qShift;
+                tPos = join.tStart + breakpoint + tShift;
+            }
+            if (res.valid) {
+                AddPart(AlignGlobalPart(qPos, qEnd - qPos, tPos, tEnd - tPos,
+                                        dMaxTotal - numDiffsTotal - res.numDiffs));
+            }
+            res.lastQueryPos = region.qSpan;
+            res.lastTargetPos = region.tSpan;
+
+        } else {
+            res = AlignGlobalPart(region.qStart, region.qSpan, region.tStart, region.tSpan,
+                                  dMaxTotal - numDiffsTotal);
+        }
+
+        // Too many diffs between the hits. Let the full alignment decide how far it can go.
+        if (res.valid == false) {
+            return AlignFullOverlap();
+        }
+        numDiffsTotal += res.numDiffs;
+    }
+
+    // Extend the back flank, and then the front flank, with whatever is left of the diff budget.
+    for (const RegionType flankType : {RegionType::BACK, RegionType::FRONT}) {
+        for (size_t i = 0; i < regions.size(); ++i) {
+            const auto& region = regions[i];
+            if (region.type != flankType) {
+                continue;
+            }
+            auto& res = results[i];
+
+            const int32_t maxSpan = region.qSpan + region.tSpan + 1;
+            const int32_t dMax =
+                std::max(MIN_DIFFS_CAP, std::min(dMaxTotal - numDiffsTotal, maxSpan));
+
+            // The front flank is aligned backwards, from the first anchor.
+            res = AlignSemiglobal(querySeqInStrand + region.qStart, region.qSpan,
+                                  targetSeqFwd + region.tStart, region.tSpan, dMax, flankBandwidth,
+                                  ComputeWideningCap(dMax, alignMaxWidenings, maxSpan),
+                                  ComputeWideningCap(flankBandwidth, alignMaxWidenings, maxSpan),
+                                  useTraceback, region.type == RegionType::FRONT, sesScratch);
+            if (numWidenings != nullptr) {
+                *numWidenings += res.numWidenings;
+            }
+
+            if (region.type == RegionType::FRONT) {
+                std::reverse(res.cigar.begin(), res.cigar.end());
+            }
+
+            numDiffsTotal += res.numDiffs;
+        }
+    }
+
+    // Collect the coordinates, diffs and the CIGAR.
+    int32_t globalAlnQueryStart = -1;
+    int32_t globalAlnTargetStart = -1;
+    int32_t globalAlnQueryEnd = 0;
+    int32_t globalAlnTargetEnd = 0;
+    int32_t offsetFrontQuery = 0;
+    int32_t offsetFrontTarget = 0;
+    int32_t offsetBackQuery = 0;
+    int32_t offsetBackTarget = 0;
+    PacBio::Pancake::Alignment::DiffCounts diffs;
+    PacBio::BAM::Cigar cigar;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const auto& region = regions[i];
+        const auto& res = results[i];
+        if (region.type == RegionType::FRONT) {
+            offsetFrontQuery = res.lastQueryPos;
+            offsetFrontTarget = res.lastTargetPos;
+        } else if (region.type == RegionType::BACK) {
+            offsetBackQuery = res.lastQueryPos;
+            offsetBackTarget = res.lastTargetPos;
+        } else {
+            if (globalAlnQueryStart < 0) {
+                globalAlnQueryStart = region.qStart;
+                globalAlnTargetStart = region.tStart;
+            }
+            globalAlnQueryEnd = region.qStart + region.qSpan;
+            globalAlnTargetEnd = region.tStart + region.tSpan;
+        }
+        diffs = diffs + res.diffCounts;
+        for (const auto& op : res.cigar) {
+            AppendToCigar(cigar, op.Type(), op.Length());
+        }
+    }
+
+    OverlapPtr ret = createOverlap(ovl);
+    ret->NumLongIndels = longJoins.size();
+    ret->LongInsertionBases = longInsertionBases;
+    ret->LongDeletionBases = longDeletionBases;
+    ret->Astart = globalAlnQueryStart - offsetFrontQuery;
+    ret->Aend = globalAlnQueryEnd + offsetBackQuery;
+    ret->Bstart = globalAlnTargetStart - offsetFrontTarget;
+    ret->Bend = globalAlnTargetEnd + offsetBackTarget;
+    ret->Cigar = std::move(cigar);
+
+    // Convert back to the forward query and the target in strand.
+    if (ret->Brev) {
+        std::reverse(ret->Cigar.begin(), ret->Cigar.end());
+        std::swap(ret->Astart, ret->Aend);
+        ret->Astart = ret->Alen - ret->Astart;
+        ret->Aend = ret->Alen - ret->Aend;
+        std::swap(ret->Bstart, ret->Bend);
+        ret->Bstart = ret->Blen - ret->Bstart;
+        ret->Bend = ret->Blen - ret->Bend;
+    }
+
+    // Compute edit distance, identity and score. The long indels are not counted.
+    ret->EditDistance = -1;
+    if (useTraceback) {
+        diffs = RemoveLongIndelDiffs(diffs, *ret);
+        diffs.Identity(noSNPs, noIndels, ret->Identity, ret->EditDistance);
+        ret->Score = -diffs.numEq;
+    } else {
+        const int32_t qSpan = ret->ASpan() - ret->LongInsertionBases;
+        const int32_t tSpan = ret->BSpan() - ret->LongDeletionBases;
+        ret->EditDistance = std::max(
+            0, numDiffsTotal - ret->LongInsertionBases - ret->LongDeletionBases);
+        ret->Score = -(std::min(qSpan, tSpan) - ret->EditDistance);
+        const float span = std::max(qSpan, tSpan);
+        ret->Identity =
+            ((span != 0.0f) ? ((span - static_cast<float>(ret->EditDistance)) / span) : -0.0f);
+    }
+
+    if (trimAlignment && ret->Cigar.size() > 0) {
+        PacBio::BAM::Cigar newCigar;
+        TrimmingInfo trimInfo;
+        TrimCigar(ret->Cigar, trimWindowSize, std::max(1.0, trimWindowSize * trimMatchFraction),
+                  trimToFirstMatch, newCigar, trimInfo);
+        ret->Astart += trimInfo.queryFront;
+        ret->Bstart += trimInfo.targetFront;
+        ret->Aend -= trimInfo.queryBack;
+        ret->Bend -= trimInfo.targetBack;
+        std::swap(ret->Cigar, newCigar);
+    }
+
+    NormalizeAndExtractVariantsInPlace_(ret, targetSeq, querySeq, reverseQuerySeq, noSNPs, noIndels,
+                                        maskHomopolymers, maskSimpleRepeats, maskHomopolymerSNPs,
+                                        maskHomopolymersArbitrary);
+
+    return ret;
+}
+
 void Mapper::NormalizeAndExtractVariantsInPlace_(
     OverlapPtr& ovl, const PacBio::Pancake::FastaSequenceCached& targetSeq,
     const PacBio::Pancake::FastaSequenceCached& querySeq, const std::string /*reverseQuerySeq*/,
@@ -1000,7 +2175,7 @@ void Mapper::NormalizeAndExtractVariantsInPlace_(
                          maskSimpleRepeats, maskHomopolymerSNPs, maskHomopolymersArbitrary,
                          ovl->Avars, ovl->Bvars, diffsPerBase, diffsPerEvent);
 
-    const auto& diffs = diffsPerBase;
+    const auto diffs = RemoveLongIndelDiffs(diffsPerBase, *ovl);
     diffs.Identity(noSNPs, noIndels, ovl->Identity, ovl->EditDistance);
     ovl->Score = -diffs.numEq;
 }
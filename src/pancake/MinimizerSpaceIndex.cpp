@@ -0,0 +1,439 @@
+// Author: Ivan Sovic
+
+#include <pacbio/pancake/Minimizers.h>
+#include <pacbio/pancake/MinimizerSpaceIndex.h>
+#include <pacbio/pancake/Seed.h>
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+namespace PacBio {
+namespace Pancake {
+
+namespace {
+
+using PacBio::Pancake::SeedDB::Seed;
+using PacBio::Pancake::SeedDB::SeedRaw;
+
+/*
+ * \brief A seed decoded for the minimizer-space merge. Target seeds on the reverse strand
+ * are reported in the reverse complement coordinates, with the strand flag flipped.
+*/
+class MinSpaceSeed
+{
+public:
+    uint64_t key = 0;
+    int32_t pos = 0;
+    int32_t span = 0;
+    bool isRev = false;
+};
+
+inline MinSpaceSeed DecodeMinSpaceSeed(const SeedRaw& seed)
+{
+    MinSpaceSeed ret;
+    ret.key = Seed::DecodeKey(seed);
+    ret.pos = Seed::DecodePos(seed);
+    ret.span = Seed::DecodeSpan(seed);
+    ret.isRev = Seed::DecodeIsRev(seed);
+    return ret;
+}
+
+inline MinSpaceSeed DecodeMinSpaceSeedReverse(const SeedRaw& seed, int32_t seqLen)
+{
+    MinSpaceSeed ret = DecodeMinSpaceSeed(seed);
+    ret.pos = seqLen - (ret.pos + ret.span);
+    ret.isRev = !ret.isRev;
+    return ret;
+}
+
+inline uint64_t MixKMinMerHash(uint64_t hash, uint64_t key, bool isRev)
+{
+    const uint64_t value = ((key << 1) | static_cast<uint64_t>(isRev)) * 0x9E3779B97F4A7C15ULL;
+    return PacBio::Pancake::SeedDB::InvertibleHash(hash ^ value, 0xFFFFFFFFFFFFFFFFULL);
+}
+
+inline bool SeedsByPosition(const SeedRaw& a, const SeedRaw& b)
+{
+    return std::make_tuple(Seed::DecodeSeqId(a), Seed::DecodePos(a), Seed::DecodeKey(a)) <
+           std::make_tuple(Seed::DecodeSeqId(b), Seed::DecodePos(b), Seed::DecodeKey(b));
+}
+
+/*
+ * \brief A pair of k-min-mers which have the same hash. The target seed index is in the
+ * orientation of the query, i.e. counted from the back of the target if the strands differ.
+*/
+class MinSpaceCandidate
+{
+public:
+    int32_t targetId = 0;
+    bool targetRev = false;
+    int32_t queryFirst = 0;
+    int32_t targetFirst = 0;
+
+    bool operator<(const MinSpaceCandidate& b) const
+    {
+        return std::tie(targetId, targetRev, queryFirst, targetFirst) <
+               std::tie(b.targetId, b.targetRev, b.queryFirst, b.targetFirst);
+    }
+};
+
+/*
+ * \brief Finds the first pair of matching seeds on the given diagonal, starting from the
+ * indices i and j and moving in the direction of step. The target seeds are sorted by
+ * position, so a single pass over both strings is needed.
+*/
+template <typename GetQuerySeed, typename GetTargetSeed>
+bool FindNextMatchOnDiagonal(const GetQuerySeed& getQuerySeed, int32_t numQuerySeeds,
+                             const GetTargetSeed& getTargetSeed, int32_t numTargetSeeds,
+                             int32_t i, int32_t j, int32_t step, int32_t refDiag,
+                             int32_t maxDiagonalDiff, int32_t& retI, int32_t& retJ)
+{
+    for (; i >= 0 && i < numQuerySeeds; i += step) {
+        const MinSpaceSeed q = getQuerySeed(i);
+        const int32_t expectedPos = q.pos + refDiag;
+        while (j >= 0 && j < numTargetSeeds &&
+               step * (getTargetSeed(j).pos - expectedPos) < -maxDiagonalDiff) {
+            j += step;
+        }
+        for (int32_t k = j; k >= 0 && k < numTargetSeeds; k += step) {
+            const MinSpaceSeed t = getTargetSeed(k);
+            if (step * (t.pos - expectedPos) > maxDiagonalDiff) {
+                break;
+            }
+            if (q.key == t.key && q.isRev == t.isRev) {
+                retI = i;
+                retJ = k;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*
+ * \brief Walks along two minimizer strings starting from a matching pair of seeds.
+ * If the next two seeds do not match, the closest matching pair within maxSkip seeds
+ * on either string is taken instead. If there is none (e.g. in a low quality region of a read),
+ * the walk continues from the next matching pair on the same diagonal.
+ * Returns the last matching pair of indices, and the number of matches.
+*/
+template <typename GetQuerySeed, typename GetTargetSeed>
+int32_t MergeMinimizerStrings(const GetQuerySeed& getQuerySeed, int32_t numQuerySeeds,
+                              const GetTargetSeed& getTargetSeed, int32_t numTargetSeeds,
+                              int32_t startQuery, int32_t startTarget, int32_t step,
+                              int32_t maxSkip, int32_t maxDiagonalDiff, int32_t& retLastQuery,
+                              int32_t& retLastTarget)
+{
+    retLastQuery = startQuery;
+    retLastTarget = startTarget;
+
+    const auto IsInside = [&](int32_t i, int32_t j) {
+        return i >= 0 && i < numQuerySeeds && j >= 0 && j < numTargetSeeds;
+    };
+
+    MinSpaceSeed qs = getQuerySeed(startQuery);
+    MinSpaceSeed ts = getTargetSeed(startTarget);
+    int32_t refDiag = ts.pos - qs.pos;
+    int32_t numMatches = 1;
+
+    const auto IsMatch = [&](int32_t i, int32_t j) {
+        const MinSpaceSeed q = getQuerySeed(i);
+        const MinSpaceSeed t = getTargetSeed(j);
+        return q.key == t.key && q.isRev == t.isRev &&
+               std::abs((t.pos - q.pos) - refDiag) <= maxDiagonalDiff;
+    };
+
+    int32_t i = startQuery + step;
+    int32_t j = startTarget + step;
+    while (IsInside(i, j)) {
+        bool found = IsMatch(i, j);
+        // Resynchronize the strings by trying the smallest total skips first.
+        for (int32_t totalSkip = 1; found == false && totalSkip <= 2 * maxSkip; ++totalSkip) {
+            for (int32_t di = std::max(0, totalSkip - maxSkip);
+                 di <= std::min(totalSkip, maxSkip); ++di) {
+                const int32_t ni = i + di * step;
+                const int32_t nj = j + (totalSkip - di) * step;
+                if (IsInside(ni, nj) && IsMatch(ni, nj)) {
+                    i = ni;
+                    j = nj;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (found == false &&
+            FindNextMatchOnDiagonal(getQuerySeed, numQuerySeeds, getTargetSeed, numTargetSeeds,
+                                    i, j, step, refDiag, maxDiagonalDiff, i, j) == false) {
+            break;
+        }
+        refDiag = getTargetSeed(j).pos - getQuerySeed(i).pos;
+        retLastQuery = i;
+        retLastTarget = j;
+        ++numMatches;
+        i += step;
+        j += step;
+    }
+
+    return numMatches;
+}
+
+/*
+ * \brief A run of matching minimizers found by a single merge, given by the indices of the
+ * first and the last matching seed in the query and the target minimizer strings.
+*/
+class MinSpaceSegment
+{
+public:
+    int32_t firstQuery = 0;
+    int32_t lastQuery = 0;
+    int32_t firstTarget = 0;
+    int32_t lastTarget = 0;
+    int32_t numShared = 0;
+};
+
+}  // namespace
+
+MinimizerSpaceIndex::MinimizerSpaceIndex(
+    const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams,
+    const std::vector<int32_t>& sequenceLengths,
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds, int32_t kMinMerSize)
+    : seeds_(std::move(seeds))
+    , seedParams_(seedParams)
+    , sequenceLengths_(sequenceLengths)
+    , kMinMerSize_(kMinMerSize)
+{
+    if (kMinMerSize_ <= 0) {
+        throw std::runtime_error(
+            "The k-min-mer size needs to be > 0 in MinimizerSpaceIndex. kMinMerSize = " +
+            std::to_string(kMinMerSize_));
+    }
+
+#ifdef SEED_INDEX_USING_DENSEHASH
+    hash_.set_empty_key(
+        SEED_INDEX_EMPTY_HASH_KEY);  // Densehash requires this to be defined on top.
+#endif
+
+    BuildIndex_();
+}
+
+MinimizerSpaceIndex::~MinimizerSpaceIndex() = default;
+
+void MinimizerSpaceIndex::BuildIndex_()
+{
+    // Minimizer strings are ordered by position.
+    std::sort(seeds_.begin(), seeds_.end(), SeedsByPosition);
+
+    // Find the range of seeds for each sequence.
+    sequenceRanges_.assign(sequenceLengths_.size(), std::make_pair(0, 0));
+    for (int64_t start = 0, end = 0; start < static_cast<int64_t>(seeds_.size()); start = end) {
+        const int32_t seqId = PacBio::Pancake::SeedDB::Seed::DecodeSeqId(seeds_[start]);
+        if (seqId >= static_cast<int32_t>(sequenceLengths_.size())) {
+            std::ostringstream oss;
+            oss << "Seed sequence ID is out of bounds of the sequence lengths in "
+                   "MinimizerSpaceIndex. seqId = "
+                << seqId << ", sequenceLengths_.size() = " << sequenceLengths_.size();
+            throw std::runtime_error(oss.str());
+        }
+        end = start + 1;
+        while (end < static_cast<int64_t>(seeds_.size()) &&
+               PacBio::Pancake::SeedDB::Seed::DecodeSeqId(seeds_[end]) == seqId) {
+            ++end;
+        }
+        sequenceRanges_[seqId] = std::make_pair(start, end);
+    }
+
+    // Collect and sort the k-min-mers.
+    kMinMers_.clear();
+    kMinMers_.reserve(seeds_.size());
+    for (int32_t seqId = 0; seqId < static_cast<int32_t>(sequenceRanges_.size()); ++seqId) {
+        const auto& range = sequenceRanges_[seqId];
+        ComputeKMinMers_(seeds_.data() + range.first,
+                         static_cast<int32_t>(range.second - range.first), seqId, kMinMerSize_,
+                         kMinMers_);
+    }
+    std::sort(kMinMers_.begin(), kMinMers_.end(), [](const KMinMer& a, const KMinMer& b) {
+        return std::tie(a.hash, a.seqId, a.firstSeedId) < std::tie(b.hash, b.seqId, b.firstSeedId);
+    });
+
+    // Fill out the hash table.
+    hash_.clear();
+    for (int64_t start = 0, end = 0; start < static_cast<int64_t>(kMinMers_.size());
+         start = end) {
+        end = start + 1;
+        while (end < static_cast<int64_t>(kMinMers_.size()) &&
+               kMinMers_[end].hash == kMinMers_[start].hash) {
+            ++end;
+        }
+        hash_[kMinMers_[start].hash] = std::make_pair(start, end);
+    }
+}
+
+void MinimizerSpaceIndex::ComputeKMinMers_(const PacBio::Pancake::SeedDB::SeedRaw* seeds,
+                                           int32_t numSeeds, int32_t seqId, int32_t kMinMerSize,
+                                           std::vector<KMinMer>& retKMinMers)
+{
+    for (int32_t i = 0; (i + kMinMerSize) <= numSeeds; ++i) {
+        // The reverse complement of a minimizer string has the seeds in the reverse order,
+        // with the same keys and the flipped strands.
+        uint64_t hashFwd = 0;
+        uint64_t hashRev = 0;
+        for (int32_t j = 0; j < kMinMerSize; ++j) {
+            const auto& seedFwd = seeds[i + j];
+            const auto& seedRev = seeds[i + kMinMerSize - 1 - j];
+            hashFwd = MixKMinMerHash(hashFwd, Seed::DecodeKey(seedFwd), Seed::DecodeIsRev(seedFwd));
+            hashRev =
+                MixKMinMerHash(hashRev, Seed::DecodeKey(seedRev), !Seed::DecodeIsRev(seedRev));
+        }
+        if (hashFwd == hashRev) {
+            continue;
+        }
+        KMinMer kMinMer;
+        kMinMer.hash = std::min(hashFwd, hashRev);
+        kMinMer.seqId = seqId;
+        kMinMer.firstSeedId = i;
+        kMinMer.isRev = hashRev < hashFwd;
+        retKMinMers.emplace_back(kMinMer);
+    }
+}
+
+void MinimizerSpaceIndex::ComputeFrequencyStats(double percentileCutoff, int64_t& retFreqMax,
+                                                double& retFreqAvg, double& retFreqMedian,
+                                                int64_t& retFreqCutoff) const
+{
+    ComputeSeedHashFrequencyStats(hash_, percentileCutoff, retFreqMax, retFreqAvg, retFreqMedian,
+                                  retFreqCutoff);
+}
+
+void MinimizerSpaceIndex::FindMatches(const PacBio::Pancake::SeedDB::SeedRaw* querySeeds,
+                                      int64_t querySeedsSize, int32_t queryId, int64_t freqCutoff,
+                                      int32_t maxSkip, int32_t maxDiagonalDiff, bool skipSelfHits,
+                                      bool skipSymmetricOverlaps,
+                                      std::vector<MinimizerSpaceMatch>& matches) const
+{
+    matches.clear();
+
+    if (querySeedsSize < kMinMerSize_ || hash_.empty()) {
+        return;
+    }
+
+    // Construct the minimizer string of the query.
+    std::vector<SeedRaw> qSeeds(querySeeds, querySeeds + querySeedsSize);
+    std::sort(qSeeds.begin(), qSeeds.end(), SeedsByPosition);
+    const int32_t numQuerySeeds = qSeeds.size();
+
+    std::vector<KMinMer> queryKMinMers;
+    ComputeKMinMers_(qSeeds.data(), numQuerySeeds, queryId, kMinMerSize_, queryKMinMers);
+
+    // Look up the k-min-mers.
+    std::vector<MinSpaceCandidate> candidates;
+    for (const auto& qk : queryKMinMers) {
+        auto it = hash_.find(qk.hash);
+        if (it == hash_.end()) {
+            continue;
+        }
+        const int64_t start = std::get<0>(it->second);
+        const int64_t end = std::get<1>(it->second);
+        if (freqCutoff > 0 && (end - start) > freqCutoff) {
+            continue;
+        }
+        for (int64_t i = start; i < end; ++i) {
+            const auto& tk = kMinMers_[i];
+            if ((skipSelfHits && tk.seqId == queryId) ||
+                (skipSymmetricOverlaps && tk.seqId > queryId)) {
+                continue;
+            }
+            const auto& range = sequenceRanges_[tk.seqId];
+            const int32_t numTargetSeeds = range.second - range.first;
+            MinSpaceCandidate candidate;
+            candidate.targetId = tk.seqId;
+            candidate.targetRev = qk.isRev != tk.isRev;
+            candidate.queryFirst = qk.firstSeedId;
+            candidate.targetFirst = candidate.targetRev
+                                        ? (numTargetSeeds - 1 - (tk.firstSeedId + kMinMerSize_ - 1))
+                                        : tk.firstSeedId;
+            candidates.emplace_back(candidate);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    const auto GetQuerySeed = [&](int32_t i) { return DecodeMinSpaceSeed(qSeeds[i]); };
+
+    // Merged segments of the current target and strand. The candidates which were already
+    // covered by a previous segment are skipped.
+    std::vector<MinSpaceSegment> segments;
+
+    for (size_t candId = 0; candId < candidates.size(); ++candId) {
+        const auto& cand = candidates[candId];
+
+        bool isCovered = false;
+        for (const auto& seg : segments) {
+            if (cand.queryFirst >= seg.firstQuery && cand.queryFirst <= seg.lastQuery &&
+                cand.targetFirst >= seg.firstTarget && cand.targetFirst <= seg.lastTarget) {
+                isCovered = true;
+                break;
+            }
+        }
+
+        const auto& range = sequenceRanges_[cand.targetId];
+        const SeedRaw* tSeeds = seeds_.data() + range.first;
+        const int32_t numTargetSeeds = range.second - range.first;
+        const int32_t targetLen = sequenceLengths_[cand.targetId];
+        const bool targetRev = cand.targetRev;
+        const auto GetTargetSeed = [&](int32_t j) {
+            return targetRev ? DecodeMinSpaceSeedReverse(tSeeds[numTargetSeeds - 1 - j], targetLen)
+                             : DecodeMinSpaceSeed(tSeeds[j]);
+        };
+
+        // The hashes can collide, so the anchor itself needs to be verified.
+        const MinSpaceSeed qAnchor = GetQuerySeed(cand.queryFirst);
+        const MinSpaceSeed tAnchor = GetTargetSeed(cand.targetFirst);
+        if (isCovered == false && qAnchor.key == tAnchor.key && qAnchor.isRev == tAnchor.isRev) {
+            MinSpaceSegment seg;
+            seg.lastQuery = cand.queryFirst;
+            seg.lastTarget = cand.targetFirst;
+            seg.firstQuery = cand.queryFirst;
+            seg.firstTarget = cand.targetFirst;
+            const int32_t numRight = MergeMinimizerStrings(
+                GetQuerySeed, numQuerySeeds, GetTargetSeed, numTargetSeeds, cand.queryFirst,
+                cand.targetFirst, 1, maxSkip, maxDiagonalDiff, seg.lastQuery, seg.lastTarget);
+            const int32_t numLeft = MergeMinimizerStrings(
+                GetQuerySeed, numQuerySeeds, GetTargetSeed, numTargetSeeds, cand.queryFirst,
+                cand.targetFirst, -1, maxSkip, maxDiagonalDiff, seg.firstQuery, seg.firstTarget);
+            seg.numShared = numRight + numLeft - 1;
+            segments.emplace_back(seg);
+
+            if (seg.numShared >= kMinMerSize_) {
+                const MinSpaceSeed qFirst = GetQuerySeed(seg.firstQuery);
+                const MinSpaceSeed qLast = GetQuerySeed(seg.lastQuery);
+                const MinSpaceSeed tFirst = GetTargetSeed(seg.firstTarget);
+                const MinSpaceSeed tLast = GetTargetSeed(seg.lastTarget);
+
+                MinimizerSpaceMatch match;
+                match.targetId = cand.targetId;
+                match.targetRev = cand.targetRev;
+                match.queryStart = qFirst.pos;
+                match.queryEnd = qLast.pos + qLast.span;
+                match.targetStart = tFirst.pos;
+                match.targetEnd = tLast.pos + tLast.span;
+                match.numSharedSeeds = seg.numShared;
+                match.numQuerySeeds = seg.lastQuery - seg.firstQuery + 1;
+                match.numTargetSeeds = seg.lastTarget - seg.firstTarget + 1;
+                match.reachesStart = seg.firstQuery <= maxSkip || seg.firstTarget <= maxSkip;
+                match.reachesEnd = (numQuerySeeds - 1 - seg.lastQuery) <= maxSkip ||
+                                   (numTargetSeeds - 1 - seg.lastTarget) <= maxSkip;
+                matches.emplace_back(match);
+            }
+        }
+
+        // The segments are used only to skip the candidates of the same target and strand.
+        if ((candId + 1) == candidates.size() || candidates[candId + 1].targetId != cand.targetId ||
+            candidates[candId + 1].targetRev != cand.targetRev) {
+            segments.clear();
+        }
+    }
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
@@ -12,6 +12,7 @@
 #include <pacbio/pancake/Minimizers.h>
 #include <pacbio/pancake/Seed.h>
 #include <pacbio/util/CommonTypes.h>
+#include <algorithm>
 #include <deque>
 #include <iostream>
 
@@ -23,6 +24,7 @@ using minkey_t = uint64_t;
 
 const int32_t MAX_SPACING_IN_SEED = 32;
 const int32_t MAX_WINDOW_BUFFER_SIZE = 512;
+const int32_t MAX_SEED_SPAN = 255;
 
 // This is a temporary class, just used for implementing the minimizer window.
 class SpacedBuffer
@@ -82,8 +84,6 @@ int GenerateMinimizers(std::vector<PacBio::Pancake::Int128t>& minimizers, const
                        const int32_t kmerSize, const int32_t winSize, const int32_t spacing,
                        const bool useReverseComplement, const bool useHPC, const int32_t maxHPCLen)
 {
-    const int32_t MAX_SEED_SPAN = 255;
-
     // Sanity check that the seq is not NULL;
     if (!seq) {
         throw std::runtime_error("Cannot generate minimizers. The sequence is NULL.");
@@ -343,6 +343,381 @@ void GenerateMinimizers(std::vector<PacBio::Pancake::Int128t>& retSeeds,
                        useReverseComplement, useHPC, maxHPCLen);
 }
 
+namespace {
+
+// A base of the sequence after the optional homopolymer compression. The position and the
+// length of the homopolymer run are in the coordinates of the original sequence.
+struct CompressedBase
+{
+    uint64_t twobit = 0;
+    int32_t pos = 0;
+    int32_t len = 0;
+};
+
+// A selected syncmer. The id is the index of the first kmer base in the compressed sequence,
+// and is used to measure the distance between the two kmers of a randstrobe.
+struct Syncmer
+{
+    uint64_t key = 0;
+    int32_t id = 0;
+    int32_t pos = 0;
+    int32_t span = 0;
+    bool isRev = false;
+};
+
+void ValidateSyncmerParams(const uint8_t* seq, const int32_t kmerSize, const int32_t syncmerSize,
+                           const bool closedSyncmers, const bool useReverseComplement,
+                           const int32_t maxHPCLen)
+{
+    if (!seq) {
+        throw std::runtime_error("Cannot generate syncmers. The sequence is NULL.");
+    }
+    if (kmerSize <= 0 || kmerSize > 28) {
+        throw std::runtime_error(
+            "Cannot generate syncmers. The kmerSize is out of bounds, should be in range [1, "
+            "28]. kmerSize = " +
+            std::to_string(kmerSize));
+    }
+    if (syncmerSize <= 0 || syncmerSize > kmerSize) {
+        throw std::runtime_error(
+            "Cannot generate syncmers. The syncmerSize is out of bounds, should be in range [1, "
+            "kmerSize]. syncmerSize = " +
+            std::to_string(syncmerSize) + ", kmerSize = " + std::to_string(kmerSize));
+    }
+    // The middle s-mer of a kmer is also the middle s-mer of its reverse complement only
+    // if the number of s-mers in the kmer is odd.
+    if (!closedSyncmers && useReverseComplement && ((kmerSize - syncmerSize) % 2) != 0) {
+        throw std::runtime_error(
+            "Cannot generate open syncmers. The difference between the kmerSize and the "
+            "syncmerSize needs to be even when the reverse complement is used. kmerSize = " +
+            std::to_string(kmerSize) + ", syncmerSize = " + std::to_string(syncmerSize));
+    }
+    if (maxHPCLen >= 256) {
+        throw std::runtime_error(
+            "Cannot generate syncmers. The maxHPCLen is out of bounds, should be in range [0, "
+            "256]. maxHPCLen = " +
+            std::to_string(maxHPCLen));
+    }
+}
+
+void CollectSyncmersFromStretch(std::vector<Syncmer>& syncmers,
+                                const std::vector<CompressedBase>& bases, const int32_t firstId,
+                                const int32_t kmerSize, const int32_t syncmerSize,
+                                const bool closedSyncmers, const bool useReverseComplement)
+{
+    const int32_t numBases = bases.size();
+    if (numBases < kmerSize) {
+        return;
+    }
+
+    const uint64_t kmerMask = ComputeKmerMask(kmerSize);
+    const uint64_t smerMask = ComputeKmerMask(syncmerSize);
+    const int32_t openOffset = (kmerSize - syncmerSize) / 2;
+
+    // Hashes of all s-mers in this stretch.
+    std::vector<uint64_t> smerHashes(numBases - syncmerSize + 1);
+    uint64_t smerFwd = 0;
+    uint64_t smerRev = 0;
+    for (int32_t i = 0; i < numBases; ++i) {
+        const uint64_t b = bases[i].twobit;
+        smerFwd = ((smerFwd << 2) | b) & smerMask;
+        smerRev = (smerRev >> 2) | ((3 - b) << (syncmerSize * 2 - 2));
+        if ((i + 1) >= syncmerSize) {
+            const uint64_t smer =
+                (useReverseComplement && smerRev < smerFwd) ? smerRev : smerFwd;
+            smerHashes[i + 1 - syncmerSize] = InvertibleHash(smer, smerMask);
+        }
+    }
+
+    // Slide the kmer over the stretch, and keep the s-mers of the current kmer in a queue
+    // sorted by the hash, so that the minimum is always at the front.
+    std::deque<int32_t> minQueue;
+    uint64_t kmerFwd = 0;
+    uint64_t kmerRev = 0;
+    for (int32_t i = 0; i < numBases; ++i) {
+        const uint64_t b = bases[i].twobit;
+        kmerFwd = ((kmerFwd << 2) | b) & kmerMask;
+        kmerRev = (kmerRev >> 2) | ((3 - b) << (kmerSize * 2 - 2));
+
+        if ((i + 1) >= syncmerSize) {
+            const int32_t smerId = i + 1 - syncmerSize;
+            while (!minQueue.empty() && smerHashes[minQueue.back()] > smerHashes[smerId]) {
+                minQueue.pop_back();
+            }
+            minQueue.emplace_back(smerId);
+        }
+        if ((i + 1) < kmerSize) {
+            continue;
+        }
+
+        const int32_t kmerStart = i + 1 - kmerSize;
+        while (minQueue.front() < kmerStart) {
+            minQueue.pop_front();
+        }
+        const uint64_t minHash = smerHashes[minQueue.front()];
+        const bool isSyncmer =
+            closedSyncmers ? (smerHashes[kmerStart] == minHash ||
+                              smerHashes[kmerStart + kmerSize - syncmerSize] == minHash)
+                           : (smerHashes[kmerStart + openOffset] == minHash);
+
+        // Skip symmetric kmers, same as for minimizers.
+        if (!isSyncmer || kmerFwd == kmerRev) {
+            continue;
+        }
+
+        const int32_t span = bases[i].pos + bases[i].len - bases[kmerStart].pos;
+        if (span > MAX_SEED_SPAN) {
+            continue;
+        }
+
+        Syncmer syncmer;
+        syncmer.key = kmerFwd;
+        if (useReverseComplement && kmerRev < kmerFwd) {
+            syncmer.key = kmerRev;
+            syncmer.isRev = true;
+        }
+        syncmer.key = InvertibleHash(syncmer.key, kmerMask);
+        syncmer.id = firstId + kmerStart;
+        syncmer.pos = bases[kmerStart].pos;
+        syncmer.span = span;
+        syncmers.emplace_back(syncmer);
+    }
+}
+
+std::vector<Syncmer> CollectSyncmers(const uint8_t* seq, const int32_t seqLen,
+                                     const int32_t kmerSize, const int32_t syncmerSize,
+                                     const bool closedSyncmers, const bool useReverseComplement,
+                                     const bool useHPC, const int32_t maxHPCLen)
+{
+    std::vector<Syncmer> syncmers;
+    std::vector<CompressedBase> bases;
+    int32_t numIds = 0;
+
+    // Non-nucleotide bases split the sequence into stretches, and each is processed separately.
+    // A non-nucleotide base still takes up one id, so that the distances are symmetric
+    // for both strands.
+    for (int32_t pos = 0; pos < seqLen;) {
+        const uint8_t b = seq[pos];
+        if (!IsNucleotide[b]) {
+            CollectSyncmersFromStretch(syncmers, bases, numIds, kmerSize, syncmerSize,
+                                       closedSyncmers, useReverseComplement);
+            numIds += static_cast<int32_t>(bases.size()) + 1;
+            bases.clear();
+            ++pos;
+            continue;
+        }
+        int32_t hpLen = 1;
+        if (useHPC) {
+            while ((pos + hpLen) < seqLen && seq[pos + hpLen] == b) {
+                ++hpLen;
+            }
+        }
+        if (!useHPC || hpLen < maxHPCLen) {
+            CompressedBase base;
+            base.twobit = BaseToTwobit[b];
+            base.pos = pos;
+            base.len = hpLen;
+            bases.emplace_back(base);
+        }
+        pos += hpLen;
+    }
+    CollectSyncmersFromStretch(syncmers, bases, numIds, kmerSize, syncmerSize, closedSyncmers,
+                               useReverseComplement);
+
+    return syncmers;
+}
+
+}  // namespace
+
+int GenerateSyncmers(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                     const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                     const int32_t kmerSize, const int32_t syncmerSize, const bool closedSyncmers,
+                     const bool useReverseComplement, const bool useHPC, const int32_t maxHPCLen)
+{
+    ValidateSyncmerParams(seq, kmerSize, syncmerSize, closedSyncmers, useReverseComplement,
+                          maxHPCLen);
+
+    const std::vector<Syncmer> syncmers =
+        CollectSyncmers(seq, seqLen, kmerSize, syncmerSize, closedSyncmers, useReverseComplement,
+                        useHPC, maxHPCLen);
+
+    for (const auto& syncmer : syncmers) {
+        seeds.emplace_back(Seed::Encode(syncmer.key, syncmer.span, seqId,
+                                        syncmer.pos + seqOffset, syncmer.isRev));
+    }
+
+    return 0;
+}
+
+int GenerateRandstrobes(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                        const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                        const int32_t kmerSize, const int32_t syncmerSize,
+                        const int32_t strobeMinDist, const int32_t strobeMaxDist,
+                        const bool useReverseComplement, const bool useHPC,
+                        const int32_t maxHPCLen)
+{
+    ValidateSyncmerParams(seq, kmerSize, syncmerSize, false, useReverseComplement, maxHPCLen);
+    if (strobeMinDist <= 0 || strobeMaxDist < strobeMinDist ||
+        (strobeMaxDist + kmerSize) > MAX_SEED_SPAN) {
+        throw std::runtime_error(
+            "Cannot generate randstrobes. The strobe distances are out of bounds, should be "
+            "0 < strobeMinDist <= strobeMaxDist and strobeMaxDist + kmerSize <= " +
+            std::to_string(MAX_SEED_SPAN) + ". strobeMinDist = " + std::to_string(strobeMinDist) +
+            ", strobeMaxDist = " + std::to_string(strobeMaxDist) +
+            ", kmerSize = " + std::to_string(kmerSize));
+    }
+
+    const std::vector<Syncmer> syncmers = CollectSyncmers(
+        seq, seqLen, kmerSize, syncmerSize, false, useReverseComplement, useHPC, maxHPCLen);
+
+    // The combined key of the two strobes has to fit the 56 bits of the seed key.
+    const uint64_t strobeMask = ComputeKmerMask(28);
+    const int32_t numSyncmers = syncmers.size();
+    const size_t firstSeed = seeds.size();
+
+    for (int32_t i = 0; i < numSyncmers; ++i) {
+        const auto& first = syncmers[i];
+
+        // The second strobe is searched downstream of a kmer in the fwd orientation, and upstream
+        // of a kmer in the rev orientation. This way the same pair of kmers is linked on both
+        // strands of the sequence.
+        const int32_t step = (first.isRev) ? -1 : 1;
+        int32_t bestId = -1;
+        uint64_t bestScore = 0;
+        for (int32_t j = i + step; j >= 0 && j < numSyncmers; j += step) {
+            const int32_t dist = std::abs(syncmers[j].id - first.id);
+            if (dist > strobeMaxDist) {
+                break;
+            }
+            if (dist < strobeMinDist) {
+                continue;
+            }
+            // The strict comparison picks the closest kmer in case of a tie, on both strands.
+            const uint64_t score = first.key ^ syncmers[j].key;
+            if (bestId < 0 || score < bestScore) {
+                bestId = j;
+                bestScore = score;
+            }
+        }
+        if (bestId < 0) {
+            continue;
+        }
+
+        const auto& second = syncmers[bestId];
+        const int32_t start = std::min(first.pos, second.pos);
+        const int32_t end = std::max(first.pos + first.span, second.pos + second.span);
+        if ((end - start) > MAX_SEED_SPAN) {
+            continue;
+        }
+        const uint64_t key = InvertibleHash(((first.key << 1) ^ second.key) & strobeMask,
+                                            strobeMask);
+        seeds.emplace_back(Seed::Encode(key, end - start, seqId, start + seqOffset, first.isRev));
+    }
+
+    // Upstream strobes make the seeds out of order.
+    std::stable_sort(seeds.begin() + firstSeed, seeds.end(),
+                     [](const PacBio::Pancake::Int128t& a, const PacBio::Pancake::Int128t& b) {
+                         return Seed::DecodePos(a) < Seed::DecodePos(b);
+                     });
+
+    return 0;
+}
+
+int GenerateSeeds(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                  const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                  const SeedDBParameters& params)
+{
+    if (params.Scheme == SeedingScheme::Minimizer) {
+        return GenerateMinimizers(seeds, seq, seqLen, seqOffset, seqId, params.KmerSize,
+                                  params.MinimizerWindow, params.Spacing, params.UseRC,
+                                  params.UseHPCForSeedsOnly, params.MaxHPCLen);
+    }
+    if (params.Spacing != 0) {
+        throw std::runtime_error(
+            "Spaced seeds are supported only with minimizers. Seeding scheme: " +
+            SeedingSchemeToString(params.Scheme));
+    }
+    if (params.Scheme == SeedingScheme::OpenSyncmer ||
+        params.Scheme == SeedingScheme::ClosedSyncmer) {
+        return GenerateSyncmers(seeds, seq, seqLen, seqOffset, seqId, params.KmerSize,
+                                params.SyncmerSize, params.Scheme == SeedingScheme::ClosedSyncmer,
+                                params.UseRC, params.UseHPCForSeedsOnly, params.MaxHPCLen);
+    }
+    if (params.Scheme == SeedingScheme::Randstrobe) {
+        return GenerateRandstrobes(seeds, seq, seqLen, seqOffset, seqId, params.KmerSize,
+                                   params.SyncmerSize, params.StrobeMinDist, params.StrobeMaxDist,
+                                   params.UseRC, params.UseHPCForSeedsOnly, params.MaxHPCLen);
+    }
+    throw std::runtime_error("Unsupported seeding scheme: " +
+                             SeedingSchemeToString(params.Scheme));
+}
+
+int GenerateSeedsCircular(std::vector<PacBio::Pancake::Int128t>& seeds, const uint8_t* seq,
+                          const int32_t seqLen, const int32_t seqOffset, const int32_t seqId,
+                          const SeedDBParameters& params)
+{
+    if (!seq) {
+        throw std::runtime_error("Cannot generate seeds. The sequence is NULL.");
+    }
+    if (seqLen == 0) {
+        return 0;
+    }
+
+    // The flanks need to cover the span of any seed together with the context which selects it.
+    // With HPC, a compressed base can span up to MaxHPCLen bases of the sequence.
+    const int32_t context =
+        params.KmerSize * (params.Spacing + 1) + params.MinimizerWindow + params.StrobeMaxDist;
+    const int32_t flankLen =
+        std::min(seqLen, context * (params.UseHPCForSeedsOnly ? std::max(1, params.MaxHPCLen) : 1));
+
+    // Virtual rotation: suffix + sequence + prefix.
+    std::vector<uint8_t> rotated;
+    rotated.reserve(seqLen + 2 * flankLen);
+    rotated.insert(rotated.end(), seq + seqLen - flankLen, seq + seqLen);
+    rotated.insert(rotated.end(), seq, seq + seqLen);
+    rotated.insert(rotated.end(), seq, seq + flankLen);
+
+    std::vector<PacBio::Pancake::Int128t> rotatedSeeds;
+    const int rv =
+        GenerateSeeds(rotatedSeeds, rotated.data(), rotated.size(), 0, seqId, params);
+    if (rv) {
+        return rv;
+    }
+
+    // Keep the seeds which begin within the sequence, and shift them to its coordinates.
+    for (const auto& seed : rotatedSeeds) {
+        const int32_t pos = Seed::DecodePos(seed) - flankLen;
+        if (pos < 0 || pos >= seqLen) {
+            continue;
+        }
+        seeds.emplace_back(Seed::Encode(Seed::DecodeKey(seed), Seed::DecodeSpan(seed),
+                                        Seed::DecodeSeqId(seed), pos + seqOffset,
+                                        Seed::DecodeIsRev(seed)));
+    }
+
+    return 0;
+}
+
+void GenerateSeeds(std::vector<PacBio::Pancake::Int128t>& retSeeds,
+                   std::vector<int32_t>& retSequenceLengths,
+                   const std::vector<FastaSequenceCached>& targetSeqs,
+                   const SeedDBParameters& params)
+{
+    retSeeds.clear();
+    retSequenceLengths.clear();
+    retSequenceLengths.reserve(targetSeqs.size());
+    for (int32_t recordId = 0; recordId < static_cast<int32_t>(targetSeqs.size()); ++recordId) {
+        const auto& record = targetSeqs[recordId];
+        const uint8_t* seq = reinterpret_cast<const uint8_t*>(record.data());
+        const int32_t seqLen = record.size();
+        retSequenceLengths.emplace_back(seqLen);
+        int rv = GenerateSeeds(retSeeds, seq, seqLen, 0, record.Id(), params);
+        if (rv)
+            throw std::runtime_error("Generating seeds failed for the target sequence, id = " +
+                                     std::to_string(recordId));
+    }
+}
+
 }  // namespace SeedDB
 }  // namespace Pancake
 }  // namespace PacBio
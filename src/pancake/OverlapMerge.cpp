@@ -0,0 +1,210 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/OverlapMerge.h>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace PacBio {
+namespace Pancake {
+
+namespace {
+
+// Returns the start and the length of the column which begins at or after pos,
+// or a length of 0 if there are no more columns.
+std::pair<int32_t, int32_t> FindColumn(const std::string& line, int32_t pos)
+{
+    const int32_t len = line.size();
+    while (pos < len && (line[pos] == ' ' || line[pos] == '\t')) {
+        ++pos;
+    }
+    int32_t end = pos;
+    while (end < len && line[end] != ' ' && line[end] != '\t') {
+        ++end;
+    }
+    return std::make_pair(pos, end - pos);
+}
+
+float ParseFloatColumn(const std::string& line, const std::pair<int32_t, int32_t>& col)
+{
+    const std::string str = line.substr(col.first, col.second);
+    char* end = nullptr;
+    const float val = std::strtof(str.c_str(), &end);
+    if (str.empty() || end != (str.c_str() + str.size())) {
+        throw std::runtime_error("Malformed overlap line, not a number: '" + str + "' in line: '" +
+                                 line + "'.");
+    }
+    return val;
+}
+
+// The columns of the two read names of the line, in the order of the unordered pair.
+std::pair<std::pair<int32_t, int32_t>, std::pair<int32_t, int32_t>> PairColumns(
+    const OverlapLine& a)
+{
+    const auto colA = std::make_pair(0, a.aNameLen);
+    const auto colB = std::make_pair(a.bNameStart, a.bNameLen);
+    const bool aFirst = a.line.compare(0, a.aNameLen, a.line, a.bNameStart, a.bNameLen) <= 0;
+    return aFirst ? std::make_pair(colA, colB) : std::make_pair(colB, colA);
+}
+
+int32_t CompareColumns(const OverlapLine& a, const std::pair<int32_t, int32_t>& colA,
+                       const OverlapLine& b, const std::pair<int32_t, int32_t>& colB)
+{
+    return a.line.compare(colA.first, colA.second, b.line, colB.first, colB.second);
+}
+
+}  // namespace
+
+OverlapLine ParseOverlapLine(std::string line)
+{
+    const auto colA = FindColumn(line, 0);
+    const auto colB = FindColumn(line, colA.first + colA.second);
+    const auto colScore = FindColumn(line, colB.first + colB.second);
+    const auto colIdentity = FindColumn(line, colScore.first + colScore.second);
+    if (colA.second == 0 || colB.second == 0 || colScore.second == 0 ||
+        colIdentity.second == 0) {
+        throw std::runtime_error("Malformed overlap line, expected at least 4 columns: '" + line +
+                                 "'.");
+    }
+
+    OverlapLine ret;
+    ret.score = ParseFloatColumn(line, colScore);
+    ret.identity = ParseFloatColumn(line, colIdentity);
+
+    // Leading whitespace is dropped, so that the A-read name begins at the start of the line.
+    if (colA.first > 0) {
+        line.erase(0, colA.first);
+    }
+    ret.aNameLen = colA.second;
+    ret.bNameStart = colB.first - colA.first;
+    ret.bNameLen = colB.second;
+    ret.line = std::move(line);
+    return ret;
+}
+
+int32_t CompareAName(const OverlapLine& a, const OverlapLine& b)
+{
+    return a.line.compare(0, a.aNameLen, b.line, 0, b.aNameLen);
+}
+
+int32_t ComparePair(const OverlapLine& a, const OverlapLine& b)
+{
+    const auto colsA = PairColumns(a);
+    const auto colsB = PairColumns(b);
+    const int32_t cmp = CompareColumns(a, colsA.first, b, colsB.first);
+    if (cmp != 0) {
+        return cmp;
+    }
+    return CompareColumns(a, colsA.second, b, colsB.second);
+}
+
+bool OverlapLineLess(const OverlapLine& a, const OverlapLine& b, OverlapSortOrder order)
+{
+    const int32_t cmpGroup = (order == OverlapSortOrder::ByRead) ? CompareAName(a, b)
+                                                                 : ComparePair(a, b);
+    if (cmpGroup != 0) {
+        return cmpGroup < 0;
+    }
+    // Score is negative, as per legacy Falcon convention.
+    if (a.score != b.score) {
+        return a.score < b.score;
+    }
+    if (a.identity != b.identity) {
+        return a.identity > b.identity;
+    }
+    const int32_t cmpA = CompareAName(a, b);
+    if (cmpA != 0) {
+        return cmpA < 0;
+    }
+    const int32_t cmpB = a.line.compare(a.bNameStart, a.bNameLen, b.line, b.bNameStart, b.bNameLen);
+    if (cmpB != 0) {
+        return cmpB < 0;
+    }
+    return a.line < b.line;
+}
+
+void SortOverlapLines(std::vector<OverlapLine>& lines, OverlapSortOrder order)
+{
+    std::sort(lines.begin(), lines.end(), [order](const OverlapLine& a, const OverlapLine& b) {
+        return OverlapLineLess(a, b, order);
+    });
+}
+
+void WriteOverlapLines(const std::vector<OverlapLine>& lines, const std::string& outPath)
+{
+    std::ofstream ofs(outPath);
+    if (ofs.is_open() == false) {
+        throw std::runtime_error("Could not open file '" + outPath + "' for writing!");
+    }
+    for (const auto& line : lines) {
+        ofs << line.line << '\n';
+    }
+    ofs.close();
+    if (ofs.fail()) {
+        throw std::runtime_error("Could not write the overlaps to file '" + outPath + "'!");
+    }
+}
+
+OverlapRunMerger::OverlapRunMerger(const std::vector<std::string>& runPaths,
+                                   OverlapSortOrder order)
+    : order_(order)
+{
+    runs_.reserve(runPaths.size());
+    heads_.resize(runPaths.size());
+    for (const auto& runPath : runPaths) {
+        auto ifs = std::make_unique<std::ifstream>(runPath);
+        if (ifs->is_open() == false) {
+            throw std::runtime_error("Could not open the sorted run file '" + runPath + "'!");
+        }
+        runs_.emplace_back(std::move(ifs));
+    }
+    for (int32_t i = 0; i < static_cast<int32_t>(runs_.size()); ++i) {
+        if (ReadHead_(i)) {
+            heap_.emplace_back(i);
+        }
+    }
+    std::make_heap(heap_.begin(), heap_.end(),
+                   [this](int32_t a, int32_t b) { return HeapCompare_(a, b); });
+}
+
+OverlapRunMerger::~OverlapRunMerger() = default;
+
+bool OverlapRunMerger::GetNext(OverlapLine& ret)
+{
+    if (heap_.empty()) {
+        return false;
+    }
+    const auto comp = [this](int32_t a, int32_t b) { return HeapCompare_(a, b); };
+    std::pop_heap(heap_.begin(), heap_.end(), comp);
+    const int32_t runId = heap_.back();
+    ret = std::move(heads_[runId]);
+    if (ReadHead_(runId)) {
+        std::push_heap(heap_.begin(), heap_.end(), comp);
+    } else {
+        heap_.pop_back();
+    }
+    return true;
+}
+
+bool OverlapRunMerger::ReadHead_(int32_t runId)
+{
+    std::string line;
+    while (std::getline(*runs_[runId], line)) {
+        if (line.empty()) {
+            continue;
+        }
+        heads_[runId] = ParseOverlapLine(std::move(line));
+        return true;
+    }
+    return false;
+}
+
+bool OverlapRunMerger::HeapCompare_(int32_t a, int32_t b) const
+{
+    // The std heap functions build a max-heap, so the comparison is reversed.
+    return OverlapLineLess(heads_[b], heads_[a], order_);
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
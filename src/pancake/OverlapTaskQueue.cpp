@@ -0,0 +1,427 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/OverlapTaskQueue.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace PacBio {
+namespace Pancake {
+
+namespace {
+
+bool FileExists(const std::string& path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+double SecondsSinceModified(const std::string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        throw std::runtime_error("Could not stat the file '" + path +
+                                 "': " + std::strerror(errno));
+    }
+    return std::difftime(std::time(nullptr), st.st_mtime);
+}
+
+void CreateDir(const std::string& path)
+{
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Could not create the folder '" + path +
+                                 "': " + std::strerror(errno));
+    }
+}
+
+// Creates the file only if it does not exist yet. This is atomic also on NFSv3 and later.
+// Returns false if the file already exists. A file which could not be written is removed,
+// so that it does not hold the name.
+bool CreateFileExclusive(const std::string& path, const std::string& contents)
+{
+    const int fd = open(path.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            return false;
+        }
+        throw std::runtime_error("Could not create the file '" + path +
+                                 "': " + std::strerror(errno));
+    }
+    const ssize_t numWritten = write(fd, contents.c_str(), contents.size());
+    const int rvClose = close(fd);
+    if (numWritten != static_cast<ssize_t>(contents.size()) || rvClose != 0) {
+        unlink(path.c_str());
+        throw std::runtime_error("Could not write to the file '" + path + "'.");
+    }
+    return true;
+}
+
+// Identifies the worker in the lock files, for debugging.
+std::string WorkerName()
+{
+    char hostname[256] = {0};
+    if (gethostname(hostname, sizeof(hostname) - 1) != 0) {
+        snprintf(hostname, sizeof(hostname), "unknown");
+    }
+    return std::string(hostname) + "\t" + std::to_string(getpid()) + "\n";
+}
+
+std::string TaskName(int32_t taskId)
+{
+    char buff[32];
+    snprintf(buff, sizeof(buff), "task-%06d", taskId);
+    return buff;
+}
+
+}  // namespace
+
+std::vector<OverlapTask> PlanOverlapTasks(const SeqDBIndexCache& targetCache,
+                                          const SeqDBIndexCache& queryCache,
+                                          int32_t queryBlocksPerTask, bool skipSymmetric)
+{
+    if (queryBlocksPerTask <= 0) {
+        throw std::runtime_error("The number of query blocks per task should be > 0.");
+    }
+
+    const int32_t numTargetBlocks = targetCache.blockLines.size();
+    const int32_t numQueryBlocks = queryCache.blockLines.size();
+
+    std::vector<std::vector<OverlapTask>> groups;
+    std::vector<double> groupCosts;
+    for (int32_t targetBlockId = 0; targetBlockId < numTargetBlocks; ++targetBlockId) {
+        const auto& targetBlock = targetCache.GetBlockLine(targetBlockId);
+        const double targetBases = targetBlock.numBases;
+        std::vector<OverlapTask> group;
+        double groupCost = 0.0;
+        for (int32_t blockId = 0; blockId < numQueryBlocks; ++blockId) {
+            const auto& queryBlock = queryCache.GetBlockLine(blockId);
+            // The mapper keeps only the overlaps with a target ID lower than the query ID.
+            if (skipSymmetric && (queryBlock.endSeqId - 1) <= targetBlock.startSeqId) {
+                continue;
+            }
+            // Only about half of the pairs are mapped when the ID ranges of the blocks overlap.
+            const bool isDiagonal = skipSymmetric && queryBlock.startSeqId < targetBlock.endSeqId;
+            const double cost = (isDiagonal ? 0.5 : 1.0) * targetBases * queryBlock.numBases;
+            // Append to the previous task if the blocks are consecutive and it is not full.
+            if (group.empty() || group.back().queryBlockEndId != blockId ||
+                (group.back().queryBlockEndId - group.back().queryBlockStartId) >=
+                    queryBlocksPerTask) {
+                OverlapTask task;
+                task.targetBlockId = targetBlockId;
+                task.queryBlockStartId = blockId;
+                task.queryBlockEndId = blockId;
+                group.emplace_back(task);
+            }
+            group.back().queryBlockEndId = blockId + 1;
+            group.back().cost += cost;
+            groupCost += cost;
+        }
+        if (group.empty()) {
+            continue;
+        }
+        std::stable_sort(group.begin(), group.end(), [](const auto& a, const auto& b) {
+            return a.cost > b.cost;
+        });
+        groups.emplace_back(std::move(group));
+        groupCosts.emplace_back(groupCost);
+    }
+
+    std::vector<int32_t> order(groups.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int32_t a, int32_t b) { return groupCosts[a] > groupCosts[b]; });
+
+    std::vector<OverlapTask> tasks;
+    for (const int32_t groupId : order) {
+        for (auto& task : groups[groupId]) {
+            task.taskId = tasks.size();
+            tasks.emplace_back(task);
+        }
+    }
+    return tasks;
+}
+
+void WriteOverlapTaskPlan(std::ostream& os, const std::vector<OverlapTask>& tasks)
+{
+    os << "#task_id\ttarget_block\tquery_block_start\tquery_block_end\tcost\n";
+    for (const auto& task : tasks) {
+        os << task.taskId << "\t" << task.targetBlockId << "\t" << task.queryBlockStartId << "\t"
+           << task.queryBlockEndId << "\t" << task.cost << "\n";
+    }
+}
+
+std::vector<OverlapTask> ParseOverlapTaskPlan(std::istream& is)
+{
+    std::vector<OverlapTask> tasks;
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        OverlapTask task;
+        std::string extra;
+        if (!(iss >> task.taskId >> task.targetBlockId >> task.queryBlockStartId >>
+              task.queryBlockEndId >> task.cost) ||
+            (iss >> extra)) {
+            throw std::runtime_error("Malformed line in the task plan: '" + line + "'.");
+        }
+        if (task.taskId != static_cast<int32_t>(tasks.size())) {
+            throw std::runtime_error("The task IDs in the task plan are not consecutive: '" +
+                                     line + "'.");
+        }
+        tasks.emplace_back(task);
+    }
+    return tasks;
+}
+
+OverlapTaskQueue::OverlapTaskQueue(const std::string& workDir,
+                                   const std::vector<OverlapTask>& plan, int32_t leaseSeconds)
+    : workDir_{workDir}, plan_{plan}, leaseSeconds_{leaseSeconds}
+{
+    if (leaseSeconds_ <= 0) {
+        throw std::runtime_error("The task lease should be > 0 seconds.");
+    }
+    CreateDir(workDir_);
+    CreateDir(workDir_ + "/tasks");
+    CreateDir(workDir_ + "/out");
+    LoadOrWritePlan_();
+    heartbeatThread_ = std::thread(&OverlapTaskQueue::HeartbeatWorker_, this);
+}
+
+OverlapTaskQueue::~OverlapTaskQueue()
+{
+    Release();
+    {
+        std::lock_guard<std::mutex> lock(heartbeatMutex_);
+        heartbeatStop_ = true;
+    }
+    heartbeatCv_.notify_all();
+    heartbeatThread_.join();
+}
+
+void OverlapTaskQueue::LoadOrWritePlan_()
+{
+    const std::string planPath = workDir_ + "/plan.tsv";
+
+    // The worker which creates the lock writes the plan, and renames it into place when done.
+    if (CreateFileExclusive(workDir_ + "/plan.lock", WorkerName())) {
+        const std::string tmpPath = planPath + ".tmp";
+        {
+            std::ofstream ofs(tmpPath);
+            WriteOverlapTaskPlan(ofs, plan_);
+            if (ofs.good() == false) {
+                throw std::runtime_error("Could not write the task plan to '" + tmpPath + "'.");
+            }
+        }
+        if (std::rename(tmpPath.c_str(), planPath.c_str()) != 0) {
+            throw std::runtime_error("Could not rename the task plan to '" + planPath +
+                                     "': " + std::strerror(errno));
+        }
+        return;
+    }
+
+    // Wait for the other worker to write the plan.
+    const auto waitStart = std::chrono::steady_clock::now();
+    while (FileExists(planPath) == false) {
+        const auto waited = std::chrono::steady_clock::now() - waitStart;
+        if (waited > std::chrono::seconds(leaseSeconds_)) {
+            throw std::runtime_error("The task plan '" + planPath +
+                                     "' was not written in time. If the worker which planned "
+                                     "the tasks failed, remove the '" +
+                                     workDir_ + "/plan.lock' file and restart.");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    std::ifstream ifs(planPath);
+    if (ifs.is_open() == false) {
+        throw std::runtime_error("Could not open the task plan '" + planPath + "'.");
+    }
+    std::vector<OverlapTask> existingPlan = ParseOverlapTaskPlan(ifs);
+    if (existingPlan != plan_) {
+        throw std::runtime_error("The task plan '" + planPath +
+                                 "' differs from the tasks of this worker. All workers of a "
+                                 "work folder should use the same DBs and work options.");
+    }
+    plan_ = std::move(existingPlan);
+}
+
+std::string OverlapTaskQueue::TaskLockPath(int32_t taskId, int32_t attempt) const
+{
+    return workDir_ + "/tasks/" + TaskName(taskId) + ".lock." + std::to_string(attempt);
+}
+
+std::string OverlapTaskQueue::TaskDonePath(int32_t taskId) const
+{
+    return workDir_ + "/tasks/" + TaskName(taskId) + ".done";
+}
+
+std::string OverlapTaskQueue::TaskOutputPath(int32_t taskId) const
+{
+    return workDir_ + "/out/" + TaskName(taskId) + ".out";
+}
+
+std::string OverlapTaskQueue::OutputPath() const
+{
+    if (HasTask() == false) {
+        throw std::runtime_error("No task is claimed.");
+    }
+    return TaskOutputPath(currentTaskId_) + ".tmp." + std::to_string(currentAttempt_);
+}
+
+bool OverlapTaskQueue::Claim(int32_t targetBlockId, OverlapTask& task)
+{
+    if (HasTask()) {
+        throw std::runtime_error("Cannot claim a task before the current one is finished.");
+    }
+
+    if (targetBlockId >= 0) {
+        for (const auto& planTask : plan_) {
+            if (planTask.targetBlockId == targetBlockId && TryClaim_(planTask)) {
+                task = planTask;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // First look only at the target blocks which no worker has started yet, so that each
+    // worker indexes a different target block. Then help with the remaining tasks.
+    for (const bool onlyUntouched : {true, false}) {
+        for (size_t start = 0, end = 0; start < plan_.size(); start = end) {
+            bool isUntouched = true;
+            for (end = start;
+                 end < plan_.size() && plan_[end].targetBlockId == plan_[start].targetBlockId;
+                 ++end) {
+                isUntouched = isUntouched && !FileExists(TaskLockPath(plan_[end].taskId, 0));
+            }
+            if (onlyUntouched && isUntouched == false) {
+                continue;
+            }
+            for (size_t i = start; i < end; ++i) {
+                if (TryClaim_(plan_[i])) {
+                    task = plan_[i];
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool OverlapTaskQueue::TryClaim_(const OverlapTask& task)
+{
+    if (FileExists(TaskDonePath(task.taskId))) {
+        return false;
+    }
+    int32_t attempt = 0;
+    while (FileExists(TaskLockPath(task.taskId, attempt))) {
+        ++attempt;
+    }
+    if (attempt > 0 &&
+        SecondsSinceModified(TaskLockPath(task.taskId, attempt - 1)) < leaseSeconds_) {
+        return false;
+    }
+    const std::string lockPath = TaskLockPath(task.taskId, attempt);
+    if (CreateFileExclusive(lockPath, WorkerName()) == false) {
+        return false;
+    }
+    // The previous owner could have completed the task in the meantime.
+    if (FileExists(TaskDonePath(task.taskId))) {
+        return false;
+    }
+    currentTaskId_ = task.taskId;
+    currentAttempt_ = attempt;
+    SetHeartbeatPath_(lockPath);
+    return true;
+}
+
+bool OverlapTaskQueue::Complete()
+{
+    if (HasTask() == false) {
+        throw std::runtime_error("No task is claimed.");
+    }
+    SetHeartbeatPath_("");
+    const std::string tmpPath = OutputPath();
+    const int32_t taskId = currentTaskId_;
+    // Taking the next attempt's lock commits the output atomically. It fails only if another
+    // worker has reclaimed the task, and it keeps the task from being reclaimed afterwards.
+    const bool isOwner =
+        CreateFileExclusive(TaskLockPath(currentTaskId_, currentAttempt_ + 1), WorkerName());
+    currentTaskId_ = -1;
+    currentAttempt_ = -1;
+
+    if (isOwner == false) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    const std::string outPath = TaskOutputPath(taskId);
+    if (std::rename(tmpPath.c_str(), outPath.c_str()) != 0) {
+        throw std::runtime_error("Could not rename the task output to '" + outPath +
+                                 "': " + std::strerror(errno));
+    }
+    // A reclaiming worker which raced with this one can have created the marker already.
+    CreateFileExclusive(TaskDonePath(taskId), WorkerName());
+    return true;
+}
+
+void OverlapTaskQueue::Release()
+{
+    if (HasTask() == false) {
+        return;
+    }
+    SetHeartbeatPath_("");
+    std::remove(OutputPath().c_str());
+    // Expire the lease right away.
+    struct utimbuf times;
+    times.actime = 0;
+    times.modtime = 0;
+    utime(TaskLockPath(currentTaskId_, currentAttempt_).c_str(), &times);
+    currentTaskId_ = -1;
+    currentAttempt_ = -1;
+}
+
+int32_t OverlapTaskQueue::NumDone() const
+{
+    int32_t numDone = 0;
+    for (const auto& task : plan_) {
+        numDone += FileExists(TaskDonePath(task.taskId));
+    }
+    return numDone;
+}
+
+void OverlapTaskQueue::SetHeartbeatPath_(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(heartbeatMutex_);
+    heartbeatPath_ = path;
+}
+
+void OverlapTaskQueue::HeartbeatWorker_()
+{
+    const auto interval = std::chrono::milliseconds(leaseSeconds_ * 250);
+    std::unique_lock<std::mutex> lock(heartbeatMutex_);
+    while (heartbeatStop_ == false) {
+        if (heartbeatCv_.wait_for(lock, interval, [this]() { return heartbeatStop_; })) {
+            break;
+        }
+        if (heartbeatPath_.empty() == false) {
+            utime(heartbeatPath_.c_str(), nullptr);
+        }
+    }
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
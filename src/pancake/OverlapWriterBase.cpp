@@ -171,6 +171,12 @@ void OverlapWriterBase::PrintOverlapAsPAF(FILE* fpOut, const OverlapPtr& ovl,
             static_cast<int32_t>(ovl->Score));
     fprintf(fpOut, "\tAT:Z:%s\tBT:Z:%s", AtypeStr.c_str(), BtypeStr.c_str());
 
+    // Number of merged large indels, and their bases in the query and in the target.
+    if (ovl->NumLongIndels > 0) {
+        fprintf(fpOut, "\tLI:i:%d\tLQ:i:%d\tLT:i:%d", ovl->NumLongIndels,
+                ovl->LongInsertionBases, ovl->LongDeletionBases);
+    }
+
     if (writeCigar) {
         fprintf(fpOut, "\tcg:Z:");
         if (ovl->Cigar.empty()) {
@@ -210,6 +216,15 @@ void OverlapWriterBase::PrintOverlapAsPAF(FILE* fpOut, const OverlapPtr& ovl,
 void OverlapWriterBase::PrintOverlapAsSAM(FILE* fpOut, const OverlapPtr& ovl, const char* query,
                                           int64_t queryLen, const std::string& Aname,
                                           const std::string& Bname, bool writeIds, bool writeCigar)
+{
+    PrintOverlapAsSAM(fpOut, ovl, query, queryLen, Aname, Bname, writeIds, writeCigar, false,
+                      "");
+}
+
+void OverlapWriterBase::PrintOverlapAsSAM(FILE* fpOut, const OverlapPtr& ovl, const char* query,
+                                          int64_t queryLen, const std::string& Aname,
+                                          const std::string& Bname, bool writeIds, bool writeCigar,
+                                          bool writeMappingFlags, const std::string& extraTags)
 {
     // double identity = static_cast<double>(ovl->Identity);
     // if (identity == 0.0 && ovl->EditDistance >= 0.0) {
@@ -227,6 +242,10 @@ void OverlapWriterBase::PrintOverlapAsSAM(FILE* fpOut, const OverlapPtr& ovl, co
     std::string AtypeStr = OverlapTypeToStringSingleChar(ovl->Atype);
     std::string BtypeStr = OverlapTypeToStringSingleChar(ovl->Btype);
     int32_t flag = tIsRev ? 16 : 0;
+    if (writeMappingFlags) {
+        flag |= ovl->IsSecondary ? 256 : 0;
+        flag |= ovl->IsSupplementary ? 2048 : 0;
+    }
     int32_t mapq = 60;
     std::string seq = (ovl->Brev) ? ReverseComplement(query, queryLen, 0, queryLen)
                                   : std::string(query, queryLen);
@@ -272,6 +291,9 @@ void OverlapWriterBase::PrintOverlapAsSAM(FILE* fpOut, const OverlapPtr& ovl, co
 
     fprintf(fpOut, "\t*\t0\t0\t%s\t%s", seq.c_str(), qual.c_str());
     fprintf(fpOut, "\tAT:Z:%s\tBT:Z:%s", AtypeStr.c_str(), BtypeStr.c_str());
+    if (extraTags.empty() == false) {
+        fprintf(fpOut, "\t%s", extraTags.c_str());
+    }
     fprintf(fpOut, "\n");
 }
 
@@ -97,5 +97,22 @@ void OverlapWriterSAM::Write(const OverlapPtr& ovl,
     }
 }
 
+void OverlapWriterSAM::WriteWithSAMTags(const OverlapPtr& ovl,
+                                        const PacBio::Pancake::SeqDBReaderCachedBlock& targetSeqs,
+                                        const PacBio::Pancake::FastaSequenceCached& querySeq,
+                                        const std::string& samTags)
+{
+    // The split mappings are never flipped, so the query and target names are not swapped.
+    if (ovl->IsFlipped) {
+        Write(ovl, targetSeqs, querySeq);
+        return;
+    }
+    // Don't look for the actual headers unless required. Saves the cost of a search.
+    const auto& qName = writeIds_ ? "" : querySeq.Name();
+    const auto& tName = writeIds_ ? "" : targetSeqs.GetSequence(ovl->Bid).Name();
+    PrintOverlapAsSAM(fpOut_, ovl, querySeq.Bases(), querySeq.Size(), qName, tName, writeIds_,
+                      writeCigar_, true, samTags);
+}
+
 }  // namespace Pancake
 }  // namespace PacBio
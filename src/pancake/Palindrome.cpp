@@ -0,0 +1,101 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/DPChain.h>
+#include <pacbio/pancake/Palindrome.h>
+#include <pacbio/pancake/SeedIndex.h>
+#include <algorithm>
+
+namespace PacBio {
+namespace Pancake {
+
+// Same as the chaining defaults of the MapperCLR.
+static const int32_t PALINDROME_CHAIN_MAX_SKIP = 25;
+static const int32_t PALINDROME_CHAIN_MAX_PREDECESSORS = 500;
+
+PalindromeResult DetectPalindrome(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize,
+                                  int32_t seqLen, int32_t minNumSeeds, int32_t minArmSpan,
+                                  int32_t maxSeedDistance, int32_t chainBandwidth,
+                                  int64_t maxSeedOccurrences)
+{
+    PalindromeResult ret;
+    if (seedsSize < 2) {
+        return ret;
+    }
+
+    // The sequence is its own index. A hit on the reverse strand pairs a seed with its
+    // reverse complement copy, so its target coordinate is in the reverse complement.
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw> sortedSeeds(seeds, seeds + seedsSize);
+    std::sort(sortedSeeds.begin(), sortedSeeds.end());
+    std::vector<SeedHit> allHits;
+    CollectSeedHitsFromSortedSeeds(sortedSeeds.data(), sortedSeeds.size(), sortedSeeds.data(),
+                                   sortedSeeds.size(), seqLen, maxSeedOccurrences, allHits);
+
+    // Each pair of seeds is found twice, once from each side. Keep only the hits where the
+    // query seed comes first in the sequence, so that the chain covers only one arm.
+    std::vector<SeedHit> hits;
+    for (const auto& hit : allHits) {
+        if (hit.targetRev && (hit.queryPos + hit.targetPos + hit.targetSpan) < seqLen) {
+            hits.emplace_back(hit);
+        }
+    }
+    if (hits.empty()) {
+        return ret;
+    }
+    std::sort(hits.begin(), hits.end(), [](const SeedHit& a, const SeedHit& b) {
+        return std::make_pair(a.targetPos, a.queryPos) < std::make_pair(b.targetPos, b.queryPos);
+    });
+
+    const std::vector<ChainedHits> chains =
+        ChainHits(hits.data(), hits.size(), PALINDROME_CHAIN_MAX_SKIP,
+                  PALINDROME_CHAIN_MAX_PREDECESSORS, maxSeedDistance, chainBandwidth, 1, 0, 0);
+
+    // Pick the chain with the longest arm.
+    const ChainedHits* bestChain = nullptr;
+    int32_t bestArmSpan = 0;
+    for (const auto& chain : chains) {
+        if (chain.hits.empty()) {
+            continue;
+        }
+        const int32_t armSpan =
+            chain.hits.back().queryPos + chain.hits.back().querySpan - chain.hits.front().queryPos;
+        if (bestChain == nullptr || armSpan > bestArmSpan) {
+            bestChain = &chain;
+            bestArmSpan = armSpan;
+        }
+    }
+    if (bestChain == nullptr) {
+        return ret;
+    }
+
+    // A seed at position p and its copy at position p' are mirrored around (p + p' + span) / 2.
+    // In the reverse complement, p' + span = seqLen - targetPos.
+    int64_t sumFold = 0;
+    for (const auto& hit : bestChain->hits) {
+        sumFold += hit.queryPos + seqLen - hit.targetPos;
+    }
+    ret.foldPos = sumFold / (2 * static_cast<int64_t>(bestChain->hits.size()));
+    ret.armStart = bestChain->hits.front().queryPos;
+    ret.armEnd = std::min(ret.foldPos,
+                          bestChain->hits.back().queryPos + bestChain->hits.back().querySpan);
+    ret.numSeeds = bestChain->hits.size();
+    ret.isPalindrome = ret.numSeeds >= minNumSeeds && (ret.armEnd - ret.armStart) >= minArmSpan;
+
+    return ret;
+}
+
+void CollectSeedsOnLongerArm(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize,
+                             int32_t seqLen, const PalindromeResult& palindrome,
+                             std::vector<PacBio::Pancake::SeedDB::SeedRaw>& retSeeds)
+{
+    const bool keepFront = palindrome.foldPos >= (seqLen - palindrome.foldPos);
+    for (int64_t i = 0; i < seedsSize; ++i) {
+        const auto decoded = PacBio::Pancake::SeedDB::Seed(seeds[i]);
+        if ((keepFront && (decoded.pos + decoded.span) <= palindrome.foldPos) ||
+            (keepFront == false && decoded.pos >= palindrome.foldPos)) {
+            retSeeds.emplace_back(seeds[i]);
+        }
+    }
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
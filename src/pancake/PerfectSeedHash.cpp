@@ -0,0 +1,267 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/PerfectSeedHash.h>
+#include <pacbio/util/CommonTypes.h>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace PacBio {
+namespace Pancake {
+
+namespace {
+
+// Number of buckets is kBucketsFactor * N / log2(N), as in PTHash.
+const double kBucketsFactor = 6.0;
+// The table has N / kLoadFactor positions, the ones above N are remapped to the free slots.
+const double kLoadFactor = 0.98;
+// 60% of the keys go into 30% of the buckets, so that the large buckets are placed first,
+// while the table is still empty.
+const uint64_t kDenseKeysThreshold = static_cast<uint64_t>(0.6 * 4294967296.0);
+const double kDenseBucketsFraction = 0.3;
+const uint32_t kMaxPilot = 0xFFFF;
+const int32_t kMaxAttempts = 16;
+
+// Slot layout: [63:28] start of the seed range, [27:8] count, [7:0] fingerprint.
+const int32_t kCountShift = 8;
+const int32_t kStartShift = 28;
+const uint64_t kFingerprintMask = 0xFF;
+const uint64_t kCountMask = 0xFFFFF;
+const int64_t kMaxStart = (static_cast<int64_t>(1) << 36) - 1;
+
+inline uint64_t Mix64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// The key is already mixed, so a multiplication is enough to decorrelate the position from
+// the bucket. Only the high bits of these are used.
+inline uint64_t HashPilot(uint32_t pilot) { return (pilot + 1) * 0x9e3779b97f4a7c15ULL; }
+
+inline uint64_t HashPosition(uint64_t hashedKey) { return hashedKey * 0xc2b2ae3d27d4eb4fULL; }
+
+inline int64_t FastRange64(uint64_t x, int64_t range)
+{
+    return static_cast<int64_t>((static_cast<UInt128t>(x) * range) >> 64);
+}
+
+inline bool TestBit(const std::vector<uint64_t>& bits, int64_t pos)
+{
+    return (bits[pos >> 6] >> (pos & 63)) & 1;
+}
+
+inline void SetBit(std::vector<uint64_t>& bits, int64_t pos)
+{
+    bits[pos >> 6] |= static_cast<uint64_t>(1) << (pos & 63);
+}
+
+}  // namespace
+
+PerfectSeedHash::PerfectSeedHash() = default;
+
+PerfectSeedHash::PerfectSeedHash(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize)
+    : seeds_(seeds)
+{
+    if (seedsSize > kMaxStart) {
+        std::ostringstream oss;
+        oss << "(PerfectSeedHash) Too many seeds for the hash. seedsSize = " << seedsSize
+            << ", maximum = " << kMaxStart;
+        throw std::runtime_error(oss.str());
+    }
+
+    // Ranges of seeds with the same key.
+    std::vector<int64_t> starts;
+    for (int64_t i = 0; i < seedsSize; ++i) {
+        if (i == 0 || PacBio::Pancake::SeedDB::Seed::DecodeKey(seeds[i]) !=
+                          PacBio::Pancake::SeedDB::Seed::DecodeKey(seeds[i - 1])) {
+            starts.emplace_back(i);
+        }
+    }
+    numKeys_ = starts.size();
+    if (numKeys_ == 0) {
+        return;
+    }
+    starts.emplace_back(seedsSize);
+
+    tableSize_ = std::max<int64_t>(numKeys_, std::ceil(numKeys_ / kLoadFactor));
+    numBuckets_ = std::max<int64_t>(
+        2, std::ceil(kBucketsFactor * numKeys_ / std::log2(std::max<int64_t>(2, numKeys_))));
+    numDenseBuckets_ = std::max<int64_t>(
+        1, std::min<int64_t>(numBuckets_ - 1, numBuckets_ * kDenseBucketsFraction));
+
+    std::vector<uint64_t> keys(numKeys_);
+    for (int64_t i = 0; i < numKeys_; ++i) {
+        keys[i] = PacBio::Pancake::SeedDB::Seed::DecodeKey(seeds[starts[i]]);
+    }
+
+    for (int32_t attempt = 0; attempt < kMaxAttempts; ++attempt) {
+        seed_ = Mix64(attempt + 1);
+        if (Build_(keys)) {
+            break;
+        }
+        if (attempt + 1 == kMaxAttempts) {
+            throw std::runtime_error(
+                "(PerfectSeedHash) Could not construct the perfect hash function.");
+        }
+    }
+
+    // Fill the slots.
+    slots_.resize(numKeys_, 0);
+    for (int64_t i = 0; i < numKeys_; ++i) {
+        const uint64_t hashedKey = Mix64(keys[i] ^ seed_);
+        const int64_t slot = FindSlot_(hashedKey);
+        const int64_t count = starts[i + 1] - starts[i];
+        const uint64_t packedCount =
+            (count >= static_cast<int64_t>(kCountMask)) ? kCountMask : count;
+        if (packedCount == kCountMask) {
+            largeCounts_[slot] = count;
+        }
+        slots_[slot] = (static_cast<uint64_t>(starts[i]) << kStartShift) |
+                       (packedCount << kCountShift) | (hashedKey & kFingerprintMask);
+    }
+}
+
+bool PerfectSeedHash::Build_(const std::vector<uint64_t>& keys)
+{
+    // Distribute the keys into buckets, by counting sort.
+    std::vector<int64_t> bucketStarts(numBuckets_ + 1, 0);
+    for (const auto& key : keys) {
+        ++bucketStarts[GetBucket_(Mix64(key ^ seed_)) + 1];
+    }
+    int32_t maxBucketSize = 0;
+    for (int64_t i = 0; i < numBuckets_; ++i) {
+        maxBucketSize = std::max<int64_t>(maxBucketSize, bucketStarts[i + 1]);
+        bucketStarts[i + 1] += bucketStarts[i];
+    }
+    std::vector<uint64_t> positionHashes(numKeys_);
+    {
+        std::vector<int64_t> fill(bucketStarts.begin(), bucketStarts.end() - 1);
+        for (const auto& key : keys) {
+            const uint64_t hashedKey = Mix64(key ^ seed_);
+            positionHashes[fill[GetBucket_(hashedKey)]++] = HashPosition(hashedKey);
+        }
+    }
+
+    // Order the buckets from the largest to the smallest, by counting sort.
+    std::vector<int64_t> sizeStarts(maxBucketSize + 2, 0);
+    for (int64_t i = 0; i < numBuckets_; ++i) {
+        ++sizeStarts[maxBucketSize - (bucketStarts[i + 1] - bucketStarts[i]) + 1];
+    }
+    for (int32_t i = 0; i <= maxBucketSize; ++i) {
+        sizeStarts[i + 1] += sizeStarts[i];
+    }
+    std::vector<int64_t> bucketOrder(numBuckets_);
+    for (int64_t i = 0; i < numBuckets_; ++i) {
+        bucketOrder[sizeStarts[maxBucketSize - (bucketStarts[i + 1] - bucketStarts[i])]++] = i;
+    }
+
+    // Search for the pilot of each bucket.
+    pilots_.assign(numBuckets_, 0);
+    std::vector<uint64_t> taken((tableSize_ + 63) / 64, 0);
+    std::vector<int64_t> positions(maxBucketSize);
+    for (const auto& bucket : bucketOrder) {
+        const int64_t start = bucketStarts[bucket];
+        const int64_t size = bucketStarts[bucket + 1] - start;
+        if (size == 0) {
+            break;
+        }
+        uint32_t pilot = 0;
+        for (; pilot < kMaxPilot; ++pilot) {
+            const uint64_t pilotHash = HashPilot(pilot);
+            bool isFree = true;
+            for (int64_t i = 0; i < size && isFree; ++i) {
+                const int64_t pos = FastRange64(positionHashes[start + i] ^ pilotHash, tableSize_);
+                isFree = (TestBit(taken, pos) == false) &&
+                         std::find(positions.begin(), positions.begin() + i, pos) ==
+                             (positions.begin() + i);
+                positions[i] = pos;
+            }
+            if (isFree) {
+                break;
+            }
+        }
+        if (pilot == kMaxPilot) {
+            return false;
+        }
+        pilots_[bucket] = pilot;
+        for (int64_t i = 0; i < size; ++i) {
+            SetBit(taken, positions[i]);
+        }
+    }
+
+    // Remap the taken positions outside of the first numKeys_ slots to the free slots.
+    freeSlots_.assign(tableSize_ - numKeys_, 0);
+    int64_t freeSlot = 0;
+    for (int64_t pos = numKeys_; pos < tableSize_; ++pos) {
+        if (TestBit(taken, pos) == false) {
+            continue;
+        }
+        while (TestBit(taken, freeSlot)) {
+            ++freeSlot;
+        }
+        freeSlots_[pos - numKeys_] = freeSlot;
+        ++freeSlot;
+    }
+
+    return true;
+}
+
+int64_t PerfectSeedHash::GetBucket_(uint64_t hashedKey) const
+{
+    const uint64_t lo = hashedKey & 0xFFFFFFFF;
+    const uint64_t hi = hashedKey >> 32;
+    if (lo < kDenseKeysThreshold) {
+        return (hi * numDenseBuckets_) >> 32;
+    }
+    return numDenseBuckets_ + ((hi * (numBuckets_ - numDenseBuckets_)) >> 32);
+}
+
+int64_t PerfectSeedHash::FindSlot_(uint64_t hashedKey) const
+{
+    const uint16_t pilot = pilots_[GetBucket_(hashedKey)];
+    const int64_t pos = FastRange64(HashPosition(hashedKey) ^ HashPilot(pilot), tableSize_);
+    return (pos < numKeys_) ? pos : freeSlots_[pos - numKeys_];
+}
+
+PerfectSeedHash::value_type PerfectSeedHash::GetSlot_(int64_t slot) const
+{
+    const uint64_t packed = slots_[slot];
+    const int64_t start = packed >> kStartShift;
+    int64_t count = (packed >> kCountShift) & kCountMask;
+    if (count == static_cast<int64_t>(kCountMask)) {
+        count = largeCounts_.at(slot);
+    }
+    return value_type(PacBio::Pancake::SeedDB::Seed::DecodeKey(seeds_[start]),
+                      std::make_pair(start, start + count));
+}
+
+PerfectSeedHash::const_iterator PerfectSeedHash::find(uint64_t key) const
+{
+    if (numKeys_ == 0) {
+        return end();
+    }
+    const uint64_t hashedKey = Mix64(key ^ seed_);
+    const int64_t slot = FindSlot_(hashedKey);
+    const uint64_t packed = slots_[slot];
+    if ((packed & kFingerprintMask) != (hashedKey & kFingerprintMask) ||
+        PacBio::Pancake::SeedDB::Seed::DecodeKey(seeds_[packed >> kStartShift]) != key) {
+        return end();
+    }
+    return const_iterator(this, slot);
+}
+
+int64_t PerfectSeedHash::MemoryUsage() const
+{
+    return pilots_.capacity() * sizeof(uint16_t) + freeSlots_.capacity() * sizeof(int64_t) +
+           slots_.capacity() * sizeof(uint64_t) +
+           largeCounts_.size() * (sizeof(int64_t) * 2 + sizeof(void*) * 2);
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
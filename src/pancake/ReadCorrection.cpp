@@ -0,0 +1,221 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/pancake/ReadCorrection.h>
+#include <pacbio/util/Util.h>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace PacBio {
+namespace Pancake {
+
+PileupAlignment CreatePileupAlignment(const Overlap& ovl, const char* targetSeq,
+                                      int32_t targetLen)
+{
+    if (ovl.Arev) {
+        throw std::runtime_error("The A-read should always be forward oriented. (In "
+                                 "CreatePileupAlignment.)");
+    }
+    const int32_t bStartFwd = ovl.BstartFwd();
+    const int32_t bEndFwd = ovl.BendFwd();
+    if (bStartFwd < 0 || bEndFwd > targetLen || bEndFwd < bStartFwd) {
+        std::ostringstream oss;
+        oss << "Invalid B range in CreatePileupAlignment. BstartFwd = " << bStartFwd
+            << ", BendFwd = " << bEndFwd << ", targetLen = " << targetLen << ".";
+        throw std::runtime_error(oss.str());
+    }
+
+    PileupAlignment ret;
+    ret.queryStart = ovl.Astart;
+    ret.queryEnd = ovl.Aend;
+    ret.cigar = ovl.Cigar;
+    ret.targetSeq = std::string(targetSeq + bStartFwd, bEndFwd - bStartFwd);
+    if (ovl.Brev) {
+        ret.targetSeq = PacBio::Pancake::ReverseComplement(ret.targetSeq, 0, ret.targetSeq.size());
+    }
+    return ret;
+}
+
+namespace {
+
+/*
+ * Versions of a single homopolymer run, and the number of reads which support each.
+*/
+using RunVotes = std::vector<std::pair<std::string, int32_t>>;
+
+void AddVote(RunVotes& votes, const std::string& version)
+{
+    for (auto& vote : votes) {
+        if (vote.first == version) {
+            ++vote.second;
+            return;
+        }
+    }
+    votes.emplace_back(version, 1);
+}
+
+/*
+ * Walks the CIGAR of one alignment, and adds the votes for all the runs which the alignment
+ * covers completely. The bases of the other read which are not aligned to the corrected read
+ * are attached to the run of the same base: to the previous run if it is of the same base, or
+ * otherwise to the next run, which is where the left-aligned homopolymer insertions are.
+*/
+void AddAlignmentVotes(const PileupAlignment& aln, const std::vector<int32_t>& runIds,
+                       const std::vector<int32_t>& runStarts, const char* seq, int32_t seqLen,
+                       std::vector<RunVotes>& votes)
+{
+    using PacBio::BAM::CigarOperationType;
+
+    const int32_t numRuns = static_cast<int32_t>(runStarts.size()) - 1;
+    const int32_t targetLen = aln.targetSeq.size();
+    int32_t qPos = aln.queryStart;
+    int32_t tPos = 0;
+    int32_t currRun = -1;
+    std::string currVersion;
+    std::string pending;
+
+    // Moves to the run of the next query base, and closes the current run.
+    auto EnterRun = [&](int32_t runId) {
+        if (runId == currRun) {
+            return;
+        }
+        if (currRun >= 0 && runStarts[currRun] >= aln.queryStart &&
+            runStarts[currRun + 1] <= aln.queryEnd) {
+            AddVote(votes[currRun], currVersion);
+        }
+        currRun = runId;
+        currVersion.clear();
+        std::swap(currVersion, pending);
+    };
+
+    for (const auto& op : aln.cigar) {
+        const int32_t opLen = op.Length();
+        const auto type = op.Type();
+        if (type == CigarOperationType::SEQUENCE_MATCH ||
+            type == CigarOperationType::SEQUENCE_MISMATCH ||
+            type == CigarOperationType::ALIGNMENT_MATCH) {
+            if ((qPos + opLen) > seqLen || (tPos + opLen) > targetLen) {
+                throw std::runtime_error("The CIGAR is longer than the aligned sequences in "
+                                         "CorrectRead.");
+            }
+            for (int32_t i = 0; i < opLen; ++i, ++qPos, ++tPos) {
+                EnterRun(runIds[qPos]);
+                currVersion += aln.targetSeq[tPos];
+            }
+        } else if (type == CigarOperationType::INSERTION) {
+            if ((qPos + opLen) > seqLen) {
+                throw std::runtime_error("The CIGAR is longer than the corrected read in "
+                                         "CorrectRead.");
+            }
+            for (int32_t i = 0; i < opLen; ++i, ++qPos) {
+                EnterRun(runIds[qPos]);
+            }
+        } else if (type == CigarOperationType::DELETION) {
+            if ((tPos + opLen) > targetLen) {
+                throw std::runtime_error("The CIGAR is longer than the aligned target in "
+                                         "CorrectRead.");
+            }
+            for (int32_t i = 0; i < opLen; ++i, ++tPos) {
+                const char base = aln.targetSeq[tPos];
+                if (pending.empty() && currRun >= 0 && base == seq[runStarts[currRun]]) {
+                    currVersion += base;
+                } else {
+                    pending += base;
+                }
+            }
+        } else {
+            std::ostringstream oss;
+            oss << "CIGAR operation '" << op.TypeToChar(type) << "' not supported by CorrectRead.";
+            throw std::runtime_error(oss.str());
+        }
+    }
+    if (qPos != aln.queryEnd) {
+        std::ostringstream oss;
+        oss << "The CIGAR does not span the query range in CorrectRead. queryStart = "
+            << aln.queryStart << ", queryEnd = " << aln.queryEnd << ", CIGAR end = " << qPos
+            << ".";
+        throw std::runtime_error(oss.str());
+    }
+    // The unaligned bases after the last run can't be attributed, and are dropped.
+    pending.clear();
+    EnterRun(numRuns);
+}
+
+}  // namespace
+
+std::string CorrectRead(const char* seq, int32_t seqLen,
+                        const std::vector<PileupAlignment>& alignments,
+                        const ReadCorrectionSettings& settings, ReadCorrectionStats& stats)
+{
+    stats = ReadCorrectionStats();
+
+    // Split the read into homopolymer runs. The last run start is the end of the read.
+    std::vector<int32_t> runStarts;
+    std::vector<int32_t> runIds(seqLen, 0);
+    for (int32_t i = 0; i < seqLen; ++i) {
+        if (i == 0 || seq[i] != seq[i - 1]) {
+            runStarts.emplace_back(i);
+        }
+        runIds[i] = static_cast<int32_t>(runStarts.size()) - 1;
+    }
+    runStarts.emplace_back(seqLen);
+    const int32_t numRuns = static_cast<int32_t>(runStarts.size()) - 1;
+    stats.numRuns = numRuns;
+
+    std::vector<RunVotes> votes(numRuns);
+    for (const auto& aln : alignments) {
+        if (aln.queryStart < 0 || aln.queryEnd > seqLen || aln.queryEnd < aln.queryStart) {
+            std::ostringstream oss;
+            oss << "Invalid query range in CorrectRead. queryStart = " << aln.queryStart
+                << ", queryEnd = " << aln.queryEnd << ", seqLen = " << seqLen << ".";
+            throw std::runtime_error(oss.str());
+        }
+        AddAlignmentVotes(aln, runIds, runStarts, seq, seqLen, votes);
+    }
+
+    std::string ret;
+    ret.reserve(seqLen);
+    for (int32_t r = 0; r < numRuns; ++r) {
+        const std::string own(seq + runStarts[r], runStarts[r + 1] - runStarts[r]);
+        int32_t numOthers = 0;
+        int32_t ownSupport = 0;
+        const std::pair<std::string, int32_t>* best = nullptr;
+        for (const auto& vote : votes[r]) {
+            numOthers += vote.second;
+            if (vote.first == own) {
+                ownSupport = vote.second;
+            }
+            // Ties are broken in favour of the read's own version, and then lexicographically,
+            // so that the result does not depend on the order of the alignments.
+            if (best == nullptr || vote.second > best->second ||
+                (vote.second == best->second && best->first != own &&
+                 (vote.first == own || vote.first < best->first))) {
+                best = &vote;
+            }
+        }
+
+        // The read itself counts toward the coverage and the support of its own version.
+        if ((numOthers + 1) < settings.minCoverage) {
+            ret += own;
+            continue;
+        }
+        ++stats.numCovered;
+        if (best->first == own || best->second <= (ownSupport + 1)) {
+            ret += own;
+            continue;
+        }
+        if (ownSupport >= settings.minHetSupport &&
+            ownSupport >= settings.minHetFraction * numOthers) {
+            ret += own;
+            ++stats.numHetKept;
+            continue;
+        }
+        ret += best->first;
+        ++stats.numCorrected;
+    }
+
+    return ret;
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
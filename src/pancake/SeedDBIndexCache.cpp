@@ -1,6 +1,7 @@
 // Authors: Ivan Sovic
 
 #include <pacbio/pancake/SeedDBIndexCache.h>
+#include <pacbio/util/CRC32C.h>
 #include <pacbio/util/Util.h>
 #include <pbcopper/utility/StringUtils.h>
 #include <limits>
@@ -45,10 +46,20 @@ PacBio::Pancake::SeedDB::SeedDBParameters ParseSeedDBParams(const std::string& p
             ret.Spacing = std::stoi(values[1]);
         } else if (values[0] == "hpc") {
             ret.UseHPC = std::stoi(values[1]);
+        } else if (values[0] == "hpc_seeds") {
+            ret.UseHPCForSeedsOnly = std::stoi(values[1]);
         } else if (values[0] == "hpc_len") {
             ret.MaxHPCLen = std::stoi(values[1]);
         } else if (values[0] == "rc") {
             ret.UseRC = std::stoi(values[1]);
+        } else if (values[0] == "scheme") {
+            ret.Scheme = PacBio::Pancake::SeedDB::SeedingSchemeFromString(values[1]);
+        } else if (values[0] == "sync") {
+            ret.SyncmerSize = std::stoi(values[1]);
+        } else if (values[0] == "strobe_min") {
+            ret.StrobeMinDist = std::stoi(values[1]);
+        } else if (values[0] == "strobe_max") {
+            ret.StrobeMaxDist = std::stoi(values[1]);
         }
     }
 
@@ -69,6 +80,7 @@ std::unique_ptr<PacBio::Pancake::SeedDBIndexCache> LoadSeedDBIndexCache(
     SeedDBSeedsLine sl;
     SeedDBBlockLine bl;
     int32_t numReadItems = 0;
+    int32_t readOffset = 0;
     size_t offset = 0;
     int32_t totalNumSeqs = 0;
 
@@ -133,11 +145,17 @@ std::unique_ptr<PacBio::Pancake::SeedDBIndexCache> LoadSeedDBIndexCache(
                 cache->seedLines.emplace_back(sl);
                 break;
             case 'B':
-                numReadItems = sscanf(&line[1], "%d %d %d %ld", &(bl.blockId), &(bl.startSeqId),
-                                      &(bl.endSeqId), &(bl.numBytes));
+                numReadItems = sscanf(&line[1], "%d %d %d %ld%n", &(bl.blockId), &(bl.startSeqId),
+                                      &(bl.endSeqId), &(bl.numBytes), &readOffset);
                 if (numReadItems != 4) {
                     throw std::runtime_error("Problem parsing line: '" + std::string(line) + "'.");
                 }
+                bl.hasChecksum = false;
+                bl.checksum = 0;
+                if (sscanf(&line[1 + readOffset], "%s", buff) == 1) {
+                    bl.hasChecksum = true;
+                    bl.checksum = ParseCRC32C(buff);
+                }
                 cache->blockLines.emplace_back(bl);
                 break;
             default:
@@ -172,6 +190,7 @@ std::unique_ptr<PacBio::Pancake::SeedDBIndexCache> LoadSeedDBIndexCache(
         SeedDBSeedsLine sl;
         SeedDBBlockLine bl;
         std::string paramsStr;
+        std::string checksumStr;
 
         switch (token) {
             case 'V':
@@ -199,6 +218,10 @@ std::unique_ptr<PacBio::Pancake::SeedDBIndexCache> LoadSeedDBIndexCache(
                 break;
             case 'B':
                 iss >> bl.blockId >> bl.startSeqId >> bl.endSeqId >> bl.numBytes;
+                if (iss >> checksumStr) {
+                    bl.hasChecksum = true;
+                    bl.checksum = ParseCRC32C(checksumStr);
+                }
                 cache->blockLines.emplace_back(bl);
                 break;
             default:
@@ -329,7 +352,16 @@ std::ostream& operator<<(std::ostream& os, const PacBio::Pancake::SeedDBIndexCac
     os << "V\t" << r.version << "\n";
     os << "P\tk=" << r.seedParams.KmerSize << ",w=" << r.seedParams.MinimizerWindow
        << ",s=" << r.seedParams.Spacing << ",hpc=" << r.seedParams.UseHPC
-       << ",hpc_len=" << r.seedParams.MaxHPCLen << ",rc=" << r.seedParams.UseRC << "\n";
+       << ",hpc_len=" << r.seedParams.MaxHPCLen << ",rc=" << r.seedParams.UseRC;
+    if (r.seedParams.UseHPCForSeedsOnly) {
+        os << ",hpc_seeds=1";
+    }
+    if (r.seedParams.Scheme != PacBio::Pancake::SeedDB::SeedingScheme::Minimizer) {
+        os << ",scheme=" << PacBio::Pancake::SeedDB::SeedingSchemeToString(r.seedParams.Scheme)
+           << ",sync=" << r.seedParams.SyncmerSize << ",strobe_min=" << r.seedParams.StrobeMinDist
+           << ",strobe_max=" << r.seedParams.StrobeMaxDist;
+    }
+    os << "\n";
     for (const auto& fl : r.fileLines) {
         os << "F"
            << "\t" << fl.fileId << "\t" << fl.filename << "\t" << fl.numSequences << "\t"
@@ -343,7 +375,11 @@ std::ostream& operator<<(std::ostream& os, const PacBio::Pancake::SeedDBIndexCac
     for (const auto& bl : r.blockLines) {
         os << "B"
            << "\t" << bl.blockId << "\t" << bl.startSeqId << "\t" << bl.endSeqId << "\t"
-           << bl.numBytes << "\n";
+           << bl.numBytes;
+        if (bl.hasChecksum) {
+            os << "\t" << CRC32CToString(bl.checksum);
+        }
+        os << "\n";
     }
     return os;
 }
@@ -2,6 +2,7 @@
 
 #include <pacbio/pancake/SeedDBReader.h>
 #include <pacbio/pancake/SeedDBReaderCachedBlock.h>
+#include <pacbio/util/CRC32C.h>
 #include <iostream>
 #include <sstream>
 
@@ -37,10 +38,45 @@ SeedDBReaderCachedBlock::SeedDBReaderCachedBlock(
     LoadBlock(blockIds);
 }
 
+SeedDBReaderCachedBlock::SeedDBReaderCachedBlock(
+    const std::vector<FastaSequenceCached>& seqs,
+    const std::vector<std::vector<PacBio::Pancake::Int128t>>& seeds)
+{
+    if (seqs.size() != seeds.size()) {
+        std::ostringstream oss;
+        oss << "(SeedDBReaderCachedBlock) The number of sequences and seed vectors does not "
+               "match. seqs.size() = "
+            << seqs.size() << ", seeds.size() = " << seeds.size();
+        throw std::runtime_error(oss.str());
+    }
+
+    int64_t totalSize = 0;
+    for (const auto& seqSeeds : seeds) {
+        totalSize += seqSeeds.size();
+    }
+    data_.reserve(totalSize);
+    records_.resize(seqs.size());
+
+    for (size_t i = 0; i < seqs.size(); ++i) {
+        const int64_t seqStart = data_.size();
+        data_.insert(data_.end(), seeds[i].begin(), seeds[i].end());
+        records_[i] = SequenceSeedsCached(seqs[i].Name(), data_.data() + seqStart,
+                                          seeds[i].size(), seqs[i].Id());
+        headerToOrdinalId_[seqs[i].Name()] = i;
+        seqIdToOrdinalId_[seqs[i].Id()] = i;
+    }
+}
+
 SeedDBReaderCachedBlock::~SeedDBReaderCachedBlock() = default;
 
 void SeedDBReaderCachedBlock::LoadBlock(const std::vector<int32_t>& blockIds)
 {
+    if (indexCache_ == nullptr) {
+        throw std::runtime_error(
+            "(SeedDBReaderCachedBlock) Cannot load blocks, the seeds were not loaded from a "
+            "SeedDB.");
+    }
+
     blockIds_ = blockIds;
 
     // Form the contiguous blocks for loading.
@@ -122,6 +158,32 @@ void SeedDBReaderCachedBlock::LoadBlock(const std::vector<int32_t>& blockIds)
         // Increment the storage location for the next part.
         currDataPos += numItemsRead;
     }
+
+    VerifyBlockChecksums_();
+}
+
+void SeedDBReaderCachedBlock::VerifyBlockChecksums_() const
+{
+    for (const auto& blockId : blockIds_) {
+        const auto& bl = indexCache_->GetBlockLine(blockId);
+        if (bl.hasChecksum == false) {
+            continue;
+        }
+        uint32_t checksum = 0;
+        for (int32_t seqId = bl.startSeqId; seqId < bl.endSeqId; ++seqId) {
+            const auto& record = records_[seqIdToOrdinalId_.at(seqId)];
+            checksum = CombineRecordCRC32C(
+                checksum, CRC32C(record.Seeds(), record.Size() * sizeof(PacBio::Pancake::Int128t)));
+        }
+        if (checksum != bl.checksum) {
+            std::ostringstream oss;
+            oss << "(SeedDBReaderCachedBlock) Checksum mismatch for block " << blockId
+                << " of the SeedDB '" << indexCache_->indexFilename
+                << "'. The seed files are corrupted. Expected: " << CRC32CToString(bl.checksum)
+                << ", computed: " << CRC32CToString(checksum) << ".";
+            throw std::runtime_error(oss.str());
+        }
+    }
 }
 
 const SequenceSeedsCached& SeedDBReaderCachedBlock::GetSeedsForSequence(int32_t seqId) const
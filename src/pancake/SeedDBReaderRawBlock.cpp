@@ -2,6 +2,7 @@
 
 #include <pacbio/pancake/SeedDBReader.h>
 #include <pacbio/pancake/SeedDBReaderRawBlock.h>
+#include <pacbio/util/CRC32C.h>
 #include <functional>
 #include <iostream>
 #include <sstream>
@@ -88,6 +89,27 @@ std::vector<SeedDB::SeedRaw> SeedDBReaderRawBlock::GetBlock(int32_t blockId) con
         }
     }
 
+    // The parts are in the order of sequence IDs, so the seeds of each sequence follow
+    // the seeds of the previous one.
+    const auto& bl = seedDBIndexCache_->blockLines[blockId];
+    if (bl.hasChecksum) {
+        uint32_t checksum = 0;
+        int64_t seqStart = 0;
+        for (int32_t seqId = bl.startSeqId; seqId < bl.endSeqId; ++seqId) {
+            const auto& sl = seedDBIndexCache_->GetSeedsLine(seqId);
+            checksum = CombineRecordCRC32C(checksum, CRC32C(&ret[seqStart], sl.numBytes));
+            seqStart += sl.numBytes / 16;
+        }
+        if (checksum != bl.checksum) {
+            std::ostringstream oss;
+            oss << "(SeedDBReaderRawBlock) Checksum mismatch for block " << blockId
+                << " of the SeedDB '" << seedDBIndexCache_->indexFilename
+                << "'. The seed files are corrupted. Expected: " << CRC32CToString(bl.checksum)
+                << ", computed: " << CRC32CToString(checksum) << ".";
+            throw std::runtime_error(oss.str());
+        }
+    }
+
     return ret;
 }
 
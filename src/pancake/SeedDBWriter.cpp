@@ -2,6 +2,7 @@
 
 #include <pacbio/pancake/FastaSequenceCached.h>
 #include <pacbio/pancake/SeedDBWriter.h>
+#include <pacbio/util/CRC32C.h>
 #include <pacbio/util/Util.h>
 #include <cmath>
 #include <iostream>
@@ -82,6 +83,9 @@ void SeedDBWriter::WriteSeeds(const std::string& seqName, int32_t seqId, int32_t
     currentBlock_.numBytes += numBytes;
     currentBlock_.startSeqId = (currentBlock_.startSeqId < 0) ? seqId : currentBlock_.startSeqId;
     currentBlock_.endSeqId = seqId + 1;
+    currentBlock_.checksum =
+        CombineRecordCRC32C(currentBlock_.checksum, CRC32C(seeds.data(), numBytes));
+    currentBlock_.hasChecksum = true;
 
     // Increase counts for the current file.
     fileLines_.back().numBytes += numBytes;
@@ -155,9 +159,20 @@ void SeedDBWriter::WriteIndex()
     fprintf(fpOutIndex_.get(), "V\t%s\n", version_.c_str());
 
     // Write the parameters used to compute the seeds.
-    fprintf(fpOutIndex_.get(), "P\tk=%d,w=%d,s=%d,hpc=%d,hpc_len=%d,rc=%d\n", params_.KmerSize,
+    // The HPC seeding and the scheme are written only if they are not the default, so that
+    // the minimizer DBs stay compatible with older versions.
+    fprintf(fpOutIndex_.get(), "P\tk=%d,w=%d,s=%d,hpc=%d,hpc_len=%d,rc=%d", params_.KmerSize,
             params_.MinimizerWindow, params_.Spacing, params_.UseHPC, params_.MaxHPCLen,
             params_.UseRC);
+    if (params_.UseHPCForSeedsOnly) {
+        fprintf(fpOutIndex_.get(), ",hpc_seeds=1");
+    }
+    if (params_.Scheme != PacBio::Pancake::SeedDB::SeedingScheme::Minimizer) {
+        fprintf(fpOutIndex_.get(), ",scheme=%s,sync=%d,strobe_min=%d,strobe_max=%d",
+                PacBio::Pancake::SeedDB::SeedingSchemeToString(params_.Scheme).c_str(),
+                params_.SyncmerSize, params_.StrobeMinDist, params_.StrobeMaxDist);
+    }
+    fprintf(fpOutIndex_.get(), "\n");
 
     // Write all the files and their sizes.
     for (const auto& f : fileLines_) {
@@ -174,8 +189,12 @@ void SeedDBWriter::WriteIndex()
 
     // Write the blocks of all sequences.
     for (size_t i = 0; i < blockLines_.size(); ++i) {
-        fprintf(fpOutIndex_.get(), "B\t%d\t%d\t%d\t%ld\n", blockLines_[i].blockId,
+        fprintf(fpOutIndex_.get(), "B\t%d\t%d\t%d\t%ld", blockLines_[i].blockId,
                 blockLines_[i].startSeqId, blockLines_[i].endSeqId, blockLines_[i].numBytes);
+        if (blockLines_[i].hasChecksum) {
+            fprintf(fpOutIndex_.get(), "\t%s", CRC32CToString(blockLines_[i].checksum).c_str());
+        }
+        fprintf(fpOutIndex_.get(), "\n");
     }
 }
 
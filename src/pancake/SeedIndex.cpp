@@ -15,8 +15,9 @@ namespace PacBio {
 namespace Pancake {
 
 SeedIndex::SeedIndex(std::shared_ptr<PacBio::Pancake::SeedDBIndexCache>& seedDBCache,
-                     std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds)
-    : seeds_(std::move(seeds)), seedParams_(seedDBCache->seedParams)
+                     std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds,
+                     SeedIndexHashType hashType)
+    : seeds_(std::move(seeds)), hashType_(hashType), seedParams_(seedDBCache->seedParams)
 {
 #ifdef SEED_INDEX_USING_DENSEHASH
     hash_.set_empty_key(
@@ -33,8 +34,12 @@ SeedIndex::SeedIndex(std::shared_ptr<PacBio::Pancake::SeedDBIndexCache>& seedDBC
 
 SeedIndex::SeedIndex(const PacBio::Pancake::SeedDB::SeedDBParameters& seedParams,
                      const std::vector<int32_t>& sequenceLengths,
-                     std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds)
-    : seeds_(std::move(seeds)), seedParams_(seedParams), sequenceLengths_(sequenceLengths)
+                     std::vector<PacBio::Pancake::SeedDB::SeedRaw>&& seeds,
+                     SeedIndexHashType hashType)
+    : seeds_(std::move(seeds))
+    , hashType_(hashType)
+    , seedParams_(seedParams)
+    , sequenceLengths_(sequenceLengths)
 {
 #ifdef SEED_INDEX_USING_DENSEHASH
     hash_.set_empty_key(
@@ -58,6 +63,12 @@ void SeedIndex::BuildHash_()
     kx::radix_sort(seeds_.begin(), seeds_.end());
     ttSort.Stop();
 
+    // The perfect hash stores only the ranges of the sorted seeds.
+    if (hashType_ == SeedIndexHashType::PerfectHash) {
+        perfectHash_ = std::make_unique<PerfectSeedHash>(seeds_.data(), seeds_.size());
+        return;
+    }
+
     // Clear the storage for the hash.
     hash_.clear();
 
@@ -92,6 +103,22 @@ void SeedIndex::BuildHash_()
 void SeedIndex::ComputeFrequencyStats(double percentileCutoff, int64_t& retFreqMax,
                                       double& retFreqAvg, double& retFreqMedian,
                                       int64_t& retFreqCutoff) const
+{
+    if (perfectHash_ != nullptr) {
+        ComputeSeedHashFrequencyStats(*perfectHash_, percentileCutoff, retFreqMax, retFreqAvg,
+                                      retFreqMedian, retFreqCutoff);
+        return;
+    }
+    ComputeSeedHashFrequencyStats(hash_, percentileCutoff, retFreqMax, retFreqAvg, retFreqMedian,
+                                  retFreqCutoff);
+}
+
+namespace {
+
+template <typename HashType>
+void ComputeSeedHashFrequencyStatsImpl(const HashType& hash, double percentileCutoff,
+                                       int64_t& retFreqMax, double& retFreqAvg,
+                                       double& retFreqMedian, int64_t& retFreqCutoff)
 {
     retFreqMax = 0;
     retFreqAvg = 0.0;
@@ -107,7 +134,7 @@ void SeedIndex::ComputeFrequencyStats(double percentileCutoff, int64_t& retFreqM
     }
 
     // Empty input.
-    if (hash_.empty()) {
+    if (hash.empty()) {
         return;
     }
 
@@ -115,8 +142,8 @@ void SeedIndex::ComputeFrequencyStats(double percentileCutoff, int64_t& retFreqM
     std::vector<int64_t> freqs;
     double sumFreqs = 0.0;
     int64_t numValidKeys = 0;
-    freqs.reserve(hash_.size());
-    for (auto it = hash_.begin(); it != hash_.end(); ++it) {
+    freqs.reserve(hash.size());
+    for (auto it = hash.begin(); it != hash.end(); ++it) {
         int64_t start = std::get<0>(it->second);
         int64_t end = std::get<1>(it->second);
         int64_t span = end - start;
@@ -150,16 +177,45 @@ void SeedIndex::ComputeFrequencyStats(double percentileCutoff, int64_t& retFreqM
                     2.0;
 }
 
+}  // namespace
+
+void ComputeSeedHashFrequencyStats(const SeedHashType& hash, double percentileCutoff,
+                                   int64_t& retFreqMax, double& retFreqAvg, double& retFreqMedian,
+                                   int64_t& retFreqCutoff)
+{
+    ComputeSeedHashFrequencyStatsImpl(hash, percentileCutoff, retFreqMax, retFreqAvg,
+                                      retFreqMedian, retFreqCutoff);
+}
+
+void ComputeSeedHashFrequencyStats(const PerfectSeedHash& hash, double percentileCutoff,
+                                   int64_t& retFreqMax, double& retFreqAvg, double& retFreqMedian,
+                                   int64_t& retFreqCutoff)
+{
+    ComputeSeedHashFrequencyStatsImpl(hash, percentileCutoff, retFreqMax, retFreqAvg,
+                                      retFreqMedian, retFreqCutoff);
+}
+
 int64_t SeedIndex::GetSeeds(uint64_t key,
                             std::vector<PacBio::Pancake::SeedDB::SeedRaw>& seeds) const
 {
     seeds.clear();
-    auto it = hash_.find(key);
-    if (it == hash_.end()) {
-        return 0;
+    int64_t start = 0;
+    int64_t end = 0;
+    if (perfectHash_ != nullptr) {
+        auto it = perfectHash_->find(key);
+        if (it == perfectHash_->end()) {
+            return 0;
+        }
+        start = std::get<0>(it->second);
+        end = std::get<1>(it->second);
+    } else {
+        auto it = hash_.find(key);
+        if (it == hash_.end()) {
+            return 0;
+        }
+        start = std::get<0>(it->second);
+        end = std::get<1>(it->second);
     }
-    int64_t start = std::get<0>(it->second);
-    int64_t end = std::get<1>(it->second);
     seeds.insert(seeds.end(), seeds_.begin() + start, seeds_.begin() + end);
     return (end - start);
 }
@@ -174,10 +230,125 @@ bool SeedIndex::CollectHits(const PacBio::Pancake::SeedDB::SeedRaw* querySeeds,
                             int64_t querySeedsSize, int32_t queryLen, std::vector<SeedHit>& hits,
                             int64_t freqCutoff) const
 {
+    if (perfectHash_ != nullptr) {
+        return PacBio::Pancake::SeedDB::CollectSeedHits<PerfectSeedHash>(
+            hits, querySeeds, querySeedsSize, queryLen, *perfectHash_, &seeds_[0], seeds_.size(),
+            sequenceLengths_, seedParams_.KmerSize, seedParams_.Spacing, freqCutoff);
+    }
     return PacBio::Pancake::SeedDB::CollectSeedHits<SeedHashType>(
         hits, querySeeds, querySeedsSize, queryLen, hash_, &seeds_[0], seeds_.size(),
         sequenceLengths_, seedParams_.KmerSize, seedParams_.Spacing, freqCutoff);
 }
 
+void CollectSeedsNearSequenceEnds(const PacBio::Pancake::SeedDB::SeedRaw* seeds, int64_t seedsSize,
+                                  const std::vector<int32_t>& sequenceLengths, int32_t maxDist,
+                                  std::vector<PacBio::Pancake::SeedDB::SeedRaw>& retSeeds)
+{
+    for (int64_t i = 0; i < seedsSize; ++i) {
+        const int32_t seqId = PacBio::Pancake::SeedDB::Seed::DecodeSeqId(seeds[i]);
+        const int32_t pos = PacBio::Pancake::SeedDB::Seed::DecodePos(seeds[i]);
+        if (seqId < 0 || seqId >= static_cast<int32_t>(sequenceLengths.size())) {
+            std::ostringstream oss;
+            oss << "Invalid seqId in CollectSeedsNearSequenceEnds. seqId = " << seqId
+                << ", sequenceLengths.size() = " << sequenceLengths.size();
+            throw std::runtime_error(oss.str());
+        }
+        if (pos < maxDist || pos >= (sequenceLengths[seqId] - maxDist)) {
+            retSeeds.emplace_back(seeds[i]);
+        }
+    }
+}
+
+void CollectSeedHitsFromSortedSeeds(const PacBio::Pancake::SeedDB::SeedRaw* querySeeds,
+                                    int64_t querySeedsSize,
+                                    const PacBio::Pancake::SeedDB::SeedRaw* targetSeeds,
+                                    int64_t targetSeedsSize, int32_t targetLen, int64_t freqCutoff,
+                                    std::vector<SeedHit>& retHits)
+{
+    using PacBio::Pancake::SeedDB::Seed;
+
+    int64_t queryId = 0;
+    int64_t targetId = 0;
+    while (queryId < querySeedsSize && targetId < targetSeedsSize) {
+        const uint64_t queryKey = Seed::DecodeKey(querySeeds[queryId]);
+        const uint64_t targetKey = Seed::DecodeKey(targetSeeds[targetId]);
+        if (queryKey < targetKey) {
+            ++queryId;
+            continue;
+        } else if (targetKey < queryKey) {
+            ++targetId;
+            continue;
+        }
+
+        // Find the ranges of seeds with the same key.
+        int64_t queryEnd = queryId + 1;
+        while (queryEnd < querySeedsSize && Seed::DecodeKey(querySeeds[queryEnd]) == queryKey) {
+            ++queryEnd;
+        }
+        int64_t targetEnd = targetId + 1;
+        while (targetEnd < targetSeedsSize &&
+               Seed::DecodeKey(targetSeeds[targetEnd]) == targetKey) {
+            ++targetEnd;
+        }
+
+        // Skip very frequent seeds.
+        if (freqCutoff <= 0 || (targetEnd - targetId) <= freqCutoff) {
+            for (int64_t i = queryId; i < queryEnd; ++i) {
+                auto decodedQuery = Seed(querySeeds[i]);
+                for (int64_t j = targetId; j < targetEnd; ++j) {
+                    auto decodedTarget = Seed(targetSeeds[j]);
+                    const int32_t querySpan = decodedQuery.span;
+                    const int32_t targetSpan = decodedTarget.span;
+                    bool isRev = false;
+                    int32_t targetPos = decodedTarget.pos;
+                    if (decodedQuery.IsRev() != decodedTarget.IsRev()) {
+                        isRev = true;
+                        targetPos = targetLen - (decodedTarget.pos + targetSpan);
+                    }
+                    retHits.emplace_back(SeedHit{decodedTarget.seqID, isRev, targetPos,
+                                                 decodedQuery.pos, targetSpan, querySpan, 0});
+                }
+            }
+        }
+
+        queryId = queryEnd;
+        targetId = targetEnd;
+    }
+}
+
+SortedSequenceSeeds::SortedSequenceSeeds(const std::vector<SequenceSeedsCached>& records)
+{
+    int64_t numSeeds = 0;
+    for (const auto& record : records) {
+        numSeeds += record.Size();
+    }
+    seeds_.reserve(numSeeds);
+
+    // The key occupies the most significant bits of a raw seed, so sorting the raw values
+    // sorts the seeds by key. The views stay valid because the seeds are not reallocated
+    // after the reserve.
+    records_.reserve(records.size());
+    for (const auto& record : records) {
+        const int64_t offset = seeds_.size();
+        seeds_.insert(seeds_.end(), record.Seeds(), record.Seeds() + record.Size());
+        std::sort(seeds_.begin() + offset, seeds_.end());
+        seqIdToOrdinalId_[record.Id()] = records_.size();
+        records_.emplace_back(
+            SequenceSeedsCached(record.Name(), seeds_.data() + offset, record.Size(), record.Id()));
+    }
+}
+
+const SequenceSeedsCached& SortedSequenceSeeds::GetSeedsForSequence(int32_t seqId) const
+{
+    const auto it = seqIdToOrdinalId_.find(seqId);
+    if (it == seqIdToOrdinalId_.end()) {
+        std::ostringstream oss;
+        oss << "(SortedSequenceSeeds) Invalid seqId, not found in the block. seqId = " << seqId
+            << ", records_.size() = " << records_.size();
+        throw std::runtime_error(oss.str());
+    }
+    return records_[it->second];
+}
+
 }  // namespace Pancake
 }  // namespace PacBio
@@ -1,6 +1,7 @@
 // Authors: Ivan Sovic
 
 #include <pacbio/pancake/SeqDBIndexCache.h>
+#include <pacbio/util/CRC32C.h>
 #include <pacbio/util/Util.h>
 #include <array>
 #include <iostream>
@@ -12,6 +13,17 @@
 namespace PacBio {
 namespace Pancake {
 
+static const char* SEQDB_CIRCULAR_FLAG = "circular";
+
+// Parses the optional trailing column of an S line.
+static bool ParseSeqDBCircularFlag(const std::string& flag, const std::string& line)
+{
+    if (flag != SEQDB_CIRCULAR_FLAG) {
+        throw std::runtime_error("Unknown sequence flag '" + flag + "' in line: '" + line + "'.");
+    }
+    return true;
+}
+
 std::unique_ptr<PacBio::Pancake::SeqDBIndexCache> LoadSeqDBIndexCache(
     const std::string& indexFilename)
 {
@@ -118,14 +130,25 @@ std::unique_ptr<PacBio::Pancake::SeqDBIndexCache> LoadSeqDBIndexCache(
                     offset += readOffset + 1;
                     sl.ranges.emplace_back(r);
                 }
+                sl.isCircular = false;
+                if (offset < numRead && sscanf(&line[offset], "%s", buff) == 1) {
+                    sl.isCircular = ParseSeqDBCircularFlag(buff, line);
+                }
                 cache->seqLines.emplace_back(sl);
                 break;
             case 'B':
-                numReadItems = sscanf(&line[1], "%d %d %d %ld %ld", &(bl.blockId), &(bl.startSeqId),
-                                      &(bl.endSeqId), &(bl.numBytes), &(bl.numBases));
+                numReadItems = sscanf(&line[1], "%d %d %d %ld %ld%n", &(bl.blockId),
+                                      &(bl.startSeqId), &(bl.endSeqId), &(bl.numBytes),
+                                      &(bl.numBases), &readOffset);
                 if (numReadItems != 5) {
                     throw std::runtime_error("Problem parsing line: '" + std::string(line) + "'.");
                 }
+                bl.hasChecksum = false;
+                bl.checksum = 0;
+                if (sscanf(&line[1 + readOffset], "%s", buff) == 1) {
+                    bl.hasChecksum = true;
+                    bl.checksum = ParseCRC32C(buff);
+                }
                 cache->blockLines.emplace_back(bl);
                 break;
             default:
@@ -148,6 +171,7 @@ std::unique_ptr<PacBio::Pancake::SeqDBIndexCache> LoadSeqDBIndexCache(
 
     std::string line;
     char token;
+    std::string flag;
     while (std::getline(is, line)) {
         if (line.empty()) continue;
 
@@ -182,6 +206,9 @@ std::unique_ptr<PacBio::Pancake::SeqDBIndexCache> LoadSeqDBIndexCache(
                     iss >> r.start >> r.end;
                     sl.ranges.emplace_back(r);
                 }
+                if (iss >> flag) {
+                    sl.isCircular = ParseSeqDBCircularFlag(flag, line);
+                }
                 if (sl.seqId != static_cast<int32_t>(cache->seqLines.size())) {
                     std::ostringstream oss;
                     oss << "Invalid seqId for line: '" << line
@@ -193,6 +220,10 @@ std::unique_ptr<PacBio::Pancake::SeqDBIndexCache> LoadSeqDBIndexCache(
                 break;
             case 'B':
                 iss >> bl.blockId >> bl.startSeqId >> bl.endSeqId >> bl.numBytes >> bl.numBases;
+                if (iss >> flag) {
+                    bl.hasChecksum = true;
+                    bl.checksum = ParseCRC32C(flag);
+                }
                 cache->blockLines.emplace_back(bl);
                 break;
             default:
@@ -238,14 +269,21 @@ void WriteSeqDBIndexCache(FILE* fpOut, const SeqDBIndexCache& cache)
         for (const auto& r : cache.seqLines[i].ranges) {
             fprintf(fpOut, "\t%d\t%d", r.start, r.end);
         }
+        if (cache.seqLines[i].isCircular) {
+            fprintf(fpOut, "\t%s", SEQDB_CIRCULAR_FLAG);
+        }
         fprintf(fpOut, "\n");
     }
 
     // Write the blocks of all sequences.
     for (size_t i = 0; i < cache.blockLines.size(); ++i) {
-        fprintf(fpOut, "B\t%d\t%d\t%d\t%ld\t%ld\n", cache.blockLines[i].blockId,
+        fprintf(fpOut, "B\t%d\t%d\t%d\t%ld\t%ld", cache.blockLines[i].blockId,
                 cache.blockLines[i].startSeqId, cache.blockLines[i].endSeqId,
                 cache.blockLines[i].numBytes, cache.blockLines[i].numBases);
+        if (cache.blockLines[i].hasChecksum) {
+            fprintf(fpOut, "\t%s", CRC32CToString(cache.blockLines[i].checksum).c_str());
+        }
+        fprintf(fpOut, "\n");
     }
 }
 
@@ -534,12 +572,19 @@ std::ostream& operator<<(std::ostream& os, const PacBio::Pancake::SeqDBIndexCach
         for (const auto& r : sl.ranges) {
             os << "\t" << r.start << "\t" << r.end;
         }
+        if (sl.isCircular) {
+            os << "\t" << SEQDB_CIRCULAR_FLAG;
+        }
         os << "\n";
     }
     for (const auto& bl : cache.blockLines) {
         os << "B"
            << "\t" << bl.blockId << "\t" << bl.startSeqId << "\t" << bl.endSeqId << "\t"
-           << bl.numBytes << "\t" << bl.numBases << "\n";
+           << bl.numBytes << "\t" << bl.numBases;
+        if (bl.hasChecksum) {
+            os << "\t" << CRC32CToString(bl.checksum);
+        }
+        os << "\n";
     }
     return os;
 }
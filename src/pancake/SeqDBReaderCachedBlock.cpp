@@ -3,8 +3,10 @@
 #include <pacbio/pancake/SeqDBReader.h>
 #include <pacbio/pancake/SeqDBReaderCachedBlock.h>
 #include <pacbio/pancake/Twobit.h>
+#include <pacbio/util/CRC32C.h>
 #include <pacbio/util/RunLengthEncoding.h>
 #include <pacbio/util/Util.h>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -12,8 +14,11 @@ namespace PacBio {
 namespace Pancake {
 
 SeqDBReaderCachedBlock::SeqDBReaderCachedBlock(
-    std::shared_ptr<PacBio::Pancake::SeqDBIndexCache>& seqDBCache, bool useHomopolymerCompression)
-    : seqDBIndexCache_(seqDBCache), useHomopolymerCompression_(useHomopolymerCompression)
+    std::shared_ptr<PacBio::Pancake::SeqDBIndexCache>& seqDBCache, bool useHomopolymerCompression,
+    bool buildHPCCoordinateMap)
+    : seqDBIndexCache_(seqDBCache)
+    , useHomopolymerCompression_(useHomopolymerCompression)
+    , buildHPCCoordinateMap_(buildHPCCoordinateMap)
 {
     ValidateSeqDBIndexCache(seqDBCache);
 }
@@ -24,21 +29,35 @@ void SeqDBReaderCachedBlock::LoadBlocks(const std::vector<int32_t>& blockIds)
 {
     // Collect all sequence IDs for all blocks.
     std::vector<int32_t> seqIds;
+    bool hasChecksums = false;
     for (const auto& blockId : blockIds) {
         const auto& bl = seqDBIndexCache_->GetBlockLine(blockId);
         std::vector<int32_t> newSpan(bl.endSeqId - bl.startSeqId);
         std::iota(newSpan.begin(), newSpan.end(), bl.startSeqId);
         seqIds.insert(seqIds.end(), newSpan.begin(), newSpan.end());
+        hasChecksums = hasChecksums || bl.hasChecksum;
     }
 
     // Get the contiguous file parts for loading.
     std::vector<ContiguousFilePart> parts = GetSeqDBContiguousParts(seqDBIndexCache_, seqIds);
 
-    // Actually load the data.
+    // Actually load the data. The record checksums are computed while the bytes are loaded,
+    // and only if there is a block to verify.
+    std::vector<uint32_t> recordChecksums;
+    std::vector<uint32_t>* recordChecksumsPtr = hasChecksums ? &recordChecksums : nullptr;
     if (seqDBIndexCache_->compressionLevel == 0) {
-        return LoadBlockUncompressed_(parts);
+        LoadBlockUncompressed_(parts, recordChecksumsPtr);
+    } else {
+        LoadBlockCompressed_(parts, recordChecksumsPtr);
+    }
+
+    if (hasChecksums) {
+        VerifyBlockChecksums_(blockIds, recordChecksums);
+    }
+
+    if (useHomopolymerCompression_) {
+        CompressHomopolymers_();
     }
-    return LoadBlockCompressed_(parts);
 }
 
 void SeqDBReaderCachedBlock::LoadSequences(const std::vector<int32_t>& seqIds)
@@ -48,9 +67,14 @@ void SeqDBReaderCachedBlock::LoadSequences(const std::vector<int32_t>& seqIds)
 
     // Actually load the data.
     if (seqDBIndexCache_->compressionLevel == 0) {
-        return LoadBlockUncompressed_(parts);
+        LoadBlockUncompressed_(parts, nullptr);
+    } else {
+        LoadBlockCompressed_(parts, nullptr);
+    }
+
+    if (useHomopolymerCompression_) {
+        CompressHomopolymers_();
     }
-    return LoadBlockCompressed_(parts);
 }
 
 void SeqDBReaderCachedBlock::LoadSequences(const std::vector<std::string>& seqNames)
@@ -60,12 +84,18 @@ void SeqDBReaderCachedBlock::LoadSequences(const std::vector<std::string>& seqNa
 
     // Actually load the data.
     if (seqDBIndexCache_->compressionLevel == 0) {
-        return LoadBlockUncompressed_(parts);
+        LoadBlockUncompressed_(parts, nullptr);
+    } else {
+        LoadBlockCompressed_(parts, nullptr);
+    }
+
+    if (useHomopolymerCompression_) {
+        CompressHomopolymers_();
     }
-    return LoadBlockCompressed_(parts);
 }
 
-void SeqDBReaderCachedBlock::LoadBlockCompressed_(const std::vector<ContiguousFilePart>& parts)
+void SeqDBReaderCachedBlock::LoadBlockCompressed_(const std::vector<ContiguousFilePart>& parts,
+                                                  std::vector<uint32_t>* recordChecksums)
 {
     // Count the data size.
     int64_t totalBases = 0;
@@ -81,6 +111,9 @@ void SeqDBReaderCachedBlock::LoadBlockCompressed_(const std::vector<ContiguousFi
     // Preallocate the space for all the records.
     data_.resize(totalBases);
     records_.resize(totalRecords);
+    if (recordChecksums != nullptr) {
+        recordChecksums->resize(totalRecords);
+    }
 
     // Position of a current record in the data_ vector.
     int64_t seqStart = 0;
@@ -119,6 +152,9 @@ void SeqDBReaderCachedBlock::LoadBlockCompressed_(const std::vector<ContiguousFi
         for (const auto& id : part.seqIds) {
             const auto& sl = seqDBIndexCache_->GetSeqLine(id);
             const int64_t firstByte = sl.fileOffset - startByteOffset;
+            if (recordChecksums != nullptr) {
+                (*recordChecksums)[currRecord] = CRC32C(&tempData[firstByte], sl.numBytes);
+            }
             DecompressSequence(&tempData[firstByte], sl.numBytes, sl.numBases, sl.ranges,
                                &data_[seqStart]);
             records_[currRecord] = FastaSequenceCached{
@@ -130,12 +166,10 @@ void SeqDBReaderCachedBlock::LoadBlockCompressed_(const std::vector<ContiguousFi
         }
     }
 
-    if (useHomopolymerCompression_) {
-        CompressHomopolymers_();
-    }
 }
 
-void SeqDBReaderCachedBlock::LoadBlockUncompressed_(const std::vector<ContiguousFilePart>& parts)
+void SeqDBReaderCachedBlock::LoadBlockUncompressed_(const std::vector<ContiguousFilePart>& parts,
+                                                    std::vector<uint32_t>* recordChecksums)
 {
     // Count the data size.
     int64_t totalBases = 0;
@@ -151,6 +185,9 @@ void SeqDBReaderCachedBlock::LoadBlockUncompressed_(const std::vector<Contiguous
     // Preallocate the space for all the records.
     data_.resize(totalBases);
     records_.resize(totalRecords);
+    if (recordChecksums != nullptr) {
+        recordChecksums->resize(totalRecords);
+    }
 
     int64_t currDataPos = 0;
     int64_t currRecord = 0;
@@ -183,6 +220,9 @@ void SeqDBReaderCachedBlock::LoadBlockUncompressed_(const std::vector<Contiguous
         int64_t seqStart = currDataPos;
         for (const auto& id : part.seqIds) {
             const auto& sl = seqDBIndexCache_->GetSeqLine(id);
+            if (recordChecksums != nullptr) {
+                (*recordChecksums)[currRecord] = CRC32C(&data_[seqStart], sl.numBases);
+            }
             records_[currRecord] = FastaSequenceCached{
                 sl.header, reinterpret_cast<const char*>(&data_[seqStart]), sl.numBases, sl.seqId};
             headerToOrdinalId_[sl.header] = currRecord;
@@ -194,9 +234,29 @@ void SeqDBReaderCachedBlock::LoadBlockUncompressed_(const std::vector<Contiguous
         // Increment the storage location for the next part.
         currDataPos += numItemsRead;
     }
+}
 
-    if (useHomopolymerCompression_) {
-        CompressHomopolymers_();
+void SeqDBReaderCachedBlock::VerifyBlockChecksums_(const std::vector<int32_t>& blockIds,
+                                                   const std::vector<uint32_t>& recordChecksums)
+{
+    for (const auto& blockId : blockIds) {
+        const auto& bl = seqDBIndexCache_->GetBlockLine(blockId);
+        if (bl.hasChecksum == false) {
+            continue;
+        }
+        uint32_t checksum = 0;
+        for (int32_t seqId = bl.startSeqId; seqId < bl.endSeqId; ++seqId) {
+            checksum = CombineRecordCRC32C(checksum, recordChecksums[seqIdToOrdinalId_[seqId]]);
+        }
+        if (checksum != bl.checksum) {
+            std::ostringstream oss;
+            oss << "(SeqDBReaderCachedBlock) Checksum mismatch for block " << blockId
+                << " of the SeqDB '" << seqDBIndexCache_->indexFilename
+                << "'. The sequence files are corrupted. Expected: "
+                << CRC32CToString(bl.checksum) << ", computed: " << CRC32CToString(checksum)
+                << ".";
+            throw std::runtime_error(oss.str());
+        }
     }
 }
 
@@ -254,13 +314,46 @@ void SeqDBReaderCachedBlock::GetSequence(FastaSequenceCached& record, const std:
     record = records_[ordinalId];
 }
 
+std::vector<int32_t> SeqDBReaderCachedBlock::UnrollCircularSequences()
+{
+    std::vector<int32_t> circularLengths(seqDBIndexCache_->seqLines.size(), 0);
+    int64_t totalBases = 0;
+    for (const auto& record : records_) {
+        const bool isCircular = seqDBIndexCache_->GetSeqLine(record.Id()).isCircular;
+        circularLengths[record.Id()] = isCircular ? record.size() : 0;
+        totalBases += isCircular ? (2 * record.size()) : record.size();
+    }
+
+    // The records point to the data, so all of them are moved to a new buffer.
+    std::vector<uint8_t> newData(totalBases);
+    int64_t seqStart = 0;
+    for (auto& record : records_) {
+        const uint8_t* bases = reinterpret_cast<const uint8_t*>(record.data());
+        const int64_t seqLen = record.size();
+        const int32_t numCopies = (circularLengths[record.Id()] > 0) ? 2 : 1;
+        for (int32_t i = 0; i < numCopies; ++i) {
+            std::copy(bases, bases + seqLen, newData.begin() + seqStart + i * seqLen);
+        }
+        record.Bases(reinterpret_cast<const char*>(newData.data() + seqStart));
+        record.Size(numCopies * seqLen);
+        seqStart += numCopies * seqLen;
+    }
+    std::swap(data_, newData);
+
+    return circularLengths;
+}
+
 void SeqDBReaderCachedBlock::CompressHomopolymers_()
 {
     std::vector<int32_t> runLengths;
+    hpcCoordinateMap_.Clear();
     for (auto& record : records_) {
         int64_t comprLen = PacBio::Pancake::RunLengthEncoding(const_cast<char*>(record.c_str()),
                                                               record.size(), runLengths);
         record.Size(comprLen);
+        if (buildHPCCoordinateMap_) {
+            hpcCoordinateMap_.AddSequence(record.Id(), runLengths.data(), comprLen);
+        }
     }
 }
 
@@ -2,6 +2,7 @@
 
 #include <pacbio/pancake/CompressedSequence.h>
 #include <pacbio/pancake/SeqDBWriter.h>
+#include <pacbio/util/CRC32C.h>
 #include <pacbio/util/Util.h>
 #include <cmath>
 #include <iostream>
@@ -44,7 +45,8 @@ SeqDBWriter::~SeqDBWriter()
     WriteIndex();
 }
 
-void SeqDBWriter::AddSequence(const std::string& header, const std::string& seq)
+void SeqDBWriter::AddSequence(const std::string& header, const std::string& seq,
+                              bool isCircular)
 {
     // We need access to the open file to count the number of sequences, bases and bytes.
     if (cache_.fileLines.empty()) {
@@ -63,6 +65,7 @@ void SeqDBWriter::AddSequence(const std::string& header, const std::string& seq)
     std::vector<Range> ranges;
     int64_t numUncompressedBases = 0;
     int64_t numCompressedBases = 0;
+    const size_t bufferStart = seqBuffer_.size();
 
     // Add the bases (either compressed or uncompressed), and initialize the
     // byte and length values properly.
@@ -90,6 +93,10 @@ void SeqDBWriter::AddSequence(const std::string& header, const std::string& seq)
         numCompressedBases = numBytes;
     }
 
+    // Checksum of the bytes as they are stored in the file.
+    const uint32_t recordChecksum =
+        CRC32C(seqBuffer_.data() + bufferStart, seqBuffer_.size() - bufferStart);
+
     // Create a new index registry object.
     SeqDBSequenceLine sl;
     sl.seqId = static_cast<int32_t>(cache_.seqLines.size());
@@ -99,6 +106,7 @@ void SeqDBWriter::AddSequence(const std::string& header, const std::string& seq)
     sl.fileId = cache_.fileLines.back().fileId;
     sl.fileOffset = cache_.fileLines.back().numBytes;
     sl.ranges = ranges;
+    sl.isCircular = isCircular;
     cache_.seqLines.emplace_back(sl);
 
     // Extend the current block.
@@ -106,6 +114,8 @@ void SeqDBWriter::AddSequence(const std::string& header, const std::string& seq)
     currentBlock_.endSeqId = sl.seqId + 1;
     currentBlock_.numBytes += sl.numBytes;
     currentBlock_.numBases += sl.numBases;
+    currentBlock_.checksum = CombineRecordCRC32C(currentBlock_.checksum, recordChecksum);
+    currentBlock_.hasChecksum = true;
 
     // Increase counts for the current file.
     cache_.fileLines.back().numBytes += numBytes;
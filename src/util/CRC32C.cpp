@@ -0,0 +1,134 @@
+// Authors: Ivan Sovic
+
+#include <pacbio/util/CRC32C.h>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PANCAKE_CRC32C_SSE42
+#include <nmmintrin.h>
+#endif
+
+namespace PacBio {
+namespace Pancake {
+
+namespace {
+
+const std::string CRC32C_COLUMN_PREFIX = "crc32c=";
+
+// Reversed Castagnoli polynomial.
+constexpr uint32_t CRC32C_POLY = 0x82F63B78;
+
+using CRC32CTables = std::array<std::array<uint32_t, 256>, 8>;
+
+/*
+ * Tables for the slicing-by-8 implementation. The table k holds the CRC of a byte
+ * followed by k zero bytes.
+*/
+CRC32CTables CreateCRC32CTables()
+{
+    CRC32CTables tables;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int32_t j = 0; j < 8; ++j) {
+            crc = (crc & 1) ? ((crc >> 1) ^ CRC32C_POLY) : (crc >> 1);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t k = 1; k < tables.size(); ++k) {
+            const uint32_t prev = tables[k - 1][i];
+            tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+uint32_t CRC32CSoftware(const uint8_t* data, size_t len, uint32_t crc)
+{
+    static const CRC32CTables tables = CreateCRC32CTables();
+    while (len >= 8) {
+        const uint32_t lo = crc ^ (static_cast<uint32_t>(data[0]) |
+                                   (static_cast<uint32_t>(data[1]) << 8) |
+                                   (static_cast<uint32_t>(data[2]) << 16) |
+                                   (static_cast<uint32_t>(data[3]) << 24));
+        crc = tables[7][lo & 0xFF] ^ tables[6][(lo >> 8) & 0xFF] ^ tables[5][(lo >> 16) & 0xFF] ^
+              tables[4][lo >> 24] ^ tables[3][data[4]] ^ tables[2][data[5]] ^
+              tables[1][data[6]] ^ tables[0][data[7]];
+        data += 8;
+        len -= 8;
+    }
+    for (; len > 0; --len, ++data) {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef PANCAKE_CRC32C_SSE42
+// Compiled for SSE4.2 regardless of the build flags, and called only if the CPU supports it.
+__attribute__((target("sse4.2"))) uint32_t CRC32CHardware(const uint8_t* data, size_t len,
+                                                            uint32_t crc)
+{
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        len -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; len > 0; --len, ++data) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+#endif
+
+}  // namespace
+
+uint32_t CRC32C(const void* data, size_t len, uint32_t crc)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    crc = ~crc;
+#ifdef PANCAKE_CRC32C_SSE42
+    static const bool hasSSE42 = __builtin_cpu_supports("sse4.2");
+    if (hasSSE42) {
+        return ~CRC32CHardware(bytes, len, crc);
+    }
+#endif
+    return ~CRC32CSoftware(bytes, len, crc);
+}
+
+uint32_t CombineRecordCRC32C(uint32_t blockCrc, uint32_t recordCrc)
+{
+    const uint8_t bytes[4] = {
+        static_cast<uint8_t>(recordCrc & 0xFF), static_cast<uint8_t>((recordCrc >> 8) & 0xFF),
+        static_cast<uint8_t>((recordCrc >> 16) & 0xFF), static_cast<uint8_t>(recordCrc >> 24)};
+    return CRC32C(bytes, sizeof(bytes), blockCrc);
+}
+
+std::string CRC32CToString(uint32_t crc)
+{
+    char buff[16];
+    snprintf(buff, sizeof(buff), "%08x", crc);
+    return CRC32C_COLUMN_PREFIX + buff;
+}
+
+uint32_t ParseCRC32C(const std::string& column)
+{
+    const size_t prefixLen = CRC32C_COLUMN_PREFIX.size();
+    const bool isValid =
+        column.size() == (prefixLen + 8) &&
+        column.compare(0, prefixLen, CRC32C_COLUMN_PREFIX) == 0 &&
+        column.find_first_not_of("0123456789abcdefABCDEF", prefixLen) == std::string::npos;
+    if (!isValid) {
+        throw std::runtime_error("Invalid checksum column: '" + column + "'.");
+    }
+    return static_cast<uint32_t>(std::stoul(column.substr(prefixLen), nullptr, 16));
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
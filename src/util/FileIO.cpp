@@ -36,6 +36,8 @@ bool FormatIsXml(const std::string& fn) { return boost::algorithm::iends_with(fn
 
 bool FormatIsSeqDB(const std::string& fn) { return boost::algorithm::iends_with(fn, ".seqdb"); }
 
+bool FormatIsSeedDB(const std::string& fn) { return boost::algorithm::iends_with(fn, ".seeddb"); }
+
 SequenceFormat ParseFormat(const std::string& filename)
 {
     if (FormatIsFasta(filename)) {
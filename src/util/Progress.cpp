@@ -0,0 +1,187 @@
+// Author: Ivan Sovic
+
+#include <pacbio/util/Progress.h>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace PacBio {
+namespace Pancake {
+
+double EstimateRemainingSecs(const ProgressSnapshot& snapshot)
+{
+    double fraction = -1.0;
+    if (snapshot.totalBases > 0) {
+        fraction = static_cast<double>(snapshot.bases) / snapshot.totalBases;
+    } else if (snapshot.totalQueries > 0) {
+        fraction = static_cast<double>(snapshot.queries) / snapshot.totalQueries;
+    }
+    if (fraction <= 0.0 || snapshot.elapsedSecs <= 0.0) {
+        return -1.0;
+    }
+    if (fraction >= 1.0) {
+        return 0.0;
+    }
+    return snapshot.elapsedSecs * (1.0 - fraction) / fraction;
+}
+
+std::string FormatDuration(double secs)
+{
+    if (secs < 0.0) {
+        return "--:--:--";
+    }
+    const int64_t total = std::llround(secs);
+    char buff[64];
+    std::snprintf(buff, sizeof(buff), "%02lld:%02lld:%02lld",
+                  static_cast<long long>(total / 3600), static_cast<long long>((total / 60) % 60),
+                  static_cast<long long>(total % 60));
+    return std::string(buff);
+}
+
+std::string FormatProgressLine(const std::string& name, const ProgressSnapshot& snapshot)
+{
+    const double secs = snapshot.elapsedSecs;
+    const double queriesPerSec = (secs > 0.0) ? snapshot.queries / secs : 0.0;
+    const double mbpPerSec = (secs > 0.0) ? snapshot.bases / secs / 1000000.0 : 0.0;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "[" << name << "] queries: " << snapshot.queries;
+    if (snapshot.totalQueries > 0) {
+        oss << " / " << snapshot.totalQueries << " ("
+            << 100.0 * snapshot.queries / snapshot.totalQueries << "%)";
+    }
+    oss << ", bases: " << snapshot.bases / 1000000.0 << " Mbp";
+    if (snapshot.totalBases > 0) {
+        oss << " / " << snapshot.totalBases / 1000000.0 << " Mbp";
+    }
+    oss << ", rate: " << queriesPerSec << " queries/s, " << mbpPerSec << " Mbp/s"
+        << ", hits: " << snapshot.hits << ", alignments: " << snapshot.alignments;
+    // Only the workflows which align with the adaptive band widen it.
+    if (snapshot.bandWidenings > 0) {
+        oss << ", band widenings: " << snapshot.bandWidenings;
+    }
+    oss << ", overlaps: " << snapshot.overlaps << ", elapsed: " << FormatDuration(secs)
+        << ", ETA: " << FormatDuration(EstimateRemainingSecs(snapshot));
+    return oss.str();
+}
+
+std::string FormatProgressJSON(const std::string& name, const ProgressSnapshot& snapshot,
+                               bool isFinal)
+{
+    const double secs = snapshot.elapsedSecs;
+    const double queriesPerSec = (secs > 0.0) ? snapshot.queries / secs : 0.0;
+    const double basesPerSec = (secs > 0.0) ? snapshot.bases / secs : 0.0;
+    const double eta = EstimateRemainingSecs(snapshot);
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "{\"name\":\"" << name << "\",\"final\":" << (isFinal ? "true" : "false")
+        << ",\"elapsed_secs\":" << secs << ",\"queries\":" << snapshot.queries
+        << ",\"total_queries\":" << snapshot.totalQueries << ",\"bases\":" << snapshot.bases
+        << ",\"total_bases\":" << snapshot.totalBases << ",\"hits\":" << snapshot.hits
+        << ",\"alignments\":" << snapshot.alignments << ",\"band_widenings\":"
+        << snapshot.bandWidenings << ",\"overlaps\":" << snapshot.overlaps
+        << ",\"queries_per_sec\":" << queriesPerSec << ",\"bases_per_sec\":" << basesPerSec
+        << ",\"eta_secs\":";
+    if (eta < 0.0) {
+        oss << "null";
+    } else {
+        oss << eta;
+    }
+    oss << "}";
+    return oss.str();
+}
+
+ProgressReporter::ProgressReporter(const std::string& name, double intervalSecs,
+                                   const std::string& jsonPath)
+    : name_(name), intervalSecs_(intervalSecs), startTime_(std::chrono::steady_clock::now())
+{
+    if (jsonPath.empty() == false) {
+        jsonOfs_ = std::make_unique<std::ofstream>(jsonPath, std::ios::app);
+        if (jsonOfs_->is_open() == false) {
+            throw std::runtime_error("Could not open file '" + jsonPath +
+                                     "' for writing the progress reports.");
+        }
+    }
+}
+
+ProgressReporter::~ProgressReporter()
+{
+    // The destructor must not throw, and failing to write a progress report is not fatal.
+    try {
+        Stop();
+    } catch (...) {
+    }
+}
+
+void ProgressReporter::SetTotals(int64_t totalQueries, int64_t totalBases)
+{
+    totalQueries_.store(totalQueries, std::memory_order_relaxed);
+    totalBases_.store(totalBases, std::memory_order_relaxed);
+}
+
+ProgressSnapshot ProgressReporter::Snapshot() const
+{
+    ProgressSnapshot ret;
+    ret.elapsedSecs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+    ret.queries = counters_.Queries();
+    ret.totalQueries = totalQueries_.load(std::memory_order_relaxed);
+    ret.bases = counters_.Bases();
+    ret.totalBases = totalBases_.load(std::memory_order_relaxed);
+    ret.hits = counters_.Hits();
+    ret.alignments = counters_.Alignments();
+    ret.bandWidenings = counters_.BandWidenings();
+    ret.overlaps = counters_.Overlaps();
+    return ret;
+}
+
+void ProgressReporter::Start()
+{
+    if (intervalSecs_ <= 0.0 || thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = false;
+    }
+    thread_ = std::thread(&ProgressReporter::Run_, this);
+}
+
+void ProgressReporter::Stop()
+{
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopRequested_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    // Write the final line only once, even if Stop is called multiple times.
+    if (jsonOfs_) {
+        *jsonOfs_ << FormatProgressJSON(name_, Snapshot(), true) << "\n";
+        jsonOfs_.reset();
+    }
+}
+
+void ProgressReporter::Run_()
+{
+    const auto interval = std::chrono::duration<double>(intervalSecs_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (cv_.wait_for(lock, interval, [this]() { return stopRequested_; }) == false) {
+        const ProgressSnapshot snapshot = Snapshot();
+        std::cerr << FormatProgressLine(name_, snapshot) << std::endl;
+        if (jsonOfs_) {
+            *jsonOfs_ << FormatProgressJSON(name_, snapshot, false) << std::endl;
+        }
+    }
+}
+
+}  // namespace Pancake
+}  // namespace PacBio
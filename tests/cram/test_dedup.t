@@ -0,0 +1,40 @@
+Detect the exact duplicates on both strands, and the near duplicates. The whitelist keeps the longest read of each group.
+  $ rm -f reads.seqdb* out.*
+  > ${BIN_DIR}/pancake seqdb reads ${PROJECT_DIR}/test-data/dedup/reads.fasta
+  > ${BIN_DIR}/pancake dedup --groups out.groups.tsv reads.seqdb out.whitelist.txt
+  > cat out.whitelist.txt
+  > cat out.groups.tsv
+  read1
+  read2
+  read4
+  read1	read3
+  read2	read5
+  read1	read6
+
+A stricter diff rate keeps the near duplicates apart, and the blacklist lists the removed reads.
+  $ rm -f out.*
+  > ${BIN_DIR}/pancake dedup --max-diff-rate 0 --blacklist reads.seqdb out.blacklist.txt
+  > cat out.blacklist.txt
+  read3
+  read6
+
+The whitelist can be used to filter the SeqDB.
+  $ rm -f out.* filtered.seqdb
+  > ${BIN_DIR}/pancake dedup reads.seqdb out.whitelist.txt
+  > ${BIN_DIR}/pancake dbfilter --filter-list out.whitelist.txt --filter-type whitelist reads filtered
+  > cut -f 1-3 filtered.seqdb | grep "^S"
+  S	0	read1
+  S	1	read2
+  S	2	read4
+
+A zero buffer size confirms the candidate pairs one at a time, with the same results.
+  $ rm -f out.*
+  > ${BIN_DIR}/pancake dedup --buffer-size 0 --groups out.groups.tsv reads.seqdb out.whitelist.txt
+  > cat out.whitelist.txt
+  > cat out.groups.tsv
+  read1
+  read2
+  read4
+  read1	read3
+  read2	read5
+  read1	read6
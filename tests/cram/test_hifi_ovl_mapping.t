@@ -21,6 +21,37 @@ is not flagged as secondary.
   hap1/1/0_11225	11225	0	11225	-	ctg.000000F:124200-136500	12301	697	11922	11225	11225	60	tp:A:P	NM:i:18	IT:f:99.8396	SC:i:-11207	AT:Z:c	BT:Z:C	VQ:Z:*	VT:Z:*
   hap1/1/0_11225	11225	0	11225	+	ctg.000001F:66000-77700	11701	213	11435	11225	11222	60	tp:A:S	NM:i:64	IT:f:99.4298	SC:i:-11158	AT:Z:c	BT:Z:C	VQ:Z:*	VT:Z:*
 
+#############################################
+### Test the structural variant evidence. ###
+#############################################
+The first 6kbp of the read map to the forward strand of the reference, and the remaining 4kbp to the reverse
+strand. The mappings extend past the junction, which is placed exactly by realigning the query.
+The SEQ column is not shown.
+  $ ${BIN_DIR}/pancake seqdb reads ${PROJECT_DIR}/test-data/mapping/test-3-split-read.reads.fasta
+  > ${BIN_DIR}/pancake seeddb -k 15 -w 10 -s 0 reads.seqdb reads
+  > ${BIN_DIR}/pancake seqdb ref ${PROJECT_DIR}/test-data/mapping/test-3-split-read.ref.fasta
+  > ${BIN_DIR}/pancake seeddb -k 15 -w 10 -s 0 ref.seqdb ref
+  > ${BIN_DIR}/pancake ovl-hifi --num-threads 1 ref reads 0 0 0 --out-fmt sam --mark-secondary --write-sa-tags --sv-bedpe sv.bedpe | cut -f 1-9,11-
+  > cat sv.bedpe
+  @HD	VN:1.5
+  @SQ	SN:ctg.000000F:114000-128000	LN:14001
+  split/1/0_10000	0	ctg.000000F:114000-128000	1001	60	*	*	0	0	*	AT:Z:u	BT:Z:u	SA:Z:ctg.000000F:114000-128000,8001,-,4140M5860S,60,76;
+  split/1/0_10000	2064	ctg.000000F:114000-128000	8001	60	*	*	0	0	*	AT:Z:u	BT:Z:u	SA:Z:ctg.000000F:114000-128000,1001,+,6146M3854S,60,74;
+  ctg.000000F:114000-128000	6999	7000	ctg.000000F:114000-128000	11999	12000	split/1/0_10000	.	+	-	split	6000	0	0
+
+Without the SA tags, the SAM flags are not set.
+  $ ${BIN_DIR}/pancake seqdb reads ${PROJECT_DIR}/test-data/mapping/test-3-split-read.reads.fasta
+  > ${BIN_DIR}/pancake seeddb -k 15 -w 10 -s 0 reads.seqdb reads
+  > ${BIN_DIR}/pancake seqdb ref ${PROJECT_DIR}/test-data/mapping/test-3-split-read.ref.fasta
+  > ${BIN_DIR}/pancake seeddb -k 15 -w 10 -s 0 ref.seqdb ref
+  > ${BIN_DIR}/pancake ovl-hifi --num-threads 1 ref reads 0 0 0 --out-fmt sam --mark-secondary | grep -v "^@" | cut -f 1-4
+  split/1/0_10000	0	ctg.000000F:114000-128000	1001
+  split/1/0_10000	16	ctg.000000F:114000-128000	8001
+
+The SA tags are only available with the SAM output.
+  $ ${BIN_DIR}/pancake ovl-hifi --num-threads 1 ref reads 0 0 0 --out-fmt paf --mark-secondary --write-sa-tags 2>&1 | grep -o "The '--write-sa-tags'.*"
+  The '--write-sa-tags' option requires '--out-fmt sam'.
+
 #######################################
 ### Test trimming of CIGAR strings. ###
 #######################################
@@ -0,0 +1,32 @@
+Merge the overlaps of two jobs, and group them by the A-read. The overlaps of each read are sorted by score.
+  $ rm -f out.* test.in.*
+  > printf "a b -100 99.00 0 0 100 100 0 0 100 100 5\nb c -300 99.00 0 0 300 300 0 0 300 300 5\n" > test.in.1.m4
+  > printf "b a -120 98.00 0 0 120 120 0 0 120 120 5\na c -200 99.00 0 0 200 200 0 0 200 200 5\nc b -300 99.50 0 0 300 300 0 0 300 300 5\n" > test.in.2.m4
+  > ${BIN_DIR}/pancake ovl-merge out.m4 test.in.1.m4 test.in.2.m4
+  > cat out.m4
+  a c -200 99.00 0 0 200 200 0 0 200 200 5
+  a b -100 99.00 0 0 100 100 0 0 100 100 5
+  b c -300 99.00 0 0 300 300 0 0 300 300 5
+  b a -120 98.00 0 0 120 120 0 0 120 120 5
+  c b -300 99.50 0 0 300 300 0 0 300 300 5
+
+Deduplicate the A-B and B-A overlaps. The better overlap of each pair is kept, by score and then identity.
+Inputs are given through a FOFN, and the small memory budget forces multiple sorted runs.
+  $ rm -f out.* test.in.fofn
+  > echo "test.in.1.m4" > test.in.fofn
+  > echo "test.in.2.m4" >> test.in.fofn
+  > ${BIN_DIR}/pancake ovl-merge --dedup --max-memory 0.0001 --num-threads 2 out.m4 test.in.fofn
+  > cat out.m4
+  > ls out.m4.* 2>/dev/null | wc -l | awk '{ print $1 }'
+  a c -200 99.00 0 0 200 200 0 0 200 200 5
+  b a -120 98.00 0 0 120 120 0 0 120 120 5
+  c b -300 99.50 0 0 300 300 0 0 300 300 5
+  0
+
+Keep only the best overlap of each A-read, across all inputs.
+  $ rm -f out.*
+  > ${BIN_DIR}/pancake ovl-merge --bestn 1 out.m4 test.in.1.m4 test.in.2.m4
+  > cat out.m4
+  a c -200 99.00 0 0 200 200 0 0 200 200 5
+  b c -300 99.00 0 0 300 300 0 0 300 300 5
+  c b -300 99.50 0 0 300 300 0 0 300 300 5
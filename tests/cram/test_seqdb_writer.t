@@ -241,3 +241,15 @@ Test filtered XML input.
   B	0	0	11	116004	464009
   test-input-xml.seqdb
   test-input-xml.seqdb.0.seq
+
+Mark the sequences from a list as circular. Only the S lines of the listed sequences get the trailing "circular" column.
+  $ rm -f test-circular.seqdb*
+  > echo "m141013_011508_sherri_c100709962550000001823135904221533_s1_p0/3414/0_11983" > circular.txt
+  > echo "m141013_011508_sherri_c100709962550000001823135904221533_s1_p0/3981/0_5105" >> circular.txt
+  > ${BIN_DIR}/pancake seqdb test-circular ${PROJECT_DIR}/test-data/seqdb-writer/in.fasta --block-size 0 --buffer-size 1024 --split-blocks --circular-list circular.txt
+  > grep "^S" test-circular.seqdb | cut -f 1-3,11
+  S	0	m141013_011508_sherri_c100709962550000001823135904221533_s1_p0/3005/0_5852
+  S	1	m141013_011508_sherri_c100709962550000001823135904221533_s1_p0/3414/0_11983	circular
+  S	2	m141013_011508_sherri_c100709962550000001823135904221533_s1_p0/3820/0_24292
+  S	3	m141013_011508_sherri_c100709962550000001823135904221533_s1_p0/3981/0_5105	circular
+  S	4	m141013_011508_sherri_c100709962550000001823135904221533_s1_p0/4028/0_19001
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <pacbio/pancake/AlignerKSW2.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+using namespace PacBio::Pancake;
+
+namespace AlignerKSW2Tests {
+
+std::string GenerateRandomSequence(int32_t len, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> dist(0, 3);
+    std::string ret(len, 'A');
+    for (int32_t i = 0; i < len; ++i) {
+        ret[i] = "ACGT"[dist(gen)];
+    }
+    return ret;
+}
+
+// Introduces a mismatch, an insertion and a deletion every 100 bases.
+std::string MutateSequence(const std::string& seq)
+{
+    std::string ret;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        if ((i % 100) == 10) {
+            ret += (seq[i] == 'A') ? 'C' : 'A';
+        } else if ((i % 100) == 50) {
+            ret += seq[i];
+            ret += 'T';
+        } else if ((i % 100) != 80) {
+            ret += seq[i];
+        }
+    }
+    return ret;
+}
+
+void ExpectEqualResults(const AlignmentResult& expected, const AlignmentResult& result)
+{
+    EXPECT_EQ(expected.cigar, result.cigar);
+    EXPECT_EQ(expected.valid, result.valid);
+    EXPECT_EQ(expected.score, result.score);
+    EXPECT_EQ(expected.maxScore, result.maxScore);
+    EXPECT_EQ(expected.zdropped, result.zdropped);
+    EXPECT_EQ(expected.lastQueryPos, result.lastQueryPos);
+    EXPECT_EQ(expected.lastTargetPos, result.lastTargetPos);
+    EXPECT_EQ(expected.maxQueryPos, result.maxQueryPos);
+    EXPECT_EQ(expected.maxTargetPos, result.maxTargetPos);
+}
+
+}  // namespace AlignerKSW2Tests
+
+TEST(AlignerKSW2, ResultBufferOverloads_SameAsReturnedResults)
+{
+    const std::string target = AlignerKSW2Tests::GenerateRandomSequence(2000, 1234);
+    const std::string query = AlignerKSW2Tests::MutateSequence(target);
+
+    AlignerKSW2 aligner(AlignmentParameters{});
+
+    // Reuse the same result object, to make sure that nothing is left over from the previous call.
+    AlignmentResult result;
+
+    {
+        SCOPED_TRACE("Global");
+        const AlignmentResult expected =
+            aligner.Global(query.c_str(), query.size(), target.c_str(), target.size());
+        aligner.Global(query.c_str(), query.size(), target.c_str(), target.size(), result);
+        EXPECT_TRUE(expected.valid);
+        AlignerKSW2Tests::ExpectEqualResults(expected, result);
+    }
+    {
+        SCOPED_TRACE("Extend");
+        const AlignmentResult expected =
+            aligner.Extend(query.c_str(), query.size(), target.c_str(), target.size());
+        aligner.Extend(query.c_str(), query.size(), target.c_str(), target.size(), result);
+        EXPECT_TRUE(expected.valid);
+        AlignerKSW2Tests::ExpectEqualResults(expected, result);
+    }
+    {
+        SCOPED_TRACE("ExtendReverse");
+        const std::string queryRev(query.rbegin(), query.rend());
+        const std::string targetRev(target.rbegin(), target.rend());
+        const AlignmentResult expected =
+            aligner.Extend(queryRev.c_str(), queryRev.size(), targetRev.c_str(), targetRev.size());
+        aligner.ExtendReverse(query.c_str(), query.size(), target.c_str(), target.size(), result);
+        EXPECT_TRUE(expected.valid);
+        AlignerKSW2Tests::ExpectEqualResults(expected, result);
+    }
+}
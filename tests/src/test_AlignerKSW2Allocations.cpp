@@ -0,0 +1,207 @@
+// Built as a separate test executable, because it replaces the global operator new.
+
+#include <gtest/gtest.h>
+
+#include <pacbio/pancake/AlignerEdlib.h>
+#include <pacbio/pancake/AlignerKSW2.h>
+#include <pacbio/pancake/AlignerSES1.h>
+#include <pacbio/pancake/AlignerSES2.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+using namespace PacBio::Pancake;
+
+namespace AlignerKSW2AllocationsTests {
+
+// Only the allocations made by this thread while a CountAllocations object is alive are
+// counted, so that neither the test framework nor the setup code contribute.
+thread_local bool isCounting = false;
+thread_local int64_t numAllocations = 0;
+
+class CountAllocations
+{
+public:
+    CountAllocations() : numAllocationsBefore_(numAllocations) { isCounting = true; }
+    ~CountAllocations() { isCounting = false; }
+    int64_t NumAllocations() const { return numAllocations - numAllocationsBefore_; }
+
+private:
+    int64_t numAllocationsBefore_ = 0;
+};
+
+std::string GenerateRandomSequence(int32_t len, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> dist(0, 3);
+    std::string ret(len, 'A');
+    for (int32_t i = 0; i < len; ++i) {
+        ret[i] = "ACGT"[dist(gen)];
+    }
+    return ret;
+}
+
+// Introduces a mismatch, an insertion and a deletion every 100 bases.
+std::string MutateSequence(const std::string& seq)
+{
+    std::string ret;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        if ((i % 100) == 10) {
+            ret += (seq[i] == 'A') ? 'C' : 'A';
+        } else if ((i % 100) == 50) {
+            ret += seq[i];
+            ret += 'T';
+        } else if ((i % 100) != 80) {
+            ret += seq[i];
+        }
+    }
+    return ret;
+}
+
+// Aligns the same pair a few times to grow the buffers, and then counts the allocations made
+// by further calls of the caller-owned result variants. The results are compared to the ones of
+// the value-returning functions.
+int64_t CountSteadyStateAllocations(AlignerBase& aligner, const std::string& query,
+                                    const std::string& target)
+{
+    const AlignmentResult expectedGlobal =
+        aligner.Global(query.c_str(), query.size(), target.c_str(), target.size());
+    const AlignmentResult expectedExtend =
+        aligner.Extend(query.c_str(), query.size(), target.c_str(), target.size());
+
+    AlignmentResult resultGlobal;
+    AlignmentResult resultExtend;
+    auto AlignAll = [&]() {
+        aligner.Global(query.c_str(), query.size(), target.c_str(), target.size(), resultGlobal);
+        aligner.Extend(query.c_str(), query.size(), target.c_str(), target.size(), resultExtend);
+        aligner.ExtendReverse(query.c_str(), query.size(), target.c_str(), target.size(),
+                              resultExtend);
+    };
+
+    AlignAll();
+    AlignAll();
+
+    int64_t numAllocations = 0;
+    {
+        CountAllocations counter;
+        for (int32_t i = 0; i < 10; ++i) {
+            AlignAll();
+        }
+        numAllocations = counter.NumAllocations();
+    }
+
+    EXPECT_TRUE(resultGlobal.valid);
+    EXPECT_EQ(expectedGlobal.cigar, resultGlobal.cigar);
+    EXPECT_EQ(expectedGlobal.score, resultGlobal.score);
+    EXPECT_EQ(expectedExtend.valid, resultExtend.valid);
+    EXPECT_EQ(expectedExtend.cigar, resultExtend.cigar);
+
+    return numAllocations;
+}
+
+}  // namespace AlignerKSW2AllocationsTests
+
+// The default array versions of the operators forward to these. They are not inlined, so that
+// GCC does not pair the malloc and the free with the new and delete at the call sites.
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    if (AlignerKSW2AllocationsTests::isCounting) {
+        ++AlignerKSW2AllocationsTests::numAllocations;
+    }
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+TEST(AlignerKSW2, ResultBufferOverloads_NoAllocationsInSteadyState)
+{
+    const std::string target = AlignerKSW2AllocationsTests::GenerateRandomSequence(2000, 5678);
+    const std::string query = AlignerKSW2AllocationsTests::MutateSequence(target);
+
+    AlignerKSW2 aligner(AlignmentParameters{});
+    AlignmentResult result;
+
+    auto AlignAll = [&]() {
+        aligner.Global(query.c_str(), query.size(), target.c_str(), target.size(), result);
+        aligner.Extend(query.c_str(), query.size(), target.c_str(), target.size(), result);
+        aligner.ExtendReverse(query.c_str(), query.size(), target.c_str(), target.size(), result);
+    };
+
+    // The first calls grow the memory pool and the CIGAR buffer.
+    AlignAll();
+    AlignAll();
+
+    // The memory pool of the aligner allocates with malloc, so it is checked separately.
+    const km_stat_t poolBefore = aligner.MemoryPoolStats();
+    int64_t numAllocations = 0;
+    {
+        AlignerKSW2AllocationsTests::CountAllocations counter;
+        for (int32_t i = 0; i < 10; ++i) {
+            AlignAll();
+        }
+        numAllocations = counter.NumAllocations();
+    }
+    const km_stat_t poolAfter = aligner.MemoryPoolStats();
+
+    EXPECT_TRUE(result.valid);
+    EXPECT_EQ(0, numAllocations);
+    EXPECT_LT(0U, poolBefore.n_cores);
+    EXPECT_EQ(poolBefore.n_cores, poolAfter.n_cores);
+    EXPECT_EQ(poolBefore.capacity, poolAfter.capacity);
+}
+
+TEST(AlignerSES1, ResultBufferOverloads_NoAllocationsInSteadyState)
+{
+    const std::string target = AlignerKSW2AllocationsTests::GenerateRandomSequence(500, 5678);
+    const std::string query = AlignerKSW2AllocationsTests::MutateSequence(target);
+
+    AlignerSES1 aligner(AlignmentParameters{});
+
+    EXPECT_EQ(0, AlignerKSW2AllocationsTests::CountSteadyStateAllocations(aligner, query, target));
+}
+
+TEST(AlignerSES2, ResultBufferOverloads_NoAllocationsInSteadyState)
+{
+    const std::string target = AlignerKSW2AllocationsTests::GenerateRandomSequence(500, 5678);
+    const std::string query = AlignerKSW2AllocationsTests::MutateSequence(target);
+
+    AlignerSES2 aligner(AlignmentParameters{});
+
+    EXPECT_EQ(0, AlignerKSW2AllocationsTests::CountSteadyStateAllocations(aligner, query, target));
+}
+
+TEST(AlignerEdlib, ResultBufferOverloads_ReuseTheResultBuffers)
+{
+    const std::string target = AlignerKSW2AllocationsTests::GenerateRandomSequence(500, 5678);
+    const std::string query = AlignerKSW2AllocationsTests::MutateSequence(target);
+
+    AlignerEdlib aligner(AlignmentParameters{});
+
+    // Edlib allocates its matrices and the alignment path internally, so only the allocations
+    // of a value-returning call on top of that are checked to be gone.
+    int64_t numAllocationsPerValueCall = 0;
+    {
+        aligner.Global(query.c_str(), query.size(), target.c_str(), target.size());
+        AlignerKSW2AllocationsTests::CountAllocations counter;
+        aligner.Global(query.c_str(), query.size(), target.c_str(), target.size());
+        numAllocationsPerValueCall = counter.NumAllocations();
+    }
+
+    const int64_t numAllocations =
+        AlignerKSW2AllocationsTests::CountSteadyStateAllocations(aligner, query, target);
+
+    // There are 10 rounds of alignments, and one of the three calls in each aligns.
+    EXPECT_LT(numAllocations, numAllocationsPerValueCall * 10);
+}
@@ -465,6 +465,68 @@ TEST(AlignmentSeeded, AlignSingleRegion_ArrayOfTests)
     }
 }
 
+TEST(AlignmentSeeded, AlignUngapped_ArrayOfTests)
+{
+    struct TestData
+    {
+        std::string testName;
+        std::string querySeq;
+        std::string targetSeq;
+        int32_t maxMismatches = 0;
+        int32_t minMismatchDist = 0;
+        bool expectedValid = false;
+        PacBio::Data::Cigar expectedCigar;
+    };
+
+    // clang-format off
+    std::vector<TestData> allTests{
+        TestData{"Empty input", "", "", 4, 4, true, PacBio::Data::Cigar()},
+        TestData{"Exact match, shorter than a word", "ACTGA", "ACTGA", 4, 4, true, PacBio::Data::Cigar("5=")},
+        TestData{"Exact match, multiple words and a tail",
+                    "AAAAACCCCCTTTTTGGGGGACT", "AAAAACCCCCTTTTTGGGGGACT", 4, 4, true,
+                    PacBio::Data::Cigar("23=")},
+        TestData{"Mismatches in the words and in the tail",
+                    "AAAAACCCCCTTTTTGGGGGACT", "AAAATCCCCCTGTTTGGGGGACA", 4, 4, true,
+                    PacBio::Data::Cigar("4=1X6=1X10=1X")},
+        TestData{"Mismatch at the first base", "AAAAACCCCC", "TAAAACCCCC", 4, 4, true,
+                    PacBio::Data::Cigar("1X9=")},
+        TestData{"Too many mismatches", "AAAAACCCCCTTTTTGGGGGACT", "AAAATCCCCCTGTTTGGGGGACA", 2, 4,
+                    false, PacBio::Data::Cigar()},
+        TestData{"Mismatches too close, could be an indel", "AAAAACCCCC", "AAAACACCCC", 4, 4,
+                    false, PacBio::Data::Cigar()},
+        TestData{"Mismatches far enough", "AAAAACCCCCC", "AAAACCCCACC", 4, 4, true,
+                    PacBio::Data::Cigar("4=1X3=1X2=")},
+    };
+    // clang-format on
+
+    // Reused for all tests, to make sure that nothing is left over from the previous call.
+    AlignmentResult reusedResult;
+
+    for (const auto& data : allTests) {
+        // Name the test.
+        SCOPED_TRACE(data.testName);
+
+        // Run the unit under test.
+        AlignmentResult result =
+            AlignUngapped(data.querySeq.c_str(), data.targetSeq.c_str(), data.querySeq.size(),
+                          data.maxMismatches, data.minMismatchDist);
+        AlignUngapped(data.querySeq.c_str(), data.targetSeq.c_str(), data.querySeq.size(),
+                      data.maxMismatches, data.minMismatchDist, reusedResult);
+
+        // Evaluate.
+        EXPECT_EQ(data.expectedValid, result.valid);
+        EXPECT_EQ(data.expectedCigar, result.cigar);
+        if (data.expectedValid) {
+            EXPECT_EQ(static_cast<int32_t>(data.querySeq.size()), result.lastQueryPos);
+            EXPECT_EQ(static_cast<int32_t>(data.targetSeq.size()), result.lastTargetPos);
+        }
+        EXPECT_EQ(result.valid, reusedResult.valid);
+        EXPECT_EQ(result.cigar, reusedResult.cigar);
+        EXPECT_EQ(result.lastQueryPos, reusedResult.lastQueryPos);
+        EXPECT_EQ(result.lastTargetPos, reusedResult.lastTargetPos);
+    }
+}
+
 TEST(AlignmentSeeded, AlignmentSeeded_ArrayOfTests)
 {
     struct TestData
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <random>
 #include <sstream>
 #include <tuple>
 #include <vector>
@@ -888,6 +889,85 @@ TEST(Test_AlignmentTools_NormalizeCigar, ArrayOfTests)
     }
 }
 
+TEST(Test_AlignmentTools_NormalizeCigar, RandomizedComparisonToM5)
+{
+    /*
+     * NormalizeCigar works directly on the CIGAR operations. Compare it to normalizing
+     * the M5 representation of the same alignment, on random alignments of low
+     * complexity sequences with many adjacent and repeated gaps.
+    */
+    const int32_t seed = 42;
+    const int32_t numTests = 2000;
+    std::mt19937 gen(seed);
+    const std::string alphabet = "ACGT";
+
+    for (int32_t testId = 0; testId < numTests; ++testId) {
+        // Smaller alphabets produce more homopolymers and repeats.
+        std::uniform_int_distribution<int32_t> distAlphabetSize(1, 4);
+        std::uniform_int_distribution<int32_t> distBase(0, distAlphabetSize(gen) - 1);
+        std::uniform_int_distribution<int32_t> distOp(0, 5);
+        std::uniform_int_distribution<int32_t> distMatchLen(1, 20);
+        std::uniform_int_distribution<int32_t> distDiffLen(1, 4);
+        std::uniform_int_distribution<int32_t> distNumOps(0, 30);
+
+        std::string query;
+        std::string target;
+        PacBio::BAM::Cigar cigar;
+        const int32_t numOps = distNumOps(gen);
+        for (int32_t i = 0; i < numOps; ++i) {
+            const int32_t op = distOp(gen);
+            if (op <= 2) {
+                const int32_t len = distMatchLen(gen);
+                for (int32_t j = 0; j < len; ++j) {
+                    const char base = alphabet[distBase(gen)];
+                    query += base;
+                    target += base;
+                    AppendToCigar(cigar, PacBio::BAM::CigarOperationType::SEQUENCE_MATCH, 1);
+                }
+            } else if (op == 3) {
+                const int32_t len = distDiffLen(gen);
+                for (int32_t j = 0; j < len; ++j) {
+                    const int32_t base = distBase(gen);
+                    const int32_t offset = 1 + std::uniform_int_distribution<int32_t>(0, 2)(gen);
+                    query += alphabet[base];
+                    target += alphabet[(base + offset) % 4];
+                    AppendToCigar(cigar, PacBio::BAM::CigarOperationType::SEQUENCE_MISMATCH, 1);
+                }
+            } else if (op == 4) {
+                const int32_t len = distDiffLen(gen);
+                for (int32_t j = 0; j < len; ++j) {
+                    query += alphabet[distBase(gen)];
+                }
+                AppendToCigar(cigar, PacBio::BAM::CigarOperationType::INSERTION, len);
+            } else {
+                const int32_t len = distDiffLen(gen);
+                for (int32_t j = 0; j < len; ++j) {
+                    target += alphabet[distBase(gen)];
+                }
+                AppendToCigar(cigar, PacBio::BAM::CigarOperationType::DELETION, len);
+            }
+        }
+
+        SCOPED_TRACE("testId = " + std::to_string(testId) + ", query = " + query +
+                     ", target = " + target + ", cigar = " + cigar.ToStdString());
+
+        // Expected results.
+        std::string queryAln;
+        std::string targetAln;
+        ConvertCigarToM5(query.c_str(), query.size(), target.c_str(), target.size(), cigar,
+                         queryAln, targetAln);
+        NormalizeAlignmentInPlace(queryAln, targetAln);
+        const PacBio::BAM::Cigar expected = ConvertM5ToCigar(queryAln, targetAln);
+
+        // Run the unit under test.
+        const PacBio::BAM::Cigar result =
+            NormalizeCigar(query.c_str(), query.size(), target.c_str(), target.size(), cigar);
+
+        // Evaluate.
+        ASSERT_EQ(expected, result);
+    }
+}
+
 TEST(Test_AlignmentTools_TrimCigar, ArrayOfTests)
 {
     // clang-format off
@@ -1015,6 +1095,10 @@ TEST(Test_AlignmentTools_TrimCigar, ArrayOfTests)
         */
         {"Clipping on front and back, mixed ops. Smaller window - 15bp with 8bp matches required.",
                     "1X1=1D2=2D1=1X1D1=2I2=1X5=2D1=2I1=2X1=3I100=1I100=1I100=3I1=2X1=2I1=2D5=1X2=2I1=1D1X1=2D2=1D1=1X", 15, 8, true, "2=2D1=1X1D1=2I2=1X5=2D1=2I1=2X1=3I100=1I100=1I100=3I1=2X1=2I1=2D5=1X2=2I1=1D1X1=2D2=", {2, 3, 2, 3}},
+        {"Large window, 1000bp with 990bp matches required.",
+                    "5X2000=3I1000=1X2000=7D", 1000, 990, true, "2000=3I1000=1X2000=", {5, 5, 0, 7}},
+        {"Large window, 1000bp with 990bp matches required, trim to non-match ops allowed.",
+                    "20X2000=3I1000=1X2000=7D", 1000, 990, false, "10X2000=3I1000=1X2000=7D", {10, 10, 0, 0}},
         {"Clipping on front and back, mixed ops. Larger window - 80bp with 80bp matches required.",
                     "1X1=1D2=2D1=1X1D1=2I2=1X5=2D1=2I1=2X1=3I100=1I100=1I100=3I1=2X1=2I1=2D5=1X2=2I1=1D1X1=2D2=1D1=1X", 80, 80, true, "100=1I100=1I100=", {27, 26, 27, 26}},
     };
@@ -1049,7 +1133,9 @@ TEST(Test_AlignmentTools_TrimCigar, ArrayOfTests_ShouldThrow)
 {
     // clang-format off
     std::vector<std::tuple<std::string, std::string, int32_t, int32_t, bool, bool, std::string, PacBio::Pancake::TrimmingInfo>> testData {
-        {"Window size is too large, 1000bp and max is 512bp.", "1I1000=", 1000, 15, true, true, "1000=", {1, 0, 0, 0}},
+        {"Negative window size.", "1I1000=", -1, 15, true, true, "", {0, 0, 0, 0}},
+        {"Window size larger than 512bp is allowed.", "1I2000=", 1000, 15, true, false, "2000=", {1, 0, 0, 0}},
+        {"Window not followed by another column is not considered.", "1I1000=", 1000, 15, true, false, "", {0, 0, 0, 0}},
     };
     // clang-format on
 
@@ -0,0 +1,338 @@
+#include <gtest/gtest.h>
+
+#include <pacbio/pancake/Breakpoint.h>
+#include <pacbio/pancake/MapperBase.h>
+#include <pacbio/pancake/MapperCLR.h>
+#include <pacbio/pancake/Overlap.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace BreakpointTests {
+
+std::unique_ptr<ChainedRegion> MakeRegion(int32_t Bid, bool Brev, int32_t Astart, int32_t Aend,
+                                          int32_t Alen, int32_t Bstart, int32_t Bend, int32_t Blen,
+                                          const std::string& cigar, int32_t priority)
+{
+    auto region = std::make_unique<ChainedRegion>();
+    region->mapping = createOverlap(0, Bid, 0.0f, 0.0f, false, Astart, Aend, Alen, Brev, Bstart,
+                                    Bend, Blen, 0, 0, OverlapType::Unknown, OverlapType::Unknown);
+    region->mapping->Cigar = PacBio::BAM::Cigar(cigar);
+    region->priority = priority;
+    return region;
+}
+
+std::string GenerateRandomSequence(int32_t len, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> dist(0, 3);
+    std::string ret(len, 'A');
+    for (int32_t i = 0; i < len; ++i) {
+        ret[i] = "ACGT"[dist(gen)];
+    }
+    return ret;
+}
+
+}  // namespace BreakpointTests
+
+TEST(Breakpoint, ExtractLargeIndelBreakpoints_ForwardStrand)
+{
+    auto region = BreakpointTests::MakeRegion(3, false, 10, 370, 400, 0, 410, 500,
+                                              "100=60D100=10I50=100I100=", 0);
+
+    std::vector<Breakpoint> result = ExtractLargeIndelBreakpoints(*region->mapping, 7, 50);
+
+    // clang-format off
+    std::vector<Breakpoint> expected = {
+        {BreakpointType::Deletion, 0, 110, 0, 7, 3, false, 100, 7, 3, false, 160, 60},
+        {BreakpointType::Insertion, 0, 270, 100, 7, 3, false, 310, 7, 3, false, 310, 100},
+    };
+    // clang-format on
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST(Breakpoint, ExtractLargeIndelBreakpoints_ReverseStrand)
+{
+    // Target coordinates are in the strand of the target, but should be reported in fwd.
+    auto region = BreakpointTests::MakeRegion(3, true, 0, 200, 200, 100, 360, 1000,
+                                              "100=60D100=", 0);
+
+    std::vector<Breakpoint> result = ExtractLargeIndelBreakpoints(*region->mapping, 0, 50);
+
+    // clang-format off
+    std::vector<Breakpoint> expected = {
+        {BreakpointType::Deletion, 0, 100, 0, 0, 3, true, 800, 0, 3, true, 740, 60},
+    };
+    // clang-format on
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST(Breakpoint, ExtractBreakpoints_ArrayOfTests)
+{
+    struct TestData
+    {
+        std::string testName;
+        std::vector<std::tuple<int32_t, bool, int32_t, int32_t, int32_t, int32_t, std::string,
+                               int32_t>>
+            mappings;  // Bid, Brev, Astart, Aend, Bstart, Bend, cigar, priority.
+        int32_t minSVLength = 50;
+        std::vector<Breakpoint> expected;
+    };
+
+    // clang-format off
+    std::vector<TestData> testData = {
+        {
+            "Empty input",
+            {},
+            50,
+            {},
+        },
+        {
+            "Single mapping without large indels",
+            {
+                {0, false, 0, 1000, 0, 1000, "1000=", 0},
+            },
+            50,
+            {},
+        },
+        {
+            "Two mappings on different targets, no gap in the query.",
+            {
+                {0, false, 0, 500, 100, 600, "500=", 0},
+                {1, false, 500, 1000, 2000, 2500, "500=", 0},
+            },
+            50,
+            {
+                {BreakpointType::SplitRead, 0, 500, 0, 0, 0, false, 600, 1, 1, false, 2000, 0},
+            },
+        },
+        {
+            "Secondary mappings are ignored.",
+            {
+                {0, false, 0, 500, 100, 600, "500=", 0},
+                {1, false, 500, 1000, 2000, 2500, "500=", 1},
+            },
+            50,
+            {},
+        },
+        {
+            "Colinear mappings with a large gap in the target are a deletion. Input order does not matter.",
+            {
+                {0, false, 500, 1000, 20500, 21000, "500=", 0},
+                {0, false, 0, 500, 0, 500, "500=", 0},
+            },
+            50,
+            {
+                {BreakpointType::Deletion, 0, 500, 0, 1, 0, false, 500, 0, 0, false, 20500, 20000},
+            },
+        },
+        {
+            "Colinear mappings with a large gap in the query are an insertion.",
+            {
+                {0, false, 0, 500, 0, 500, "500=", 0},
+                {0, false, 15500, 16000, 510, 1010, "500=", 0},
+            },
+            50,
+            {
+                {BreakpointType::Insertion, 0, 500, 15000, 0, 0, false, 500, 1, 0, false, 510, 14990},
+            },
+        },
+        {
+            "Colinear mappings with a small gap are not reported.",
+            {
+                {0, false, 0, 500, 0, 500, "500=", 0},
+                {0, false, 510, 1000, 530, 1020, "490=", 0},
+            },
+            50,
+            {},
+        },
+        {
+            "Strand switch, overlapping in the query. The junction is refined using the alignments.",
+            {
+                {0, false, 0, 520, 0, 520, "500=20X", 0},
+                {0, true, 500, 1000, 0, 500, "500=", 0},
+            },
+            50,
+            {
+                {BreakpointType::SplitRead, 0, 500, -20, 0, 0, false, 500, 1, 0, true, 10000, 0},
+            },
+        },
+    };
+    // clang-format on
+
+    for (const auto& data : testData) {
+        SCOPED_TRACE(data.testName);
+
+        std::vector<std::unique_ptr<ChainedRegion>> mappings;
+        for (const auto& m : data.mappings) {
+            mappings.emplace_back(BreakpointTests::MakeRegion(
+                std::get<0>(m), std::get<1>(m), std::get<2>(m), std::get<3>(m), 1000,
+                std::get<4>(m), std::get<5>(m), 10000, std::get<6>(m), std::get<7>(m)));
+        }
+
+        std::vector<Breakpoint> result = ExtractBreakpoints(mappings, 0, data.minSVLength);
+
+        EXPECT_EQ(data.expected, result);
+    }
+}
+
+TEST(Breakpoint, ExtractBreakpoints_RealignedJunctions)
+{
+    std::string target = BreakpointTests::GenerateRandomSequence(10000, 4321);
+    // The bases past the strand switch junction differ from the other side, so it is exact.
+    auto Complement = [](char base) {
+        return PacBio::Pancake::BaseToBaseComplement[static_cast<int32_t>(base)];
+    };
+    for (const char base : std::string("ACGT")) {
+        if (base != Complement(target[5499])) {
+            target[1500] = base;
+        }
+        if (Complement(base) != target[1499]) {
+            target[5500] = base;
+        }
+    }
+    const std::vector<FastaSequenceCached> targetSeqs = {
+        FastaSequenceCached("chr1", target.c_str(), target.size(), 0),
+    };
+
+    {
+        SCOPED_TRACE("Strand switch. Both mappings extend past the junction with mismatches.");
+        const std::string query =
+            target.substr(1000, 500) +
+            PacBio::Pancake::ReverseComplement(target.substr(5000, 500), 0, 500);
+        const FastaSequenceCached querySeq("query", query.c_str(), query.size(), 0);
+        std::vector<std::unique_ptr<ChainedRegion>> mappings;
+        mappings.emplace_back(
+            BreakpointTests::MakeRegion(0, false, 0, 520, 1000, 1000, 1520, 10000, "500=20X", 0));
+        mappings.emplace_back(
+            BreakpointTests::MakeRegion(0, true, 480, 1000, 1000, 4480, 5000, 10000, "20X500=", 0));
+
+        const std::vector<Breakpoint> expected = {
+            {BreakpointType::SplitRead, 0, 500, 0, 0, 0, false, 1500, 1, 0, true, 5500, 0},
+        };
+        EXPECT_EQ(expected, ExtractBreakpoints(mappings, querySeq, targetSeqs, 0, 50));
+    }
+
+    {
+        SCOPED_TRACE("Deletion with inserted bases. The mappings stop short of the junction.");
+        // The inserted bases match neither of the target flanks, so the junction is exact.
+        std::string inserted(30, 'A');
+        for (int32_t i = 0; i < 30; ++i) {
+            for (const char base : std::string("ACGT")) {
+                if (base != target[1500 + i] && base != target[2970 + i]) {
+                    inserted[i] = base;
+                    break;
+                }
+            }
+        }
+        const std::string query =
+            target.substr(1000, 500) + inserted + target.substr(3000, 470);
+        const FastaSequenceCached querySeq("query", query.c_str(), query.size(), 0);
+        std::vector<std::unique_ptr<ChainedRegion>> mappings;
+        mappings.emplace_back(
+            BreakpointTests::MakeRegion(0, false, 0, 480, 1000, 1000, 1480, 10000, "480=", 0));
+        mappings.emplace_back(
+            BreakpointTests::MakeRegion(0, false, 540, 1000, 1000, 3010, 3470, 10000, "460=", 0));
+
+        const std::vector<Breakpoint> expected = {
+            {BreakpointType::Deletion, 0, 500, 30, 0, 0, false, 1500, 1, 0, false, 3000, 1470},
+        };
+        EXPECT_EQ(expected, ExtractBreakpoints(mappings, querySeq, targetSeqs, 0, 50));
+    }
+}
+
+TEST(Breakpoint, FormatSATag)
+{
+    std::vector<std::unique_ptr<ChainedRegion>> mappings;
+    mappings.emplace_back(
+        BreakpointTests::MakeRegion(0, false, 0, 500, 1000, 100, 600, 10000, "500=", 0));
+    mappings.emplace_back(
+        BreakpointTests::MakeRegion(1, true, 500, 1000, 1000, 0, 510, 10000, "200=10D300=", 0));
+    mappings.emplace_back(
+        BreakpointTests::MakeRegion(1, false, 0, 1000, 1000, 0, 1000, 10000, "1000=", 1));
+    mappings[1]->mapping->EditDistance = 10;
+
+    const std::string target0 = "ACTG";
+    std::vector<FastaSequenceCached> targetSeqs = {
+        FastaSequenceCached("chr1", target0.c_str(), target0.size(), 0),
+        FastaSequenceCached("chr2", target0.c_str(), target0.size(), 1),
+    };
+
+    EXPECT_EQ("SA:Z:chr2,9491,-,300=10D200=500S,60,10;",
+              FormatSATag(mappings, 0, targetSeqs, false));
+    EXPECT_EQ("SA:Z:000000000,101,+,500=500S,60,0;", FormatSATag(mappings, 1, targetSeqs, true));
+    EXPECT_EQ("SA:Z:chr1,101,+,500=500S,60,0;chr2,9491,-,300=10D200=500S,60,10;",
+              FormatSATag(mappings, 2, targetSeqs, false));
+}
+
+TEST(Breakpoint, PrintBreakpointAsBEDPE)
+{
+    auto Print = [](const Breakpoint& bp) {
+        char* buffer = nullptr;
+        size_t bufferSize = 0;
+        FILE* fpOut = open_memstream(&buffer, &bufferSize);
+        PrintBreakpointAsBEDPE(fpOut, bp, "query", "chr1", "chr2");
+        fclose(fpOut);
+        const std::string ret(buffer, bufferSize);
+        free(buffer);
+        return ret;
+    };
+
+    {
+        SCOPED_TRACE("Forward strand on both sides.");
+        const Breakpoint bp{BreakpointType::SplitRead, 0, 500, 0, 0, 0, false, 1500, 1, 1, false,
+                            3000, 0};
+        EXPECT_EQ("chr1\t1499\t1500\tchr2\t3000\t3001\tquery\t.\t+\t+\tsplit\t500\t0\t0\n",
+                  Print(bp));
+    }
+
+    {
+        SCOPED_TRACE("Strand switch. The first base of the right mapping precedes the boundary.");
+        const Breakpoint bp{BreakpointType::SplitRead, 0, 500, 0, 0, 0, false, 1500, 1, 1, true,
+                            5500, 0};
+        EXPECT_EQ("chr1\t1499\t1500\tchr2\t5499\t5500\tquery\t.\t+\t-\tsplit\t500\t0\t0\n",
+                  Print(bp));
+    }
+
+    {
+        SCOPED_TRACE("Reverse strand on both sides.");
+        const Breakpoint bp{BreakpointType::Deletion, 0, 500, 0, 0, 0, true, 5000, 1, 0, true,
+                            4000, 1000};
+        EXPECT_EQ("chr1\t5000\t5001\tchr2\t3999\t4000\tquery\t.\t-\t-\tdel\t500\t0\t1000\n",
+                  Print(bp));
+    }
+}
+
+TEST(Breakpoint, ExtractBreakpoints_MapperCLR_LargeDeletion)
+{
+    // The query skips 12kbp of the target, which is more than the maxGap. The two
+    // halves should be mapped as primary and supplementary, and the junction reported as a deletion.
+    const std::string target = BreakpointTests::GenerateRandomSequence(30000, 1234);
+    const std::string query = target.substr(0, 10000) + target.substr(22000, 8000);
+
+    MapperCLRSettings settings;
+    settings.alignerTypeGlobal = AlignerType::KSW2;
+    settings.alignerTypeExt = AlignerType::KSW2;
+    MapperCLR mapper(settings);
+
+    std::vector<MapperBaseResult> result = mapper.MapAndAlign({target}, {query});
+    ASSERT_EQ(1, static_cast<int32_t>(result.size()));
+
+    const std::vector<Breakpoint> breakpoints = ExtractBreakpoints(result[0].mappings, 0, 50);
+    ASSERT_EQ(1, static_cast<int32_t>(breakpoints.size()));
+
+    const auto& bp = breakpoints[0];
+    EXPECT_EQ(BreakpointType::Deletion, bp.type);
+    EXPECT_EQ(10000, bp.queryPos);
+    EXPECT_EQ(10000, bp.leftTargetPos);
+    EXPECT_EQ(22000, bp.rightTargetPos);
+    EXPECT_EQ(12000, bp.svLen);
+}
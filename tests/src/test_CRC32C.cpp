@@ -0,0 +1,193 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/SeedDBReaderCachedBlock.h>
+#include <pacbio/pancake/SeedDBReaderRawBlock.h>
+#include <pacbio/pancake/SeedDBWriter.h>
+#include <pacbio/pancake/SeqDBReaderCachedBlock.h>
+#include <pacbio/pancake/SeqDBWriter.h>
+#include <pacbio/util/CRC32C.h>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace CRC32CTests {
+
+std::string CreateTempDir()
+{
+    std::string dirTemplate = testing::TempDir() + "pancake-crc32c-XXXXXX";
+    if (mkdtemp(&dirTemplate[0]) == nullptr) {
+        throw std::runtime_error("Could not create a temporary folder.");
+    }
+    return dirTemplate;
+}
+
+// Flips all bits of one byte of the file.
+void CorruptByte(const std::string& path, int64_t offset)
+{
+    FILE* fp = fopen(path.c_str(), "r+b");
+    ASSERT_NE(nullptr, fp);
+    ASSERT_EQ(0, fseek(fp, offset, SEEK_SET));
+    const int value = fgetc(fp);
+    ASSERT_NE(EOF, value);
+    ASSERT_EQ(0, fseek(fp, offset, SEEK_SET));
+    fputc(value ^ 0xFF, fp);
+    fclose(fp);
+}
+
+std::string RandomSeq(int32_t len, std::mt19937& rng)
+{
+    const char* bases = "ACGT";
+    std::string ret;
+    for (int32_t i = 0; i < len; ++i) {
+        ret += bases[rng() % 4];
+    }
+    return ret;
+}
+
+TEST(CRC32C, KnownValuesAndChaining)
+{
+    EXPECT_EQ(0u, CRC32C("", 0));
+    EXPECT_EQ(0xE3069283u, CRC32C("123456789", 9));
+    const std::vector<uint8_t> zeros(32, 0);
+    EXPECT_EQ(0x8A9136AAu, CRC32C(zeros.data(), zeros.size()));
+
+    // Checksumming in pieces gives the same result for all split points.
+    std::mt19937 rng(17);
+    const std::string data = RandomSeq(100, rng);
+    const uint32_t expected = CRC32C(data.data(), data.size());
+    for (size_t split = 0; split <= data.size(); ++split) {
+        const uint32_t first = CRC32C(data.data(), split);
+        EXPECT_EQ(expected, CRC32C(data.data() + split, data.size() - split, first));
+    }
+
+    // The block checksum depends on the order of the records.
+    const uint32_t a = CRC32C("A", 1);
+    const uint32_t b = CRC32C("B", 1);
+    EXPECT_NE(CombineRecordCRC32C(CombineRecordCRC32C(0, a), b),
+              CombineRecordCRC32C(CombineRecordCRC32C(0, b), a));
+}
+
+TEST(CRC32C, IndexColumn)
+{
+    EXPECT_EQ("crc32c=e3069283", CRC32CToString(0xE3069283));
+    EXPECT_EQ("crc32c=0000002a", CRC32CToString(42));
+    EXPECT_EQ(0xE3069283u, ParseCRC32C("crc32c=e3069283"));
+    EXPECT_EQ(0xE3069283u, ParseCRC32C("crc32c=E3069283"));
+    EXPECT_THROW({ ParseCRC32C("crc32c=e306928"); }, std::runtime_error);
+    EXPECT_THROW({ ParseCRC32C("crc32c=e306928g"); }, std::runtime_error);
+    EXPECT_THROW({ ParseCRC32C("md5=e3069283"); }, std::runtime_error);
+
+    // Both index parsers read the optional column, and the writer writes it back.
+    const std::string index =
+        "V\t0.1.0\n"
+        "C\t0\n"
+        "F\t0\ttest.seqdb.0.seq\t2\t300\t300\n"
+        "S\t0\tread1\t0\t0\t100\t100\t1\t0\t100\n"
+        "S\t1\tread2\t0\t100\t200\t200\t1\t0\t200\n"
+        "B\t0\t0\t1\t100\t100\n"
+        "B\t1\t1\t2\t200\t200\tcrc32c=0123abcd\n";
+    std::istringstream iss(index);
+    const auto cacheFromStream = LoadSeqDBIndexCache(iss, "test.seqdb");
+    FILE* fpIn = fmemopen(const_cast<char*>(index.c_str()), index.size(), "r");
+    const auto cacheFromFile = LoadSeqDBIndexCache(fpIn, "test.seqdb");
+    fclose(fpIn);
+    for (const auto* cache : {cacheFromStream.get(), cacheFromFile.get()}) {
+        EXPECT_FALSE(cache->blockLines[0].hasChecksum);
+        EXPECT_TRUE(cache->blockLines[1].hasChecksum);
+        EXPECT_EQ(0x0123ABCDu, cache->blockLines[1].checksum);
+    }
+
+    char* buffer = nullptr;
+    size_t bufferSize = 0;
+    FILE* fpOut = open_memstream(&buffer, &bufferSize);
+    WriteSeqDBIndexCache(fpOut, *cacheFromStream);
+    fclose(fpOut);
+    const std::string written(buffer, bufferSize);
+    free(buffer);
+    EXPECT_EQ(index, written);
+}
+
+TEST(CRC32C, SeqDBCorruptionIsDetected)
+{
+    std::mt19937 rng(5);
+    const std::vector<std::string> seqs = {RandomSeq(100, rng), RandomSeq(100, rng),
+                                           RandomSeq(100, rng)};
+
+    for (const bool useCompression : {false, true}) {
+        SCOPED_TRACE("useCompression = " + std::to_string(useCompression));
+        const std::string prefix = CreateTempDir() + "/reads";
+        {
+            // Two blocks: the first two sequences, and the last one.
+            auto writer = CreateSeqDBWriter(prefix, useCompression, 1000, 150, false);
+            for (size_t i = 0; i < seqs.size(); ++i) {
+                writer->AddSequence("read" + std::to_string(i), seqs[i]);
+            }
+        }
+
+        std::shared_ptr<SeqDBIndexCache> seqDBCache = LoadSeqDBIndexCache(prefix + ".seqdb");
+        ASSERT_EQ(2, static_cast<int32_t>(seqDBCache->blockLines.size()));
+        EXPECT_TRUE(seqDBCache->blockLines[0].hasChecksum);
+        EXPECT_TRUE(seqDBCache->blockLines[1].hasChecksum);
+
+        SeqDBReaderCachedBlock reader(seqDBCache, false);
+        reader.LoadBlocks({0, 1});
+        ASSERT_EQ(3, static_cast<int32_t>(reader.records().size()));
+        const auto& record = reader.GetSequence(2);
+        EXPECT_EQ(seqs[2], std::string(record.Bases(), record.Size()));
+
+        // Corrupt the last sequence. Only its block fails to load.
+        const auto& sl = seqDBCache->GetSeqLine(2);
+        CorruptByte(prefix + ".seqdb.0.seq", sl.fileOffset + sl.numBytes / 2);
+        EXPECT_NO_THROW({ reader.LoadBlocks({0}); });
+        EXPECT_THROW({ reader.LoadBlocks({1}); }, std::runtime_error);
+        EXPECT_THROW({ reader.LoadBlocks({0, 1}); }, std::runtime_error);
+
+        // Loading the individual sequences does not verify the blocks.
+        EXPECT_NO_THROW({ reader.LoadSequences(std::vector<int32_t>{2}); });
+    }
+}
+
+TEST(CRC32C, SeedDBCorruptionIsDetected)
+{
+    std::mt19937 rng(7);
+    std::vector<std::vector<Int128t>> seeds(3);
+    for (auto& seqSeeds : seeds) {
+        for (int32_t i = 0; i < 10; ++i) {
+            seqSeeds.emplace_back((static_cast<Int128t>(rng()) << 64) | rng());
+        }
+    }
+
+    const std::string prefix = CreateTempDir() + "/reads";
+    {
+        SeedDB::SeedDBParameters params;
+        auto writer = CreateSeedDBWriter(prefix, false, params);
+        writer->WriteSeeds("read0", 0, 100, seeds[0]);
+        writer->WriteSeeds("read1", 1, 100, seeds[1]);
+        writer->MarkBlockEnd();
+        writer->WriteSeeds("read2", 2, 100, seeds[2]);
+    }
+
+    std::shared_ptr<SeedDBIndexCache> seedDBCache = LoadSeedDBIndexCache(prefix + ".seeddb");
+    ASSERT_EQ(2, static_cast<int32_t>(seedDBCache->blockLines.size()));
+    EXPECT_TRUE(seedDBCache->blockLines[0].hasChecksum);
+    EXPECT_TRUE(seedDBCache->blockLines[1].hasChecksum);
+
+    SeedDBReaderCachedBlock readerCached(seedDBCache, {0, 1});
+    SeedDBReaderRawBlock readerRaw(seedDBCache);
+    EXPECT_EQ(20, static_cast<int32_t>(readerRaw.GetBlock(0).size()));
+
+    // Corrupt the seeds of the first sequence.
+    CorruptByte(prefix + ".seeddb.0.seeds", 37);
+    EXPECT_THROW({ readerCached.LoadBlock({0}); }, std::runtime_error);
+    EXPECT_NO_THROW({ readerCached.LoadBlock({1}); });
+    EXPECT_THROW({ readerRaw.GetBlock(0); }, std::runtime_error);
+    EXPECT_NO_THROW({ readerRaw.GetBlock(1); });
+}
+
+}  // namespace CRC32CTests
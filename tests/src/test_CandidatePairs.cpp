@@ -0,0 +1,120 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/CandidatePairs.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace CandidatePairsTests {
+
+std::unique_ptr<SeqDBIndexCache> MakeSeqDBCache(const std::vector<std::string>& names)
+{
+    std::ostringstream oss;
+    oss << "V\t0.1.0\nC\t0\nF\t0\tdummy.seqdb.0.seq\t" << names.size() << "\t"
+        << names.size() * 100 << "\t" << names.size() * 100 << "\n";
+    for (size_t i = 0; i < names.size(); ++i) {
+        oss << "S\t" << i << "\t" << names[i] << "\t0\t" << i * 100 << "\t100\t100\t1\t0\t100\n";
+    }
+    oss << "B\t0\t0\t" << names.size() << "\t" << names.size() * 100 << "\t"
+        << names.size() * 100 << "\n";
+    std::istringstream is(oss.str());
+    auto ret = LoadSeqDBIndexCache(is, "dummy.seqdb");
+    ret->ConstructHeaderLookup();
+    return ret;
+}
+
+TEST(CandidatePairs, ParseCandidateStrand)
+{
+    EXPECT_EQ(CandidateStrand::Forward, ParseCandidateStrand("+"));
+    EXPECT_EQ(CandidateStrand::Forward, ParseCandidateStrand("0"));
+    EXPECT_EQ(CandidateStrand::Reverse, ParseCandidateStrand("-"));
+    EXPECT_EQ(CandidateStrand::Reverse, ParseCandidateStrand("1"));
+    EXPECT_EQ(CandidateStrand::Any, ParseCandidateStrand("*"));
+    EXPECT_THROW({ ParseCandidateStrand("fwd"); }, std::runtime_error);
+}
+
+TEST(CandidatePairs, ParseCandidatePairLine)
+{
+    std::string query;
+    std::string target;
+    CandidateStrand strand = CandidateStrand::Any;
+
+    EXPECT_TRUE(ParseCandidatePairLine("read1\tread2", query, target, strand));
+    EXPECT_EQ("read1", query);
+    EXPECT_EQ("read2", target);
+    EXPECT_EQ(CandidateStrand::Any, strand);
+
+    EXPECT_TRUE(ParseCandidatePairLine("read3 read4 -", query, target, strand));
+    EXPECT_EQ("read3", query);
+    EXPECT_EQ("read4", target);
+    EXPECT_EQ(CandidateStrand::Reverse, strand);
+
+    // Empty lines and comments are skipped.
+    EXPECT_FALSE(ParseCandidatePairLine("", query, target, strand));
+    EXPECT_FALSE(ParseCandidatePairLine("  ", query, target, strand));
+    EXPECT_FALSE(ParseCandidatePairLine("# query target", query, target, strand));
+
+    // Malformed lines.
+    EXPECT_THROW({ ParseCandidatePairLine("read1", query, target, strand); }, std::runtime_error);
+    EXPECT_THROW({ ParseCandidatePairLine("read1 read2 + extra", query, target, strand); },
+                 std::runtime_error);
+}
+
+TEST(CandidatePairs, NormalizeCandidatePairs)
+{
+    std::vector<CandidatePair> pairs = {
+        {2, 0, CandidateStrand::Forward}, {0, 1, CandidateStrand::Reverse},
+        {0, 1, CandidateStrand::Reverse}, {1, 2, CandidateStrand::Forward},
+        {1, 2, CandidateStrand::Reverse}, {0, 0, CandidateStrand::Any},
+    };
+    const std::vector<CandidatePair> expected = {
+        {0, 0, CandidateStrand::Any},
+        {0, 1, CandidateStrand::Reverse},
+        {1, 2, CandidateStrand::Any},
+        {2, 0, CandidateStrand::Forward},
+    };
+    NormalizeCandidatePairs(pairs);
+    EXPECT_EQ(expected, pairs);
+}
+
+TEST(CandidatePairs, ReadCandidatePairsByName)
+{
+    const auto queryCache = MakeSeqDBCache({"q0", "q1"});
+    const auto targetCache = MakeSeqDBCache({"t0", "t1", "t2"});
+
+    std::istringstream is("# Comment\nq1 t2 +\n\nq0\tt0\nq0 t1 1\n");
+    const std::vector<CandidatePair> expected = {
+        {1, 2, CandidateStrand::Forward},
+        {0, 0, CandidateStrand::Any},
+        {0, 1, CandidateStrand::Reverse},
+    };
+    EXPECT_EQ(expected, ReadCandidatePairs(is, *queryCache, *targetCache, false));
+
+    // Unknown names throw.
+    std::istringstream isUnknown("q0 t3\n");
+    EXPECT_THROW({ ReadCandidatePairs(isUnknown, *queryCache, *targetCache, false); },
+                 std::runtime_error);
+}
+
+TEST(CandidatePairs, ReadCandidatePairsById)
+{
+    const auto queryCache = MakeSeqDBCache({"q0", "q1"});
+    const auto targetCache = MakeSeqDBCache({"t0", "t1", "t2"});
+
+    std::istringstream is("1 2\n0 0 -\n");
+    const std::vector<CandidatePair> expected = {
+        {1, 2, CandidateStrand::Any},
+        {0, 0, CandidateStrand::Reverse},
+    };
+    EXPECT_EQ(expected, ReadCandidatePairs(is, *queryCache, *targetCache, true));
+
+    // IDs out of bounds throw.
+    std::istringstream isOutOfBounds("2 0\n");
+    EXPECT_THROW({ ReadCandidatePairs(isOutOfBounds, *queryCache, *targetCache, true); },
+                 std::runtime_error);
+}
+
+}  // namespace CandidatePairsTests
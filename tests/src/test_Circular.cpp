@@ -0,0 +1,233 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/Circular.h>
+#include <pacbio/pancake/Minimizers.h>
+#include <pacbio/pancake/SeqDBIndexCache.h>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace CircularTests {
+
+std::string GenerateRandomSequence(int32_t len, std::mt19937& rng)
+{
+    const char* bases = "ACGT";
+    std::string ret(len, 'A');
+    for (auto& c : ret) {
+        c = bases[rng() % 4];
+    }
+    return ret;
+}
+
+// Seeds as (pos, key, isRev), with the positions rotated by the given offset.
+std::set<std::tuple<int32_t, uint64_t, bool>> ToRotatedSet(
+    const std::vector<SeedDB::SeedRaw>& seeds, int32_t rotation, int32_t seqLen)
+{
+    std::set<std::tuple<int32_t, uint64_t, bool>> ret;
+    for (const auto& seedRaw : seeds) {
+        const SeedDB::Seed seed(seedRaw);
+        ret.emplace(std::make_tuple((seed.pos + rotation) % seqLen, seed.key, seed.seqRev));
+    }
+    return ret;
+}
+
+TEST(Circular, GenerateSeedsCircular)
+{
+    std::mt19937 rng(19);
+    const std::string seq = GenerateRandomSequence(3000, rng);
+    const int32_t seqLen = seq.size();
+    const int32_t rotation = 1234;
+    const std::string rotated = seq.substr(rotation) + seq.substr(0, rotation);
+
+    SeedDB::SeedDBParameters params;
+    params.KmerSize = 15;
+    params.MinimizerWindow = 10;
+
+    std::vector<SeedDB::SeedRaw> seeds;
+    std::vector<SeedDB::SeedRaw> rotatedSeeds;
+    SeedDB::GenerateSeedsCircular(seeds, reinterpret_cast<const uint8_t*>(seq.c_str()), seqLen,
+                                  0, 0, params);
+    SeedDB::GenerateSeedsCircular(rotatedSeeds,
+                                  reinterpret_cast<const uint8_t*>(rotated.c_str()), seqLen, 0,
+                                  0, params);
+
+    // The seeds do not depend on where the origin of a circular sequence is.
+    EXPECT_EQ(ToRotatedSet(seeds, seqLen - rotation, seqLen),
+              ToRotatedSet(rotatedSeeds, 0, seqLen));
+
+    // All seeds begin within the sequence, and some span the origin.
+    int32_t numSpanningOrigin = 0;
+    for (const auto& seedRaw : seeds) {
+        const SeedDB::Seed seed(seedRaw);
+        EXPECT_LT(seed.pos, seqLen);
+        numSpanningOrigin += (seed.pos + static_cast<int32_t>(seed.span)) > seqLen;
+    }
+    EXPECT_GT(numSpanningOrigin, 0);
+
+    // The same seeds as the linear sequence, away from the origin.
+    std::vector<SeedDB::SeedRaw> linearSeeds;
+    SeedDB::GenerateSeeds(linearSeeds, reinterpret_cast<const uint8_t*>(seq.c_str()), seqLen, 0,
+                          0, params);
+    std::set<std::tuple<int32_t, uint64_t, bool>> linearInner;
+    std::set<std::tuple<int32_t, uint64_t, bool>> circularInner;
+    for (const auto& seed : ToRotatedSet(linearSeeds, 0, seqLen)) {
+        if (std::get<0>(seed) >= 100 && std::get<0>(seed) < (seqLen - 100)) {
+            linearInner.emplace(seed);
+        }
+    }
+    for (const auto& seed : ToRotatedSet(seeds, 0, seqLen)) {
+        if (std::get<0>(seed) >= 100 && std::get<0>(seed) < (seqLen - 100)) {
+            circularInner.emplace(seed);
+        }
+    }
+    EXPECT_EQ(linearInner, circularInner);
+}
+
+TEST(Circular, UnrollCircularSeeds)
+{
+    // Sequence 0 is linear, sequence 1 is circular with length 100.
+    const std::vector<SeedDB::SeedRaw> seeds = {
+        SeedDB::Seed::Encode(1, 15, 0, 10, false),
+        SeedDB::Seed::Encode(2, 15, 1, 0, false),
+        SeedDB::Seed::Encode(3, 15, 1, 50, true),
+        SeedDB::Seed::Encode(4, 15, 1, 95, false),
+    };
+    const std::vector<int32_t> circularLengths = {0, 100};
+    const std::vector<SeedDB::SeedRaw> results =
+        UnrollCircularSeeds(seeds.data(), seeds.size(), circularLengths);
+
+    // The copy of the seed at 95 would end past the unrolled sequence.
+    const std::vector<SeedDB::SeedRaw> expected = {
+        SeedDB::Seed::Encode(1, 15, 0, 10, false),  SeedDB::Seed::Encode(2, 15, 1, 0, false),
+        SeedDB::Seed::Encode(3, 15, 1, 50, true),   SeedDB::Seed::Encode(4, 15, 1, 95, false),
+        SeedDB::Seed::Encode(2, 15, 1, 100, false), SeedDB::Seed::Encode(3, 15, 1, 150, true),
+    };
+    EXPECT_EQ(expected, results);
+
+    EXPECT_TRUE(UnrollCircularSeeds(nullptr, 0, circularLengths).empty());
+}
+
+TEST(Circular, WrapCircularOverlaps)
+{
+    // Target 1 is circular, with length 1000, and was unrolled to 2000 bases.
+    const std::vector<int32_t> circularLengths = {0, 1000};
+    std::vector<OverlapPtr> overlaps;
+    // A query which spans the origin, on the fwd strand.
+    overlaps.emplace_back(createOverlap(0, 1, -300, 99.0, false, 0, 300, 300, false, 900, 1200,
+                                        2000, 0, 10, OverlapType::FivePrime,
+                                        OverlapType::ThreePrime));
+    // The same query on the rev strand. The fwd coordinates of the target are [900, 1200).
+    overlaps.emplace_back(createOverlap(2, 1, -300, 99.0, false, 0, 300, 300, true, 800, 1100,
+                                        2000, 0, 10, OverlapType::FivePrime,
+                                        OverlapType::ThreePrime));
+    // A query away from the origin, found in both copies. The second copy is worse.
+    overlaps.emplace_back(createOverlap(3, 1, -200, 99.0, false, 50, 250, 300, false, 1100, 1300,
+                                        2000, 0, 10, OverlapType::Internal, OverlapType::Internal));
+    overlaps.emplace_back(createOverlap(3, 1, -300, 99.0, false, 0, 300, 300, false, 50, 350,
+                                        2000, 0, 10, OverlapType::FivePrime,
+                                        OverlapType::ThreePrime));
+    // An overlap with a linear target is not changed.
+    overlaps.emplace_back(createOverlap(4, 0, -300, 99.0, false, 0, 300, 300, false, 0, 300, 500,
+                                        0, 10, OverlapType::Contained, OverlapType::Contains));
+    // The flipped versions of the first two overlaps: the target is the A-read.
+    overlaps.emplace_back(createOverlap(overlaps[0]));
+    overlaps.back()->Flip();
+    overlaps.emplace_back(createOverlap(overlaps[1]));
+    overlaps.back()->Flip();
+
+    WrapCircularOverlaps(overlaps, circularLengths, 0, 100);
+
+    ASSERT_EQ(6, overlaps.size());
+    EXPECT_EQ(900, overlaps[0]->Bstart);
+    EXPECT_EQ(1200, overlaps[0]->Bend);
+    EXPECT_EQ(1000, overlaps[0]->Blen);
+    EXPECT_EQ(OverlapType::Contained, overlaps[0]->Atype);
+    EXPECT_EQ(OverlapType::Contains, overlaps[0]->Btype);
+
+    // The start is wrapped in the reverse strand as well.
+    EXPECT_EQ(800, overlaps[1]->Bstart);
+    EXPECT_EQ(1100, overlaps[1]->Bend);
+    EXPECT_EQ(900, overlaps[1]->BstartFwd());
+    EXPECT_EQ(1200, overlaps[1]->BendFwd());
+    EXPECT_EQ(1000, overlaps[1]->Blen);
+
+    EXPECT_EQ(3, overlaps[2]->Aid);
+    EXPECT_EQ(50, overlaps[2]->Bstart);
+    EXPECT_EQ(350, overlaps[2]->Bend);
+    EXPECT_EQ(OverlapType::Contained, overlaps[2]->Atype);
+
+    EXPECT_EQ(0, overlaps[3]->Bid);
+    EXPECT_EQ(500, overlaps[3]->Blen);
+    EXPECT_EQ(OverlapType::Contained, overlaps[3]->Atype);
+
+    EXPECT_TRUE(overlaps[4]->IsFlipped);
+    EXPECT_EQ(1, overlaps[4]->Aid);
+    EXPECT_EQ(900, overlaps[4]->Astart);
+    EXPECT_EQ(1200, overlaps[4]->Aend);
+    EXPECT_EQ(1000, overlaps[4]->Alen);
+    EXPECT_EQ(OverlapType::Contains, overlaps[4]->Atype);
+    EXPECT_EQ(OverlapType::Contained, overlaps[4]->Btype);
+
+    EXPECT_TRUE(overlaps[5]->IsFlipped);
+    EXPECT_EQ(1, overlaps[5]->Aid);
+    EXPECT_FALSE(overlaps[5]->Arev);
+    EXPECT_EQ(900, overlaps[5]->Astart);
+    EXPECT_EQ(1200, overlaps[5]->Aend);
+    EXPECT_TRUE(overlaps[5]->Brev);
+    EXPECT_EQ(0, overlaps[5]->BstartFwd());
+    EXPECT_EQ(300, overlaps[5]->BendFwd());
+
+    // Flipping back restores the wrapped coordinates of the primary overlap.
+    overlaps[5]->Flip();
+    EXPECT_EQ(800, overlaps[5]->Bstart);
+    EXPECT_EQ(1100, overlaps[5]->Bend);
+}
+
+TEST(Circular, SeqDBIndexCacheFlag)
+{
+    const std::string index =
+        "V\t0.1.0\n"
+        "C\t0\n"
+        "F\t0\ttest.seqdb.0.seq\t2\t300\t300\n"
+        "S\t0\tchr\t0\t0\t100\t100\t1\t0\t100\n"
+        "S\t1\tplasmid\t0\t100\t200\t200\t1\t0\t200\tcircular\n"
+        "B\t0\t0\t2\t300\t300\n";
+
+    std::istringstream iss(index);
+    const auto cacheFromStream = LoadSeqDBIndexCache(iss, "test.seqdb");
+    EXPECT_FALSE(cacheFromStream->seqLines[0].isCircular);
+    EXPECT_TRUE(cacheFromStream->seqLines[1].isCircular);
+
+    // The writer writes the flag back.
+    char* buffer = nullptr;
+    size_t bufferSize = 0;
+    FILE* fpOut = open_memstream(&buffer, &bufferSize);
+    WriteSeqDBIndexCache(fpOut, *cacheFromStream);
+    fclose(fpOut);
+    const std::string written(buffer, bufferSize);
+    free(buffer);
+    EXPECT_EQ(index, written);
+
+    FILE* fpIn = fmemopen(const_cast<char*>(index.c_str()), index.size(), "r");
+    const auto cacheFromFile = LoadSeqDBIndexCache(fpIn, "test.seqdb");
+    fclose(fpIn);
+    EXPECT_FALSE(cacheFromFile->seqLines[0].isCircular);
+    EXPECT_TRUE(cacheFromFile->seqLines[1].isCircular);
+
+    const std::string badIndex =
+        "V\t0.1.0\n"
+        "C\t0\n"
+        "F\t0\ttest.seqdb.0.seq\t1\t100\t100\n"
+        "S\t0\tchr\t0\t0\t100\t100\t1\t0\t100\tlinear\n";
+    std::istringstream issBad(badIndex);
+    EXPECT_THROW({ LoadSeqDBIndexCache(issBad, "test.seqdb"); }, std::runtime_error);
+}
+
+}  // namespace CircularTests
@@ -0,0 +1,227 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/DuplicateReads.h>
+#include <pacbio/util/Util.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace DuplicateReadsTests {
+
+std::string GenerateRandomSequence(int32_t len, std::mt19937& rng)
+{
+    const char* bases = "ACGT";
+    std::string ret(len, 'A');
+    for (auto& c : ret) {
+        c = bases[rng() % 4];
+    }
+    return ret;
+}
+
+// Introduces the given number of substitutions at random positions.
+std::string Mutate(const std::string& seq, int32_t numDiffs, std::mt19937& rng)
+{
+    const char* bases = "ACGT";
+    std::string ret = seq;
+    for (int32_t i = 0; i < numDiffs; ++i) {
+        const int32_t pos = rng() % ret.size();
+        char base = ret[pos];
+        while (base == ret[pos]) {
+            base = bases[rng() % 4];
+        }
+        ret[pos] = base;
+    }
+    return ret;
+}
+
+std::vector<ReadFingerprint> ComputeFingerprints(const std::vector<std::string>& seqs,
+                                                 int32_t kmerSize, int32_t sketchSize)
+{
+    std::vector<ReadFingerprint> ret;
+    for (const auto& seq : seqs) {
+        ret.emplace_back(ComputeReadFingerprint(seq.c_str(), seq.size(), kmerSize, sketchSize));
+    }
+    return ret;
+}
+
+TEST(DuplicateReads, ComputeReadFingerprint)
+{
+    std::mt19937 rng(7);
+    const std::string seq = GenerateRandomSequence(2000, rng);
+    const std::string seqRev = PacBio::Pancake::ReverseComplement(seq, 0, seq.size());
+    std::string seqLower = seq;
+    for (auto& c : seqLower) {
+        c = std::tolower(c);
+    }
+
+    const ReadFingerprint fp = ComputeReadFingerprint(seq.c_str(), seq.size(), 15, 32);
+    const ReadFingerprint fpRev = ComputeReadFingerprint(seqRev.c_str(), seqRev.size(), 15, 32);
+    const ReadFingerprint fpLower =
+        ComputeReadFingerprint(seqLower.c_str(), seqLower.size(), 15, 32);
+
+    // The fingerprints are strand-canonical, and the strand flag tells them apart.
+    EXPECT_EQ(fp.hash, fpRev.hash);
+    EXPECT_NE(fp.isRev, fpRev.isRev);
+    EXPECT_EQ(fp.sketch, fpRev.sketch);
+    EXPECT_EQ(fp.hash, fpLower.hash);
+    EXPECT_EQ(fp.sketch, fpLower.sketch);
+    EXPECT_EQ(2000, fp.length);
+
+    // The sketch is sorted and distinct.
+    ASSERT_EQ(32, fp.sketch.size());
+    for (size_t i = 1; i < fp.sketch.size(); ++i) {
+        EXPECT_LT(fp.sketch[i - 1], fp.sketch[i]);
+    }
+
+    // A single substitution changes the whole-read hash.
+    const std::string mutated = Mutate(seq, 1, rng);
+    const ReadFingerprint fpMutated =
+        ComputeReadFingerprint(mutated.c_str(), mutated.size(), 15, 32);
+    EXPECT_NE(fp.hash, fpMutated.hash);
+
+    // Too short for a single k-mer.
+    const ReadFingerprint fpShort = ComputeReadFingerprint("ACGTN", 5, 15, 32);
+    EXPECT_TRUE(fpShort.sketch.empty());
+    EXPECT_EQ(5, fpShort.length);
+
+    EXPECT_THROW({ ComputeReadFingerprint("ACGT", 4, 33, 32); }, std::runtime_error);
+}
+
+TEST(DuplicateReads, EstimateSketchJaccard)
+{
+    EXPECT_EQ(1.0, EstimateSketchJaccard({1, 2, 3, 4}, {1, 2, 3, 4}, 4));
+    EXPECT_EQ(0.0, EstimateSketchJaccard({1, 3, 5, 7}, {2, 4, 6, 8}, 4));
+    // The union sketch is {1, 2, 3, 4}, of which 1 and 3 are shared.
+    EXPECT_EQ(0.5, EstimateSketchJaccard({1, 3, 5}, {1, 2, 3, 4}, 4));
+    EXPECT_EQ(0.0, EstimateSketchJaccard({}, {}, 4));
+}
+
+TEST(DuplicateReads, FindCandidatesAndGroup)
+{
+    std::mt19937 rng(11);
+    const std::string seqA = GenerateRandomSequence(3000, rng);
+    const std::string seqB = GenerateRandomSequence(3000, rng);
+    const std::string seqC = GenerateRandomSequence(2500, rng);
+
+    const std::vector<std::string> seqs = {
+        seqA,                                                // 0
+        seqB,                                                // 1
+        PacBio::Pancake::ReverseComplement(seqA, 0, 3000),  // 2: exact dup of 0, rev strand.
+        Mutate(seqB, 10, rng),                               // 3: near dup of 1.
+        seqC,                                                // 4
+        seqA,                                                // 5: exact dup of 0.
+        seqB.substr(0, 2950),                                // 6: near containment in 1.
+        seqC.substr(0, 1500),                                // 7: too short to be a dup of 4.
+    };
+    const std::vector<ReadFingerprint> fps = ComputeFingerprints(seqs, 15, 64);
+
+    const std::vector<std::pair<int32_t, int32_t>> exact = FindExactDuplicateCandidates(fps);
+    const std::vector<std::pair<int32_t, int32_t>> expectedExact = {{0, 2}, {0, 5}};
+    EXPECT_EQ(expectedExact, exact);
+
+    const std::vector<std::pair<int32_t, int32_t>> near =
+        FindNearDuplicateCandidates(fps, {0, 1, 3, 4, 6, 7}, 0.95, 0.5, 64);
+    const std::vector<std::pair<int32_t, int32_t>> expectedNear = {{1, 3}, {6, 1}, {6, 3}};
+    EXPECT_EQ(expectedNear, near);
+
+    // Confirm the candidates with the alignment, and group them.
+    DuplicateGroups groups(seqs.size());
+    for (const auto& candidates : {exact, near}) {
+        for (const auto& pair : candidates) {
+            const auto& a = seqs[pair.first];
+            const auto& b = seqs[pair.second];
+            bool isRev = false;
+            const int32_t diffs =
+                AlignDuplicateCandidate(a.c_str(), a.size(), b.c_str(), b.size(), 0.01, isRev);
+            EXPECT_GE(diffs, 0);
+            if (diffs >= 0) {
+                groups.Join(pair.first, pair.second);
+            }
+            EXPECT_EQ(pair == std::make_pair(0, 2), isRev);
+        }
+    }
+    const std::vector<int32_t> expectedReps = {0, 1, 0, 1, 4, 0, 1, 7};
+    EXPECT_EQ(expectedReps, groups.Representatives(fps));
+}
+
+TEST(DuplicateReads, FindNearDuplicateCandidates_RecallOfMutatedCopies)
+{
+    // Each random read has a copy with 0.5% substitutions, on a random strand. With the default
+    // k-mer and sketch sizes, every copy should be found and no unrelated reads paired.
+    const int32_t numReads = 200;
+    const int32_t kmerSize = 21;
+    const int32_t sketchSize = 32;
+    std::mt19937 rng(17);
+    std::vector<std::string> seqs;
+    for (int32_t i = 0; i < numReads; ++i) {
+        const std::string seq = GenerateRandomSequence(5000, rng);
+        std::string copy = Mutate(seq, 25, rng);
+        if (rng() % 2) {
+            copy = PacBio::Pancake::ReverseComplement(copy, 0, copy.size());
+        }
+        seqs.emplace_back(seq);
+        seqs.emplace_back(copy);
+    }
+    const std::vector<ReadFingerprint> fps = ComputeFingerprints(seqs, kmerSize, sketchSize);
+    std::vector<int32_t> readIds(seqs.size());
+    for (int32_t i = 0; i < static_cast<int32_t>(readIds.size()); ++i) {
+        readIds[i] = i;
+    }
+
+    const std::vector<std::pair<int32_t, int32_t>> results =
+        FindNearDuplicateCandidates(fps, readIds, 0.95, 0.5, sketchSize);
+
+    int32_t numFound = 0;
+    for (const auto& pair : results) {
+        EXPECT_EQ(pair.first / 2, pair.second / 2);
+        numFound += (pair.first / 2) == (pair.second / 2);
+    }
+    EXPECT_EQ(numReads, numFound);
+}
+
+TEST(DuplicateReads, AlignDuplicateCandidate)
+{
+    std::mt19937 rng(13);
+    const std::string seqA = GenerateRandomSequence(1000, rng);
+    const std::string seqB = Mutate(seqA, 5, rng);
+    const std::string seqC = GenerateRandomSequence(1000, rng);
+
+    bool isRev = true;
+    EXPECT_EQ(0, AlignDuplicateCandidate(seqA.c_str(), 1000, seqA.c_str(), 1000, 0.0, isRev));
+    EXPECT_FALSE(isRev);
+
+    const int32_t diffs =
+        AlignDuplicateCandidate(seqA.c_str(), 1000, seqB.c_str(), 1000, 0.01, isRev);
+    EXPECT_GT(diffs, 0);
+    EXPECT_LE(diffs, 5);
+
+    // Over the diff budget, or unrelated.
+    EXPECT_EQ(-1, AlignDuplicateCandidate(seqA.c_str(), 1000, seqB.c_str(), 1000, 0.001, isRev));
+    EXPECT_EQ(-1, AlignDuplicateCandidate(seqA.c_str(), 1000, seqC.c_str(), 1000, 0.01, isRev));
+    EXPECT_EQ(-1, AlignDuplicateCandidate(seqA.c_str(), 1000, "", 0, 0.01, isRev));
+}
+
+TEST(DuplicateReads, RepresentativeIsLongest)
+{
+    std::vector<ReadFingerprint> fps(4);
+    fps[0].length = 100;
+    fps[1].length = 200;
+    fps[2].length = 200;
+    fps[3].length = 50;
+
+    DuplicateGroups groups(4);
+    groups.Join(3, 2);
+    groups.Join(2, 1);
+    groups.Join(0, 3);
+    EXPECT_EQ(groups.Find(0), groups.Find(2));
+
+    // Ties go to the lowest ID.
+    const std::vector<int32_t> expected = {1, 1, 1, 1};
+    EXPECT_EQ(expected, groups.Representatives(fps));
+}
+
+}  // namespace DuplicateReadsTests
@@ -0,0 +1,250 @@
+// Authors: Ivan Sovic
+
+#include <PancakeTestData.h>
+#include <gtest/gtest.h>
+#include <pacbio/pancake/HPCCoordinateMap.h>
+#include <pacbio/pancake/SeqDBReaderCachedBlock.h>
+#include <pacbio/util/RunLengthEncoding.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace HPCCoordinateMapTests {
+
+// Random sequence with long homopolymers, with some runs over 255 bases.
+std::string GenerateHomopolymerSequence(int32_t numRuns, std::mt19937& rng)
+{
+    const char* bases = "ACGT";
+    std::string ret;
+    int32_t prevBase = -1;
+    for (int32_t i = 0; i < numRuns; ++i) {
+        int32_t base = rng() % 4;
+        while (base == prevBase) {
+            base = rng() % 4;
+        }
+        const int32_t runLen = ((rng() % 50) == 0) ? (250 + rng() % 300) : (1 + rng() % 6);
+        ret.append(runLen, bases[base]);
+        prevBase = base;
+    }
+    return ret;
+}
+
+std::unique_ptr<Overlap> MakeOverlap(int32_t aStart, int32_t aEnd, int32_t aLen, bool bRev,
+                                     int32_t bStart, int32_t bEnd, int32_t bLen,
+                                     const std::string& cigar, const std::string& aVars,
+                                     const std::string& bVars)
+{
+    auto ovl = createOverlap(0, 1, -100.0, 1.0, false, aStart, aEnd, aLen, bRev, bStart, bEnd,
+                             bLen, 0, 0, OverlapType::Unknown, OverlapType::Unknown);
+    ovl->Cigar = PacBio::BAM::Cigar(cigar);
+    ovl->Avars = aVars;
+    ovl->Bvars = bVars;
+    return ovl;
+}
+
+TEST(HPCCoordinateMap, CompareToRunLengthEncoding)
+{
+    std::mt19937 rng(17);
+    // The lengths test both a partial and a full last sample interval.
+    for (const int32_t numRuns : {1, 63, 64, 128, 1000}) {
+        SCOPED_TRACE("numRuns = " + std::to_string(numRuns));
+        const std::string seq = GenerateHomopolymerSequence(numRuns, rng);
+        std::string seqHPC;
+        std::vector<int32_t> seqToHPCCoords;
+        std::vector<int32_t> hpcToSeqCoords;
+        RunLengthEncoding(seq, seqHPC, seqToHPCCoords, hpcToSeqCoords);
+        std::vector<int32_t> runLengths;
+        RunLengthEncoding(seq, seqHPC, runLengths);
+        ASSERT_EQ(numRuns, static_cast<int32_t>(seqHPC.size()));
+
+        HPCCoordinateMap map;
+        map.AddSequence(3, runLengths.data(), runLengths.size());
+        EXPECT_EQ(numRuns, map.HPCLength(3));
+        EXPECT_EQ(static_cast<int32_t>(seq.size()), map.RawLength(3));
+
+        // The hpcToSeqCoords point to the last base of each run.
+        for (int32_t i = 0; i < numRuns; ++i) {
+            EXPECT_EQ(hpcToSeqCoords[i], map.ToRaw(3, i + 1) - 1);
+            EXPECT_EQ(runLengths[i], map.RunLength(3, i));
+        }
+        EXPECT_EQ(static_cast<int32_t>(seq.size()), map.ToRaw(3, numRuns));
+        for (int32_t i = 0; i < static_cast<int32_t>(seq.size()); ++i) {
+            EXPECT_EQ(seqToHPCCoords[i], map.ToHPC(3, i));
+        }
+        EXPECT_EQ(numRuns, map.ToHPC(3, seq.size()));
+
+        EXPECT_EQ(seq, map.ExpandSequence(3, seqHPC.c_str(), 0, numRuns));
+    }
+}
+
+TEST(HPCCoordinateMap, MultipleSequencesAndErrors)
+{
+    const std::vector<int32_t> runsA = {3, 1, 2, 1};
+    const std::vector<int32_t> runsB = {300, 1};
+
+    HPCCoordinateMap map;
+    map.AddSequence(0, runsA.data(), runsA.size());
+    map.AddSequence(5, runsB.data(), runsB.size());
+    EXPECT_TRUE(map.HasSequence(5));
+    EXPECT_FALSE(map.HasSequence(1));
+    EXPECT_EQ(7, map.RawLength(0));
+    EXPECT_EQ(301, map.RawLength(5));
+    EXPECT_EQ(300, map.ToRaw(5, 1));
+    EXPECT_EQ(0, map.ToHPC(5, 299));
+    EXPECT_EQ("AAACGGT", map.ExpandSequence(0, "ACGT", 0, 4));
+    EXPECT_EQ("CGG", map.ExpandSequence(0, "ACGT", 1, 3));
+
+    // The ranges which span the origin of a circular sequence.
+    const std::vector<int32_t> expectedRuns = {2, 1, 3, 1};
+    EXPECT_EQ(expectedRuns, map.RunLengths(0, 2, 6));
+
+    EXPECT_THROW({ map.ToRaw(1, 0); }, std::runtime_error);
+    EXPECT_THROW({ map.ToRaw(0, 5); }, std::runtime_error);
+    EXPECT_THROW({ map.ToHPC(0, 8); }, std::runtime_error);
+    EXPECT_THROW({ map.RunLengths(0, 0, 9); }, std::runtime_error);
+    const std::vector<int32_t> badRuns = {1, 0};
+    EXPECT_THROW({ map.AddSequence(2, badRuns.data(), badRuns.size()); }, std::runtime_error);
+
+    map.Clear();
+    EXPECT_FALSE(map.HasSequence(0));
+}
+
+TEST(HPCCoordinateMap, LiftOverlapToRaw)
+{
+    // A: raw "AAACGGT", HPC "ACGT".
+    const std::vector<int32_t> runsA = {3, 1, 2, 1};
+    const std::string aSeqHPC = "ACGT";
+    HPCCoordinateMap aMap;
+    aMap.AddSequence(0, runsA.data(), runsA.size());
+
+    {
+        SCOPED_TRACE("Forward, homopolymer length differences.");
+        // B: raw "AACGGGT", HPC "ACGT".
+        const std::vector<int32_t> runsB = {2, 1, 3, 1};
+        HPCCoordinateMap bMap;
+        bMap.AddSequence(1, runsB.data(), runsB.size());
+
+        auto ovl = MakeOverlap(0, 4, 4, false, 0, 4, 4, "4=", "", "");
+        LiftOverlapToRaw(*ovl, aMap, bMap, aSeqHPC.c_str());
+        EXPECT_EQ(0, ovl->Astart);
+        EXPECT_EQ(7, ovl->Aend);
+        EXPECT_EQ(7, ovl->Alen);
+        EXPECT_EQ(0, ovl->Bstart);
+        EXPECT_EQ(7, ovl->Bend);
+        EXPECT_EQ(7, ovl->Blen);
+        EXPECT_EQ("2=1I3=1D1=", ovl->Cigar.ToStdString());
+        EXPECT_EQ("a", ovl->Avars);
+        EXPECT_EQ("g", ovl->Bvars);
+    }
+
+    {
+        SCOPED_TRACE("Reverse, partial overlap.");
+        // B: raw "ACCCGTT", HPC "ACGT". The reverse complement of the raw B is "AACGGGT".
+        const std::vector<int32_t> runsB = {1, 3, 1, 2};
+        HPCCoordinateMap bMap;
+        bMap.AddSequence(1, runsB.data(), runsB.size());
+
+        // A "CGGT" and the B strand "CGGGT".
+        auto ovl = MakeOverlap(1, 4, 4, true, 1, 4, 4, "3=", "", "");
+        LiftOverlapToRaw(*ovl, aMap, bMap, aSeqHPC.c_str());
+        EXPECT_EQ(3, ovl->Astart);
+        EXPECT_EQ(7, ovl->Aend);
+        EXPECT_EQ(2, ovl->Bstart);
+        EXPECT_EQ(7, ovl->Bend);
+        EXPECT_EQ(7, ovl->Blen);
+        EXPECT_EQ("3=1D1=", ovl->Cigar.ToStdString());
+        EXPECT_EQ("", ovl->Avars);
+        EXPECT_EQ("g", ovl->Bvars);
+    }
+
+    {
+        SCOPED_TRACE("Mismatches and insertions keep their variants.");
+        // B: raw "AATTTGGT", HPC "ATGT".
+        const std::vector<int32_t> runsB = {2, 3, 2, 1};
+        HPCCoordinateMap bMap;
+        bMap.AddSequence(1, runsB.data(), runsB.size());
+
+        auto ovl = MakeOverlap(0, 4, 4, false, 0, 4, 4, "1=1X2=", "C", "T");
+        LiftOverlapToRaw(*ovl, aMap, bMap, aSeqHPC.c_str());
+        EXPECT_EQ("2=1I1X2D3=", ovl->Cigar.ToStdString());
+        EXPECT_EQ("aC", ovl->Avars);
+        EXPECT_EQ("TTT", ovl->Bvars);
+        EXPECT_EQ(7, ovl->Aend);
+        EXPECT_EQ(8, ovl->Bend);
+
+        // B: raw "AAGGGT", HPC "AGT".
+        const std::vector<int32_t> runsC = {2, 3, 1};
+        HPCCoordinateMap cMap;
+        cMap.AddSequence(1, runsC.data(), runsC.size());
+        auto ovlIns = MakeOverlap(0, 4, 4, false, 0, 3, 3, "1=1I2=", "C", "");
+        LiftOverlapToRaw(*ovlIns, aMap, cMap, aSeqHPC.c_str());
+        EXPECT_EQ("2=2I2=1D1=", ovlIns->Cigar.ToStdString());
+        EXPECT_EQ("aC", ovlIns->Avars);
+        EXPECT_EQ("g", ovlIns->Bvars);
+        EXPECT_EQ(6, ovlIns->Bend);
+    }
+
+    {
+        SCOPED_TRACE("Circular B, spanning the origin.");
+        const std::vector<int32_t> runsB = {2, 1, 3, 1};
+        HPCCoordinateMap bMap;
+        bMap.AddSequence(1, runsB.data(), runsB.size());
+
+        auto ovl = MakeOverlap(0, 4, 4, false, 2, 6, 4, "", "", "");
+        LiftOverlapToRaw(*ovl, aMap, bMap, aSeqHPC.c_str());
+        EXPECT_EQ(3, ovl->Bstart);
+        EXPECT_EQ(10, ovl->Bend);
+        EXPECT_EQ(7, ovl->Blen);
+    }
+
+    {
+        SCOPED_TRACE("Invalid input.");
+        const std::vector<int32_t> runsB = {2, 1, 3, 1};
+        HPCCoordinateMap bMap;
+        bMap.AddSequence(1, runsB.data(), runsB.size());
+
+        auto ovlLen = MakeOverlap(0, 4, 5, false, 0, 4, 4, "4=", "", "");
+        EXPECT_THROW({ LiftOverlapToRaw(*ovlLen, aMap, bMap, aSeqHPC.c_str()); },
+                     std::runtime_error);
+        auto ovlCigar = MakeOverlap(0, 4, 4, false, 0, 4, 4, "5=", "", "");
+        EXPECT_THROW({ LiftOverlapToRaw(*ovlCigar, aMap, bMap, aSeqHPC.c_str()); },
+                     std::runtime_error);
+        auto ovlVars = MakeOverlap(0, 4, 4, false, 0, 4, 4, "1=1X2=", "", "");
+        EXPECT_THROW({ LiftOverlapToRaw(*ovlVars, aMap, bMap, aSeqHPC.c_str()); },
+                     std::runtime_error);
+    }
+}
+
+TEST(HPCCoordinateMap, BuiltBySeqDBReaderCachedBlock)
+{
+    const std::string inSeqDB =
+        PacBio::PancakeTestsConfig::Data_Dir + "/seqdb-writer/test-7-uncompressed-2blocks.seqdb";
+    std::shared_ptr<SeqDBIndexCache> seqDBCache = LoadSeqDBIndexCache(inSeqDB);
+
+    SeqDBReaderCachedBlock readerRaw(seqDBCache, false);
+    SeqDBReaderCachedBlock readerHPC(seqDBCache, true, true);
+    SeqDBReaderCachedBlock readerNoMap(seqDBCache, true);
+
+    for (int32_t blockId = 0; blockId < static_cast<int32_t>(seqDBCache->blockLines.size());
+         ++blockId) {
+        SCOPED_TRACE("blockId = " + std::to_string(blockId));
+        readerRaw.LoadBlocks({blockId});
+        readerHPC.LoadBlocks({blockId});
+        readerNoMap.LoadBlocks({blockId});
+        const auto& map = readerHPC.hpcCoordinateMap();
+        ASSERT_EQ(readerRaw.records().size(), readerHPC.records().size());
+        for (size_t i = 0; i < readerHPC.records().size(); ++i) {
+            const auto& raw = readerRaw.records()[i];
+            const auto& hpc = readerHPC.records()[i];
+            EXPECT_FALSE(readerNoMap.hpcCoordinateMap().HasSequence(hpc.Id()));
+            ASSERT_TRUE(map.HasSequence(hpc.Id()));
+            EXPECT_EQ(hpc.size(), map.HPCLength(hpc.Id()));
+            EXPECT_EQ(std::string(raw.c_str(), raw.size()),
+                      map.ExpandSequence(hpc.Id(), hpc.c_str(), 0, hpc.size()));
+        }
+    }
+}
+
+}  // namespace HPCCoordinateMapTests
@@ -0,0 +1,476 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/MapperHiFi.h>
+#include <pacbio/pancake/OverlapWriterBase.h>
+#include <pacbio/util/Util.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace MapperHiFiTests {
+
+// The M4 format does not store the number of seeds, so a fixed value is set.
+OverlapPtr ParseOverlap(const std::string& ovlStr)
+{
+    auto ovl = ParseM4OverlapFromString(ovlStr);
+    ovl->NumSeeds = 10;
+    return ovl;
+}
+
+std::vector<OverlapPtr> ParseOverlaps(const std::vector<std::string>& ovlStrs)
+{
+    std::vector<OverlapPtr> ret;
+    for (const auto& ovlStr : ovlStrs) {
+        ret.emplace_back(ParseOverlap(ovlStr));
+    }
+    return ret;
+}
+
+std::vector<std::string> PrintOverlaps(const std::vector<OverlapPtr>& overlaps)
+{
+    std::vector<std::string> ret;
+    for (const auto& ovl : overlaps) {
+        ret.emplace_back(OverlapWriterBase::PrintOverlapAsM4(ovl, "", "", true, false));
+    }
+    return ret;
+}
+
+std::vector<int32_t> QueryPositions(const std::vector<SeedHit>& hits)
+{
+    std::vector<int32_t> ret;
+    for (const auto& hit : hits) {
+        ret.emplace_back(hit.queryPos);
+    }
+    return ret;
+}
+
+std::string GenerateRandomSequence(int32_t len, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> dist(0, 3);
+    std::string ret(len, 'A');
+    for (int32_t i = 0; i < len; ++i) {
+        ret[i] = "ACGT"[dist(gen)];
+    }
+    return ret;
+}
+
+// Creates a forward hit for every queryStep bases of the query in [qStart, qEnd], on the
+// diagonal given by the target position of the first hit.
+std::vector<SeedHit> CreateHits(int32_t tStart, int32_t qStart, int32_t qEnd, int32_t queryStep)
+{
+    std::vector<SeedHit> ret;
+    for (int32_t qPos = qStart; qPos <= qEnd; qPos += queryStep) {
+        ret.emplace_back(SeedHit(1, false, tStart + qPos - qStart, qPos, 15, 15, 0));
+    }
+    return ret;
+}
+
+OverlapPtr AlignPiecewise(const std::string& target, const std::string& query,
+                          const OverlapPtr& ovl, const std::vector<SeedHit>& anchorHits)
+{
+    const FastaSequenceCached targetSeq("target", target.c_str(), target.size(), 1);
+    const FastaSequenceCached querySeq("query", query.c_str(), query.size(), 0);
+    const std::string reverseQuerySeq = ReverseComplement(query, 0, query.size());
+    return OverlapHiFi::Mapper::AlignOverlapPiecewise(
+        targetSeq, querySeq, reverseQuerySeq, ovl, anchorHits, 50, 0.01, 0.03, 3, true, false,
+        false, false, false, false, false, false, 0, 0.0, false, nullptr, nullptr);
+}
+
+TEST(MapperHiFi, GetOverlapEndClass)
+{
+    EXPECT_EQ(OverlapHiFi::OverlapEndClass::FivePrime,
+              OverlapHiFi::GetOverlapEndClass(OverlapType::FivePrime));
+    EXPECT_EQ(OverlapHiFi::OverlapEndClass::ThreePrime,
+              OverlapHiFi::GetOverlapEndClass(OverlapType::ThreePrime));
+    EXPECT_EQ(OverlapHiFi::OverlapEndClass::Containment,
+              OverlapHiFi::GetOverlapEndClass(OverlapType::Contained));
+    EXPECT_EQ(OverlapHiFi::OverlapEndClass::Containment,
+              OverlapHiFi::GetOverlapEndClass(OverlapType::Contains));
+    EXPECT_EQ(OverlapHiFi::OverlapEndClass::Internal,
+              OverlapHiFi::GetOverlapEndClass(OverlapType::Internal));
+    EXPECT_EQ(OverlapHiFi::OverlapEndClass::Internal,
+              OverlapHiFi::GetOverlapEndClass(OverlapType::Unknown));
+}
+
+TEST(MapperHiFi, KeepBestOverlaps)
+{
+    // Sorted by score. Types: 5' x3, 3' x2, contained x1.
+    const std::vector<std::string> inOverlaps = {
+        "000000000 000000001 -9000 99.00 0 0 9000 10000 0 1000 10000 10000 5",
+        "000000000 000000002 -8000 99.00 0 2000 10000 10000 0 0 8000 10000 3",
+        "000000000 000000003 -7000 99.00 0 0 7000 10000 0 3000 10000 10000 5",
+        "000000000 000000004 -6000 99.00 0 0 6000 10000 0 4000 10000 10000 5",
+        "000000000 000000005 -5000 99.00 0 5000 10000 10000 0 0 5000 10000 3",
+        "000000000 000000006 -4000 99.00 0 0 4000 4000 0 1000 5000 10000 contained",
+    };
+
+    struct TestData
+    {
+        std::string testName;
+        int32_t bestN = 0;
+        int32_t bestNPerEnd = 0;
+        std::vector<int32_t> expectedKept;
+        std::vector<int32_t> expectedRemoved;
+    };
+
+    // clang-format off
+    const std::vector<TestData> testData = {
+        {"No limits", 0, 0, {0, 1, 2, 3, 4, 5}, {}},
+        {"Global limit only", 2, 0, {0, 1}, {2, 3, 4, 5}},
+        {"Per-end limit only", 0, 1, {0, 1, 5}, {2, 3, 4}},
+        {"Per-end limit with more than available", 0, 2, {0, 1, 2, 4, 5}, {3}},
+        {"Both limits", 4, 2, {0, 1, 2, 4}, {3, 5}},
+    };
+    // clang-format on
+
+    for (const auto& data : testData) {
+        SCOPED_TRACE(data.testName);
+        auto overlaps = ParseOverlaps(inOverlaps);
+        const auto removed = OverlapHiFi::KeepBestOverlaps(overlaps, data.bestN, data.bestNPerEnd);
+
+        std::vector<std::string> expectedKept;
+        for (const auto& id : data.expectedKept) {
+            expectedKept.emplace_back(inOverlaps[id]);
+        }
+        std::vector<std::string> expectedRemoved;
+        for (const auto& id : data.expectedRemoved) {
+            expectedRemoved.emplace_back(inOverlaps[id]);
+        }
+        EXPECT_EQ(expectedKept, PrintOverlaps(overlaps));
+        EXPECT_EQ(expectedRemoved, PrintOverlaps(removed));
+    }
+}
+
+TEST(MapperHiFi, AlignmentSchedulerInactiveWithoutLimits)
+{
+    const auto candidates = ParseOverlaps({
+        "000000000 000000001 -100 99.00 0 5000 5100 10000 0 100 200 10000 *",
+        "000000000 000000002 -100 99.00 0 0 100 10000 0 9000 9100 10000 *",
+    });
+    OverlapHifiSettings settings;
+    OverlapHiFi::AlignmentScheduler scheduler(candidates, settings);
+    EXPECT_FALSE(scheduler.IsActive());
+    EXPECT_EQ(std::vector<int32_t>({0, 1}), scheduler.Order());
+    EXPECT_TRUE(scheduler.ShouldAlign(0));
+    EXPECT_TRUE(scheduler.ShouldAlign(1));
+    EXPECT_EQ(0, scheduler.NumSkipped());
+}
+
+TEST(MapperHiFi, AlignmentSchedulerStopsAfterBestN)
+{
+    // The score bounds of the candidates are: -10000, -5100, -9900 and -1000.
+    const auto candidates = ParseOverlaps({
+        "000000000 000000001 -100 99.00 0 0 100 10000 0 0 100 10000 *",
+        "000000000 000000002 -100 99.00 0 5000 5100 10000 0 100 200 10000 *",
+        "000000000 000000003 -100 99.00 0 100 200 10000 0 0 100 10000 *",
+        "000000000 000000004 -100 99.00 0 0 100 10000 0 9000 9100 10000 *",
+    });
+    OverlapHifiSettings settings;
+    settings.BestN = 2;
+    settings.MinIdentity = 0.0;
+    settings.MinMappedLength = 0;
+    OverlapHiFi::AlignmentScheduler scheduler(candidates, settings);
+    EXPECT_TRUE(scheduler.IsActive());
+    EXPECT_EQ(std::vector<int32_t>({0, 2, 1, 3}), scheduler.Order());
+
+    // The first two alignments fill the limit, and the remaining candidates cannot beat them.
+    auto aligned0 = ParseOverlap(
+        "000000000 000000001 -9950 99.90 0 0 10000 10000 0 0 10000 10000 contained");
+    auto aligned2 = ParseOverlap(
+        "000000000 000000003 -9800 99.90 0 100 10000 10000 0 0 9900 10000 3");
+    EXPECT_TRUE(scheduler.ShouldAlign(0));
+    scheduler.AddAligned(0, *aligned0);
+    EXPECT_TRUE(scheduler.ShouldAlign(2));
+    scheduler.AddAligned(2, *aligned2);
+    EXPECT_FALSE(scheduler.ShouldAlign(1));
+    EXPECT_FALSE(scheduler.ShouldAlign(3));
+    EXPECT_EQ(2, scheduler.NumSkipped());
+}
+
+TEST(MapperHiFi, AlignmentSchedulerIgnoresFilteredAlignments)
+{
+    const auto candidates = ParseOverlaps({
+        "000000000 000000001 -100 99.00 0 0 100 10000 0 0 100 10000 *",
+        "000000000 000000002 -100 99.00 0 5000 5100 10000 0 100 200 10000 *",
+    });
+    OverlapHifiSettings settings;
+    settings.BestN = 1;
+    settings.MinIdentity = 98.0;
+    settings.MinMappedLength = 0;
+    OverlapHiFi::AlignmentScheduler scheduler(candidates, settings);
+
+    // The alignment is below the minimum identity, so it does not count towards the limit.
+    auto aligned0 = ParseOverlap(
+        "000000000 000000001 -9000 90.00 0 0 10000 10000 0 0 10000 10000 contained");
+    EXPECT_TRUE(scheduler.ShouldAlign(0));
+    scheduler.AddAligned(0, *aligned0);
+    EXPECT_TRUE(scheduler.ShouldAlign(1));
+    EXPECT_EQ(0, scheduler.NumSkipped());
+}
+
+TEST(MapperHiFi, AlignmentSchedulerRevisitsAfterMisprediction)
+{
+    // Predicted end classes: contained, 3', 3' and 5'.
+    const auto candidates = ParseOverlaps({
+        "000000000 000000001 -100 99.00 0 0 100 10000 0 0 100 10000 *",
+        "000000000 000000002 -100 99.00 0 5000 5100 10000 0 100 200 10000 *",
+        "000000000 000000003 -100 99.00 0 100 200 10000 0 0 100 10000 *",
+        "000000000 000000004 -100 99.00 0 0 100 10000 0 9000 9100 10000 *",
+    });
+    OverlapHifiSettings settings;
+    settings.BestNPerEnd = 1;
+    settings.MinIdentity = 0.0;
+    settings.MinMappedLength = 0;
+    auto aligned0 = ParseOverlap(
+        "000000000 000000001 -9950 99.90 0 0 10000 10000 0 0 10000 10000 contained");
+    auto aligned2 = ParseOverlap(
+        "000000000 000000003 -9800 99.90 0 100 10000 10000 0 0 9900 10000 3");
+
+    {
+        SCOPED_TRACE("The predictions hold.");
+        OverlapHiFi::AlignmentScheduler scheduler(candidates, settings);
+        EXPECT_EQ(std::vector<int32_t>({0, 2, 1, 3}), scheduler.Order());
+        EXPECT_TRUE(scheduler.ShouldAlign(0));
+        scheduler.AddAligned(0, *aligned0);
+        EXPECT_TRUE(scheduler.ShouldAlign(2));
+        scheduler.AddAligned(2, *aligned2);
+        EXPECT_FALSE(scheduler.ShouldAlign(1));
+        EXPECT_TRUE(scheduler.ShouldAlign(3));
+        scheduler.AddAligned(3, *ParseOverlap("000000000 000000004 -950 99.90 0 0 1000 10000 0 "
+                                              "9000 10000 10000 5"));
+        EXPECT_FALSE(scheduler.IsPredictionViolated());
+        EXPECT_EQ(std::vector<int32_t>(), scheduler.TakeSkipped());
+        EXPECT_EQ(1, scheduler.NumSkipped());
+    }
+
+    {
+        SCOPED_TRACE("The last candidate aligns only as an internal overlap.");
+        OverlapHiFi::AlignmentScheduler scheduler(candidates, settings);
+        EXPECT_TRUE(scheduler.ShouldAlign(0));
+        scheduler.AddAligned(0, *aligned0);
+        EXPECT_TRUE(scheduler.ShouldAlign(2));
+        scheduler.AddAligned(2, *aligned2);
+        EXPECT_FALSE(scheduler.ShouldAlign(1));
+        EXPECT_TRUE(scheduler.ShouldAlign(3));
+        scheduler.AddAligned(3, *ParseOverlap("000000000 000000004 -450 99.90 0 0 500 10000 0 "
+                                              "9000 9500 10000 u"));
+        EXPECT_TRUE(scheduler.IsPredictionViolated());
+        EXPECT_EQ(std::vector<int32_t>({1}), scheduler.TakeSkipped());
+        EXPECT_EQ(0, scheduler.NumSkipped());
+        EXPECT_TRUE(scheduler.ShouldAlign(1));
+    }
+
+    {
+        SCOPED_TRACE("An alignment is better than the bound of its candidate.");
+        OverlapHiFi::AlignmentScheduler scheduler(candidates, settings);
+        EXPECT_TRUE(scheduler.ShouldAlign(3));
+        scheduler.AddAligned(3, *ParseOverlap("000000000 000000004 -1200 99.90 0 0 1000 10000 0 "
+                                              "9000 10000 10000 5"));
+        EXPECT_TRUE(scheduler.IsPredictionViolated());
+    }
+}
+
+TEST(MapperHiFi, MergeColinearAnchorsAcrossLargeIndel)
+{
+    // Anchors 0 and 1 are split by a 2000 bp deletion in the query. Anchor 2 is on another
+    // target, and anchor 3 is not colinear with the other two.
+    const auto anchors = ParseOverlaps({
+        "000000000 000000001 -10 99.00 0 0 4000 20000 0 0 4000 20000 *",
+        "000000000 000000001 -10 99.00 0 4100 9000 20000 0 6100 11000 20000 *",
+        "000000000 000000002 -10 99.00 0 100 5000 20000 0 100 5000 20000 *",
+        "000000000 000000001 -10 99.00 0 2000 3000 20000 0 15000 16000 20000 *",
+    });
+    std::vector<std::vector<SeedHit>> anchorHits = {
+        {SeedHit(1, false, 0, 0, 15, 15, 0), SeedHit(1, false, 4000, 4000, 15, 15, 0)},
+        {SeedHit(1, false, 6100, 4100, 15, 15, 0), SeedHit(1, false, 11000, 9000, 15, 15, 0)},
+        {SeedHit(2, false, 100, 100, 15, 15, 0), SeedHit(2, false, 5000, 5000, 15, 15, 0)},
+        {SeedHit(1, false, 15000, 2000, 15, 15, 0), SeedHit(1, false, 16000, 3000, 15, 15, 0)},
+    };
+
+    const auto results =
+        OverlapHiFi::MergeColinearAnchors(anchors, &anchorHits, 5000, 100, 3, 500);
+
+    const std::vector<std::string> expected = {
+        "000000000 000000001 -20 99.00 0 0 9000 20000 0 0 11000 20000 *",
+        "000000000 000000002 -10 99.00 0 100 5000 20000 0 100 5000 20000 *",
+        "000000000 000000001 -10 99.00 0 2000 3000 20000 0 15000 16000 20000 *",
+    };
+    EXPECT_EQ(expected, PrintOverlaps(results));
+    ASSERT_EQ(3, results.size());
+    EXPECT_EQ(20, results[0]->NumSeeds);
+    EXPECT_EQ(1, results[0]->NumLongIndels);
+    EXPECT_EQ(0, results[0]->LongInsertionBases);
+    EXPECT_EQ(2000, results[0]->LongDeletionBases);
+    EXPECT_EQ(0, results[1]->NumLongIndels);
+
+    // The hits are concatenated, and the first hit after the join is flagged.
+    ASSERT_EQ(3, anchorHits.size());
+    ASSERT_EQ(4, anchorHits[0].size());
+    EXPECT_EQ(4100, anchorHits[0][2].queryPos);
+    EXPECT_FALSE(anchorHits[0][1].CheckFlagLongJoin());
+    EXPECT_TRUE(anchorHits[0][2].CheckFlagLongJoin());
+    EXPECT_FALSE(anchorHits[0][3].CheckFlagLongJoin());
+}
+
+TEST(MapperHiFi, MergeColinearAnchorsMaxGapAndFilters)
+{
+    // A 1500 bp insertion in the query separates a long anchor from a short one,
+    // which would not pass the filters on its own.
+    const std::vector<std::string> inAnchors = {
+        "000000000 000000001 -10 99.00 0 0 5000 20000 0 1000 6000 20000 *",
+        "000000000 000000001 -3 99.00 0 6600 7400 20000 0 6100 6900 20000 *",
+    };
+
+    const auto anchors = ParseOverlaps(inAnchors);
+
+    {
+        SCOPED_TRACE("Merged");
+        const auto results =
+            OverlapHiFi::MergeColinearAnchors(anchors, nullptr, 2000, 100, 3, 1000);
+        const std::vector<std::string> expected = {
+            "000000000 000000001 -13 99.00 0 0 7400 20000 0 1000 6900 20000 *",
+        };
+        EXPECT_EQ(expected, PrintOverlaps(results));
+        ASSERT_EQ(1, results.size());
+        EXPECT_EQ(1, results[0]->NumLongIndels);
+        EXPECT_EQ(1500, results[0]->LongInsertionBases);
+        EXPECT_EQ(0, results[0]->LongDeletionBases);
+    }
+
+    {
+        SCOPED_TRACE("Gap too large");
+        const auto results =
+            OverlapHiFi::MergeColinearAnchors(anchors, nullptr, 1000, 100, 3, 1000);
+        EXPECT_EQ(std::vector<std::string>({inAnchors[0]}), PrintOverlaps(results));
+    }
+
+    {
+        SCOPED_TRACE("Shift below the minimum indel length");
+        const auto results =
+            OverlapHiFi::MergeColinearAnchors(anchors, nullptr, 2000, 2000, 3, 1000);
+        ASSERT_EQ(1, results.size());
+        EXPECT_EQ(0, results[0]->NumLongIndels);
+        EXPECT_EQ(0, results[0]->LongInsertionBases);
+    }
+
+    EXPECT_THROW({ OverlapHiFi::MergeColinearAnchors(anchors, nullptr, -1, 100, 3, 1000); },
+                 std::runtime_error);
+}
+
+TEST(MapperHiFi, FilterDetourHits)
+{
+    const std::vector<SeedHit> diagonal = CreateHits(0, 0, 200, 100);
+
+    {
+        SCOPED_TRACE("Too few hits to filter.");
+        const std::vector<SeedHit> hits = {diagonal[0], SeedHit(1, false, 150, 100, 15, 15, 0)};
+        EXPECT_EQ(hits, OverlapHiFi::FilterDetourHits(hits, 10, 0));
+    }
+
+    {
+        SCOPED_TRACE("A detour which returns to the diagonal.");
+        std::vector<SeedHit> hits = diagonal;
+        hits.emplace_back(SeedHit(1, false, 350, 300, 15, 15, 0));
+        hits.emplace_back(SeedHit(1, false, 400, 400, 15, 15, 0));
+        hits.emplace_back(SeedHit(1, false, 500, 500, 15, 15, 0));
+        EXPECT_EQ(std::vector<int32_t>({0, 100, 200, 400, 500}),
+                  QueryPositions(OverlapHiFi::FilterDetourHits(hits, 10, 0)));
+    }
+
+    {
+        SCOPED_TRACE("A long join is not a detour.");
+        std::vector<SeedHit> hits = diagonal;
+        hits.emplace_back(SeedHit(1, false, 350, 300, 15, 15, 0));
+        hits.back().SetFlagLongJoin();
+        hits.emplace_back(SeedHit(1, false, 400, 350, 15, 15, 0));
+        hits.emplace_back(SeedHit(1, false, 400, 400, 15, 15, 0));
+        EXPECT_EQ(std::vector<int32_t>({0, 100, 200, 300, 350, 400}),
+                  QueryPositions(OverlapHiFi::FilterDetourHits(hits, 10, 0)));
+    }
+
+    {
+        SCOPED_TRACE("Short runs on another diagonal at the ends.");
+        std::vector<SeedHit> hits = {SeedHit(1, false, 40, 0, 15, 15, 0),
+                                     SeedHit(1, false, 50, 10, 15, 15, 0)};
+        for (const auto& hit : CreateHits(100, 100, 300, 100)) {
+            hits.emplace_back(hit);
+        }
+        hits.emplace_back(SeedHit(1, false, 470, 400, 15, 15, 0));
+        hits.emplace_back(SeedHit(1, false, 480, 410, 15, 15, 0));
+        EXPECT_EQ(std::vector<int32_t>({100, 200, 300}),
+                  QueryPositions(OverlapHiFi::FilterDetourHits(hits, 10, 50)));
+        EXPECT_EQ(std::vector<int32_t>({0, 10, 100, 200, 300, 400, 410}),
+                  QueryPositions(OverlapHiFi::FilterDetourHits(hits, 10, 5)));
+    }
+}
+
+TEST(MapperHiFi, AlignOverlapPiecewiseStitchesRegions)
+{
+    // A mismatch at 500 and a single-base insertion at 1200 of the query.
+    const std::string target = GenerateRandomSequence(2000, 17);
+    std::string query = target;
+    query[500] = (query[500] == 'A') ? 'C' : 'A';
+    const char insBase = (target[1199] != 'G' && target[1200] != 'G') ? 'G' : 'T';
+    query.insert(query.begin() + 1200, insBase);
+
+    std::vector<SeedHit> hits = CreateHits(100, 100, 1100, 200);
+    for (const auto& hit : CreateHits(1299, 1300, 1900, 200)) {
+        hits.emplace_back(hit);
+    }
+    const auto ovl =
+        ParseOverlap("000000000 000000001 -10 99.00 0 100 1900 2001 0 100 1899 2000 *");
+
+    const auto result = AlignPiecewise(target, query, ovl, hits);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ("000000000 000000001 -1999 99.90 0 0 2001 2001 0 0 2000 2000 *",
+              OverlapWriterBase::PrintOverlapAsM4(result, "", "", true, false));
+    EXPECT_EQ("500=1X699=1I800=", result->Cigar.ToStdString());
+    EXPECT_EQ(2, result->EditDistance);
+
+    // The first and the last hit need to match the overlap.
+    std::vector<SeedHit> badHits = hits;
+    badHits.pop_back();
+    EXPECT_THROW({ AlignPiecewise(target, query, ovl, badHits); }, std::runtime_error);
+}
+
+TEST(MapperHiFi, AlignOverlapPiecewiseAcrossLongJoin)
+{
+    // The query is missing 300 bases of the target, and the anchors were merged over the
+    // deletion, so the hit after the join is flagged.
+    const std::string target = GenerateRandomSequence(3000, 23);
+    const std::string query = target.substr(0, 1500) + target.substr(1800);
+
+    std::vector<SeedHit> hits = CreateHits(100, 100, 1400, 100);
+    for (const auto& hit : CreateHits(1900, 1600, 2600, 100)) {
+        hits.emplace_back(hit);
+    }
+    hits[14].SetFlagLongJoin();
+    auto ovl = ParseOverlap("000000000 000000001 -10 99.00 0 100 2600 2700 0 100 2900 3000 *");
+    ovl->NumLongIndels = 1;
+    ovl->LongDeletionBases = 300;
+
+    const auto result = AlignPiecewise(target, query, ovl, hits);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(0, result->Astart);
+    EXPECT_EQ(2700, result->Aend);
+    EXPECT_EQ(0, result->Bstart);
+    EXPECT_EQ(3000, result->Bend);
+    EXPECT_EQ(1, result->NumLongIndels);
+    EXPECT_EQ(300, result->LongDeletionBases);
+    EXPECT_EQ(0, result->EditDistance);
+    // The normalization can split the deletion where the shifted bases match.
+    int32_t numEq = 0;
+    int32_t numD = 0;
+    for (const auto& op : result->Cigar) {
+        numEq += (op.Type() == PacBio::BAM::CigarOperationType::SEQUENCE_MATCH) ? op.Length() : 0;
+        numD += (op.Type() == PacBio::BAM::CigarOperationType::DELETION) ? op.Length() : 0;
+    }
+    EXPECT_EQ(2700, numEq);
+    EXPECT_EQ(300, numD);
+}
+
+}  // namespace MapperHiFiTests
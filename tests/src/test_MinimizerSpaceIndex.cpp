@@ -0,0 +1,159 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/MinimizerSpaceIndex.h>
+#include <pacbio/pancake/Minimizers.h>
+#include <pacbio/util/Util.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace MinimizerSpaceIndexTests {
+
+std::string GenerateRandomSequence(int32_t len, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> dist(0, 3);
+    std::string ret(len, 'A');
+    for (int32_t i = 0; i < len; ++i) {
+        ret[i] = "ACGT"[dist(gen)];
+    }
+    return ret;
+}
+
+std::vector<SeedDB::SeedRaw> ComputeSeeds(const std::string& seq, int32_t seqId,
+                                          const SeedDB::SeedDBParameters& params)
+{
+    std::vector<SeedDB::SeedRaw> seeds;
+    const int rv = SeedDB::GenerateSeeds(seeds, reinterpret_cast<const uint8_t*>(seq.data()),
+                                         seq.size(), 0, seqId, params);
+    EXPECT_EQ(0, rv);
+    return seeds;
+}
+
+class TestData
+{
+public:
+    std::vector<MinimizerSpaceMatch> matches;
+    int32_t numQuerySeeds = 0;
+};
+
+// Indexes a single target with ID 0, and finds the matches of the query with ID 1.
+TestData FindMatches(const std::string& target, const std::string& query,
+                     int32_t queryId = 1, bool skipSelfHits = false)
+{
+    SeedDB::SeedDBParameters params;
+    params.KmerSize = 15;
+    params.MinimizerWindow = 30;
+
+    MinimizerSpaceIndex index(params, {static_cast<int32_t>(target.size())},
+                              ComputeSeeds(target, 0, params), 3);
+
+    const std::vector<SeedDB::SeedRaw> querySeeds = ComputeSeeds(query, queryId, params);
+
+    TestData ret;
+    ret.numQuerySeeds = querySeeds.size();
+    index.FindMatches(querySeeds.data(), querySeeds.size(), queryId, 0, 5, 20, skipSelfHits,
+                      false, ret.matches);
+    return ret;
+}
+
+}  // namespace MinimizerSpaceIndexTests
+
+TEST(MinimizerSpaceIndex, IdenticalSequences)
+{
+    const std::string target = MinimizerSpaceIndexTests::GenerateRandomSequence(5000, 1234);
+
+    const auto result = MinimizerSpaceIndexTests::FindMatches(target, target);
+
+    ASSERT_EQ(1, static_cast<int32_t>(result.matches.size()));
+    const auto& match = result.matches[0];
+    EXPECT_FALSE(match.targetRev);
+    EXPECT_EQ(match.queryStart, match.targetStart);
+    EXPECT_EQ(match.queryEnd, match.targetEnd);
+    EXPECT_EQ(result.numQuerySeeds, match.numSharedSeeds);
+    EXPECT_EQ(result.numQuerySeeds, match.numQuerySeeds);
+    EXPECT_EQ(result.numQuerySeeds, match.numTargetSeeds);
+    EXPECT_TRUE(match.reachesStart);
+    EXPECT_TRUE(match.reachesEnd);
+}
+
+TEST(MinimizerSpaceIndex, ReverseComplementSequences)
+{
+    const std::string target = MinimizerSpaceIndexTests::GenerateRandomSequence(5000, 1234);
+    const std::string query = PacBio::Pancake::ReverseComplement(target, 0, target.size());
+
+    const auto result = MinimizerSpaceIndexTests::FindMatches(target, query);
+
+    // The target coordinates are in the reverse strand, so they are the same as in the query.
+    ASSERT_EQ(1, static_cast<int32_t>(result.matches.size()));
+    const auto& match = result.matches[0];
+    EXPECT_TRUE(match.targetRev);
+    EXPECT_EQ(match.queryStart, match.targetStart);
+    EXPECT_EQ(match.queryEnd, match.targetEnd);
+    EXPECT_EQ(result.numQuerySeeds, match.numSharedSeeds);
+    EXPECT_TRUE(match.reachesStart);
+    EXPECT_TRUE(match.reachesEnd);
+}
+
+TEST(MinimizerSpaceIndex, DovetailOverlapWithErrors)
+{
+    // The query begins at 5000 bp of the target, has a substitution every 300 bp, and
+    // extends for another 3000 bp past the end of the target.
+    const std::string target = MinimizerSpaceIndexTests::GenerateRandomSequence(10000, 1234);
+    std::string query = target.substr(5000) +
+                        MinimizerSpaceIndexTests::GenerateRandomSequence(3000, 5678);
+    for (size_t i = 150; i < 5000; i += 300) {
+        query[i] = (query[i] == 'A') ? 'C' : 'A';
+    }
+
+    const auto result = MinimizerSpaceIndexTests::FindMatches(target, query);
+
+    ASSERT_EQ(1, static_cast<int32_t>(result.matches.size()));
+    const auto& match = result.matches[0];
+    EXPECT_FALSE(match.targetRev);
+    EXPECT_EQ(5000, match.targetStart - match.queryStart);
+    EXPECT_LT(match.queryStart, 100);
+    EXPECT_GT(match.targetEnd, 9900);
+    EXPECT_LT(match.numSharedSeeds, match.numQuerySeeds);
+    EXPECT_TRUE(match.reachesStart);
+    EXPECT_TRUE(match.reachesEnd);
+}
+
+TEST(MinimizerSpaceIndex, UnrelatedSequencesHaveNoMatches)
+{
+    const std::string target = MinimizerSpaceIndexTests::GenerateRandomSequence(5000, 1234);
+    const std::string query = MinimizerSpaceIndexTests::GenerateRandomSequence(5000, 5678);
+
+    const auto result = MinimizerSpaceIndexTests::FindMatches(target, query);
+
+    EXPECT_TRUE(result.matches.empty());
+}
+
+TEST(MinimizerSpaceIndex, SkipSelfHits)
+{
+    const std::string target = MinimizerSpaceIndexTests::GenerateRandomSequence(5000, 1234);
+
+    const auto result = MinimizerSpaceIndexTests::FindMatches(target, target, 0, false);
+    EXPECT_EQ(1, static_cast<int32_t>(result.matches.size()));
+    EXPECT_TRUE(MinimizerSpaceIndexTests::FindMatches(target, target, 0, true).matches.empty());
+}
+
+TEST(MinimizerSpaceIndex, InvalidParametersThrow)
+{
+    SeedDB::SeedDBParameters params;
+    const std::vector<SeedDB::SeedRaw> seeds = {SeedDB::Seed::Encode(123, 10, 5, 0, false)};
+
+    // Invalid k-min-mer size.
+    EXPECT_THROW(
+        { MinimizerSpaceIndex index(params, {1000}, std::vector<SeedDB::SeedRaw>(seeds), 0); },
+        std::runtime_error);
+
+    // The seed sequence ID is not covered by the sequence lengths.
+    EXPECT_THROW(
+        { MinimizerSpaceIndex index(params, {1000}, std::vector<SeedDB::SeedRaw>(seeds), 3); },
+        std::runtime_error);
+}
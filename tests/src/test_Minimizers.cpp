@@ -2,6 +2,9 @@
 #include <pacbio/pancake/Minimizers.h>
 #include <pacbio/pancake/Seed.h>
 #include <pacbio/util/CommonTypes.h>
+#include <algorithm>
+#include <random>
+#include <tuple>
 // #include <iostream>
 
 using namespace PacBio::Pancake;
@@ -709,3 +712,189 @@ TEST(GenerateMinimizers, FromStrings)
     EXPECT_EQ(expectedSeeds, results);
     EXPECT_EQ(expectedSequenceLengths, sequenceLengths);
 }
+
+namespace MinimizersTests {
+
+std::string GenerateRandomSequence(int32_t len, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> dist(0, 3);
+    std::string ret(len, 'A');
+    for (int32_t i = 0; i < len; ++i) {
+        ret[i] = "ACGT"[dist(gen)];
+    }
+    return ret;
+}
+
+std::string ReverseComplement(const std::string& seq)
+{
+    std::string ret(seq.rbegin(), seq.rend());
+    for (auto& c : ret) {
+        c = (c == 'A') ? 'T' : (c == 'C') ? 'G' : (c == 'G') ? 'C' : (c == 'T') ? 'A' : c;
+    }
+    return ret;
+}
+
+// Key, span, start and strand of each seed, with the coordinates optionally converted from the
+// reverse complement of a sequence of length seqLen.
+std::vector<std::tuple<uint64_t, int32_t, int32_t, bool>> SeedsToTuples(
+    const std::vector<PacBio::Pancake::Int128t>& seeds, int32_t seqLen, bool fromRevCmp)
+{
+    std::vector<std::tuple<uint64_t, int32_t, int32_t, bool>> ret;
+    for (const auto& seedRaw : seeds) {
+        const SeedDB::Seed seed(seedRaw);
+        const int32_t span = seed.span;
+        const int32_t pos = fromRevCmp ? (seqLen - (seed.pos + span)) : seed.pos;
+        const bool isRev = fromRevCmp ? !seed.seqRev : seed.seqRev;
+        ret.emplace_back(std::make_tuple(static_cast<uint64_t>(seed.key), span, pos, isRev));
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+std::vector<PacBio::Pancake::Int128t> GenerateSeeds(const std::string& seq,
+                                                    const SeedDB::SeedDBParameters& params)
+{
+    std::vector<PacBio::Pancake::Int128t> seeds;
+    SeedDB::GenerateSeeds(seeds, reinterpret_cast<const uint8_t*>(seq.data()), seq.size(), 0, 0,
+                          params);
+    return seeds;
+}
+
+}  // namespace MinimizersTests
+
+TEST(GenerateSyncmers, CompareToBruteForce)
+{
+    const int32_t k = 15;
+    const int32_t s = 7;
+    const std::string seq = MinimizersTests::GenerateRandomSequence(2000, 123);
+
+    const uint64_t kmerMask = SeedDB::ComputeKmerMask(k);
+    const uint64_t smerMask = SeedDB::ComputeKmerMask(s);
+    auto Encode = [](const std::string& kmer) {
+        uint64_t fwd = 0;
+        uint64_t rev = 0;
+        for (size_t i = 0; i < kmer.size(); ++i) {
+            const uint64_t b = std::string("ACGT").find(kmer[i]);
+            fwd = (fwd << 2) | b;
+            rev = rev | ((3 - b) << (2 * i));
+        }
+        return std::make_pair(std::min(fwd, rev), rev < fwd);
+    };
+
+    for (const bool closed : {false, true}) {
+        SCOPED_TRACE(closed ? "closed" : "open");
+
+        std::vector<PacBio::Pancake::Int128t> expected;
+        for (int32_t i = 0; (i + k) <= static_cast<int32_t>(seq.size()); ++i) {
+            std::vector<uint64_t> smerHashes;
+            for (int32_t j = 0; j <= (k - s); ++j) {
+                smerHashes.emplace_back(
+                    SeedDB::InvertibleHash(Encode(seq.substr(i + j, s)).first, smerMask));
+            }
+            const uint64_t minHash = *std::min_element(smerHashes.begin(), smerHashes.end());
+            const bool isSyncmer = closed ? (smerHashes.front() == minHash ||
+                                             smerHashes.back() == minHash)
+                                          : (smerHashes[(k - s) / 2] == minHash);
+            if (isSyncmer) {
+                const auto kmer = Encode(seq.substr(i, k));
+                expected.emplace_back(SeedDB::Seed::Encode(
+                    SeedDB::InvertibleHash(kmer.first, kmerMask), k, 0, i, kmer.second));
+            }
+        }
+
+        std::vector<PacBio::Pancake::Int128t> results;
+        SeedDB::GenerateSyncmers(results, reinterpret_cast<const uint8_t*>(seq.data()), seq.size(),
+                                 0, 0, k, s, closed, true, false, 10);
+
+        EXPECT_EQ(expected, results);
+    }
+}
+
+TEST(GenerateSeeds, SameSeedsOnBothStrands)
+{
+    // Each scheme should pick the same seeds on both strands, otherwise the reverse
+    // complemented overlaps would lose sensitivity.
+    const std::string seq = MinimizersTests::GenerateRandomSequence(3000, 456) + "NNN" +
+                            MinimizersTests::GenerateRandomSequence(500, 789) + "AAAAAAAAAAAAAA" +
+                            MinimizersTests::GenerateRandomSequence(500, 321);
+    const std::string seqRev = MinimizersTests::ReverseComplement(seq);
+
+    for (const auto& scheme :
+         {SeedDB::SeedingScheme::OpenSyncmer, SeedDB::SeedingScheme::ClosedSyncmer,
+          SeedDB::SeedingScheme::Randstrobe}) {
+        for (const bool useHPC : {false, true}) {
+            SCOPED_TRACE(SeedDB::SeedingSchemeToString(scheme) + ", useHPC = " +
+                         std::to_string(useHPC));
+            SeedDB::SeedDBParameters params;
+            params.KmerSize = 20;
+            params.SyncmerSize = 10;
+            params.Scheme = scheme;
+            params.UseHPCForSeedsOnly = useHPC;
+
+            const auto seedsFwd = MinimizersTests::GenerateSeeds(seq, params);
+            const auto seedsRev = MinimizersTests::GenerateSeeds(seqRev, params);
+
+            EXPECT_FALSE(seedsFwd.empty());
+            EXPECT_EQ(MinimizersTests::SeedsToTuples(seedsFwd, seq.size(), false),
+                      MinimizersTests::SeedsToTuples(seedsRev, seq.size(), true));
+        }
+    }
+}
+
+TEST(GenerateSeeds, RandstrobesLinkSyncmersWithinTheDistanceRange)
+{
+    const std::string seq = MinimizersTests::GenerateRandomSequence(5000, 111);
+    SeedDB::SeedDBParameters params;
+    params.KmerSize = 20;
+    params.SyncmerSize = 10;
+    params.StrobeMinDist = 30;
+    params.StrobeMaxDist = 80;
+
+    params.Scheme = SeedDB::SeedingScheme::OpenSyncmer;
+    const auto syncmers = MinimizersTests::GenerateSeeds(seq, params);
+    params.Scheme = SeedDB::SeedingScheme::Randstrobe;
+    const auto strobes = MinimizersTests::GenerateSeeds(seq, params);
+
+    // There is at most one randstrobe per syncmer, and the seeds are sorted by position.
+    EXPECT_FALSE(strobes.empty());
+    EXPECT_LE(strobes.size(), syncmers.size());
+    for (size_t i = 0; i < strobes.size(); ++i) {
+        const SeedDB::Seed seed(strobes[i]);
+        EXPECT_GE(static_cast<int32_t>(seed.span), params.StrobeMinDist + params.KmerSize);
+        EXPECT_LE(static_cast<int32_t>(seed.span), params.StrobeMaxDist + params.KmerSize);
+        if (i > 0) {
+            EXPECT_LE(SeedDB::Seed::DecodePos(strobes[i - 1]), seed.pos);
+        }
+    }
+}
+
+TEST(GenerateSeeds, InvalidParametersThrow)
+{
+    const std::string seq = MinimizersTests::GenerateRandomSequence(100, 1);
+    SeedDB::SeedDBParameters params;
+
+    {
+        SCOPED_TRACE("Open syncmers with an odd number of s-mers in a kmer");
+        params.Scheme = SeedDB::SeedingScheme::OpenSyncmer;
+        params.KmerSize = 20;
+        params.SyncmerSize = 11;
+        EXPECT_THROW(MinimizersTests::GenerateSeeds(seq, params), std::runtime_error);
+        params.Scheme = SeedDB::SeedingScheme::ClosedSyncmer;
+        EXPECT_NO_THROW(MinimizersTests::GenerateSeeds(seq, params));
+    }
+    {
+        SCOPED_TRACE("Randstrobe span too large for the seed encoding");
+        params.Scheme = SeedDB::SeedingScheme::Randstrobe;
+        params.SyncmerSize = 10;
+        params.StrobeMinDist = 20;
+        params.StrobeMaxDist = 240;
+        EXPECT_THROW(MinimizersTests::GenerateSeeds(seq, params), std::runtime_error);
+    }
+    {
+        SCOPED_TRACE("Spaced seeds are supported only for minimizers");
+        params.Scheme = SeedDB::SeedingScheme::ClosedSyncmer;
+        params.Spacing = 1;
+        EXPECT_THROW(MinimizersTests::GenerateSeeds(seq, params), std::runtime_error);
+    }
+}
@@ -0,0 +1,143 @@
+// Authors: Ivan Sovic
+
+#include <PancakeTestData.h>
+#include <gtest/gtest.h>
+#include <pacbio/pancake/OverlapMerge.h>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace OverlapMergeTests {
+
+std::vector<std::string> ToStrings(const std::vector<OverlapLine>& lines)
+{
+    std::vector<std::string> ret;
+    for (const auto& line : lines) {
+        ret.emplace_back(line.line);
+    }
+    return ret;
+}
+
+std::vector<OverlapLine> ToLines(const std::vector<std::string>& strs)
+{
+    std::vector<OverlapLine> ret;
+    for (const auto& str : strs) {
+        ret.emplace_back(ParseOverlapLine(str));
+    }
+    return ret;
+}
+
+TEST(OverlapMerge, ParseOverlapLine)
+{
+    // IPA format, with the extra columns.
+    const OverlapLine line = ParseOverlapLine(
+        "read1 read22 -1000 99.50 0 0 1000 5000 1 4000 5000 5000 5 3 u * * * *");
+    EXPECT_EQ("read1", line.AName());
+    EXPECT_EQ("read22", line.BName());
+    EXPECT_EQ(-1000.0f, line.score);
+    EXPECT_EQ(99.5f, line.identity);
+    EXPECT_EQ("read1 read22 -1000 99.50 0 0 1000 5000 1 4000 5000 5000 5 3 u * * * *", line.line);
+
+    // M4 format with the IDs, and leading whitespace.
+    const OverlapLine lineM4 = ParseOverlapLine("  000000002 000000001 -500 98.00 0 0 500 500");
+    EXPECT_EQ("000000002", lineM4.AName());
+    EXPECT_EQ("000000001", lineM4.BName());
+    EXPECT_EQ(-500.0f, lineM4.score);
+
+    EXPECT_THROW({ ParseOverlapLine("read1 read2 -1000"); }, std::runtime_error);
+    EXPECT_THROW({ ParseOverlapLine("read1 read2 abc 99.0 0 0 1 1"); }, std::runtime_error);
+    EXPECT_THROW({ ParseOverlapLine(""); }, std::runtime_error);
+}
+
+TEST(OverlapMerge, SortByRead)
+{
+    std::vector<OverlapLine> lines = ToLines({
+        "b a -100 99.00 0 0 100 100 0 0 100 100",
+        "a c -100 98.00 0 0 100 100 0 0 100 100",
+        "a b -100 99.00 0 0 100 100 0 0 100 100",
+        "a d -200 97.00 0 0 200 200 0 0 200 200",
+        "ab a -300 99.00 0 0 300 300 0 0 300 300",
+    });
+    SortOverlapLines(lines, OverlapSortOrder::ByRead);
+
+    // Grouped by the A-read, and the best overlap first: lower score, then higher identity.
+    const std::vector<std::string> expected = {
+        "a d -200 97.00 0 0 200 200 0 0 200 200",
+        "a b -100 99.00 0 0 100 100 0 0 100 100",
+        "a c -100 98.00 0 0 100 100 0 0 100 100",
+        "ab a -300 99.00 0 0 300 300 0 0 300 300",
+        "b a -100 99.00 0 0 100 100 0 0 100 100",
+    };
+    EXPECT_EQ(expected, ToStrings(lines));
+}
+
+TEST(OverlapMerge, SortByPair)
+{
+    std::vector<OverlapLine> lines = ToLines({
+        "b a -100 99.00 0 0 100 100 0 0 100 100",
+        "a c -100 98.00 0 0 100 100 0 0 100 100",
+        "a b -120 99.00 0 0 120 120 0 0 120 120",
+        "c a -100 99.00 0 0 100 100 0 0 100 100",
+    });
+    SortOverlapLines(lines, OverlapSortOrder::ByPair);
+
+    // The A-B and B-A overlaps are adjacent, and the best one is first.
+    const std::vector<std::string> expected = {
+        "a b -120 99.00 0 0 120 120 0 0 120 120",
+        "b a -100 99.00 0 0 100 100 0 0 100 100",
+        "c a -100 99.00 0 0 100 100 0 0 100 100",
+        "a c -100 98.00 0 0 100 100 0 0 100 100",
+    };
+    EXPECT_EQ(expected, ToStrings(lines));
+    EXPECT_EQ(0, ComparePair(lines[0], lines[1]));
+    EXPECT_EQ(0, ComparePair(lines[2], lines[3]));
+    EXPECT_LT(ComparePair(lines[1], lines[2]), 0);
+}
+
+TEST(OverlapMerge, MergeRuns)
+{
+    const std::vector<std::vector<std::string>> runs = {
+        {
+            "a b -100 99.00 0 0 100 100 0 0 100 100",
+            "c a -300 99.00 0 0 300 300 0 0 300 300",
+        },
+        {},
+        {
+            "a c -200 99.00 0 0 200 200 0 0 200 200",
+            "b c -100 99.00 0 0 100 100 0 0 100 100",
+            "c b -100 99.00 0 0 100 100 0 0 100 100",
+        },
+        {
+            "b a -100 99.00 0 0 100 100 0 0 100 100",
+        },
+    };
+
+    std::vector<std::string> runPaths;
+    std::vector<OverlapLine> allLines;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        std::vector<OverlapLine> lines = ToLines(runs[i]);
+        allLines.insert(allLines.end(), lines.begin(), lines.end());
+        SortOverlapLines(lines, OverlapSortOrder::ByRead);
+        runPaths.emplace_back(PacBio::PancakeTestsConfig::GeneratedData_Dir + "/ovl-merge.run." +
+                              std::to_string(i) + ".tmp");
+        WriteOverlapLines(lines, runPaths.back());
+    }
+
+    OverlapRunMerger merger(runPaths, OverlapSortOrder::ByRead);
+    std::vector<OverlapLine> results;
+    OverlapLine line;
+    while (merger.GetNext(line)) {
+        results.emplace_back(line);
+    }
+
+    // The merged runs are the same as if all lines were sorted at once.
+    SortOverlapLines(allLines, OverlapSortOrder::ByRead);
+    EXPECT_EQ(ToStrings(allLines), ToStrings(results));
+    EXPECT_FALSE(merger.GetNext(line));
+
+    EXPECT_THROW({ OverlapRunMerger({"nonexistent.run.tmp"}, OverlapSortOrder::ByRead); },
+                 std::runtime_error);
+}
+
+}  // namespace OverlapMergeTests
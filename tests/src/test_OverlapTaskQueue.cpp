@@ -0,0 +1,256 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/OverlapTaskQueue.h>
+#include <pacbio/pancake/SeqDBIndexCache.h>
+#include <utime.h>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace OverlapTaskQueueTests {
+
+std::string CreateTempDir()
+{
+    std::string dirTemplate = testing::TempDir() + "pancake-taskqueue-XXXXXX";
+    if (mkdtemp(&dirTemplate[0]) == nullptr) {
+        throw std::runtime_error("Could not create a temporary folder.");
+    }
+    return dirTemplate;
+}
+
+bool FileExists(const std::string& path) { return std::ifstream(path).good(); }
+
+void WriteFile(const std::string& path, const std::string& contents)
+{
+    std::ofstream ofs(path);
+    ofs << contents;
+}
+
+// Creates a lock file as if written by another worker, with the last heartbeat in the past.
+void CreateLock(const std::string& path, int32_t ageSeconds)
+{
+    WriteFile(path, "otherhost\t123\n");
+    struct utimbuf times;
+    times.actime = std::time(nullptr) - ageSeconds;
+    times.modtime = times.actime;
+    ASSERT_EQ(0, utime(path.c_str(), &times));
+}
+
+// Creates an index with the given sequence lengths in each block.
+std::shared_ptr<SeqDBIndexCache> CreateCache(const std::vector<std::vector<int32_t>>& blocks)
+{
+    std::ostringstream seqLines;
+    std::ostringstream blockLines;
+    int32_t seqId = 0;
+    int64_t offset = 0;
+    for (size_t blockId = 0; blockId < blocks.size(); ++blockId) {
+        const int32_t startSeqId = seqId;
+        int64_t blockBases = 0;
+        for (const int32_t len : blocks[blockId]) {
+            seqLines << "S\t" << seqId << "\tread" << seqId << "\t0\t" << offset << "\t" << len
+                     << "\t" << len << "\t1\t0\t" << len << "\n";
+            ++seqId;
+            offset += len;
+            blockBases += len;
+        }
+        blockLines << "B\t" << blockId << "\t" << startSeqId << "\t" << seqId << "\t"
+                   << blockBases << "\t" << blockBases << "\n";
+    }
+    std::istringstream iss("V\t0.1.0\nC\t0\nF\t0\ttest.seqdb.0.seq\t" +
+                           std::to_string(seqId) + "\t" + std::to_string(offset) + "\t" +
+                           std::to_string(offset) + "\n" + seqLines.str() + blockLines.str());
+    return LoadSeqDBIndexCache(iss, "test.seqdb");
+}
+
+// Blocks of 100, 300 and 200 bp, with two sequences each.
+std::shared_ptr<SeqDBIndexCache> CreateCache()
+{
+    return CreateCache({{50, 50}, {100, 200}, {100, 100}});
+}
+
+std::vector<std::vector<int32_t>> Summarize(const std::vector<OverlapTask>& tasks)
+{
+    std::vector<std::vector<int32_t>> ret;
+    for (const auto& task : tasks) {
+        ret.emplace_back(std::vector<int32_t>{task.taskId, task.targetBlockId,
+                                              task.queryBlockStartId, task.queryBlockEndId});
+    }
+    return ret;
+}
+
+TEST(OverlapTaskQueue, PlanOverlapTasks)
+{
+    const auto cache = CreateCache();
+
+    {
+        SCOPED_TRACE("Triangular, one query block per task.");
+        const std::vector<OverlapTask> tasks = PlanOverlapTasks(*cache, *cache, 1, true);
+        // Group costs: T0 = 5000 + 30000 + 20000, T1 = 45000 + 60000, T2 = 20000.
+        const std::vector<std::vector<int32_t>> expected = {
+            {0, 1, 2, 3}, {1, 1, 1, 2}, {2, 0, 1, 2}, {3, 0, 2, 3}, {4, 0, 0, 1}, {5, 2, 2, 3},
+        };
+        EXPECT_EQ(expected, Summarize(tasks));
+        EXPECT_DOUBLE_EQ(60000.0, tasks[0].cost);
+        EXPECT_DOUBLE_EQ(5000.0, tasks[4].cost);
+    }
+
+    {
+        SCOPED_TRACE("All pairs, two query blocks per task.");
+        const std::vector<OverlapTask> tasks = PlanOverlapTasks(*cache, *cache, 2, false);
+        const std::vector<std::vector<int32_t>> expected = {
+            {0, 1, 0, 2}, {1, 1, 2, 3}, {2, 2, 0, 2}, {3, 2, 2, 3}, {4, 0, 0, 2}, {5, 0, 2, 3},
+        };
+        EXPECT_EQ(expected, Summarize(tasks));
+    }
+
+    EXPECT_THROW({ PlanOverlapTasks(*cache, *cache, 0, false); }, std::runtime_error);
+}
+
+TEST(OverlapTaskQueue, PlanSkipSymmetricUsesSequenceIds)
+{
+    {
+        SCOPED_TRACE("Single-sequence blocks produce only the self hits on the diagonal.");
+        const auto cache = CreateCache({{100}, {300}, {200}});
+        const std::vector<std::vector<int32_t>> expected = {
+            {0, 1, 2, 3}, {1, 0, 1, 2}, {2, 0, 2, 3},
+        };
+        EXPECT_EQ(expected, Summarize(PlanOverlapTasks(*cache, *cache, 1, true)));
+    }
+
+    {
+        SCOPED_TRACE("Query blocked more coarsely than the target.");
+        const auto targetCache = CreateCache();
+        const auto queryCache = CreateCache({{50, 50, 100, 200, 100, 100}});
+        const std::vector<OverlapTask> tasks = PlanOverlapTasks(*targetCache, *queryCache, 1, true);
+        const std::vector<std::vector<int32_t>> expected = {
+            {0, 1, 0, 1}, {1, 2, 0, 1}, {2, 0, 0, 1},
+        };
+        EXPECT_EQ(expected, Summarize(tasks));
+    }
+
+    {
+        SCOPED_TRACE("Target blocked more coarsely than the query.");
+        const auto targetCache = CreateCache({{50, 50, 100}, {200, 100, 100}});
+        const auto queryCache = CreateCache();
+        const std::vector<OverlapTask> tasks = PlanOverlapTasks(*targetCache, *queryCache, 1, true);
+        // T0 = 0.5 * 200 * 100 + 0.5 * 200 * 300 + 200 * 200, T1 = 0.5 * 400 * 200.
+        const std::vector<std::vector<int32_t>> expected = {
+            {0, 0, 2, 3}, {1, 0, 1, 2}, {2, 0, 0, 1}, {3, 1, 2, 3},
+        };
+        EXPECT_EQ(expected, Summarize(tasks));
+    }
+}
+
+TEST(OverlapTaskQueue, PlanRoundTrip)
+{
+    const auto cache = CreateCache();
+    const std::vector<OverlapTask> tasks = PlanOverlapTasks(*cache, *cache, 1, true);
+    std::ostringstream oss;
+    WriteOverlapTaskPlan(oss, tasks);
+    std::istringstream iss(oss.str());
+    const std::vector<OverlapTask> parsed = ParseOverlapTaskPlan(iss);
+    EXPECT_EQ(tasks, parsed);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        EXPECT_DOUBLE_EQ(tasks[i].cost, parsed[i].cost);
+    }
+
+    std::istringstream issMalformed("0\t1\t2\t3\n");
+    EXPECT_THROW({ ParseOverlapTaskPlan(issMalformed); }, std::runtime_error);
+    std::istringstream issNotConsecutive("1\t1\t2\t3\t100\n");
+    EXPECT_THROW({ ParseOverlapTaskPlan(issNotConsecutive); }, std::runtime_error);
+}
+
+TEST(OverlapTaskQueue, ClaimCompleteAndRelease)
+{
+    const auto cache = CreateCache();
+    const std::vector<OverlapTask> plan = PlanOverlapTasks(*cache, *cache, 1, true);
+    const std::string workDir = CreateTempDir() + "/work";
+
+    OverlapTaskQueue workerA(workDir, plan, 600);
+    OverlapTaskQueue workerB(workDir, plan, 600);
+    EXPECT_TRUE(FileExists(workDir + "/plan.tsv"));
+    EXPECT_THROW({ OverlapTaskQueue(workDir, PlanOverlapTasks(*cache, *cache, 1, false), 600); },
+                 std::runtime_error);
+
+    // The second worker starts on a different target block.
+    OverlapTask taskA;
+    OverlapTask taskB;
+    ASSERT_TRUE(workerA.Claim(-1, taskA));
+    ASSERT_TRUE(workerB.Claim(-1, taskB));
+    EXPECT_EQ(0, taskA.taskId);
+    EXPECT_EQ(2, taskB.taskId);
+    EXPECT_THROW({ workerA.Claim(-1, taskA); }, std::runtime_error);
+
+    WriteFile(workerA.OutputPath(), "overlaps\n");
+    EXPECT_TRUE(workerA.Complete());
+    EXPECT_FALSE(workerA.HasTask());
+    EXPECT_TRUE(FileExists(workerA.TaskDonePath(0)));
+    EXPECT_TRUE(FileExists(workerA.TaskOutputPath(0)));
+    EXPECT_TRUE(FileExists(workerA.TaskLockPath(0, 1)));
+    EXPECT_EQ(1, workerB.NumDone());
+
+    // The next task of the same target block. A released task can be claimed right away.
+    ASSERT_TRUE(workerA.Claim(1, taskA));
+    EXPECT_EQ(1, taskA.taskId);
+    WriteFile(workerA.OutputPath(), "partial\n");
+    workerA.Release();
+    EXPECT_FALSE(FileExists(workerA.TaskOutputPath(1) + ".tmp.0"));
+    ASSERT_TRUE(workerA.Claim(1, taskA));
+    EXPECT_EQ(1, taskA.taskId);
+    EXPECT_EQ(workerA.TaskOutputPath(1) + ".tmp.1", workerA.OutputPath());
+}
+
+TEST(OverlapTaskQueue, ExpiredAndLostLeases)
+{
+    const auto cache = CreateCache();
+    const std::vector<OverlapTask> plan = PlanOverlapTasks(*cache, *cache, 1, true);
+    const std::string workDir = CreateTempDir() + "/work";
+    OverlapTaskQueue worker(workDir, plan, 60);
+
+    // Tasks 0 and 1 are held by live workers, and the worker of task 2 stopped responding.
+    CreateLock(worker.TaskLockPath(0, 0), 0);
+    CreateLock(worker.TaskLockPath(1, 0), 30);
+    CreateLock(worker.TaskLockPath(2, 0), 120);
+
+    OverlapTask task;
+    EXPECT_FALSE(worker.Claim(1, task));
+    ASSERT_TRUE(worker.Claim(0, task));
+    EXPECT_EQ(2, task.taskId);
+    EXPECT_EQ(worker.TaskOutputPath(2) + ".tmp.1", worker.OutputPath());
+
+    // The heartbeat of this worker was also missed, and the task was claimed again.
+    const std::string outputPath = worker.OutputPath();
+    WriteFile(outputPath, "overlaps\n");
+    CreateLock(worker.TaskLockPath(2, 2), 0);
+    EXPECT_FALSE(worker.Complete());
+    EXPECT_FALSE(FileExists(outputPath));
+    EXPECT_FALSE(FileExists(worker.TaskOutputPath(2)));
+    EXPECT_FALSE(FileExists(worker.TaskDonePath(2)));
+
+    // Complete all tasks which are not held by the other workers.
+    int32_t numCompleted = 0;
+    while (worker.Claim(-1, task)) {
+        WriteFile(worker.OutputPath(), "overlaps\n");
+        EXPECT_TRUE(worker.Complete());
+        ++numCompleted;
+    }
+    EXPECT_EQ(3, numCompleted);
+    EXPECT_EQ(3, worker.NumDone());
+    EXPECT_FALSE(worker.IsFinished());
+
+    // The other workers finish.
+    for (const int32_t taskId : {0, 1, 2}) {
+        WriteFile(worker.TaskDonePath(taskId), "");
+    }
+    EXPECT_TRUE(worker.IsFinished());
+    EXPECT_FALSE(worker.Claim(-1, task));
+}
+
+}  // namespace OverlapTaskQueueTests
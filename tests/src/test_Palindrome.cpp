@@ -0,0 +1,120 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/pancake/Minimizers.h>
+#include <pacbio/pancake/Palindrome.h>
+#include <pacbio/util/Util.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace PalindromeTests {
+
+std::string GenerateRandomSequence(int32_t len, std::mt19937& rng)
+{
+    const char* bases = "ACGT";
+    std::string ret(len, 'A');
+    for (auto& c : ret) {
+        c = bases[rng() % 4];
+    }
+    return ret;
+}
+
+std::vector<SeedDB::SeedRaw> ComputeSeeds(const std::string& seq)
+{
+    SeedDB::SeedDBParameters params;
+    params.KmerSize = 15;
+    params.MinimizerWindow = 5;
+    params.Spacing = 0;
+    params.UseHPC = false;
+    params.UseRC = true;
+    std::vector<SeedDB::SeedRaw> seeds;
+    SeedDB::GenerateSeeds(seeds, reinterpret_cast<const uint8_t*>(seq.c_str()), seq.size(), 0, 0,
+                          params);
+    return seeds;
+}
+
+PalindromeResult Detect(const std::vector<SeedDB::SeedRaw>& seeds, int32_t seqLen)
+{
+    return DetectPalindrome(seeds.data(), seeds.size(), seqLen, 3, 1000, 5000, 100, 10);
+}
+
+TEST(Palindrome, MissedAdapter)
+{
+    // The read is a sequence, a short hairpin, and the reverse complement of the sequence.
+    std::mt19937 rng(11);
+    const std::string arm = GenerateRandomSequence(5000, rng);
+    const std::string hairpin = GenerateRandomSequence(40, rng);
+    const std::string read = arm + hairpin + ReverseComplement(arm, 0, arm.size());
+    const auto seeds = ComputeSeeds(read);
+
+    const PalindromeResult result = Detect(seeds, read.size());
+    EXPECT_TRUE(result.isPalindrome);
+    EXPECT_NEAR(5020, result.foldPos, 1);
+    EXPECT_LT(result.armStart, 50);
+    EXPECT_GT(result.armEnd, 4950);
+    EXPECT_LE(result.armEnd, result.foldPos);
+    EXPECT_GT(result.numSeeds, 100);
+
+    // Trimming keeps the seeds of the longer side of the fold.
+    std::vector<SeedDB::SeedRaw> trimmedSeeds;
+    CollectSeedsOnLongerArm(seeds.data(), seeds.size(), read.size(), result, trimmedSeeds);
+    EXPECT_FALSE(trimmedSeeds.empty());
+    EXPECT_LT(trimmedSeeds.size(), seeds.size());
+    for (const auto& seed : trimmedSeeds) {
+        const auto decoded = SeedDB::Seed(seed);
+        EXPECT_LE(decoded.pos + decoded.span, result.foldPos);
+    }
+    EXPECT_FALSE(Detect(trimmedSeeds, read.size()).isPalindrome);
+}
+
+TEST(Palindrome, InvertedRepeatWithSpacer)
+{
+    // A shorter inverted repeat, separated by a long unrelated sequence.
+    std::mt19937 rng(13);
+    const std::string prefix = GenerateRandomSequence(3000, rng);
+    const std::string arm = GenerateRandomSequence(2000, rng);
+    const std::string spacer = GenerateRandomSequence(3000, rng);
+    const std::string read = prefix + arm + spacer + ReverseComplement(arm, 0, arm.size());
+    const auto seeds = ComputeSeeds(read);
+
+    const PalindromeResult result = Detect(seeds, read.size());
+    EXPECT_TRUE(result.isPalindrome);
+    EXPECT_NEAR(6500, result.foldPos, 1);
+    EXPECT_GE(result.armStart, 3000);
+    EXPECT_LE(result.armEnd, 5000);
+}
+
+TEST(Palindrome, NormalReadIsNotAPalindrome)
+{
+    std::mt19937 rng(17);
+    const std::string read = GenerateRandomSequence(10000, rng);
+    const auto seeds = ComputeSeeds(read);
+    const PalindromeResult result = Detect(seeds, read.size());
+    EXPECT_FALSE(result.isPalindrome);
+
+    // Too short an arm.
+    const std::string arm = GenerateRandomSequence(500, rng);
+    const std::string shortRead = read + arm + ReverseComplement(arm, 0, arm.size());
+    const auto shortSeeds = ComputeSeeds(shortRead);
+    const PalindromeResult shortResult = Detect(shortSeeds, shortRead.size());
+    EXPECT_FALSE(shortResult.isPalindrome);
+    EXPECT_NEAR(10500, shortResult.foldPos, 1);
+
+    // No seeds.
+    EXPECT_EQ(PalindromeResult(), Detect({}, 0));
+}
+
+TEST(Palindrome, ActionFromString)
+{
+    EXPECT_EQ(PalindromeAction::None, PalindromeActionFromString("none"));
+    EXPECT_EQ(PalindromeAction::Report, PalindromeActionFromString("report"));
+    EXPECT_EQ(PalindromeAction::Skip, PalindromeActionFromString("skip"));
+    EXPECT_EQ(PalindromeAction::Trim, PalindromeActionFromString("trim"));
+    EXPECT_EQ("trim", PalindromeActionToString(PalindromeAction::Trim));
+    EXPECT_THROW({ PalindromeActionFromString("split"); }, std::runtime_error);
+}
+
+}  // namespace PalindromeTests
@@ -0,0 +1,120 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <lib/kxsort/kxsort.h>
+#include <pacbio/pancake/PerfectSeedHash.h>
+#include <pacbio/pancake/Seed.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace PerfectSeedHashTests {
+
+// Generates seeds for numKeys random keys, each occurring between 1 and maxCount times,
+// and sorts them by key.
+std::vector<SeedDB::SeedRaw> GenerateSortedSeeds(int32_t numKeys, int32_t maxCount,
+                                                 std::mt19937& rng, std::set<uint64_t>& retKeys)
+{
+    std::uniform_int_distribution<uint64_t> keyDist(0, (static_cast<uint64_t>(1) << 48) - 1);
+    std::uniform_int_distribution<int32_t> countDist(1, maxCount);
+    std::vector<SeedDB::SeedRaw> seeds;
+    retKeys.clear();
+    while (static_cast<int32_t>(retKeys.size()) < numKeys) {
+        const uint64_t key = keyDist(rng);
+        if (retKeys.emplace(key).second == false) {
+            continue;
+        }
+        const int32_t count = countDist(rng);
+        for (int32_t i = 0; i < count; ++i) {
+            seeds.emplace_back(SeedDB::Seed::Encode(key, 15, i % 7, i, false));
+        }
+    }
+    kx::radix_sort(seeds.begin(), seeds.end());
+    return seeds;
+}
+
+TEST(PerfectSeedHash, EmptyInput)
+{
+    const std::vector<SeedDB::SeedRaw> seeds;
+    PerfectSeedHash hash(seeds.data(), seeds.size());
+    EXPECT_TRUE(hash.empty());
+    EXPECT_EQ(0, hash.size());
+    EXPECT_TRUE(hash.find(0) == hash.end());
+    EXPECT_TRUE(hash.find(123) == hash.end());
+    EXPECT_TRUE(hash.begin() == hash.end());
+}
+
+TEST(PerfectSeedHash, AllKeysAreFoundWithTheirRanges)
+{
+    std::mt19937 rng(13);
+    for (const int32_t numKeys : {1, 2, 3, 10, 100, 1000, 50000}) {
+        SCOPED_TRACE("numKeys = " + std::to_string(numKeys));
+        std::set<uint64_t> keys;
+        const auto seeds = GenerateSortedSeeds(numKeys, 5, rng, keys);
+        PerfectSeedHash hash(seeds.data(), seeds.size());
+        ASSERT_EQ(numKeys, hash.size());
+
+        // Each key points to the range of its seeds in the sorted array.
+        int64_t start = 0;
+        for (const auto& key : keys) {
+            int64_t end = start;
+            while (end < static_cast<int64_t>(seeds.size()) &&
+                   SeedDB::Seed::DecodeKey(seeds[end]) == key) {
+                ++end;
+            }
+            const auto it = hash.find(key);
+            ASSERT_TRUE(it != hash.end());
+            EXPECT_EQ(key, it->first);
+            EXPECT_EQ(std::make_pair(start, end), it->second);
+            start = end;
+        }
+
+        // Iteration visits each key once.
+        std::set<uint64_t> visited;
+        for (auto it = hash.begin(); it != hash.end(); ++it) {
+            EXPECT_TRUE(visited.emplace(it->first).second);
+        }
+        EXPECT_EQ(keys, visited);
+    }
+}
+
+TEST(PerfectSeedHash, KeysNotInTheHashAreRejected)
+{
+    std::mt19937 rng(17);
+    std::set<uint64_t> keys;
+    const auto seeds = GenerateSortedSeeds(10000, 3, rng, keys);
+    PerfectSeedHash hash(seeds.data(), seeds.size());
+
+    std::uniform_int_distribution<uint64_t> keyDist(0, (static_cast<uint64_t>(1) << 48) - 1);
+    for (int32_t i = 0; i < 100000; ++i) {
+        const uint64_t key = keyDist(rng);
+        if (keys.count(key) == 0) {
+            EXPECT_TRUE(hash.find(key) == hash.end());
+        }
+    }
+}
+
+TEST(PerfectSeedHash, CountLargerThanThePackedField)
+{
+    // The count of a key which does not fit into the slot is stored separately.
+    const int64_t largeCount = (1 << 20) + 5;
+    std::vector<SeedDB::SeedRaw> seeds;
+    seeds.emplace_back(SeedDB::Seed::Encode(3, 15, 0, 0, false));
+    for (int64_t i = 0; i < largeCount; ++i) {
+        seeds.emplace_back(SeedDB::Seed::Encode(7, 15, 0, i, false));
+    }
+    seeds.emplace_back(SeedDB::Seed::Encode(11, 15, 0, 0, false));
+    PerfectSeedHash hash(seeds.data(), seeds.size());
+
+    using Range = std::pair<int64_t, int64_t>;
+    ASSERT_EQ(3, hash.size());
+    EXPECT_EQ(Range(0, 1), hash.find(3)->second);
+    EXPECT_EQ(Range(1, largeCount + 1), hash.find(7)->second);
+    EXPECT_EQ(Range(largeCount + 1, largeCount + 2), hash.find(11)->second);
+    EXPECT_TRUE(hash.find(5) == hash.end());
+}
+
+}  // namespace PerfectSeedHashTests
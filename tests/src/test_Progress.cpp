@@ -0,0 +1,147 @@
+// Authors: Ivan Sovic
+
+#include <PancakeTestData.h>
+#include <gtest/gtest.h>
+#include <pacbio/util/Progress.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace ProgressTests {
+
+ProgressSnapshot MakeSnapshot(double elapsedSecs, int64_t queries, int64_t totalQueries,
+                              int64_t bases, int64_t totalBases)
+{
+    ProgressSnapshot ret;
+    ret.elapsedSecs = elapsedSecs;
+    ret.queries = queries;
+    ret.totalQueries = totalQueries;
+    ret.bases = bases;
+    ret.totalBases = totalBases;
+    return ret;
+}
+
+TEST(Test_Progress, EstimateRemainingSecs)
+{
+    // The fraction of bases is used when the total is known.
+    EXPECT_DOUBLE_EQ(30.0, EstimateRemainingSecs(MakeSnapshot(10.0, 90, 100, 250, 1000)));
+
+    // The fraction of queries is used otherwise.
+    EXPECT_DOUBLE_EQ(10.0, EstimateRemainingSecs(MakeSnapshot(10.0, 50, 100, 250, 0)));
+
+    // Done.
+    EXPECT_DOUBLE_EQ(0.0, EstimateRemainingSecs(MakeSnapshot(10.0, 100, 100, 1000, 1000)));
+
+    // Unknown: no totals, nothing processed yet or no elapsed time.
+    EXPECT_LT(EstimateRemainingSecs(MakeSnapshot(10.0, 50, 0, 250, 0)), 0.0);
+    EXPECT_LT(EstimateRemainingSecs(MakeSnapshot(10.0, 0, 100, 0, 1000)), 0.0);
+    EXPECT_LT(EstimateRemainingSecs(MakeSnapshot(0.0, 50, 100, 250, 1000)), 0.0);
+}
+
+TEST(Test_Progress, FormatDuration)
+{
+    EXPECT_EQ("00:00:00", FormatDuration(0.0));
+    EXPECT_EQ("00:01:05", FormatDuration(65.2));
+    EXPECT_EQ("27:46:40", FormatDuration(100000.0));
+    EXPECT_EQ("--:--:--", FormatDuration(-1.0));
+}
+
+TEST(Test_Progress, FormatProgressLine)
+{
+    ProgressSnapshot snapshot = MakeSnapshot(10.0, 25, 100, 2000000, 8000000);
+    snapshot.hits = 1000;
+    snapshot.alignments = 50;
+    snapshot.overlaps = 40;
+
+    EXPECT_EQ(
+        "[ovl-hifi] queries: 25 / 100 (25.00%), bases: 2.00 Mbp / 8.00 Mbp, rate: 2.50 queries/s, "
+        "0.20 Mbp/s, hits: 1000, alignments: 50, overlaps: 40, elapsed: 00:00:10, "
+        "ETA: 00:00:30",
+        FormatProgressLine("ovl-hifi", snapshot));
+
+    // The band widenings are reported only if there were any.
+    snapshot.bandWidenings = 7;
+    EXPECT_EQ(
+        "[ovl-hifi] queries: 25 / 100 (25.00%), bases: 2.00 Mbp / 8.00 Mbp, rate: 2.50 queries/s, "
+        "0.20 Mbp/s, hits: 1000, alignments: 50, band widenings: 7, overlaps: 40, "
+        "elapsed: 00:00:10, ETA: 00:00:30",
+        FormatProgressLine("ovl-hifi", snapshot));
+
+    // Without the totals, the ETA is unknown.
+    EXPECT_EQ(
+        "[seqdb] queries: 25, bases: 2.00 Mbp, rate: 2.50 queries/s, 0.20 Mbp/s, hits: 0, "
+        "alignments: 0, overlaps: 0, elapsed: 00:00:10, ETA: --:--:--",
+        FormatProgressLine("seqdb", MakeSnapshot(10.0, 25, 0, 2000000, 0)));
+}
+
+TEST(Test_Progress, FormatProgressJSON)
+{
+    EXPECT_EQ(
+        "{\"name\":\"seeddb\",\"final\":false,\"elapsed_secs\":10.00,\"queries\":25,"
+        "\"total_queries\":100,\"bases\":2000,\"total_bases\":0,\"hits\":0,\"alignments\":0,"
+        "\"band_widenings\":0,\"overlaps\":0,\"queries_per_sec\":2.50,\"bases_per_sec\":200.00,"
+        "\"eta_secs\":30.00}",
+        FormatProgressJSON("seeddb", MakeSnapshot(10.0, 25, 100, 2000, 0), false));
+
+    EXPECT_EQ(
+        "{\"name\":\"seqdb\",\"final\":true,\"elapsed_secs\":10.00,\"queries\":25,"
+        "\"total_queries\":0,\"bases\":2000,\"total_bases\":0,\"hits\":0,\"alignments\":0,"
+        "\"band_widenings\":0,\"overlaps\":0,\"queries_per_sec\":2.50,\"bases_per_sec\":200.00,"
+        "\"eta_secs\":null}",
+        FormatProgressJSON("seqdb", MakeSnapshot(10.0, 25, 0, 2000, 0), true));
+}
+
+TEST(Test_Progress, ReporterWritesFinalJSONLine)
+{
+    const std::string jsonFile =
+        PacBio::PancakeTestsConfig::GeneratedData_Dir + "/progress.jsonl";
+    std::remove(jsonFile.c_str());
+
+    // Periodic reports are disabled, so only the final line is written.
+    {
+        ProgressReporter progress("seqfetch", 0.0, jsonFile);
+        progress.SetTotals(3, 300);
+        progress.Start();
+        for (int32_t i = 0; i < 3; ++i) {
+            progress.Counters().AddQueries(1);
+            progress.Counters().AddBases(100);
+            progress.Counters().AddOverlaps(2);
+        }
+        const ProgressSnapshot snapshot = progress.Snapshot();
+        EXPECT_EQ(3, snapshot.queries);
+        EXPECT_EQ(300, snapshot.bases);
+        EXPECT_EQ(6, snapshot.overlaps);
+        EXPECT_EQ(3, snapshot.totalQueries);
+        EXPECT_EQ(300, snapshot.totalBases);
+    }
+
+    // A second reporter appends to the same file.
+    {
+        ProgressReporter progress("seqfetch", 0.0, jsonFile);
+        progress.Counters().AddQueries(5);
+    }
+
+    std::vector<std::string> lines;
+    std::ifstream ifs(jsonFile);
+    std::string line;
+    while (std::getline(ifs, line)) {
+        lines.emplace_back(line);
+    }
+    ASSERT_EQ(2, static_cast<int32_t>(lines.size()));
+    EXPECT_NE(std::string::npos, lines[0].find("\"final\":true"));
+    EXPECT_NE(std::string::npos, lines[0].find("\"queries\":3,\"total_queries\":3"));
+    EXPECT_NE(std::string::npos, lines[0].find("\"eta_secs\":0.00"));
+    EXPECT_NE(std::string::npos, lines[1].find("\"queries\":5,\"total_queries\":0"));
+}
+
+TEST(Test_Progress, ReporterThrowsOnInvalidJSONPath)
+{
+    EXPECT_THROW({ ProgressReporter progress("seqdb", 0.0, "/nonexistent/dir/progress.jsonl"); },
+                 std::runtime_error);
+}
+
+}  // namespace ProgressTests
@@ -0,0 +1,221 @@
+// Authors: Ivan Sovic
+
+#include <gtest/gtest.h>
+#include <pacbio/alignment/Ses2AlignBanded.hpp>
+#include <pacbio/pancake/ReadCorrection.h>
+#include <pacbio/util/Util.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PacBio::Pancake;
+
+namespace ReadCorrectionTests {
+
+PileupAlignment MakeAlignment(int32_t queryStart, int32_t queryEnd, const std::string& targetSeq,
+                              const std::string& cigar)
+{
+    PileupAlignment ret;
+    ret.queryStart = queryStart;
+    ret.queryEnd = queryEnd;
+    ret.targetSeq = targetSeq;
+    ret.cigar = PacBio::BAM::Cigar(cigar);
+    return ret;
+}
+
+std::string RunCorrectRead(const std::string& seq, const std::vector<PileupAlignment>& alignments,
+                           const ReadCorrectionSettings& settings, ReadCorrectionStats& stats)
+{
+    return CorrectRead(seq.c_str(), seq.size(), alignments, settings, stats);
+}
+
+// Introduces substitutions and homopolymer indels at the given rate.
+std::string AddErrors(const std::string& seq, double errorRate, std::mt19937& rng)
+{
+    const char* bases = "ACGT";
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::string ret;
+    for (const char c : seq) {
+        if (dist(rng) >= errorRate) {
+            ret += c;
+            continue;
+        }
+        const int32_t type = rng() % 3;
+        if (type == 0) {
+            char base = c;
+            while (base == c) {
+                base = bases[rng() % 4];
+            }
+            ret += base;
+        } else if (type == 1) {
+            ret += c;
+            ret += c;
+        }
+    }
+    return ret;
+}
+
+TEST(ReadCorrection, HomopolymerIndelsAndSubstitutions)
+{
+    ReadCorrectionSettings settings;
+    ReadCorrectionStats stats;
+
+    {
+        SCOPED_TRACE("Missing homopolymer base, with the indels placed differently.");
+        const std::string query = "ACGTTAC";
+        const std::string truth = "ACGTTTAC";
+        const std::vector<PileupAlignment> alignments = {
+            MakeAlignment(0, 7, truth, "3=1D4="),
+            MakeAlignment(0, 7, truth, "5=1D2="),
+            MakeAlignment(0, 7, truth, "4=1D3="),
+        };
+        EXPECT_EQ(truth, RunCorrectRead(query, alignments, settings, stats));
+        EXPECT_EQ(6, stats.numRuns);
+        EXPECT_EQ(6, stats.numCovered);
+        EXPECT_EQ(1, stats.numCorrected);
+        EXPECT_EQ(0, stats.numHetKept);
+    }
+
+    {
+        SCOPED_TRACE("Extra homopolymer base.");
+        const std::string query = "ACGGTA";
+        const std::string truth = "ACGTA";
+        const std::vector<PileupAlignment> alignments = {
+            MakeAlignment(0, 6, truth, "2=1I3="),
+            MakeAlignment(0, 6, truth, "3=1I2="),
+        };
+        EXPECT_EQ(truth, RunCorrectRead(query, alignments, settings, stats));
+    }
+
+    {
+        SCOPED_TRACE("Substitution.");
+        const std::string query = "ACGAAC";
+        const std::string truth = "ACCAAC";
+        const std::vector<PileupAlignment> alignments = {
+            MakeAlignment(0, 6, truth, "2=1X3="),
+            MakeAlignment(0, 6, truth, "2=1X3="),
+        };
+        EXPECT_EQ(truth, RunCorrectRead(query, alignments, settings, stats));
+    }
+}
+
+TEST(ReadCorrection, CoverageAndHeterozygousVariants)
+{
+    const std::string query = "ACGAAC";
+    const std::string other = "ACCAAC";
+    std::vector<PileupAlignment> alignments = {
+        MakeAlignment(0, 6, other, "2=1X3="),
+    };
+
+    ReadCorrectionSettings settings;
+    ReadCorrectionStats stats;
+
+    // Too low coverage.
+    EXPECT_EQ(query, RunCorrectRead(query, alignments, settings, stats));
+    EXPECT_EQ(0, stats.numCovered);
+
+    // Two reads support the query, and four the other version.
+    alignments.emplace_back(MakeAlignment(0, 6, other, "2=1X3="));
+    alignments.emplace_back(MakeAlignment(0, 6, other, "2=1X3="));
+    alignments.emplace_back(MakeAlignment(0, 6, other, "2=1X3="));
+    alignments.emplace_back(MakeAlignment(0, 6, query, "6="));
+    alignments.emplace_back(MakeAlignment(0, 6, query, "6="));
+    EXPECT_EQ(query, RunCorrectRead(query, alignments, settings, stats));
+    EXPECT_EQ(1, stats.numHetKept);
+    EXPECT_EQ(0, stats.numCorrected);
+
+    settings.minHetSupport = 3;
+    EXPECT_EQ(other, RunCorrectRead(query, alignments, settings, stats));
+    EXPECT_EQ(0, stats.numHetKept);
+    EXPECT_EQ(1, stats.numCorrected);
+
+    // Ties keep the read's own version.
+    settings.minHetSupport = 10;
+    alignments.emplace_back(MakeAlignment(0, 6, query, "6="));
+    EXPECT_EQ(query, RunCorrectRead(query, alignments, settings, stats));
+}
+
+TEST(ReadCorrection, PartiallyCoveredRuns)
+{
+    // The alignments start within the first run of A's, so that run is not corrected.
+    const std::string query = "AAAACGTT";
+    const std::vector<PileupAlignment> alignments = {
+        MakeAlignment(2, 8, "AAACGT", "1=1D3=1I1="),
+        MakeAlignment(2, 8, "AAACGT", "1=1D3=1I1="),
+    };
+    ReadCorrectionSettings settings;
+    ReadCorrectionStats stats;
+    EXPECT_EQ("AAAACGT", RunCorrectRead(query, alignments, settings, stats));
+    EXPECT_EQ(3, stats.numCovered);
+
+    // The CIGAR does not match the query span.
+    const std::vector<PileupAlignment> badAlignments = {MakeAlignment(0, 8, "AAACGT", "6=")};
+    EXPECT_THROW({ RunCorrectRead(query, badAlignments, settings, stats); }, std::runtime_error);
+}
+
+TEST(ReadCorrection, CreatePileupAlignment)
+{
+    const std::string target = "AACCGGTTAC";
+    Overlap ovl;
+    ovl.Astart = 10;
+    ovl.Aend = 14;
+    ovl.Alen = 100;
+    ovl.Bstart = 2;
+    ovl.Bend = 6;
+    ovl.Blen = target.size();
+    ovl.Cigar = PacBio::BAM::Cigar("4=");
+
+    ovl.Brev = false;
+    PileupAlignment aln = CreatePileupAlignment(ovl, target.c_str(), target.size());
+    EXPECT_EQ("CCGG", aln.targetSeq);
+    EXPECT_EQ(10, aln.queryStart);
+    EXPECT_EQ(14, aln.queryEnd);
+    EXPECT_EQ("4=", aln.cigar.ToStdString());
+
+    // The B coordinates are in the strand of B, so this is the fwd range [4, 8).
+    ovl.Brev = true;
+    aln = CreatePileupAlignment(ovl, target.c_str(), target.size());
+    EXPECT_EQ("AACC", aln.targetSeq);
+
+    ovl.Bend = 12;
+    EXPECT_THROW({ CreatePileupAlignment(ovl, target.c_str(), target.size()); },
+                 std::runtime_error);
+}
+
+TEST(ReadCorrection, RandomReads)
+{
+    std::mt19937 rng(23);
+    const char* bases = "ACGT";
+    std::string truth;
+    for (int32_t i = 0; i < 3000; ++i) {
+        truth += bases[rng() % 4];
+    }
+
+    const std::string query = AddErrors(truth, 0.01, rng);
+    ASSERT_NE(truth, query);
+
+    std::vector<PileupAlignment> alignments;
+    for (int32_t i = 0; i < 15; ++i) {
+        const std::string read = AddErrors(truth, 0.01, rng);
+        const auto sesResult = PacBio::Pancake::Alignment::SES2AlignBanded<
+            PacBio::Pancake::Alignment::SESAlignMode::Global,
+            PacBio::Pancake::Alignment::SESTrimmingMode::Disabled,
+            PacBio::Pancake::Alignment::SESTracebackMode::Enabled>(
+            query.c_str(), query.size(), read.c_str(), read.size(), 200, 200);
+        ASSERT_TRUE(sesResult.valid);
+        PileupAlignment aln;
+        aln.queryStart = 0;
+        aln.queryEnd = query.size();
+        aln.targetSeq = read;
+        aln.cigar = sesResult.cigar;
+        alignments.emplace_back(std::move(aln));
+    }
+
+    ReadCorrectionSettings settings;
+    ReadCorrectionStats stats;
+    const std::string corrected = RunCorrectRead(query, alignments, settings, stats);
+    EXPECT_EQ(truth, corrected);
+    EXPECT_GT(stats.numCorrected, 0);
+}
+
+}  // namespace ReadCorrectionTests
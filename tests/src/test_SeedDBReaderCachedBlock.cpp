@@ -258,3 +258,44 @@ TEST(SeedDBReaderCachedBlock, BatchCompareWithSeedDBReader)
         }
     }
 }
+
+TEST(SeedDBReaderCachedBlock, ConstructFromComputedSeeds)
+{
+    /*
+     * The seeds computed on the fly are wrapped into a block, and can be accessed
+     * in the same way as the ones loaded from a SeedDB.
+    */
+
+    // Input values.
+    const std::string bases = "ACTGACTGACTG";
+    const std::vector<PacBio::Pancake::FastaSequenceCached> seqs = {
+        {"seq5", bases.c_str(), 4, 5},
+        {"seq7", bases.c_str(), 8, 7},
+        {"seq9", bases.c_str(), 12, 9},
+    };
+    const std::vector<std::vector<PacBio::Pancake::Int128t>> seeds = {
+        {1, 2},
+        {},
+        {3, 4, 5},
+    };
+
+    PacBio::Pancake::SeedDBReaderCachedBlock reader(seqs, seeds);
+
+    // Evaluate.
+    ASSERT_EQ(3, reader.records().size());
+    for (size_t i = 0; i < seqs.size(); ++i) {
+        const auto& record = reader.GetSeedsForSequence(seqs[i].Id());
+        EXPECT_EQ(seqs[i].Name(), record.Name());
+        EXPECT_EQ(seqs[i].Id(), record.Id());
+        const std::vector<PacBio::Pancake::Int128t> results(record.Seeds(),
+                                                            record.Seeds() + record.Size());
+        EXPECT_EQ(seeds[i], results);
+        EXPECT_EQ(record.Id(), reader.GetSeedsForSequence(seqs[i].Name()).Id());
+    }
+    EXPECT_THROW({ reader.GetSeedsForSequence(6); }, std::runtime_error);
+    EXPECT_THROW({ reader.LoadBlock({0}); }, std::runtime_error);
+
+    // The number of sequences and seed vectors must match.
+    EXPECT_THROW(
+        { PacBio::Pancake::SeedDBReaderCachedBlock(seqs, {{1}, {2}}); }, std::runtime_error);
+}
@@ -5,6 +5,8 @@
 #include <pacbio/pancake/Seed.h>
 #include <pacbio/pancake/SeedIndex.h>
 #include <pacbio/util/CommonTypes.h>
+#include <algorithm>
+#include <random>
 #include <sstream>
 #include <tuple>
 
@@ -547,6 +549,179 @@ B	0	0	1	96
     EXPECT_EQ(expected, results);
 }
 
+TEST(SeedIndex, CollectSeedHitsFromSortedSeedsMatchesCollectHits)
+{
+    /*
+     * The merge join over the sorted seeds of a single target should produce the
+     * same set of hits as the lookup in a SeedIndex built for that target,
+     * including the hits on the reverse strand and the frequency cutoff.
+    */
+    const int32_t k = 30;
+    const int32_t targetId = 0;
+    const int32_t targetLen = 38;
+    const int32_t queryLen = 38;
+    const std::vector<PacBio::Pancake::SeedDB::SeedRaw> targetSeeds = {
+        PacBio::Pancake::SeedDB::Seed::Encode(0, k, targetId, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(123, k, targetId, 1, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(5, k, targetId, 2, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(7, k, targetId, 3, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(5, k, targetId, 4, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(0, k, targetId, 5, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(123, k, targetId, 6, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(5, k, targetId, 7, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(123, k, targetId, 8, false),
+    };
+    const int32_t queryId = 0;
+    const std::vector<PacBio::Pancake::SeedDB::SeedRaw> querySeeds = {
+        PacBio::Pancake::SeedDB::Seed::Encode(0, k, queryId, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(123, k, queryId, 1, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(5, k, queryId, 2, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(7, k, queryId, 3, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(5, k, queryId, 4, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(0, k, queryId, 5, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(123, k, queryId, 6, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(5, k, queryId, 7, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(123, k, queryId, 8, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(999, k, queryId, 8, false),
+    };
+
+    const std::string targetSeedDBString =
+        R"(V	0.1.0
+P	k=30,w=80,hpc=0,hpc_len=10,rc=1
+F	0	dummy.seeddb.0.seeds	1	144
+S	0	targetSeq0	0	0	144	38	9
+B	0	0	1	144
+)";
+    std::istringstream is(targetSeedDBString);
+    std::shared_ptr<PacBio::Pancake::SeedDBIndexCache> targetSeedDBCache =
+        PacBio::Pancake::LoadSeedDBIndexCache(is, "filename.seeddb");
+
+    auto sortedQuerySeeds = querySeeds;
+    auto sortedTargetSeeds = targetSeeds;
+    std::sort(sortedQuerySeeds.begin(), sortedQuerySeeds.end());
+    std::sort(sortedTargetSeeds.begin(), sortedTargetSeeds.end());
+
+    for (const int64_t freqCutoff : {0, 1, 2, 3}) {
+        SCOPED_TRACE("freqCutoff = " + std::to_string(freqCutoff));
+
+        // Expected results, from the index.
+        PacBio::Pancake::SeedIndex si(targetSeedDBCache,
+                                      std::vector<PacBio::Pancake::SeedDB::SeedRaw>(targetSeeds));
+        std::vector<PacBio::Pancake::SeedHit> expected;
+        si.CollectHits(querySeeds, queryLen, expected, freqCutoff);
+        std::sort(expected.begin(), expected.end());
+
+        // Run the unit under test.
+        std::vector<PacBio::Pancake::SeedHit> results;
+        PacBio::Pancake::CollectSeedHitsFromSortedSeeds(
+            sortedQuerySeeds.data(), sortedQuerySeeds.size(), sortedTargetSeeds.data(),
+            sortedTargetSeeds.size(), targetLen, freqCutoff, results);
+        std::sort(results.begin(), results.end());
+
+        EXPECT_EQ(expected, results);
+    }
+}
+
+TEST(SeedIndex, SortedSequenceSeedsSortsEachSequence)
+{
+    const int32_t k = 30;
+    const std::vector<PacBio::Pancake::SeedDB::SeedRaw> seeds = {
+        // Sequence 7.
+        PacBio::Pancake::SeedDB::Seed::Encode(123, k, 7, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(5, k, 7, 1, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(0, k, 7, 2, true),
+        // Sequence 3.
+        PacBio::Pancake::SeedDB::Seed::Encode(9, k, 3, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(1, k, 3, 1, false),
+    };
+    const std::vector<PacBio::Pancake::SequenceSeedsCached> records = {
+        PacBio::Pancake::SequenceSeedsCached("seq7", seeds.data(), 3, 7),
+        PacBio::Pancake::SequenceSeedsCached("seq3", seeds.data() + 3, 2, 3),
+        PacBio::Pancake::SequenceSeedsCached("empty", nullptr, 0, 4),
+    };
+
+    const PacBio::Pancake::SortedSequenceSeeds sortedSeeds(records);
+
+    for (const auto& record : records) {
+        SCOPED_TRACE("seqId = " + std::to_string(record.Id()));
+        std::vector<PacBio::Pancake::SeedDB::SeedRaw> expected(record.Seeds(),
+                                                               record.Seeds() + record.Size());
+        std::sort(expected.begin(), expected.end());
+        const auto& result = sortedSeeds.GetSeedsForSequence(record.Id());
+        EXPECT_EQ(record.Id(), result.Id());
+        EXPECT_EQ(record.Name(), result.Name());
+        EXPECT_EQ(expected, std::vector<PacBio::Pancake::SeedDB::SeedRaw>(
+                                result.Seeds(), result.Seeds() + result.Size()));
+    }
+
+    EXPECT_THROW({ sortedSeeds.GetSeedsForSequence(0); }, std::runtime_error);
+}
+
+TEST(SeedIndex, PerfectHashMatchesFlatHashMap)
+{
+    /*
+     * Both hash types should produce the same seeds, hits and frequency statistics,
+     * including for the query keys which are not in the index.
+    */
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint64_t> keyDist(0, 2000);
+    std::uniform_int_distribution<int32_t> seqIdDist(0, 9);
+    std::uniform_int_distribution<int32_t> posDist(0, 900);
+    std::uniform_int_distribution<int32_t> revDist(0, 1);
+    const int32_t k = 15;
+    const std::vector<int32_t> sequenceLengths(10, 1000);
+    PacBio::Pancake::SeedDB::SeedDBParameters seedParams;
+    seedParams.KmerSize = k;
+
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw> targetSeeds;
+    for (int32_t i = 0; i < 5000; ++i) {
+        targetSeeds.emplace_back(PacBio::Pancake::SeedDB::Seed::Encode(
+            keyDist(rng) / 2, k, seqIdDist(rng), posDist(rng), revDist(rng)));
+    }
+    std::vector<PacBio::Pancake::SeedDB::SeedRaw> querySeeds;
+    for (int32_t i = 0; i < 1000; ++i) {
+        querySeeds.emplace_back(
+            PacBio::Pancake::SeedDB::Seed::Encode(keyDist(rng), k, 0, posDist(rng), revDist(rng)));
+    }
+
+    // The index takes ownership of the seeds, so each one gets a copy.
+    auto flatSeeds = targetSeeds;
+    auto perfectSeeds = targetSeeds;
+    const PacBio::Pancake::SeedIndex flatIndex(seedParams, sequenceLengths, std::move(flatSeeds),
+                                               PacBio::Pancake::SeedIndexHashType::FlatHashMap);
+    const PacBio::Pancake::SeedIndex perfectIndex(seedParams, sequenceLengths,
+                                                  std::move(perfectSeeds),
+                                                  PacBio::Pancake::SeedIndexHashType::PerfectHash);
+    EXPECT_EQ(PacBio::Pancake::SeedIndexHashType::PerfectHash, perfectIndex.GetHashType());
+
+    for (uint64_t key = 0; key <= 2000; ++key) {
+        std::vector<PacBio::Pancake::SeedDB::SeedRaw> expected;
+        std::vector<PacBio::Pancake::SeedDB::SeedRaw> results;
+        EXPECT_EQ(flatIndex.GetSeeds(key, expected), perfectIndex.GetSeeds(key, results));
+        EXPECT_EQ(expected, results);
+    }
+
+    for (const int64_t freqCutoff : {0, 3, 6}) {
+        std::vector<PacBio::Pancake::SeedHit> expected;
+        std::vector<PacBio::Pancake::SeedHit> results;
+        flatIndex.CollectHits(querySeeds, 1000, expected, freqCutoff);
+        perfectIndex.CollectHits(querySeeds, 1000, results, freqCutoff);
+        EXPECT_EQ(expected, results);
+    }
+
+    int64_t expectedFreqMax = 0, resultFreqMax = 0;
+    double expectedFreqAvg = 0.0, resultFreqAvg = 0.0;
+    double expectedFreqMedian = 0.0, resultFreqMedian = 0.0;
+    int64_t expectedFreqCutoff = 0, resultFreqCutoff = 0;
+    flatIndex.ComputeFrequencyStats(0.1, expectedFreqMax, expectedFreqAvg, expectedFreqMedian,
+                                    expectedFreqCutoff);
+    perfectIndex.ComputeFrequencyStats(0.1, resultFreqMax, resultFreqAvg, resultFreqMedian,
+                                       resultFreqCutoff);
+    EXPECT_EQ(
+        std::make_tuple(expectedFreqMax, expectedFreqAvg, expectedFreqMedian, expectedFreqCutoff),
+        std::make_tuple(resultFreqMax, resultFreqAvg, resultFreqMedian, resultFreqCutoff));
+}
+
 TEST(SeedIndex, ComputeFrequencyStatsEmptyIndex)
 {
     /*
@@ -674,6 +849,56 @@ TEST(SeedIndex, ComputeFrequencyThresholdOutOfBounds)
         std::runtime_error);
 }
 
+TEST(SeedIndex, CollectSeedsNearSequenceEnds)
+{
+    /*
+     * Only the seeds which begin within maxDist from either end of their sequence should be kept.
+     * Sequence 0 is shorter than 2 * maxDist, so all of its seeds are kept.
+    */
+    // Input values.
+    std::vector<PacBio::Pancake::Int128t> inSeeds = {
+        PacBio::Pancake::SeedDB::Seed::Encode(10, 0, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(11, 0, 8, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(12, 0, 12, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(20, 1, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(21, 1, 9, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(22, 1, 10, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(23, 1, 50, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(24, 1, 89, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(25, 1, 90, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(26, 1, 99, false),
+    };
+    const std::vector<int32_t> sequenceLengths = {18, 100};
+    const int32_t maxDist = 10;
+
+    // Expected results.
+    const std::vector<PacBio::Pancake::Int128t> expected = {
+        PacBio::Pancake::SeedDB::Seed::Encode(10, 0, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(11, 0, 8, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(12, 0, 12, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(20, 1, 0, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(21, 1, 9, false),
+        PacBio::Pancake::SeedDB::Seed::Encode(25, 1, 90, true),
+        PacBio::Pancake::SeedDB::Seed::Encode(26, 1, 99, false),
+    };
+
+    // Run the unit under test.
+    std::vector<PacBio::Pancake::Int128t> results;
+    PacBio::Pancake::CollectSeedsNearSequenceEnds(&inSeeds[0], inSeeds.size(), sequenceLengths,
+                                                  maxDist, results);
+
+    // Evaluate.
+    EXPECT_EQ(expected, results);
+
+    // A sequence ID without a known length should throw.
+    EXPECT_THROW(
+        {
+            PacBio::Pancake::CollectSeedsNearSequenceEnds(&inSeeds[0], inSeeds.size(), {18},
+                                                          maxDist, results);
+        },
+        std::runtime_error);
+}
+
 TEST(SeedIndex, ParsingSeedIndexCache_Stream_RoundTrip_Good)
 {
     // Load the SeedDB cache.
@@ -258,6 +258,143 @@ TEST(SES2AlignBanded_Global, AllTests)
         }
     }
 }
+
+TEST(SES2AlignBanded_ReverseDirection, AllTests)
+{
+    // Aligning the reversed sequences in the reverse direction should give
+    // exactly the same results as aligning the original sequences forward.
+    for (const auto& data : testDataGlobal) {
+        const std::string queryRev(data.query.rbegin(), data.query.rend());
+        const std::string targetRev(data.target.rbegin(), data.target.rend());
+        {
+            SCOPED_TRACE("Global-" + data.testName);
+
+            Alignment::SesResults result =
+                Alignment::SES2AlignBanded<Alignment::SESAlignMode::Global,
+                                           Alignment::SESTrimmingMode::Disabled,
+                                           Alignment::SESTracebackMode::Enabled,
+                                           Alignment::SESAlignDirection::Reverse>(
+                    queryRev.c_str(), queryRev.size(), targetRev.c_str(), targetRev.size(),
+                    data.maxDiffs, data.bandwidth);
+
+            EXPECT_EQ(data.expectedGlobal, result);
+        }
+        {
+            SCOPED_TRACE("Semiglobal-" + data.testName);
+
+            Alignment::SesResults result =
+                Alignment::SES2AlignBanded<Alignment::SESAlignMode::Semiglobal,
+                                           Alignment::SESTrimmingMode::Disabled,
+                                           Alignment::SESTracebackMode::Enabled,
+                                           Alignment::SESAlignDirection::Reverse>(
+                    queryRev.c_str(), queryRev.size(), targetRev.c_str(), targetRev.size(),
+                    data.maxDiffs, data.bandwidth);
+
+            EXPECT_EQ(data.expectedSemiglobal, result);
+        }
+    }
+}
+
+TEST(SES2AlignBanded_Adaptive, AllTests)
+{
+    for (const auto& data : testDataGlobal) {
+        SCOPED_TRACE("Adaptive-" + data.testName);
+
+        // Without room for widening, the results are the same as those of the fixed band.
+        const Alignment::SesResults resultFixed =
+            Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                               Alignment::SESTrimmingMode::Disabled,
+                                               Alignment::SESTracebackMode::Enabled>(
+                data.query.c_str(), data.query.size(), data.target.c_str(), data.target.size(),
+                data.maxDiffs, data.bandwidth, data.maxDiffs, data.bandwidth);
+        EXPECT_EQ(data.expectedGlobal, resultFixed);
+        EXPECT_EQ(0, resultFixed.numWidenings);
+    }
+}
+
+TEST(SES2AlignBanded_Adaptive, WidensBandAndDiffs)
+{
+    // The real HiFi pair from the test data needs 105 diffs.
+    const auto& data = testDataGlobal.back();
+    ASSERT_EQ(105, data.expectedGlobal.numDiffs);
+
+    // A tight band and diff budget are not enough.
+    const Alignment::SesResults resultTight =
+        Alignment::SES2AlignBanded<Alignment::SESAlignMode::Global,
+                                   Alignment::SESTrimmingMode::Disabled,
+                                   Alignment::SESTracebackMode::Enabled>(
+            data.query.c_str(), data.query.size(), data.target.c_str(), data.target.size(), 10,
+            10);
+    EXPECT_FALSE(resultTight.valid);
+
+    // The adaptive alignment starts with the same tight limits, and resumes with the doubled
+    // limits until the alignment fits: 10 -> 20 -> 40 -> 80 -> 160 diffs.
+    auto ss = std::make_shared<SESScratchSpace>();
+    const Alignment::SesResults result =
+        Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                           Alignment::SESTrimmingMode::Disabled,
+                                           Alignment::SESTracebackMode::Enabled>(
+            data.query.c_str(), data.query.size(), data.target.c_str(), data.target.size(), 10,
+            10, data.maxDiffs, data.bandwidth, ss);
+    EXPECT_EQ(data.expectedGlobal, result);
+    EXPECT_EQ(4, result.numWidenings);
+
+    // The same without the traceback.
+    const Alignment::SesResults resultNoTraceback =
+        Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                           Alignment::SESTrimmingMode::Disabled,
+                                           Alignment::SESTracebackMode::Disabled>(
+            data.query.c_str(), data.query.size(), data.target.c_str(), data.target.size(), 10,
+            10, data.maxDiffs, data.bandwidth, ss);
+    EXPECT_TRUE(resultNoTraceback.valid);
+    EXPECT_EQ(data.expectedGlobal.numDiffs, resultNoTraceback.numDiffs);
+    EXPECT_EQ(4, resultNoTraceback.numWidenings);
+
+    // The caps still apply.
+    const Alignment::SesResults resultCapped =
+        Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                           Alignment::SESTrimmingMode::Disabled,
+                                           Alignment::SESTracebackMode::Enabled>(
+            data.query.c_str(), data.query.size(), data.target.c_str(), data.target.size(), 10,
+            10, 50, 50, ss);
+    EXPECT_FALSE(resultCapped.valid);
+    EXPECT_EQ(3, resultCapped.numWidenings);
+}
+
+TEST(SES2AlignBanded_Adaptive, BuffersSizedForInitialBandWithoutWidening)
+{
+    // The initial limits are enough for the real HiFi pair, so the band is never widened.
+    const auto& data = testDataGlobal.back();
+    const int32_t maxDiffsCap = data.maxDiffs * 8;
+    const int32_t bandwidthCap = data.bandwidth * 8;
+
+    auto ss = std::make_shared<SESScratchSpace>();
+    const Alignment::SesResults result =
+        Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                           Alignment::SESTrimmingMode::Disabled,
+                                           Alignment::SESTracebackMode::Enabled>(
+            data.query.c_str(), data.query.size(), data.target.c_str(), data.target.size(),
+            data.maxDiffs, data.bandwidth, maxDiffsCap, bandwidthCap, ss);
+    EXPECT_EQ(data.expectedGlobal, result);
+    EXPECT_EQ(0, result.numWidenings);
+
+    // The rows and the traceback matrix are sized for the initial band, not for the caps.
+    const size_t rowLen = 2 * data.maxDiffs + 3;
+    EXPECT_LE(ss->v.capacity(), rowLen);
+    EXPECT_LE(ss->u.capacity(), rowLen);
+    EXPECT_LE(ss->dStart.capacity(), rowLen);
+    EXPECT_LE(ss->v2.capacity(), rowLen * data.maxDiffs);
+
+    // After widening, the buffers grow, and the result is still correct.
+    const Alignment::SesResults resultWidened =
+        Alignment::SES2AlignBandedAdaptive<Alignment::SESAlignMode::Global,
+                                           Alignment::SESTrimmingMode::Disabled,
+                                           Alignment::SESTracebackMode::Enabled>(
+            data.query.c_str(), data.query.size(), data.target.c_str(), data.target.size(), 10,
+            10, maxDiffsCap, bandwidthCap, ss);
+    EXPECT_EQ(data.expectedGlobal, resultWidened);
+    EXPECT_LT(0, resultWidened.numWidenings);
+}
 }
 }
 }